@@ -15,6 +15,8 @@ import 'services/log_service.dart';
 import 'services/task_service.dart';
 import 'utils/constants.dart';
 import 'services/floating_window_service.dart';
+import 'services/windows_ipc.dart';
+import 'services/windows_floating_helper.dart';
 
 /// 应用入口点
 Future<void> main(List<String> args) async {
@@ -195,6 +197,41 @@ Future<void> _initializeApp() async {
       }
     });
 
+    // 原生悬浮球（Windows）的消息与再次启动转交过来的参数：Runner 已恢复主窗口，
+    // 这里处理打开任务，并把再次启动的窗口拉到前台
+    WindowsFloatingIpc.events().listen((batch) async {
+      for (final event in batch) {
+        if (event.type == FloatingBallEvent.typeActivate) {
+          print('✓ [WINDOW] 再次启动已转交到当前实例，参数: ${event.args}');
+          try {
+            await windowManager.show();
+            await windowManager.focus();
+          } catch (e) {
+            print('✗ [WINDOW] 处理再次启动失败: $e');
+          }
+          continue;
+        }
+        if (event.type == FloatingBallEvent.typeBallReady) {
+          WindowsFloatingHelper.onBallRestarted();
+          continue;
+        }
+        if (event.type != FloatingBallEvent.typeOpenTask) continue;
+        try {
+          await windowManager.show();
+          await windowManager.focus();
+          final taskIdInt = int.tryParse(event.taskId ?? '');
+          if (taskIdInt != null) {
+            await TaskService.instance.markTaskAsRead(taskIdInt);
+            print('✓ [WINDOW] 已标记任务已读: $taskIdInt');
+          } else {
+            print('✗ [WINDOW] 无法解析任务ID: ${event.taskId}');
+          }
+        } catch (e) {
+          print('✗ [WINDOW] 处理悬浮球 open_task 失败: $e');
+        }
+      }
+    });
+
     print('✓ WindowManager初始化成功');
 
     // 初始化系统托盘（所有平台）
@@ -0,0 +1,175 @@
+import 'dart:typed_data';
+
+import '../models/task.dart';
+
+/// Binary UPDATE_TASKS payload understood by the native floating ball
+/// (WM_COPYDATA dwData = [FloatingBallWire.copyDataId]).
+///
+/// Layout mirrors `windows/native_floating_ball/src/core/task_wire.h`;
+/// all integers are little-endian.
+///
+/// Header (16 bytes):
+///   u32 magic 'CDTW' | u8 version | u8 kind | u16 headerSize
+///   u32 count        | u32 sequence (0 = unsequenced)
+/// Record (4-byte aligned):
+///   u32 recordSize | u8 priority | u8 flags | u16 idLen | i64 dueMs
+///   u32 titleLen   | UTF-16 id | UTF-16 title | padding
+///   [ADD only] u32 position (live index after insertion)
+///
+/// A snapshot with a non-zero sequence establishes a baseline; each
+/// following ADD/UPDATE/REMOVE message must carry the next sequence number.
+class FloatingBallWire {
+  static const int copyDataId = 4;
+  static const int magic = 0x57544443; // "CDTW"
+  static const int version = 1;
+  static const int kindSnapshot = 0;
+  static const int kindAdd = 1;
+  static const int kindUpdate = 2;
+  static const int kindRemove = 3;
+  static const int headerSize = 16;
+  static const int recordFixedSize = 20;
+
+  static const int flagUnread = 1 << 0;
+  static const int flagCompleted = 1 << 1;
+
+  /// Ball replies (WM_COPYDATA return value).
+  static const int resultRejected = 0;
+  static const int resultApplied = 1;
+  static const int resultResyncRequired = 2;
+
+  /// Encodes [entries] as one message of [kind]. For [kindAdd] the entry's
+  /// [FloatingBallEntry.position] is written as the insertion index.
+  static Uint8List encode(int kind, List<FloatingBallEntry> entries,
+      {int sequence = 0}) {
+    final withPosition = kind == kindAdd;
+    var total = headerSize;
+    for (final e in entries) {
+      total += _recordSize(e.id.length, e.title.length, withPosition);
+    }
+
+    final bytes = Uint8List(total);
+    final data = ByteData.sublistView(bytes);
+    data.setUint32(0, magic, Endian.little);
+    data.setUint8(4, version);
+    data.setUint8(5, kind);
+    data.setUint16(6, headerSize, Endian.little);
+    data.setUint32(8, entries.length, Endian.little);
+    data.setUint32(12, sequence, Endian.little);
+
+    var offset = headerSize;
+    for (final e in entries) {
+      offset = _writeRecord(data, offset, e, withPosition);
+    }
+    return bytes;
+  }
+
+  static int _recordSize(int idLen, int titleLen, bool withPosition) =>
+      ((recordFixedSize + (idLen + titleLen) * 2 + 3) & ~3) +
+      (withPosition ? 4 : 0);
+
+  static int _writeRecord(
+      ByteData data, int offset, FloatingBallEntry e, bool withPosition) {
+    final id = e.id;
+    final title = e.title;
+    final size = _recordSize(id.length, title.length, withPosition);
+
+    data.setUint32(offset, size, Endian.little);
+    data.setUint8(offset + 4, e.priority);
+    data.setUint8(offset + 5, e.flags);
+    data.setUint16(offset + 6, id.length, Endian.little);
+    data.setInt64(offset + 8, e.dueMs, Endian.little);
+    data.setUint32(offset + 16, title.length, Endian.little);
+
+    var p = offset + recordFixedSize;
+    for (var i = 0; i < id.length; i++, p += 2) {
+      data.setUint16(p, id.codeUnitAt(i), Endian.little);
+    }
+    for (var i = 0; i < title.length; i++, p += 2) {
+      data.setUint16(p, title.codeUnitAt(i), Endian.little);
+    }
+    if (withPosition) {
+      data.setUint32(offset + size - 4, e.position, Endian.little);
+    }
+    return offset + size;
+  }
+}
+
+/// What the ball knows about one task; compared field-by-field to build
+/// deltas against the last list the ball acknowledged.
+class FloatingBallEntry {
+  final String id;
+  final String title;
+  final int priority;
+  final int flags;
+  final int dueMs;
+
+  /// Insertion index for ADD records; ignored elsewhere.
+  final int position;
+
+  const FloatingBallEntry(this.id, this.title, this.priority, this.flags,
+      this.dueMs, [this.position = 0xFFFFFFFF]);
+
+  factory FloatingBallEntry.fromTask(Task task) {
+    var flags = 0;
+    if (!task.isRead) flags |= FloatingBallWire.flagUnread;
+    if (task.isCompleted) flags |= FloatingBallWire.flagCompleted;
+    return FloatingBallEntry(task.id.toString(), task.title,
+        task.priority.index, flags,
+        task.dueDate?.toUtc().millisecondsSinceEpoch ?? 0);
+  }
+
+  FloatingBallEntry at(int index) =>
+      FloatingBallEntry(id, title, priority, flags, dueMs, index);
+
+  bool sameContent(FloatingBallEntry o) =>
+      title == o.title &&
+      priority == o.priority &&
+      flags == o.flags &&
+      dueMs == o.dueMs;
+}
+
+/// REMOVE/UPDATE/ADD messages turning one list into another, in the order
+/// they must be applied.
+class FloatingBallDelta {
+  final List<FloatingBallEntry> removed;
+  final List<FloatingBallEntry> updated;
+  final List<FloatingBallEntry> added;
+
+  FloatingBallDelta(this.removed, this.updated, this.added);
+
+  bool get isEmpty => removed.isEmpty && updated.isEmpty && added.isEmpty;
+
+  /// Returns null when retained tasks changed relative order; the ball only
+  /// positions new rows, so a reorder needs a snapshot.
+  static FloatingBallDelta? between(
+      List<FloatingBallEntry> previous, List<FloatingBallEntry> next) {
+    final nextById = {for (final e in next) e.id: e};
+    final previousById = {for (final e in previous) e.id: e};
+
+    final removed = <FloatingBallEntry>[];
+    final retained = <String>[];
+    for (final e in previous) {
+      if (nextById.containsKey(e.id)) {
+        retained.add(e.id);
+      } else {
+        removed.add(e);
+      }
+    }
+
+    final updated = <FloatingBallEntry>[];
+    final added = <FloatingBallEntry>[];
+    var r = 0;
+    for (var i = 0; i < next.length; i++) {
+      final e = next[i];
+      final old = previousById[e.id];
+      if (old == null) {
+        added.add(e.at(i));
+        continue;
+      }
+      if (r >= retained.length || retained[r] != e.id) return null;
+      r++;
+      if (!old.sameContent(e)) updated.add(e);
+    }
+    return FloatingBallDelta(removed, updated, added);
+  }
+}
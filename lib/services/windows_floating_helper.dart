@@ -4,7 +4,7 @@ import '../models/task.dart';
 import 'windows_ipc.dart';
 
 class WindowsFloatingHelper {
-  /// Launch native floating window exe. Returns true if process started.
+  /// Launch native floating window exe. Returns true once the ball is up.
   static Future<bool> launchNativeFloating({String? exePath}) async {
     if (!Platform.isWindows) return false;
     // Search deterministic and fallback build paths
@@ -44,7 +44,13 @@ class WindowsFloatingHelper {
             }
           } catch (_) {}
 
-          await Process.start(file.path, const [], runInShell: true);
+          // The runner spawns the ball directly and waits for its ready
+          // signal; older runners without the launcher fall back to a plain
+          // start plus a short grace period.
+          final ready = await WindowsFloatingIpc.launchBall(file.path);
+          if (ready != null) return ready;
+          await Process.start(file.path, const []);
+          await Future.delayed(const Duration(milliseconds: 300));
           return true;
         }
       } catch (_) {}
@@ -52,14 +58,19 @@ class WindowsFloatingHelper {
     return false;
   }
 
-  /// Launch native floating window and sync unread tasks once (after a short delay).
+  /// Launch native floating window and sync unread tasks as soon as it is
+  /// ready.
   static Future<bool> launchFloatingAndSync(List<Task> unread, {String? exePath}) async {
     final ok = await launchNativeFloating(exePath: exePath);
-    if (ok) {
-      // Give the floating window time to create
-      await Future.delayed(const Duration(milliseconds: 300));
-      WindowsFloatingIpc.sendUnreadTasks(unread);
-    }
+    // Sent even when the launch failed: the list is recorded by
+    // WindowsFloatingIpc and replayed once a ball reports ready.
+    WindowsFloatingIpc.sendUnreadTasks(unread);
     return ok;
   }
+
+  /// The runner restarted the ball after a crash: send it the last list
+  /// published through [WindowsFloatingIpc.sendUnreadTasks].
+  static void onBallRestarted() {
+    WindowsFloatingIpc.resendUnreadTasks();
+  }
 }
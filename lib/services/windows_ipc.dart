@@ -1,43 +1,306 @@
 // Windows-only: WM_COPYDATA sender to native floating window
+import 'dart:convert' show jsonDecode;
 import 'dart:ffi' as ffi;
 import 'dart:io' show Platform;
+import 'dart:typed_data';
 import 'package:ffi/ffi.dart';
+import 'package:flutter/services.dart';
 import 'package:win32/win32.dart' as win32;
 import '../models/task.dart';
+import 'floating_ball_wire.dart';
+
+// SendMessageTimeoutW, bound directly so the exact signature doesn't depend
+// on the win32 package version.
+typedef _SendMessageTimeoutNative = ffi.IntPtr Function(ffi.IntPtr hWnd,
+    ffi.Uint32 msg, ffi.UintPtr wParam, ffi.IntPtr lParam, ffi.Uint32 flags,
+    ffi.Uint32 timeoutMs, ffi.Pointer<ffi.UintPtr> result);
+typedef _SendMessageTimeoutDart = int Function(int hWnd, int msg, int wParam,
+    int lParam, int flags, int timeoutMs, ffi.Pointer<ffi.UintPtr> result);
 
 class WindowsFloatingIpc {
   static const String _floatingClassName = 'NativeFloatingBallWindow';
 
+  /// Upper bound a send may block the UI thread when the ball is busy.
+  static const int _sendTimeoutMs = 200;
+  static const int _smtoAbortIfHung = 0x0002;
+  static const int _smtoErrorOnExit = 0x0020;
+
+  static _SendMessageTimeoutDart? _sendMessageTimeoutFn;
+
+  /// Snapshots at least this large go through the runner's shared-memory
+  /// channel (one tiny notification instead of a kernel copy per update).
+  static const int _sharedSnapshotMinBytes = 32 * 1024;
+  static const MethodChannel _channel =
+      MethodChannel('chat_desktop/floating_ball');
+  static Future<bool> _sendChain = Future.value(true);
+  static const EventChannel _events =
+      EventChannel('chat_desktop/floating_ball/events');
+
+  // Delta sync state: the last list the ball acknowledged and the sequence
+  // number of the last message sent to it.
+  static int _peerHwnd = 0;
+  static int _sequence = 0;
+  static List<FloatingBallEntry>? _acked;
+
+  /// The list most recently passed to [sendUnreadTasks], whether or not the
+  /// ball was up to take it; [resendUnreadTasks] replays it.
+  static List<Task> _lastUnread = const [];
+
+  /// Messages from the native floating ball, decoded by the runner and
+  /// delivered in batches (one list per platform-channel hop). The runner has
+  /// already restored the main window when an event arrives.
+  static Stream<List<FloatingBallEvent>> events() {
+    if (!Platform.isWindows) return const Stream.empty();
+    return _events.receiveBroadcastStream().map((batch) => [
+          for (final e in batch as List)
+            FloatingBallEvent._fromMap(Map<Object?, Object?>.from(e as Map)),
+        ]);
+  }
+
   /// Send unread tasks to native floating window (hover bubble).
-  /// The floating app expects WM_COPYDATA with dwData=1 and a UTF-16 payload
-  /// where each line is: "<id> <title>".
-  static bool sendUnreadTasks(List<Task> unread) {
-    if (!Platform.isWindows) return false;
+  /// Once the ball has acknowledged a sequenced snapshot, only the
+  /// REMOVE/UPDATE/ADD deltas against it are sent. A gap reported by the ball,
+  /// a reorder, or a new ball window falls back to a fresh snapshot; large
+  /// snapshots are published through shared memory by the runner. Older
+  /// floating builds that don't understand the binary payload
+  /// ([FloatingBallWire], dwData=4) get the legacy text payload (dwData=1,
+  /// one "<id> <title>" line per task).
+  ///
+  /// Calls are serialized so sequence numbers reach the ball in order.
+  static Future<bool> sendUnreadTasks(List<Task> unread) {
+    if (!Platform.isWindows) return Future.value(false);
+    _lastUnread = unread;
+    return _enqueue(() => _sendUnreadTasks(unread));
+  }
+
+  /// Sends the last list given to [sendUnreadTasks] as a fresh snapshot, for
+  /// a ball that was (re)started and holds no list. Resolved when the send
+  /// runs, so an update queued before it is not overtaken by an older list.
+  static Future<bool> resendUnreadTasks() {
+    if (!Platform.isWindows) return Future.value(false);
+    return _enqueue(() {
+      _acked = null;
+      return _sendUnreadTasks(_lastUnread);
+    });
+  }
+
+  static Future<bool> _enqueue(Future<bool> Function() send) {
+    final next = _sendChain.then((_) => send(), onError: (_) => send());
+    _sendChain = next;
+    return next;
+  }
+
+  static Future<bool> _sendUnreadTasks(List<Task> unread) async {
+    final hwnd = _resolveBall();
+    if (hwnd == 0) {
+      _acked = null;
+      return false; // floating window not found
+    }
+    if (hwnd != _peerHwnd) {
+      // Ball restarted: its list is empty and its sequence unknown
+      _peerHwnd = hwnd;
+      _acked = null;
+    }
 
+    final seen = <String>{};
+    final entries = <FloatingBallEntry>[
+      for (final t in unread)
+        if (seen.add(t.id.toString())) FloatingBallEntry.fromTask(t),
+    ];
+
+    final acked = _acked;
+    if (acked != null) {
+      final delta = FloatingBallDelta.between(acked, entries);
+      if (delta != null) {
+        final result = _sendDelta(hwnd, delta);
+        if (result == FloatingBallWire.resultApplied) {
+          _acked = entries;
+          return true;
+        }
+        if (result == null) {
+          _acked = null; // timed out: resync on the next update
+          return false;
+        }
+      }
+    }
+
+    final snapshot = FloatingBallWire.encode(
+        FloatingBallWire.kindSnapshot, entries,
+        sequence: _nextSequence());
+    var result = snapshot.length >= _sharedSnapshotMinBytes
+        ? await _publishShared(snapshot)
+        : null;
+    if (result == FloatingBallWire.resultApplied) {
+      _acked = entries;
+      return true;
+    }
+    // The shared section is unavailable or was rejected (e.g. the ball could
+    // not map it): the same snapshot may still be accepted over WM_COPYDATA.
+    // Only a rejected binary send means the ball predates the wire format.
+    result = _sendBytes(hwnd, FloatingBallWire.copyDataId, snapshot) ?? -1;
+    if (result == FloatingBallWire.resultApplied) {
+      _acked = entries;
+      return true;
+    }
+    _acked = null;
+    // A busy/hung ball timed out: don't block again on the text payload;
+    // the next update re-sends a snapshot.
+    if (result != FloatingBallWire.resultRejected) return false;
+    return _sendLegacyText(hwnd, unread);
+  }
+
+  /// The cached ball window if it is still alive with the expected class,
+  /// otherwise one FindWindow lookup. Avoids a window search per update.
+  static int _resolveBall() {
+    final cached = _peerHwnd;
+    if (cached != 0 && win32.IsWindow(cached) != 0 && _hasBallClass(cached)) {
+      return cached;
+    }
     final className = _floatingClassName.toNativeUtf16(allocator: calloc);
     try {
-      final hwnd = win32.FindWindow(className, ffi.nullptr);
-      if (hwnd == 0) {
-        return false; // floating window not found
-      }
+      return win32.FindWindow(className, ffi.nullptr);
+    } finally {
+      calloc.free(className);
+    }
+  }
 
-      final lines = unread.map((t) => '${t.id} ${t.title}').join('\n');
-      // UTF-16 payload including terminating NUL
-      final payload = lines.toNativeUtf16(allocator: calloc);
-      // Define local COPYDATASTRUCT to avoid platform typedef issues
-      final cds = calloc<_COPYDATASTRUCT>();
-      cds.ref.dwData = ffi.sizeOf<ffi.IntPtr>() == 8 ? 1 : 1; // 1 = UPDATE_TASKS
-      cds.ref.cbData = (lines.length + 1) * 2; // bytes
-      cds.ref.lpData = payload.cast();
+  static bool _hasBallClass(int hwnd) {
+    const capacity = 64;
+    final buffer = calloc<ffi.Uint16>(capacity).cast<Utf16>();
+    try {
+      final len = win32.GetClassName(hwnd, buffer, capacity);
+      return len > 0 && buffer.toDartString(length: len) == _floatingClassName;
+    } finally {
+      calloc.free(buffer);
+    }
+  }
 
-      // WM_COPYDATA = 0x004A
-      win32.SendMessage(hwnd, 0x004A, 0, cds.address);
+  /// Window-message dispatch profile of the main process (counts and latency
+  /// per message type). The floating ball writes its own table to its log.
+  static Future<String?> dumpDispatchProfile() async {
+    if (!Platform.isWindows) return null;
+    try {
+      return await _channel.invokeMethod<String>('dumpDispatchProfile');
+    } on MissingPluginException {
+      return null;
+    }
+  }
 
+  /// Per-subsystem memory accounting of the floating ball (current and peak
+  /// bytes for animation frames, render resources, IPC buffers, bubble scene
+  /// and logging, plus the process private bytes). The ball also writes the
+  /// table to its log. Null when the ball is not running or did not answer.
+  static Future<Map<String, dynamic>?> dumpMemoryReport() async {
+    if (!Platform.isWindows) return null;
+    try {
+      final json = await _channel.invokeMethod<String>('dumpMemoryReport');
+      return json == null ? null : jsonDecode(json) as Map<String, dynamic>;
+    } on MissingPluginException {
+      return null;
+    }
+  }
+
+  /// Starts the native floating ball through the runner (no shell) and
+  /// completes once the ball reports its window and GIFs are live, so the
+  /// first snapshot can be sent right away. Returns null when the runner does
+  /// not provide the launcher, false if the ball could not be started.
+  static Future<bool?> launchBall(String exePath) async {
+    if (!Platform.isWindows) return false;
+    try {
+      return await _channel.invokeMethod<bool>('launchBall', exePath);
+    } on MissingPluginException {
+      return null;
+    }
+  }
+
+  /// Shared-memory snapshot via the runner. Returns the ball's reply, or null
+  /// if the channel is unavailable and WM_COPYDATA should be used instead.
+  static Future<int?> _publishShared(Uint8List snapshot) async {
+    try {
+      final result =
+          await _channel.invokeMethod<int>('publishTaskSnapshot', snapshot);
+      return (result == null || result < 0) ? null : result;
+    } on MissingPluginException {
+      return null;
+    } on PlatformException {
+      return null;
+    }
+  }
+
+  /// Returns resultApplied if every message was applied, otherwise the first
+  /// failing reply (null on timeout).
+  static int? _sendDelta(int hwnd, FloatingBallDelta delta) {
+    final messages = [
+      (FloatingBallWire.kindRemove, delta.removed),
+      (FloatingBallWire.kindUpdate, delta.updated),
+      (FloatingBallWire.kindAdd, delta.added),
+    ];
+    for (final (kind, entries) in messages) {
+      if (entries.isEmpty) continue;
+      final result = _sendBinary(hwnd, kind, entries);
+      if (result != FloatingBallWire.resultApplied) return result;
+    }
+    return FloatingBallWire.resultApplied;
+  }
+
+  static int _nextSequence() {
+    _sequence = _sequence >= 0xFFFFFFFF ? 1 : _sequence + 1; // 0 = unsequenced
+    return _sequence;
+  }
+
+  /// WM_COPYDATA with a bounded wait. Returns the receiver's reply, or null
+  /// if it timed out, is hung, or went away.
+  static int? _sendCopyData(
+      int hwnd, int dwData, ffi.Pointer<ffi.Void> data, int bytes) {
+    final send = _sendMessageTimeoutFn ??= ffi.DynamicLibrary.open('user32.dll')
+        .lookupFunction<_SendMessageTimeoutNative, _SendMessageTimeoutDart>(
+            'SendMessageTimeoutW');
+    final cds = calloc<_COPYDATASTRUCT>();
+    final reply = calloc<ffi.UintPtr>();
+    try {
+      cds.ref.dwData = dwData;
+      cds.ref.cbData = bytes;
+      cds.ref.lpData = data;
+      // WM_COPYDATA = 0x004A
+      final ok = send(hwnd, 0x004A, 0, cds.address,
+          _smtoAbortIfHung | _smtoErrorOnExit, _sendTimeoutMs, reply);
+      return ok == 0 ? null : reply.value;
+    } finally {
+      calloc.free(reply);
       calloc.free(cds);
-      calloc.free(payload);
-      return true;
+    }
+  }
+
+  static int? _sendBinary(int hwnd, int kind, List<FloatingBallEntry> entries) {
+    final bytes =
+        FloatingBallWire.encode(kind, entries, sequence: _nextSequence());
+    // The ball replies with FloatingBallWire.result*
+    return _sendBytes(hwnd, FloatingBallWire.copyDataId, bytes);
+  }
+
+  static int? _sendBytes(int hwnd, int dwData, Uint8List bytes) {
+    final data = calloc<ffi.Uint8>(bytes.length);
+    try {
+      data.asTypedList(bytes.length).setAll(0, bytes);
+      return _sendCopyData(hwnd, dwData, data.cast(), bytes.length);
     } finally {
-      calloc.free(className);
+      calloc.free(data);
+    }
+  }
+
+  static bool _sendLegacyText(int hwnd, List<Task> unread) {
+    // Titles are flattened to one line: the text format is newline-delimited
+    final lines = unread
+        .map((t) => '${t.id} ${t.title.replaceAll(RegExp(r'[\r\n]+'), ' ')}')
+        .join('\n');
+    // UTF-16 payload including terminating NUL
+    final payload = lines.toNativeUtf16(allocator: calloc);
+    try {
+      // 1 = UPDATE_TASKS
+      return _sendCopyData(hwnd, 1, payload.cast(), (lines.length + 1) * 2) !=
+          null;
+    } finally {
+      calloc.free(payload);
     }
   }
 
@@ -51,8 +314,8 @@ class WindowsFloatingIpc {
     try {
       final hwndBall = win32.FindWindow(clsBall, ffi.nullptr);
       if (hwndBall != 0) {
-        // WM_CLOSE = 0x0010
-        win32.SendMessage(hwndBall, 0x0010, 0, 0);
+        // WM_CLOSE = 0x0010; posted so a busy ball can't block the caller
+        win32.PostMessage(hwndBall, 0x0010, 0, 0);
         closed = true;
       }
     } finally {
@@ -63,7 +326,7 @@ class WindowsFloatingIpc {
     try {
       final hwndBubble = win32.FindWindow(clsBubble, ffi.nullptr);
       if (hwndBubble != 0) {
-        win32.SendMessage(hwndBubble, 0x0010, 0, 0);
+        win32.PostMessage(hwndBubble, 0x0010, 0, 0);
         closed = true;
       }
     } finally {
@@ -83,3 +346,32 @@ base class _COPYDATASTRUCT extends ffi.Struct {
 
   external ffi.Pointer<ffi.Void> lpData;
 }
+
+/// An event from the native floating ball, a relaunch of the app that the
+/// runner forwarded to this instance, or a ball restart
+/// (see [WindowsFloatingIpc.events]).
+class FloatingBallEvent {
+  static const String typeOpenTask = 'open_task';
+  static const String typeRestore = 'restore';
+  static const String typeActivate = 'activate';
+
+  /// The runner restarted a crashed ball; it needs a fresh snapshot.
+  static const String typeBallReady = 'ball_ready';
+
+  final String type;
+
+  /// Set for [typeOpenTask].
+  final String? taskId;
+
+  /// Command-line arguments of the relaunch, set for [typeActivate].
+  final List<String> args;
+
+  const FloatingBallEvent(this.type, {this.taskId, this.args = const []});
+
+  factory FloatingBallEvent._fromMap(Map<Object?, Object?> map) =>
+      FloatingBallEvent(map['type'] as String? ?? '',
+          taskId: map['taskId'] as String?,
+          args: [
+            for (final a in (map['args'] as List?) ?? const []) a as String,
+          ]);
+}
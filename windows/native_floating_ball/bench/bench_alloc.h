@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+
+// 基准进程内的全局堆分配计数（替换了全局 operator new），用于验证“稳态零分配”一类的目标。
+uint64_t BenchAllocationCount();
+
+// 作用域内的分配次数
+class BenchAllocationScope {
+public:
+  BenchAllocationScope() : m_start(BenchAllocationCount()) {}
+  uint64_t Count() const { return BenchAllocationCount() - m_start; }
+
+private:
+  uint64_t m_start;
+};
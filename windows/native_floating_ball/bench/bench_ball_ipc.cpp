@@ -0,0 +1,62 @@
+// 悬浮球 → 主程序消息的解码与合批：一次突发（连续点击 + 恢复请求）从 WM_COPYDATA
+// 解码到产出一批事件的开销，以及合批后每批的事件数（一次平台通道往返）
+#include <string>
+#include <vector>
+#include "bench_alloc.h"
+#include "bench_harness.h"
+#include "core/ball_ipc.h"
+
+namespace {
+
+struct RawMessage {
+  uintptr_t dwData;
+  std::u16string payload;
+};
+
+// 模拟一次突发：用户连点同一任务、换一个任务再点、期间夹杂恢复主窗口请求
+std::vector<RawMessage> MakeBurst(size_t n) {
+  std::vector<RawMessage> burst;
+  for (size_t i = 0; i < n; ++i) {
+    if (i % 4 == 3) {
+      burst.push_back({kBallIpcRestoreMain, u"restore_main_window"});
+      continue;
+    }
+    std::u16string id;
+    for (char c : std::to_string(100000 + i / 3)) id += (char16_t)c;
+    burst.push_back({kBallIpcOpenTask, EncodeOpenTask(id)});
+  }
+  return burst;
+}
+
+void BM_BallIpcDecodeBatch(BenchState& state) {
+  const std::vector<RawMessage> burst = MakeBurst(32);
+  BallIpcBatch batch;
+  size_t batches = 0, events = 0;
+  BenchAllocationScope allocs;
+  while (state.KeepRunning()) {
+    for (const RawMessage& m : burst) {
+      BallIpcEvent event;
+      if (DecodeBallIpc(m.dwData, m.payload.data(), m.payload.size() * sizeof(char16_t), &event)) {
+        batch.Push(std::move(event));
+      }
+    }
+    events += batch.Take().size();
+    ++batches;
+  }
+  state.SetItemsProcessed(state.Iterations() * burst.size());
+  state.SetCounter("messages_per_batch", (double)burst.size());
+  state.SetCounter("events_per_batch", batches ? (double)events / batches : 0.0);
+  state.SetCounter("allocs_per_message", (double)allocs.Count() / ((double)state.Iterations() * burst.size()));
+}
+NFB_BENCHMARK(BM_BallIpcDecodeBatch);
+
+void BM_BallIpcEncodeOpenTask(BenchState& state) {
+  const std::u16string id = u"task-\"42\"";
+  while (state.KeepRunning()) {
+    DoNotOptimize(EncodeOpenTask(id).size());
+  }
+  state.SetItemsProcessed(state.Iterations());
+}
+NFB_BENCHMARK(BM_BallIpcEncodeOpenTask);
+
+} // namespace
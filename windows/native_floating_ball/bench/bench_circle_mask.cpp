@@ -0,0 +1,79 @@
+// 圆形蒙版：按直径构建一次的开销、乘进一帧的开销（显示尺寸帧构建时每帧一次），
+// 以及与 256x256 超采样参考的最大覆盖率误差（1/255 为单位）和总面积相对 πr² 的误差
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "bench_harness.h"
+#include "core/circle_mask.h"
+
+namespace {
+
+// 参考覆盖率：边缘像素 256x256 超采样（与 CircleMask 同一几何：圆心在中心，半径 (d - 2) / 2）
+int ReferenceCoverage(uint32_t d, uint32_t x, uint32_t y) {
+  constexpr int kRef = 256;
+  const double c = d / 2.0, r = (d - 2.0) / 2.0;
+  int inside = 0;
+  for (int sy = 0; sy < kRef; ++sy) {
+    const double py = y + (sy + 0.5) / kRef - c;
+    for (int sx = 0; sx < kRef; ++sx) {
+      const double px = x + (sx + 0.5) / kRef - c;
+      if (px * px + py * py <= r * r) ++inside;
+    }
+  }
+  return (inside * 255 + kRef * kRef / 2) / (kRef * kRef);
+}
+
+void RunBuild(BenchState& state, uint32_t diameter) {
+  CircleMask mask;
+  while (state.KeepRunning()) {
+    mask.Build(diameter);
+    DoNotOptimize(mask.Row(diameter / 2));
+  }
+  state.SetItemsProcessed(state.Iterations());
+  // 精度只在最后算一次，不计入上面的循环（基准函数整体计时，这部分摊在所有迭代上）
+  if (state.Iterations() < 16) return;
+  int maxError = 0;
+  double area = 0.0;
+  for (uint32_t y = 0; y < diameter; ++y) {
+    const CircleMask::Span& span = mask.RowSpan(y);
+    for (uint32_t x = span.first; x < span.last; ++x) {
+      const uint8_t cov = mask.Coverage(x, y);
+      area += cov / 255.0;
+      if (cov != 0 && cov != 255) maxError = (std::max)(maxError, std::abs(cov - ReferenceCoverage(diameter, x, y)));
+    }
+  }
+  const double r = (diameter - 2.0) / 2.0;
+  const double exact = 3.14159265358979 * r * r;
+  state.SetCounter("max_cov_error", (double)maxError);
+  state.SetCounter("area_error_pct", 100.0 * std::fabs(area - exact) / exact);
+}
+
+void RunApply(BenchState& state, uint32_t diameter) {
+  CircleMask mask;
+  mask.Build(diameter);
+  std::vector<uint8_t> frame((size_t)diameter * diameter * 4);
+  for (size_t i = 0; i < frame.size(); ++i) frame[i] = (uint8_t)(i * 7);
+  const std::vector<uint8_t> source = frame;
+  while (state.KeepRunning()) {
+    frame = source;
+    mask.Apply(frame.data(), (size_t)diameter * 4);
+    DoNotOptimize(frame.data());
+  }
+  state.SetItemsProcessed(state.Iterations());
+  state.SetBytesProcessed(state.Iterations() * frame.size());
+}
+
+[[maybe_unused]] const bool kRegistered = [] {
+  for (uint32_t diameter : { 120u, 240u }) { // 100% / 200% 缩放
+    RegisterBenchmark("BM_CircleMaskBuild/" + std::to_string(diameter),
+                      [diameter](BenchState& state) { RunBuild(state, diameter); });
+    RegisterBenchmark("BM_CircleMaskApply/" + std::to_string(diameter),
+                      [diameter](BenchState& state) { RunApply(state, diameter); });
+  }
+  return true;
+}();
+
+} // namespace
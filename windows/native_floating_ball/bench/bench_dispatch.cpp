@@ -0,0 +1,23 @@
+// 消息分发剖析本身的开销：每条消息两次时钟读取 + 一次表查找，须远小于消息处理本身
+#include <cstdint>
+#include "bench_harness.h"
+#include "core/dispatch_profiler.h"
+
+namespace {
+
+// 鼠标移动时的典型消息流
+constexpr uint32_t kMessages[] = { 0x0084, 0x0020, 0x0200, 0x0084, 0x0020, 0x0200, 0x0113, 0xC123 };
+
+void BM_DispatchProfilerScope(BenchState& state) {
+  DispatchProfiler profiler;
+  size_t i = 0;
+  while (state.KeepRunning()) {
+    DispatchProfiler::Scope scope(profiler, kMessages[i++ & 7]);
+  }
+  state.SetItemsProcessed(state.Iterations());
+  const DispatchProfiler::Entry* hit = profiler.Find(0x0084);
+  state.SetCounter("nchittest_p99_ns", hit ? (double)hit->PercentileNs(0.99) : 0.0);
+}
+NFB_BENCHMARK(BM_DispatchProfilerScope);
+
+} // namespace
@@ -0,0 +1,303 @@
+// 端到端 IPC：本进程充当发送端（替代 Dart 主程序），fork 出的子进程运行悬浮球的可移植接收路径
+// （解码 → 序号校验 → 列表模型 → 视口排版 → 软件渲染到内存帧）。
+//
+// 传输用 socketpair 模拟 WM_COPYDATA 的同步语义：发送端写入一条消息后等待应答（模型已应用），
+// 悬浮球在没有待处理消息时才渲染一帧并回报帧内最后的序号（对应 kMsgTasksChanged 的合并刷新）。
+// 报告两种延迟的 p50/p99：ack（发送 → 模型已应用）与 pixels（发送 → 包含该更新的帧已画完），
+// 以及持续吞吐 updates_per_s。列表规模 × 发送速率（不限速 / 1000/s / 120/s）各一组。
+// 仅 POSIX（Linux/macOS）；Windows 上真实进程的测量见悬浮球日志。
+#if !defined(_WIN32)
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_harness.h"
+#include "synthetic_rasterizer.h"
+#include "core/glyph_atlas.h"
+#include "core/list_viewport.h"
+#include "core/task_list_model.h"
+#include "core/task_sync.h"
+#include "core/task_wire.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr float kFontSize = 13.f;
+constexpr float kMaxTextWidth = 260.f;
+constexpr int kBubbleW = 280;
+constexpr int kBubbleH = 240;
+
+// 悬浮球 → 发送端的回报：1 字节类型 + u32 值
+enum ReplyType : uint8_t { kReplyAck = 1, kReplyFrame = 2 };
+
+bool WriteAll(int fd, const void* data, size_t size) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  while (size) {
+    const ssize_t n = write(fd, p, size);
+    if (n <= 0) return false;
+    p += n;
+    size -= (size_t)n;
+  }
+  return true;
+}
+
+bool ReadAll(int fd, void* data, size_t size) {
+  uint8_t* p = static_cast<uint8_t*>(data);
+  while (size) {
+    const ssize_t n = read(fd, p, size);
+    if (n <= 0) return false;
+    p += n;
+    size -= (size_t)n;
+  }
+  return true;
+}
+
+bool SendReply(int fd, ReplyType type, uint32_t value) {
+  uint8_t buf[5] = { type };
+  std::memcpy(buf + 1, &value, 4);
+  return WriteAll(fd, buf, sizeof(buf));
+}
+
+// 子进程：悬浮球的接收与渲染路径（与 BallWindow/BubbleWindow 的可移植部分一致）
+class BallPipeline {
+public:
+  void Run(int fd) {
+    std::vector<uint8_t> msg;
+    uint32_t lastApplied = 0;
+    bool dirty = false;
+    for (;;) {
+      uint32_t len = 0;
+      if (!ReadAll(fd, &len, sizeof(len)) || len == 0) return;
+      msg.resize(len);
+      if (!ReadAll(fd, msg.data(), len)) return;
+      const TaskSyncResult r = m_sync.Apply(msg.data(), msg.size(), m_model);
+      if (r == TaskSyncResult::Applied) {
+        lastApplied = m_sync.LastSequence();
+        dirty = true;
+      }
+      if (!SendReply(fd, kReplyAck, (uint32_t)r)) return;
+      // 合并刷新：只有没有后续消息排队时才画（对应 PostMessage 的 kMsgTasksChanged）
+      pollfd pfd{ fd, POLLIN, 0 };
+      if (dirty && poll(&pfd, 1, 0) == 0) {
+        RenderFrame();
+        dirty = false;
+        if (!SendReply(fd, kReplyFrame, lastApplied)) return;
+      }
+    }
+  }
+
+private:
+  void RenderFrame() {
+    m_viewport.itemCount = (int)m_model.Size();
+    m_viewport.viewportHeight = m_viewport.PreferredHeight(8);
+    m_viewport.ClampScroll();
+    int first = 0, last = 0;
+    m_viewport.VisibleRange(&first, &last);
+    std::fill(m_frame.begin(), m_frame.end(), (uint8_t)0);
+    for (int i = first; i < last; ++i) {
+      const TaskRow& row = m_model.Row(i);
+      const std::u16string& text = row.item.title.empty() ? row.item.id : row.item.title;
+      const ShapedLine* line = m_lines.Get(m_atlas, m_raster, text, kFontSize, 96, kMaxTextWidth);
+      if (!line) continue;
+      BlitLine(*line, m_atlas, m_frame.data(), kBubbleW * 4, kBubbleW, kBubbleH,
+               10, (int)m_viewport.RowTop(i), 0xF2FFFFFFu, 1.f);
+    }
+    DoNotOptimize(m_frame.data());
+  }
+
+  TaskSyncReceiver m_sync;
+  TaskListModel m_model;
+  ListViewport m_viewport;
+  SyntheticRasterizer m_raster;
+  GlyphAtlas m_atlas;
+  ShapedTextCache m_lines;
+  std::vector<uint8_t> m_frame = std::vector<uint8_t>((size_t)kBubbleW * kBubbleH * 4, 0);
+};
+
+struct Tasks {
+  std::vector<std::u16string> ids;
+  std::vector<std::u16string> titles;
+};
+
+std::u16string ToU16(const std::string& s) {
+  std::u16string out;
+  for (char c : s) out += (char16_t)c;
+  return out;
+}
+
+Tasks MakeTasks(size_t count) {
+  static const char16_t* kSamples[] = {
+    u"请于本周五前提交季度预算调整方案并同步财务部",
+    u"Review PR #1284: fix race in task sync",
+    u"客户回访：华东区 12 家门店满意度调查（第二批）",
+    u"整理会议纪要",
+  };
+  Tasks t;
+  for (size_t i = 0; i < count; ++i) {
+    t.ids.push_back(ToU16(std::to_string(100000 + i)));
+    t.titles.push_back(kSamples[i % (sizeof(kSamples) / sizeof(kSamples[0]))]);
+  }
+  return t;
+}
+
+double Percentile(std::vector<double>& v, double p) {
+  if (v.empty()) return 0.0;
+  const size_t k = (size_t)(p * (double)(v.size() - 1));
+  std::nth_element(v.begin(), v.begin() + (ptrdiff_t)k, v.end());
+  return v[k];
+}
+
+class StandInSender {
+public:
+  explicit StandInSender(int fd) : m_fd(fd) {}
+
+  bool Send(const std::vector<uint8_t>& msg, uint32_t seq, uint32_t* result) {
+    const uint32_t len = (uint32_t)msg.size();
+    const Clock::time_point t0 = Clock::now();
+    if (!WriteAll(m_fd, &len, sizeof(len)) || !WriteAll(m_fd, msg.data(), msg.size())) return false;
+    if (seq) m_pending.push_back({ seq, t0 });
+    // 同步等待 ack（SendMessage 语义）；途中收到的帧回报一并记账
+    for (;;) {
+      uint8_t buf[5];
+      if (!ReadAll(m_fd, buf, sizeof(buf))) return false;
+      uint32_t value = 0;
+      std::memcpy(&value, buf + 1, 4);
+      if (buf[0] == kReplyFrame) { OnFrame(value); continue; }
+      if (seq) m_ack.push_back(Ms(Clock::now() - t0));
+      *result = value;
+      return true;
+    }
+  }
+
+  // 收尾：等待最后一帧回报
+  void Drain(uint32_t lastSeq) {
+    while (!m_pending.empty() && m_pending.front().seq <= lastSeq) {
+      pollfd pfd{ m_fd, POLLIN, 0 };
+      if (poll(&pfd, 1, 1000) <= 0) return;
+      uint8_t buf[5];
+      if (!ReadAll(m_fd, buf, sizeof(buf))) return;
+      uint32_t value = 0;
+      std::memcpy(&value, buf + 1, 4);
+      if (buf[0] == kReplyFrame) OnFrame(value);
+    }
+  }
+
+  std::vector<double>& AckMs() { return m_ack; }
+  std::vector<double>& PixelMs() { return m_pixels; }
+
+private:
+  struct Pending { uint32_t seq; Clock::time_point sent; };
+
+  static double Ms(Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); }
+
+  void OnFrame(uint32_t seq) {
+    const Clock::time_point now = Clock::now();
+    size_t n = 0;
+    while (n < m_pending.size() && m_pending[n].seq <= seq) {
+      m_pixels.push_back(Ms(now - m_pending[n].sent));
+      ++n;
+    }
+    m_pending.erase(m_pending.begin(), m_pending.begin() + (ptrdiff_t)n);
+  }
+
+  int m_fd;
+  std::vector<Pending> m_pending;
+  std::vector<double> m_ack;
+  std::vector<double> m_pixels;
+};
+
+// rate = 0 表示不限速（上一条 ack 后立即发送下一条）
+void RunEndToEnd(BenchState& state, size_t listSize, double rate) {
+  int sv[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) { state.SetLabel("socketpair failed"); return; }
+  const pid_t pid = fork();
+  if (pid < 0) { close(sv[0]); close(sv[1]); state.SetLabel("fork failed"); return; }
+  if (pid == 0) {
+    close(sv[0]);
+    BallPipeline ball;
+    ball.Run(sv[1]);
+    close(sv[1]);
+    _exit(0);
+  }
+  close(sv[1]);
+  const int fd = sv[0];
+
+  Tasks tasks = MakeTasks(listSize);
+  TaskWireWriter writer;
+  TaskItemView v;
+  uint32_t seq = 1;
+  uint32_t result = 0;
+  writer.Begin(TaskWireKind::Snapshot, seq);
+  for (size_t i = 0; i < listSize; ++i) {
+    v.id = tasks.ids[i];
+    v.title = tasks.titles[i];
+    writer.Add(v);
+  }
+  StandInSender sender(fd);
+  bool ok = sender.Send(writer.Finish(), 0, &result) && result == (uint32_t)TaskSyncResult::Applied;
+  sender.AckMs().clear();
+
+  // 每次迭代：改一条可见区附近的标题（发送端的一次任务变化），作为带序号的 UPDATE 增量
+  const Clock::duration interval = rate > 0.0
+      ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate))
+      : Clock::duration::zero();
+  std::u16string title;
+  Clock::time_point next = Clock::now();
+  const Clock::time_point start = next;
+  uint64_t sent = 0;
+  while (ok && state.KeepRunning()) {
+    if (rate > 0.0) {
+      std::this_thread::sleep_until(next);
+      next += interval;
+    }
+    const size_t row = (size_t)(sent % (std::min)(listSize, (size_t)16));
+    title = tasks.titles[row];
+    title += u" · ";
+    title += ToU16(std::to_string(sent));
+    v.id = tasks.ids[row];
+    v.title = title;
+    writer.Begin(TaskWireKind::Update, ++seq);
+    writer.Add(v);
+    ok = sender.Send(writer.Finish(), seq, &result) && result == (uint32_t)TaskSyncResult::Applied;
+    ++sent;
+  }
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  sender.Drain(seq);
+
+  const uint32_t stop = 0;
+  WriteAll(fd, &stop, sizeof(stop));
+  close(fd);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  if (!ok) state.SetLabel("ball rejected an update");
+
+  state.SetItemsProcessed(sent);
+  state.SetCounter("ack_p50_us", Percentile(sender.AckMs(), 0.50) * 1000.0);
+  state.SetCounter("ack_p99_us", Percentile(sender.AckMs(), 0.99) * 1000.0);
+  state.SetCounter("pixels_p50_us", Percentile(sender.PixelMs(), 0.50) * 1000.0);
+  state.SetCounter("pixels_p99_us", Percentile(sender.PixelMs(), 0.99) * 1000.0);
+  state.SetCounter("updates_per_s", seconds > 0.0 ? (double)sent / seconds : 0.0);
+}
+
+[[maybe_unused]] const bool kRegistered = [] {
+  for (size_t listSize : { (size_t)100, (size_t)1000, (size_t)10000 }) {
+    for (double rate : { 0.0, 1000.0, 120.0 }) {
+      std::string name = "BM_EndToEndIpc/" + std::to_string(listSize) + "/";
+      name += rate > 0.0 ? std::to_string((int)rate) + "hz" : "unpaced";
+      RegisterBenchmark(name, [listSize, rate](BenchState& state) { RunEndToEnd(state, listSize, rate); });
+    }
+  }
+  return true;
+}();
+
+} // namespace
+
+#endif // !_WIN32
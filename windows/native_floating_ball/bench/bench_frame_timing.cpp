@@ -0,0 +1,115 @@
+// 帧耗时统计的开销与精度：HDR 直方图单次记录、分位数查询，以及悬浮球一帧的完整埋点
+// （5 次时钟读取 + 4 个阶段 + 一次 FramePresented），须远小于一帧本身（百微秒量级）
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "bench_harness.h"
+#include "core/dispatch_profiler.h"
+#include "core/frame_timing.h"
+#include "core/hdr_histogram.h"
+
+namespace {
+
+// 对数正态的帧耗时样本：中位数约 200us，长尾到几毫秒
+std::vector<uint64_t> MakeSamples(size_t n) {
+  std::mt19937_64 rng(48);
+  std::lognormal_distribution<double> dist(std::log(200000.0), 0.6);
+  std::vector<uint64_t> samples(n);
+  for (uint64_t& s : samples) s = (uint64_t)dist(rng);
+  return samples;
+}
+
+void BM_HdrHistogramRecord(BenchState& state) {
+  const std::vector<uint64_t> samples = MakeSamples(4096);
+  HdrHistogram h;
+  size_t i = 0;
+  while (state.KeepRunning()) {
+    h.Record(samples[i++ & 4095]);
+  }
+  DoNotOptimize(h.Count());
+  state.SetItemsProcessed(state.Iterations());
+}
+NFB_BENCHMARK(BM_HdrHistogramRecord);
+
+// 同样的样本记进消息剖析的 2 的幂直方图，作对照
+void BM_Log2HistogramRecord(BenchState& state) {
+  const std::vector<uint64_t> samples = MakeSamples(4096);
+  DispatchProfiler profiler;
+  size_t i = 0;
+  while (state.KeepRunning()) {
+    profiler.Record(0x0113, samples[i++ & 4095]);
+  }
+  state.SetItemsProcessed(state.Iterations());
+}
+NFB_BENCHMARK(BM_Log2HistogramRecord);
+
+// 分位数查询（周期汇总与叠加层每帧一次），并给出与精确值相比的相对误差
+void BM_HdrHistogramPercentile(BenchState& state) {
+  std::vector<uint64_t> samples = MakeSamples(100000);
+  HdrHistogram h;
+  DispatchProfiler profiler;
+  for (uint64_t s : samples) {
+    h.Record(s);
+    profiler.Record(0x0113, s);
+  }
+  uint64_t p99 = 0;
+  while (state.KeepRunning()) {
+    p99 = h.Percentile(0.99);
+    DoNotOptimize(p99);
+  }
+  state.SetItemsProcessed(state.Iterations());
+  std::sort(samples.begin(), samples.end());
+  const double exact = (double)samples[(size_t)(0.99 * (double)(samples.size() - 1))];
+  state.SetCounter("p99_error_pct", 100.0 * std::fabs((double)p99 - exact) / exact);
+  const double log2 = (double)profiler.Find(0x0113)->PercentileNs(0.99);
+  state.SetCounter("log2_p99_error_pct", 100.0 * std::fabs(log2 - exact) / exact);
+}
+NFB_BENCHMARK(BM_HdrHistogramPercentile);
+
+// BallWindow::Render 的埋点原样照搬（不含绘制本身）
+void BM_BallFrameInstrumentation(BenchState& state) {
+  FrameTimings timings;
+  timings.Reset(FrameTimings::NowNs());
+  while (state.KeepRunning()) {
+    const uint64_t t0 = FrameTimings::NowNs();
+    const uint64_t s0 = FrameTimings::NowNs();
+    const uint64_t selectNs = FrameTimings::NowNs() - s0;
+    const uint64_t t1 = FrameTimings::NowNs();
+    const uint64_t t2 = FrameTimings::NowNs();
+    const uint64_t t3 = FrameTimings::NowNs();
+    timings.Record(FrameStage::BallSelect, selectNs);
+    timings.Record(FrameStage::BallDraw, t1 - t0 - selectNs);
+    timings.Record(FrameStage::BallEndDraw, t2 - t1);
+    timings.Record(FrameStage::BallPresent, t3 - t2);
+    timings.FramePresented(FrameSurface::Ball, t3, t3 - t0, 40000000);
+    DoNotOptimize(timings.SummaryDue(t3));
+  }
+  state.SetItemsProcessed(state.Iterations());
+}
+NFB_BENCHMARK(BM_BallFrameInstrumentation);
+
+// 周期汇总写日志前的格式化
+void BM_FrameTimingsFormat(BenchState& state) {
+  FrameTimings timings;
+  const uint64_t start = FrameTimings::NowNs();
+  timings.Reset(start);
+  const std::vector<uint64_t> samples = MakeSamples(4096);
+  uint64_t now = start;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    now += 40000000;
+    timings.Record((FrameStage)(i % (size_t)FrameStage::kCount), samples[i]);
+    timings.FramePresented(i & 1 ? FrameSurface::Ball : FrameSurface::Bubble, now, samples[i], 40000000);
+  }
+  size_t bytes = 0;
+  while (state.KeepRunning()) {
+    bytes = timings.Format(now).size();
+    DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.Iterations());
+  state.SetCounter("report_bytes", (double)bytes);
+}
+NFB_BENCHMARK(BM_FrameTimingsFormat);
+
+} // namespace
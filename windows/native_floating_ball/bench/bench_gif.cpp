@@ -0,0 +1,167 @@
+// 悬浮球动画管线：仓库自带 GIF（unread_logo.gif / dynamic_logo.gif，找不到的在 label 中注明并跳过）的
+// 块结构解析、LZW 解码 + 逐帧合成、整张加载（DisplayFrames::Build：解码合成、缩放到直径、
+// 乘上圆形蒙版，只保留显示尺寸帧）、缩放到悬浮球直径，以及每帧绘制的两种做法：每帧从整张画布缩放
+// （旧做法，软件渲染目标上的主要开销）与直接拷贝已缩放好的显示尺寸帧（现状）。
+// 悬浮球本身用 WIC 解码合成（GifPlayer::Load），这里测的是 core/gif_decoder；两者之后的
+// 缩放、蒙版与命中区域走同一段 DisplayFrames 代码。
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench_harness.h"
+#include "core/circle_mask.h"
+#include "core/display_frames.h"
+#include "core/gif_decoder.h"
+#include "core/image_scale.h"
+
+#ifndef NFB_ASSET_DIR
+#define NFB_ASSET_DIR "."
+#endif
+
+namespace {
+
+constexpr const char* kAssets[] = { "unread_logo.gif", "dynamic_logo.gif" };
+constexpr uint32_t kDiameter = 120;
+
+// 计时包含整个基准函数：文件内容与合成结果按资源缓存，只在第一次调用时准备
+struct Asset {
+  std::vector<uint8_t> bytes;
+  uint32_t width{0}, height{0};
+  std::vector<std::vector<uint8_t>> canvases; // 每帧整画布
+  std::vector<std::vector<uint8_t>> display;  // 每帧缩放到 kDiameter
+};
+
+const Asset* LoadAsset(const std::string& name, BenchState& state, bool composed = false) {
+  static std::map<std::string, Asset> cache;
+  Asset& asset = cache[name];
+  if (asset.bytes.empty()) {
+    std::ifstream in(std::string(NFB_ASSET_DIR) + "/" + name, std::ios::binary);
+    if (in.is_open()) asset.bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  GifDecoder decoder;
+  if (asset.bytes.empty() || !decoder.Open(asset.bytes.data(), asset.bytes.size())) {
+    state.Skip(name + " not found under " NFB_ASSET_DIR);
+    return nullptr;
+  }
+  asset.width = decoder.Width();
+  asset.height = decoder.Height();
+  if (composed && asset.canvases.empty()) {
+    const size_t frameBytes = (size_t)asset.width * asset.height * 4;
+    CoverScaler scaler;
+    scaler.Configure(asset.width, asset.height, kDiameter, kDiameter);
+    while (const uint8_t* canvas = decoder.ComposeNext()) {
+      asset.canvases.emplace_back(canvas, canvas + frameBytes);
+      asset.display.emplace_back((size_t)kDiameter * kDiameter * 4);
+      scaler.Scale(canvas, (size_t)asset.width * 4, asset.display.back().data(), (size_t)kDiameter * 4);
+    }
+  }
+  return &asset;
+}
+
+double Megabytes(const std::vector<std::vector<uint8_t>>& frames) {
+  size_t bytes = 0;
+  for (const auto& f : frames) bytes += f.size();
+  return (double)bytes / (1024.0 * 1024.0);
+}
+
+void RunParse(BenchState& state, const std::string& name) {
+  const Asset* asset = LoadAsset(name, state);
+  if (!asset) return;
+  GifDecoder decoder;
+  while (state.KeepRunning()) DoNotOptimize(decoder.Open(asset->bytes.data(), asset->bytes.size()));
+  state.SetBytesProcessed(state.Iterations() * asset->bytes.size());
+  state.SetCounter("frames", (double)decoder.FrameCount());
+}
+
+void RunDecodeCompose(BenchState& state, const std::string& name) {
+  const Asset* asset = LoadAsset(name, state);
+  if (!asset) return;
+  GifDecoder decoder;
+  decoder.Open(asset->bytes.data(), asset->bytes.size());
+  while (state.KeepRunning()) {
+    decoder.Rewind();
+    while (const uint8_t* canvas = decoder.ComposeNext()) DoNotOptimize(canvas);
+  }
+  state.SetItemsProcessed(state.Iterations() * decoder.FrameCount());
+  state.SetBytesProcessed(state.Iterations() * asset->bytes.size());
+  state.SetCounter("canvas_px", (double)decoder.Width() * decoder.Height());
+}
+
+// 读文件、构建显示尺寸帧（蒙版按直径只建一次，不计入）；解码合成用 core/gif_decoder 代替 WIC
+void RunLoad(BenchState& state, const std::string& name) {
+  if (!LoadAsset(name, state)) return;
+  const std::string path = std::string(NFB_ASSET_DIR) + "/" + name;
+  CircleMask mask;
+  mask.Build(kDiameter);
+  double retainedMb = 0.0;
+  while (state.KeepRunning()) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    DisplayFrames frames;
+    if (!frames.Build(bytes.data(), bytes.size(), mask)) break;
+    retainedMb = (double)frames.Bytes() / (1024.0 * 1024.0);
+    DoNotOptimize(frames.Frame(0));
+  }
+  state.SetItemsProcessed(state.Iterations());
+  state.SetCounter("retained_mb", retainedMb);
+}
+
+void RunScale(BenchState& state, const std::string& name, uint32_t diameter) {
+  const Asset* asset = LoadAsset(name, state, true);
+  if (!asset) return;
+  std::vector<uint8_t> out((size_t)diameter * diameter * 4);
+  CoverScaler scaler;
+  scaler.Configure(asset->width, asset->height, diameter, diameter);
+  size_t index = 0;
+  while (state.KeepRunning()) {
+    scaler.Scale(asset->canvases[index].data(), (size_t)asset->width * 4, out.data(), (size_t)diameter * 4);
+    DoNotOptimize(out.data());
+    index = (index + 1) % asset->canvases.size();
+  }
+  state.SetItemsProcessed(state.Iterations());
+  state.SetBytesProcessed(state.Iterations() * asset->canvases[0].size());
+}
+
+// 每帧绘制：fullCanvas 时每帧从整张画布缩放到直径（旧做法），否则只把缓存的显示尺寸帧拷进 DIB（BallWindow::Render）
+void RunFrameRender(BenchState& state, const std::string& name, bool fullCanvas) {
+  const Asset* asset = LoadAsset(name, state, true);
+  if (!asset) return;
+  const size_t displayBytes = (size_t)kDiameter * kDiameter * 4;
+  CoverScaler scaler;
+  scaler.Configure(asset->width, asset->height, kDiameter, kDiameter);
+  std::vector<uint8_t> dib(displayBytes);
+  size_t index = 0;
+  while (state.KeepRunning()) {
+    if (fullCanvas) {
+      scaler.Scale(asset->canvases[index].data(), (size_t)asset->width * 4, dib.data(), (size_t)kDiameter * 4);
+    } else {
+      std::memcpy(dib.data(), asset->display[index].data(), displayBytes);
+    }
+    DoNotOptimize(dib.data());
+    index = (index + 1) % asset->canvases.size();
+  }
+  state.SetItemsProcessed(state.Iterations());
+  state.SetCounter("retained_mb", Megabytes(fullCanvas ? asset->canvases : asset->display));
+}
+
+[[maybe_unused]] const bool kRegistered = [] {
+  for (const char* asset : kAssets) {
+    const std::string name = std::string(asset).substr(0, std::strlen(asset) - 4); // 去掉 .gif
+    RegisterBenchmark("BM_GifParse/" + name, [asset](BenchState& state) { RunParse(state, asset); });
+    RegisterBenchmark("BM_GifDecodeCompose/" + name, [asset](BenchState& state) { RunDecodeCompose(state, asset); });
+    RegisterBenchmark("BM_GifLoad/" + name, [asset](BenchState& state) { RunLoad(state, asset); });
+    for (uint32_t diameter : { 120u, 240u }) { // 100% / 200% 缩放
+      RegisterBenchmark("BM_GifScaleToDiameter/" + name + "/" + std::to_string(diameter),
+                        [asset, diameter](BenchState& state) { RunScale(state, asset, diameter); });
+    }
+    RegisterBenchmark("BM_BallFrameRender/" + name + "/full_canvas",
+                      [asset](BenchState& state) { RunFrameRender(state, asset, true); });
+    RegisterBenchmark("BM_BallFrameRender/" + name + "/display_size",
+                      [asset](BenchState& state) { RunFrameRender(state, asset, false); });
+  }
+  return true;
+}();
+
+} // namespace
@@ -0,0 +1,247 @@
+#include "bench_harness.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace {
+
+struct BenchEntry {
+  std::string name;
+  BenchFn fn;
+};
+
+std::vector<BenchEntry>& Registry() {
+  static std::vector<BenchEntry> registry;
+  return registry;
+}
+
+struct BenchResult {
+  std::string name;
+  uint64_t iterations{0};
+  double nsPerOp{0.0};
+  double itemsPerSecond{0.0};
+  double bytesPerSecond{0.0};
+  std::vector<std::pair<std::string, double>> counters;
+  std::string label;
+  bool skipped{false};
+};
+
+std::string JsonEscape(const std::string& s) {
+  std::string out;
+  out.reserve(s.size() + 2);
+  for (char c : s) {
+    switch (c) {
+    case '"': out += "\\\""; break;
+    case '\\': out += "\\\\"; break;
+    case '\n': out += "\\n"; break;
+    default:
+      if ((unsigned char)c < 0x20) {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "\\u%04x", (unsigned)c);
+        out += buf;
+      } else {
+        out += c;
+      }
+    }
+  }
+  return out;
+}
+
+// 读取之前 --json 写出的结果（每个基准一行），返回 name → ns/op
+std::map<std::string, double> LoadBaseline(const std::string& path) {
+  std::map<std::string, double> baseline;
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    const size_t name = line.find("\"name\": \"");
+    const size_t ns = line.find("\"ns_per_op\": ");
+    if (name == std::string::npos || ns == std::string::npos) continue;
+    const size_t begin = name + 9;
+    const size_t end = line.find('"', begin);
+    if (end == std::string::npos) continue;
+    baseline[line.substr(begin, end - begin)] = std::atof(line.c_str() + ns + 13);
+  }
+  return baseline;
+}
+
+std::string BuildContext() {
+  char date[32] = "";
+  const std::time_t now = std::time(nullptr);
+  std::tm tm{};
+#ifdef _WIN32
+  gmtime_s(&tm, &now);
+#else
+  gmtime_r(&now, &tm);
+#endif
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", &tm);
+  std::ostringstream compiler;
+#if defined(_MSC_VER)
+  compiler << "msvc " << _MSC_VER;
+#elif defined(__clang__)
+  compiler << "clang " << __clang_major__ << "." << __clang_minor__;
+#elif defined(__GNUC__)
+  compiler << "gcc " << __GNUC__ << "." << __GNUC_MINOR__;
+#endif
+#if defined(_WIN32)
+  const char* os = "windows";
+#elif defined(__APPLE__)
+  const char* os = "macos";
+#else
+  const char* os = "linux";
+#endif
+#ifdef NDEBUG
+  const char* build = "release";
+#else
+  const char* build = "debug";
+#endif
+  std::ostringstream out;
+  out << "{\"date\": \"" << date << "\", \"os\": \"" << os << "\", \"compiler\": \"" << compiler.str()
+      << "\", \"build\": \"" << build << "\"}";
+  return out.str();
+}
+
+BenchResult RunOne(const BenchEntry& entry, double minSeconds) {
+  using Clock = std::chrono::steady_clock;
+  // 预热一次（不计时）：首次调用中的一次性准备（读入资源、建立缓存）不计入结果
+  {
+    BenchState warmup(1);
+    entry.fn(warmup);
+    if (warmup.Skipped()) {
+      BenchResult r;
+      r.name = entry.name;
+      r.label = warmup.Label();
+      r.skipped = true;
+      return r;
+    }
+  }
+  uint64_t iterations = 1;
+  for (;;) {
+    BenchState state(iterations);
+    const auto t0 = Clock::now();
+    entry.fn(state);
+    const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    if (seconds >= minSeconds || iterations >= (1ull << 40)) {
+      BenchResult r;
+      r.name = entry.name;
+      r.iterations = iterations;
+      r.nsPerOp = seconds * 1e9 / (double)iterations;
+      if (seconds > 0.0) {
+        r.itemsPerSecond = (double)state.ItemsProcessed() / seconds;
+        r.bytesPerSecond = (double)state.BytesProcessed() / seconds;
+      }
+      r.counters = state.Counters();
+      r.label = state.Label();
+      return r;
+    }
+    // 按已用时间估算下一轮迭代次数，至少翻倍、最多放大 100 倍
+    const double scale = (seconds > 0.0) ? (minSeconds * 1.4 / seconds) : 100.0;
+    iterations = (uint64_t)((double)iterations * (std::min)(100.0, (std::max)(2.0, scale)));
+  }
+}
+
+} // namespace
+
+void BenchState::SetCounter(const std::string& name, double value) {
+  for (auto& c : m_counters) {
+    if (c.first == name) { c.second = value; return; }
+  }
+  m_counters.emplace_back(name, value);
+}
+
+void RegisterBenchmark(const std::string& name, BenchFn fn) {
+  Registry().push_back(BenchEntry{ name, std::move(fn) });
+}
+
+int RunBenchmarks(int argc, char** argv) {
+  std::string filter;
+  std::string jsonPath;
+  std::string comparePath;
+  double threshold = 0.10;
+  double minSeconds = 0.2;
+  for (int i = 1; i < argc; ++i) {
+    const char* a = argv[i];
+    if (std::strncmp(a, "--filter=", 9) == 0) filter = a + 9;
+    else if (std::strncmp(a, "--json=", 7) == 0) jsonPath = a + 7;
+    else if (std::strncmp(a, "--min-time=", 11) == 0) minSeconds = std::atof(a + 11);
+    else if (std::strncmp(a, "--compare=", 10) == 0) comparePath = a + 10;
+    else if (std::strncmp(a, "--threshold=", 12) == 0) threshold = std::atof(a + 12) / 100.0;
+    else if (std::strcmp(a, "--list") == 0) {
+      for (const auto& e : Registry()) std::printf("%s\n", e.name.c_str());
+      return 0;
+    } else {
+      std::fprintf(stderr, "usage: %s [--filter=substr] [--json=path] [--min-time=seconds] [--compare=baseline.json] [--threshold=percent] [--list]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::vector<BenchResult> results;
+  std::printf("%-48s %14s %14s %16s\n", "benchmark", "iterations", "ns/op", "items/s");
+  for (const auto& e : Registry()) {
+    if (!filter.empty() && e.name.find(filter) == std::string::npos) continue;
+    BenchResult r = RunOne(e, minSeconds);
+    if (r.skipped) {
+      std::printf("%-48s %14s [%s]\n", r.name.c_str(), "skipped", r.label.c_str());
+      results.push_back(std::move(r));
+      continue;
+    }
+    std::printf("%-48s %14llu %14.1f %16.0f", r.name.c_str(), (unsigned long long)r.iterations, r.nsPerOp, r.itemsPerSecond);
+    for (const auto& c : r.counters) std::printf(" %s=%g", c.first.c_str(), c.second);
+    if (!r.label.empty()) std::printf(" [%s]", r.label.c_str());
+    std::printf("\n");
+    std::fflush(stdout);
+    results.push_back(std::move(r));
+  }
+
+  if (!jsonPath.empty()) {
+    std::ofstream out(jsonPath, std::ios::trunc);
+    if (!out.is_open()) {
+      std::fprintf(stderr, "cannot write %s\n", jsonPath.c_str());
+      return 1;
+    }
+    out << "{\n  \"context\": " << BuildContext() << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+      const auto& r = results[i];
+      out << "    {\"name\": \"" << JsonEscape(r.name) << "\", \"iterations\": " << r.iterations
+          << ", \"ns_per_op\": " << r.nsPerOp << ", \"items_per_second\": " << r.itemsPerSecond
+          << ", \"bytes_per_second\": " << r.bytesPerSecond;
+      if (!r.label.empty()) out << ", \"label\": \"" << JsonEscape(r.label) << "\"";
+      if (r.skipped) out << ", \"skipped\": true";
+      out << ", \"counters\": {";
+      for (size_t c = 0; c < r.counters.size(); ++c) {
+        out << (c ? ", " : "") << "\"" << JsonEscape(r.counters[c].first) << "\": " << r.counters[c].second;
+      }
+      out << "}}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+  }
+
+  // 与基线对比：ns/op 变慢超过阈值的列出来，并以非零退出码返回，便于 CI 拦截
+  if (!comparePath.empty()) {
+    const std::map<std::string, double> baseline = LoadBaseline(comparePath);
+    if (baseline.empty()) {
+      std::fprintf(stderr, "no results in baseline %s\n", comparePath.c_str());
+      return 1;
+    }
+    int regressions = 0;
+    for (const auto& r : results) {
+      if (r.skipped) continue;
+      const auto it = baseline.find(r.name);
+      if (it == baseline.end() || it->second <= 0.0) continue;
+      const double change = r.nsPerOp / it->second - 1.0;
+      if (change > threshold) {
+        std::printf("REGRESSION %-48s %12.1f -> %12.1f ns/op (%+.1f%%)\n", r.name.c_str(), it->second, r.nsPerOp,
+                    change * 100.0);
+        ++regressions;
+      }
+    }
+    std::printf("%d regression(s) beyond %.0f%% against %s\n", regressions, threshold * 100.0, comparePath.c_str());
+    if (regressions) return 3;
+  }
+  return 0;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 极简基准框架（不引入第三方依赖）：自动标定迭代次数，输出 ns/op 与吞吐，并可导出 JSON 便于趋势跟踪。
+//
+//   static void BM_Foo(BenchState& state) {
+//     while (state.KeepRunning()) { ... }
+//     state.SetItemsProcessed(state.Iterations() * n);
+//   }
+//   NFB_BENCHMARK(BM_Foo);
+class BenchState {
+public:
+  explicit BenchState(uint64_t iterations) : m_iterations(iterations) {}
+
+  bool KeepRunning() { return m_done++ < m_iterations; }
+  uint64_t Iterations() const { return m_iterations; }
+
+  void SetItemsProcessed(uint64_t n) { m_items = n; }
+  void SetBytesProcessed(uint64_t n) { m_bytes = n; }
+  // 额外指标（例如命中率、p99），原样写入结果
+  void SetCounter(const std::string& name, double value);
+  void SetLabel(const std::string& label) { m_label = label; }
+  // 前置条件不满足（例如缺少资源文件）：不计时、不参与基线对比，原因写入 label
+  void Skip(const std::string& reason) {
+    m_label = reason;
+    m_skipped = true;
+  }
+  bool Skipped() const { return m_skipped; }
+
+  uint64_t ItemsProcessed() const { return m_items; }
+  uint64_t BytesProcessed() const { return m_bytes; }
+  const std::vector<std::pair<std::string, double>>& Counters() const { return m_counters; }
+  const std::string& Label() const { return m_label; }
+
+private:
+  uint64_t m_iterations;
+  uint64_t m_done{0};
+  uint64_t m_items{0};
+  uint64_t m_bytes{0};
+  std::vector<std::pair<std::string, double>> m_counters;
+  std::string m_label;
+  bool m_skipped{false};
+};
+
+using BenchFn = std::function<void(BenchState&)>;
+
+void RegisterBenchmark(const std::string& name, BenchFn fn);
+
+struct BenchRegistrar {
+  BenchRegistrar(const char* name, BenchFn fn) { RegisterBenchmark(name, std::move(fn)); }
+};
+
+#define NFB_BENCH_CONCAT2(a, b) a##b
+#define NFB_BENCH_CONCAT(a, b) NFB_BENCH_CONCAT2(a, b)
+#define NFB_BENCHMARK(fn) static BenchRegistrar NFB_BENCH_CONCAT(nfb_bench_reg_, __LINE__)(#fn, fn)
+
+// 阻止编译器把被测结果优化掉
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+int RunBenchmarks(int argc, char** argv);
@@ -0,0 +1,85 @@
+// 命中区域：由显示尺寸帧的 alpha 构建每行区间的开销，以及 WM_NCHITTEST 的单次查询开销。
+// mismatches 为逐像素与直接比较 alpha 阈值不一致的个数（应为 0）；spans 为区间总数。
+// 位图用圆形蒙版叠一个透明环（GIF 中心镂空、行内多段区间的情况）。
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "bench_harness.h"
+#include "core/circle_mask.h"
+#include "core/hit_mask.h"
+
+namespace {
+
+std::vector<uint8_t> MakeRingFrame(const CircleMask& mask) {
+  const uint32_t d = mask.Diameter();
+  std::vector<uint8_t> frame((size_t)d * d * 4);
+  mask.Fill(0xFF4169E1u, frame.data(), (size_t)d * 4);
+  const double c = d / 2.0, inner = d / 6.0, outer = d / 4.0;
+  for (uint32_t y = 0; y < d; ++y) {
+    for (uint32_t x = 0; x < d; ++x) {
+      const double dx = x + 0.5 - c, dy = y + 0.5 - c;
+      const double r2 = dx * dx + dy * dy;
+      if (r2 >= inner * inner && r2 < outer * outer) {
+        uint8_t* p = frame.data() + ((size_t)y * d + x) * 4;
+        p[0] = p[1] = p[2] = p[3] = 0;
+      }
+    }
+  }
+  return frame;
+}
+
+void RunBuild(BenchState& state, uint32_t diameter) {
+  CircleMask mask;
+  mask.Build(diameter);
+  const std::vector<uint8_t> frame = MakeRingFrame(mask);
+  HitMask hit;
+  while (state.KeepRunning()) {
+    hit.Build(frame.data() + 3, diameter, diameter, (size_t)diameter * 4, 4);
+    DoNotOptimize(hit.SpanCount());
+  }
+  state.SetItemsProcessed(state.Iterations());
+  int mismatches = 0;
+  for (uint32_t y = 0; y < diameter; ++y) {
+    for (uint32_t x = 0; x < diameter; ++x) {
+      const bool opaque = frame[((size_t)y * diameter + x) * 4 + 3] >= HitMask::kDefaultMinAlpha;
+      if (hit.Contains((int)x, (int)y) != opaque) ++mismatches;
+    }
+  }
+  // 越界坐标（窗口边框外、负坐标）必须不命中
+  if (hit.Contains(-1, 0) || hit.Contains(0, -1) || hit.Contains((int)diameter, 0) || hit.Contains(0, (int)diameter)) {
+    ++mismatches;
+  }
+  state.SetCounter("mismatches", (double)mismatches);
+  state.SetCounter("spans", (double)hit.SpanCount());
+  state.SetCounter("bytes", (double)hit.Bytes());
+}
+
+void RunContains(BenchState& state, uint32_t diameter) {
+  CircleMask mask;
+  mask.Build(diameter);
+  const std::vector<uint8_t> frame = MakeRingFrame(mask);
+  HitMask hit;
+  hit.Build(frame.data() + 3, diameter, diameter, (size_t)diameter * 4, 4);
+  // 光标轨迹：按固定步长扫过整个窗口（含透明角落）
+  uint32_t x = 0, y = 0;
+  uint64_t inside = 0;
+  while (state.KeepRunning()) {
+    inside += hit.Contains((int)x, (int)y);
+    x += 7;
+    if (x >= diameter) { x -= diameter; y = (y + 3) % diameter; }
+  }
+  DoNotOptimize(inside);
+  state.SetItemsProcessed(state.Iterations());
+}
+
+[[maybe_unused]] const bool kRegistered = [] {
+  for (uint32_t diameter : { 120u, 240u }) { // 100% / 200% 缩放
+    RegisterBenchmark("BM_HitMaskBuild/" + std::to_string(diameter),
+                      [diameter](BenchState& state) { RunBuild(state, diameter); });
+    RegisterBenchmark("BM_HitMaskContains/" + std::to_string(diameter),
+                      [diameter](BenchState& state) { RunContains(state, diameter); });
+  }
+  return true;
+}();
+
+} // namespace
@@ -0,0 +1,96 @@
+// 旧文本格式 UPDATE_TASKS（dwData=1）的解析与合并：10k 行负载，统计每次更新的堆分配次数
+#include <string>
+#include <vector>
+#include "bench_alloc.h"
+#include "bench_harness.h"
+#include "core/task_list_model.h"
+#include "core/task_text_parser.h"
+
+namespace {
+
+constexpr size_t kLines = 10000;
+
+std::u16string MakePayload(size_t lines) {
+  static const char16_t* kSamples[] = {
+    u"请于本周五前提交季度预算调整方案并同步财务部",
+    u"Review PR #1284: fix race in task sync",
+    u"客户回访：华东区 12 家门店满意度调查（第二批）",
+    u"整理会议纪要",
+  };
+  std::u16string payload;
+  for (size_t i = 0; i < lines; ++i) {
+    for (char c : std::to_string(100000 + i)) payload += (char16_t)c;
+    payload += u' ';
+    payload += kSamples[i % (sizeof(kSamples) / sizeof(kSamples[0]))];
+    payload += (i % 7 == 0) ? u"\r\n" : u"\n";
+  }
+  payload += u'\0';
+  return payload;
+}
+
+// 旧实现：拷贝整块负载、原地替换 CR、逐行 substr 到新 vector
+std::vector<TaskItem> ParseByCopy(const char16_t* data, size_t len) {
+  std::u16string payload(data, len);
+  for (auto& ch : payload) if (ch == u'\r') ch = u'\n';
+  std::vector<TaskItem> items;
+  size_t start = 0;
+  while (start < payload.size()) {
+    size_t pos = payload.find(u'\n', start);
+    const size_t end = (pos == std::u16string::npos ? payload.size() : pos);
+    std::u16string line = payload.substr(start, end - start);
+    while (!line.empty() && line.back() == u'\0') line.pop_back();
+    if (!line.empty()) {
+      const size_t sp = line.find(u' ');
+      TaskItem item;
+      item.id = line.substr(0, sp);
+      if (sp != std::u16string::npos) item.title = line.substr(sp + 1);
+      items.push_back(std::move(item));
+    }
+    if (pos == std::u16string::npos) break; else start = pos + 1;
+  }
+  return items;
+}
+
+void BM_LegacyParseCopy10k(BenchState& state) {
+  const std::u16string payload = MakePayload(kLines);
+  BenchAllocationScope allocs;
+  while (state.KeepRunning()) {
+    DoNotOptimize(ParseByCopy(payload.data(), payload.size()).size());
+  }
+  state.SetItemsProcessed(state.Iterations() * kLines);
+  state.SetBytesProcessed(state.Iterations() * payload.size() * sizeof(char16_t));
+  state.SetCounter("allocs_per_update", (double)allocs.Count() / (double)state.Iterations());
+}
+NFB_BENCHMARK(BM_LegacyParseCopy10k);
+
+void BM_LegacyParseViews10k(BenchState& state) {
+  const std::u16string payload = MakePayload(kLines);
+  TaskTextParser parser;
+  parser.Parse(payload); // 首次更新让条目数组长到稳态容量
+  BenchAllocationScope allocs;
+  while (state.KeepRunning()) {
+    DoNotOptimize(parser.Parse(payload).size());
+  }
+  state.SetItemsProcessed(state.Iterations() * kLines);
+  state.SetBytesProcessed(state.Iterations() * payload.size() * sizeof(char16_t));
+  state.SetCounter("allocs_per_update", (double)allocs.Count() / (double)state.Iterations());
+}
+NFB_BENCHMARK(BM_LegacyParseViews10k);
+
+// 悬浮球收到内容不变的 10k 行更新：解析 + 按 id 合并进列表模型
+void BM_LegacyParseApply10k(BenchState& state) {
+  const std::u16string payload = MakePayload(kLines);
+  TaskTextParser parser;
+  TaskListModel model;
+  model.Replace(parser.Parse(payload));
+  model.Replace(parser.Parse(payload));
+  BenchAllocationScope allocs;
+  while (state.KeepRunning()) {
+    DoNotOptimize(model.Replace(parser.Parse(payload)).Empty());
+  }
+  state.SetItemsProcessed(state.Iterations() * kLines);
+  state.SetCounter("allocs_per_update", (double)allocs.Count() / (double)state.Iterations());
+}
+NFB_BENCHMARK(BM_LegacyParseApply10k);
+
+} // namespace
@@ -0,0 +1,126 @@
+// 悬浮球日志：异步环形缓冲日志器的调用开销（入队、被级别过滤、被重复抑制、多线程竞争），
+// 对照原来每条日志“打开文件 → 追加一行 → 关闭”的做法。日志写到临时目录，结束后删除。
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_harness.h"
+#include "core/async_logger.h"
+
+namespace {
+
+std::string TempLogPath(const char* name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void RemoveLogs(const std::string& path) {
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  for (int i = 1; i < 4; ++i) std::filesystem::remove(path + "." + std::to_string(i), ec);
+}
+
+AsyncLogger::Options BenchOptions(const std::string& path) {
+  AsyncLogger::Options options;
+  options.path = path;
+  options.maxFileBytes = 4 * 1024 * 1024;
+  return options;
+}
+
+constexpr char kLine[] = "[native_floating_ball] task snapshot applied rows=128 seq=4242";
+
+// 纯调用开销：后台线程跟不上时环满丢弃（dropped 计数），调用方永不阻塞
+void BM_LogEnqueue(BenchState& state) {
+  const std::string path = TempLogPath("nfb_bench_enqueue.log");
+  AsyncLogger logger;
+  logger.Open(BenchOptions(path));
+  while (state.KeepRunning()) DoNotOptimize(logger.Log(LogLevel::Info, kLine));
+  state.SetItemsProcessed(state.Iterations());
+  state.SetCounter("dropped", (double)logger.Dropped());
+  logger.Close();
+  RemoveLogs(path);
+}
+NFB_BENCHMARK(BM_LogEnqueue);
+
+// 持续写入：每 256 条 Flush 一次，包含后台线程格式化与写文件的摊销成本
+void BM_LogSustained(BenchState& state) {
+  const std::string path = TempLogPath("nfb_bench_sustained.log");
+  AsyncLogger logger;
+  logger.Open(BenchOptions(path));
+  uint64_t n = 0;
+  while (state.KeepRunning()) {
+    logger.Log(LogLevel::Info, kLine);
+    if ((++n & 255) == 0) logger.Flush();
+  }
+  logger.Flush();
+  state.SetItemsProcessed(state.Iterations());
+  state.SetCounter("dropped", (double)logger.Dropped());
+  logger.Close();
+  RemoveLogs(path);
+}
+NFB_BENCHMARK(BM_LogSustained);
+
+// 每帧都失败的 EndDraw：同一条错误在窗口期内只计数
+void BM_LogRepeatedError(BenchState& state) {
+  const std::string path = TempLogPath("nfb_bench_repeat.log");
+  AsyncLogger logger;
+  logger.Open(BenchOptions(path));
+  while (state.KeepRunning()) DoNotOptimize(logger.Log(LogLevel::Error, "[native_floating_ball] EndDraw hr=0x8899000C"));
+  state.SetItemsProcessed(state.Iterations());
+  state.SetCounter("suppressed", (double)logger.Suppressed());
+  logger.Close();
+  RemoveLogs(path);
+}
+NFB_BENCHMARK(BM_LogRepeatedError);
+
+void BM_LogFilteredLevel(BenchState& state) {
+  const std::string path = TempLogPath("nfb_bench_filtered.log");
+  AsyncLogger logger;
+  logger.Open(BenchOptions(path));
+  while (state.KeepRunning()) DoNotOptimize(logger.Log(LogLevel::Debug, kLine));
+  state.SetItemsProcessed(state.Iterations());
+  logger.Close();
+  RemoveLogs(path);
+}
+NFB_BENCHMARK(BM_LogFilteredLevel);
+
+// 4 个线程同时记录（每次迭代每线程 64 条，计时含线程启动）
+void BM_LogContended(BenchState& state) {
+  const std::string path = TempLogPath("nfb_bench_contended.log");
+  AsyncLogger logger;
+  logger.Open(BenchOptions(path));
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 64;
+  while (state.KeepRunning()) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < kPerThread; ++i) logger.Log(LogLevel::Info, kLine);
+      });
+    }
+    for (auto& t : threads) t.join();
+    logger.Flush();
+  }
+  state.SetItemsProcessed(state.Iterations() * kThreads * kPerThread);
+  state.SetCounter("dropped", (double)logger.Dropped());
+  logger.Close();
+  RemoveLogs(path);
+}
+NFB_BENCHMARK(BM_LogContended);
+
+// 原来的做法：每条日志打开、追加、关闭一次
+void BM_LogOpenAppendClose(BenchState& state) {
+  const std::string path = TempLogPath("nfb_bench_baseline.log");
+  while (state.KeepRunning()) {
+    std::FILE* f = std::fopen(path.c_str(), "ab");
+    if (!f) break;
+    std::fputs(kLine, f);
+    std::fputc('\n', f);
+    std::fclose(f);
+  }
+  state.SetItemsProcessed(state.Iterations());
+  RemoveLogs(path);
+}
+NFB_BENCHMARK(BM_LogOpenAppendClose);
+
+} // namespace
@@ -0,0 +1,5 @@
+#include "bench_harness.h"
+
+int main(int argc, char** argv) {
+  return RunBenchmarks(argc, argv);
+}
@@ -0,0 +1,94 @@
+// 内存分账：登记一次调整的开销（单线程；悬浮球 UI 线程与日志线程同时登记时的竞争），
+// 以及按需导出的文本 / JSON 报告。每帧渲染都会做一次登记，开销需要远小于帧预算。
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "bench_harness.h"
+#include "core/memory_accounting.h"
+
+namespace {
+
+// 每帧上传位图的登记：进入时 Set(整画布)，离开时释放
+void BM_MemoryChargeScope(BenchState& state) {
+  MemoryAccounting accounting;
+  while (state.KeepRunning()) {
+    MemoryCharge upload(MemorySubsystem::RenderResources, accounting);
+    upload.Set(976u * 720u * 4u);
+    DoNotOptimize(upload.Bytes());
+  }
+  state.SetItemsProcessed(state.Iterations());
+  state.SetCounter("peak_mb", (double)accounting.Total().peak / (1024.0 * 1024.0));
+}
+NFB_BENCHMARK(BM_MemoryChargeScope);
+
+// 值不变的 Set（气泡每帧刷新表面登记的常见情况）不触及共享计数
+void BM_MemoryChargeUnchanged(BenchState& state) {
+  MemoryAccounting accounting;
+  MemoryCharge surface(MemorySubsystem::RenderResources, accounting);
+  while (state.KeepRunning()) {
+    surface.Set(280u * 180u * 4u);
+    DoNotOptimize(surface.Bytes());
+  }
+  state.SetItemsProcessed(state.Iterations());
+}
+NFB_BENCHMARK(BM_MemoryChargeUnchanged);
+
+// 另一线程持续登记 / 释放（日志旁路队列）时 UI 线程的登记开销
+void BM_MemoryChargeContended(BenchState& state) {
+  MemoryAccounting accounting;
+  std::atomic<bool> stop{false};
+  std::thread other([&] {
+    MemoryCharge queue(MemorySubsystem::Logging, accounting);
+    while (!stop.load(std::memory_order_relaxed)) {
+      queue.Add(512);
+      queue.Set(0);
+    }
+  });
+  while (state.KeepRunning()) {
+    MemoryCharge upload(MemorySubsystem::RenderResources, accounting);
+    upload.Set(976u * 720u * 4u);
+  }
+  stop.store(true);
+  other.join();
+  state.SetItemsProcessed(state.Iterations());
+}
+NFB_BENCHMARK(BM_MemoryChargeContended);
+
+void FillTypical(MemoryAccounting& accounting) {
+  accounting.Add(MemorySubsystem::AnimationFrames, 61u * 976u * 720u * 4u);
+  accounting.Add(MemorySubsystem::RenderResources, 120u * 120u * 4u);
+  accounting.Add(MemorySubsystem::IpcBuffers, 1u << 20);
+  accounting.Add(MemorySubsystem::BubbleScene, 512u * 512u);
+  accounting.Add(MemorySubsystem::Logging, 512u * 256u);
+  accounting.SetBudget(64u << 20);
+}
+
+void BM_MemoryReportFormat(BenchState& state) {
+  MemoryAccounting accounting;
+  FillTypical(accounting);
+  size_t bytes = 0;
+  while (state.KeepRunning()) {
+    const std::string text = accounting.Format(300u << 20);
+    bytes = text.size();
+    DoNotOptimize(text.data());
+  }
+  state.SetItemsProcessed(state.Iterations());
+  state.SetCounter("bytes", (double)bytes);
+}
+NFB_BENCHMARK(BM_MemoryReportFormat);
+
+void BM_MemoryReportJson(BenchState& state) {
+  MemoryAccounting accounting;
+  FillTypical(accounting);
+  size_t bytes = 0;
+  while (state.KeepRunning()) {
+    const std::string json = accounting.ToJson(300u << 20);
+    bytes = json.size();
+    DoNotOptimize(json.data());
+  }
+  state.SetItemsProcessed(state.Iterations());
+  state.SetCounter("bytes", (double)bytes);
+}
+NFB_BENCHMARK(BM_MemoryReportJson);
+
+} // namespace
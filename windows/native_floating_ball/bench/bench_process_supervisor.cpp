@@ -0,0 +1,112 @@
+// 子进程监管：启动 → 就绪信号的延迟（替代主程序原来的 cmd.exe 中转 + 固定 300ms 等待），
+// 以及“就绪后崩溃”时的退避重启序列。子进程用 /bin/sh 脚本代替悬浮球：从 --ready=<fd> 参数取出 fd 写一个字节。
+// 仅 POSIX；Windows 上的事件句柄实现与之对应。
+#if !defined(_WIN32)
+
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_harness.h"
+#include "core/process_supervisor.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// $1 为监管方追加的 --ready=<fd>（$0 占位为 sh）
+constexpr char kSignalReady[] = "eval \"printf r >&${1#--ready=}\"";
+
+std::vector<std::string> ShellArgs(const std::string& script) {
+  return { "-c", script, "sh" };
+}
+
+double Percentile(std::vector<double> v, double p) {
+  if (v.empty()) return 0.0;
+  std::sort(v.begin(), v.end());
+  return v[(size_t)(p * (double)(v.size() - 1))];
+}
+
+// viaShell 模拟原来的 runInShell：多一层 shell 进程再启动目标
+void RunSpawnReady(BenchState& state, bool viaShell) {
+  const std::string script = std::string(kSignalReady) + "; exit 0";
+  const std::vector<std::string> args = viaShell
+      ? ShellArgs("exec /bin/sh -c '" + script + "' sh \"$1\"")
+      : ShellArgs(script);
+  std::vector<double> readyUs;
+  uint64_t failures = 0;
+  while (state.KeepRunning()) {
+    ChildProcess child;
+    const Clock::time_point start = Clock::now();
+    if (!child.Spawn("/bin/sh", args)) { ++failures; continue; }
+    bool ready = false;
+    for (;;) {
+      const ChildProcess::WaitResult r = child.Wait(std::chrono::milliseconds(2000));
+      if (r == ChildProcess::WaitResult::Ready) {
+        ready = true;
+        readyUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+      } else {
+        break; // Exited / Timeout
+      }
+    }
+    failures += !ready;
+  }
+  state.SetItemsProcessed(state.Iterations());
+  state.SetCounter("ready_p50_us", Percentile(readyUs, 0.50));
+  state.SetCounter("ready_p99_us", Percentile(readyUs, 0.99));
+  if (failures) state.SetLabel(std::to_string(failures) + " launches never became ready");
+}
+
+void BM_SupervisorSpawnReady(BenchState& state) { RunSpawnReady(state, false); }
+NFB_BENCHMARK(BM_SupervisorSpawnReady);
+
+void BM_SupervisorSpawnReadyViaShell(BenchState& state) { RunSpawnReady(state, true); }
+NFB_BENCHMARK(BM_SupervisorSpawnReadyViaShell);
+
+// 每个子进程就绪后立即以退出码 3 崩溃：应看到 maxRestarts 次重启、每次都重新就绪，最后放弃
+void BM_SupervisorCrashLoop(BenchState& state) {
+  uint64_t bad = 0;
+  std::vector<double> restartUs;
+  while (state.KeepRunning()) {
+    ProcessSupervisor::Options options;
+    options.path = "/bin/sh";
+    options.args = ShellArgs(std::string(kSignalReady) + "; exit 3");
+    options.initialBackoff = std::chrono::milliseconds(1);
+    options.maxBackoff = std::chrono::milliseconds(4);
+    options.maxRestarts = 3;
+
+    std::mutex mutex;
+    std::vector<ProcessSupervisor::Event> events;
+    Clock::time_point crashedAt;
+    ProcessSupervisor supervisor(options, [&](ProcessSupervisor::Event event, uint32_t, int) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (event == ProcessSupervisor::Event::Crashed) crashedAt = Clock::now();
+      if (event == ProcessSupervisor::Event::Ready && !events.empty()) {
+        restartUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - crashedAt).count());
+      }
+      events.push_back(event);
+    });
+    supervisor.Start();
+    while (supervisor.IsRunning()) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    supervisor.Stop();
+
+    // Ready, Crashed × 3 轮，然后 Ready, GaveUp
+    using E = ProcessSupervisor::Event;
+    const std::vector<E> expected = { E::Ready, E::Crashed, E::Ready, E::Crashed, E::Ready, E::Crashed,
+                                      E::Ready, E::GaveUp };
+    bad += events != expected || supervisor.Restarts() != options.maxRestarts;
+  }
+  state.SetItemsProcessed(state.Iterations());
+  state.SetCounter("crash_to_ready_p50_us", Percentile(restartUs, 0.50));
+  state.SetCounter("bad_rounds", (double)bad);
+  if (bad) state.SetLabel("unexpected supervision sequence");
+}
+NFB_BENCHMARK(BM_SupervisorCrashLoop);
+
+} // namespace
+
+#endif // !_WIN32
@@ -0,0 +1,152 @@
+// 事件轨迹回放基准：把一条轨迹全速喂给无窗口悬浮球（与窗口版共用 BallState 与任务同步），
+// 以一次完整回放为一次迭代，并按事件类别给出平均处理耗时。
+//   BM_Replay/hover_dispatch_burst：合成场景——悬停展开气泡的同时收到一串增量更新
+//   BM_Replay/<文件名>：bench/traces/ 下现场录到的 .nfbt（见该目录的 README）
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "bench_harness.h"
+#include "headless_ball.h"
+#include "core/task_wire.h"
+
+namespace {
+
+std::u16string ToU16(const std::string& s) {
+  return std::u16string(s.begin(), s.end());
+}
+
+// 2 秒的合成轨迹：40 条任务的快照后，光标从左上方透明角落划入（这几次移动应穿透），之后在球内
+// 每 8ms 一次 WM_MOUSEMOVE，同时主程序以 20ms 间隔推送
+// 增量（新增 / 改标题 / 移除交替），每条增量后跟一次合并落地；GIF 帧定时器按 40ms 触发；1.2 秒时光标离开，
+// 之后每 250ms 一次隐藏轮询。
+std::vector<uint8_t> MakeHoverDispatchBurst() {
+  EventTraceEncoder trace;
+  TaskWireWriter wire;
+  std::vector<std::u16string> ids, titles;
+  const auto item = [&](size_t i) {
+    ids.push_back(ToU16("task-" + std::to_string(i)));
+    titles.push_back(ToU16("Review the quarterly report draft #" + std::to_string(i)));
+    TaskItemView view;
+    view.id = ids.back();
+    view.title = titles.back();
+    return view;
+  };
+
+  uint32_t seq = 1;
+  wire.Begin(TaskWireKind::Snapshot, seq);
+  for (size_t i = 0; i < 40; ++i) wire.Add(item(i));
+  const std::vector<uint8_t>& snapshot = wire.Finish();
+  trace.Append(TraceEventKind::CopyData, 0, (uint32_t)kTaskWireCopyDataId, 0, snapshot.data(), snapshot.size());
+  trace.Append(TraceEventKind::TasksFlush, 50);
+
+  size_t nextId = 40, oldest = 0;
+  uint64_t nextMove = 60000, nextFrame = 40000, nextDelta = 150000, nextHide = UINT64_MAX;
+  const uint64_t leaveUs = 1200000, endUs = 2000000;
+  bool left = false;
+  for (uint64_t t = 0; t < endUs; t += 1000) {
+    if (t >= nextFrame) {
+      trace.Append(TraceEventKind::FrameTimer, t);
+      nextFrame += 40000;
+    }
+    if (!left && t >= nextMove && t < 100000) {
+      const uint32_t step = (uint32_t)(t - 60000) / 8000;
+      trace.Append(TraceEventKind::MouseMove, t, 4 + step * 3, 4 + step * 3);
+      nextMove += 8000;
+    } else if (!left && t >= nextMove) {
+      trace.Append(TraceEventKind::MouseMove, t, 60 + (uint32_t)(t / 8000) % 8, 60);
+      nextMove += 8000;
+    }
+    if (!left && t >= leaveUs) {
+      trace.Append(TraceEventKind::MouseLeave, t);
+      left = true;
+      nextHide = t + 250000;
+    }
+    if (t >= nextHide) {
+      trace.Append(TraceEventKind::HideTimer, t, 0);
+      nextHide = UINT64_MAX;
+    }
+    if (t >= nextDelta && t < leaveUs + 200000) {
+      const uint32_t op = seq % 3;
+      wire.Begin(op == 0 ? TaskWireKind::Add : op == 1 ? TaskWireKind::Update : TaskWireKind::Remove, ++seq);
+      if (op == 0) {
+        wire.Add(item(nextId++));
+      } else {
+        TaskItemView view;
+        view.id = ids[op == 1 ? ids.size() - 1 : oldest++];
+        titles.push_back(ToU16("Updated at " + std::to_string(t / 1000) + " ms"));
+        view.title = titles.back();
+        wire.Add(view);
+      }
+      const std::vector<uint8_t>& delta = wire.Finish();
+      trace.Append(TraceEventKind::CopyData, t, (uint32_t)kTaskWireCopyDataId, 0, delta.data(), delta.size());
+      trace.Append(TraceEventKind::TasksFlush, t + 200);
+      nextDelta += 20000;
+    }
+  }
+  return trace.Data();
+}
+
+std::vector<uint8_t> ReadFile(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+// 解码 GIF 较慢，整个进程共用一个悬浮球；每次回放从上一次结束时的状态继续（合成轨迹以快照开头，会重建基线）
+HeadlessBall& SharedBall() {
+  static HeadlessBall* ball = [] {
+    HeadlessBall* b = new HeadlessBall();
+    b->LoadAssets(NFB_ASSET_DIR);
+    return b;
+  }();
+  return *ball;
+}
+
+void RunReplay(BenchState& state, const std::vector<uint8_t>& trace) {
+  HeadlessBall& ball = SharedBall();
+  DispatchProfiler profile;
+  ReplayResult result;
+  const uint64_t passedBefore = ball.PassedThrough();
+  while (state.KeepRunning()) {
+    result = ReplayTrace(trace.data(), trace.size(), ball, false, &profile);
+  }
+  if (!result.events) {
+    state.Skip("empty or unreadable trace");
+    return;
+  }
+  state.SetItemsProcessed(state.Iterations() * result.events);
+  state.SetCounter("events", (double)result.events);
+  state.SetCounter("trace_ms", (double)result.traceUs / 1000.0);
+  state.SetCounter("passed_through", (double)(ball.PassedThrough() - passedBefore) / (double)state.Iterations());
+  const auto avg = [&](const char* name, uint32_t id) {
+    const DispatchProfiler::Entry* e = profile.Find(id);
+    if (e && e->count) state.SetCounter(std::string(name) + "_us", (double)e->totalNs / (double)e->count / 1000.0);
+  };
+  avg("mouse_move", (uint32_t)TraceEventKind::MouseMove);
+  avg("copy_data", (uint32_t)TraceEventKind::CopyData);
+  avg("snapshot", (uint32_t)TraceEventKind::SnapshotPublished);
+  avg("tasks_flush", (uint32_t)TraceEventKind::TasksFlush);
+  avg("frame_timer", (uint32_t)TraceEventKind::FrameTimer);
+  avg("bubble_tick", HeadlessBall::kBubbleTickClass);
+}
+
+[[maybe_unused]] const bool kRegistered = [] {
+  RegisterBenchmark("BM_Replay/hover_dispatch_burst", [](BenchState& state) {
+    static const std::vector<uint8_t> trace = MakeHoverDispatchBurst();
+    RunReplay(state, trace);
+  });
+  std::error_code ec;
+  const std::filesystem::path dir = std::filesystem::path(NFB_ASSET_DIR) / "windows/native_floating_ball/bench/traces";
+  for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+    if (entry.path().extension() != ".nfbt") continue;
+    const std::filesystem::path path = entry.path();
+    RegisterBenchmark("BM_Replay/" + path.stem().string(), [path](BenchState& state) {
+      RunReplay(state, ReadFile(path));
+    });
+  }
+  return true;
+}();
+
+} // namespace
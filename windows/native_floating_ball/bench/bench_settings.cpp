@@ -0,0 +1,86 @@
+// 悬浮球设置：拖拽结束时保存位置的开销。原来每次 WM_EXITSIZEMOVE 都截断并重写文本文件；
+// 现在只改内存表，由后台线程去抖合并后原子替换写盘。连续拖拽 16 次应只落盘一次（writes_per_burst）。
+// 设置文件写到临时目录，结束后删除。
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "bench_harness.h"
+#include "core/settings_store.h"
+
+namespace {
+
+std::string TempSettingsPath(const char* name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void RemoveSettings(const std::string& path) {
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  std::filesystem::remove(path + ".tmp", ec);
+}
+
+// 原来的做法：每次保存都截断重写
+void BM_SettingsTruncateRewrite(BenchState& state) {
+  const std::string path = TempSettingsPath("nfb_bench_settings_legacy.txt");
+  int x = 0;
+  while (state.KeepRunning()) {
+    std::ofstream out(path, std::ios::trunc);
+    out << (x++ & 1023) << " " << 640;
+  }
+  state.SetItemsProcessed(state.Iterations());
+  RemoveSettings(path);
+}
+NFB_BENCHMARK(BM_SettingsTruncateRewrite);
+
+// 内存表上的一次保存（去抖窗口内，不触发写盘）
+void BM_SettingsSetPosition(BenchState& state) {
+  const std::string path = TempSettingsPath("nfb_bench_settings_set.txt");
+  SettingsStore store;
+  store.Open({ path, std::chrono::milliseconds(60000), std::chrono::milliseconds(60000) });
+  int x = 0;
+  while (state.KeepRunning()) {
+    store.Set("pos.0123456789abcdef", std::to_string(x++ & 1023) + " 640");
+  }
+  state.SetItemsProcessed(state.Iterations());
+  store.Close();
+  RemoveSettings(path);
+}
+NFB_BENCHMARK(BM_SettingsSetPosition);
+
+void BM_SettingsGetInt(BenchState& state) {
+  const std::string path = TempSettingsPath("nfb_bench_settings_get.txt");
+  SettingsStore store;
+  store.Open({ path });
+  store.SetInt("diameter", 120);
+  store.SetInt("memory_budget_kb", 16384);
+  int64_t sum = 0;
+  while (state.KeepRunning()) sum += store.GetInt("diameter", 0);
+  DoNotOptimize(sum);
+  state.SetItemsProcessed(state.Iterations());
+  store.Close();
+  RemoveSettings(path);
+}
+NFB_BENCHMARK(BM_SettingsGetInt);
+
+// 一阵连续保存（16 次）+ 等待落盘：计时包含原子替换（含 fsync）的完整成本
+void BM_SettingsBurstThenFlush(BenchState& state) {
+  const std::string path = TempSettingsPath("nfb_bench_settings_burst.txt");
+  SettingsStore store;
+  store.Open({ path, std::chrono::milliseconds(60000), std::chrono::milliseconds(60000) });
+  const uint64_t writesBefore = store.Writes();
+  int x = 0;
+  while (state.KeepRunning()) {
+    for (int i = 0; i < 16; ++i) store.Set("pos.0123456789abcdef", std::to_string(x++ & 1023) + " 640");
+    store.Flush();
+  }
+  state.SetItemsProcessed(state.Iterations() * 16);
+  state.SetCounter("writes_per_burst", (double)(store.Writes() - writesBefore) / (double)state.Iterations());
+  if (store.Failures()) state.SetLabel("atomic write failed");
+  store.Close();
+  RemoveSettings(path);
+}
+NFB_BENCHMARK(BM_SettingsBurstThenFlush);
+
+} // namespace
@@ -0,0 +1,140 @@
+// 单实例启动：后启动的进程判定“已有主实例”并完成转交的耗时，以及多个进程同时启动时的竞争。
+// 竞争用例每次迭代 fork N 个进程，在共享内存里的发令旗上同时开始 Claim；主实例发布端点后等其余进程转交完再退出。
+// 结果必须恰好一个 Primary、其余全部 Forwarded，否则在 label 中报告。
+// 仅 POSIX（flock + shm_open，与 Windows 的具名互斥量 + 文件映射语义一致）。
+#if !defined(_WIN32)
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_harness.h"
+#include "core/single_instance.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t kWindowTag = 0x5EED;
+constexpr size_t kMaxProcs = 64;
+
+std::string BenchInstanceName() {
+  return "NfbBench.Instance." + std::to_string(getpid());
+}
+
+void RemoveLockFile(const std::string& name) {
+  const char* dir = std::getenv("XDG_RUNTIME_DIR");
+  unlink((std::string(dir && *dir ? dir : "/tmp") + "/" + name + ".lock").c_str());
+}
+
+// 主实例已就绪时，后启动进程的一次判定 + 转交（同进程内两个锁对象，flock 同样互斥）
+void BM_SingleInstanceForward(BenchState& state) {
+  const std::string name = BenchInstanceName();
+  SingleInstance primary(name);
+  const auto accept = [](const SingleInstance::Endpoint& e) { return e.window == kWindowTag; };
+  if (primary.Claim(std::chrono::milliseconds(0), accept) != InstanceRole::Primary) {
+    state.SetLabel("lock already held");
+    return;
+  }
+  primary.Publish({(uint32_t)getpid(), kWindowTag});
+  uint64_t forwarded = 0;
+  while (state.KeepRunning()) {
+    SingleInstance second(name);
+    forwarded += second.Claim(std::chrono::milliseconds(100), accept) == InstanceRole::Forwarded;
+  }
+  if (forwarded != state.Iterations()) state.SetLabel("forward failed");
+  state.SetItemsProcessed(state.Iterations());
+  RemoveLockFile(name);
+}
+NFB_BENCHMARK(BM_SingleInstanceForward);
+
+struct RaceShared {
+  std::atomic<int> go;
+  std::atomic<int> procs;    // 实际 fork 成功的进程数
+  std::atomic<int> finished; // 已完成 Claim 的非主实例数
+  std::atomic<int> primaries;
+  std::atomic<int> forwarded;
+  std::atomic<int> timedOut;
+  std::atomic<int64_t> claimNs[kMaxProcs];
+};
+
+void RaceChild(RaceShared* shared, const std::string& name, size_t index) {
+  {
+    SingleInstance instance(name);
+    while (!shared->go.load(std::memory_order_acquire)) {}
+    const Clock::time_point start = Clock::now();
+    const InstanceRole role = instance.Claim(std::chrono::seconds(2), [](const SingleInstance::Endpoint& e) {
+      return e.window == kWindowTag && kill((pid_t)e.pid, 0) == 0;
+    });
+    shared->claimNs[index].store(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    if (role == InstanceRole::Primary) {
+      shared->primaries.fetch_add(1);
+      // 模拟启动阶段：发布端点前的这段时间里，其余进程只能等待
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+      instance.Publish({(uint32_t)getpid(), kWindowTag});
+      while (shared->finished.load(std::memory_order_acquire) < shared->procs.load() - 1) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    } else {
+      (role == InstanceRole::Forwarded ? shared->forwarded : shared->timedOut).fetch_add(1);
+      shared->finished.fetch_add(1, std::memory_order_release);
+    }
+  } // 析构：释放锁、删除端点（_exit 不会运行析构函数）
+  _exit(0);
+}
+
+void RunRace(BenchState& state, int procs) {
+  void* mem = mmap(nullptr, sizeof(RaceShared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (mem == MAP_FAILED) { state.SetLabel("mmap failed"); return; }
+  RaceShared* shared = static_cast<RaceShared*>(mem);
+  const std::string name = BenchInstanceName();
+  std::vector<double> claimUs;
+  uint64_t badRounds = 0;
+  while (state.KeepRunning()) {
+    new (shared) RaceShared{};
+    std::vector<pid_t> children;
+    for (int i = 0; i < procs; ++i) {
+      const pid_t pid = fork();
+      if (pid == 0) RaceChild(shared, name, (size_t)i);
+      if (pid > 0) children.push_back(pid);
+    }
+    shared->procs.store((int)children.size());
+    shared->go.store(1, std::memory_order_release);
+    for (pid_t pid : children) {
+      int status = 0;
+      waitpid(pid, &status, 0);
+    }
+    if (shared->primaries.load() != 1 || shared->forwarded.load() != (int)children.size() - 1) ++badRounds;
+    for (size_t i = 0; i < children.size(); ++i) claimUs.push_back((double)shared->claimNs[i].load() / 1000.0);
+  }
+  munmap(mem, sizeof(RaceShared));
+  RemoveLockFile(name);
+
+  std::sort(claimUs.begin(), claimUs.end());
+  const auto pct = [&](double p) { return claimUs.empty() ? 0.0 : claimUs[(size_t)(p * (double)(claimUs.size() - 1))]; };
+  state.SetItemsProcessed(state.Iterations() * (uint64_t)procs);
+  state.SetCounter("claim_p50_us", pct(0.50));
+  state.SetCounter("claim_p99_us", pct(0.99));
+  state.SetCounter("bad_rounds", (double)badRounds);
+  if (badRounds) state.SetLabel("single-instance invariant violated");
+}
+
+[[maybe_unused]] const bool kRegistered = [] {
+  for (int procs : { 2, 8, 32 }) {
+    RegisterBenchmark("BM_SingleInstanceRace/" + std::to_string(procs),
+                      [procs](BenchState& state) { RunRace(state, procs); });
+  }
+  return true;
+}();
+
+} // namespace
+
+#endif // !_WIN32
@@ -0,0 +1,35 @@
+// 启动时间线记录器的开销：常开启，一个区间应只有两次时钟读取 + 一次原子自增；导出只在首帧后做一次
+#include "bench_harness.h"
+#include "core/startup_trace.h"
+
+namespace {
+
+void BM_StartupTraceSpan(BenchState& state) {
+  StartupTracer tracer;
+  while (state.KeepRunning()) {
+    StartupTracer::Span span(tracer, "span");
+  }
+  state.SetItemsProcessed(state.Iterations());
+  state.SetCounter("dropped", (double)tracer.Dropped());
+}
+NFB_BENCHMARK(BM_StartupTraceSpan);
+
+// 一次典型启动（约 20 个区间）的导出
+void BM_StartupTraceExport(BenchState& state) {
+  StartupTracer tracer;
+  tracer.SetProcess(1234, "chat_desktop");
+  for (int i = 0; i < 20; ++i) {
+    StartupTracer::Span span(tracer, "FlutterViewController");
+  }
+  tracer.AddInstant("first frame");
+  size_t bytes = 0;
+  while (state.KeepRunning()) {
+    bytes = tracer.ToChromeJson().size();
+    DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.Iterations());
+  state.SetBytesProcessed(state.Iterations() * bytes);
+}
+NFB_BENCHMARK(BM_StartupTraceExport);
+
+} // namespace
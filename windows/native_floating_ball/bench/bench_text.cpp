@@ -0,0 +1,101 @@
+// 气泡文本路径：字形图集 + 单行排版缓存 + 软件贴图（对应 BubbleWindow 的每帧文本绘制）
+#include <string>
+#include <vector>
+#include "bench_harness.h"
+#include "synthetic_rasterizer.h"
+#include "core/glyph_atlas.h"
+
+namespace {
+
+constexpr float kFontSize = 13.f;
+constexpr float kMaxTextWidth = 260.f;
+constexpr int kBubbleW = 280;
+constexpr int kBubbleH = 240;
+constexpr int kVisibleRows = 8;
+
+std::vector<std::u16string> MakeTitles(size_t count) {
+  static const char16_t* kSamples[] = {
+    u"请于本周五前提交季度预算调整方案并同步财务部",
+    u"Review PR #1284: fix race in task sync",
+    u"客户回访：华东区 12 家门店满意度调查（第二批）",
+    u"Deploy hotfix 2.3.1 to staging and notify QA",
+    u"整理会议纪要",
+    u"更新《员工手册》第 4 章：远程办公与考勤规则说明",
+  };
+  std::vector<std::u16string> titles;
+  for (size_t i = 0; i < count; ++i) {
+    std::u16string t = kSamples[i % (sizeof(kSamples) / sizeof(kSamples[0]))];
+    t += u" #";
+    for (char c : std::to_string(i)) t += (char16_t)c;
+    titles.push_back(std::move(t));
+  }
+  return titles;
+}
+
+// 冷启动：每次迭代都从空图集开始排版可见行（首帧 / 图集被清空后的成本）
+void BM_TextShapeCold(BenchState& state) {
+  const auto titles = MakeTitles(kVisibleRows);
+  SyntheticRasterizer raster;
+  while (state.KeepRunning()) {
+    GlyphAtlas atlas;
+    ShapedTextCache cache;
+    for (const auto& t : titles) DoNotOptimize(cache.Get(atlas, raster, t, kFontSize, 96, kMaxTextWidth));
+  }
+  state.SetItemsProcessed(state.Iterations() * titles.size());
+}
+NFB_BENCHMARK(BM_TextShapeCold);
+
+// 动画帧：所有可见行都已缓存，只剩查找
+void BM_TextShapeWarm(BenchState& state) {
+  const auto titles = MakeTitles(kVisibleRows);
+  SyntheticRasterizer raster;
+  GlyphAtlas atlas;
+  ShapedTextCache cache;
+  for (const auto& t : titles) cache.Get(atlas, raster, t, kFontSize, 96, kMaxTextWidth);
+  while (state.KeepRunning()) {
+    for (const auto& t : titles) DoNotOptimize(cache.Get(atlas, raster, t, kFontSize, 96, kMaxTextWidth));
+  }
+  state.SetItemsProcessed(state.Iterations() * titles.size());
+  state.SetCounter("hit_rate", cache.GetStats().HitRate());
+}
+NFB_BENCHMARK(BM_TextShapeWarm);
+
+// 把可见行贴到内存中的气泡缓冲（软件渲染一帧文本）
+void BM_TextBlitFrame(BenchState& state) {
+  const auto titles = MakeTitles(kVisibleRows);
+  SyntheticRasterizer raster;
+  GlyphAtlas atlas;
+  ShapedTextCache cache;
+  std::vector<const ShapedLine*> lines;
+  for (const auto& t : titles) lines.push_back(cache.Get(atlas, raster, t, kFontSize, 96, kMaxTextWidth));
+  std::vector<uint8_t> frame((size_t)kBubbleW * kBubbleH * 4, 0);
+  while (state.KeepRunning()) {
+    for (int i = 0; i < (int)lines.size(); ++i) {
+      BlitLine(*lines[i], atlas, frame.data(), kBubbleW * 4, kBubbleW, kBubbleH, 10, 10 + i * 28, 0xF2FFFFFFu, 1.f);
+    }
+    DoNotOptimize(frame.data());
+  }
+  state.SetItemsProcessed(state.Iterations() * lines.size());
+}
+NFB_BENCHMARK(BM_TextBlitFrame);
+
+// 大量不同标题滚动经过：衡量图集增长/清空与 LRU 淘汰下的稳态成本
+void BM_TextShapeScrolling(BenchState& state) {
+  const auto titles = MakeTitles(2000);
+  SyntheticRasterizer raster;
+  GlyphAtlas atlas;
+  ShapedTextCache cache;
+  size_t first = 0;
+  while (state.KeepRunning()) {
+    for (int i = 0; i < kVisibleRows; ++i) {
+      DoNotOptimize(cache.Get(atlas, raster, titles[(first + i) % titles.size()], kFontSize, 96, kMaxTextWidth));
+    }
+    first += 3; // 每帧滚动 3 行
+  }
+  state.SetItemsProcessed(state.Iterations() * kVisibleRows);
+  state.SetCounter("line_hit_rate", cache.GetStats().HitRate());
+  state.SetCounter("atlas_resets", (double)atlas.GetStats().resets);
+}
+NFB_BENCHMARK(BM_TextShapeScrolling);
+
+} // namespace
@@ -0,0 +1,151 @@
+// UTF-16 ⇄ UTF-8 转码：逐码点的两遍标量实现（对应 WideCharToMultiByte 先问长度再转换）与 core/utf_transcode 对比。
+// 语料取自真实路径：ASCII（任务 ID / JSON 键）、中文标题、中英混排。
+#include <string>
+#include <vector>
+#include "bench_harness.h"
+#include "core/utf_transcode.h"
+
+namespace {
+
+enum class Corpus { Ascii, Cjk, Mixed };
+
+const char* CorpusName(Corpus c) {
+  switch (c) {
+  case Corpus::Ascii: return "ascii";
+  case Corpus::Cjk: return "cjk";
+  default: return "mixed";
+  }
+}
+
+// 约 64 KiB 的 UTF-16 文本
+std::u16string MakeText(Corpus corpus) {
+  static const char16_t* kAscii[] = {
+    u"{\"taskId\":\"6f1c2a9e-04b7-4d1e-9a55-3c0e7d2b8f41\",\"unread\":true}",
+    u"Review PR #1284: fix race in task sync",
+  };
+  static const char16_t* kCjk[] = {
+    u"请于本周五前提交季度预算调整方案并同步财务部",
+    u"更新员工手册第四章远程办公与考勤规则说明",
+  };
+  static const char16_t* kMixed[] = {
+    u"客户回访：华东区 12 家门店满意度调查（第二批）",
+    u"Deploy hotfix 2.3.1 to staging 并通知 QA 🚀",
+  };
+  const char16_t** samples = corpus == Corpus::Ascii ? kAscii : corpus == Corpus::Cjk ? kCjk : kMixed;
+  std::u16string text;
+  for (size_t i = 0; text.size() < 32 * 1024; ++i) {
+    text += samples[i % 2];
+    text += u'\n';
+  }
+  return text;
+}
+
+void BaselineUtf16ToUtf8(std::u16string_view in, std::string* out) {
+  auto next = [&](size_t& i) -> char32_t {
+    const char32_t c = in[i++];
+    if (c >= 0xD800 && c <= 0xDBFF && i < in.size() && in[i] >= 0xDC00 && in[i] <= 0xDFFF) {
+      return 0x10000 + ((c - 0xD800) << 10) + (in[i++] - 0xDC00);
+    }
+    return (c >= 0xD800 && c <= 0xDFFF) ? 0xFFFD : c;
+  };
+  size_t length = 0;
+  for (size_t i = 0; i < in.size();) {
+    const char32_t c = next(i);
+    length += c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+  }
+  out->resize(length);
+  char* p = out->data();
+  for (size_t i = 0; i < in.size();) {
+    const char32_t c = next(i);
+    if (c < 0x80) {
+      *p++ = (char)c;
+    } else if (c < 0x800) {
+      *p++ = (char)(0xC0 | (c >> 6));
+      *p++ = (char)(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+      *p++ = (char)(0xE0 | (c >> 12));
+      *p++ = (char)(0x80 | ((c >> 6) & 0x3F));
+      *p++ = (char)(0x80 | (c & 0x3F));
+    } else {
+      *p++ = (char)(0xF0 | (c >> 18));
+      *p++ = (char)(0x80 | ((c >> 12) & 0x3F));
+      *p++ = (char)(0x80 | ((c >> 6) & 0x3F));
+      *p++ = (char)(0x80 | (c & 0x3F));
+    }
+  }
+}
+
+// 只处理合法输入（语料由上面的编码器生成）
+void BaselineUtf8ToUtf16(std::string_view in, std::u16string* out) {
+  auto next = [&](size_t& i) -> char32_t {
+    const unsigned char b = (unsigned char)in[i++];
+    if (b < 0x80) return b;
+    const int extra = b >= 0xF0 ? 3 : b >= 0xE0 ? 2 : 1;
+    char32_t c = b & (0x3F >> extra);
+    for (int k = 0; k < extra && i < in.size(); ++k) c = (c << 6) | ((unsigned char)in[i++] & 0x3F);
+    return c;
+  };
+  size_t length = 0;
+  for (size_t i = 0; i < in.size();) length += next(i) >= 0x10000 ? 2 : 1;
+  out->resize(length);
+  char16_t* p = out->data();
+  for (size_t i = 0; i < in.size();) {
+    const char32_t c = next(i);
+    if (c >= 0x10000) {
+      *p++ = (char16_t)(0xD800 + ((c - 0x10000) >> 10));
+      *p++ = (char16_t)(0xDC00 + ((c - 0x10000) & 0x3FF));
+    } else {
+      *p++ = (char16_t)c;
+    }
+  }
+}
+
+void RunToUtf8(BenchState& state, Corpus corpus, bool baseline) {
+  const std::u16string text = MakeText(corpus);
+  std::string out;
+  while (state.KeepRunning()) {
+    if (baseline) BaselineUtf16ToUtf8(text, &out);
+    else Utf16ToUtf8(text, &out);
+    DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.Iterations() * text.size());
+  state.SetBytesProcessed(state.Iterations() * text.size() * sizeof(char16_t));
+  state.SetCounter("utf8_bytes", (double)out.size());
+}
+
+void RunToUtf16(BenchState& state, Corpus corpus, bool baseline) {
+  std::string text;
+  Utf16ToUtf8(MakeText(corpus), &text);
+  std::u16string out;
+  while (state.KeepRunning()) {
+    if (baseline) BaselineUtf8ToUtf16(text, &out);
+    else Utf8ToUtf16(text, &out);
+    DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.Iterations() * text.size());
+  state.SetBytesProcessed(state.Iterations() * text.size());
+  state.SetCounter("utf16_units", (double)out.size());
+}
+
+// 只做校验 + 长度统计（Strict 模式入口的第一步）
+void RunLength(BenchState& state, Corpus corpus) {
+  const std::u16string text = MakeText(corpus);
+  bool valid = false;
+  while (state.KeepRunning()) DoNotOptimize(Utf8LengthOf(text, &valid));
+  state.SetBytesProcessed(state.Iterations() * text.size() * sizeof(char16_t));
+  if (!valid) state.SetLabel("corpus rejected");
+}
+
+[[maybe_unused]] const bool kRegistered = [] {
+  for (Corpus corpus : { Corpus::Ascii, Corpus::Cjk, Corpus::Mixed }) {
+    const std::string suffix = std::string("/") + CorpusName(corpus);
+    RegisterBenchmark("BM_Utf16ToUtf8Baseline" + suffix, [corpus](BenchState& s) { RunToUtf8(s, corpus, true); });
+    RegisterBenchmark("BM_Utf16ToUtf8" + suffix, [corpus](BenchState& s) { RunToUtf8(s, corpus, false); });
+    RegisterBenchmark("BM_Utf8ToUtf16Baseline" + suffix, [corpus](BenchState& s) { RunToUtf16(s, corpus, true); });
+    RegisterBenchmark("BM_Utf8ToUtf16" + suffix, [corpus](BenchState& s) { RunToUtf16(s, corpus, false); });
+    RegisterBenchmark("BM_Utf8LengthOf" + suffix, [corpus](BenchState& s) { RunLength(s, corpus); });
+  }
+  return true;
+}();
+
+} // namespace
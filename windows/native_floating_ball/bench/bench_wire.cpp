@@ -0,0 +1,136 @@
+// UPDATE_TASKS 二进制负载：编码（发送端）、零拷贝解码与解码后合并进列表模型（悬浮球接收端）
+#include <string>
+#include <vector>
+#include "bench_harness.h"
+#include "core/task_list_model.h"
+#include "core/task_sync.h"
+#include "core/task_wire.h"
+
+namespace {
+
+constexpr size_t kTaskCount = 500;
+
+struct OwnedTasks {
+  std::vector<std::u16string> ids;
+  std::vector<std::u16string> titles;
+  std::vector<TaskItemView> views;
+};
+
+OwnedTasks MakeTasks(size_t count) {
+  static const char16_t* kSamples[] = {
+    u"请于本周五前提交季度预算调整方案并同步财务部",
+    u"Review PR #1284: fix race in task sync",
+    u"客户回访：华东区 12 家门店满意度调查（第二批）",
+    u"整理会议纪要\n（含行动项）",
+  };
+  OwnedTasks t;
+  for (size_t i = 0; i < count; ++i) {
+    std::u16string id;
+    for (char c : std::to_string(100000 + i)) id += (char16_t)c;
+    t.ids.push_back(std::move(id));
+    t.titles.push_back(kSamples[i % (sizeof(kSamples) / sizeof(kSamples[0]))]);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    TaskItemView v;
+    v.id = t.ids[i];
+    v.title = t.titles[i];
+    v.priority = (uint8_t)(i % 3);
+    v.dueMs = 1700000000000LL + (int64_t)i * 60000;
+    t.views.push_back(v);
+  }
+  return t;
+}
+
+void BM_WireEncode(BenchState& state) {
+  const OwnedTasks tasks = MakeTasks(kTaskCount);
+  TaskWireWriter writer;
+  size_t bytes = 0;
+  while (state.KeepRunning()) {
+    writer.Begin(TaskWireKind::Snapshot);
+    for (const TaskItemView& v : tasks.views) writer.Add(v);
+    bytes = writer.Finish().size();
+    DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.Iterations() * kTaskCount);
+  state.SetBytesProcessed(state.Iterations() * bytes);
+}
+NFB_BENCHMARK(BM_WireEncode);
+
+void BM_WireDecode(BenchState& state) {
+  const OwnedTasks tasks = MakeTasks(kTaskCount);
+  TaskWireWriter writer;
+  writer.Begin(TaskWireKind::Snapshot);
+  for (const TaskItemView& v : tasks.views) writer.Add(v);
+  const std::vector<uint8_t> payload = writer.Finish();
+  std::vector<TaskItemView> decoded;
+  while (state.KeepRunning()) {
+    DoNotOptimize(DecodeTaskWire(payload.data(), payload.size(), &decoded));
+  }
+  state.SetItemsProcessed(state.Iterations() * kTaskCount);
+  state.SetBytesProcessed(state.Iterations() * payload.size());
+}
+NFB_BENCHMARK(BM_WireDecode);
+
+// 稳态：列表没有变化，只解码并按 id 比对（不应为任何行分配内存）
+void BM_WireDecodeApplyUnchanged(BenchState& state) {
+  const OwnedTasks tasks = MakeTasks(kTaskCount);
+  TaskWireWriter writer;
+  writer.Begin(TaskWireKind::Snapshot);
+  for (const TaskItemView& v : tasks.views) writer.Add(v);
+  const std::vector<uint8_t> payload = writer.Finish();
+  std::vector<TaskItemView> decoded;
+  TaskListModel model;
+  model.Replace(tasks.views);
+  while (state.KeepRunning()) {
+    DecodeTaskWire(payload.data(), payload.size(), &decoded);
+    DoNotOptimize(model.Replace(decoded).Empty());
+  }
+  state.SetItemsProcessed(state.Iterations() * kTaskCount);
+}
+NFB_BENCHMARK(BM_WireDecodeApplyUnchanged);
+
+// 突发更新：大列表上一次只改一条。快照要重发并比对整表，增量只触及那一行
+constexpr size_t kLargeTaskCount = 5000;
+
+void BM_SyncSnapshotOneChanged(BenchState& state) {
+  OwnedTasks tasks = MakeTasks(kLargeTaskCount);
+  TaskWireWriter writer;
+  TaskListModel model;
+  TaskSyncReceiver sync;
+  uint32_t seq = 0;
+  const std::u16string titles[2] = {u"标题 A", u"标题 B"};
+  while (state.KeepRunning()) {
+    tasks.views[kLargeTaskCount / 2].title = titles[seq & 1];
+    writer.Begin(TaskWireKind::Snapshot, ++seq);
+    for (const TaskItemView& v : tasks.views) writer.Add(v);
+    const std::vector<uint8_t>& payload = writer.Finish();
+    DoNotOptimize(sync.Apply(payload.data(), payload.size(), model));
+  }
+  state.SetItemsProcessed(state.Iterations());
+}
+NFB_BENCHMARK(BM_SyncSnapshotOneChanged);
+
+void BM_SyncDeltaOneChanged(BenchState& state) {
+  OwnedTasks tasks = MakeTasks(kLargeTaskCount);
+  TaskWireWriter writer;
+  TaskListModel model;
+  TaskSyncReceiver sync;
+  uint32_t seq = 1;
+  writer.Begin(TaskWireKind::Snapshot, seq);
+  for (const TaskItemView& v : tasks.views) writer.Add(v);
+  sync.Apply(writer.Finish().data(), writer.Finish().size(), model);
+  const std::u16string titles[2] = {u"标题 A", u"标题 B"};
+  while (state.KeepRunning()) {
+    TaskItemView changed = tasks.views[kLargeTaskCount / 2];
+    changed.title = titles[seq & 1];
+    writer.Begin(TaskWireKind::Update, ++seq);
+    writer.Add(changed);
+    const std::vector<uint8_t>& payload = writer.Finish();
+    DoNotOptimize(sync.Apply(payload.data(), payload.size(), model));
+  }
+  state.SetItemsProcessed(state.Iterations());
+  state.SetCounter("resyncs", sync.HasBase() ? 0.0 : 1.0);
+}
+NFB_BENCHMARK(BM_SyncDeltaOneChanged);
+
+} // namespace
@@ -0,0 +1,275 @@
+#include "headless_ball.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include "core/task_wire.h"
+
+namespace {
+
+constexpr int kBubbleWidth = 280; // BubbleWindow::kWidth
+constexpr int kBubbleMaxRows = 8; // BubbleWindow::kMaxVisibleRows
+constexpr float kFontSize = 13.f;
+constexpr uint32_t kLegacyTextCopyData = 1;
+
+int64_t ElapsedNs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+HeadlessBall::HeadlessBall(uint32_t diameter)
+  : m_diameter(diameter), m_dib((size_t)diameter * diameter * 4) {}
+
+int HeadlessBall::LoadAssets(const std::string& dir) {
+  static const char* kFiles[2] = { "unread_logo.gif", "dynamic_logo.gif" }; // 按 BallGif 排列
+  m_mask.Build(m_diameter);
+  m_fallbackFrame.resize(m_dib.size());
+  m_mask.Fill(0xFF4169E1u, m_fallbackFrame.data(), (size_t)m_diameter * 4);
+  m_fallbackHit.Build(m_mask.Row(0), m_diameter, m_diameter, m_diameter, 1);
+  int loaded = 0;
+  for (int i = 0; i < 2; ++i) {
+    std::ifstream in(dir + "/" + kFiles[i], std::ios::binary);
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (m_gifs[i].Build(bytes.data(), bytes.size(), m_mask)) ++loaded;
+    m_state.SetFrameDelays((BallGif)i, m_gifs[i].DelaysMs());
+  }
+  // 对应 WM_CREATE 末尾：选择 GIF、启动帧定时器、绘制首帧
+  ApplyEffects(m_state.Start());
+  return loaded;
+}
+
+uint64_t HeadlessBall::NextTickUs() const {
+  return m_nextTickUs;
+}
+
+void HeadlessBall::AdvanceTo(uint64_t timeUs, DispatchProfiler* profile) {
+  while (m_nextTickUs <= timeUs) {
+    m_nowUs = m_nextTickUs;
+    const auto start = std::chrono::steady_clock::now();
+    TickBubble();
+    if (profile) profile->Record(kBubbleTickClass, (uint64_t)ElapsedNs(start));
+  }
+  m_nowUs = (std::max)(m_nowUs, timeUs);
+}
+
+void HeadlessBall::Dispatch(const TraceEvent& event, DispatchProfiler* profile) {
+  AdvanceTo(event.timeUs, profile);
+  const auto start = std::chrono::steady_clock::now();
+  Handle(event);
+  if (profile) profile->Record((uint32_t)event.kind, (uint64_t)ElapsedNs(start));
+}
+
+// 与 BallWindow::HandleMessage 的对应分支一致
+void HeadlessBall::Handle(const TraceEvent& event) {
+  switch (event.kind) {
+  case TraceEventKind::MouseMove: {
+    // 窗口版在 WM_NCHITTEST 里把透明像素交给下面的窗口，这些位置根本收不到 WM_MOUSEMOVE
+    // （更早录的轨迹里可能还有）
+    const DisplayFrames& gif = m_gifs[(size_t)m_state.ActiveGif()];
+    const HitMask& hit = gif.FrameCount() ? gif.Hit() : m_fallbackHit;
+    if (!hit.Contains((int)event.a, (int)event.b)) {
+      ++m_passedThrough;
+      break;
+    }
+    ApplyEffects(m_state.OnMouseMove(m_bubbleVisible && !m_animHiding));
+    break;
+  }
+  case TraceEventKind::MouseLeave:
+    ApplyEffects(m_state.OnMouseLeave());
+    break;
+  case TraceEventKind::FrameTimer:
+    ApplyEffects(m_state.OnFrameTimer());
+    break;
+  case TraceEventKind::HideTimer:
+    ApplyEffects(m_state.OnHideTimer(event.a != 0));
+    break;
+  case TraceEventKind::CopyData:
+  case TraceEventKind::SnapshotPublished: {
+    // lpData 在窗口版中是对齐的；轨迹里的负载位置任意，先拷到对齐的缓冲
+    std::vector<uint64_t> aligned((event.payloadSize + 7) / 8);
+    if (event.payloadSize) std::memcpy(aligned.data(), event.payload, event.payloadSize);
+    if (event.kind == TraceEventKind::CopyData && event.a == kLegacyTextCopyData) {
+      const std::vector<TaskItemView>& items = m_textParser.Parse(
+          std::u16string_view(reinterpret_cast<const char16_t*>(aligned.data()), event.payloadSize / sizeof(char16_t)));
+      m_sync.Invalidate();
+      OnTasksChanged(m_model.Replace(items));
+      break;
+    }
+    if (event.kind == TraceEventKind::CopyData && event.a != kTaskWireCopyDataId) break;
+    const TaskSyncResult result = m_sync.Apply(aligned.data(), event.payloadSize, m_model);
+    if (result == TaskSyncResult::Rejected) {
+      ++m_rejected;
+    } else {
+      OnTasksChanged(result == TaskSyncResult::Applied ? m_model.LastDiff() : TaskListDiff{});
+    }
+    break;
+  }
+  case TraceEventKind::TasksFlush:
+    ApplyEffects(m_state.FlushTasksChanged());
+    break;
+  case TraceEventKind::DpiChanged:
+  case TraceEventKind::DisplayChange:
+    // 窗口版只重新定位窗口，不重建 DIB，也不重绘
+    break;
+  default:
+    break;
+  }
+}
+
+// BubbleWindow::OnModelChanged + BallWindow::QueueTasksChanged
+void HeadlessBall::OnTasksChanged(const TaskListDiff& diff) {
+  if (!m_bubbleVisible) m_model.Tick(1.f);
+  m_viewport.itemCount = (int)m_model.Size();
+  m_viewport.ClampScroll();
+  if (m_bubbleVisible && m_model.IsAnimating() && !m_rowAnim) {
+    m_rowAnim = true;
+    if (m_nextTickUs == UINT64_MAX) m_nextTickUs = m_nowUs + kBubbleTickUs;
+  }
+  m_state.QueueTasksChanged(diff, (int)m_model.LiveCount());
+}
+
+void HeadlessBall::ApplyEffects(uint32_t effects) {
+  if (effects & kBallEffectRender) RenderBall();
+  if (effects & kBallEffectShowBubble) ShowBubble();
+  if ((effects & kBallEffectRefreshBubble) && m_bubbleVisible) {
+    ListViewport v = m_viewport;
+    v.itemCount = (int)m_model.LiveCount();
+    m_bubbleHeight = (int)std::ceil(v.PreferredHeight(kBubbleMaxRows));
+    m_viewport.viewportHeight = (float)m_bubbleHeight;
+    m_viewport.ClampScroll();
+    RenderBubble();
+  }
+  if (effects & kBallEffectHideBubble) HideBubble();
+  // 帧定时器与隐藏轮询（包括 kBallEffectStopHideTimer）的触发都已录在轨迹里，这里不需要模拟
+}
+
+void HeadlessBall::RenderBall() {
+  const DisplayFrames& gif = m_gifs[(size_t)m_state.ActiveGif()];
+  const uint8_t* frame = gif.FrameCount() ? gif.Frame(m_state.FrameIndex() % gif.FrameCount()) : m_fallbackFrame.data();
+  std::memcpy(m_dib.data(), frame, m_dib.size());
+  ++m_ballFrames;
+}
+
+// BallWindow::ShowBubble → BubbleWindow::ShowNoActivate（每次都会重启显示动画）
+void HeadlessBall::ShowBubble() {
+  ListViewport v = m_viewport;
+  v.itemCount = (int)m_model.LiveCount();
+  m_bubbleHeight = (int)std::ceil(v.PreferredHeight(kBubbleMaxRows));
+  m_viewport.viewportHeight = (float)m_bubbleHeight;
+  m_viewport.ClampScroll();
+  m_animShowing = true;
+  m_animHiding = false;
+  m_animT = 0.f;
+  if (m_nextTickUs == UINT64_MAX) m_nextTickUs = m_nowUs + kBubbleTickUs;
+  RenderBubble();
+  m_bubbleVisible = true;
+}
+
+void HeadlessBall::HideBubble() {
+  if (!m_bubbleVisible) return;
+  m_animHiding = true;
+  m_animShowing = false;
+  m_animT = 0.f;
+  if (m_nextTickUs == UINT64_MAX) m_nextTickUs = m_nowUs + kBubbleTickUs;
+}
+
+// BubbleWindow::Render 的软件版本：清屏后只排版并贴可见行
+void HeadlessBall::RenderBubble() {
+  if (!m_bubbleVisible && !m_animHiding) return;
+  const int h = (std::max)(m_bubbleHeight, 1);
+  m_bubbleSurface.assign((size_t)kBubbleWidth * h * 4, 0);
+  float t = m_animHiding ? 1.f - m_animT : m_animT;
+  const float opacity = 0.1f + 0.9f * t;
+  const float maxTextW = (float)kBubbleWidth - 20.f;
+  int first = 0, last = 0;
+  m_viewport.VisibleRange(&first, &last);
+  for (int i = first; i < last; ++i) {
+    const TaskRow& row = m_model.Row(i);
+    const std::u16string& text = row.item.title.empty() ? row.item.id : row.item.title;
+    const ShapedLine* line = m_lines.Get(m_atlas, m_raster, text, kFontSize, 96, maxTextW);
+    const int dx = row.removing ? 0 : (int)std::round((1.f - row.anim) * 8.f);
+    BlitLine(*line, m_atlas, m_bubbleSurface.data(), kBubbleWidth * 4, kBubbleWidth, h, 10 + dx,
+             (int)m_viewport.RowTop(i), 0xF2FFFFFFu, row.anim * opacity);
+  }
+  ++m_bubbleFrames;
+}
+
+// 显隐动画（定时器 101）与行动画（定时器 102）共用 16ms 周期，各自触发一次重绘
+void HeadlessBall::TickBubble() {
+  if (m_animShowing || m_animHiding) {
+    m_animT = (std::min)(m_animT + 0.08f, 1.f);
+    RenderBubble();
+    if (m_animT >= 1.f) {
+      if (m_animHiding) {
+        m_bubbleVisible = false;
+        m_animHiding = false;
+        m_rowAnim = false;
+        m_model.Tick(1.f);
+        m_viewport.itemCount = (int)m_model.Size();
+      }
+      m_animShowing = false;
+    }
+  }
+  if (m_rowAnim) {
+    const bool more = m_model.Tick(0.016f);
+    m_viewport.itemCount = (int)m_model.Size();
+    m_viewport.ClampScroll();
+    RenderBubble();
+    if (!more) m_rowAnim = false;
+  }
+  m_nextTickUs = (m_animShowing || m_animHiding || m_rowAnim) ? m_nowUs + kBubbleTickUs : UINT64_MAX;
+}
+
+ReplayResult ReplayTrace(const uint8_t* data, size_t size, HeadlessBall& ball, bool realtime,
+                         DispatchProfiler* profile) {
+  ReplayResult result;
+  EventTraceReader reader;
+  if (!reader.Open(data, size)) return result;
+  const uint64_t base = ball.NowUs();
+  const auto start = std::chrono::steady_clock::now();
+  const auto waitUntil = [&](uint64_t us) {
+    if (realtime) std::this_thread::sleep_until(start + std::chrono::microseconds(us - base));
+  };
+  TraceEvent event;
+  while (reader.Next(&event)) {
+    event.timeUs += base;
+    while (ball.NextTickUs() <= event.timeUs) {
+      const uint64_t tick = ball.NextTickUs();
+      waitUntil(tick);
+      ball.AdvanceTo(tick, profile);
+    }
+    waitUntil(event.timeUs);
+    ball.Dispatch(event, profile);
+    ++result.events;
+    result.traceUs = event.timeUs - base;
+  }
+  result.truncated = reader.Truncated();
+  result.wallMs = (double)ElapsedNs(start) / 1e6;
+  return result;
+}
+
+std::string FormatReplayProfile(const DispatchProfiler& profile) {
+  std::string out;
+  char line[160];
+  std::snprintf(line, sizeof(line), "%-16s %10s %10s %10s %10s %12s\n",
+                "event", "count", "avg_us", "p99_us", "max_us", "total_ms");
+  out += line;
+  const auto row = [&](const char* name, uint32_t id) {
+    const DispatchProfiler::Entry* e = profile.Find(id);
+    if (!e || !e->count) return;
+    std::snprintf(line, sizeof(line), "%-16s %10llu %10.1f %10.1f %10.1f %12.2f\n", name,
+                  (unsigned long long)e->count, (double)e->totalNs / (double)e->count / 1000.0,
+                  (double)e->PercentileNs(0.99) / 1000.0, (double)e->maxNs / 1000.0, (double)e->totalNs / 1e6);
+    out += line;
+  };
+  for (uint32_t id = (uint32_t)TraceEventKind::MouseMove; id <= (uint32_t)TraceEventKind::DisplayChange; ++id) {
+    row(TraceEventKindName((TraceEventKind)id), id);
+  }
+  row("bubble_tick", HeadlessBall::kBubbleTickClass);
+  return out;
+}
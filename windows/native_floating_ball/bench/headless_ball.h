@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "synthetic_rasterizer.h"
+#include "core/ball_state.h"
+#include "core/circle_mask.h"
+#include "core/dispatch_profiler.h"
+#include "core/display_frames.h"
+#include "core/event_trace.h"
+#include "core/glyph_atlas.h"
+#include "core/hit_mask.h"
+#include "core/list_viewport.h"
+#include "core/task_list_model.h"
+#include "core/task_sync.h"
+#include "core/task_text_parser.h"
+
+// 无窗口的悬浮球：与 ball_wnd.cpp 共用 BallState，任务模型走同样的 TaskSyncReceiver / TaskTextParser，
+// 渲染用软件实现并保持与窗口版相同的工作量——GIF 在加载时构建为乘过圆形蒙版的显示尺寸帧，
+// 每帧只拷进 DIB；气泡只绘制可见行（字形图集 + BlitLine，字形来自合成光栅化器）。
+// 气泡的显隐动画与行动画在窗口版由 16ms 定时器驱动，回放时按轨迹时间在两条事件之间补上这些 tick。
+class HeadlessBall {
+public:
+  static constexpr uint32_t kBubbleTickUs = 16000;
+  // 回放报告里的附加类别（轨迹中的事件类别见 TraceEventKind）
+  static constexpr uint32_t kBubbleTickClass = 100;
+
+  explicit HeadlessBall(uint32_t diameter = 120);
+
+  // 按 LoadGifs 的方式加载两张 GIF（构建显示尺寸帧）；找不到的按空动画处理
+  // （窗口版此时绘制纯色圆）。返回成功加载的张数。
+  int LoadAssets(const std::string& dir);
+
+  // 先补上 timeUs 之前到期的气泡 tick，再处理事件；耗时按类别记入 profile（可为空）
+  void Dispatch(const TraceEvent& event, DispatchProfiler* profile);
+  // 处理 timeUs 之前到期的气泡 tick
+  void AdvanceTo(uint64_t timeUs, DispatchProfiler* profile);
+  // 下一个气泡 tick 的时间；没有进行中的动画时返回 UINT64_MAX
+  uint64_t NextTickUs() const;
+  // 已处理到的时间；回放把轨迹时间平移到它之后，同一个对象可以连续回放多次
+  uint64_t NowUs() const { return m_nowUs; }
+
+  const BallState& State() const { return m_state; }
+  size_t TaskCount() const { return m_model.LiveCount(); }
+  uint64_t BallFrames() const { return m_ballFrames; }
+  uint64_t BubbleFrames() const { return m_bubbleFrames; }
+  uint64_t Rejected() const { return m_rejected; }
+  // 落在透明像素上、窗口版会穿透到下层窗口的 WM_MOUSEMOVE
+  uint64_t PassedThrough() const { return m_passedThrough; }
+
+private:
+  void Handle(const TraceEvent& event);
+  void ApplyEffects(uint32_t effects);
+  void OnTasksChanged(const TaskListDiff& diff);
+  void RenderBall();
+  void ShowBubble();
+  void HideBubble();
+  void RenderBubble();
+  void TickBubble();
+
+  uint32_t m_diameter;
+  BallState m_state;
+  CircleMask m_mask;
+  DisplayFrames m_gifs[2];
+  std::vector<uint8_t> m_fallbackFrame;
+  HitMask m_fallbackHit;
+  std::vector<uint8_t> m_dib;
+
+  TaskSyncReceiver m_sync;
+  TaskTextParser m_textParser;
+  TaskListModel m_model;
+  ListViewport m_viewport;
+  SyntheticRasterizer m_raster;
+  GlyphAtlas m_atlas;
+  ShapedTextCache m_lines;
+  std::vector<uint8_t> m_bubbleSurface;
+  int m_bubbleHeight{0};
+  bool m_bubbleVisible{false};
+  bool m_animShowing{false};
+  bool m_animHiding{false};
+  float m_animT{0.f};
+  bool m_rowAnim{false};
+  uint64_t m_nowUs{0};
+  uint64_t m_nextTickUs{UINT64_MAX};
+
+  uint64_t m_ballFrames{0};
+  uint64_t m_bubbleFrames{0};
+  uint64_t m_rejected{0};
+  uint64_t m_passedThrough{0};
+};
+
+struct ReplayResult {
+  uint64_t events{0};
+  uint64_t traceUs{0};   // 轨迹覆盖的时长
+  double wallMs{0.0};    // 回放实际用时（realtime 时约等于 traceUs）
+  bool truncated{false}; // 轨迹末尾不完整（录制中途崩溃），已回放完整的部分
+};
+
+// 把整条轨迹喂给 ball；realtime 为 true 时按录制时的间隔等待，否则全速。
+// profile 按类别累计每个事件（及气泡 tick）的处理耗时：单线程、不含等待，即每类事件占用的 CPU 时间
+ReplayResult ReplayTrace(const uint8_t* data, size_t size, HeadlessBall& ball, bool realtime,
+                         DispatchProfiler* profile);
+
+// 按类别的文本报告：次数、平均 / p99 / 最大（微秒）、合计（毫秒）
+std::string FormatReplayProfile(const DispatchProfiler& profile);
@@ -0,0 +1,61 @@
+// 事件轨迹回放工具：把悬浮球录下的 .nfbt 喂给无窗口悬浮球，按事件类别输出处理耗时。
+//   native_floating_replay trace.nfbt [--realtime] [--assets=dir] [--loops=N]
+// --realtime 按录制时的间隔回放（复现定时器与输入的交错）；默认全速回放，适合做回归对比。
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "headless_ball.h"
+
+int main(int argc, char** argv) {
+  std::string tracePath;
+  std::string assetDir = NFB_ASSET_DIR;
+  bool realtime = false;
+  int loops = 1;
+  for (int i = 1; i < argc; ++i) {
+    const char* a = argv[i];
+    if (std::strcmp(a, "--realtime") == 0) realtime = true;
+    else if (std::strncmp(a, "--assets=", 9) == 0) assetDir = a + 9;
+    else if (std::strncmp(a, "--loops=", 8) == 0) loops = (std::max)(1, std::atoi(a + 8));
+    else if (a[0] != '-' && tracePath.empty()) tracePath = a;
+    else {
+      tracePath.clear();
+      break;
+    }
+  }
+  if (tracePath.empty()) {
+    std::fprintf(stderr, "usage: %s trace.nfbt [--realtime] [--assets=dir] [--loops=N]\n", argv[0]);
+    return 2;
+  }
+
+  std::ifstream in(tracePath, std::ios::binary);
+  const std::vector<uint8_t> trace((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  EventTraceReader probe;
+  if (!probe.Open(trace.data(), trace.size())) {
+    std::fprintf(stderr, "%s: not an event trace\n", tracePath.c_str());
+    return 1;
+  }
+
+  HeadlessBall ball;
+  if (ball.LoadAssets(assetDir) < 2) {
+    std::fprintf(stderr, "warning: missing GIFs in %s, those states render a solid circle\n", assetDir.c_str());
+  }
+  DispatchProfiler profile;
+  ReplayResult result;
+  for (int i = 0; i < loops; ++i) {
+    result = ReplayTrace(trace.data(), trace.size(), ball, realtime, &profile);
+  }
+
+  std::printf("%s: %llu events over %.1f ms, replay %.1f ms/loop x %d%s\n", tracePath.c_str(),
+              (unsigned long long)result.events, (double)result.traceUs / 1000.0, result.wallMs, loops,
+              result.truncated ? " (truncated)" : "");
+  std::printf("ball frames %llu, bubble frames %llu, tasks %zu, rejected %llu\n\n",
+              (unsigned long long)ball.BallFrames(), (unsigned long long)ball.BubbleFrames(), ball.TaskCount(),
+              (unsigned long long)ball.Rejected());
+  std::fputs(FormatReplayProfile(profile).c_str(), stdout);
+  return 0;
+}
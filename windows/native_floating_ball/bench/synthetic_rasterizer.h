@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include "core/glyph_atlas.h"
+
+// 无字体依赖的光栅化器：CJK 全角、其余半角，生成确定性的覆盖率图案。
+// 只用于在没有 DirectWrite 的环境下测量图集/排版/贴图本身的开销。
+class SyntheticRasterizer : public GlyphRasterizer {
+public:
+  bool Rasterize(uint32_t codepoint, float sizePx, GlyphBitmap* out) override {
+    ++rasterized;
+    const bool wide = codepoint >= 0x2E80;
+    out->advance = wide ? sizePx : sizePx * 0.55f;
+    if (codepoint == ' ') return true;
+    out->width = (int)(out->advance) - 1;
+    out->height = (int)(sizePx * 0.8f);
+    out->left = 0;
+    out->top = out->height;
+    out->coverage.resize((size_t)out->width * (size_t)out->height);
+    uint32_t h = codepoint * 2654435761u;
+    for (auto& c : out->coverage) {
+      h ^= h << 13; h ^= h >> 17; h ^= h << 5;
+      c = (uint8_t)(h >> 24);
+    }
+    return true;
+  }
+  float Ascent(float sizePx) const override { return sizePx * 0.9f; }
+  float LineHeight(float sizePx) const override { return sizePx * 1.3f; }
+
+  uint64_t rasterized{0};
+};
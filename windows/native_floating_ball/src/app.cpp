@@ -1,21 +1,69 @@
 #include <windows.h>
 #include <shellscalingapi.h>
+#include <fstream>
+#include <string>
 #include "ball_wnd.h"
+#include "core/async_logger.h"
+#include "core/process_supervisor.h"
+#include "core/startup_trace.h"
+#include "core/utf_transcode.h"
 
 #pragma comment(lib, "Shcore.lib")
 
+// 环境变量 CHAT_DESKTOP_STARTUP_TRACE 指向目录时，把启动时间线写成 Chrome trace JSON
+// （与主程序的 startup_chat_desktop_<pid>.json 放在一起，可在查看器中合并）
+static void ExportStartupTraceIfRequested() {
+  wchar_t dir[MAX_PATH];
+  const DWORD len = GetEnvironmentVariableW(L"CHAT_DESKTOP_STARTUP_TRACE", dir, MAX_PATH);
+  if (len == 0 || len >= MAX_PATH) return;
+  std::wstring path(dir, len);
+  if (path.back() != L'\\' && path.back() != L'/') path += L'\\';
+  path += L"startup_native_floating_ball_" + std::to_wstring(GetCurrentProcessId()) + L".json";
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (out.is_open()) out << ProcessStartupTracer().ToChromeJson();
+}
+
+// 由主程序的 ProcessSupervisor 拉起时，窗口与 GIF 都已就绪后通知它（随后立即收到第一份快照）
+static void SignalLauncherReady() {
+  int argc = 0;
+  LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+  if (!argv) return;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg;
+    Utf16ToUtf8(std::u16string_view(reinterpret_cast<const char16_t*>(argv[i]), wcslen(argv[i])), &arg);
+    if (SignalSupervisorReady(arg)) break;
+  }
+  LocalFree(argv);
+}
+
 int APIENTRY wWinMain(HINSTANCE hInst, HINSTANCE, LPWSTR, int) {
+  StartupTracer& trace = ProcessStartupTracer();
+  trace.SetProcess(GetCurrentProcessId(), "native_floating_ball");
+  StartupTracer::Span startup(trace, "wWinMain -> message loop");
   // DPI awareness (Win10): per‑monitor v2
   SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
-  CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+  {
+    StartupTracer::Span span(trace, "CoInitializeEx");
+    CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+  }
 
   BallWindow::Register(hInst);
   const int diameter = 120;
   // 初始位置由悬浮窗内部计算（固定右下角），这里的 x/y 仅作占位
-  HWND hWnd = BallWindow::Create(hInst, 0, 0, diameter);
+  HWND hWnd = nullptr;
+  {
+    StartupTracer::Span span(trace, "BallWindow::Create"); // 含 WM_CREATE（D2D 初始化、LoadGifs、首帧）
+    hWnd = BallWindow::Create(hInst, 0, 0, diameter);
+  }
   if (!hWnd) return -1;
-  ShowWindow(hWnd, SW_SHOWNOACTIVATE);
-  UpdateWindow(hWnd);
+  {
+    StartupTracer::Span span(trace, "ShowWindow");
+    ShowWindow(hWnd, SW_SHOWNOACTIVATE);
+    UpdateWindow(hWnd);
+  }
+  startup.End();
+  SignalLauncherReady();
+  ExportStartupTraceIfRequested();
 
   MSG msg;
   while (GetMessage(&msg, nullptr, 0, 0)) {
@@ -23,6 +71,7 @@ int APIENTRY wWinMain(HINSTANCE hInst, HINSTANCE, LPWSTR, int) {
     DispatchMessage(&msg);
   }
 
+  ProcessLogger().Close();
   CoUninitialize();
   return 0;
 }
@@ -1,18 +1,57 @@
 #include "ball_wnd.h"
+#include "ipc_send.h"
+#include "core/async_logger.h"
+#include "core/ball_ipc.h"
+#include "core/ball_position.h"
+#include "core/dispatch_profiler.h"
+#include "core/frame_timing.h"
+#include "core/memory_accounting.h"
+#include "core/startup_trace.h"
+#include "core/utf_transcode.h"
 #include <dwmapi.h>
+#include <psapi.h>
 #include <shellscalingapi.h>
+#include <windowsx.h>
 #include <shlobj.h>
 #include <cassert>
 #include <algorithm>
-#include <fstream>
+#include <cstring>
 #include <sstream>
+#include <string_view>
+#include <vector>
 
 #pragma comment(lib, "Dwmapi.lib")
+#pragma comment(lib, "Psapi.lib")
 #pragma comment(lib, "Shcore.lib")
 
 static const wchar_t* kBallClass = L"NativeFloatingBallWindow";
 static const wchar_t* kFlutterMainClass = L"FLUTTER_RUNNER_WIN32_WINDOW";
 
+// 设置项（native_floating_ball_settings.txt）
+// 位置：pos.<显示器拓扑> = "x y"（见 core/ball_position.h）
+static constexpr char kSettingDiameter[] = "diameter";
+static constexpr char kSettingFrameProfile[] = "frame_profile"; // full | balanced | saver
+static constexpr char kSettingMemoryBudgetKb[] = "memory_budget_kb"; // 登记内存总量预算，0 = 不限
+static constexpr char kSettingFrameStatsIntervalS[] = "frame_stats_interval_s"; // 帧耗时汇总写日志的周期，0 = 不写
+static constexpr char kSettingDebugOverlay[] = "debug_overlay"; // 1 = 球面上叠加帧率与 p99
+
+// 显示器拓扑：各显示器矩形与 DPI 的哈希。同一组显示器（例如笔记本接上扩展坞）各自记住一个位置
+static BOOL CALLBACK CollectMonitor(HMONITOR mon, HDC, LPRECT, LPARAM param) {
+  MONITORINFO mi{ sizeof(mi) };
+  if (!GetMonitorInfoW(mon, &mi)) return TRUE;
+  UINT dpiX = 96, dpiY = 96;
+  GetDpiForMonitor(mon, MDT_EFFECTIVE_DPI, &dpiX, &dpiY);
+  auto* out = reinterpret_cast<std::vector<MonitorGeometry>*>(param);
+  out->push_back({ mi.rcMonitor.left, mi.rcMonitor.top, mi.rcMonitor.right, mi.rcMonitor.bottom, (int32_t)dpiX });
+  return TRUE;
+}
+
+static std::string CurrentMonitorTopologyKey() {
+  std::vector<MonitorGeometry> monitors;
+  EnumDisplayMonitors(nullptr, nullptr, CollectMonitor, reinterpret_cast<LPARAM>(&monitors));
+  return MonitorTopologyKey(std::move(monitors));
+}
+
 static std::wstring HrToString(HRESULT hr) {
   std::wstringstream ss;
   ss << L"0x" << std::hex << (unsigned long)hr;
@@ -23,26 +62,6 @@ struct BallCreateParams {
   int diameter{120};
 };
 
-static HWND FindFlutterMainWindow() {
-  struct Ctx {
-    HWND found{nullptr};
-  } ctx;
-  EnumWindows(
-      [](HWND hWnd, LPARAM lp) -> BOOL {
-        auto* c = reinterpret_cast<Ctx*>(lp);
-        wchar_t cls[256]{0};
-        if (GetClassNameW(hWnd, cls, (int)(sizeof(cls) / sizeof(cls[0])))) {
-          if (wcscmp(cls, kFlutterMainClass) == 0) {
-            c->found = hWnd;
-            return FALSE; // stop
-          }
-        }
-        return TRUE; // continue
-      },
-      reinterpret_cast<LPARAM>(&ctx));
-  return ctx.found;
-}
-
 static void ActivateToForeground(HWND hWnd) {
   if (!hWnd || !IsWindow(hWnd)) return;
 
@@ -75,13 +94,89 @@ static void ActivateToForeground(HWND hWnd) {
 
 static void SendRestoreRequest(HWND hWnd) {
   if (!hWnd || !IsWindow(hWnd)) return;
-  // 约定：dwData=3 表示“恢复主窗口”（由 Runner 进程自行 Show/Restore/Foreground）
+  // 约定：dwData=kBallIpcRestoreMain 表示“恢复主窗口”（由 Runner 进程自行 Show/Restore/Foreground）
   const wchar_t* payload = L"restore_main_window";
-  COPYDATASTRUCT cds{};
-  cds.dwData = 3;
-  cds.cbData = (DWORD)((wcslen(payload) + 1) * sizeof(wchar_t));
-  cds.lpData = (PVOID)payload;
-  SendMessageW(hWnd, WM_COPYDATA, 0, (LPARAM)&cds);
+  if (!SendCopyData(hWnd, kBallIpcRestoreMain, payload, (DWORD)((wcslen(payload) + 1) * sizeof(wchar_t)))) {
+    // 主程序忙碌/挂起：改为异步恢复，不阻塞悬浮球
+    ShowWindowAsync(hWnd, SW_SHOW);
+    ShowWindowAsync(hWnd, SW_RESTORE);
+  }
+}
+
+// 大列表快照：发布端写入共享内存后只发一条不带负载的通知，这里无锁读出一份本地副本再应用，
+// 省去 WM_COPYDATA 每次更新的跨进程拷贝。读不到（区域不存在/被持续覆盖）时返回 Rejected，发送端改走 WM_COPYDATA。
+TaskSyncResult BallWindow::OnSnapshotPublished() {
+  if (!m_snapshotRegion.IsOpen()) {
+    const size_t regionSize = SeqlockSnapshot::RegionSize(kTaskSnapshotCapacity);
+    if (!m_snapshotRegion.Open(kTaskSnapshotRegionName, regionSize) ||
+        !m_snapshotReader.Attach(m_snapshotRegion.Data(), regionSize)) {
+      m_snapshotRegion.Close();
+      LogLine(L"task snapshot: shared region unavailable");
+      return TaskSyncResult::Rejected;
+    }
+  }
+  if (m_snapshotReader.Read(&m_snapshotBuf, nullptr) != SeqlockSnapshotReader::Status::Ok) {
+    return TaskSyncResult::Rejected;
+  }
+  m_ipcMemory.Set(m_snapshotRegion.Size() + m_snapshotBuf.capacity());
+  m_eventTrace.Record(TraceEventKind::SnapshotPublished, 0, 0, m_snapshotBuf.data(), m_snapshotBuf.size());
+  EnsureBubble();
+  if (!m_bubble) return TaskSyncResult::Rejected;
+  const TaskSyncResult result = m_bubble->ApplyWire(m_taskSync, m_snapshotBuf.data(), m_snapshotBuf.size());
+  if (result != TaskSyncResult::Rejected) {
+    QueueTasksChanged(result == TaskSyncResult::Applied ? m_bubble->LastDiff() : TaskListDiff{}, (int)m_bubble->TaskCount());
+  }
+  return result;
+}
+
+// 模型在 WM_COPYDATA 里同步更新（发送端需要即时的应用结果），重排/重绘则推迟到投递的
+// kMsgTasksChanged：发送端的 SendMessage 优先于投递消息处理，一帧内到达的多次更新
+// 因此只触发一次 GIF 切换与一次气泡刷新，发送端也不必等待渲染完成。
+void BallWindow::QueueTasksChanged(const TaskListDiff& diff, int unreadCount) {
+  if (!m_state.QueueTasksChanged(diff, unreadCount)) return;
+  if (!PostMessage(m_hWnd, kMsgTasksChanged, 0, 0)) FlushTasksChanged(); // 队列已满时退回同步处理
+}
+
+void BallWindow::FlushTasksChanged() {
+  m_eventTrace.Record(TraceEventKind::TasksFlush);
+  ApplyEffects(m_state.FlushTasksChanged());
+  CheckMemoryBudget();
+}
+
+GifPlayer* BallWindow::ActiveGif() {
+  return m_state.ActiveGif() == BallGif::Dynamic ? &m_gifDynamic : &m_gifUnread;
+}
+
+// 与 Render 选帧的规则一致：当前 GIF 没有帧时画的是纯色圆
+const HitMask& BallWindow::ActiveHitMask() {
+  const GifPlayer* gif = ActiveGif();
+  return gif->FrameCount() > 0 ? gif->Hit() : m_fallbackHit;
+}
+
+// 把 BallState 返回的副作用落实为定时器、重绘与气泡操作
+void BallWindow::ApplyEffects(uint32_t effects) {
+  // 帧定时器驱动的一帧：预定间隔是刚到期的那次定时
+  const UINT budgetMs = (effects & kBallEffectRestartFrameTimer) ? m_frameTimerDelayMs : 0;
+  if (effects & kBallEffectRestartFrameTimer) {
+    KillTimer(m_hWnd, m_timerId);
+    m_frameTimerDelayMs = 0;
+    if (m_state.FrameCount() > 0) {
+      m_frameTimerDelayMs = m_state.FrameDelayMs(m_state.FrameIndex());
+      SetTimer(m_hWnd, m_timerId, m_frameTimerDelayMs, nullptr);
+    }
+  }
+  if (effects & kBallEffectRender) Render(budgetMs);
+  if (effects & kBallEffectShowBubble) ShowBubble();
+  if ((effects & kBallEffectRefreshBubble) && m_bubble && m_bubble->IsVisible()) {
+    RECT wr{}; GetWindowRect(m_hWnd, &wr);
+    m_bubble->Refresh(wr.right + 8, wr.top, BubbleWindow::kWidth, m_bubble->PreferredHeight());
+  }
+  if (effects & kBallEffectStopHideTimer) KillTimer(m_hWnd, m_hideTimerId);
+  if (effects & kBallEffectStartHideTimer) SetTimer(m_hWnd, m_hideTimerId, BallState::kHideDelayMs, nullptr);
+  if (effects & kBallEffectHideBubble) {
+    KillTimer(m_hWnd, m_hideTimerId);
+    HideBubble();
+  }
 }
 
 ATOM BallWindow::Register(HINSTANCE hInst) {
@@ -105,8 +200,11 @@ HWND BallWindow::Create(HINSTANCE hInst, int x, int y, int diameter) {
   return hWnd;
 }
 
-BallWindow::BallWindow(HINSTANCE hInst) : m_hInst(hInst) {}
+BallWindow::BallWindow(HINSTANCE hInst) : m_hInst(hInst), m_mainPeer(kFlutterMainClass, kPeerRoleMain) {}
 BallWindow::~BallWindow() {
+  if (m_overlayFormat) m_overlayFormat->Release();
+  if (m_pDW) m_pDW->Release();
+  if (m_frameBitmap) m_frameBitmap->Release();
   if (m_pRT) m_pRT->Release();
   if (m_pD2DFactory) m_pD2DFactory->Release();
   if (m_pWIC) m_pWIC->Release();
@@ -134,91 +232,151 @@ LRESULT CALLBACK BallWindow::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
     SetWindowLongPtr(hWnd, GWLP_USERDATA, 0);
     return res;
   }
+  DispatchProfiler::Scope scope(ProcessDispatchProfiler(), msg); // 按消息类型统计处理耗时
   return self->HandleMessage(hWnd, msg, wParam, lParam);
 }
 
 LRESULT BallWindow::HandleMessage(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+  if (m_snapshotMsg && msg == m_snapshotMsg) return (LRESULT)OnSnapshotPublished();
+  if (m_peerHelloMsg && msg == m_peerHelloMsg) { m_mainPeer.OnHello(wParam, lParam); return 0; }
+  if (m_dumpProfileMsg && msg == m_dumpProfileMsg) {
+    ProcessLogger().Log(LogLevel::Info, "dispatch profile:\n" + ProcessDispatchProfiler().Format()); // 超过槽位长度，走旁路队列
+    ProcessLogger().Log(LogLevel::Info, ProcessFrameTimings().Format(FrameTimings::NowNs()));
+    return 0;
+  }
+  if (m_memoryReportMsg && msg == m_memoryReportMsg) {
+    ReportMemory(reinterpret_cast<HWND>(wParam));
+    return 1;
+  }
   switch (msg) {
   case WM_CREATE: {
+    OpenLog();
+    OpenSettings();
+    // 共享内存快照的“版本已更新”通知（注册消息，进程间取值一致）
+    m_snapshotMsg = RegisterWindowMessageW(kTaskSnapshotMessageName);
+    // 向主程序报到一次；之后双击/打开任务都直接使用缓存的主窗口句柄
+    m_peerHelloMsg = m_mainPeer.Attach(hWnd, kPeerRoleBall);
+    m_dumpProfileMsg = RegisterWindowMessageW(kDispatchDumpMessageName);
+    m_memoryReportMsg = RegisterWindowMessageW(kMemoryReportMessageName);
+    OpenEventTrace();
     // Layered per-pixel alpha, click-through disabled (we need interactivity)
+    StartupTracer& trace = ProcessStartupTracer();
+    StartupTracer::Span create(trace, "WM_CREATE");
     PositionInitial();
     EnsureBorderlessStyle();
-    InitializeD2D();
+    {
+      StartupTracer::Span span(trace, "InitializeD2D");
+      InitializeD2D();
+    }
     // Load GIFs (with fallbacks)
-    LoadGifs();
-    SelectGifByUnread();
-    m_frameIndex = 0;
-    if (m_activeGif && m_activeGif->FrameCount() > 0) {
-      SetTimer(hWnd, m_timerId, m_activeGif->GetDelayMs(0), nullptr);
+    {
+      StartupTracer::Span span(trace, "LoadGifs");
+      LoadGifs();
+    }
+    CheckMemoryBudget();
+    m_state.SetFrameDelays(BallGif::Unread, m_gifUnread.DelaysMs());
+    m_state.SetFrameDelays(BallGif::Dynamic, m_gifDynamic.DelaysMs());
+    {
+      StartupTracer::Span span(trace, "first Render");
+      ApplyEffects(m_state.Start());
     }
-    Render();
     return 0;
   }
   case WM_MOUSEMOVE: {
+    m_eventTrace.Record(TraceEventKind::MouseMove, (uint32_t)GET_X_LPARAM(lParam), (uint32_t)GET_Y_LPARAM(lParam));
     TRACKMOUSEEVENT tme{ sizeof(TRACKMOUSEEVENT), TME_LEAVE, m_hWnd, 0 };
     TrackMouseEvent(&tme);
-    ShowBubble();
+    ApplyEffects(m_state.OnMouseMove(m_bubble && m_bubble->IsShowing()));
     return 0;
   }
   case WM_MOUSELEAVE:
-    HideBubble(); return 0;
+    // 不立即隐藏：给鼠标留出移入气泡（滚动/点击）的时间，由 m_hideTimerId 轮询决定
+    m_eventTrace.Record(TraceEventKind::MouseLeave);
+    ApplyEffects(m_state.OnMouseLeave());
+    return 0;
   case WM_LBUTTONDBLCLK:
     OpenMainApp(); return 0;
   case WM_NCLBUTTONDBLCLK:
     // 当前窗口在 WM_NCHITTEST 中返回 HTCAPTION，双击会走非客户区消息
     OpenMainApp(); return 0;
   case WM_COPYDATA: {
-    // Accept UPDATE_TASKS from external sender: dwData=1, payload = L"<id> <title>\n..."
     auto cds = reinterpret_cast<COPYDATASTRUCT*>(lParam);
-    if (cds && cds->dwData == 1 && cds->lpData && cds->cbData >= sizeof(wchar_t)) {
-      std::wstring payload(reinterpret_cast<const wchar_t*>(cds->lpData), cds->cbData / sizeof(wchar_t));
-      // Normalize CRLF
-      for (auto& ch : payload) if (ch == L'\r') ch = L'\n';
-      std::vector<std::wstring> items;
-      size_t start = 0;
-      while (start < payload.size()) {
-        size_t pos = payload.find(L'\n', start);
-        std::wstring line = payload.substr(start, (pos == std::wstring::npos ? payload.size() : pos) - start);
-        if (!line.empty()) items.push_back(line);
-        if (pos == std::wstring::npos) break; else start = pos + 1;
-      }
+    if (!cds || !cds->lpData) return 0;
+    m_eventTrace.Record(TraceEventKind::CopyData, (uint32_t)cds->dwData, 0, cds->lpData, cds->cbData);
+    if (cds->dwData == kTaskWireCopyDataId) {
+      // 二进制 UPDATE_TASKS（快照或带序号的增量）：视图直接指向 lpData，不逐行分配。
+      // 返回 TaskSyncResult：1 已应用；2 序号缺口，请发送端重发快照；0 无法解析，发送端回退到文本格式
       EnsureBubble();
-      // Unread count = items count
-      m_unreadCount = (int)items.size();
-      SelectGifByUnread();
-      m_frameIndex = 0;
-      if (m_activeGif && m_activeGif->FrameCount() > 0) {
-        KillTimer(m_hWnd, m_timerId);
-        SetTimer(m_hWnd, m_timerId, m_activeGif->GetDelayMs(0), nullptr);
+      if (!m_bubble) return 0;
+      const TaskSyncResult result = m_bubble->ApplyWire(m_taskSync, cds->lpData, cds->cbData);
+      if (result == TaskSyncResult::Rejected) {
+        LogLine(L"WM_COPYDATA: malformed task wire payload");
+      } else {
+        // 等待重发快照期间也按模型当前行数刷新角标，不让未读数停留在旧值
+        QueueTasksChanged(result == TaskSyncResult::Applied ? m_bubble->LastDiff() : TaskListDiff{}, (int)m_bubble->TaskCount());
       }
+      return (LRESULT)result;
+    }
+    // 旧格式 UPDATE_TASKS：dwData=1，payload = L"<id> <title>\n..."
+    if (cds->dwData == 1 && cds->cbData >= sizeof(wchar_t)) {
+      const std::vector<TaskItemView>& items = m_textParser.Parse(
+          std::u16string_view(reinterpret_cast<const char16_t*>(cds->lpData), cds->cbData / sizeof(char16_t)));
+      EnsureBubble();
+      // 整表被旧格式替换后，二进制增量的基线随之失效
+      m_taskSync.Invalidate();
       if (m_bubble) {
-        m_bubble->SetItems(items);
-        // If visible, re-show to refresh content/size
-        if (m_bubble->IsVisible()) {
-          RECT wr{}; GetWindowRect(m_hWnd, &wr);
-          m_bubble->ShowNoActivate(wr.right + 8, wr.top, 280, 28 * (int)items.size() + 20);
-        }
+        QueueTasksChanged(m_bubble->SetItems(items), (int)m_bubble->TaskCount());
+      } else {
+        QueueTasksChanged(TaskListDiff{}, (int)items.size());
       }
-      return 0;
+      return 1;
     }
     return 0;
   }
-  case WM_DPICHANGED:
-    OnDpiChanged(hWnd, wParam, lParam); return 0;
+  case kMsgTasksChanged:
+    FlushTasksChanged();
+    return 0;
+  case WM_DPICHANGED: {
+    const RECT* suggested = reinterpret_cast<const RECT*>(lParam);
+    m_eventTrace.Record(TraceEventKind::DpiChanged, HIWORD(wParam), (uint32_t)(suggested->right - suggested->left));
+    OnDpiChanged(hWnd, wParam, lParam);
+    return 0;
+  }
   case WM_DISPLAYCHANGE:
   case WM_SETTINGCHANGE:
-    // 分辨率/缩放/任务栏位置变化后，重新贴右下角
-    PositionBottomRight();
+    m_eventTrace.Record(TraceEventKind::DisplayChange);
+    // 分辨率/缩放/任务栏位置变化后：回到这组显示器上次的位置，没有则贴右下角
+    m_topologyKey = CurrentMonitorTopologyKey();
+    PositionInitial();
     EnsureBorderlessStyle();
     return 0;
+  case WM_ENDSESSION:
+    // 注销/关机时进程随后被结束：写出去抖中的设置与日志
+    if (wParam) {
+      m_settings.Flush();
+      m_eventTrace.Flush();
+      ProcessLogger().Flush();
+    }
+    return 0;
+  case WM_DESTROY:
+    // 窗口被关闭（Alt+F4、WM_CLOSE）后结束消息循环：进程以退出码 0 退出，监管端视为主动关闭、不再重启；
+    // 否则进程会没有窗口地一直挂着，主程序再也找不到它
+    m_settings.Flush();
+    m_eventTrace.Flush();
+    PostQuitMessage(0);
+    return 0;
   case WM_EXITSIZEMOVE:
     // 用户拖拽结束后保存位置，下次启动自动回放
     SaveCurrentPosition();
     return 0;
   case WM_NCHITTEST: {
-    // 必须返回 HTCLIENT，否则鼠标事件会走非客户区消息（WM_NC*），导致 WM_MOUSEMOVE 等不触发，
+    // 可见像素必须返回 HTCLIENT，否则鼠标事件会走非客户区消息（WM_NC*），导致 WM_MOUSEMOVE 等不触发，
     // 表现为“悬停/点击没反应”。拖拽在 WM_LBUTTONDOWN 中手动触发。
-    return HTCLIENT;
+    // 透明角落与几乎透明的抗锯齿边缘返回 HTTRANSPARENT：不产生 WM_MOUSEMOVE（也就不会展开气泡），
+    // 交给下面的窗口。alpha 为 0 的像素分层窗口本身就会穿透到其他进程的窗口。
+    POINT pt{ GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam) };
+    ScreenToClient(hWnd, &pt);
+    return ActiveHitMask().Contains(pt.x, pt.y) ? HTCLIENT : HTTRANSPARENT;
   }
   case WM_LBUTTONDOWN: {
     // 手动进入系统拖拽（保持 HTCLIENT 的同时支持拖动窗口）
@@ -227,11 +385,15 @@ LRESULT BallWindow::HandleMessage(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPa
     return 0;
   }
   case WM_TIMER:
-    if (wParam == m_timerId && m_activeGif && m_activeGif->FrameCount() > 0) {
-      m_frameIndex = (m_frameIndex + 1) % m_activeGif->FrameCount();
-      KillTimer(hWnd, m_timerId);
-      SetTimer(hWnd, m_timerId, m_activeGif->GetDelayMs(m_frameIndex), nullptr);
-      Render();
+    if (wParam == m_hideTimerId) {
+      const bool inside = IsCursorOverBallOrBubble();
+      m_eventTrace.Record(TraceEventKind::HideTimer, inside ? 1u : 0u);
+      ApplyEffects(m_state.OnHideTimer(inside));
+      return 0;
+    }
+    if (wParam == m_timerId) {
+      m_eventTrace.Record(TraceEventKind::FrameTimer);
+      ApplyEffects(m_state.OnFrameTimer());
     }
     return 0;
   case WM_PAINT:
@@ -240,40 +402,64 @@ LRESULT BallWindow::HandleMessage(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPa
   return DefWindowProc(hWnd, msg, wParam, lParam);
 }
 
-std::wstring BallWindow::GetSettingsPath() const {
+// %APPDATA%\chat_desktop：首次调用时解析并创建，之后直接用缓存（拖拽保存、写日志都不再查询 Shell）
+const std::wstring& BallWindow::GetSettingsDir() const {
+  if (m_settingsDirResolved) return m_settingsDir;
+  m_settingsDirResolved = true;
   PWSTR appData = nullptr;
-  std::wstring path;
   if (SUCCEEDED(SHGetKnownFolderPath(FOLDERID_RoamingAppData, 0, nullptr, &appData)) && appData) {
-    path = appData;
-    CoTaskMemFree(appData);
-    path += L"\\chat_desktop";
-    CreateDirectoryW(path.c_str(), nullptr);
-    path += L"\\native_floating_ball_pos.txt";
+    m_settingsDir = appData;
+    m_settingsDir += L"\\chat_desktop";
+    CreateDirectoryW(m_settingsDir.c_str(), nullptr);
   }
-  return path;
+  CoTaskMemFree(appData);
+  return m_settingsDir;
+}
+
+std::wstring BallWindow::GetSettingsPath() const {
+  const std::wstring& dir = GetSettingsDir();
+  return dir.empty() ? std::wstring() : dir + L"\\native_floating_ball_settings.txt";
 }
 
 std::wstring BallWindow::GetLogPath() const {
-  std::wstring path = GetSettingsPath();
-  if (path.empty()) return path;
-  const std::wstring suffix = L"native_floating_ball_pos.txt";
-  if (path.size() >= suffix.size() &&
-      path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0) {
-    path.resize(path.size() - suffix.size());
-    path += L"native_floating_ball.log";
-    return path;
-  }
-  path += L".log";
-  return path;
+  const std::wstring& dir = GetSettingsDir();
+  return dir.empty() ? std::wstring() : dir + L"\\native_floating_ball.log";
 }
 
-void BallWindow::LogLine(const std::wstring& line) const {
+// 日志由 ProcessLogger 的后台线程写入；wWinMain 在消息循环结束后 Close，写完剩余记录
+void BallWindow::OpenLog() {
+  AsyncLogger& logger = ProcessLogger();
+  if (logger.IsOpen()) return;
   const std::wstring path = GetLogPath();
   if (path.empty()) return;
+  AsyncLogger::Options options;
+  Utf16ToUtf8(std::u16string_view(reinterpret_cast<const char16_t*>(path.data()), path.size()), &options.path);
+  logger.Open(options);
+}
 
-  std::wofstream out(path, std::ios::app);
-  if (!out.is_open()) return;
-  out << line << L"\n";
+// 与启动时间线（CHAT_DESKTOP_STARTUP_TRACE）相同的开关方式：环境变量指向目录时录制本次运行的事件轨迹
+void BallWindow::OpenEventTrace() {
+  wchar_t dir[MAX_PATH];
+  const DWORD len = GetEnvironmentVariableW(L"CHAT_DESKTOP_EVENT_TRACE", dir, MAX_PATH);
+  if (len == 0 || len >= MAX_PATH) return;
+  std::wstring path(dir, len);
+  if (path.back() != L'\\' && path.back() != L'/') path += L'\\';
+  path += L"native_floating_ball_events_" + std::to_wstring(GetCurrentProcessId()) + L".nfbt";
+  std::string utf8;
+  Utf16ToUtf8(std::u16string_view(reinterpret_cast<const char16_t*>(path.data()), path.size()), &utf8);
+  if (m_eventTrace.Open(utf8)) {
+    LogLine(L"event trace: recording to " + path);
+  } else {
+    LogLine(L"event trace: cannot open " + path, LogLevel::Warn);
+  }
+}
+
+void BallWindow::LogLine(const std::wstring& line, LogLevel level) const {
+  AsyncLogger& logger = ProcessLogger();
+  if (!logger.Enabled(level)) return;
+  std::string utf8;
+  Utf16ToUtf8(std::u16string_view(reinterpret_cast<const char16_t*>(line.data()), line.size()), &utf8);
+  logger.Log(level, utf8);
 }
 
 void BallWindow::LogHr(const wchar_t* where, HRESULT hr) const {
@@ -282,7 +468,7 @@ void BallWindow::LogHr(const wchar_t* where, HRESULT hr) const {
   line += where;
   line += L" hr=";
   line += HrToString(hr);
-  LogLine(line);
+  LogLine(line, LogLevel::Error);
 }
 
 void BallWindow::LogLastError(const wchar_t* where) const {
@@ -290,7 +476,31 @@ void BallWindow::LogLastError(const wchar_t* where) const {
   const DWORD err = GetLastError();
   std::wstringstream ss;
   ss << L"[native_floating_ball] " << where << L" GetLastError=" << err;
-  LogLine(ss.str());
+  LogLine(ss.str(), LogLevel::Error);
+}
+
+// 文本报告写入日志；replyTo 非空时另把 JSON 报告以 WM_COPYDATA 发回（主程序的 dumpMemoryReport）
+void BallWindow::ReportMemory(HWND replyTo) {
+  PROCESS_MEMORY_COUNTERS_EX pmc{};
+  pmc.cb = sizeof(pmc);
+  uint64_t privateBytes = 0;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc), sizeof(pmc))) {
+    privateBytes = pmc.PrivateUsage;
+  }
+  const MemoryAccounting& accounting = ProcessMemoryAccounting();
+  ProcessLogger().Log(LogLevel::Info, "memory report:\n" + accounting.Format(privateBytes));
+  if (!replyTo || !IsWindow(replyTo)) return;
+  const std::string json = accounting.ToJson(privateBytes);
+  if (!SendCopyData(replyTo, kBallIpcMemoryReport, json.data(), (DWORD)json.size())) {
+    LogLine(L"memory report: reply not delivered", LogLevel::Warn);
+  }
+}
+
+// 登记总量越过 memory_budget_kb 时记一次警告并附上报告（回落后再次越过会再记）
+void BallWindow::CheckMemoryBudget() {
+  MemoryAccounting& accounting = ProcessMemoryAccounting();
+  if (!accounting.TakeBudgetExceeded()) return;
+  ProcessLogger().Log(LogLevel::Warn, "memory budget exceeded:\n" + accounting.Format());
 }
 
 void BallWindow::EnsureBorderlessStyle() {
@@ -312,16 +522,44 @@ void BallWindow::EnsureBorderlessStyle() {
       SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE | SWP_FRAMECHANGED);
 }
 
-bool BallWindow::LoadSavedPosition(POINT* ptOut) {
-  if (!ptOut) return false;
+// 设置在 WM_CREATE 时读入一次；之后的读取只查内存，保存由 SettingsStore 去抖后原子写盘
+void BallWindow::OpenSettings() {
+  m_topologyKey = CurrentMonitorTopologyKey();
   const std::wstring path = GetSettingsPath();
-  if (path.empty()) return false;
+  if (path.empty()) return;
+  SettingsStore::Options options;
+  Utf16ToUtf8(std::u16string_view(reinterpret_cast<const char16_t*>(path.data()), path.size()), &options.path);
+  if (!m_settings.Open(options)) LogLine(L"settings: existing file could not be read", LogLevel::Warn);
+  ImportLegacyPosition();
+
+  m_diameter = (int)std::clamp<int64_t>(m_settings.GetInt(kSettingDiameter, m_diameter), 48, 512);
+  std::string profile;
+  m_settings.Get(kSettingFrameProfile, &profile);
+  // 帧间隔下限：balanced 约 30fps，saver 约 10fps；full 按 GIF 自身的帧延迟
+  m_state.SetMinFrameDelayMs(profile == "saver" ? 100u : profile == "balanced" ? 33u : 0u);
+  const int64_t budgetKb = m_settings.GetInt(kSettingMemoryBudgetKb, 0);
+  ProcessMemoryAccounting().SetBudget(budgetKb > 0 ? (uint64_t)budgetKb * 1024 : 0);
+  const int64_t statsS = m_settings.GetInt(kSettingFrameStatsIntervalS, 300);
+  FrameTimings& timings = ProcessFrameTimings();
+  timings.SetSummaryInterval(statsS > 0 ? (uint64_t)statsS * 1000000000ull : 0);
+  timings.Reset(FrameTimings::NowNs());
+  m_debugOverlay = m_settings.GetInt(kSettingDebugOverlay, 0) != 0;
+}
 
-  std::wifstream in(path);
-  if (!in.is_open()) return false;
+// 旧版本把位置单独存在 native_floating_ball_pos.txt（"x y"）：升级后第一次启动时导入到当前显示器拓扑
+void BallWindow::ImportLegacyPosition() {
+  const std::wstring& dir = GetSettingsDir();
+  if (dir.empty()) return;
+  const std::wstring legacyPath = dir + L"\\native_floating_ball_pos.txt";
+  std::string legacyPathUtf8;
+  Utf16ToUtf8(std::u16string_view(reinterpret_cast<const char16_t*>(legacyPath.data()), legacyPath.size()), &legacyPathUtf8);
+  ImportLegacyBallPosition(m_settings, m_topologyKey, legacyPathUtf8);
+}
+
+bool BallWindow::LoadSavedPosition(POINT* ptOut) {
+  if (!ptOut) return false;
   long x = 0, y = 0;
-  in >> x >> y;
-  if (!in.good()) return false;
+  if (!LoadBallPosition(m_settings, m_topologyKey, &x, &y)) return false;
   ptOut->x = (LONG)x;
   ptOut->y = (LONG)y;
   return true;
@@ -329,14 +567,9 @@ bool BallWindow::LoadSavedPosition(POINT* ptOut) {
 
 void BallWindow::SaveCurrentPosition() {
   if (!m_hWnd) return;
-  const std::wstring path = GetSettingsPath();
-  if (path.empty()) return;
-
   RECT wr{};
   if (!GetWindowRect(m_hWnd, &wr)) return;
-  std::wofstream out(path, std::ios::trunc);
-  if (!out.is_open()) return;
-  out << wr.left << L" " << wr.top;
+  SaveBallPosition(m_settings, m_topologyKey, wr.left, wr.top);
 }
 
 void BallWindow::ClampToWorkArea(POINT* ptInOut) {
@@ -397,7 +630,6 @@ bool BallWindow::InitializeD2D() {
       return false;
     }
   }
-
   // Create memory DC + DIB
   if (!m_hMemDC) {
     HDC hdcScreen = GetDC(nullptr);
@@ -419,16 +651,22 @@ bool BallWindow::InitializeD2D() {
       return false;
     }
     SelectObject(m_hMemDC, m_hDIB);
+    m_dibMemory.Set((size_t)m_diameter * m_diameter * 4);
   }
 
   // 为了在部分核显/企业版系统上更稳定，默认使用 SOFTWARE 渲染（悬浮球很小，性能足够）。
+  // 帧直接拷进 DIB，渲染目标只在调试叠加层第一次绘制时创建
   m_rtType = D2D1_RENDER_TARGET_TYPE_SOFTWARE;
-  return CreateRenderTarget(m_rtType);
+  return true;
 }
 
 bool BallWindow::CreateRenderTarget(D2D1_RENDER_TARGET_TYPE type) {
   if (!m_pD2DFactory || !m_hMemDC) return false;
 
+  if (m_frameBitmap) {
+    m_frameBitmap->Release();
+    m_frameBitmap = nullptr;
+  }
   if (m_pRT) {
     m_pRT->Release();
     m_pRT = nullptr;
@@ -448,64 +686,100 @@ bool BallWindow::CreateRenderTarget(D2D1_RENDER_TARGET_TYPE type) {
   return true;
 }
 
-void BallWindow::Render() {
-  if (!m_pRT) {
-    if (!CreateRenderTarget(m_rtType)) return;
-  }
-  RECT rc{ 0,0,m_diameter,m_diameter };
-  m_pRT->BindDC(m_hMemDC, &rc);
-  m_pRT->BeginDraw();
-  m_pRT->Clear(D2D1::ColorF(0, 0.f)); // fully transparent
-
-  // Circular clip layer
-  const float r = (m_diameter - 2.f) / 2.f;
-  const D2D1_ELLIPSE e = D2D1::Ellipse(D2D1::Point2F((float)m_diameter / 2, (float)m_diameter / 2), r, r);
-  ID2D1EllipseGeometry* geo = nullptr;
-  m_pD2DFactory->CreateEllipseGeometry(e, &geo);
-  ID2D1Layer* layer = nullptr;
-  m_pRT->CreateLayer(nullptr, &layer);
-  m_pRT->PushLayer(D2D1::LayerParameters(D2D1::InfiniteRect(), geo), layer);
-
-  if (m_activeGif && m_activeGif->FrameCount() > 0) {
-    IWICFormatConverter* conv = nullptr;
-    if (m_activeGif->CreateConvertedFrame(m_pWIC, m_frameIndex, &conv)) {
-      ID2D1Bitmap* bmp = nullptr;
-      if (SUCCEEDED(m_pRT->CreateBitmapFromWicBitmap(conv, nullptr, &bmp))) {
-        const float tw = (float)m_diameter;
-        const float th = (float)m_diameter;
-        const float gw = (float)m_activeGif->Width();
-        const float gh = (float)m_activeGif->Height();
-        // Cover fit: scale to cover circle
-        float scale = (std::max)(tw / gw, th / gh);
-        float dw = gw * scale;
-        float dh = gh * scale;
-        D2D1_RECT_F dst = D2D1::RectF((tw - dw) / 2.f, (th - dh) / 2.f, (tw - dw) / 2.f + dw, (th - dh) / 2.f + dh);
-        m_pRT->DrawBitmap(bmp, dst, 1.f, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR);
-        bmp->Release();
-      }
-      conv->Release();
-    }
+// 当前帧已是乘过圆形蒙版的显示尺寸帧：直接拷进 DIB，不需要椭圆几何、图层或裁剪
+void BallWindow::Render(UINT budgetMs) {
+  if (!m_pBits) return;
+  const uint64_t t0 = FrameTimings::NowNs();
+  GifPlayer* gif = ActiveGif();
+  if (gif->FrameCount() == 0 && m_fallbackFrame.empty()) return; // LoadGifs 之前
+  const uint8_t* frame = gif->FrameCount() > 0 ? gif->DisplayFrame(m_state.FrameIndex()) : m_fallbackFrame.data();
+  const uint64_t t1 = FrameTimings::NowNs();
+  uint64_t t2 = t1;
+  if (m_debugOverlay) {
+    if (!DrawFrameWithOverlay(frame)) return;
+    t2 = FrameTimings::NowNs();
   } else {
-    // Fallback solid circle
-    ID2D1SolidColorBrush* brush = nullptr;
-    m_pRT->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::RoyalBlue, 1.f), &brush);
-    m_pRT->FillEllipse(e, brush);
-    brush->Release();
+    GdiFlush(); // DIB 可能还有未完成的 GDI 操作
+    std::memcpy(m_pBits, frame, (size_t)m_diameter * m_diameter * 4);
   }
+  const uint64_t t3 = FrameTimings::NowNs();
+  PresentLayered();
+  const uint64_t t4 = FrameTimings::NowNs();
+
+  // 叠加层路径下 draw 为 BeginDraw 到 EndDraw 之前，end_draw 含回写 DIB；直拷路径下 end_draw 记 0
+  FrameTimings& timings = ProcessFrameTimings();
+  timings.Record(FrameStage::BallSelect, t1 - t0);
+  timings.Record(FrameStage::BallDraw, m_debugOverlay ? t2 - t1 : t3 - t1);
+  timings.Record(FrameStage::BallEndDraw, m_debugOverlay ? t3 - t2 : 0);
+  timings.Record(FrameStage::BallPresent, t4 - t3);
+  timings.FramePresented(FrameSurface::Ball, t4, t4 - t0, (uint64_t)budgetMs * 1000000);
+  if (timings.SummaryDue(t4)) ReportFrameTimings(t4);
+}
 
-  m_pRT->PopLayer();
-  layer->Release();
-  geo->Release();
-
+// 调试叠加层：帧经一张复用的 D2D 位图贴到 DC 渲染目标上，再画叠加文字
+bool BallWindow::DrawFrameWithOverlay(const uint8_t* frame) {
+  if (!m_pRT && !CreateRenderTarget(m_rtType)) return false;
+  const UINT32 pitch = (UINT32)m_diameter * 4;
+  if (!m_frameBitmap) {
+    const D2D1_BITMAP_PROPERTIES bp = D2D1::BitmapProperties(
+        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED));
+    m_pRT->CreateBitmap(D2D1::SizeU(m_diameter, m_diameter), frame, pitch, bp, &m_frameBitmap);
+    if (!m_frameBitmap) return false;
+  } else {
+    m_frameBitmap->CopyFromMemory(nullptr, frame, pitch);
+  }
+  const RECT rc{ 0,0,m_diameter,m_diameter };
+  m_pRT->BindDC(m_hMemDC, &rc);
+  m_pRT->BeginDraw();
+  m_pRT->Clear(D2D1::ColorF(0, 0.f));
+  m_pRT->DrawBitmap(m_frameBitmap, D2D1::RectF(0.f, 0.f, (float)m_diameter, (float)m_diameter), 1.f,
+                    D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
+  DrawDebugOverlay();
   const HRESULT hr = m_pRT->EndDraw();
   if (FAILED(hr)) {
     LogHr(L"EndDraw", hr);
     if (hr == D2DERR_RECREATE_TARGET) {
       CreateRenderTarget(m_rtType);
     }
-    return;
+    return false;
   }
-  PresentLayered();
+  return true;
+}
+
+// 球面中下部：半透明底 + 一行等宽小字（最近一秒的帧率与本周期帧耗时的 p99）；只在球重绘时更新
+void BallWindow::DrawDebugOverlay() {
+  if (!m_pDW) {
+    DWriteCreateFactory(DWRITE_FACTORY_TYPE_SHARED, __uuidof(IDWriteFactory), reinterpret_cast<IUnknown**>(&m_pDW));
+    if (!m_pDW) return;
+  }
+  if (!m_overlayFormat) {
+    m_pDW->CreateTextFormat(L"Consolas", nullptr, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL,
+                            DWRITE_FONT_STRETCH_NORMAL, 10.f, L"en-us", &m_overlayFormat);
+    if (!m_overlayFormat) return;
+    m_overlayFormat->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER);
+    m_overlayFormat->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_CENTER);
+    m_overlayFormat->SetWordWrapping(DWRITE_WORD_WRAPPING_NO_WRAP);
+  }
+  const std::string text = ProcessFrameTimings().OverlayText(FrameSurface::Ball);
+  const std::wstring wide(text.begin(), text.end()); // ASCII
+  const float d = (float)m_diameter;
+  const D2D1_RECT_F box = D2D1::RectF(d * 0.12f, d * 0.64f, d * 0.88f, d * 0.64f + 14.f);
+  ID2D1SolidColorBrush* back = nullptr;
+  ID2D1SolidColorBrush* fore = nullptr;
+  m_pRT->CreateSolidColorBrush(D2D1::ColorF(0.f, 0.f, 0.f, 0.6f), &back);
+  m_pRT->CreateSolidColorBrush(D2D1::ColorF(1.f, 1.f, 1.f, 1.f), &fore);
+  if (back && fore) {
+    m_pRT->FillRoundedRectangle(D2D1::RoundedRect(box, 3.f, 3.f), back);
+    m_pRT->DrawText(wide.c_str(), (UINT32)wide.size(), m_overlayFormat, box, fore);
+  }
+  if (back) back->Release();
+  if (fore) fore->Release();
+}
+
+void BallWindow::ReportFrameTimings(uint64_t nowNs) {
+  FrameTimings& timings = ProcessFrameTimings();
+  ProcessLogger().Log(LogLevel::Info, timings.Format(nowNs)); // 多行，走旁路队列
+  timings.Reset(nowNs);
 }
 
 void BallWindow::PresentLayered() {
@@ -534,6 +808,11 @@ void BallWindow::OnDpiChanged(HWND hWnd, WPARAM wParam, LPARAM lParam) {
 }
 
 void BallWindow::LoadGifs() {
+  // 蒙版与帧都按当前直径构建；找不到 GIF 时用同一个蒙版画纯色圆
+  m_mask.Build((uint32_t)m_diameter);
+  m_fallbackFrame.resize((size_t)m_diameter * m_diameter * 4);
+  m_mask.Fill(0xFF4169E1u, m_fallbackFrame.data(), (size_t)m_diameter * 4); // RoyalBlue
+  m_fallbackHit.Build(m_mask.Row(0), (uint32_t)m_diameter, (uint32_t)m_diameter, (size_t)m_diameter, 1);
   // Primary: exe directory
   wchar_t exePath[MAX_PATH]; GetModuleFileName(nullptr, exePath, MAX_PATH);
   wchar_t* slash = wcsrchr(exePath, L'\\'); if (slash) *(slash) = 0; // dirname
@@ -541,8 +820,8 @@ void BallWindow::LoadGifs() {
   auto tryLoad = [&](const std::wstring& baseDir) -> bool {
     std::wstring unread = baseDir + L"\\unread_logo.gif";
     std::wstring dyn    = baseDir + L"\\dynamic_logo.gif";
-    bool okU = m_gifUnread.Load(m_pWIC, unread);
-    bool okD = m_gifDynamic.Load(m_pWIC, dyn);
+    bool okU = m_gifUnread.Load(m_pWIC, unread, m_mask);
+    bool okD = m_gifDynamic.Load(m_pWIC, dyn, m_mask);
     return okU && okD;
   };
 
@@ -562,18 +841,28 @@ void BallWindow::LoadGifs() {
   // If still not found, leave players empty; Render() draws a fallback circle.
 }
 
-void BallWindow::SelectGifByUnread() {
-  m_activeGif = (m_unreadCount > 0) ? &m_gifDynamic : &m_gifUnread;
-}
-
 void BallWindow::OpenMainApp() {
-  // 有些情况下 FindWindow 会找不到（多窗口/不同线程创建），这里改为枚举顶层窗口更稳。
-  HWND hwndMain = FindFlutterMainWindow();
+  LARGE_INTEGER freq{}, t0{}, t1{}, t2{};
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&t0);
+  bool cached = false;
+  HWND hwndMain = m_mainPeer.Resolve(&cached);
   if (!hwndMain) return;
+  QueryPerformanceCounter(&t1);
 
   // 先让主程序自己从托盘隐藏状态恢复（跨进程前台激活限制更少）
   SendRestoreRequest(hwndMain);
   ActivateToForeground(hwndMain);
+  QueryPerformanceCounter(&t2);
+
+  // 双击→主窗口前台的耗时（查找句柄 / 恢复+激活），用于对比握手缓存前后的差异
+  const auto us = [&](const LARGE_INTEGER& a, const LARGE_INTEGER& b) {
+    return (long long)((b.QuadPart - a.QuadPart) * 1000000 / (freq.QuadPart ? freq.QuadPart : 1));
+  };
+  std::wstringstream ss;
+  ss << L"OpenMainApp resolve_us=" << us(t0, t1) << L" activate_us=" << us(t1, t2)
+     << L" cached=" << (cached ? 1 : 0) << L" foreground=" << (GetForegroundWindow() == hwndMain ? 1 : 0);
+  LogLine(ss.str());
   // 打开主程序后隐藏悬浮球（如需保留可删除此行）
   ShowWindow(m_hWnd, SW_HIDE);
 }
@@ -590,14 +879,29 @@ void BallWindow::EnsureBubble() {
       m_bubble.reset(new BubbleWindow(m_hInst, m_hwndBubble));
       SetWindowLongPtr(m_hwndBubble, GWLP_USERDATA, (LONG_PTR)m_bubble.get());
     }
+    m_bubble->SetMainPeer(&m_mainPeer);
   }
 }
 
 void BallWindow::ShowBubble() {
   EnsureBubble();
+  KillTimer(m_hWnd, m_hideTimerId);
   RECT wr{}; GetWindowRect(m_hWnd, &wr);
   int x = wr.right + 8; int y = wr.top;
-  m_bubble->ShowNoActivate(x, y, 280, 180);
+  m_bubble->ShowNoActivate(x, y, BubbleWindow::kWidth, m_bubble->PreferredHeight());
+}
+
+bool BallWindow::IsCursorOverBallOrBubble() const {
+  POINT pt{};
+  if (!GetCursorPos(&pt)) return false;
+  RECT wr{};
+  if (GetWindowRect(m_hWnd, &wr)) {
+    // 球与气泡之间有 8px 间隙，向右扩展一点避免鼠标穿过间隙时误判离开
+    wr.right += 8;
+    if (PtInRect(&wr, pt)) return true;
+  }
+  if (m_bubble && m_bubble->IsVisible() && GetWindowRect(m_bubble->Handle(), &wr) && PtInRect(&wr, pt)) return true;
+  return false;
 }
 
 void BallWindow::HideBubble() {
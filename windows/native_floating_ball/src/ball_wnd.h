@@ -1,13 +1,28 @@
 #pragma once
 #include <windows.h>
 #include <d2d1.h>
+#include <dwrite.h>
 #include <wincodec.h>
 #include <memory>
 #include <string>
+#include <vector>
 #include "gif_player.h"
 #include "bubble_wnd.h"
+#include "peer_link.h"
+#include "core/async_logger.h"
+#include "core/ball_state.h"
+#include "core/circle_mask.h"
+#include "core/event_trace.h"
+#include "core/hit_mask.h"
+#include "core/memory_accounting.h"
+#include "core/seqlock_snapshot.h"
+#include "core/settings_store.h"
+#include "core/shared_region.h"
+#include "core/task_sync.h"
+#include "core/task_text_parser.h"
 
 #pragma comment(lib, "d2d1.lib")
+#pragma comment(lib, "dwrite.lib")
 #pragma comment(lib, "windowscodecs.lib")
 
 class BallWindow {
@@ -24,49 +39,94 @@ private:
 
   bool InitializeD2D();
   bool CreateRenderTarget(D2D1_RENDER_TARGET_TYPE type);
-  void Render();
+  // budgetMs：这一帧与上一帧之间的预定间隔（帧定时器驱动时为 GIF 帧延迟），0 表示按需重绘
+  void Render(UINT budgetMs = 0);
   void PresentLayered();
+  bool DrawFrameWithOverlay(const uint8_t* frame);
+  void DrawDebugOverlay();
+  void ReportFrameTimings(uint64_t nowNs);
 
   void OnDpiChanged(HWND hWnd, WPARAM wParam, LPARAM lParam);
   void PositionBottomRight();
   void PositionInitial();
+  void OpenSettings();
+  void ImportLegacyPosition();
   bool LoadSavedPosition(POINT* ptOut);
   void SaveCurrentPosition();
   void ClampToWorkArea(POINT* ptInOut);
+  const std::wstring& GetSettingsDir() const;
   std::wstring GetSettingsPath() const;
   std::wstring GetLogPath() const;
-  void LogLine(const std::wstring& line) const;
+  void OpenLog();
+  void OpenEventTrace();
+  void LogLine(const std::wstring& line, LogLevel level = LogLevel::Info) const;
   void LogHr(const wchar_t* where, HRESULT hr) const;
   void LogLastError(const wchar_t* where) const;
+  void ReportMemory(HWND replyTo);
+  void CheckMemoryBudget();
   void EnsureBorderlessStyle();
   void LoadGifs();
-  void SelectGifByUnread();
+  GifPlayer* ActiveGif();
+  const HitMask& ActiveHitMask();
+  void ApplyEffects(uint32_t effects);
   void OpenMainApp();
+  TaskSyncResult OnSnapshotPublished();
+  void QueueTasksChanged(const TaskListDiff& diff, int unreadCount);
+  void FlushTasksChanged();
 
 private:
   HINSTANCE m_hInst{};
   HWND m_hWnd{};
   int m_diameter{120};
-  UINT m_frameIndex{0};
   UINT m_timerId{1};
+  UINT m_hideTimerId{2}; // 鼠标离开后延迟隐藏气泡
+  UINT m_frameTimerDelayMs{0}; // 帧定时器当前的间隔，作为下一帧的预定间隔
+  bool m_debugOverlay{false};  // 设置项 debug_overlay：球面上叠加帧率与 p99
   GifPlayer m_gifUnread;
   GifPlayer m_gifDynamic;
-  GifPlayer* m_activeGif{nullptr};
-  int m_unreadCount{0};
+  BallState m_state;                    // GIF 选择、帧推进、任务变化合并、气泡显隐（与轨迹回放共用）
+  EventTraceWriter m_eventTrace;        // CHAT_DESKTOP_EVENT_TRACE 设置时录制输入 / IPC 事件
+  PeerLink m_mainPeer;                  // 主程序窗口（握手缓存，失效时才重新查找）
+  UINT m_peerHelloMsg{0};
+  UINT m_dumpProfileMsg{0};             // 按需把消息分发剖析写入日志
+  UINT m_memoryReportMsg{0};            // 按需导出内存报告（见 core/memory_accounting.h）
+  mutable std::wstring m_settingsDir;   // 见 GetSettingsDir
+  mutable bool m_settingsDirResolved{false};
+  SettingsStore m_settings;             // 析构时写出尚未落盘的修改
+  std::string m_topologyKey;            // 当前显示器拓扑，位置按它分别保存
   HWND m_hwndBubble{nullptr};
   std::unique_ptr<BubbleWindow> m_bubble;
+  TaskTextParser m_textParser;          // 旧文本格式解析，条目数组跨更新复用
+  TaskSyncReceiver m_taskSync;          // 二进制快照/增量的序号状态
+  static constexpr UINT kMsgTasksChanged = WM_APP + 1; // 合并后的任务变化通知
+  // 共享内存快照通道（只读映射）
+  UINT m_snapshotMsg{0};
+  SharedRegion m_snapshotRegion;
+  SeqlockSnapshotReader m_snapshotReader;
+  std::vector<uint8_t> m_snapshotBuf;
+  MemoryCharge m_ipcMemory{MemorySubsystem::IpcBuffers}; // 快照映射 + 本地副本容量
   void EnsureBubble();
   void ShowBubble();
   void HideBubble();
+  bool IsCursorOverBallOrBubble() const;
 
-  // D2D / WIC
+  // 显示尺寸帧的圆形蒙版（按直径构建一次）；没有 GIF 时绘制的纯色圆及其命中区域
+  CircleMask m_mask;
+  std::vector<uint8_t> m_fallbackFrame;
+  HitMask m_fallbackHit;
+
+  // D2D：只有调试叠加层需要（帧直接拷进 DIB）；WIC 只在加载 GIF 时使用
   ID2D1Factory* m_pD2DFactory{nullptr};
-  ID2D1DCRenderTarget* m_pRT{nullptr};
   IWICImagingFactory* m_pWIC{nullptr};
+  ID2D1DCRenderTarget* m_pRT{nullptr};
+  ID2D1Bitmap* m_frameBitmap{nullptr}; // 叠加层路径下承载当前帧，随渲染目标重建
   D2D1_RENDER_TARGET_TYPE m_rtType{D2D1_RENDER_TARGET_TYPE_SOFTWARE};
+  IDWriteFactory* m_pDW{nullptr};             // 只在开启调试叠加层时创建
+  IDWriteTextFormat* m_overlayFormat{nullptr};
 
   // Back buffer (GDI)
   HBITMAP m_hDIB{nullptr};
   HDC m_hMemDC{nullptr};
   void* m_pBits{nullptr};
+  MemoryCharge m_dibMemory{MemorySubsystem::RenderResources};
 };
@@ -1,13 +1,22 @@
 #include "bubble_wnd.h"
+#include "ipc_send.h"
+#include "core/ball_ipc.h"
+#include "core/dispatch_profiler.h"
+#include "core/frame_timing.h"
 #include <dwmapi.h>
 #include <uxtheme.h>
 #include <d2d1helper.h>
 #include <windowsx.h>
+#include <algorithm>
+#include <cmath>
 #include <string>
 
 #pragma comment(lib, "Dwmapi.lib")
 
 static const wchar_t* kBubbleClass = L"NativeFloatingBubbleWindow";
+static const wchar_t* kFontFamily = L"Segoe UI";
+static const wchar_t* kFontKey = L"Segoe UI@13";
+static const float kFontSize = 13.f;
 
 ATOM BubbleWindow::Register(HINSTANCE hInst) {
   WNDCLASSEX wc{ sizeof(WNDCLASSEX) };
@@ -70,16 +79,75 @@ static void EnableAcrylic(HWND hWnd, BYTE opacity /*0-255*/, COLORREF tint = RGB
   pSetWindowCompositionAttribute(hWnd, &data);
 }
 
-void BubbleWindow::SetItems(const std::vector<std::wstring>& items) {
-  m_items = items;
+static std::wstring_view WideView(const std::u16string& s) {
+  static_assert(sizeof(wchar_t) == sizeof(char16_t), "Win32 wchar_t is UTF-16");
+  return std::wstring_view(reinterpret_cast<const wchar_t*>(s.data()), s.size());
 }
 
-void BubbleWindow::ShowNoActivate(int x, int y, int w, int h) {
-  SetWindowPos(m_hWnd, HWND_TOPMOST, x, y, w, h, SWP_NOACTIVATE | SWP_SHOWWINDOW);
+const TaskListDiff& BubbleWindow::SetItems(const std::vector<TaskItemView>& items) {
+  const TaskListDiff& diff = m_model.Replace(items);
+  OnModelChanged();
+  return diff;
+}
+
+TaskSyncResult BubbleWindow::ApplyWire(TaskSyncReceiver& sync, const void* data, size_t size) {
+  const TaskSyncResult result = sync.Apply(data, size, m_model);
+  // 接收端保证未应用的负载不改动模型，但视口/动画状态的刷新很便宜，不依赖这一点
+  OnModelChanged();
+  return result;
+}
+
+void BubbleWindow::OnModelChanged() {
+  // 不可见时没有必要播放行动画，直接跳到终态
+  if (!m_visible) m_model.Tick(1.f);
+  m_viewport.itemCount = (int)m_model.Size();
+  m_sceneMemory.Set(m_model.Size() * sizeof(TaskRow) + (size_t)m_atlas.Width() * m_atlas.Height());
+  m_viewport.ClampScroll();
+  if (m_visible && m_model.IsAnimating() && !m_rowAnimTimer) {
+    m_rowAnimTimer = SetTimer(m_hWnd, 102, kAnimTickMs, nullptr);
+  }
+}
+
+int BubbleWindow::PreferredHeight() const {
+  // 按 live 行计算高度，淡出中的残影行不撑大窗口
+  ListViewport v = m_viewport;
+  v.itemCount = (int)m_model.LiveCount();
+  return (int)std::ceil(v.PreferredHeight(kMaxVisibleRows));
+}
+
+void BubbleWindow::UpdateRegion(int w, int h) {
   // Rounded region (to enable acrylic with round corners)
   if (m_hrgn) { DeleteObject(m_hrgn); m_hrgn = nullptr; }
   m_hrgn = CreateRoundRectRgn(0, 0, w, h, 20, 20);
   SetWindowRgn(m_hWnd, m_hrgn, FALSE);
+}
+
+void BubbleWindow::Refresh(int x, int y, int w, int h) {
+  if (!m_visible) return;
+  RECT wr{}; GetWindowRect(m_hWnd, &wr);
+  const bool resized = (wr.right - wr.left != w) || (wr.bottom - wr.top != h);
+  if (resized || wr.left != x || wr.top != y) {
+    SetWindowPos(m_hWnd, nullptr, x, y, w, h, SWP_NOACTIVATE | SWP_NOZORDER);
+  }
+  if (resized) UpdateRegion(w, h);
+  m_viewport.viewportHeight = (float)h;
+  m_viewport.ClampScroll();
+  Render();
+}
+
+void BubbleWindow::TickRows() {
+  const bool more = m_model.Tick(0.016f);
+  m_viewport.itemCount = (int)m_model.Size();
+  m_viewport.ClampScroll();
+  Render(kAnimTickMs);
+  if (!more && m_rowAnimTimer) { KillTimer(m_hWnd, m_rowAnimTimer); m_rowAnimTimer = 0; }
+}
+
+void BubbleWindow::ShowNoActivate(int x, int y, int w, int h) {
+  m_viewport.viewportHeight = (float)h;
+  m_viewport.ClampScroll();
+  SetWindowPos(m_hWnd, HWND_TOPMOST, x, y, w, h, SWP_NOACTIVATE | SWP_SHOWWINDOW);
+  UpdateRegion(w, h);
   // Enable acrylic blur
   EnableAcrylic(m_hWnd, 0xD0, RGB(30,30,30));
   StartShowAnim();
@@ -106,6 +174,7 @@ LRESULT CALLBACK BubbleWindow::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARA
     SetWindowLongPtr(hWnd, GWLP_USERDATA, 0);
     return res;
   }
+  DispatchProfiler::Scope scope(ProcessDispatchProfiler(), msg); // 按消息类型统计处理耗时
   return self->HandleMessage(hWnd, msg, wParam, lParam);
 }
 
@@ -118,16 +187,16 @@ LRESULT BubbleWindow::HandleMessage(HWND hWnd, UINT msg, WPARAM wParam, LPARAM l
   }
   case WM_TIMER:
     if (wParam == m_animTimer) { TickAnim(); return 0; }
+    if (m_rowAnimTimer && wParam == m_rowAnimTimer) { TickRows(); return 0; }
     break;
+  case WM_MOUSEWHEEL:
+    OnMouseWheel(wParam);
+    return 0;
   case WM_LBUTTONUP: {
     POINT pt{ GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam) };
     int idx = HitTest(pt);
-    if (idx >= 0 && idx < (int)m_items.size()) {
-      // Assume item string begins with id: e.g., "42 任务标题"
-      std::wstring s = m_items[idx];
-      size_t sp = s.find(L' ');
-      std::wstring id = (sp == std::wstring::npos) ? s : s.substr(0, sp);
-      SendOpenTaskToMain(id);
+    if (idx >= 0 && idx < (int)m_model.Size() && !m_model.Row(idx).removing) {
+      SendOpenTaskToMain(m_model.Row(idx).item.id);
       Hide();
     }
     return 0;
@@ -136,8 +205,10 @@ LRESULT BubbleWindow::HandleMessage(HWND hWnd, UINT msg, WPARAM wParam, LPARAM l
   return DefWindowProc(hWnd, msg, wParam, lParam);
 }
 
-void BubbleWindow::Render() {
+void BubbleWindow::Render(UINT budgetMs) {
   if (!m_visible && !m_animHiding) return;
+  const uint64_t t0 = FrameTimings::NowNs();
+  m_layoutNs = 0;
   RECT rc; GetClientRect(m_hWnd, &rc);
   int w = rc.right - rc.left, h = rc.bottom - rc.top;
   // Init D2D/DWrite once
@@ -176,54 +247,180 @@ void BubbleWindow::Render() {
   brush->Release(); border->Release();
 
   // Text format once
-  if (!m_pFormat) m_pDW->CreateTextFormat(L"Segoe UI", nullptr, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH_NORMAL, 13.f, L"zh-CN", &m_pFormat);
-  m_itemRects.clear();
-  float y = 10.f; const float lineH = 24.f;
-  for (auto& s : m_items) {
-    D2D1_RECT_F tr = D2D1::RectF(10.f, y, (float)w - 10.f, y + lineH);
-    ID2D1SolidColorBrush* txt = nullptr; m_hwndRT->CreateSolidColorBrush(D2D1::ColorF(1.f,1.f,1.f, 0.95f * opacity), &txt);
-    m_hwndRT->DrawTextW(s.c_str(), (UINT)s.size(), m_pFormat, tr, txt, D2D1_DRAW_TEXT_OPTIONS_ENABLE_COLOR_FONT);
-    txt->Release();
-    RECT hr{ (LONG)(6*scale), (LONG)((y-2)*scale), (LONG)((w-6)*scale), (LONG)((y+lineH+2)*scale) };
-    m_itemRects.push_back(hr);
-    y += lineH + 4.f;
+  if (!m_pFormat) {
+    m_pDW->CreateTextFormat(kFontFamily, nullptr, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH_NORMAL, kFontSize, L"zh-CN", &m_pFormat);
+    if (m_pFormat) m_pFormat->SetWordWrapping(DWRITE_WORD_WRAPPING_NO_WRAP);
+  }
+  m_renderScale = scale;
+  m_viewport.viewportHeight = (float)h;
+  m_viewport.ClampScroll();
+
+  // 只绘制与视口相交的行：无论未读任务有多少条，每帧成本都只与可见行数有关
+  int first = 0, last = 0;
+  m_viewport.VisibleRange(&first, &last);
+  m_hwndRT->PushAxisAlignedClip(D2D1::RectF(0.f, 0.f, (float)w, (float)h), D2D1_ANTIALIAS_MODE_ALIASED);
+  ID2D1SolidColorBrush* txt = nullptr; m_hwndRT->CreateSolidColorBrush(D2D1::ColorF(1.f,1.f,1.f, 0.95f * opacity), &txt);
+  // 每行文本只在首次出现时排版/截断一次，之后的动画帧直接复用缓存结果
+  const float maxTextW = (float)w - 20.f;
+  if (!m_glyphInitTried) {
+    m_glyphInitTried = true;
+    const wchar_t* families[] = { kFontFamily, L"Microsoft YaHei UI", L"Microsoft YaHei", L"SimSun" };
+    m_glyphRaster.Initialize(m_pDW, families, sizeof(families) / sizeof(families[0]));
   }
+  if (!m_glyphRaster.IsReady() || !DrawRowsWithAtlas(first, last, maxTextW, txt)) {
+    DrawRowsWithLayouts(first, last, maxTextW, txt);
+  }
+  txt->Release();
+  DrawPriorityMarkers(first, last, opacity);
+
+  // 内容超出视口时绘制一个细滚动条，提示还有更多条目
+  const float maxScroll = m_viewport.MaxScroll();
+  if (maxScroll > 0.f) {
+    const float track = (float)h - 8.f;
+    const float thumb = (std::max)(16.f, track * (float)h / m_viewport.ContentHeight());
+    const float top = 4.f + (track - thumb) * (m_viewport.scrollOffset / maxScroll);
+    ID2D1SolidColorBrush* bar = nullptr; m_hwndRT->CreateSolidColorBrush(D2D1::ColorF(1.f,1.f,1.f, 0.35f * opacity), &bar);
+    m_hwndRT->FillRoundedRectangle(D2D1::RoundedRect(D2D1::RectF((float)w - 6.f, top, (float)w - 3.f, top + thumb), 1.5f, 1.5f), bar);
+    bar->Release();
+  }
+  m_hwndRT->PopAxisAlignedClip();
+  const uint64_t t1 = FrameTimings::NowNs();
   m_hwndRT->EndDraw();
+  const uint64_t t2 = FrameTimings::NowNs();
+  FrameTimings& timings = ProcessFrameTimings();
+  timings.Record(FrameStage::BubbleLayout, m_layoutNs);
+  timings.Record(FrameStage::BubbleDraw, t1 - t0 - m_layoutNs);
+  timings.Record(FrameStage::BubbleEndDraw, t2 - t1);
+  timings.FramePresented(FrameSurface::Bubble, t2, t2 - t0, (uint64_t)budgetMs * 1000000);
+  m_surfaceMemory.Set((size_t)w * h * 4 + (m_atlasBitmap ? (size_t)m_atlas.Width() * m_atlas.Height() : 0));
+}
+
+void BubbleWindow::DrawRowsWithLayouts(int first, int last, float maxTextW, ID2D1SolidColorBrush* txt) {
+  const UINT dpi = GetDpiForWindow(m_hWnd);
+  for (int i = first; i < last; ++i) {
+    const TaskRow& row = m_model.Row(i);
+    const float y = m_viewport.RowTop(i);
+    const std::u16string& text = row.item.title.empty() ? row.item.id : row.item.title;
+    const uint64_t l0 = FrameTimings::NowNs();
+    const CachedTextLayout* tl = m_textCache.Get(m_pDW, m_pFormat, kFontKey, WideView(text), maxTextW, m_viewport.rowHeight, dpi);
+    m_layoutNs += FrameTimings::NowNs() - l0;
+    if (tl && tl->Layout()) {
+      // 行级动画：插入的行从右侧淡入，移除的行原地淡出
+      txt->SetOpacity(row.anim);
+      const float dx = row.removing ? 0.f : (1.f - row.anim) * 8.f;
+      m_hwndRT->DrawTextLayout(D2D1::Point2F(10.f + dx, y), tl->Layout(), txt, D2D1_DRAW_TEXT_OPTIONS_ENABLE_COLOR_FONT);
+    }
+  }
+}
+
+bool BubbleWindow::DrawRowsWithAtlas(int first, int last, float maxTextW, ID2D1SolidColorBrush* txt) {
+  // 1) 先排版全部可见行（可能向图集追加字形）；图集中途被清空时整组重排，保证所有行引用同一代图集
+  const uint64_t l0 = FrameTimings::NowNs();
+  m_visibleTexts.clear();
+  for (int i = first; i < last; ++i) {
+    const TaskRow& row = m_model.Row(i);
+    const std::u16string& text = row.item.title.empty() ? row.item.id : row.item.title;
+    m_visibleTexts.push_back(text);
+  }
+  const bool consistent = m_lineCache.GetConsistent(m_atlas, m_glyphRaster, m_visibleTexts, kFontSize, 96, maxTextW, &m_visibleLines);
+  m_layoutNs = FrameTimings::NowNs() - l0;
+  if (!consistent) return false; // 可见文本放不进一张图集
+
+  // 2) 只把新增字形所在的脏矩形上传到 A8 纹理
+  const AtlasRect dirty = m_atlas.TakeDirtyRect();
+  if (!m_atlasBitmap) {
+    const D2D1_BITMAP_PROPERTIES bp = D2D1::BitmapProperties(D2D1::PixelFormat(DXGI_FORMAT_A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED));
+    m_hwndRT->CreateBitmap(D2D1::SizeU(m_atlas.Width(), m_atlas.Height()), m_atlas.Pixels(), m_atlas.Width(), bp, &m_atlasBitmap);
+    if (!m_atlasBitmap) return false;
+  } else if (!dirty.Empty()) {
+    const D2D1_RECT_U r = D2D1::RectU(dirty.left, dirty.top, dirty.right, dirty.bottom);
+    m_atlasBitmap->CopyFromMemory(&r, m_atlas.Pixels() + (size_t)dirty.top * m_atlas.Width() + dirty.left, m_atlas.Width());
+  }
+
+  // 3) 每个字形一次 FillOpacityMask（图集作为覆盖率蒙版，颜色来自画刷），没有任何逐帧排版
+  m_hwndRT->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+  for (int i = first; i < last; ++i) {
+    const TaskRow& row = m_model.Row(i);
+    const ShapedLine* line = m_visibleLines[i - first];
+    txt->SetOpacity(row.anim);
+    const float dx = row.removing ? 0.f : std::round((1.f - row.anim) * 8.f);
+    const float baseline = std::round(m_viewport.RowTop(i) + line->ascent);
+    for (const PlacedGlyph& pg : line->glyphs) {
+      const GlyphEntry& g = pg.glyph;
+      if (!g.w || !g.h) continue;
+      const float gx = 10.f + dx + pg.x + g.left;
+      const float gy = baseline - g.top;
+      const D2D1_RECT_F dst = D2D1::RectF(gx, gy, gx + g.w, gy + g.h);
+      const D2D1_RECT_F src = D2D1::RectF((float)g.x, (float)g.y, (float)(g.x + g.w), (float)(g.y + g.h));
+      m_hwndRT->FillOpacityMask(m_atlasBitmap, txt, D2D1_OPACITY_MASK_CONTENT_TEXT_GRAYSCALE, &dst, &src);
+    }
+  }
+  m_hwndRT->SetAntialiasMode(D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+  return true;
+}
+
+void BubbleWindow::DrawPriorityMarkers(int first, int last, float opacity) {
+  // 高优先级任务在行首左侧留白处画一个小红点
+  ID2D1SolidColorBrush* dot = nullptr;
+  for (int i = first; i < last; ++i) {
+    const TaskRow& row = m_model.Row(i);
+    if (row.item.priority < 2) continue;
+    if (!dot) m_hwndRT->CreateSolidColorBrush(D2D1::ColorF(1.f, 0.36f, 0.32f, 0.95f * opacity), &dot);
+    if (!dot) return;
+    dot->SetOpacity(row.anim);
+    const float cy = m_viewport.RowTop(i) + m_viewport.rowHeight * 0.5f;
+    m_hwndRT->FillEllipse(D2D1::Ellipse(D2D1::Point2F(5.f, cy), 2.f, 2.f), dot);
+  }
+  if (dot) dot->Release();
 }
 
 int BubbleWindow::HitTest(POINT pt) const {
-  for (int i = 0; i < (int)m_itemRects.size(); ++i) if (PtInRect(&m_itemRects[i], pt)) return i;
-  return -1;
+  const float scale = (m_renderScale > 0.f) ? m_renderScale : 1.f;
+  const float x = pt.x / scale;
+  RECT rc; GetClientRect(m_hWnd, &rc);
+  if (x < 6.f || x > (float)(rc.right - rc.left) - 6.f) return -1;
+  return m_viewport.RowAt(pt.y / scale);
+}
+
+void BubbleWindow::OnMouseWheel(WPARAM wParam) {
+  // 每个滚轮刻度滚动 3 行（与系统默认一致）
+  const int delta = GET_WHEEL_DELTA_WPARAM(wParam);
+  const float dy = -(float)delta / WHEEL_DELTA * 3.f * m_viewport.RowPitch();
+  if (m_viewport.ScrollBy(dy)) Render();
 }
 
-void BubbleWindow::SendOpenTaskToMain(const std::wstring& idStr) {
-  // Find Flutter main window by class (title may vary)
-  HWND hwndMain = FindWindowW(L"FLUTTER_RUNNER_WIN32_WINDOW", nullptr);
+void BubbleWindow::SendOpenTaskToMain(std::u16string_view id) {
+  // 优先使用握手缓存的主窗口；未绑定时退回按类名查找（title may vary）
+  HWND hwndMain = m_mainPeer ? m_mainPeer->Resolve() : FindWindowW(L"FLUTTER_RUNNER_WIN32_WINDOW", nullptr);
   if (!hwndMain) return;
-  std::wstring payload = L"{\"action\":\"open_task\",\"taskId\":" + idStr + L"}";
-  COPYDATASTRUCT cds{}; cds.dwData = 2; // OPEN_TASK
-  cds.cbData = (DWORD)((payload.size() + 1) * sizeof(wchar_t));
-  cds.lpData = (PVOID)payload.c_str();
-  SendMessageW(hwndMain, WM_COPYDATA, (WPARAM)nullptr, (LPARAM)&cds);
+  // JSON 由 EncodeOpenTask 生成（非数字 id 会被转义），主程序端用 DecodeBallIpc 解析
+  const std::u16string payload = EncodeOpenTask(id);
+  // OPEN_TASK；主程序忙碌时最多等待 kIpcSendTimeoutMs，不让气泡的 UI 线程一起卡住
+  SendCopyData(hwndMain, kBallIpcOpenTask, payload.data(), (DWORD)(payload.size() * sizeof(char16_t)));
 }
 
 void BubbleWindow::StartShowAnim() {
   m_animShowing = true; m_animHiding = false; m_animT = 0.f;
-  if (!m_animTimer) m_animTimer = SetTimer(m_hWnd, 101, 16, nullptr);
+  if (!m_animTimer) m_animTimer = SetTimer(m_hWnd, 101, kAnimTickMs, nullptr);
 }
 void BubbleWindow::StartHideAnim() {
   if (!m_visible && !m_animShowing) { ShowWindow(m_hWnd, SW_HIDE); return; }
   m_animHiding = true; m_animShowing = false; m_animT = 0.f;
-  if (!m_animTimer) m_animTimer = SetTimer(m_hWnd, 101, 16, nullptr);
+  if (!m_animTimer) m_animTimer = SetTimer(m_hWnd, 101, kAnimTickMs, nullptr);
 }
 void BubbleWindow::TickAnim() {
   // simple ease-out
   m_animT += 0.08f;
   if (m_animT > 1.f) m_animT = 1.f;
-  Render();
+  Render(kAnimTickMs);
   if (m_animT >= 1.f) {
     KillTimer(m_hWnd, m_animTimer); m_animTimer = 0;
-    if (m_animHiding) { ShowWindow(m_hWnd, SW_HIDE); m_visible = false; m_animHiding = false; }
+    if (m_animHiding) {
+      ShowWindow(m_hWnd, SW_HIDE); m_visible = false; m_animHiding = false;
+      if (m_rowAnimTimer) { KillTimer(m_hWnd, m_rowAnimTimer); m_rowAnimTimer = 0; }
+      m_model.Tick(1.f);
+      m_viewport.itemCount = (int)m_model.Size();
+    }
     if (m_animShowing) { m_animShowing = false; }
   }
 }
@@ -4,26 +4,66 @@
 #include <dwrite.h>
 #include <vector>
 #include <string>
+#include <string_view>
+#include "core/list_viewport.h"
+#include "core/memory_accounting.h"
+#include "core/task_list_model.h"
+#include "core/task_sync.h"
+#include "core/glyph_atlas.h"
+#include "dwrite_glyph_rasterizer.h"
+#include "peer_link.h"
+#include "text_layout_cache.h"
 
 class BubbleWindow {
 public:
+  static constexpr int kWidth = 280;
+  static constexpr int kMaxVisibleRows = 8; // 超过后改为滚动
+  static constexpr UINT kAnimTickMs = 16;   // 显隐动画与行动画的定时器间隔
+
   static ATOM Register(HINSTANCE hInst);
   static HWND Create(HINSTANCE hInst, int x, int y, int w, int h);
 
   static LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
   LRESULT HandleMessage(HWND, UINT, WPARAM, LPARAM);
 
-  void SetItems(const std::vector<std::wstring>& items);
+  // 按 id 与当前列表做差异合并；只有插入/删除/移动/更新的行会重新排版并播放行级动画
+  const TaskListDiff& SetItems(const std::vector<TaskItemView>& items);
+  // 应用二进制快照/增量（带序号校验）；增量只触及变化的行
+  TaskSyncResult ApplyWire(TaskSyncReceiver& sync, const void* data, size_t size);
+  const TaskListDiff& LastDiff() const { return m_model.LastDiff(); }
+  size_t TaskCount() const { return m_model.LiveCount(); }
   void ShowNoActivate(int x, int y, int w, int h);
+  // 已显示时的增量刷新：不重建圆角区域、不重置显隐动画
+  void Refresh(int x, int y, int w, int h);
   void Hide();
   bool IsVisible() const { return m_visible; }
+  // 可见且不在隐藏动画中
+  bool IsShowing() const { return m_visible && !m_animHiding; }
+  HWND Handle() const { return m_hWnd; }
+  // 主程序窗口句柄缓存（由悬浮球持有）；点击任务时不再逐次 FindWindow
+  void SetMainPeer(PeerLink* peer) { m_mainPeer = peer; }
+  // 按条目数计算气泡高度（封顶 kMaxVisibleRows 行）
+  int PreferredHeight() const;
+  // 行文本测量/截断缓存的命中统计（用于诊断动画帧是否仍在重复排版）
+  TextLayoutCache::Stats TextCacheStats() const { return m_textCache.GetStats(); }
+  ShapedTextCache::Stats ShapedLineStats() const { return m_lineCache.GetStats(); }
+  GlyphAtlas::Stats GlyphAtlasStats() const { return m_atlas.GetStats(); }
 
   BubbleWindow(HINSTANCE hInst, HWND hWnd) : m_hInst(hInst), m_hWnd(hWnd) {}
 
 private:
-  void Render();
+  // budgetMs：动画定时器驱动时为 kAnimTickMs，0 表示按需重绘（帧耗时统计用）
+  void Render(UINT budgetMs = 0);
   int HitTest(POINT pt) const;
-  void SendOpenTaskToMain(const std::wstring& idStr);
+  void UpdateRegion(int w, int h);
+  // 可见行放不进一张图集、或纹理创建失败时返回 false（什么也没画），调用方改用 DrawRowsWithLayouts
+  bool DrawRowsWithAtlas(int first, int last, float maxTextW, ID2D1SolidColorBrush* txt);
+  void DrawRowsWithLayouts(int first, int last, float maxTextW, ID2D1SolidColorBrush* txt);
+  void DrawPriorityMarkers(int first, int last, float opacity);
+  void OnModelChanged();
+  void TickRows();
+  void OnMouseWheel(WPARAM wParam);
+  void SendOpenTaskToMain(std::u16string_view id);
   void StartShowAnim();
   void StartHideAnim();
   void TickAnim();
@@ -32,19 +72,35 @@ private:
   HINSTANCE m_hInst{};
   HWND m_hWnd{};
   bool m_visible{false};
-  std::vector<std::wstring> m_items; // one per line; format: "<id> <title>"
-  std::vector<RECT> m_itemRects;
+  PeerLink* m_mainPeer{nullptr};
+  TaskListModel m_model;     // id -> 行；含正在淡出的已移除行
+  ListViewport m_viewport;   // 只渲染可见行；命中测试由 y 偏移直接换算
+  float m_renderScale{1.f};  // 当前帧的动画缩放，HitTest 需要反算
 
   // D2D/DWrite + backbuffer
   ID2D1Factory* m_pD2D{nullptr};
   ID2D1HwndRenderTarget* m_hwndRT{nullptr};
   IDWriteFactory* m_pDW{nullptr};
   IDWriteTextFormat* m_pFormat{nullptr};
+  TextLayoutCache m_textCache;         // 回退路径：DirectWrite layout
+  // 主路径：字形图集（排版结果按行缓存，绘制时只贴图）
+  DWriteGlyphRasterizer m_glyphRaster;
+  GlyphAtlas m_atlas;
+  ShapedTextCache m_lineCache;
+  ID2D1Bitmap* m_atlasBitmap{nullptr}; // A8 覆盖率纹理
+  bool m_glyphInitTried{false};
+  std::vector<std::u16string_view> m_visibleTexts;
+  std::vector<const ShapedLine*> m_visibleLines;
+  uint64_t m_layoutNs{0}; // 本帧可见行排版的耗时（FrameStage::BubbleLayout）
   HRGN m_hrgn{nullptr};
+  // 行结构体 + 图集像素（行内字符串与排版缓存未计入）；渲染目标表面 + A8 图集纹理
+  MemoryCharge m_sceneMemory{MemorySubsystem::BubbleScene};
+  MemoryCharge m_surfaceMemory{MemorySubsystem::RenderResources};
 
   // Animation
   bool m_animShowing{false};
   bool m_animHiding{false};
   float m_animT{0.f}; // 0..1
   UINT_PTR m_animTimer{0};
+  UINT_PTR m_rowAnimTimer{0}; // 行级插入/移除动画
 };
@@ -0,0 +1,294 @@
+#include "async_logger.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iterator>
+#include <system_error>
+
+namespace {
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint64_t HashMessage(std::string_view s) {
+  uint64_t h = 1469598103934665603ull; // FNV-1a
+  for (unsigned char c : s) {
+    h ^= c;
+    h *= 1099511628211ull;
+  }
+  return h | 1; // 0 表示空表项
+}
+
+const char* LevelTag(LogLevel level) {
+  switch (level) {
+  case LogLevel::Debug: return "D";
+  case LogLevel::Info: return "I";
+  case LogLevel::Warn: return "W";
+  default: return "E";
+  }
+}
+
+std::filesystem::path NativePath(const std::string& utf8) {
+  return std::filesystem::u8path(utf8);
+}
+
+std::FILE* OpenAppend(const std::filesystem::path& path) {
+#ifdef _WIN32
+  return _wfopen(path.c_str(), L"ab");
+#else
+  return std::fopen(path.c_str(), "ab");
+#endif
+}
+
+} // namespace
+
+AsyncLogger::AsyncLogger() {
+  for (size_t i = 0; i < kCapacity; ++i) m_slots[i].seq.store(i, std::memory_order_relaxed);
+}
+
+bool AsyncLogger::Open(const Options& options) {
+  Close();
+  m_options = options;
+  m_options.maxFiles = (std::max)(m_options.maxFiles, 1);
+  SetMinLevel(options.minLevel);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = false;
+    m_wakeRequested = false;
+  }
+  OpenFile();
+  if (!m_file) return false;
+  m_ringMemory.Set(sizeof(m_slots));
+  m_running.store(true, std::memory_order_release);
+  m_thread = std::thread([this] { Run(); });
+  return true;
+}
+
+void AsyncLogger::Close() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_wake.notify_one();
+  if (m_thread.joinable()) m_thread.join();
+  m_running.store(false, std::memory_order_release);
+  if (m_file) std::fclose(m_file);
+  m_file = nullptr;
+  m_ringMemory.Set(0);
+}
+
+bool AsyncLogger::Log(LogLevel level, std::string_view message) {
+  if (!Enabled(level)) return false;
+  const int64_t now = NowNs();
+  char suffix[48];
+  std::string_view tail;
+  if (level >= LogLevel::Warn) {
+    // 重复抑制：近似即可，表项竞争只会让计数略有偏差
+    const uint64_t key = HashMessage(message);
+    RepeatEntry& e = m_repeats[key % kRepeatEntries];
+    const int64_t window = std::chrono::duration_cast<std::chrono::nanoseconds>(m_options.repeatWindow).count();
+    if (e.key.load(std::memory_order_relaxed) == key) {
+      if (now - e.windowStartNs.load(std::memory_order_relaxed) < window) {
+        e.suppressed.fetch_add(1, std::memory_order_relaxed);
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      e.windowStartNs.store(now, std::memory_order_relaxed);
+      const uint32_t skipped = e.suppressed.exchange(0, std::memory_order_relaxed);
+      if (skipped) {
+        const int n = std::snprintf(suffix, sizeof(suffix), " (repeated %u more times)", skipped);
+        tail = std::string_view(suffix, n > 0 ? (size_t)n : 0);
+      }
+    } else {
+      e.key.store(key, std::memory_order_relaxed);
+      e.windowStartNs.store(now, std::memory_order_relaxed);
+      e.suppressed.store(0, std::memory_order_relaxed);
+    }
+  }
+  return Enqueue(level, now, message, tail);
+}
+
+bool AsyncLogger::Enqueue(LogLevel level, int64_t timeNs, std::string_view a, std::string_view b) {
+  if (!IsOpen()) return false;
+  if (a.size() + b.size() > kSlotText) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_long.size() >= kMaxLongRecords) {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    std::string text(a);
+    text += b;
+    m_longMemory.Add(text.capacity());
+    m_long.push_back(LongRecord{timeNs, level, m_head.load(std::memory_order_acquire), std::move(text)});
+    m_wakeRequested = true;
+    m_wake.notify_one();
+    return true;
+  }
+  // Vyukov 有界队列：seq == pos 表示槽位空闲，写完后置为 pos + 1 交给消费者
+  uint64_t pos = m_head.load(std::memory_order_relaxed);
+  Slot* slot;
+  for (;;) {
+    slot = &m_slots[pos & (kCapacity - 1)];
+    const uint64_t seq = slot->seq.load(std::memory_order_acquire);
+    const int64_t diff = (int64_t)seq - (int64_t)pos;
+    if (diff == 0) {
+      if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      pos = m_head.load(std::memory_order_relaxed);
+    }
+  }
+  slot->timeNs = timeNs;
+  slot->level = level;
+  std::memcpy(slot->text, a.data(), a.size());
+  if (!b.empty()) std::memcpy(slot->text + a.size(), b.data(), b.size());
+  slot->length = (uint32_t)(a.size() + b.size());
+  slot->seq.store(pos + 1, std::memory_order_release);
+  // 只有让后台线程从睡眠中醒来的那一次调用需要通知；其余时间它按固定间隔自行醒来
+  if (m_sleeping.exchange(false, std::memory_order_relaxed)) m_wake.notify_one();
+  return true;
+}
+
+void AsyncLogger::Flush() {
+  if (!IsOpen()) return;
+  const uint64_t target = m_head.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_wakeRequested = true;
+  m_wake.notify_one();
+  m_drained.wait_for(lock, std::chrono::seconds(2), [&] {
+    return (m_tail.load(std::memory_order_acquire) >= target && m_long.empty()) || m_stop;
+  });
+}
+
+void AsyncLogger::Run() {
+  for (;;) {
+    const bool wrote = Drain(false);
+    if (wrote && m_file) std::fflush(m_file);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_drained.notify_all();
+    if (m_stop) {
+      lock.unlock();
+      if (Drain(true) && m_file) std::fflush(m_file); // Close 之前入队的最后一批
+      const uint64_t dropped = Dropped(), suppressed = Suppressed();
+      if ((dropped || suppressed) && m_file) {
+        char buf[96];
+        const int n = std::snprintf(buf, sizeof(buf), "logger closed: %llu dropped, %llu repeats suppressed",
+                                    (unsigned long long)dropped, (unsigned long long)suppressed);
+        Write(NowNs(), LogLevel::Info, std::string_view(buf, n > 0 ? (size_t)n : 0));
+        std::fflush(m_file);
+      }
+      break;
+    }
+    if (wrote || m_wakeRequested) {
+      m_wakeRequested = false;
+      continue;
+    }
+    m_sleeping.store(true, std::memory_order_relaxed);
+    m_wake.wait_for(lock, std::chrono::milliseconds(50), [&] { return m_stop || m_wakeRequested; });
+    m_sleeping.store(false, std::memory_order_relaxed);
+    m_wakeRequested = false;
+  }
+}
+
+bool AsyncLogger::Drain(bool final) {
+  bool wrote = false;
+  std::deque<LongRecord> longRecords;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    longRecords.swap(m_long);
+  }
+  // 长消息插在它入队前已占位的环形记录之后，两条队列合起来仍是入队顺序
+  uint64_t tail = m_tail.load(std::memory_order_relaxed);
+  for (;;) {
+    while (!longRecords.empty() && longRecords.front().ringPos <= tail) {
+      Write(longRecords.front().timeNs, longRecords.front().level, longRecords.front().text);
+      longRecords.pop_front();
+      wrote = true;
+    }
+    Slot& slot = m_slots[tail & (kCapacity - 1)];
+    if (slot.seq.load(std::memory_order_acquire) != tail + 1) break;
+    Write(slot.timeNs, slot.level, std::string_view(slot.text, slot.length));
+    slot.seq.store(tail + kCapacity, std::memory_order_release);
+    m_tail.store(++tail, std::memory_order_release);
+    wrote = true;
+  }
+  // 前面的槽位还没发布完：剩下的长消息留到下一轮；关闭时不再等
+  if (final) {
+    for (const LongRecord& r : longRecords) Write(r.timeNs, r.level, r.text);
+    wrote = wrote || !longRecords.empty();
+    longRecords.clear();
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_long.insert(m_long.begin(), std::make_move_iterator(longRecords.begin()), std::make_move_iterator(longRecords.end()));
+  size_t bytes = 0;
+  for (const LongRecord& r : m_long) bytes += r.text.capacity();
+  m_longMemory.Set(bytes);
+  return wrote;
+}
+
+void AsyncLogger::Write(int64_t timeNs, LogLevel level, std::string_view text) {
+  if (!m_file) return;
+  const std::time_t seconds = (std::time_t)(timeNs / 1000000000);
+  std::tm tm{};
+#ifdef _WIN32
+  localtime_s(&tm, &seconds);
+#else
+  localtime_r(&seconds, &tm);
+#endif
+  char prefix[48];
+  const int n = std::snprintf(prefix, sizeof(prefix), "%04d-%02d-%02d %02d:%02d:%02d.%03d [%s] ",
+                              tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
+                              (int)((timeNs / 1000000) % 1000), LevelTag(level));
+  m_line.assign(prefix, n > 0 ? (size_t)n : 0);
+  m_line.append(text.data(), text.size());
+  m_line += '\n';
+  // 先轮转再写，当前文件总是以最新的记录结尾
+  if (m_fileBytes > 0 && m_fileBytes + m_line.size() > m_options.maxFileBytes) {
+    Rotate();
+    if (!m_file) return;
+  }
+  m_fileBytes += std::fwrite(m_line.data(), 1, m_line.size(), m_file);
+}
+
+void AsyncLogger::OpenFile() {
+  const std::filesystem::path path = NativePath(m_options.path);
+  m_file = OpenAppend(path);
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  m_fileBytes = ec ? 0 : (size_t)size;
+  if (m_file && m_fileBytes >= m_options.maxFileBytes) Rotate();
+}
+
+void AsyncLogger::Rotate() {
+  if (m_file) std::fclose(m_file);
+  m_file = nullptr;
+  const std::filesystem::path path = NativePath(m_options.path);
+  std::error_code ec;
+  if (m_options.maxFiles <= 1) {
+    std::filesystem::remove(path, ec);
+  } else {
+    // path.(n-2) → path.(n-1) … path → path.1；目标先删除（Windows 上 rename 不覆盖）
+    auto numbered = [&](int i) {
+      std::filesystem::path p = path;
+      p += "." + std::to_string(i);
+      return p;
+    };
+    std::filesystem::remove(numbered(m_options.maxFiles - 1), ec);
+    for (int i = m_options.maxFiles - 2; i >= 1; --i) {
+      std::filesystem::rename(numbered(i), numbered(i + 1), ec);
+    }
+    std::filesystem::rename(path, numbered(1), ec);
+  }
+  m_file = OpenAppend(path);
+  m_fileBytes = 0;
+}
+
+AsyncLogger& ProcessLogger() {
+  static AsyncLogger logger;
+  return logger;
+}
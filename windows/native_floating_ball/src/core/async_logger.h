@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "memory_accounting.h"
+
+// 异步日志：调用方只把一条记录放进无锁 MPSC 环形缓冲（定长槽位，不分配内存、不碰文件），
+// 后台线程负责格式化时间戳、写文件、按大小轮转。渲染路径上的失败日志因此不会再让每一帧都去
+// 打开 / 追加 / 关闭文件。
+//
+// - 级别：低于 MinLevel 的记录在入队前就被丢弃。
+// - 重复抑制：Warn/Error 级别的同一条消息在 repeatWindow 内只记一次，其余计数；
+//   窗口过后再出现时附带“已省略 N 次”。
+// - 环满时丢弃新记录并计数（不阻塞调用方）；超过槽位长度的长消息（例如剖析报告）走带锁的旁路队列。
+// - 轮转：文件超过 maxFileBytes 后依次改名为 path.1 … path.<maxFiles - 1>。
+// - Flush 等到调用前入队的记录都已写入；Close 写完剩余记录并停止后台线程。
+enum class LogLevel : uint8_t {
+  Debug,
+  Info,
+  Warn,
+  Error,
+};
+
+class AsyncLogger {
+public:
+  static constexpr size_t kCapacity = 512; // 槽位数（2 的幂）
+  static constexpr size_t kSlotText = 232; // 每个槽位可容纳的消息字节数
+
+  struct Options {
+    std::string path; // UTF-8
+    LogLevel minLevel{LogLevel::Info};
+    size_t maxFileBytes{1024 * 1024};
+    int maxFiles{3}; // 含当前文件
+    std::chrono::milliseconds repeatWindow{10000};
+  };
+
+  AsyncLogger();
+  ~AsyncLogger() { Close(); }
+  AsyncLogger(const AsyncLogger&) = delete;
+  AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+  // 启动后台线程；path 所在目录须已存在
+  bool Open(const Options& options);
+  void Close();
+  bool IsOpen() const { return m_running.load(std::memory_order_acquire); }
+
+  // 线程安全、无锁（长消息除外）；返回 false 表示被过滤、抑制或因环满丢弃
+  bool Log(LogLevel level, std::string_view message);
+  void Flush();
+
+  void SetMinLevel(LogLevel level) { m_minLevel.store((uint8_t)level, std::memory_order_relaxed); }
+  bool Enabled(LogLevel level) const { return (uint8_t)level >= m_minLevel.load(std::memory_order_relaxed); }
+
+  uint64_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+  uint64_t Suppressed() const { return m_suppressed.load(std::memory_order_relaxed); }
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> seq;
+    int64_t timeNs;
+    uint32_t length;
+    LogLevel level;
+    char text[kSlotText];
+  };
+  struct LongRecord {
+    int64_t timeNs;
+    LogLevel level;
+    uint64_t ringPos; // 入队时的环头位置：在它之前占位的环形记录先写
+    std::string text;
+  };
+  struct RepeatEntry {
+    std::atomic<uint64_t> key{0};
+    std::atomic<int64_t> windowStartNs{0};
+    std::atomic<uint32_t> suppressed{0};
+  };
+  static constexpr size_t kRepeatEntries = 64;
+  static constexpr size_t kMaxLongRecords = 64;
+
+  bool Enqueue(LogLevel level, int64_t timeNs, std::string_view a, std::string_view b);
+  void Run();
+  bool Drain(bool final);
+  void Write(int64_t timeNs, LogLevel level, std::string_view text);
+  void OpenFile();
+  void Rotate();
+
+  Slot m_slots[kCapacity];
+  alignas(64) std::atomic<uint64_t> m_head{0};
+  alignas(64) std::atomic<uint64_t> m_tail{0}; // 只由后台线程写
+  std::atomic<uint64_t> m_dropped{0};
+  std::atomic<uint64_t> m_suppressed{0};
+  std::atomic<uint8_t> m_minLevel{(uint8_t)LogLevel::Info};
+  RepeatEntry m_repeats[kRepeatEntries];
+
+  Options m_options;
+  std::mutex m_mutex; // 保护旁路队列与唤醒 / Flush 状态
+  std::condition_variable m_wake;
+  std::condition_variable m_drained;
+  std::deque<LongRecord> m_long;
+  MemoryCharge m_ringMemory{MemorySubsystem::Logging}; // 打开期间计入环形缓冲
+  MemoryCharge m_longMemory{MemorySubsystem::Logging}; // 旁路队列中的文本，持 m_mutex 调整
+  std::atomic<bool> m_sleeping{false};
+  bool m_wakeRequested{false};
+  bool m_stop{false};
+  std::atomic<bool> m_running{false};
+  std::thread m_thread;
+
+  // 仅后台线程使用
+  std::FILE* m_file{nullptr};
+  size_t m_fileBytes{0};
+  std::string m_line;
+};
+
+// 进程内共享的实例
+AsyncLogger& ProcessLogger();
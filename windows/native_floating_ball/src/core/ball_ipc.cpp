@@ -0,0 +1,156 @@
+#include "ball_ipc.h"
+#include <algorithm>
+
+namespace {
+
+bool IsSpace(char16_t c) { return c == u' ' || c == u'\t' || c == u'\r' || c == u'\n'; }
+
+size_t SkipSpace(std::u16string_view s, size_t i) {
+  while (i < s.size() && IsSpace(s[i])) ++i;
+  return i;
+}
+
+// 读 JSON 字符串（i 指向起始引号）；只还原 \" \\ \/ 与 \uXXXX，足够覆盖 id/动作名
+bool ReadString(std::u16string_view s, size_t& i, std::u16string* out) {
+  if (i >= s.size() || s[i] != u'"') return false;
+  out->clear();
+  for (++i; i < s.size(); ++i) {
+    char16_t c = s[i];
+    if (c == u'"') { ++i; return true; }
+    if (c != u'\\') { out->push_back(c); continue; }
+    if (++i >= s.size()) return false;
+    c = s[i];
+    if (c == u'u') {
+      if (i + 4 >= s.size()) return false;
+      char16_t v = 0;
+      for (size_t k = 1; k <= 4; ++k) {
+        const char16_t h = s[i + k];
+        v = (char16_t)(v << 4);
+        if (h >= u'0' && h <= u'9') v |= (char16_t)(h - u'0');
+        else if (h >= u'a' && h <= u'f') v |= (char16_t)(h - u'a' + 10);
+        else if (h >= u'A' && h <= u'F') v |= (char16_t)(h - u'A' + 10);
+        else return false;
+      }
+      out->push_back(v);
+      i += 4;
+    } else if (c == u'n') {
+      out->push_back(u'\n');
+    } else if (c == u't') {
+      out->push_back(u'\t');
+    } else {
+      out->push_back(c); // \" \\ \/
+    }
+  }
+  return false;
+}
+
+// 顶层对象里查找键并返回其值（字符串或数字字面量）
+bool FindValue(std::u16string_view s, std::u16string_view key, std::u16string* out) {
+  size_t i = SkipSpace(s, 0);
+  if (i >= s.size() || s[i] != u'{') return false;
+  std::u16string name;
+  ++i;
+  while (true) {
+    i = SkipSpace(s, i);
+    if (i < s.size() && s[i] == u'}') return false;
+    if (!ReadString(s, i, &name)) return false;
+    i = SkipSpace(s, i);
+    if (i >= s.size() || s[i] != u':') return false;
+    i = SkipSpace(s, i + 1);
+    if (i >= s.size()) return false;
+    const bool match = name == key;
+    if (s[i] == u'"') {
+      if (!ReadString(s, i, match ? out : &name)) return false;
+      if (match) return true;
+    } else {
+      const size_t start = i;
+      while (i < s.size() && s[i] != u',' && s[i] != u'}' && !IsSpace(s[i])) ++i;
+      if (match) {
+        out->assign(s.substr(start, i - start));
+        return !out->empty();
+      }
+    }
+    i = SkipSpace(s, i);
+    if (i < s.size() && s[i] == u',') { ++i; continue; }
+    return false;
+  }
+}
+
+bool IsNumber(std::u16string_view s) {
+  if (s.empty()) return false;
+  size_t i = (s[0] == u'-') ? 1 : 0;
+  if (i == s.size()) return false;
+  for (; i < s.size(); ++i) {
+    if (s[i] < u'0' || s[i] > u'9') return false;
+  }
+  return true;
+}
+
+} // namespace
+
+bool DecodeBallIpc(uintptr_t dwData, const void* data, size_t bytes, BallIpcEvent* out) {
+  if (dwData == kBallIpcRestoreMain) {
+    out->kind = BallIpcKind::RestoreMain;
+    out->taskId.clear();
+    return true;
+  }
+  if (dwData != kBallIpcOpenTask || !data || bytes < sizeof(char16_t) ||
+      (reinterpret_cast<uintptr_t>(data) & 1u)) {
+    return false;
+  }
+  std::u16string_view s(static_cast<const char16_t*>(data), bytes / sizeof(char16_t));
+  while (!s.empty() && s.back() == u'\0') s.remove_suffix(1);
+
+  std::u16string value;
+  if (FindValue(s, u"action", &value) && value != u"open_task") return false;
+  if (!FindValue(s, u"taskId", &value) || value.empty() || value == u"null") return false;
+  out->kind = BallIpcKind::OpenTask;
+  out->taskId = std::move(value);
+  return true;
+}
+
+std::u16string EncodeOpenTask(std::u16string_view taskId) {
+  std::u16string out = u"{\"action\":\"open_task\",\"taskId\":";
+  if (IsNumber(taskId)) {
+    out.append(taskId);
+  } else {
+    out.push_back(u'"');
+    for (char16_t c : taskId) {
+      if (c == u'"' || c == u'\\') {
+        out.push_back(u'\\');
+        out.push_back(c);
+      } else if (c < 0x20) {
+        static const char16_t kHex[] = u"0123456789abcdef";
+        out.append(u"\\u00");
+        out.push_back(kHex[c >> 4]);
+        out.push_back(kHex[c & 0xF]);
+      } else {
+        out.push_back(c);
+      }
+    }
+    out.push_back(u'"');
+  }
+  out.push_back(u'}');
+  out.push_back(u'\0');
+  return out;
+}
+
+bool BallIpcBatch::Push(BallIpcEvent event) {
+  const bool first = m_events.empty();
+  const auto same = std::find_if(m_events.begin(), m_events.end(), [&](const BallIpcEvent& e) {
+    return e.kind == event.kind && e.taskId == event.taskId;
+  });
+  if (same != m_events.end()) return false;
+  if (m_capacity && m_events.size() >= m_capacity) {
+    m_events.erase(m_events.begin());
+    ++m_dropped;
+  }
+  m_events.push_back(std::move(event));
+  return first;
+}
+
+const std::vector<BallIpcEvent>& BallIpcBatch::Take() {
+  m_taken.swap(m_events);
+  m_events.clear();
+  return m_taken;
+}
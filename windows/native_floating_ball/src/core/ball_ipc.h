@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 悬浮球 → 主程序的 WM_COPYDATA 消息（与 Win32 无关的编解码，主程序桥接到 Dart 前先在这里解析）：
+//   dwData = kBallIpcOpenTask    OPEN_TASK：UTF-16 JSON {"action":"open_task","taskId":<id>}，
+//                                 taskId 为数字或字符串，结尾可带 NUL
+//   dwData = kBallIpcRestoreMain 从托盘隐藏状态恢复主窗口，无负载
+//   dwData = kBallIpcMemoryReport 内存报告：UTF-8 JSON（MemoryAccounting::ToJson），不带 NUL；
+//                                 只作为主程序发出的 kMemoryReportMessageName 查询的回复，不经 DecodeBallIpc
+constexpr uintptr_t kBallIpcOpenTask = 2;
+constexpr uintptr_t kBallIpcRestoreMain = 3;
+constexpr uintptr_t kBallIpcMemoryReport = 6;
+
+enum class BallIpcKind : uint8_t {
+  OpenTask = 0,
+  RestoreMain = 1,
+};
+
+struct BallIpcEvent {
+  BallIpcKind kind{BallIpcKind::RestoreMain};
+  std::u16string taskId; // 仅 OpenTask
+};
+
+// 解析一条悬浮球消息；不认识的 dwData 或格式错误的负载返回 false（由其它处理者继续处理）。
+bool DecodeBallIpc(uintptr_t dwData, const void* data, size_t bytes, BallIpcEvent* out);
+
+// 生成 OPEN_TASK 负载（含结尾 NUL）；非数字 id 按 JSON 字符串转义
+std::u16string EncodeOpenTask(std::u16string_view taskId);
+
+// 一次平台通道往返之前累积的事件。突发消息合并成一批：重复的 RestoreMain、
+// 同一任务的重复 OpenTask 只保留最早的一条（OpenTask 本身已包含恢复主窗口）。
+// 超过 capacity 时丢弃最旧的事件（监听端未就绪时不无限增长）。
+class BallIpcBatch {
+public:
+  explicit BallIpcBatch(size_t capacity = 64) : m_capacity(capacity) {}
+
+  // 返回 true 表示这是本批的第一条事件（调用方此时安排一次刷新）
+  bool Push(BallIpcEvent event);
+  bool Empty() const { return m_events.empty(); }
+  size_t Size() const { return m_events.size(); }
+  size_t Dropped() const { return m_dropped; }
+  // 取走当前批次；返回的数组在下一次 Take 之前有效
+  const std::vector<BallIpcEvent>& Take();
+
+private:
+  std::vector<BallIpcEvent> m_events;
+  std::vector<BallIpcEvent> m_taken;
+  size_t m_capacity;
+  size_t m_dropped{0};
+};
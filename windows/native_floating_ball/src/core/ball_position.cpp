@@ -0,0 +1,69 @@
+#include "ball_position.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <tuple>
+
+namespace {
+
+constexpr char kPositionPrefix[] = "pos.";
+
+std::string PositionKey(std::string_view topologyKey) {
+  std::string key = kPositionPrefix;
+  key.append(topologyKey.data(), topologyKey.size());
+  return key;
+}
+
+} // namespace
+
+std::string MonitorTopologyKey(std::vector<MonitorGeometry> monitors) {
+  std::sort(monitors.begin(), monitors.end(), [](const MonitorGeometry& a, const MonitorGeometry& b) {
+    return std::tie(a.left, a.top, a.right, a.bottom, a.dpi) < std::tie(b.left, b.top, b.right, b.bottom, b.dpi);
+  });
+  // FNV-1a；初值比标准的 14695981039346656037 少一位，已保存的拓扑键依赖它，不再更改
+  uint64_t h = 1469598103934665603ull;
+  for (const MonitorGeometry& m : monitors) {
+    for (int32_t v : { m.left, m.top, m.right, m.bottom, m.dpi }) {
+      for (int i = 0; i < 4; ++i) {
+        h ^= (uint8_t)((uint32_t)v >> (i * 8));
+        h *= 1099511628211ull;
+      }
+    }
+  }
+  char key[17];
+  std::snprintf(key, sizeof(key), "%016llx", (unsigned long long)h);
+  return key;
+}
+
+bool LoadBallPosition(const SettingsStore& settings, std::string_view topologyKey, long* x, long* y) {
+  std::string value;
+  if (!x || !y || !settings.Get(PositionKey(topologyKey), &value)) return false;
+  long px = 0, py = 0;
+  const char* end = value.data() + value.size();
+  const auto rx = std::from_chars(value.data(), end, px);
+  if (rx.ec != std::errc() || rx.ptr == end || *rx.ptr != ' ') return false;
+  const auto ry = std::from_chars(rx.ptr + 1, end, py);
+  if (ry.ec != std::errc() || ry.ptr != end) return false;
+  *x = px;
+  *y = py;
+  return true;
+}
+
+void SaveBallPosition(SettingsStore& settings, std::string_view topologyKey, long x, long y) {
+  settings.Set(PositionKey(topologyKey), std::to_string(x) + " " + std::to_string(y));
+}
+
+bool ImportLegacyBallPosition(SettingsStore& settings, std::string_view topologyKey, const std::string& legacyPath) {
+  bool hasPosition = false;
+  settings.ForEachWithPrefix(kPositionPrefix, [&](const std::string&, const std::string&) { hasPosition = true; });
+  if (hasPosition || legacyPath.empty()) return false;
+  std::ifstream in(std::filesystem::u8path(legacyPath));
+  if (!in.is_open()) return false;
+  long x = 0, y = 0;
+  in >> x >> y;
+  if (in.fail()) return false;
+  SaveBallPosition(settings, topologyKey, x, y);
+  return true;
+}
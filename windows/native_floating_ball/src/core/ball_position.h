@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "settings_store.h"
+
+// 悬浮球位置按显示器拓扑分别保存：设置项 pos.<拓扑键> = "x y"。
+// 同一组显示器（例如笔记本接上扩展坞）各自记住一个位置；拓扑键是各显示器矩形与 DPI 的 FNV-1a 哈希
+// （16 位十六进制），与枚举顺序无关。
+struct MonitorGeometry {
+  int32_t left;
+  int32_t top;
+  int32_t right;
+  int32_t bottom;
+  int32_t dpi;
+};
+
+std::string MonitorTopologyKey(std::vector<MonitorGeometry> monitors);
+
+bool LoadBallPosition(const SettingsStore& settings, std::string_view topologyKey, long* x, long* y);
+void SaveBallPosition(SettingsStore& settings, std::string_view topologyKey, long x, long y);
+
+// 旧版本把位置单独存在 native_floating_ball_pos.txt（"x y"）：还没有任何 pos.* 项时导入到当前拓扑。
+// 导入之后已有 pos.* 项，旧文件不会再被读取。legacyPath 为 UTF-8；返回是否导入
+bool ImportLegacyBallPosition(SettingsStore& settings, std::string_view topologyKey, const std::string& legacyPath);
@@ -0,0 +1,78 @@
+#include "ball_state.h"
+#include <algorithm>
+#include <utility>
+
+void BallState::SetFrameDelays(BallGif gif, std::vector<uint32_t> delaysMs) {
+  m_delays[(size_t)gif] = std::move(delaysMs);
+  if (gif == m_active && m_frameIndex >= FrameCount()) m_frameIndex = 0;
+}
+
+uint32_t BallState::FrameDelayMs(uint32_t frameIndex) const {
+  const std::vector<uint32_t>& delays = m_delays[(size_t)m_active];
+  const uint32_t delay = frameIndex < delays.size() ? delays[frameIndex] : 100u;
+  return (std::max)(delay, m_minFrameDelayMs);
+}
+
+void BallState::SelectGif() {
+  m_active = m_unreadCount > 0 ? BallGif::Dynamic : BallGif::Unread;
+}
+
+uint32_t BallState::Start() {
+  SelectGif();
+  m_frameIndex = 0;
+  return FrameCount() > 0 ? (kBallEffectRestartFrameTimer | kBallEffectRender) : kBallEffectRender;
+}
+
+bool BallState::QueueTasksChanged(const TaskListDiff& diff, int unreadCount) {
+  m_pendingDiff.Accumulate(diff);
+  m_pendingUnread = unreadCount;
+  if (m_flushPending) return false;
+  m_flushPending = true;
+  return true;
+}
+
+uint32_t BallState::FlushTasksChanged() {
+  m_flushPending = false;
+  const TaskListDiff diff = m_pendingDiff;
+  m_pendingDiff.Clear();
+  m_unreadCount = m_pendingUnread;
+
+  uint32_t effects = 0;
+  const BallGif previous = m_active;
+  SelectGif();
+  // 只有切换 GIF 时才重置动画帧，避免每次更新都让动画跳回第一帧
+  if (m_active != previous) {
+    m_frameIndex = 0;
+    if (FrameCount() > 0) effects |= kBallEffectRestartFrameTimer;
+  }
+  // 按 id 增量合并；已显示时只刷新受影响的行，不重新 Show（不重建区域、不重置显隐动画）
+  if (m_bubbleShown && !diff.Empty()) effects |= kBallEffectRefreshBubble;
+  return effects;
+}
+
+uint32_t BallState::OnFrameTimer() {
+  const size_t count = FrameCount();
+  if (count == 0) return 0;
+  m_frameIndex = (uint32_t)((m_frameIndex + 1) % count);
+  return kBallEffectRestartFrameTimer | kBallEffectRender;
+}
+
+uint32_t BallState::OnMouseMove(bool bubbleShowing) {
+  if (m_hovered && bubbleShowing) return 0;
+  m_hovered = true;
+  m_bubbleShown = true;
+  // 气泡还在（刚离开又回来）：只取消隐藏轮询，不重新 Show（不重设位置、区域、亚克力，不重启显示动画）
+  return bubbleShowing ? kBallEffectStopHideTimer : kBallEffectShowBubble;
+}
+
+uint32_t BallState::OnMouseLeave() {
+  m_hovered = false;
+  // 不立即隐藏：给鼠标留出移入气泡（滚动/点击）的时间
+  return kBallEffectStartHideTimer;
+}
+
+uint32_t BallState::OnHideTimer(bool cursorInside) {
+  if (cursorInside) return 0;
+  m_bubbleShown = false;
+  return kBallEffectHideBubble;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "task_list_model.h"
+
+// 悬浮球的状态机（不依赖 Win32）：任务变化的合并、GIF 选择与帧推进、悬停与气泡显隐。
+// 窗口过程（ball_wnd.cpp）和 Linux 上的事件轨迹回放（bench/headless_ball）共用这一份逻辑：
+// 每个输入返回一组 BallEffect，由调用方落实成定时器、重绘与气泡窗口操作。
+enum class BallGif : uint8_t {
+  Unread,  // unread_logo.gif：没有任务
+  Dynamic, // dynamic_logo.gif：有任务
+};
+
+enum BallEffect : uint32_t {
+  kBallEffectRender = 1u << 0,            // 重绘当前帧
+  kBallEffectRestartFrameTimer = 1u << 1, // 以 FrameDelayMs(FrameIndex()) 重新设置帧定时器（没有帧时停止）
+  kBallEffectShowBubble = 1u << 2,        // 显示气泡（同时停止隐藏轮询）
+  kBallEffectRefreshBubble = 1u << 3,     // 气泡已显示：增量刷新受影响的行
+  kBallEffectStartHideTimer = 1u << 4,    // 开始轮询光标是否已离开球与气泡
+  kBallEffectHideBubble = 1u << 5,        // 隐藏气泡并停止隐藏轮询
+  kBallEffectStopHideTimer = 1u << 6,     // 停止隐藏轮询（光标回到球上，气泡仍在显示）
+};
+
+class BallState {
+public:
+  static constexpr uint32_t kHideDelayMs = 250; // 离开后轮询隐藏的间隔
+
+  // 每帧的 GIF 延迟（毫秒）；为空表示该 GIF 没有加载成功
+  void SetFrameDelays(BallGif gif, std::vector<uint32_t> delaysMs);
+  // 帧率档位（frame_profile）对应的帧间隔下限
+  void SetMinFrameDelayMs(uint32_t ms) { m_minFrameDelayMs = ms; }
+
+  BallGif ActiveGif() const { return m_active; }
+  size_t FrameCount() const { return m_delays[(size_t)m_active].size(); }
+  uint32_t FrameIndex() const { return m_frameIndex; }
+  uint32_t FrameDelayMs(uint32_t frameIndex) const;
+  int UnreadCount() const { return m_unreadCount; }
+  bool BubbleShown() const { return m_bubbleShown; }
+  bool Hovered() const { return m_hovered; }
+
+  // 窗口创建、GIF 加载之后调用一次
+  uint32_t Start();
+  // 合并一帧内到达的多次任务变化；返回 true 表示这是本批第一条，调用方安排一次 FlushTasksChanged
+  bool QueueTasksChanged(const TaskListDiff& diff, int unreadCount);
+  uint32_t FlushTasksChanged();
+  bool TasksChangedPending() const { return m_flushPending; }
+
+  uint32_t OnFrameTimer();
+  // 只在悬停状态变化时产生副作用：同一次悬停里的后续移动返回 0。
+  // bubbleShowing：气泡窗口可见且不在隐藏动画中（点击条目、隐藏动画都可能让气泡在状态机之外消失）
+  uint32_t OnMouseMove(bool bubbleShowing);
+  uint32_t OnMouseLeave();
+  // cursorInside：光标仍在球或气泡上
+  uint32_t OnHideTimer(bool cursorInside);
+
+private:
+  void SelectGif();
+
+  std::vector<uint32_t> m_delays[2];
+  uint32_t m_minFrameDelayMs{0};
+  BallGif m_active{BallGif::Unread};
+  uint32_t m_frameIndex{0};
+  int m_unreadCount{0};
+  bool m_bubbleShown{false};
+  bool m_hovered{false};
+  TaskListDiff m_pendingDiff;
+  int m_pendingUnread{0};
+  bool m_flushPending{false};
+};
@@ -0,0 +1,101 @@
+#include "circle_mask.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// round(v * a / 255)，v、a 都在 0..255
+inline uint8_t MulDiv255(uint32_t v, uint32_t a) {
+  const uint32_t t = v * a + 128;
+  return (uint8_t)((t + (t >> 8)) >> 8);
+}
+
+} // namespace
+
+void CircleMask::Build(uint32_t diameter) {
+  m_diameter = diameter;
+  m_coverage.assign((size_t)diameter * diameter, 0);
+  m_spans.assign(diameter, Span{});
+  if (diameter < 3) return;
+
+  const double c = diameter / 2.0;
+  const double r = (diameter - 2.0) / 2.0;
+  const double r2 = r * r;
+  // 像素中心到圆心的距离与 r 相差超过半条对角线时，整个像素都在圆内（或圆外）
+  const double halfDiagonal = std::sqrt(0.5) + 1e-9;
+  const double step = 1.0 / kSubsamples;
+  for (uint32_t y = 0; y < diameter; ++y) {
+    uint8_t* row = m_coverage.data() + (size_t)y * diameter;
+    for (uint32_t x = 0; x < diameter; ++x) {
+      const double dx = x + 0.5 - c, dy = y + 0.5 - c;
+      const double dist = std::sqrt(dx * dx + dy * dy);
+      if (dist <= r - halfDiagonal) {
+        row[x] = 255;
+      } else if (dist < r + halfDiagonal) {
+        int inside = 0;
+        for (int sy = 0; sy < kSubsamples; ++sy) {
+          const double py = y + (sy + 0.5) * step - c;
+          for (int sx = 0; sx < kSubsamples; ++sx) {
+            const double px = x + (sx + 0.5) * step - c;
+            if (px * px + py * py <= r2) ++inside;
+          }
+        }
+        row[x] = (uint8_t)((inside * 255 + kSubsamples * kSubsamples / 2) / (kSubsamples * kSubsamples));
+      }
+    }
+    Span& span = m_spans[y];
+    uint32_t first = 0, last = diameter;
+    while (first < diameter && !row[first]) ++first;
+    while (last > first && !row[last - 1]) --last;
+    uint32_t solidFirst = first, solidLast = last;
+    while (solidFirst < last && row[solidFirst] != 255) ++solidFirst;
+    while (solidLast > solidFirst && row[solidLast - 1] != 255) --solidLast;
+    if (solidFirst >= solidLast) solidFirst = solidLast = first;
+    span = Span{ (uint16_t)first, (uint16_t)last, (uint16_t)solidFirst, (uint16_t)solidLast };
+  }
+}
+
+void CircleMask::Apply(uint8_t* bgra, size_t stride) const {
+  for (uint32_t y = 0; y < m_diameter; ++y) {
+    uint8_t* px = bgra + y * stride;
+    const Span& span = m_spans[y];
+    const uint8_t* cov = Row(y);
+    std::memset(px, 0, (size_t)span.first * 4);
+    std::memset(px + (size_t)span.last * 4, 0, (size_t)(m_diameter - span.last) * 4);
+    const auto edge = [&](uint32_t from, uint32_t to) {
+      for (uint32_t x = from; x < to; ++x) {
+        uint8_t* p = px + (size_t)x * 4;
+        const uint32_t a = cov[x];
+        p[0] = MulDiv255(p[0], a);
+        p[1] = MulDiv255(p[1], a);
+        p[2] = MulDiv255(p[2], a);
+        p[3] = MulDiv255(p[3], a);
+      }
+    };
+    if (span.solidFirst == span.solidLast) {
+      edge(span.first, span.last);
+    } else {
+      edge(span.first, span.solidFirst);
+      edge(span.solidLast, span.last);
+    }
+  }
+}
+
+void CircleMask::Fill(uint32_t argb, uint8_t* bgra, size_t stride) const {
+  const uint32_t a = argb >> 24;
+  const uint8_t b = MulDiv255(argb & 0xFF, a);
+  const uint8_t g = MulDiv255((argb >> 8) & 0xFF, a);
+  const uint8_t r = MulDiv255((argb >> 16) & 0xFF, a);
+  for (uint32_t y = 0; y < m_diameter; ++y) {
+    uint8_t* px = bgra + y * stride;
+    const uint8_t* cov = Row(y);
+    for (uint32_t x = 0; x < m_diameter; ++x) {
+      uint8_t* p = px + (size_t)x * 4;
+      const uint32_t c = cov[x];
+      p[0] = MulDiv255(b, c);
+      p[1] = MulDiv255(g, c);
+      p[2] = MulDiv255(r, c);
+      p[3] = MulDiv255(a, c);
+    }
+  }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 悬浮球的抗锯齿圆形蒙版：每个直径只计算一次，构建显示尺寸帧时乘进像素，
+// 之后每帧绘制不再需要椭圆几何、图层或裁剪（旧版每帧 PushLayer + ID2D1EllipseGeometry）。
+//
+// 圆心在位图中心，半径 (diameter - 2) / 2，与旧版裁剪几何一致（四周留 1px 透明边）。
+// 覆盖率按像素面积计：完全在圆内为 255、完全在圆外为 0，跨越边缘的像素做 16x16 超采样。
+class CircleMask {
+public:
+  static constexpr int kSubsamples = 16;
+
+  // 每行覆盖率非零的区间 [first, last)，以及其中覆盖率为 255 的实心区间 [solidFirst, solidLast)；
+  // 整行透明时 first == last，没有实心像素时 solidFirst == solidLast
+  struct Span {
+    uint16_t first{0};
+    uint16_t last{0};
+    uint16_t solidFirst{0};
+    uint16_t solidLast{0};
+  };
+
+  void Build(uint32_t diameter);
+  uint32_t Diameter() const { return m_diameter; }
+
+  uint8_t Coverage(uint32_t x, uint32_t y) const { return m_coverage[(size_t)y * m_diameter + x]; }
+  const uint8_t* Row(uint32_t y) const { return m_coverage.data() + (size_t)y * m_diameter; }
+  const Span& RowSpan(uint32_t y) const { return m_spans[y]; }
+
+  // 把蒙版乘进一帧 Diameter() x Diameter() 的预乘 BGRA（四个通道同乘）：
+  // 区间外清零，实心区间不动，只有边缘像素做乘法
+  void Apply(uint8_t* bgra, size_t stride) const;
+  // 以非预乘颜色 0xAARRGGBB 填充圆形（没有 GIF 时的纯色圆）
+  void Fill(uint32_t argb, uint8_t* bgra, size_t stride) const;
+
+private:
+  uint32_t m_diameter{0};
+  std::vector<uint8_t> m_coverage;
+  std::vector<Span> m_spans;
+};
@@ -0,0 +1,168 @@
+#include "dispatch_profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+int BucketOf(uint64_t ns) {
+  int log2 = 0;
+  while (ns >> (log2 + 1)) ++log2;
+  return (std::min)((std::max)(log2 - DispatchProfiler::kMinLog2, 0), DispatchProfiler::kBuckets - 1);
+}
+
+void Accumulate(DispatchProfiler::Entry& e, uint64_t ns) {
+  ++e.count;
+  e.totalNs += ns;
+  e.maxNs = (std::max)(e.maxNs, ns);
+  ++e.histogram[BucketOf(ns)];
+}
+
+std::string MessageLabel(uint32_t message) {
+  char buf[48];
+  if (const char* name = WindowMessageName(message)) return name;
+  if (message >= 0xC000u && message <= 0xFFFFu) {
+    std::snprintf(buf, sizeof(buf), "registered 0x%04X", message);
+  } else if (message >= 0x8000u && message < 0xC000u) {
+    std::snprintf(buf, sizeof(buf), "WM_APP+%u", message - 0x8000u);
+  } else if (message >= 0x0400u && message < 0x8000u) {
+    std::snprintf(buf, sizeof(buf), "WM_USER+%u", message - 0x0400u);
+  } else {
+    std::snprintf(buf, sizeof(buf), "0x%04X", message);
+  }
+  return buf;
+}
+
+} // namespace
+
+uint64_t DispatchProfiler::Entry::PercentileNs(double p) const {
+  if (!count) return 0;
+  const uint64_t rank = (uint64_t)(p * (double)(count - 1)) + 1;
+  uint64_t seen = 0;
+  for (int b = 0; b < kBuckets; ++b) {
+    seen += histogram[b];
+    if (seen >= rank) {
+      const uint64_t upper = 1ull << (b + kMinLog2 + 1);
+      return (std::min)(upper, maxNs);
+    }
+  }
+  return maxNs;
+}
+
+void DispatchProfiler::Record(uint32_t message, uint64_t ns) {
+  ++m_total;
+  // 线性探测；消息 ID 低位分布足够分散（常见消息都小于 0x400，注册消息在 0xC000 以上）
+  const size_t start = (size_t)((message * 2654435761u) >> 25) % kCapacity;
+  for (size_t i = 0; i < kCapacity; ++i) {
+    Entry& e = m_entries[(start + i) % kCapacity];
+    if (!e.used) {
+      e.used = true;
+      e.message = message;
+    }
+    if (e.message == message) {
+      Accumulate(e, ns);
+      return;
+    }
+  }
+  Accumulate(m_other, ns);
+}
+
+void DispatchProfiler::Reset() {
+  for (Entry& e : m_entries) e = Entry{};
+  m_other = Entry{};
+  m_total = 0;
+}
+
+const DispatchProfiler::Entry* DispatchProfiler::Find(uint32_t message) const {
+  const size_t start = (size_t)((message * 2654435761u) >> 25) % kCapacity;
+  for (size_t i = 0; i < kCapacity; ++i) {
+    const Entry& e = m_entries[(start + i) % kCapacity];
+    if (!e.used) return nullptr;
+    if (e.message == message) return &e;
+  }
+  return nullptr;
+}
+
+std::string DispatchProfiler::Format() const {
+  std::vector<const Entry*> rows;
+  for (const Entry& e : m_entries) {
+    if (e.used) rows.push_back(&e);
+  }
+  std::sort(rows.begin(), rows.end(), [](const Entry* a, const Entry* b) { return a->totalNs > b->totalNs; });
+  if (m_other.count) rows.push_back(&m_other);
+
+  std::string out;
+  char line[160];
+  std::snprintf(line, sizeof(line), "%-28s %10s %10s %10s %10s %10s %12s\n",
+                "message", "count", "avg_us", "p50_us", "p99_us", "max_us", "total_ms");
+  out += line;
+  for (const Entry* e : rows) {
+    const std::string name = (e == &m_other) ? std::string("(other)") : MessageLabel(e->message);
+    std::snprintf(line, sizeof(line), "%-28s %10llu %10.1f %10.1f %10.1f %10.1f %12.2f\n",
+                  name.c_str(), (unsigned long long)e->count,
+                  e->count ? (double)e->totalNs / (double)e->count / 1000.0 : 0.0,
+                  (double)e->PercentileNs(0.50) / 1000.0, (double)e->PercentileNs(0.99) / 1000.0,
+                  (double)e->maxNs / 1000.0, (double)e->totalNs / 1e6);
+    out += line;
+  }
+  return out;
+}
+
+DispatchProfiler& ProcessDispatchProfiler() {
+  static DispatchProfiler profiler;
+  return profiler;
+}
+
+const char* WindowMessageName(uint32_t message) {
+  switch (message) {
+  case 0x0001: return "WM_CREATE";
+  case 0x0002: return "WM_DESTROY";
+  case 0x0003: return "WM_MOVE";
+  case 0x0005: return "WM_SIZE";
+  case 0x0006: return "WM_ACTIVATE";
+  case 0x0007: return "WM_SETFOCUS";
+  case 0x0008: return "WM_KILLFOCUS";
+  case 0x000F: return "WM_PAINT";
+  case 0x0010: return "WM_CLOSE";
+  case 0x0014: return "WM_ERASEBKGND";
+  case 0x0018: return "WM_SHOWWINDOW";
+  case 0x001A: return "WM_SETTINGCHANGE";
+  case 0x001D: return "WM_FONTCHANGE";
+  case 0x0020: return "WM_SETCURSOR";
+  case 0x0021: return "WM_MOUSEACTIVATE";
+  case 0x0024: return "WM_GETMINMAXINFO";
+  case 0x0046: return "WM_WINDOWPOSCHANGING";
+  case 0x0047: return "WM_WINDOWPOSCHANGED";
+  case 0x004A: return "WM_COPYDATA";
+  case 0x0081: return "WM_NCCREATE";
+  case 0x0082: return "WM_NCDESTROY";
+  case 0x0083: return "WM_NCCALCSIZE";
+  case 0x0084: return "WM_NCHITTEST";
+  case 0x0085: return "WM_NCPAINT";
+  case 0x0086: return "WM_NCACTIVATE";
+  case 0x00A0: return "WM_NCMOUSEMOVE";
+  case 0x00A1: return "WM_NCLBUTTONDOWN";
+  case 0x00A3: return "WM_NCLBUTTONDBLCLK";
+  case 0x0100: return "WM_KEYDOWN";
+  case 0x0101: return "WM_KEYUP";
+  case 0x0102: return "WM_CHAR";
+  case 0x0112: return "WM_SYSCOMMAND";
+  case 0x0113: return "WM_TIMER";
+  case 0x0200: return "WM_MOUSEMOVE";
+  case 0x0201: return "WM_LBUTTONDOWN";
+  case 0x0202: return "WM_LBUTTONUP";
+  case 0x0203: return "WM_LBUTTONDBLCLK";
+  case 0x0204: return "WM_RBUTTONDOWN";
+  case 0x0205: return "WM_RBUTTONUP";
+  case 0x020A: return "WM_MOUSEWHEEL";
+  case 0x0214: return "WM_SIZING";
+  case 0x0216: return "WM_MOVING";
+  case 0x0231: return "WM_ENTERSIZEMOVE";
+  case 0x0232: return "WM_EXITSIZEMOVE";
+  case 0x02A1: return "WM_MOUSEHOVER";
+  case 0x02A3: return "WM_MOUSELEAVE";
+  case 0x02E0: return "WM_DPICHANGED";
+  case 0x031A: return "WM_THEMECHANGED";
+  default: return nullptr;
+  }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 窗口消息分发剖析：按消息类型统计次数与处理耗时的对数直方图（主程序与悬浮球共用，不依赖 Win32）。
+// 每条消息只有两次时钟读取和一次小表查找，常开不影响交互；只在 UI 线程上使用，不加锁。
+//
+// 直方图第 b 桶覆盖 [2^(b+kMinLog2), 2^(b+kMinLog2+1)) 纳秒，首尾桶兜底；分位数取桶上界（保守估计）。
+// 表满后新出现的消息类型计入 Other()，不会动态分配。
+//
+// 按需导出：向进程内任一顶层窗口发送注册消息 kDispatchDumpMessageName，
+// 悬浮球写入日志文件；主程序经方法通道 dumpDispatchProfile 返回文本。
+constexpr wchar_t kDispatchDumpMessageName[] = L"ChatDesktop.DumpDispatchProfile";
+
+class DispatchProfiler {
+public:
+  static constexpr int kBuckets = 24;
+  static constexpr int kMinLog2 = 8; // 256ns 以下都落在第 0 桶
+  static constexpr size_t kCapacity = 128;
+
+  struct Entry {
+    uint32_t message{0};
+    bool used{false};
+    uint64_t count{0};
+    uint64_t totalNs{0};
+    uint64_t maxNs{0};
+    uint32_t histogram[kBuckets]{};
+
+    uint64_t PercentileNs(double p) const;
+  };
+
+  // RAII：构造时取时间，析构时记一次
+  class Scope {
+  public:
+    Scope(DispatchProfiler& profiler, uint32_t message)
+      : m_profiler(profiler), m_message(message), m_start(std::chrono::steady_clock::now()) {}
+    ~Scope() {
+      const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - m_start).count();
+      m_profiler.Record(m_message, ns > 0 ? (uint64_t)ns : 0);
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    DispatchProfiler& m_profiler;
+    uint32_t m_message;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  void Record(uint32_t message, uint64_t ns);
+  void Reset();
+
+  const Entry* Find(uint32_t message) const;
+  const Entry& Other() const { return m_other; }
+  uint64_t TotalCount() const { return m_total; }
+
+  // 按累计耗时降序的文本报告：消息名、次数、平均/p50/p99/最大耗时（微秒）
+  std::string Format() const;
+
+private:
+  Entry m_entries[kCapacity];
+  Entry m_other;
+  uint64_t m_total{0};
+};
+
+// 进程内共享的实例（所有窗口过程都记到这里）
+DispatchProfiler& ProcessDispatchProfiler();
+
+// 常见窗口消息的名称（数值是稳定的 Win32 ABI，这里无需包含 windows.h）；
+// 未收录的返回 nullptr，报告中按 WM_USER+n / WM_APP+n / registered 0x.... 显示
+const char* WindowMessageName(uint32_t message);
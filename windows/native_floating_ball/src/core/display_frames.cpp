@@ -0,0 +1,66 @@
+#include "display_frames.h"
+#include <algorithm>
+#include "gif_decoder.h"
+
+bool DisplayFrames::Build(const uint8_t* gif, size_t size, const CircleMask& mask) {
+  Clear();
+  GifDecoder decoder;
+  if (!decoder.Open(gif, size) || !decoder.FrameCount()) return false;
+  if (!Begin(decoder.Width(), decoder.Height(), mask, decoder.FrameCount())) return false;
+  while (const uint8_t* canvas = decoder.ComposeNext()) {
+    AddCanvas(canvas, (size_t)decoder.Width() * 4, decoder.DelayMs(decoder.NextIndex() - 1));
+  }
+  return Finish();
+}
+
+bool DisplayFrames::Begin(uint32_t sourceWidth, uint32_t sourceHeight, const CircleMask& mask, size_t frameCountHint) {
+  Clear();
+  const uint32_t d = mask.Diameter();
+  if (!d || !sourceWidth || !sourceHeight) return false;
+  m_diameter = d;
+  m_sourceWidth = sourceWidth;
+  m_sourceHeight = sourceHeight;
+  m_mask = &mask;
+  if (!m_scaler.IsConfigured(sourceWidth, sourceHeight, d, d)) m_scaler.Configure(sourceWidth, sourceHeight, d, d);
+  m_pixels.reserve(frameCountHint * FrameBytes());
+  m_delaysMs.reserve(frameCountHint);
+  m_maxAlpha.assign((size_t)d * d, 0);
+  return true;
+}
+
+void DisplayFrames::AddCanvas(const uint8_t* canvas, size_t stride, uint32_t delayMs) {
+  if (!m_mask || !canvas) return;
+  const uint32_t d = m_diameter;
+  const size_t offset = m_pixels.size();
+  m_pixels.resize(offset + FrameBytes());
+  uint8_t* frame = m_pixels.data() + offset;
+  m_scaler.Scale(canvas, stride, frame, (size_t)d * 4);
+  m_mask->Apply(frame, (size_t)d * 4);
+  for (size_t i = 0; i < m_maxAlpha.size(); ++i) m_maxAlpha[i] = (std::max)(m_maxAlpha[i], frame[i * 4 + 3]);
+  m_delaysMs.push_back(delayMs);
+}
+
+bool DisplayFrames::Finish() {
+  m_mask = nullptr;
+  if (m_delaysMs.empty()) {
+    Clear();
+    return false;
+  }
+  m_hit.Build(m_maxAlpha.data(), m_diameter, m_diameter, m_diameter, 1);
+  m_maxAlpha.clear();
+  m_maxAlpha.shrink_to_fit();
+  return true;
+}
+
+void DisplayFrames::Clear() {
+  m_pixels.clear();
+  m_pixels.shrink_to_fit();
+  m_delaysMs.clear();
+  m_hit.Clear();
+  m_diameter = 0;
+  m_sourceWidth = 0;
+  m_sourceHeight = 0;
+  m_mask = nullptr;
+  m_maxAlpha.clear();
+  m_maxAlpha.shrink_to_fit();
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "circle_mask.h"
+#include "hit_mask.h"
+#include "image_scale.h"
+
+// 悬浮球的显示尺寸帧：加载时逐帧合成 GIF、按 cover 缩放到直径并乘上圆形蒙版，只保留结果。
+// 每帧绘制就是把一帧 diameter x diameter 的预乘 BGRA 拷进 DIB，不再上传整张画布、不再缩放或裁剪；
+// 常驻内存也从“帧数 x 画布”降为“帧数 x 直径²”。直径变化时须重新 Build。
+// 同时生成命中区域：取所有帧 alpha 的最大值，动画播放时可点击的形状不随帧变化（悬停不会因换帧而闪断）。
+//
+// 合成好的画布可以逐帧送入（Begin / AddCanvas / Finish）：悬浮球用 WIC 解码合成后按此接口输入；
+// Build 用 core/gif_decoder 解码同一份文件，供基准测试与无窗口运行（Linux）使用。
+class DisplayFrames {
+public:
+  // gif 为文件内容；mask 的直径即输出尺寸。失败（数据无法解析、没有帧）时清空并返回 false
+  bool Build(const uint8_t* gif, size_t size, const CircleMask& mask);
+
+  // 逐帧输入：画布为 sourceWidth x sourceHeight 的预乘 BGRA。mask 须在 Finish 之前保持有效；
+  // frameCountHint 只用于预留内存。Finish 在没有帧时清空并返回 false
+  bool Begin(uint32_t sourceWidth, uint32_t sourceHeight, const CircleMask& mask, size_t frameCountHint);
+  void AddCanvas(const uint8_t* canvas, size_t stride, uint32_t delayMs);
+  bool Finish();
+
+  void Clear();
+
+  size_t FrameCount() const { return m_delaysMs.size(); }
+  uint32_t Diameter() const { return m_diameter; }
+  size_t FrameBytes() const { return (size_t)m_diameter * m_diameter * 4; }
+  const uint8_t* Frame(size_t index) const { return m_pixels.data() + index * FrameBytes(); }
+  const std::vector<uint32_t>& DelaysMs() const { return m_delaysMs; }
+  const HitMask& Hit() const { return m_hit; }
+  size_t Bytes() const { return m_pixels.capacity() + m_hit.Bytes(); }
+  // GIF 画布尺寸（诊断用）
+  uint32_t SourceWidth() const { return m_sourceWidth; }
+  uint32_t SourceHeight() const { return m_sourceHeight; }
+
+private:
+  std::vector<uint8_t> m_pixels; // 帧连续存放，行距 diameter * 4
+  std::vector<uint32_t> m_delaysMs;
+  uint32_t m_diameter{0};
+  uint32_t m_sourceWidth{0}, m_sourceHeight{0};
+  HitMask m_hit;
+  CoverScaler m_scaler;
+  const CircleMask* m_mask{nullptr}; // Begin 到 Finish 之间有效
+  std::vector<uint8_t> m_maxAlpha;   // 同上：逐像素 alpha 最大值
+};
@@ -0,0 +1,165 @@
+#include "event_trace.h"
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+void PutVarint(std::vector<uint8_t>& out, uint64_t v) {
+  while (v >= 0x80) {
+    out.push_back((uint8_t)(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back((uint8_t)v);
+}
+
+bool GetVarint(const uint8_t* data, size_t size, size_t* pos, uint64_t* out) {
+  uint64_t v = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (*pos >= size) return false;
+    const uint8_t byte = data[(*pos)++];
+    v |= (uint64_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      *out = v;
+      return true;
+    }
+  }
+  return false;
+}
+
+std::FILE* OpenForWrite(const std::string& utf8) {
+  const std::filesystem::path path = std::filesystem::u8path(utf8);
+#ifdef _WIN32
+  return _wfopen(path.c_str(), L"wb");
+#else
+  return std::fopen(path.c_str(), "wb");
+#endif
+}
+
+} // namespace
+
+const char* TraceEventKindName(TraceEventKind kind) {
+  switch (kind) {
+  case TraceEventKind::MouseMove: return "mouse_move";
+  case TraceEventKind::MouseLeave: return "mouse_leave";
+  case TraceEventKind::FrameTimer: return "frame_timer";
+  case TraceEventKind::HideTimer: return "hide_timer";
+  case TraceEventKind::CopyData: return "copy_data";
+  case TraceEventKind::SnapshotPublished: return "snapshot";
+  case TraceEventKind::TasksFlush: return "tasks_flush";
+  case TraceEventKind::DpiChanged: return "dpi_changed";
+  case TraceEventKind::DisplayChange: return "display_change";
+  default: return "unknown";
+  }
+}
+
+void EventTraceEncoder::Reset() {
+  m_data.assign(kEventTraceMagic, kEventTraceMagic + 4);
+  m_data.push_back(kEventTraceVersion);
+  m_data.insert(m_data.end(), 3, 0);
+  m_headerBytes = m_data.size();
+  m_lastUs = 0;
+}
+
+void EventTraceEncoder::Append(TraceEventKind kind, uint64_t timeUs, uint32_t a, uint32_t b,
+                               const void* payload, size_t payloadSize) {
+  if (timeUs < m_lastUs) timeUs = m_lastUs;
+  m_data.push_back((uint8_t)kind);
+  PutVarint(m_data, timeUs - m_lastUs);
+  PutVarint(m_data, a);
+  PutVarint(m_data, b);
+  if (!payload) payloadSize = 0;
+  PutVarint(m_data, payloadSize);
+  if (payloadSize) {
+    const uint8_t* p = static_cast<const uint8_t*>(payload);
+    m_data.insert(m_data.end(), p, p + payloadSize);
+  }
+  m_lastUs = timeUs;
+}
+
+void EventTraceEncoder::TakeRecords(std::vector<uint8_t>* out) {
+  out->assign(m_data.begin() + m_headerBytes, m_data.end());
+  m_data.resize(m_headerBytes);
+}
+
+bool EventTraceReader::Open(const uint8_t* data, size_t size) {
+  m_data = nullptr;
+  m_size = 0;
+  if (!data || size < 8 || std::memcmp(data, kEventTraceMagic, 4) != 0 || data[4] != kEventTraceVersion) {
+    return false;
+  }
+  m_data = data;
+  m_size = size;
+  Rewind();
+  return true;
+}
+
+void EventTraceReader::Rewind() {
+  m_pos = 8;
+  m_timeUs = 0;
+  m_truncated = false;
+}
+
+bool EventTraceReader::Next(TraceEvent* out) {
+  if (!m_data || m_pos >= m_size) return false;
+  size_t pos = m_pos;
+  const uint8_t kind = m_data[pos++];
+  uint64_t delta = 0, a = 0, b = 0, length = 0;
+  if (!GetVarint(m_data, m_size, &pos, &delta) || !GetVarint(m_data, m_size, &pos, &a) ||
+      !GetVarint(m_data, m_size, &pos, &b) || !GetVarint(m_data, m_size, &pos, &length) ||
+      length > m_size - pos) {
+    m_truncated = true;
+    m_pos = m_size;
+    return false;
+  }
+  m_timeUs += delta;
+  out->kind = (TraceEventKind)kind;
+  out->timeUs = m_timeUs;
+  out->a = (uint32_t)a;
+  out->b = (uint32_t)b;
+  out->payload = length ? m_data + pos : nullptr;
+  out->payloadSize = (size_t)length;
+  m_pos = pos + (size_t)length;
+  return true;
+}
+
+bool EventTraceWriter::Open(const std::string& path, size_t maxBytes) {
+  Close();
+  m_file = OpenForWrite(path);
+  if (!m_file) return false;
+  m_encoder.Reset();
+  const std::vector<uint8_t>& header = m_encoder.Data();
+  m_written = std::fwrite(header.data(), 1, header.size(), m_file);
+  m_maxBytes = maxBytes;
+  m_recorded = 0;
+  m_dropped = 0;
+  m_start = std::chrono::steady_clock::now();
+  return true;
+}
+
+void EventTraceWriter::Close() {
+  if (!m_file) return;
+  Flush();
+  std::fclose(m_file);
+  m_file = nullptr;
+}
+
+void EventTraceWriter::Record(TraceEventKind kind, uint32_t a, uint32_t b, const void* payload, size_t payloadSize) {
+  if (!m_file) return;
+  const size_t pending = m_encoder.Data().size();
+  if (m_written + pending + payloadSize + 32 > m_maxBytes) {
+    ++m_dropped;
+    return;
+  }
+  const uint64_t us = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - m_start).count();
+  m_encoder.Append(kind, us, a, b, payload, payloadSize);
+  ++m_recorded;
+  if (m_encoder.Data().size() >= kChunkBytes) Flush();
+}
+
+void EventTraceWriter::Flush() {
+  if (!m_file) return;
+  m_encoder.TakeRecords(&m_chunk);
+  if (!m_chunk.empty()) m_written += std::fwrite(m_chunk.data(), 1, m_chunk.size(), m_file);
+  std::fflush(m_file);
+}
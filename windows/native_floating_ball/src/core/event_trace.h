@@ -0,0 +1,111 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// 悬浮球输入 / IPC 事件轨迹（.nfbt）：现场录下到达悬浮球的事件，回放工具在 Linux 上
+// 按同样的顺序与时间间隔喂给 BallState 与无窗口渲染器，录到的问题场景因此可以变成回归基准。
+//
+// 格式：文件头 "NFBT" + 版本（1 字节）+ 3 字节保留；之后每条记录为
+//   kind(1 字节) | 距上一条的微秒数(varint) | a(varint) | b(varint) | 负载长度(varint) | 负载
+// a / b 的含义见 TraceEventKind。时间戳用单调时钟，从 Open 开始计。
+//
+// 开启录制：环境变量 CHAT_DESKTOP_EVENT_TRACE 指向目录时，悬浮球写入
+// <目录>/native_floating_ball_events_<pid>.nfbt（达到大小上限后停止录制）。
+enum class TraceEventKind : uint8_t {
+  MouseMove = 1,         // a = x, b = y（客户区坐标）
+  MouseLeave = 2,
+  FrameTimer = 3,
+  HideTimer = 4,         // a = 光标是否仍在球或气泡上
+  CopyData = 5,          // a = dwData，负载 = lpData
+  SnapshotPublished = 6, // 负载 = 从共享内存读出的快照（读取失败时不记录）
+  TasksFlush = 7,        // 合并后的任务变化落地（投递的 kMsgTasksChanged）
+  DpiChanged = 8,        // a = 新 DPI，b = 建议的窗口宽度
+  DisplayChange = 9,     // 分辨率 / 缩放 / 任务栏变化
+};
+
+constexpr char kEventTraceMagic[4] = { 'N', 'F', 'B', 'T' };
+constexpr uint8_t kEventTraceVersion = 1;
+
+// 轨迹中的小写名称（回放报告、基准 label 共用）；未知类型返回 "unknown"
+const char* TraceEventKindName(TraceEventKind kind);
+
+struct TraceEvent {
+  TraceEventKind kind{TraceEventKind::MouseMove};
+  uint64_t timeUs{0};
+  uint32_t a{0};
+  uint32_t b{0};
+  const uint8_t* payload{nullptr}; // 指向轨迹数据，读取期间有效
+  size_t payloadSize{0};
+};
+
+// 内存中的编码器：先写文件头，之后逐条追加（基准里合成轨迹也用它）
+class EventTraceEncoder {
+public:
+  EventTraceEncoder() { Reset(); }
+  void Reset();
+  // timeUs 须单调不减（更早的时间按与上一条相同处理）
+  void Append(TraceEventKind kind, uint64_t timeUs, uint32_t a = 0, uint32_t b = 0,
+              const void* payload = nullptr, size_t payloadSize = 0);
+  const std::vector<uint8_t>& Data() const { return m_data; }
+  // 取出文件头之后已编码的部分并清空（文件写入器分块落盘用）
+  void TakeRecords(std::vector<uint8_t>* out);
+
+private:
+  std::vector<uint8_t> m_data;
+  uint64_t m_lastUs{0};
+  size_t m_headerBytes{0};
+};
+
+class EventTraceReader {
+public:
+  // data 须在读取期间保持有效；文件头不对时返回 false
+  bool Open(const uint8_t* data, size_t size);
+  // 读出下一条；结束或数据截断时返回 false，截断时 Truncated() 为 true
+  bool Next(TraceEvent* out);
+  bool Truncated() const { return m_truncated; }
+  void Rewind();
+
+private:
+  const uint8_t* m_data{nullptr};
+  size_t m_size{0};
+  size_t m_pos{0};
+  uint64_t m_timeUs{0};
+  bool m_truncated{false};
+};
+
+// 录制到文件：UI 线程调用，编码进内存缓冲，每满 kChunkBytes 追加写一次
+class EventTraceWriter {
+public:
+  static constexpr size_t kChunkBytes = 64 * 1024;
+
+  EventTraceWriter() = default;
+  ~EventTraceWriter() { Close(); }
+  EventTraceWriter(const EventTraceWriter&) = delete;
+  EventTraceWriter& operator=(const EventTraceWriter&) = delete;
+
+  // path 为 UTF-8；超过 maxBytes 后不再记录（Dropped 计数）
+  bool Open(const std::string& path, size_t maxBytes = 32u << 20);
+  void Close();
+  bool IsOpen() const { return m_file != nullptr; }
+
+  void Record(TraceEventKind kind, uint32_t a = 0, uint32_t b = 0, const void* payload = nullptr,
+              size_t payloadSize = 0);
+  void Flush();
+
+  uint64_t Recorded() const { return m_recorded; }
+  uint64_t Dropped() const { return m_dropped; }
+
+private:
+  std::FILE* m_file{nullptr};
+  EventTraceEncoder m_encoder;
+  std::vector<uint8_t> m_chunk;
+  std::chrono::steady_clock::time_point m_start;
+  size_t m_written{0};
+  size_t m_maxBytes{0};
+  uint64_t m_recorded{0};
+  uint64_t m_dropped{0};
+};
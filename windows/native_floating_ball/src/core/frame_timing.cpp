@@ -0,0 +1,118 @@
+#include "frame_timing.h"
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+constexpr uint64_t kFpsWindowNs = 1000000000;
+
+} // namespace
+
+const char* FrameStageName(FrameStage stage) {
+  switch (stage) {
+  case FrameStage::BallSelect: return "ball.select";
+  case FrameStage::BallDraw: return "ball.draw";
+  case FrameStage::BallEndDraw: return "ball.end_draw";
+  case FrameStage::BallPresent: return "ball.present";
+  case FrameStage::BubbleLayout: return "bubble.layout";
+  case FrameStage::BubbleDraw: return "bubble.draw";
+  case FrameStage::BubbleEndDraw: return "bubble.end_draw";
+  default: return "unknown";
+  }
+}
+
+const char* FrameSurfaceName(FrameSurface surface) {
+  return surface == FrameSurface::Ball ? "ball" : surface == FrameSurface::Bubble ? "bubble" : "unknown";
+}
+
+uint64_t FrameTimings::NowNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void FrameTimings::Record(FrameStage stage, uint64_t ns) {
+  m_stages[(size_t)stage].Record(ns);
+}
+
+void FrameTimings::FramePresented(FrameSurface surface, uint64_t nowNs, uint64_t frameNs, uint64_t budgetNs) {
+  Surface& s = m_surfaces[(size_t)surface];
+  s.frame.Record(frameNs);
+  if (budgetNs && s.lastPresentNs && nowNs > s.lastPresentNs) {
+    const uint64_t interval = nowNs - s.lastPresentNs;
+    s.interval.Record(interval);
+    if (interval > budgetNs + kLateSlackNs) ++s.missed;
+  }
+  s.lastPresentNs = nowNs;
+
+  // 窗口起点那一帧不计入：之后的窗口都从上一个窗口的最后一帧开始，只数其后的帧
+  if (!s.fpsWindowStartNs) {
+    s.fpsWindowStartNs = nowNs;
+    return;
+  }
+  ++s.fpsWindowFrames;
+  if (nowNs - s.fpsWindowStartNs >= kFpsWindowNs) {
+    s.fps = (double)s.fpsWindowFrames * 1e9 / (double)(nowNs - s.fpsWindowStartNs);
+    s.fpsWindowStartNs = nowNs;
+    s.fpsWindowFrames = 0;
+  }
+}
+
+bool FrameTimings::SummaryDue(uint64_t nowNs) const {
+  if (!m_summaryIntervalNs) return false;
+  if (!m_periodStartNs) return false; // 尚未 Reset 过：以第一次 Reset 为周期起点
+  return nowNs - m_periodStartNs >= m_summaryIntervalNs;
+}
+
+void FrameTimings::Reset(uint64_t nowNs) {
+  for (HdrHistogram& h : m_stages) h.Reset();
+  for (Surface& s : m_surfaces) {
+    s.frame.Reset();
+    s.interval.Reset();
+    s.missed = 0;
+  }
+  m_periodStartNs = nowNs;
+}
+
+std::string FrameTimings::Format(uint64_t nowNs) const {
+  std::string out;
+  char line[160];
+  std::snprintf(line, sizeof(line), "frame timings over %.1f s\n",
+                m_periodStartNs && nowNs > m_periodStartNs ? (double)(nowNs - m_periodStartNs) / 1e9 : 0.0);
+  out += line;
+  std::snprintf(line, sizeof(line), "%-16s %8s %8s %8s %12s %12s %12s\n",
+                "surface", "frames", "missed", "fps", "frame_p99_us", "gap_p50_ms", "gap_p99_ms");
+  out += line;
+  for (size_t i = 0; i < (size_t)FrameSurface::kCount; ++i) {
+    const Surface& s = m_surfaces[i];
+    std::snprintf(line, sizeof(line), "%-16s %8llu %8llu %8.1f %12.1f %12.1f %12.1f\n",
+                  FrameSurfaceName((FrameSurface)i), (unsigned long long)s.frame.Count(),
+                  (unsigned long long)s.missed, s.fps, (double)s.frame.Percentile(0.99) / 1000.0,
+                  (double)s.interval.Percentile(0.5) / 1e6, (double)s.interval.Percentile(0.99) / 1e6);
+    out += line;
+  }
+  std::snprintf(line, sizeof(line), "%-16s %8s %8s %8s %12s %12s\n",
+                "stage", "count", "mean_us", "p50_us", "p99_us", "max_us");
+  out += line;
+  for (size_t i = 0; i < (size_t)FrameStage::kCount; ++i) {
+    const HdrHistogram& h = m_stages[i];
+    if (!h.Count()) continue;
+    std::snprintf(line, sizeof(line), "%-16s %8llu %8.1f %8.1f %12.1f %12.1f\n",
+                  FrameStageName((FrameStage)i), (unsigned long long)h.Count(), h.Mean() / 1000.0,
+                  (double)h.Percentile(0.5) / 1000.0, (double)h.Percentile(0.99) / 1000.0,
+                  (double)h.Max() / 1000.0);
+    out += line;
+  }
+  return out;
+}
+
+std::string FrameTimings::OverlayText(FrameSurface surface) const {
+  const Surface& s = m_surfaces[(size_t)surface];
+  char text[48];
+  std::snprintf(text, sizeof(text), "%.0f fps p99 %.1fms", s.fps, (double)s.frame.Percentile(0.99) / 1e6);
+  return text;
+}
+
+FrameTimings& ProcessFrameTimings() {
+  static FrameTimings timings;
+  return timings;
+}
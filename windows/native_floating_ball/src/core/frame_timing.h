@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "hdr_histogram.h"
+
+// 悬浮球与气泡的帧耗时统计（不依赖 Win32）：按阶段记录 HDR 直方图，按窗口统计帧间隔、
+// 错过预定间隔的次数与最近一秒的帧率。每个阶段只多两次时钟读取，常开；只在 UI 线程上使用，不加锁。
+//
+// 输出：每个汇总周期（设置项 frame_stats_interval_s）写一次日志，收到 kDispatchDumpMessageName 时随消息剖析一起写出；
+// 设置项 debug_overlay 为 1 时悬浮球在球面上叠加帧率与 p99。
+enum class FrameStage : uint8_t {
+  BallSelect,    // 取当前帧：WIC 格式转换 + 创建位图
+  BallDraw,      // 其余绘制命令（清屏、圆形裁剪、缩放绘制）
+  BallEndDraw,
+  BallPresent,   // UpdateLayeredWindow
+  BubbleLayout,  // 可见行排版（命中缓存时只是查表）
+  BubbleDraw,    // 其余绘制命令
+  BubbleEndDraw, // HWND 渲染目标的 EndDraw（包含呈现）
+  kCount,
+};
+
+enum class FrameSurface : uint8_t { Ball, Bubble, kCount };
+
+const char* FrameStageName(FrameStage stage);
+const char* FrameSurfaceName(FrameSurface surface);
+
+class FrameTimings {
+public:
+  // 系统定时器粒度约 15.6ms：比预定间隔晚一个 tick 以上才算错过
+  static constexpr uint64_t kLateSlackNs = 16000000;
+
+  static uint64_t NowNs();
+
+  void Record(FrameStage stage, uint64_t ns);
+  // 一帧已呈现：frameNs 为这一帧的总耗时，budgetNs 为它与上一帧之间的预定间隔
+  // （GIF 帧延迟、气泡动画的 16ms）；0 表示按需重绘，不计入间隔与错过统计
+  void FramePresented(FrameSurface surface, uint64_t nowNs, uint64_t frameNs, uint64_t budgetNs);
+
+  const HdrHistogram& Stage(FrameStage stage) const { return m_stages[(size_t)stage]; }
+  const HdrHistogram& Frame(FrameSurface surface) const { return m_surfaces[(size_t)surface].frame; }
+  const HdrHistogram& Interval(FrameSurface surface) const { return m_surfaces[(size_t)surface].interval; }
+  uint64_t Missed(FrameSurface surface) const { return m_surfaces[(size_t)surface].missed; }
+  // 最近一个完整秒的帧率
+  double Fps(FrameSurface surface) const { return m_surfaces[(size_t)surface].fps; }
+
+  // 汇总周期；0 表示不做周期汇总
+  void SetSummaryInterval(uint64_t ns) { m_summaryIntervalNs = ns; }
+  bool SummaryDue(uint64_t nowNs) const;
+  // 清空直方图与计数，开始新的汇总周期（帧率窗口不受影响）
+  void Reset(uint64_t nowNs);
+
+  // 多行文本：每个窗口的帧数 / 错过数 / 间隔分位数，每个阶段的均值与 p50 / p99 / 最大（微秒）
+  std::string Format(uint64_t nowNs) const;
+  // 叠加层用的单行文字，例如 "24 fps p99 3.1ms"
+  std::string OverlayText(FrameSurface surface) const;
+
+private:
+  struct Surface {
+    HdrHistogram frame;
+    HdrHistogram interval;
+    uint64_t missed{0};
+    uint64_t lastPresentNs{0};
+    uint64_t fpsWindowStartNs{0};
+    uint32_t fpsWindowFrames{0};
+    double fps{0.0};
+  };
+
+  HdrHistogram m_stages[(size_t)FrameStage::kCount];
+  Surface m_surfaces[(size_t)FrameSurface::kCount];
+  uint64_t m_periodStartNs{0};
+  uint64_t m_summaryIntervalNs{0};
+};
+
+// 进程内共享的实例（悬浮球与气泡都记到这里）
+FrameTimings& ProcessFrameTimings();
@@ -0,0 +1,281 @@
+#include "gif_decoder.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+uint16_t ReadU16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// 跳过一串数据子块（以长度 0 的块结束）；截断时返回 false
+bool SkipSubBlocks(const uint8_t* data, size_t size, size_t* pos) {
+  size_t p = *pos;
+  for (;;) {
+    if (p >= size) return false;
+    const uint8_t len = data[p++];
+    if (len == 0) break;
+    if (size - p < len) return false;
+    p += len;
+  }
+  *pos = p;
+  return true;
+}
+
+} // namespace
+
+bool GifDecoder::Open(const uint8_t* data, size_t size) {
+  m_data = data;
+  m_size = size;
+  m_width = m_height = 0;
+  m_globalPalette = 0;
+  m_globalPaletteSize = 0;
+  m_frames.clear();
+  m_next = 0;
+  if (!data || size < 13) return false;
+  if (std::memcmp(data, "GIF87a", 6) != 0 && std::memcmp(data, "GIF89a", 6) != 0) return false;
+
+  uint32_t width = ReadU16(data + 6);
+  uint32_t height = ReadU16(data + 8);
+  const uint8_t packed = data[10];
+  size_t pos = 13;
+  if (packed & 0x80) {
+    m_globalPaletteSize = (uint16_t)(1u << ((packed & 7) + 1));
+    if (size - pos < (size_t)m_globalPaletteSize * 3) return false;
+    m_globalPalette = pos;
+    pos += (size_t)m_globalPaletteSize * 3;
+  }
+
+  FrameInfo pending; // 图形控制扩展作用于紧随其后的那一帧
+  while (pos < size) {
+    const uint8_t introducer = data[pos++];
+    if (introducer == 0x3B) break; // trailer
+    if (introducer == 0x21) {
+      if (pos >= size) break;
+      const uint8_t label = data[pos++];
+      if (label == 0xF9 && pos + 6 <= size && data[pos] == 4) {
+        const uint8_t gce = data[pos + 1];
+        pending.disposal = (uint8_t)((gce >> 2) & 7);
+        const uint32_t delayMs = ReadU16(data + pos + 2) * 10u;
+        pending.delayMs = delayMs < 10 ? 100 : delayMs;
+        pending.transparent = (gce & 1) ? (int16_t)data[pos + 4] : (int16_t)-1;
+      }
+      if (!SkipSubBlocks(data, size, &pos)) break;
+      continue;
+    }
+    if (introducer != 0x2C || size - pos < 9) break; // 未知块：之后的数据不可信
+
+    FrameInfo frame = pending;
+    pending = FrameInfo{};
+    frame.left = ReadU16(data + pos);
+    frame.top = ReadU16(data + pos + 2);
+    frame.width = ReadU16(data + pos + 4);
+    frame.height = ReadU16(data + pos + 6);
+    const uint8_t imagePacked = data[pos + 8];
+    pos += 9;
+    frame.interlaced = (imagePacked & 0x40) != 0;
+    if (imagePacked & 0x80) {
+      frame.paletteSize = (uint16_t)(1u << ((imagePacked & 7) + 1));
+      if (size - pos < (size_t)frame.paletteSize * 3) break;
+      frame.paletteOffset = pos;
+      pos += (size_t)frame.paletteSize * 3;
+    } else {
+      frame.paletteOffset = m_globalPalette;
+      frame.paletteSize = m_globalPaletteSize;
+    }
+    if (pos >= size) break;
+    frame.dataOffset = pos++;
+    if (!SkipSubBlocks(data, size, &pos)) break;
+    m_frames.push_back(frame);
+  }
+  if (m_frames.empty()) return false;
+
+  // 逻辑画布为 0 时退回到第一帧的尺寸
+  if (width == 0 || height == 0) {
+    width = m_frames[0].left + m_frames[0].width;
+    height = m_frames[0].top + m_frames[0].height;
+  }
+  if (width == 0 || height == 0 || width > kMaxDimension || height > kMaxDimension) {
+    m_frames.clear();
+    return false;
+  }
+  m_width = width;
+  m_height = height;
+  Rewind();
+  return true;
+}
+
+uint32_t GifDecoder::DelayMs(size_t index) const {
+  return index < m_frames.size() ? m_frames[index].delayMs : 100;
+}
+
+void GifDecoder::Rewind() {
+  m_canvas.assign((size_t)m_width * m_height * 4, 0);
+  m_saved.clear();
+  m_next = 0;
+}
+
+const uint8_t* GifDecoder::ComposeNext() {
+  if (m_next >= m_frames.size()) return nullptr;
+  // 上一帧的 Disposal 在它显示之后、本帧绘制之前生效
+  if (m_next > 0) {
+    const FrameInfo& prev = m_frames[m_next - 1];
+    if (prev.disposal == 2) {
+      ClearRect(prev);
+    } else if (prev.disposal == 3 && m_saved.size() == m_canvas.size()) {
+      m_canvas.swap(m_saved);
+    }
+  }
+  const FrameInfo& frame = m_frames[m_next++];
+  if (frame.disposal == 3) m_saved = m_canvas;
+  if (DecodeIndices(frame)) Blit(frame);
+  return m_canvas.data();
+}
+
+bool GifDecoder::DecodeIndices(const FrameInfo& frame) {
+  const size_t total = (size_t)frame.width * frame.height;
+  if (total == 0) return false;
+  const uint8_t minCodeSize = m_data[frame.dataOffset];
+  if (minCodeSize < 2 || minCodeSize > 11) return false;
+
+  // 子块拼接成连续码流
+  m_codes.clear();
+  for (size_t p = frame.dataOffset + 1; p < m_size;) {
+    const uint8_t len = m_data[p++];
+    if (len == 0 || m_size - p < len) break;
+    m_codes.insert(m_codes.end(), m_data + p, m_data + p + len);
+    p += len;
+  }
+
+  // 码表：每个码记录前缀码、末字节、首字节与串长；输出时从尾到头直接写入目标位置
+  static thread_local uint16_t prefix[4096];
+  static thread_local uint8_t suffix[4096];
+  static thread_local uint8_t first[4096];
+  static thread_local uint16_t length[4096];
+  const uint32_t clear = 1u << minCodeSize;
+  const uint32_t eoi = clear + 1;
+  for (uint32_t i = 0; i < clear; ++i) {
+    suffix[i] = first[i] = (uint8_t)i;
+    length[i] = 1;
+  }
+
+  m_indices.assign(total, 0);
+  uint8_t* out = m_indices.data();
+  size_t pos = 0;
+  uint32_t codeSize = minCodeSize + 1u;
+  uint32_t next = clear + 2;
+  int32_t prev = -1;
+  uint32_t bits = 0, bitCount = 0;
+  size_t in = 0;
+  const auto emit = [&](uint32_t code) {
+    const size_t end = pos + length[code];
+    size_t i = end;
+    while (i > pos) {
+      --i;
+      if (i < total) out[i] = suffix[code];
+      code = prefix[code];
+    }
+    pos = end;
+  };
+
+  while (pos < total) {
+    while (bitCount < codeSize && in < m_codes.size()) {
+      bits |= (uint32_t)m_codes[in++] << bitCount;
+      bitCount += 8;
+    }
+    if (bitCount < codeSize) break; // 码流提前结束：保留已解出的部分
+    const uint32_t code = bits & ((1u << codeSize) - 1);
+    bits >>= codeSize;
+    bitCount -= codeSize;
+
+    if (code == clear) {
+      codeSize = minCodeSize + 1u;
+      next = clear + 2;
+      prev = -1;
+      continue;
+    }
+    if (code == eoi) break;
+    if (prev < 0) {
+      if (code >= clear) break;
+      emit(code);
+      prev = (int32_t)code;
+      continue;
+    }
+    uint8_t head;
+    if (code < next) {
+      head = first[code];
+      emit(code);
+    } else if (code == next) {
+      head = first[prev];
+    } else {
+      break; // 损坏
+    }
+    if (next < 4096) {
+      prefix[next] = (uint16_t)prev;
+      suffix[next] = head;
+      first[next] = first[prev];
+      length[next] = (uint16_t)(length[prev] + 1);
+      if (code == next) emit(next);
+      ++next;
+      if (next == (1u << codeSize) && codeSize < 12) ++codeSize;
+    } else if (code == next) {
+      break;
+    }
+    prev = (int32_t)code;
+  }
+  m_decoded = (std::min)(pos, total);
+  return m_decoded > 0;
+}
+
+void GifDecoder::Blit(const FrameInfo& frame) {
+  // 调色板展开为 BGRA；越界下标按黑色处理
+  uint32_t palette[256] = {};
+  const uint8_t* pal = frame.paletteOffset ? m_data + frame.paletteOffset : nullptr;
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t rgb = 0;
+    if (pal && i < frame.paletteSize) rgb = (uint32_t)pal[i * 3] << 16 | (uint32_t)pal[i * 3 + 1] << 8 | pal[i * 3 + 2];
+    palette[i] = 0xFF000000u | rgb; // 小端下字节序为 B, G, R, A
+  }
+  const int transparent = frame.transparent;
+
+  const uint32_t maxW = frame.left < m_width ? (std::min)((uint32_t)frame.width, m_width - frame.left) : 0u;
+  const uint32_t maxH = frame.top < m_height ? (std::min)((uint32_t)frame.height, m_height - frame.top) : 0u;
+  if (maxW == 0 || maxH == 0) return;
+
+  // 隔行扫描：码流中的第 n 行对应 8 行一组的四遍扫描
+  // 码流提前结束或出错时只画已解出的前 m_decoded 个像素（按码流顺序）
+  uint32_t pass = 0, step = frame.interlaced ? 8u : 1u, row = 0;
+  for (uint32_t srcRow = 0; srcRow < frame.height; ++srcRow) {
+    const size_t rowStart = (size_t)srcRow * frame.width;
+    if (rowStart >= m_decoded) break;
+    if (row < maxH) {
+      const uint8_t* idx = m_indices.data() + rowStart;
+      uint8_t* dst = m_canvas.data() + ((size_t)(frame.top + row) * m_width + frame.left) * 4;
+      const uint32_t count = (uint32_t)(std::min)((size_t)maxW, m_decoded - rowStart);
+      for (uint32_t x = 0; x < count; ++x) {
+        const uint8_t c = idx[x];
+        if (c == transparent) continue;
+        std::memcpy(dst + (size_t)x * 4, &palette[c], 4);
+      }
+    }
+    row += step;
+    if (frame.interlaced) {
+      while (row >= frame.height && pass < 3) {
+        ++pass;
+        static constexpr uint32_t kStart[4] = { 0, 4, 2, 1 };
+        static constexpr uint32_t kStep[4] = { 8, 8, 4, 2 };
+        row = kStart[pass];
+        step = kStep[pass];
+      }
+    }
+  }
+}
+
+void GifDecoder::ClearRect(const FrameInfo& frame) {
+  const uint32_t maxW = frame.left < m_width ? (std::min)((uint32_t)frame.width, m_width - frame.left) : 0u;
+  const uint32_t maxH = frame.top < m_height ? (std::min)((uint32_t)frame.height, m_height - frame.top) : 0u;
+  for (uint32_t y = 0; y < maxH; ++y) {
+    uint8_t* dst = m_canvas.data() + ((size_t)(frame.top + y) * m_width + frame.left) * 4;
+    std::memset(dst, 0, (size_t)maxW * 4);
+  }
+}
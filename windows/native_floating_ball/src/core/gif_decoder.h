@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// GIF 解码与逐帧合成（不依赖 WIC，可在 Linux 上测量）：Open 只扫描块结构、建立帧索引，
+// ComposeNext 按顺序解 LZW 并按 FrameRect / 透明色 / Disposal 规则叠加到整张画布上。
+//
+// 画布为预乘 BGRA（GIF 像素只有全透明与不透明两种，预乘与否数值相同），行距 Width() * 4。
+// Disposal 2 把帧矩形清成透明（不用背景色，悬浮球需要透明底），3 恢复到该帧绘制之前。
+// 数据损坏时：块结构截断处之后的帧不计入；LZW 码流出错的帧保留已解出的像素，其余保持原样。
+class GifDecoder {
+public:
+  static constexpr uint32_t kMaxDimension = 8192;
+
+  // data 须在解码期间保持有效（不复制）
+  bool Open(const uint8_t* data, size_t size);
+
+  uint32_t Width() const { return m_width; }
+  uint32_t Height() const { return m_height; }
+  size_t FrameCount() const { return m_frames.size(); }
+  // 帧延迟（毫秒）；没有图形控制扩展或延迟为 0 时按 100ms（很多 GIF 用 0 表示“默认速度”）
+  uint32_t DelayMs(size_t index) const;
+
+  // 解码并合成下一帧，返回画布（到下一次调用 ComposeNext / Rewind 前有效）；全部帧结束后返回 nullptr
+  const uint8_t* ComposeNext();
+  size_t NextIndex() const { return m_next; }
+  // 回到第一帧之前（画布清空）
+  void Rewind();
+
+private:
+  struct FrameInfo {
+    size_t dataOffset{0};    // LZW 最小码长字节
+    size_t paletteOffset{0}; // 0 表示无调色板
+    uint16_t paletteSize{0};
+    uint16_t left{0}, top{0}, width{0}, height{0};
+    uint32_t delayMs{100};
+    int16_t transparent{-1};
+    uint8_t disposal{0};
+    bool interlaced{false};
+  };
+
+  bool DecodeIndices(const FrameInfo& frame);
+  void Blit(const FrameInfo& frame);
+  void ClearRect(const FrameInfo& frame);
+
+  const uint8_t* m_data{nullptr};
+  size_t m_size{0};
+  uint32_t m_width{0}, m_height{0};
+  size_t m_globalPalette{0};
+  uint16_t m_globalPaletteSize{0};
+  std::vector<FrameInfo> m_frames;
+  size_t m_next{0};
+
+  std::vector<uint8_t> m_canvas;
+  std::vector<uint8_t> m_saved;   // Disposal 3 的恢复点
+  std::vector<uint8_t> m_codes;   // 拼接后的 LZW 子块
+  std::vector<uint8_t> m_indices; // 当前帧的调色板下标
+  size_t m_decoded{0};            // 其中实际解出的个数
+};
@@ -0,0 +1,258 @@
+#include "glyph_atlas.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr uint32_t kEllipsis = 0x2026;
+constexpr uint32_t kReplacement = 0xFFFD;
+constexpr int kPadding = 1; // 字形之间留 1px，避免线性采样串色
+
+uint64_t GlyphKey(uint32_t codepoint, float sizePx, uint32_t dpi) {
+  const uint64_t size = (uint64_t)std::lround(sizePx * 4.f) & 0xFFFFu; // 1/4 px 精度
+  return (uint64_t)(codepoint & 0x1FFFFFu) | (size << 21) | ((uint64_t)(dpi & 0xFFFFu) << 37);
+}
+
+// 读取一个码点；非法代理项替换为 U+FFFD。
+uint32_t NextCodepoint(std::u16string_view text, size_t* i) {
+  const uint32_t c = text[(*i)++];
+  if (c >= 0xD800 && c <= 0xDBFF) {
+    if (*i < text.size()) {
+      const uint32_t lo = text[*i];
+      if (lo >= 0xDC00 && lo <= 0xDFFF) {
+        ++*i;
+        return 0x10000u + ((c - 0xD800u) << 10) + (lo - 0xDC00u);
+      }
+    }
+    return kReplacement;
+  }
+  if (c >= 0xDC00 && c <= 0xDFFF) return kReplacement;
+  return c;
+}
+
+// v / 255 四舍五入（v <= 255 * 255），避免逐像素整数除法
+inline uint32_t Div255(uint32_t v) {
+  v += 128;
+  return (v + (v >> 8)) >> 8;
+}
+
+uint64_t Fingerprint(std::u16string_view text, float sizePx, uint32_t dpi, float maxWidth) {
+  uint64_t h = 1469598103934665603ull;
+  auto feed = [&h](const void* data, size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+  };
+  feed(text.data(), text.size() * sizeof(char16_t));
+  feed(&sizePx, sizeof(sizePx));
+  feed(&dpi, sizeof(dpi));
+  feed(&maxWidth, sizeof(maxWidth));
+  return h;
+}
+
+} // namespace
+
+GlyphAtlas::GlyphAtlas(int width, int height)
+    : m_width(width), m_height(height), m_pixels((size_t)width * (size_t)height, 0) {}
+
+void GlyphAtlas::Reset() {
+  std::fill(m_pixels.begin(), m_pixels.end(), (uint8_t)0);
+  m_glyphs.clear();
+  m_shelfX = m_shelfY = m_shelfH = 0;
+  ++m_generation;
+  ++m_stats.resets;
+  m_dirty = AtlasRect{ 0, 0, m_width, m_height };
+}
+
+bool GlyphAtlas::Allocate(int w, int h, int* x, int* y) {
+  const int pw = w + kPadding, ph = h + kPadding;
+  if (pw > m_width || ph > m_height) return false;
+  if (m_shelfX + pw > m_width) { // 换到下一层货架
+    m_shelfY += m_shelfH;
+    m_shelfX = 0;
+    m_shelfH = 0;
+  }
+  if (m_shelfY + ph > m_height) return false;
+  *x = m_shelfX;
+  *y = m_shelfY;
+  m_shelfX += pw;
+  m_shelfH = (std::max)(m_shelfH, ph);
+  return true;
+}
+
+const GlyphEntry* GlyphAtlas::Get(GlyphRasterizer& rasterizer, uint32_t codepoint, float sizePx, uint32_t dpi) {
+  const uint64_t key = GlyphKey(codepoint, sizePx, dpi);
+  auto it = m_glyphs.find(key);
+  if (it != m_glyphs.end()) {
+    ++m_stats.hits;
+    return &it->second;
+  }
+  ++m_stats.misses;
+
+  m_scratch.width = m_scratch.height = m_scratch.left = m_scratch.top = 0;
+  m_scratch.advance = 0.f;
+  m_scratch.coverage.clear();
+  if (!rasterizer.Rasterize(codepoint, sizePx, &m_scratch)) return nullptr;
+  if ((size_t)m_scratch.width * (size_t)m_scratch.height > m_scratch.coverage.size()) {
+    m_scratch.width = m_scratch.height = 0; // 光栅化器给出的数据不完整，按空白字形处理
+  }
+
+  GlyphEntry entry;
+  entry.left = (int16_t)m_scratch.left;
+  entry.top = (int16_t)m_scratch.top;
+  entry.advance = m_scratch.advance;
+  if (m_scratch.width > 0 && m_scratch.height > 0) {
+    int x = 0, y = 0;
+    if (!Allocate(m_scratch.width, m_scratch.height, &x, &y)) {
+      Reset();
+      if (!Allocate(m_scratch.width, m_scratch.height, &x, &y)) return nullptr;
+    }
+    for (int row = 0; row < m_scratch.height; ++row) {
+      std::copy_n(m_scratch.coverage.data() + (size_t)row * m_scratch.width, m_scratch.width,
+                  m_pixels.data() + (size_t)(y + row) * m_width + x);
+    }
+    entry.x = (uint16_t)x;
+    entry.y = (uint16_t)y;
+    entry.w = (uint16_t)m_scratch.width;
+    entry.h = (uint16_t)m_scratch.height;
+    const AtlasRect r{ x, y, x + m_scratch.width, y + m_scratch.height };
+    if (m_dirty.Empty()) {
+      m_dirty = r;
+    } else {
+      m_dirty.left = (std::min)(m_dirty.left, r.left);
+      m_dirty.top = (std::min)(m_dirty.top, r.top);
+      m_dirty.right = (std::max)(m_dirty.right, r.right);
+      m_dirty.bottom = (std::max)(m_dirty.bottom, r.bottom);
+    }
+  }
+  return &m_glyphs.emplace(key, entry).first->second;
+}
+
+AtlasRect GlyphAtlas::TakeDirtyRect() {
+  const AtlasRect r = m_dirty;
+  m_dirty = AtlasRect{};
+  return r;
+}
+
+// 返回 false 表示排版过程中图集被清空过（之前取到的字形位置已失效）。
+static bool ShapeOnce(GlyphAtlas& atlas, GlyphRasterizer& rasterizer, std::u16string_view text,
+                      float sizePx, uint32_t dpi, float maxWidth, ShapedLine* out) {
+  out->glyphs.clear();
+  out->width = 0.f;
+  out->truncated = false;
+  out->ascent = rasterizer.Ascent(sizePx);
+  out->lineHeight = rasterizer.LineHeight(sizePx);
+  const uint32_t generation = atlas.Generation();
+
+  float pen = 0.f;
+  size_t i = 0;
+  while (i < text.size()) {
+    uint32_t cp = NextCodepoint(text, &i);
+    if (cp == u'\r' || cp == u'\n') continue; // 单行显示，丢弃换行
+    if (cp == u'\t') cp = u' ';
+    if (cp < 0x20) continue;
+    const GlyphEntry* g = atlas.Get(rasterizer, cp, sizePx, dpi);
+    if (!g) continue;
+    const float x = std::round(pen);
+    if (maxWidth > 0.f && x + g->advance > maxWidth) {
+      out->truncated = true;
+      break;
+    }
+    out->glyphs.push_back(PlacedGlyph{ *g, x });
+    pen += g->advance;
+  }
+
+  if (out->truncated) {
+    // 回退到能放下省略号的位置
+    const GlyphEntry* ellipsis = atlas.Get(rasterizer, kEllipsis, sizePx, dpi);
+    const float ew = ellipsis ? ellipsis->advance : 0.f;
+    while (!out->glyphs.empty() && out->glyphs.back().x + out->glyphs.back().glyph.advance + ew > maxWidth) {
+      out->glyphs.pop_back();
+    }
+    pen = out->glyphs.empty() ? 0.f : out->glyphs.back().x + out->glyphs.back().glyph.advance;
+    if (ellipsis) {
+      out->glyphs.push_back(PlacedGlyph{ *ellipsis, std::round(pen) });
+      pen += ew;
+    }
+  }
+  out->width = pen;
+  out->atlasGeneration = atlas.Generation();
+  return out->atlasGeneration == generation;
+}
+
+void ShapeLine(GlyphAtlas& atlas, GlyphRasterizer& rasterizer, std::u16string_view text,
+               float sizePx, uint32_t dpi, float maxWidth, ShapedLine* out) {
+  // 图集在排版中途被清空时，在新图集上重排一次即可（单行文本远小于图集容量）
+  if (!ShapeOnce(atlas, rasterizer, text, sizePx, dpi, maxWidth, out)) {
+    ShapeOnce(atlas, rasterizer, text, sizePx, dpi, maxWidth, out);
+  }
+}
+
+const ShapedLine* ShapedTextCache::Get(GlyphAtlas& atlas, GlyphRasterizer& rasterizer, std::u16string_view text,
+                                       float sizePx, uint32_t dpi, float maxWidth) {
+  const uint64_t key = Fingerprint(text, sizePx, dpi, maxWidth);
+  if (CachedLine* hit = m_lines.Find(key)) {
+    const bool same = hit->sizePx == sizePx && hit->dpi == dpi && hit->maxWidth == maxWidth && hit->text == text;
+    if (same && hit->line.atlasGeneration == atlas.Generation()) return &hit->line;
+    if (same) { // 图集被重置过，原地重排，复用缓冲
+      ShapeLine(atlas, rasterizer, text, sizePx, dpi, maxWidth, &hit->line);
+      return &hit->line;
+    }
+  }
+  CachedLine entry;
+  entry.text.assign(text.data(), text.size());
+  entry.sizePx = sizePx;
+  entry.dpi = dpi;
+  entry.maxWidth = maxWidth;
+  ShapeLine(atlas, rasterizer, text, sizePx, dpi, maxWidth, &entry.line);
+  return &m_lines.Insert(key, std::move(entry))->line;
+}
+
+bool ShapedTextCache::GetConsistent(GlyphAtlas& atlas, GlyphRasterizer& rasterizer,
+                                    const std::vector<std::u16string_view>& texts, float sizePx, uint32_t dpi,
+                                    float maxWidth, std::vector<const ShapedLine*>* out) {
+  for (int pass = 0; pass < kMaxConsistentPasses; ++pass) {
+    const uint32_t generation = atlas.Generation();
+    out->clear();
+    // Get 对 generation 过期的行原地重排，已是当前代的行直接命中
+    for (std::u16string_view text : texts) out->push_back(Get(atlas, rasterizer, text, sizePx, dpi, maxWidth));
+    if (atlas.Generation() == generation) return true;
+  }
+  out->clear();
+  return false;
+}
+
+void BlitLine(const ShapedLine& line, const GlyphAtlas& atlas, uint8_t* dst, int dstStride,
+              int dstWidth, int dstHeight, int x, int y, uint32_t color, float opacity) {
+  const uint32_t a = (uint32_t)std::lround(((color >> 24) & 0xFF) * (std::min)((std::max)(opacity, 0.f), 1.f));
+  if (a == 0) return;
+  // 预乘后的源颜色（0..255）
+  const uint32_t pr = Div255(((color >> 16) & 0xFF) * a);
+  const uint32_t pg = Div255(((color >> 8) & 0xFF) * a);
+  const uint32_t pb = Div255((color & 0xFF) * a);
+  const uint8_t* atlasPx = atlas.Pixels();
+  const int atlasW = atlas.Width();
+  const int baseline = y + (int)std::lround(line.ascent);
+
+  for (const PlacedGlyph& pg0 : line.glyphs) {
+    const GlyphEntry& g = pg0.glyph;
+    const int gx = x + (int)pg0.x + g.left;
+    const int gy = baseline - g.top;
+    const int x0 = (std::max)(0, gx), y0 = (std::max)(0, gy);
+    const int x1 = (std::min)(dstWidth, gx + (int)g.w), y1 = (std::min)(dstHeight, gy + (int)g.h);
+    for (int py = y0; py < y1; ++py) {
+      const uint8_t* src = atlasPx + (size_t)(g.y + (py - gy)) * atlasW + g.x + (x0 - gx);
+      uint8_t* d = dst + (size_t)py * dstStride + (size_t)x0 * 4;
+      for (int px = x0; px < x1; ++px, ++src, d += 4) {
+        const uint32_t cov = *src;
+        if (!cov) continue;
+        // 覆盖率 × 预乘颜色，再做 source-over
+        const uint32_t sa = Div255(a * cov);
+        const uint32_t inv = 255 - sa;
+        d[0] = (uint8_t)(Div255(pb * cov) + Div255(d[0] * inv));
+        d[1] = (uint8_t)(Div255(pg * cov) + Div255(d[1] * inv));
+        d[2] = (uint8_t)(Div255(pr * cov) + Div255(d[2] * inv));
+        d[3] = (uint8_t)(sa + Div255(d[3] * inv));
+      }
+    }
+  }
+}
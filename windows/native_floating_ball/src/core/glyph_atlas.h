@@ -0,0 +1,137 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "lru_cache.h"
+
+// 可移植的字形图集文本渲染核心：光栅化器只负责“单个码点 -> 灰度覆盖位图”，
+// 图集负责缓存/打包，ShapeLine 负责简单排版（UTF-16 解码、累加步进、省略号截断），
+// BlitLine 把排好的一行软件混合到 BGRA 预乘缓冲。Win32 端用 DirectWrite 实现光栅化器，
+// 其余部分不依赖任何平台 API，可在 Linux 上无头运行（基准测试）。
+
+struct GlyphBitmap {
+  int width{0};
+  int height{0};
+  int left{0};       // 位图左边相对笔位置的偏移
+  int top{0};        // 基线到位图顶部的距离（向上为正）
+  float advance{0.f};
+  std::vector<uint8_t> coverage; // width * height，8 位覆盖率
+};
+
+class GlyphRasterizer {
+public:
+  virtual ~GlyphRasterizer() = default;
+  // 光栅化一个码点；缺字时应返回 .notdef 或空位图（advance 仍需有效）。
+  virtual bool Rasterize(uint32_t codepoint, float sizePx, GlyphBitmap* out) = 0;
+  virtual float Ascent(float sizePx) const = 0;
+  virtual float LineHeight(float sizePx) const = 0;
+};
+
+struct GlyphEntry {
+  uint16_t x{0}, y{0}, w{0}, h{0}; // 图集内矩形
+  int16_t left{0}, top{0};
+  float advance{0.f};
+};
+
+struct AtlasRect {
+  int left{0}, top{0}, right{0}, bottom{0};
+  bool Empty() const { return right <= left || bottom <= top; }
+};
+
+// 8 位覆盖率图集，按“货架”方式打包。满了以后整体清空并递增 generation，
+// 引用旧字形位置的排版结果据此失效重排。
+class GlyphAtlas {
+public:
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t resets{0};
+    size_t glyphs{0};
+  };
+
+  explicit GlyphAtlas(int width = 512, int height = 512);
+
+  const GlyphEntry* Get(GlyphRasterizer& rasterizer, uint32_t codepoint, float sizePx, uint32_t dpi);
+
+  int Width() const { return m_width; }
+  int Height() const { return m_height; }
+  const uint8_t* Pixels() const { return m_pixels.data(); }
+  uint32_t Generation() const { return m_generation; }
+
+  // 自上次调用以来被写入的区域（用于只上传变化部分到 GPU 纹理）。
+  AtlasRect TakeDirtyRect();
+
+  Stats GetStats() const { Stats s = m_stats; s.glyphs = m_glyphs.size(); return s; }
+
+private:
+  void Reset();
+  bool Allocate(int w, int h, int* x, int* y);
+
+  int m_width;
+  int m_height;
+  std::vector<uint8_t> m_pixels;
+  std::unordered_map<uint64_t, GlyphEntry> m_glyphs;
+  GlyphBitmap m_scratch;
+  int m_shelfX{0}, m_shelfY{0}, m_shelfH{0};
+  uint32_t m_generation{1};
+  AtlasRect m_dirty;
+  Stats m_stats;
+};
+
+struct PlacedGlyph {
+  GlyphEntry glyph;
+  float x{0.f}; // 笔位置（相对行首，已取整）
+};
+
+struct ShapedLine {
+  std::vector<PlacedGlyph> glyphs;
+  float width{0.f};
+  float ascent{0.f};
+  float lineHeight{0.f};
+  bool truncated{false};
+  uint32_t atlasGeneration{0};
+};
+
+// 单行排版：解码 UTF-16（含代理对），逐码点取字形并累加步进；超出 maxWidth 时截断并追加“…”。
+// 我们的文本只有中文/英文，从左到右、无连字，逐码点映射即可满足需要。
+void ShapeLine(GlyphAtlas& atlas, GlyphRasterizer& rasterizer, std::u16string_view text,
+               float sizePx, uint32_t dpi, float maxWidth, ShapedLine* out);
+
+// 以 (文本, 字号, DPI, 最大宽度) 为键缓存排版结果；图集 generation 变化时自动重排。
+class ShapedTextCache {
+  struct CachedLine {
+    ShapedLine line;
+    std::u16string text; // 指纹冲突校验
+    float sizePx{0.f};
+    float maxWidth{0.f};
+    uint32_t dpi{0};
+  };
+
+public:
+  using Stats = LruCache<uint64_t, CachedLine>::Stats;
+
+  explicit ShapedTextCache(size_t capacity = 256) : m_lines(capacity) {}
+
+  const ShapedLine* Get(GlyphAtlas& atlas, GlyphRasterizer& rasterizer, std::u16string_view text,
+                        float sizePx, uint32_t dpi, float maxWidth);
+
+  // 取一组行（同一帧内一起绘制的可见行）的排版结果，保证全部引用同一代图集：
+  // 排第 k 行时图集被清空，之前取到的行也都指向旧位置，因此整遍重取，直到某一遍没有 generation 变化。
+  // 最多 kMaxConsistentPasses 遍；仍不稳定（这组文本放不进一张图集）时返回 false，调用方改走不依赖图集的绘制。
+  static constexpr int kMaxConsistentPasses = 3;
+  bool GetConsistent(GlyphAtlas& atlas, GlyphRasterizer& rasterizer, const std::vector<std::u16string_view>& texts,
+                     float sizePx, uint32_t dpi, float maxWidth, std::vector<const ShapedLine*>* out);
+
+  Stats GetStats() const { return m_lines.GetStats(); }
+  void Clear() { m_lines.Clear(); }
+
+private:
+  LruCache<uint64_t, CachedLine> m_lines;
+};
+
+// 把排好的一行以预乘 source-over 混合到 BGRA 预乘缓冲；color 为非预乘 0xAARRGGBB。
+void BlitLine(const ShapedLine& line, const GlyphAtlas& atlas, uint8_t* dst, int dstStride,
+              int dstWidth, int dstHeight, int x, int y, uint32_t color, float opacity);
@@ -0,0 +1,73 @@
+#include "hdr_histogram.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+constexpr uint64_t kMaxValue = (1ull << HdrHistogram::kMaxBits) - 1;
+constexpr uint32_t kHalf = HdrHistogram::kSubBuckets / 2;
+
+int BitLength(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+  return v ? 64 - __builtin_clzll(v) : 0;
+#else
+  int n = 0;
+  while (v) { v >>= 1; ++n; }
+  return n;
+#endif
+}
+
+} // namespace
+
+size_t HdrHistogram::BucketOf(uint64_t value) {
+  value = (std::min)(value, kMaxValue);
+  if (value < kSubBuckets) return (size_t)value;
+  // value 落在 [2^(e+b-1), 2^(e+b))：右移 e 位后在 [kHalf, kSubBuckets) 之间
+  const int e = BitLength(value) - kSubBucketBits;
+  const uint64_t sub = value >> e;
+  return kSubBuckets + (size_t)(e - 1) * kHalf + (size_t)(sub - kHalf);
+}
+
+uint64_t HdrHistogram::BucketUpper(size_t index) {
+  if (index < kSubBuckets) return index;
+  const size_t e = (index - kSubBuckets) / kHalf + 1;
+  const uint64_t sub = (index - kSubBuckets) % kHalf + kHalf;
+  return ((sub + 1) << e) - 1;
+}
+
+void HdrHistogram::Record(uint64_t value) {
+  ++m_buckets[BucketOf(value)];
+  ++m_count;
+  m_total += value;
+  m_min = (std::min)(m_min, value);
+  m_max = (std::max)(m_max, value);
+}
+
+void HdrHistogram::Reset() {
+  std::fill(std::begin(m_buckets), std::end(m_buckets), 0u);
+  m_count = 0;
+  m_total = 0;
+  m_min = UINT64_MAX;
+  m_max = 0;
+}
+
+void HdrHistogram::Merge(const HdrHistogram& other) {
+  if (!other.m_count) return;
+  for (size_t i = 0; i < kBucketCount; ++i) m_buckets[i] += other.m_buckets[i];
+  m_count += other.m_count;
+  m_total += other.m_total;
+  m_min = (std::min)(m_min, other.m_min);
+  m_max = (std::max)(m_max, other.m_max);
+}
+
+uint64_t HdrHistogram::Percentile(double p) const {
+  if (!m_count) return 0;
+  p = (std::min)((std::max)(p, 0.0), 1.0);
+  const uint64_t rank = (uint64_t)(p * (double)(m_count - 1)) + 1;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += m_buckets[i];
+    if (seen >= rank) return (std::min)(BucketUpper(i), m_max);
+  }
+  return m_max;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 对数-线性分桶的直方图（HdrHistogram 的定长简化版），用于帧耗时等需要较准分位数的场合。
+// 小于 kSubBuckets 的值逐一计数；此后每个 2 的幂区间再均分为 kSubBuckets / 2 份，
+// 相对误差不超过 1 / (kSubBuckets / 2)（约 3%）。可记录到 2^kMaxBits - 1，更大的值按最大值计。
+//
+// 记录只有几次位运算与自增，不分配内存；不加锁，只在一个线程上写。
+class HdrHistogram {
+public:
+  static constexpr int kSubBucketBits = 6;
+  static constexpr uint32_t kSubBuckets = 1u << kSubBucketBits;
+  static constexpr int kMaxBits = 40; // 纳秒计约 18 分钟
+  static constexpr size_t kBucketCount = kSubBuckets + (size_t)(kMaxBits - kSubBucketBits) * (kSubBuckets / 2);
+
+  void Record(uint64_t value);
+  void Reset();
+  // 把 other 的计数累加进来（例如按周期汇总）
+  void Merge(const HdrHistogram& other);
+
+  uint64_t Count() const { return m_count; }
+  uint64_t Min() const { return m_count ? m_min : 0; }
+  uint64_t Max() const { return m_max; }
+  double Mean() const { return m_count ? (double)m_total / (double)m_count : 0.0; }
+  // p 取 [0, 1]；返回所在桶的上界（不超过 Max），与 DispatchProfiler 一样偏保守
+  uint64_t Percentile(double p) const;
+
+  static size_t BucketOf(uint64_t value);
+  // 第 index 桶覆盖的最大值
+  static uint64_t BucketUpper(size_t index);
+
+private:
+  uint32_t m_buckets[kBucketCount]{};
+  uint64_t m_count{0};
+  uint64_t m_total{0};
+  uint64_t m_min{UINT64_MAX};
+  uint64_t m_max{0};
+};
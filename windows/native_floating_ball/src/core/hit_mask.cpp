@@ -0,0 +1,42 @@
+#include "hit_mask.h"
+#include <algorithm>
+
+void HitMask::Build(const uint8_t* alpha, uint32_t width, uint32_t height, size_t rowStride, size_t pixelStride,
+                    uint8_t minAlpha) {
+  Clear();
+  if (!alpha || !width || !height || width > 0xFFFF) return;
+  m_width = width;
+  m_height = height;
+  m_rowStart.reserve((size_t)height + 1);
+  m_rowStart.push_back(0);
+  for (uint32_t y = 0; y < height; ++y) {
+    const uint8_t* row = alpha + y * rowStride;
+    uint32_t x = 0;
+    while (x < width) {
+      while (x < width && row[x * pixelStride] < minAlpha) ++x;
+      if (x == width) break;
+      const uint32_t first = x;
+      while (x < width && row[x * pixelStride] >= minAlpha) ++x;
+      m_spans.push_back(Span{ (uint16_t)first, (uint16_t)x });
+    }
+    m_rowStart.push_back((uint32_t)m_spans.size());
+  }
+  m_spans.shrink_to_fit();
+}
+
+void HitMask::Clear() {
+  m_width = 0;
+  m_height = 0;
+  m_rowStart.clear();
+  m_spans.clear();
+}
+
+bool HitMask::Contains(int x, int y) const {
+  if (x < 0 || y < 0 || (uint32_t)x >= m_width || (uint32_t)y >= m_height) return false;
+  const Span* begin = RowBegin((uint32_t)y);
+  const Span* end = RowEnd((uint32_t)y);
+  // 第一个 last > x 的区间；x 落在它的 [first, last) 内才算命中
+  const Span* it = std::upper_bound(begin, end, (uint32_t)x,
+                                    [](uint32_t value, const Span& span) { return value < span.last; });
+  return it != end && (uint32_t)x >= it->first;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 悬浮球的命中区域：按 alpha 阈值把位图压缩成每行若干个不透明区间 [first, last)。
+// WM_NCHITTEST 用它判断光标是否落在可见像素上，透明角落返回 HTTRANSPARENT 交给下面的窗口，
+// 不再为整个方形窗口吞掉点击和悬停。每行的区间按 x 升序且互不相邻，查询是行内的二分查找。
+class HitMask {
+public:
+  // alpha 低于它的像素视为透明（抗锯齿边缘最外一圈几乎看不见，不应挡住下面的窗口）
+  static constexpr uint8_t kDefaultMinAlpha = 32;
+
+  struct Span {
+    uint16_t first{0};
+    uint16_t last{0};
+  };
+
+  // alpha 指向第一行第一个像素的 alpha；rowStride / pixelStride 为字节步长
+  // （预乘 BGRA 传 bgra + 3、width * 4、4；单通道覆盖率传 coverage、width、1）
+  void Build(const uint8_t* alpha, uint32_t width, uint32_t height, size_t rowStride, size_t pixelStride,
+             uint8_t minAlpha = kDefaultMinAlpha);
+  void Clear();
+
+  uint32_t Width() const { return m_width; }
+  uint32_t Height() const { return m_height; }
+  bool Empty() const { return m_spans.empty(); }
+  // 越界坐标返回 false
+  bool Contains(int x, int y) const;
+
+  // 第 y 行的区间：[RowBegin(y), RowEnd(y))
+  const Span* RowBegin(uint32_t y) const { return m_spans.data() + m_rowStart[y]; }
+  const Span* RowEnd(uint32_t y) const { return m_spans.data() + m_rowStart[y + 1]; }
+  size_t SpanCount() const { return m_spans.size(); }
+  size_t Bytes() const { return m_spans.capacity() * sizeof(Span) + m_rowStart.capacity() * sizeof(uint32_t); }
+
+private:
+  uint32_t m_width{0};
+  uint32_t m_height{0};
+  std::vector<uint32_t> m_rowStart; // height + 1 项，第 y 行的区间在 m_spans[m_rowStart[y], m_rowStart[y + 1])
+  std::vector<Span> m_spans;
+};
@@ -0,0 +1,89 @@
+#include "image_scale.h"
+#include <algorithm>
+#include <cmath>
+
+void CoverScaler::BuildTaps(uint32_t srcLen, uint32_t dstLen, double scale, std::vector<Taps>* taps,
+                            std::vector<float>* weights) {
+  taps->assign(dstLen, Taps{});
+  weights->clear();
+  // 目标像素 i 对应源区间 [offset + i / scale, offset + (i + 1) / scale)，offset 使可见区域居中
+  const double span = 1.0 / scale;
+  const double offset = ((double)srcLen - (double)dstLen * span) / 2.0;
+  for (uint32_t i = 0; i < dstLen; ++i) {
+    const double lo = (std::max)(0.0, offset + i * span);
+    const double hi = (std::min)((double)srcLen, offset + (i + 1) * span);
+    uint32_t first = (uint32_t)lo;
+    uint32_t last = (std::min)(srcLen - 1, (uint32_t)std::ceil(hi) - (hi > lo ? 1u : 0u));
+    if (last < first) last = first;
+    Taps& t = (*taps)[i];
+    t.first = first;
+    t.count = last - first + 1;
+    t.weights = (uint32_t)weights->size();
+    double sum = 0.0;
+    for (uint32_t s = first; s <= last; ++s) {
+      const double w = (std::max)(0.0, (std::min)(hi, (double)s + 1.0) - (std::max)(lo, (double)s));
+      weights->push_back((float)w);
+      sum += w;
+    }
+    // 归一化；退化区间（放大时宽度不足一个像素也不会出现，这里只防除零）取整像素
+    for (uint32_t k = 0; k < t.count; ++k) {
+      float& w = (*weights)[t.weights + k];
+      w = sum > 0.0 ? (float)(w / sum) : (k == 0 ? 1.f : 0.f);
+    }
+  }
+}
+
+void CoverScaler::Configure(uint32_t srcW, uint32_t srcH, uint32_t dstW, uint32_t dstH) {
+  m_srcW = srcW;
+  m_srcH = srcH;
+  m_dstW = dstW;
+  m_dstH = dstH;
+  m_x.clear();
+  m_y.clear();
+  if (!srcW || !srcH || !dstW || !dstH) return;
+  const double scale = (std::max)((double)dstW / srcW, (double)dstH / srcH);
+  BuildTaps(srcW, dstW, scale, &m_x, &m_xWeights);
+  BuildTaps(srcH, dstH, scale, &m_y, &m_yWeights);
+  m_rowFirst = m_y.front().first;
+  const uint32_t rowLast = m_y.back().first + m_y.back().count;
+  m_rows.assign((size_t)(rowLast - m_rowFirst) * dstW * 4, 0.f);
+}
+
+void CoverScaler::Scale(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride) {
+  if (m_x.empty() || m_y.empty()) return;
+  // 水平：只处理被目标行用到的源行
+  const uint32_t rowCount = (uint32_t)(m_rows.size() / ((size_t)m_dstW * 4));
+  for (uint32_t r = 0; r < rowCount; ++r) {
+    const uint8_t* in = src + (size_t)(m_rowFirst + r) * srcStride;
+    float* out = m_rows.data() + (size_t)r * m_dstW * 4;
+    for (uint32_t x = 0; x < m_dstW; ++x) {
+      const Taps& t = m_x[x];
+      const float* w = m_xWeights.data() + t.weights;
+      const uint8_t* p = in + (size_t)t.first * 4;
+      float b = 0.f, g = 0.f, rr = 0.f, a = 0.f;
+      for (uint32_t k = 0; k < t.count; ++k, p += 4) {
+        b += w[k] * p[0];
+        g += w[k] * p[1];
+        rr += w[k] * p[2];
+        a += w[k] * p[3];
+      }
+      out[x * 4 + 0] = b;
+      out[x * 4 + 1] = g;
+      out[x * 4 + 2] = rr;
+      out[x * 4 + 3] = a;
+    }
+  }
+  // 垂直
+  const size_t rowFloats = (size_t)m_dstW * 4;
+  for (uint32_t y = 0; y < m_dstH; ++y) {
+    const Taps& t = m_y[y];
+    const float* w = m_yWeights.data() + t.weights;
+    uint8_t* out = dst + (size_t)y * dstStride;
+    for (size_t i = 0; i < rowFloats; ++i) {
+      const float* col = m_rows.data() + (size_t)(t.first - m_rowFirst) * rowFloats + i;
+      float v = 0.f;
+      for (uint32_t k = 0; k < t.count; ++k) v += w[k] * col[(size_t)k * rowFloats];
+      out[i] = (uint8_t)(std::min)(255.f, v + 0.5f);
+    }
+  }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 预乘 BGRA 的“覆盖”缩放：等比缩放到完全覆盖目标、居中裁剪（与悬浮球 Render 的 cover fit 一致）。
+// 按面积加权（盒式滤波）：每个目标像素取它覆盖的源像素区域的平均值，大幅缩小时没有锯齿与闪烁。
+// 权重表只与尺寸有关，Configure 一次后可对同尺寸的每一帧重复调用 Scale。
+class CoverScaler {
+public:
+  void Configure(uint32_t srcW, uint32_t srcH, uint32_t dstW, uint32_t dstH);
+  bool IsConfigured(uint32_t srcW, uint32_t srcH, uint32_t dstW, uint32_t dstH) const {
+    return m_srcW == srcW && m_srcH == srcH && m_dstW == dstW && m_dstH == dstH;
+  }
+  // 行距以字节计；src 须是 Configure 时的尺寸
+  void Scale(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride);
+
+private:
+  struct Taps {
+    uint32_t first{0};  // 第一个源像素
+    uint32_t count{0};
+    uint32_t weights{0}; // 在权重数组中的起点
+  };
+  static void BuildTaps(uint32_t srcLen, uint32_t dstLen, double scale, std::vector<Taps>* taps,
+                        std::vector<float>* weights);
+
+  uint32_t m_srcW{0}, m_srcH{0}, m_dstW{0}, m_dstH{0};
+  std::vector<Taps> m_x, m_y;
+  std::vector<float> m_xWeights, m_yWeights;
+  std::vector<float> m_rows; // 水平方向缩放后的中间行（只保存用得到的源行）
+  uint32_t m_rowFirst{0};
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+// 气泡列表的虚拟化视口：只描述“固定行高列表 + 滚动偏移”的几何关系，不依赖 Win32。
+// 渲染只遍历 VisibleRange() 返回的行，命中测试直接由 y 偏移换算行号，开销与条目数量无关。
+struct ListViewport {
+  float padding{10.f};     // 内容区上下内边距
+  float rowHeight{24.f};
+  float rowGap{4.f};
+  float viewportHeight{0.f};
+  float scrollOffset{0.f}; // 内容坐标系下的滚动偏移（>= 0）
+  int itemCount{0};
+
+  float RowPitch() const { return rowHeight + rowGap; }
+
+  float ContentHeight() const {
+    if (itemCount <= 0) return padding * 2.f;
+    return padding * 2.f + itemCount * RowPitch() - rowGap;
+  }
+
+  // 视口高度上限为 maxRows 行；内容不足时按内容高度收缩（至少保留一行）。
+  float PreferredHeight(int maxRows) const {
+    const int rows = (std::max)(1, (std::min)(itemCount, maxRows));
+    return padding * 2.f + rows * RowPitch() - rowGap;
+  }
+
+  float MaxScroll() const {
+    return (std::max)(0.f, ContentHeight() - viewportHeight);
+  }
+
+  void ClampScroll() {
+    scrollOffset = (std::min)((std::max)(scrollOffset, 0.f), MaxScroll());
+  }
+
+  // 返回滚动偏移是否发生了变化（用于决定是否需要重绘）。
+  bool ScrollBy(float dy) {
+    const float before = scrollOffset;
+    scrollOffset += dy;
+    ClampScroll();
+    return scrollOffset != before;
+  }
+
+  // 视口坐标系下第 index 行的顶部 y。
+  float RowTop(int index) const {
+    return padding + index * RowPitch() - scrollOffset;
+  }
+
+  // 与视口相交的行区间 [first, last)。
+  void VisibleRange(int* first, int* last) const {
+    const float pitch = RowPitch();
+    int f = (int)std::floor((scrollOffset - padding) / pitch);
+    int l = (int)std::ceil((scrollOffset + viewportHeight - padding) / pitch);
+    f = (std::max)(0, f);
+    l = (std::min)(itemCount, (std::max)(f, l));
+    *first = f;
+    *last = l;
+  }
+
+  // 视口坐标 y 命中的行号；行间距对半分给上下两行，与旧版 HitTest 的矩形范围一致。
+  // 只命中可见区间内（实际绘制了）的行：视口边缘露出的半个行距不会命中视口外的行。
+  int RowAt(float y) const {
+    if (y < 0.f || y >= viewportHeight) return -1;
+    const float contentY = y + scrollOffset - padding + rowGap / 2.f;
+    if (contentY < 0.f) return -1;
+    const int index = (int)(contentY / RowPitch());
+    int first = 0, last = 0;
+    VisibleRange(&first, &last);
+    return (index >= first && index < last) ? index : -1;
+  }
+};
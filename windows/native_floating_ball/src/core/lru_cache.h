@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// 通用 LRU 缓存：链表保存使用顺序（表头最新），哈希表保存 key -> 链表节点。
+// Value 可以是只可移动的 RAII 类型（例如持有 COM 指针），淘汰时随节点析构释放。
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+    size_t size{0};
+    size_t capacity{0};
+    double HitRate() const {
+      const uint64_t total = hits + misses;
+      return total ? (double)hits / (double)total : 0.0;
+    }
+  };
+
+  explicit LruCache(size_t capacity) : m_capacity(capacity ? capacity : 1) {}
+
+  LruCache(const LruCache&) = delete;
+  LruCache& operator=(const LruCache&) = delete;
+
+  // 命中时把条目移到表头并返回指针；未命中返回 nullptr。指针在下一次 Insert/Clear 前有效。
+  Value* Find(const Key& key) {
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+      ++m_stats.misses;
+      return nullptr;
+    }
+    ++m_stats.hits;
+    m_order.splice(m_order.begin(), m_order, it->second);
+    return &it->second->second;
+  }
+
+  // 插入（或覆盖）条目，超出容量时淘汰最久未使用的条目。
+  Value* Insert(const Key& key, Value value) {
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+      it->second->second = std::move(value);
+      m_order.splice(m_order.begin(), m_order, it->second);
+      return &it->second->second;
+    }
+    while (m_index.size() >= m_capacity && !m_order.empty()) {
+      m_index.erase(m_order.back().first);
+      m_order.pop_back();
+      ++m_stats.evictions;
+    }
+    m_order.emplace_front(key, std::move(value));
+    m_index.emplace(m_order.front().first, m_order.begin());
+    return &m_order.front().second;
+  }
+
+  void Clear() {
+    m_index.clear();
+    m_order.clear();
+  }
+
+  size_t Size() const { return m_index.size(); }
+
+  Stats GetStats() const {
+    Stats s = m_stats;
+    s.size = m_index.size();
+    s.capacity = m_capacity;
+    return s;
+  }
+
+  void ResetStats() { m_stats = Stats{}; }
+
+private:
+  using Entry = std::pair<Key, Value>;
+  size_t m_capacity;
+  std::list<Entry> m_order;
+  std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> m_index;
+  Stats m_stats;
+};
@@ -0,0 +1,145 @@
+#include "memory_accounting.h"
+#include <cstdio>
+
+namespace {
+
+// fetch_sub 的饱和版本：返回减之前的值
+uint64_t SaturatingSub(std::atomic<uint64_t>& value, uint64_t bytes) {
+  uint64_t old = value.load(std::memory_order_relaxed);
+  while (!value.compare_exchange_weak(old, old > bytes ? old - bytes : 0, std::memory_order_relaxed)) {
+  }
+  return old;
+}
+
+void AppendUsageJson(std::string* out, const char* name, const MemoryAccounting::Usage& usage) {
+  char buf[112];
+  std::snprintf(buf, sizeof(buf), "\"%s\":{\"current\":%llu,\"peak\":%llu}", name,
+                (unsigned long long)usage.current, (unsigned long long)usage.peak);
+  *out += buf;
+}
+
+} // namespace
+
+const char* MemorySubsystemName(MemorySubsystem subsystem) {
+  switch (subsystem) {
+  case MemorySubsystem::AnimationFrames: return "animation_frames";
+  case MemorySubsystem::RenderResources: return "render_resources";
+  case MemorySubsystem::IpcBuffers: return "ipc_buffers";
+  case MemorySubsystem::BubbleScene: return "bubble_scene";
+  case MemorySubsystem::Logging: return "logging";
+  default: return "unknown";
+  }
+}
+
+void MemoryAccounting::Raise(std::atomic<uint64_t>& peak, uint64_t value) {
+  uint64_t old = peak.load(std::memory_order_relaxed);
+  while (old < value && !peak.compare_exchange_weak(old, value, std::memory_order_relaxed)) {
+  }
+}
+
+void MemoryAccounting::Add(MemorySubsystem subsystem, size_t bytes) {
+  if (!bytes || subsystem >= MemorySubsystem::kCount) return;
+  Counter& c = m_counters[(size_t)subsystem];
+  Raise(c.peak, c.current.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+  const uint64_t before = m_total.current.fetch_add(bytes, std::memory_order_relaxed);
+  Raise(m_total.peak, before + bytes);
+  const uint64_t budget = m_budget.load(std::memory_order_relaxed);
+  if (budget && before <= budget && before + bytes > budget) {
+    m_budgetExceeded.store(true, std::memory_order_relaxed);
+  }
+}
+
+void MemoryAccounting::Sub(MemorySubsystem subsystem, size_t bytes) {
+  if (!bytes || subsystem >= MemorySubsystem::kCount) return;
+  const uint64_t old = SaturatingSub(m_counters[(size_t)subsystem].current, bytes);
+  // 总量只减去子系统实际减掉的部分，两者保持一致
+  SaturatingSub(m_total.current, old < bytes ? old : bytes);
+}
+
+MemoryAccounting::Usage MemoryAccounting::Get(MemorySubsystem subsystem) const {
+  if (subsystem >= MemorySubsystem::kCount) return {};
+  const Counter& c = m_counters[(size_t)subsystem];
+  return { c.current.load(std::memory_order_relaxed), c.peak.load(std::memory_order_relaxed) };
+}
+
+MemoryAccounting::Usage MemoryAccounting::Total() const {
+  return { m_total.current.load(std::memory_order_relaxed), m_total.peak.load(std::memory_order_relaxed) };
+}
+
+void MemoryAccounting::ResetPeaks() {
+  for (Counter& c : m_counters) c.peak.store(c.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  m_total.peak.store(m_total.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void MemoryAccounting::SetBudget(uint64_t bytes) {
+  m_budget.store(bytes, std::memory_order_relaxed);
+  if (OverBudget()) m_budgetExceeded.store(true, std::memory_order_relaxed);
+}
+
+bool MemoryAccounting::OverBudget() const {
+  const uint64_t budget = Budget();
+  return budget && m_total.current.load(std::memory_order_relaxed) > budget;
+}
+
+std::string MemoryAccounting::Format(uint64_t processPrivateBytes) const {
+  std::string out;
+  char line[128];
+  const auto row = [&](const char* name, uint64_t current, uint64_t peak) {
+    std::snprintf(line, sizeof(line), "%-20s %12.1f %12.1f\n", name, (double)current / 1024.0, (double)peak / 1024.0);
+    out += line;
+  };
+  std::snprintf(line, sizeof(line), "%-20s %12s %12s\n", "subsystem", "current_kb", "peak_kb");
+  out += line;
+  for (size_t i = 0; i < kSubsystems; ++i) {
+    const Usage u = Get((MemorySubsystem)i);
+    row(MemorySubsystemName((MemorySubsystem)i), u.current, u.peak);
+  }
+  const Usage total = Total();
+  row("(tracked total)", total.current, total.peak);
+  if (processPrivateBytes) {
+    std::snprintf(line, sizeof(line), "%-20s %12.1f\n%-20s %12.1f\n", "(process private)",
+                  (double)processPrivateBytes / 1024.0, "(untracked)",
+                  processPrivateBytes > total.current ? (double)(processPrivateBytes - total.current) / 1024.0 : 0.0);
+    out += line;
+  }
+  if (const uint64_t budget = Budget()) {
+    std::snprintf(line, sizeof(line), "%-20s %12.1f%s\n", "(budget)", (double)budget / 1024.0,
+                  total.current > budget ? "  OVER" : "");
+    out += line;
+  }
+  return out;
+}
+
+std::string MemoryAccounting::ToJson(uint64_t processPrivateBytes) const {
+  std::string out = "{\"subsystems\":{";
+  for (size_t i = 0; i < kSubsystems; ++i) {
+    if (i) out += ',';
+    AppendUsageJson(&out, MemorySubsystemName((MemorySubsystem)i), Get((MemorySubsystem)i));
+  }
+  out += "},";
+  AppendUsageJson(&out, "total", Total());
+  char buf[96];
+  std::snprintf(buf, sizeof(buf), ",\"budget\":%llu,\"over_budget\":%s", (unsigned long long)Budget(),
+                OverBudget() ? "true" : "false");
+  out += buf;
+  if (processPrivateBytes) {
+    std::snprintf(buf, sizeof(buf), ",\"process_private\":%llu", (unsigned long long)processPrivateBytes);
+    out += buf;
+  }
+  out += '}';
+  return out;
+}
+
+MemoryAccounting& ProcessMemoryAccounting() {
+  static MemoryAccounting accounting;
+  return accounting;
+}
+
+void MemoryCharge::Set(size_t bytes) {
+  if (bytes > m_bytes) {
+    m_accounting.Add(m_subsystem, bytes - m_bytes);
+  } else if (bytes < m_bytes) {
+    m_accounting.Sub(m_subsystem, m_bytes - bytes);
+  }
+  m_bytes = bytes;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 按子系统统计内存：各子系统的当前字节数与峰值（主程序与悬浮球共用，不依赖 Win32）。
+// 计数只覆盖各子系统自己登记的大块内存（GIF 帧、DIB/位图、IPC 缓冲、气泡场景、日志缓冲），
+// 报告里另附进程私有字节，两者之差即为未登记部分（堆碎片、系统库、代码页等）。
+//
+// 按需导出：向悬浮球发送注册消息 kMemoryReportMessageName，悬浮球把文本报告写入日志；
+// wParam 为非零窗口句柄时，另以 WM_COPYDATA（dwData = kBallIpcMemoryReport）把 JSON 报告发回该窗口。
+// 主程序经方法通道 dumpMemoryReport 返回这份 JSON。
+constexpr wchar_t kMemoryReportMessageName[] = L"ChatDesktop.MemoryReport";
+
+enum class MemorySubsystem : uint8_t {
+  AnimationFrames, // 合成好的 GIF 帧及加载时的临时缓冲
+  RenderResources, // DIB、D2D 位图与渲染目标表面
+  IpcBuffers,      // 快照共享映射与本地副本
+  BubbleScene,     // 气泡的行模型与字形图集
+  Logging,         // 日志环形缓冲与长消息旁路队列
+  kCount,
+};
+
+// 报告中的名称（snake_case，JSON 键与文本报告共用）
+const char* MemorySubsystemName(MemorySubsystem subsystem);
+
+class MemoryAccounting {
+public:
+  static constexpr size_t kSubsystems = (size_t)MemorySubsystem::kCount;
+
+  struct Usage {
+    uint64_t current{0};
+    uint64_t peak{0};
+  };
+
+  // 线程安全、无锁；释放量大于当前值时按 0 计（登记方的 bug 不应让报告溢出成天文数字）
+  void Add(MemorySubsystem subsystem, size_t bytes);
+  void Sub(MemorySubsystem subsystem, size_t bytes);
+
+  Usage Get(MemorySubsystem subsystem) const;
+  Usage Total() const;
+  // 峰值回落到当前值（例如加载完成后想观察稳态峰值）
+  void ResetPeaks();
+
+  // 总量预算（0 表示不限）。总量从预算以内增长到超出（或设置时已超出）时置位，由 TakeBudgetExceeded 取走
+  void SetBudget(uint64_t bytes);
+  uint64_t Budget() const { return m_budget.load(std::memory_order_relaxed); }
+  bool OverBudget() const;
+  bool TakeBudgetExceeded() { return m_budgetExceeded.exchange(false, std::memory_order_relaxed); }
+
+  // processPrivateBytes 为 0 时省略进程总量与未登记部分
+  std::string Format(uint64_t processPrivateBytes = 0) const;
+  // {"subsystems":{"<name>":{"current":n,"peak":n},...},"total":{...},"budget":n,"over_budget":b[,"process_private":n]}
+  std::string ToJson(uint64_t processPrivateBytes = 0) const;
+
+private:
+  struct Counter {
+    std::atomic<uint64_t> current{0};
+    std::atomic<uint64_t> peak{0};
+  };
+
+  static void Raise(std::atomic<uint64_t>& peak, uint64_t value);
+
+  Counter m_counters[kSubsystems];
+  Counter m_total;
+  std::atomic<uint64_t> m_budget{0};
+  std::atomic<bool> m_budgetExceeded{false};
+};
+
+// 进程内共享的实例（只含原子量，析构无副作用；静态对象析构期间登记的释放仍然安全）
+MemoryAccounting& ProcessMemoryAccounting();
+
+// RAII：持有某子系统的一笔登记，Set 调整到新的字节数，析构时全部释放。
+// 单个对象不做同步，跨线程使用时由持有者加锁；底层计数本身是线程安全的。
+class MemoryCharge {
+public:
+  explicit MemoryCharge(MemorySubsystem subsystem, MemoryAccounting& accounting = ProcessMemoryAccounting())
+    : m_accounting(accounting), m_subsystem(subsystem) {}
+  ~MemoryCharge() { Set(0); }
+  MemoryCharge(const MemoryCharge&) = delete;
+  MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+  void Set(size_t bytes);
+  void Add(size_t bytes) { Set(m_bytes + bytes); }
+  void Sub(size_t bytes) { Set(bytes < m_bytes ? m_bytes - bytes : 0); }
+  size_t Bytes() const { return m_bytes; }
+
+private:
+  MemoryAccounting& m_accounting;
+  MemorySubsystem m_subsystem;
+  size_t m_bytes{0};
+};
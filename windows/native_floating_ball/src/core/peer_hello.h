@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+
+// 主程序与悬浮球的注册握手（代替每次交互都 FindWindow/EnumWindows 查找对方）。
+//
+// 双方在窗口创建后各广播一次注册消息 kPeerHelloMessageName：
+//   wParam = 发送方顶层窗口 HWND
+//   lParam = 发送方角色（kPeerRole*），带 kPeerHelloReply 位表示这是应答、无需再回
+// 收到对方的广播后缓存其 HWND 并回一条应答，先启动的一方因此也能拿到后启动方的句柄。
+// 使用缓存前只做廉价校验（IsWindow + 所属进程未变），失效时才回退到按类名查找。
+constexpr wchar_t kPeerHelloMessageName[] = L"ChatDesktop.PeerHello";
+constexpr uint32_t kPeerRoleMain = 1;  // Flutter 主窗口
+constexpr uint32_t kPeerRoleBall = 2;  // 原生悬浮球
+constexpr uint32_t kPeerHelloReply = 0x100u;
+constexpr uint32_t kPeerRoleMask = 0xFFu;
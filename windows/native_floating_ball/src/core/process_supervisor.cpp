@@ -0,0 +1,102 @@
+#include "process_supervisor.h"
+#include <algorithm>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 监管线程检查 Stop 的间隔
+constexpr std::chrono::milliseconds kSlice(50);
+
+std::chrono::milliseconds Since(Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+}
+
+} // namespace
+
+bool RestartBackoff::Next(std::chrono::milliseconds uptime, std::chrono::milliseconds* delay) {
+  if (uptime >= m_stableRun) m_consecutive = 0;
+  if (++m_consecutive > m_maxRestarts) return false;
+  auto d = m_initial;
+  for (int i = 1; i < m_consecutive && d < m_max; ++i) d *= 2;
+  *delay = (std::min)(d, m_max);
+  return true;
+}
+
+void ProcessSupervisor::Start() {
+  std::lock_guard<std::mutex> lock(m_threadMutex);
+  if (m_running.load(std::memory_order_acquire)) return;
+  if (m_thread.joinable()) m_thread.join(); // 上一轮已自行结束
+  m_stop.store(false);
+  m_terminateOnStop.store(false);
+  m_running.store(true, std::memory_order_release);
+  m_thread = std::thread([this] { Run(); });
+}
+
+void ProcessSupervisor::Stop(bool terminateChild) {
+  std::lock_guard<std::mutex> lock(m_threadMutex);
+  m_terminateOnStop.store(terminateChild);
+  m_stop.store(true);
+  if (m_thread.joinable()) m_thread.join();
+}
+
+bool ProcessSupervisor::SleepUnlessStopped(std::chrono::milliseconds duration) {
+  const Clock::time_point until = Clock::now() + duration;
+  while (!m_stop.load()) {
+    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(until - Clock::now());
+    if (left.count() <= 0) return true;
+    std::this_thread::sleep_for((std::min)(left, kSlice));
+  }
+  return false;
+}
+
+void ProcessSupervisor::Run() {
+  RestartBackoff backoff(m_options.initialBackoff, m_options.maxBackoff, m_options.stableRun,
+                         m_options.maxRestarts);
+  while (!m_stop.load()) {
+    ChildProcess child;
+    if (!child.Spawn(m_options.path, m_options.args)) {
+      m_listener(Event::SpawnFailed, 0, 0);
+      break;
+    }
+    const Clock::time_point started = Clock::now();
+    bool ready = false;
+    bool timeoutReported = false;
+    bool exited = false;
+    while (!exited) {
+      if (m_stop.load()) {
+        if (m_terminateOnStop.load()) child.Terminate();
+        m_running.store(false, std::memory_order_release);
+        return;
+      }
+      switch (child.Wait(kSlice)) {
+      case ChildProcess::WaitResult::Ready:
+        ready = true;
+        m_listener(Event::Ready, child.Pid(), 0);
+        break;
+      case ChildProcess::WaitResult::Exited:
+        exited = true;
+        break;
+      case ChildProcess::WaitResult::Timeout:
+        if (!ready && !timeoutReported && Since(started) >= m_options.readyTimeout) {
+          timeoutReported = true;
+          m_listener(Event::ReadyTimeout, child.Pid(), 0);
+        }
+        break;
+      }
+    }
+    if (child.ExitCode() == 0) {
+      m_listener(Event::Exited, child.Pid(), 0);
+      break;
+    }
+    std::chrono::milliseconds delay{0};
+    if (!backoff.Next(Since(started), &delay)) {
+      m_listener(Event::GaveUp, child.Pid(), child.ExitCode());
+      break;
+    }
+    m_listener(Event::Crashed, child.Pid(), child.ExitCode());
+    if (!SleepUnlessStopped(delay)) break;
+    m_restarts.fetch_add(1, std::memory_order_relaxed);
+  }
+  m_running.store(false, std::memory_order_release);
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 子进程监管：直接创建子进程（Windows 上是 CreateProcessW，不经 cmd.exe），等待子进程的就绪信号，
+// 异常退出时按指数退避重启。主程序用它拉起悬浮球，就绪后立刻发送第一份快照，不再固定等待。
+//
+// 就绪信号：启动时在参数末尾追加 "--ready=<token>"，token 指向一个只被该子进程继承的内核对象
+// （Windows 为可继承的事件句柄，其余平台为管道写端的 fd）。子进程在窗口与资源都就绪后调用
+// SignalSupervisorReady；手动启动（没有该参数）时什么也不做。
+constexpr char kSupervisorReadyArg[] = "--ready=";
+
+// 子进程端：arg 为某个命令行参数；是就绪参数时发出信号并返回 true（只应调用一次）
+bool SignalSupervisorReady(std::string_view arg);
+
+// 一个子进程（平台相关部分）。析构只关闭句柄，不结束子进程
+class ChildProcess {
+public:
+  enum class WaitResult : uint8_t { Ready, Exited, Timeout };
+
+  ChildProcess() = default;
+  ~ChildProcess();
+  ChildProcess(const ChildProcess&) = delete;
+  ChildProcess& operator=(const ChildProcess&) = delete;
+
+  // path 与 args 为 UTF-8，args 不含程序名；工作目录为 path 所在目录
+  bool Spawn(const std::string& path, const std::vector<std::string>& args);
+  // 等待就绪或退出，以先发生者为准；就绪只报告一次，之后只等退出
+  WaitResult Wait(std::chrono::milliseconds timeout);
+  void Terminate();
+
+  uint32_t Pid() const { return m_pid; }
+  // 仅在 Wait 返回 Exited 后有效；被信号结束时为 128 + 信号值（POSIX）
+  int ExitCode() const { return m_exitCode; }
+
+private:
+  void Close();
+
+  uint32_t m_pid{0};
+  int m_exitCode{0};
+  bool m_ready{false};
+  bool m_exited{false};
+#ifdef _WIN32
+  void* m_process{nullptr};
+  void* m_readyEvent{nullptr};
+#else
+  int m_readyFd{-1};
+#endif
+};
+
+// 重启退避：连续异常退出时依次等待 initial、2×initial……封顶 max；
+// 子进程稳定运行超过 stableRun 后重新计数；连续重启超过 maxRestarts 次后放弃。
+class RestartBackoff {
+public:
+  RestartBackoff(std::chrono::milliseconds initial, std::chrono::milliseconds max,
+                 std::chrono::milliseconds stableRun, int maxRestarts)
+    : m_initial(initial), m_max(max), m_stableRun(stableRun), m_maxRestarts(maxRestarts) {}
+
+  // 子进程异常退出后调用；返回 false 表示应放弃
+  bool Next(std::chrono::milliseconds uptime, std::chrono::milliseconds* delay);
+  int Consecutive() const { return m_consecutive; }
+
+private:
+  std::chrono::milliseconds m_initial;
+  std::chrono::milliseconds m_max;
+  std::chrono::milliseconds m_stableRun;
+  int m_maxRestarts;
+  int m_consecutive{0};
+};
+
+// 在后台线程上运行 ChildProcess 的“启动 → 等就绪 → 等退出 → 退避重启”循环。
+// 退出码为 0 视为用户主动关闭，不再重启。
+class ProcessSupervisor {
+public:
+  struct Options {
+    std::string path;
+    std::vector<std::string> args;
+    std::chrono::milliseconds readyTimeout{10000};
+    std::chrono::milliseconds initialBackoff{250};
+    std::chrono::milliseconds maxBackoff{8000};
+    std::chrono::milliseconds stableRun{30000};
+    int maxRestarts{5};
+  };
+
+  enum class Event : uint8_t {
+    Ready,        // 子进程发出了就绪信号
+    ReadyTimeout, // 超时仍未就绪（子进程仍在运行，继续监管）
+    Crashed,      // 异常退出，将在退避后重启
+    Exited,       // 正常退出（退出码 0），监管结束
+    SpawnFailed,  // 无法创建进程，监管结束
+    GaveUp,       // 连续重启次数超限，监管结束
+  };
+  // 在监管线程上调用
+  using Listener = std::function<void(Event event, uint32_t pid, int exitCode)>;
+
+  ProcessSupervisor(Options options, Listener listener)
+    : m_options(std::move(options)), m_listener(std::move(listener)) {}
+  ~ProcessSupervisor() { Stop(); }
+  ProcessSupervisor(const ProcessSupervisor&) = delete;
+  ProcessSupervisor& operator=(const ProcessSupervisor&) = delete;
+
+  void Start();
+  // 停止监管并等待线程结束（至多一个等待片）；terminateChild 为 false 时子进程继续运行
+  void Stop(bool terminateChild = false);
+  bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+  int Restarts() const { return m_restarts.load(std::memory_order_relaxed); }
+
+private:
+  void Run();
+  // 分片等待，期间收到 Stop 返回 false
+  bool SleepUnlessStopped(std::chrono::milliseconds duration);
+
+  Options m_options;
+  Listener m_listener;
+  std::thread m_thread;
+  std::mutex m_threadMutex;
+  std::atomic<bool> m_stop{false};
+  std::atomic<bool> m_terminateOnStop{false};
+  std::atomic<bool> m_running{false};
+  std::atomic<int> m_restarts{0};
+};
@@ -0,0 +1,118 @@
+#include "process_supervisor.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdlib>
+
+extern char** environ;
+
+bool SignalSupervisorReady(std::string_view arg) {
+  const std::string_view prefix(kSupervisorReadyArg);
+  if (arg.substr(0, prefix.size()) != prefix) return false;
+  const std::string token(arg.substr(prefix.size()));
+  char* end = nullptr;
+  const long fd = std::strtol(token.c_str(), &end, 10);
+  if (token.empty() || *end || fd < 0) return false;
+  const char byte = 'r';
+  const bool ok = write((int)fd, &byte, 1) == 1;
+  close((int)fd);
+  return ok;
+}
+
+ChildProcess::~ChildProcess() {
+  Close();
+}
+
+bool ChildProcess::Spawn(const std::string& path, const std::vector<std::string>& args) {
+  Close();
+  int fds[2];
+  if (pipe(fds) != 0) return false;
+  // 只有写端被子进程继承
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  std::vector<std::string> argv_storage;
+  argv_storage.reserve(args.size() + 2);
+  argv_storage.push_back(path);
+  argv_storage.insert(argv_storage.end(), args.begin(), args.end());
+  argv_storage.push_back(std::string(kSupervisorReadyArg) + std::to_string(fds[1]));
+  std::vector<char*> argv;
+  for (std::string& a : argv_storage) argv.push_back(a.data());
+  argv.push_back(nullptr);
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  const size_t slash = path.rfind('/');
+  if (slash != std::string::npos && slash > 0) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+    posix_spawn_file_actions_addchdir_np(&actions, path.substr(0, slash).c_str());
+#endif
+  }
+  pid_t pid = 0;
+  const int rc = posix_spawn(&pid, path.c_str(), &actions, nullptr, argv.data(), environ);
+  posix_spawn_file_actions_destroy(&actions);
+  close(fds[1]);
+  if (rc != 0) {
+    close(fds[0]);
+    return false;
+  }
+  m_pid = (uint32_t)pid;
+  m_readyFd = fds[0];
+  m_ready = false;
+  m_exited = false;
+  return true;
+}
+
+ChildProcess::WaitResult ChildProcess::Wait(std::chrono::milliseconds timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  for (;;) {
+    if (m_exited) return WaitResult::Exited;
+    // 先看就绪（子进程可能发出信号后立即退出，两者都要报告）
+    if (!m_ready && m_readyFd >= 0) {
+      pollfd p{m_readyFd, POLLIN, 0};
+      if (poll(&p, 1, 0) > 0) {
+        char byte = 0;
+        const ssize_t n = read(m_readyFd, &byte, 1);
+        close(m_readyFd);
+        m_readyFd = -1;
+        if (n == 1) {
+          m_ready = true;
+          return WaitResult::Ready;
+        }
+      }
+    }
+    int status = 0;
+    if (m_pid && waitpid((pid_t)m_pid, &status, WNOHANG) == (pid_t)m_pid) {
+      m_exited = true;
+      m_exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : WIFSIGNALED(status) ? 128 + WTERMSIG(status) : 1;
+      return WaitResult::Exited;
+    }
+    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    if (left.count() <= 0) return WaitResult::Timeout;
+    // 等就绪时阻塞在管道上，否则短睡后再查退出
+    const int slice = (int)(std::min)(left.count(), (decltype(left.count()))5);
+    if (!m_ready && m_readyFd >= 0) {
+      pollfd p{m_readyFd, POLLIN, 0};
+      poll(&p, 1, slice);
+    } else {
+      poll(nullptr, 0, slice);
+    }
+  }
+}
+
+void ChildProcess::Terminate() {
+  if (m_pid && !m_exited) {
+    kill((pid_t)m_pid, SIGKILL);
+    int status = 0;
+    waitpid((pid_t)m_pid, &status, 0);
+    m_exited = true;
+    m_exitCode = 128 + SIGKILL;
+  }
+}
+
+void ChildProcess::Close() {
+  if (m_readyFd >= 0) close(m_readyFd);
+  m_readyFd = -1;
+}
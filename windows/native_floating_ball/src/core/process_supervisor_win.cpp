@@ -0,0 +1,144 @@
+#include "process_supervisor.h"
+#include <windows.h>
+#include <cstdlib>
+#include "utf_transcode.h"
+
+namespace {
+
+std::wstring Widen(const std::string& s) {
+  std::u16string wide;
+  Utf8ToUtf16(s, &wide);
+  return std::wstring(wide.begin(), wide.end());
+}
+
+// 按 CommandLineToArgvW 的规则给一个参数加引号
+void AppendQuoted(std::wstring& cmd, const std::wstring& arg) {
+  if (!arg.empty() && arg.find_first_of(L" \t\n\v\"") == std::wstring::npos) {
+    cmd += arg;
+    return;
+  }
+  cmd += L'"';
+  for (size_t i = 0;; ++i) {
+    size_t backslashes = 0;
+    while (i < arg.size() && arg[i] == L'\\') { ++i; ++backslashes; }
+    if (i == arg.size()) {
+      cmd.append(backslashes * 2, L'\\');
+      break;
+    }
+    if (arg[i] == L'"') {
+      cmd.append(backslashes * 2 + 1, L'\\');
+    } else {
+      cmd.append(backslashes, L'\\');
+    }
+    cmd += arg[i];
+  }
+  cmd += L'"';
+}
+
+} // namespace
+
+bool SignalSupervisorReady(std::string_view arg) {
+  const std::string_view prefix(kSupervisorReadyArg);
+  if (arg.substr(0, prefix.size()) != prefix) return false;
+  const std::string token(arg.substr(prefix.size()));
+  char* end = nullptr;
+  const unsigned long long value = std::strtoull(token.c_str(), &end, 10);
+  if (token.empty() || *end || !value) return false;
+  HANDLE event = reinterpret_cast<HANDLE>((uintptr_t)value);
+  const bool ok = SetEvent(event) != FALSE;
+  CloseHandle(event);
+  return ok;
+}
+
+ChildProcess::~ChildProcess() {
+  Close();
+}
+
+bool ChildProcess::Spawn(const std::string& path, const std::vector<std::string>& args) {
+  Close();
+  SECURITY_ATTRIBUTES sa{sizeof(sa), nullptr, TRUE};
+  HANDLE ready = CreateEventW(&sa, TRUE, FALSE, nullptr);
+  if (!ready) return false;
+
+  const std::wstring wpath = Widen(path);
+  std::wstring cmd;
+  AppendQuoted(cmd, wpath);
+  for (const std::string& arg : args) {
+    cmd += L' ';
+    AppendQuoted(cmd, Widen(arg));
+  }
+  cmd += L' ';
+  cmd += Widen(kSupervisorReadyArg) + std::to_wstring((uintptr_t)ready);
+
+  std::wstring dir = wpath;
+  const size_t slash = dir.find_last_of(L"\\/");
+  dir = slash == std::wstring::npos ? std::wstring() : dir.substr(0, slash);
+
+  // 只继承就绪事件，不把主程序的其它可继承句柄带进子进程
+  SIZE_T attrSize = 0;
+  InitializeProcThreadAttributeList(nullptr, 1, 0, &attrSize);
+  std::vector<unsigned char> attrBuf(attrSize);
+  auto attrs = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attrBuf.data());
+  if (!InitializeProcThreadAttributeList(attrs, 1, 0, &attrSize)) {
+    CloseHandle(ready);
+    return false;
+  }
+  UpdateProcThreadAttribute(attrs, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST, &ready, sizeof(ready), nullptr, nullptr);
+
+  STARTUPINFOEXW si{};
+  si.StartupInfo.cb = sizeof(si);
+  si.lpAttributeList = attrs;
+  PROCESS_INFORMATION pi{};
+  const BOOL ok = CreateProcessW(wpath.c_str(), cmd.data(), nullptr, nullptr, TRUE,
+                                 EXTENDED_STARTUPINFO_PRESENT, nullptr,
+                                 dir.empty() ? nullptr : dir.c_str(), &si.StartupInfo, &pi);
+  DeleteProcThreadAttributeList(attrs);
+  if (!ok) {
+    CloseHandle(ready);
+    return false;
+  }
+  CloseHandle(pi.hThread);
+  m_process = pi.hProcess;
+  m_readyEvent = ready;
+  m_pid = pi.dwProcessId;
+  m_ready = false;
+  m_exited = false;
+  return true;
+}
+
+ChildProcess::WaitResult ChildProcess::Wait(std::chrono::milliseconds timeout) {
+  if (m_exited) return WaitResult::Exited;
+  if (!m_process) return WaitResult::Exited;
+  HANDLE handles[2];
+  DWORD count = 0;
+  // 就绪事件排在前面：子进程发出信号后立即退出时，两者都会被依次报告
+  if (!m_ready) handles[count++] = m_readyEvent;
+  handles[count++] = m_process;
+  const DWORD wait = WaitForMultipleObjects(count, handles, FALSE, (DWORD)timeout.count());
+  if (wait == WAIT_TIMEOUT) return WaitResult::Timeout;
+  if (wait >= WAIT_OBJECT_0 && wait < WAIT_OBJECT_0 + count && handles[wait - WAIT_OBJECT_0] == m_readyEvent) {
+    m_ready = true;
+    return WaitResult::Ready;
+  }
+  DWORD code = 1;
+  GetExitCodeProcess(m_process, &code);
+  m_exitCode = (int)code;
+  m_exited = true;
+  return WaitResult::Exited;
+}
+
+void ChildProcess::Terminate() {
+  if (m_process && !m_exited) {
+    TerminateProcess(m_process, 1);
+    WaitForSingleObject(m_process, 1000);
+    m_exited = true;
+    m_exitCode = 1;
+  }
+}
+
+void ChildProcess::Close() {
+  if (m_process) CloseHandle(m_process);
+  if (m_readyEvent) CloseHandle(m_readyEvent);
+  m_process = nullptr;
+  m_readyEvent = nullptr;
+}
@@ -0,0 +1,153 @@
+#include "seqlock_snapshot.h"
+#include <cstring>
+#include <new>
+
+namespace {
+using Word = std::atomic<uint64_t>;
+static_assert(Word::is_always_lock_free, "shared-memory seqlock needs lock-free 64-bit atomics");
+static_assert(sizeof(Word) == sizeof(uint64_t), "atomic<uint64_t> must be layout-compatible with uint64_t");
+
+struct Header {
+  uint32_t magic;
+  uint32_t layoutVersion;
+  uint64_t capacity;   // 每槽数据区字节数（8 的倍数）
+  Word version;        // 已发布的快照数；0 表示还没有快照，当前槽为 version & 1
+  uint8_t pad[64 - 24];
+};
+static_assert(sizeof(Header) == 64, "header occupies one cache line");
+
+constexpr size_t kSlotHeader = 16; // seq + size
+
+size_t SlotStride(size_t capacity) { return kSlotHeader + capacity; }
+
+Header* HeaderOf(uint8_t* base) { return reinterpret_cast<Header*>(base); }
+const Header* HeaderOf(const uint8_t* base) { return reinterpret_cast<const Header*>(base); }
+
+Word* SlotWords(uint8_t* base, size_t capacity, uint64_t slot) {
+  return reinterpret_cast<Word*>(base + sizeof(Header) + slot * SlotStride(capacity));
+}
+const Word* SlotWords(const uint8_t* base, size_t capacity, uint64_t slot) {
+  return reinterpret_cast<const Word*>(base + sizeof(Header) + slot * SlotStride(capacity));
+}
+
+size_t AlignCapacity(size_t capacity) { return (capacity + 7) & ~(size_t)7; }
+}
+
+size_t SeqlockSnapshot::RegionSize(size_t capacity) {
+  return sizeof(Header) + 2 * SlotStride(AlignCapacity(capacity));
+}
+
+bool SeqlockSnapshotWriter::Attach(void* base, size_t regionSize, size_t capacity, bool initialize) {
+  capacity = AlignCapacity(capacity);
+  if (!base || ((uintptr_t)base & 7) || regionSize < SeqlockSnapshot::RegionSize(capacity)) return false;
+  m_base = static_cast<uint8_t*>(base);
+  Header* h = HeaderOf(m_base);
+  if (initialize) {
+    std::memset(m_base, 0, SeqlockSnapshot::RegionSize(capacity));
+    h->magic = SeqlockSnapshot::kMagic;
+    h->layoutVersion = SeqlockSnapshot::kLayoutVersion;
+    h->capacity = capacity;
+    new (&h->version) Word(0);
+    for (uint64_t slot = 0; slot < 2; ++slot) {
+      Word* w = SlotWords(m_base, capacity, slot);
+      new (&w[0]) Word(0);
+      new (&w[1]) Word(0);
+      for (size_t i = 0; i < capacity / 8; ++i) new (&w[2 + i]) Word(0);
+    }
+  } else if (h->magic != SeqlockSnapshot::kMagic || h->layoutVersion != SeqlockSnapshot::kLayoutVersion ||
+             h->capacity != capacity) {
+    m_base = nullptr;
+    return false;
+  }
+  m_capacity = capacity;
+  return true;
+}
+
+uint64_t SeqlockSnapshotWriter::Version() const {
+  return m_base ? HeaderOf(m_base)->version.load(std::memory_order_acquire) : 0;
+}
+
+bool SeqlockSnapshotWriter::Publish(const void* data, size_t size, uint64_t* versionOut) {
+  if (!m_base || size > m_capacity) return false;
+  Header* h = HeaderOf(m_base);
+  const uint64_t version = h->version.load(std::memory_order_relaxed) + 1;
+  Word* slot = SlotWords(m_base, m_capacity, version & 1);
+  Word& seq = slot[0];
+  Word& len = slot[1];
+  Word* words = slot + 2;
+
+  const uint64_t s = seq.load(std::memory_order_relaxed);
+  seq.store(s + 1, std::memory_order_relaxed); // 奇数：写入中
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const uint8_t* src = static_cast<const uint8_t*>(data);
+  const size_t full = size / 8;
+  for (size_t i = 0; i < full; ++i) {
+    uint64_t v;
+    std::memcpy(&v, src + i * 8, 8);
+    words[i].store(v, std::memory_order_relaxed);
+  }
+  if (size % 8) {
+    uint64_t v = 0;
+    std::memcpy(&v, src + full * 8, size % 8);
+    words[full].store(v, std::memory_order_relaxed);
+  }
+  len.store(size, std::memory_order_relaxed);
+
+  seq.store(s + 2, std::memory_order_release);        // 偶数：写入完成
+  h->version.store(version, std::memory_order_release);
+  if (versionOut) *versionOut = version;
+  return true;
+}
+
+bool SeqlockSnapshotReader::Attach(const void* base, size_t regionSize) {
+  m_base = nullptr;
+  if (!base || ((uintptr_t)base & 7) || regionSize < sizeof(Header)) return false;
+  const uint8_t* b = static_cast<const uint8_t*>(base);
+  const Header* h = HeaderOf(b);
+  if (h->magic != SeqlockSnapshot::kMagic || h->layoutVersion != SeqlockSnapshot::kLayoutVersion ||
+      (h->capacity & 7) || regionSize < SeqlockSnapshot::RegionSize((size_t)h->capacity)) {
+    return false;
+  }
+  m_base = b;
+  m_capacity = (size_t)h->capacity;
+  return true;
+}
+
+uint64_t SeqlockSnapshotReader::Version() const {
+  return m_base ? HeaderOf(m_base)->version.load(std::memory_order_acquire) : 0;
+}
+
+SeqlockSnapshotReader::Status SeqlockSnapshotReader::Read(std::vector<uint8_t>* out, uint64_t* versionOut, int maxRetries) {
+  if (!m_base) return Status::Invalid;
+  const Header* h = HeaderOf(m_base);
+  for (int attempt = 0; attempt <= maxRetries; ++attempt) {
+    if (attempt) ++m_retries;
+    const uint64_t version = h->version.load(std::memory_order_acquire);
+    if (version == 0) return Status::Empty;
+    const Word* slot = SlotWords(m_base, m_capacity, version & 1);
+    const uint64_t s1 = slot[0].load(std::memory_order_acquire);
+    if (s1 & 1) continue;
+    const uint64_t size = slot[1].load(std::memory_order_relaxed);
+    if (size > m_capacity) continue;
+
+    out->resize((size_t)size);
+    const Word* words = slot + 2;
+    const size_t full = (size_t)size / 8;
+    uint8_t* dst = out->data();
+    for (size_t i = 0; i < full; ++i) {
+      const uint64_t v = words[i].load(std::memory_order_relaxed);
+      std::memcpy(dst + i * 8, &v, 8);
+    }
+    if (size % 8) {
+      const uint64_t v = words[full].load(std::memory_order_relaxed);
+      std::memcpy(dst + full * 8, &v, (size_t)size % 8);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot[0].load(std::memory_order_relaxed) != s1) continue; // 读的同时被覆盖
+    if (versionOut) *versionOut = version;
+    return Status::Ok;
+  }
+  return Status::Busy;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 单写者/多读者的快照通道，放在一段（可跨进程共享的）原始内存里。
+// 双缓冲 + 每槽一个 seqlock：写者总是写“非当前”槽（写前序号置奇数、写完置偶数），
+// 再发布全局版本号；读者按版本号选槽、拷出数据后复核序号，读到一半被覆盖就重试。
+// 读写双方都不加锁、不进内核，写者也不会因读者而阻塞。
+// 数据区按 64 位原子字读写（relaxed + fence），不存在 C++ 意义上的数据竞争。
+//
+// 布局：Header | Slot0 | Slot1，Slot = { seq, size, words[capacity / 8] }
+class SeqlockSnapshot {
+public:
+  static constexpr uint32_t kMagic = 0x53534443u; // "CDSS"
+  static constexpr uint32_t kLayoutVersion = 1;
+
+  // 容纳 capacity 字节快照所需的区域大小
+  static size_t RegionSize(size_t capacity);
+};
+
+class SeqlockSnapshotWriter {
+public:
+  // initialize=true 时清零并写入头部（区域的创建者调用）
+  bool Attach(void* base, size_t regionSize, size_t capacity, bool initialize);
+  // 发布一份新快照；超过容量时返回 false（调用方改走其它通道）
+  bool Publish(const void* data, size_t size, uint64_t* versionOut = nullptr);
+  size_t Capacity() const { return m_capacity; }
+  uint64_t Version() const;
+
+private:
+  uint8_t* m_base{nullptr};
+  size_t m_capacity{0};
+};
+
+class SeqlockSnapshotReader {
+public:
+  enum class Status : uint8_t { Ok, Empty, Busy, Invalid };
+
+  bool Attach(const void* base, size_t regionSize);
+  // 读取当前快照到 out（复用其容量）；写者持续覆盖导致 maxRetries 次都不一致时返回 Busy
+  Status Read(std::vector<uint8_t>* out, uint64_t* versionOut, int maxRetries = 64);
+  uint64_t Version() const;
+  uint64_t Retries() const { return m_retries; }
+
+private:
+  const uint8_t* m_base{nullptr};
+  size_t m_capacity{0};
+  uint64_t m_retries{0};
+};
@@ -0,0 +1,223 @@
+#include "settings_store.h"
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+bool ValidKey(std::string_view key) {
+  return !key.empty() && key[0] != '#' && key.find_first_of("=\r\n") == std::string_view::npos;
+}
+
+bool ValidValue(std::string_view value) {
+  return value.find_first_of("\r\n") == std::string_view::npos;
+}
+
+} // namespace
+
+bool SettingsStore::Open(const Options& options) {
+  Close();
+  bool readOk = true;
+  std::string text;
+  {
+    const std::filesystem::path path = std::filesystem::u8path(options.path);
+    std::error_code ec;
+    if (std::filesystem::exists(path, ec)) {
+      std::ifstream in(path, std::ios::binary);
+      if (in.is_open()) {
+        text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+      }
+      readOk = in.is_open() && !in.bad();
+    }
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_options = options;
+  m_values.clear();
+  ParseInto(text);
+  m_version = m_writtenVersion = 0;
+  m_flushRequests = 0;
+  m_pending = false;
+  m_failedVersion = 0;
+  m_stop = false;
+  m_open = true;
+  m_thread = std::thread([this] { Run(); });
+  return readOk;
+}
+
+void SettingsStore::Close() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_open) return;
+    m_stop = true;
+  }
+  m_changed.notify_all();
+  if (m_thread.joinable()) m_thread.join();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_open = false;
+  m_written.notify_all();
+}
+
+bool SettingsStore::IsOpen() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_open;
+}
+
+bool SettingsStore::Get(std::string_view key, std::string* value) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto it = m_values.find(key);
+  if (it == m_values.end()) return false;
+  if (value) *value = it->second;
+  return true;
+}
+
+int64_t SettingsStore::GetInt(std::string_view key, int64_t fallback) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto it = m_values.find(key);
+  if (it == m_values.end()) return fallback;
+  const std::string& s = it->second;
+  int64_t value = 0;
+  const auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+  return ec == std::errc() && end == s.data() + s.size() ? value : fallback;
+}
+
+bool SettingsStore::Set(std::string_view key, std::string_view value) {
+  if (!ValidKey(key) || !ValidValue(value)) return false;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_values.find(key);
+    if (it != m_values.end()) {
+      if (it->second == value) return true;
+      it->second.assign(value.data(), value.size());
+    } else {
+      m_values.emplace(std::string(key), std::string(value));
+    }
+    MarkDirtyLocked();
+  }
+  m_changed.notify_one();
+  return true;
+}
+
+bool SettingsStore::SetInt(std::string_view key, int64_t value) {
+  char buf[24];
+  const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+  return ec == std::errc() && Set(key, std::string_view(buf, (size_t)(end - buf)));
+}
+
+bool SettingsStore::Erase(std::string_view key) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_values.find(key);
+    if (it == m_values.end()) return false;
+    m_values.erase(it);
+    MarkDirtyLocked();
+  }
+  m_changed.notify_one();
+  return true;
+}
+
+void SettingsStore::ForEachWithPrefix(
+    std::string_view prefix, const std::function<void(const std::string& key, const std::string& value)>& fn) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto it = m_values.lower_bound(prefix); it != m_values.end(); ++it) {
+    if (it->first.compare(0, prefix.size(), prefix) != 0) break;
+    fn(it->first, it->second);
+  }
+}
+
+bool SettingsStore::Flush() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_version == m_writtenVersion) return true;
+  if (!m_open) return false;
+  const uint64_t target = m_version;
+  if (m_failedVersion >= target) m_failedVersion = 0; // 上次写这个版本失败了：重新写一次
+  ++m_flushRequests;
+  m_changed.notify_one();
+  m_written.wait(lock, [&] { return m_writtenVersion >= target || m_failedVersion >= target || !m_open; });
+  return m_writtenVersion >= target;
+}
+
+uint64_t SettingsStore::Writes() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_writes;
+}
+
+uint64_t SettingsStore::Failures() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_failures;
+}
+
+void SettingsStore::MarkDirtyLocked() {
+  const Clock::time_point now = Clock::now();
+  if (!m_pending) m_firstDirty = now;
+  m_lastDirty = now;
+  m_pending = true;
+  ++m_version;
+}
+
+void SettingsStore::Run() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    // 上次写失败的版本不自动重试，等新的修改或 Flush
+    const bool dirty = m_version != m_writtenVersion && (m_version != m_failedVersion || m_flushRequests);
+    if (!m_stop) {
+      if (!dirty) {
+        m_flushRequests = 0;
+        m_written.notify_all();
+        m_changed.wait(lock);
+        continue;
+      }
+      if (!m_flushRequests) {
+        const Clock::time_point due = (std::min)(m_lastDirty + m_options.debounce, m_firstDirty + m_options.maxDelay);
+        if (Clock::now() < due) {
+          m_changed.wait_until(lock, due);
+          continue;
+        }
+      }
+    } else if (m_version == m_writtenVersion) {
+      break;
+    }
+    const uint64_t version = m_version;
+    const std::string data = SerializeLocked();
+    const std::string path = m_options.path;
+    m_pending = false;
+    m_flushRequests = 0;
+    lock.unlock();
+    const bool ok = WriteFileAtomically(path, data);
+    lock.lock();
+    if (ok) {
+      m_writtenVersion = version;
+      ++m_writes;
+    } else {
+      m_failedVersion = version;
+      ++m_failures;
+    }
+    m_written.notify_all();
+    if (m_stop) break; // 退出前只再尝试一次
+  }
+}
+
+std::string SettingsStore::SerializeLocked() const {
+  std::string out = "# native_floating_ball settings\n";
+  for (const auto& [key, value] : m_values) {
+    out += key;
+    out += '=';
+    out += value;
+    out += '\n';
+  }
+  return out;
+}
+
+void SettingsStore::ParseInto(std::string_view text) {
+  while (!text.empty()) {
+    const size_t eol = text.find('\n');
+    std::string_view line = text.substr(0, eol);
+    text = eol == std::string_view::npos ? std::string_view() : text.substr(eol + 1);
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    if (line.empty() || line[0] == '#') continue;
+    const size_t eq = line.find('=');
+    if (eq == std::string_view::npos || eq == 0) continue;
+    m_values[std::string(line.substr(0, eq))] = std::string(line.substr(eq + 1));
+  }
+}
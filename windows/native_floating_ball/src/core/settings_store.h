@@ -0,0 +1,79 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// 悬浮球设置：启动时读入内存，之后的读取只查内存表；修改先记在内存里，由后台线程去抖合并后写盘。
+// 写盘是原子替换（写临时文件 → 刷盘 → 改名覆盖），写到一半崩溃时旧文件仍然完整。
+//
+// 文件格式：UTF-8 文本，每行 "key=value"，# 开头的行为注释。键不能含 '=' 或换行，值不能含换行。
+// 去抖：最后一次修改后 debounce 内没有新修改才写；持续修改时最迟 maxDelay 写一次。
+class SettingsStore {
+public:
+  struct Options {
+    std::string path; // UTF-8；所在目录须已存在
+    std::chrono::milliseconds debounce{500};
+    std::chrono::milliseconds maxDelay{5000};
+  };
+
+  SettingsStore() = default;
+  ~SettingsStore() { Close(); }
+  SettingsStore(const SettingsStore&) = delete;
+  SettingsStore& operator=(const SettingsStore&) = delete;
+
+  // 读入现有文件（不存在视为空）并启动写盘线程；文件存在但无法读取时返回 false，仍可使用内存表
+  bool Open(const Options& options);
+  // 写出尚未落盘的修改并停止线程
+  void Close();
+  bool IsOpen() const;
+
+  bool Get(std::string_view key, std::string* value) const;
+  int64_t GetInt(std::string_view key, int64_t fallback) const;
+  // 值未变化时不触发写盘；键或值不合法时返回 false
+  bool Set(std::string_view key, std::string_view value);
+  bool SetInt(std::string_view key, int64_t value);
+  bool Erase(std::string_view key);
+  // 对前缀匹配的每一项调用 fn（持锁调用，fn 内不可再访问本对象）
+  void ForEachWithPrefix(std::string_view prefix,
+                         const std::function<void(const std::string& key, const std::string& value)>& fn) const;
+
+  // 立即写出尚未落盘的修改并等待完成；返回是否成功（没有修改时为 true）
+  bool Flush();
+  uint64_t Writes() const;   // 实际写盘次数
+  uint64_t Failures() const; // 写盘失败次数（下次修改或 Flush 时重试）
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  void MarkDirtyLocked();
+  void Run();
+  std::string SerializeLocked() const;
+  void ParseInto(std::string_view text);
+
+  Options m_options;
+  std::map<std::string, std::string, std::less<>> m_values;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_changed;
+  std::condition_variable m_written;
+  std::thread m_thread;
+  uint64_t m_version{0};        // 每次修改加一
+  uint64_t m_writtenVersion{0}; // 已落盘的版本
+  uint64_t m_failedVersion{0};  // 最近一次写失败的版本
+  uint64_t m_flushRequests{0};
+  uint64_t m_writes{0};
+  uint64_t m_failures{0};
+  Clock::time_point m_firstDirty;
+  Clock::time_point m_lastDirty;
+  bool m_pending{false}; // 自上次开始写盘以来有新的修改
+  bool m_stop{false};
+  bool m_open{false};
+};
+
+// 原子替换：先写 path.tmp 并刷盘，再改名覆盖 path（平台相关）
+bool WriteFileAtomically(const std::string& path, std::string_view data);
@@ -0,0 +1,37 @@
+#include "settings_store.h"
+#include <windows.h>
+#include <algorithm>
+#include "utf_transcode.h"
+
+namespace {
+
+std::wstring Widen(const std::string& s) {
+  std::u16string wide;
+  Utf8ToUtf16(s, &wide);
+  return std::wstring(wide.begin(), wide.end());
+}
+
+} // namespace
+
+bool WriteFileAtomically(const std::string& path, std::string_view data) {
+  const std::wstring target = Widen(path);
+  const std::wstring tmp = target + L".tmp";
+  HANDLE file = CreateFileW(tmp.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return false;
+  bool ok = true;
+  size_t offset = 0;
+  while (ok && offset < data.size()) {
+    const DWORD chunk = (DWORD)(std::min)(data.size() - offset, (size_t)(1u << 30));
+    DWORD written = 0;
+    ok = WriteFile(file, data.data() + offset, chunk, &written, nullptr) && written == chunk;
+    offset += written;
+  }
+  ok = ok && FlushFileBuffers(file);
+  CloseHandle(file);
+  // MOVEFILE_WRITE_THROUGH：改名完成（元数据落盘）后才返回
+  if (!ok || !MoveFileExW(tmp.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+    DeleteFileW(tmp.c_str());
+    return false;
+  }
+  return true;
+}
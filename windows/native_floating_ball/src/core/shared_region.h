@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// 跨进程具名共享内存。Windows 用文件映射（Local\ 命名空间），其余平台用 POSIX shm_open，
+// 后者使 Linux 上可以对共享内存协议做压力测试。
+class SharedRegion {
+public:
+  SharedRegion() = default;
+  ~SharedRegion();
+  SharedRegion(const SharedRegion&) = delete;
+  SharedRegion& operator=(const SharedRegion&) = delete;
+
+  // 创建（或打开已存在的）区域并映射为可读写；创建者负责在析构时删除名字（POSIX）。
+  bool Create(const std::string& name, size_t size);
+  // 打开已存在的区域；size 必须不大于创建时的大小。
+  bool Open(const std::string& name, size_t size, bool writable = false);
+  void Close();
+
+  void* Data() const { return m_data; }
+  size_t Size() const { return m_size; }
+  bool IsOpen() const { return m_data != nullptr; }
+
+private:
+  void* m_data{nullptr};
+  size_t m_size{0};
+#ifdef _WIN32
+  void* m_mapping{nullptr};
+#else
+  std::string m_unlinkName; // 仅创建者非空
+#endif
+};
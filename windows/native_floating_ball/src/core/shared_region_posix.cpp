@@ -0,0 +1,59 @@
+#include "shared_region.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+std::string PosixName(const std::string& name) {
+  return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+}
+
+SharedRegion::~SharedRegion() {
+  Close();
+}
+
+bool SharedRegion::Create(const std::string& name, size_t size) {
+  Close();
+  const std::string path = PosixName(name);
+  const int fd = shm_open(path.c_str(), O_RDWR | O_CREAT, 0600);
+  if (fd < 0) return false;
+  struct stat st {};
+  if (fstat(fd, &st) != 0 || ((size_t)st.st_size < size && ftruncate(fd, (off_t)size) != 0)) {
+    close(fd);
+    return false;
+  }
+  void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) return false;
+  m_data = p;
+  m_size = size;
+  m_unlinkName = path;
+  return true;
+}
+
+bool SharedRegion::Open(const std::string& name, size_t size, bool writable) {
+  Close();
+  const int fd = shm_open(PosixName(name).c_str(), writable ? O_RDWR : O_RDONLY, 0);
+  if (fd < 0) return false;
+  struct stat st {};
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < size) {
+    close(fd);
+    return false;
+  }
+  void* p = mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) return false;
+  m_data = p;
+  m_size = size;
+  return true;
+}
+
+void SharedRegion::Close() {
+  if (m_data) munmap(m_data, m_size);
+  m_data = nullptr;
+  m_size = 0;
+  if (!m_unlinkName.empty()) shm_unlink(m_unlinkName.c_str());
+  m_unlinkName.clear();
+}
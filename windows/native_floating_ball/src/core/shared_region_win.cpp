@@ -0,0 +1,56 @@
+#include "shared_region.h"
+#include <windows.h>
+
+namespace {
+std::wstring MappingName(const std::string& name) {
+  // 名字只用 ASCII；Local\ 使同一登录会话内的进程可见
+  std::wstring w = L"Local\\";
+  for (char c : name) w += (wchar_t)(unsigned char)c;
+  return w;
+}
+}
+
+SharedRegion::~SharedRegion() {
+  Close();
+}
+
+bool SharedRegion::Create(const std::string& name, size_t size) {
+  Close();
+  const unsigned long long size64 = size;
+  HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                      (DWORD)(size64 >> 32), (DWORD)(size64 & 0xFFFFFFFFu), MappingName(name).c_str());
+  if (!mapping) return false;
+  void* p = MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, size);
+  if (!p) {
+    CloseHandle(mapping);
+    return false;
+  }
+  m_mapping = mapping;
+  m_data = p;
+  m_size = size;
+  return true;
+}
+
+bool SharedRegion::Open(const std::string& name, size_t size, bool writable) {
+  Close();
+  const DWORD access = writable ? (FILE_MAP_READ | FILE_MAP_WRITE) : FILE_MAP_READ;
+  HANDLE mapping = OpenFileMappingW(access, FALSE, MappingName(name).c_str());
+  if (!mapping) return false;
+  void* p = MapViewOfFile(mapping, access, 0, 0, size);
+  if (!p) {
+    CloseHandle(mapping);
+    return false;
+  }
+  m_mapping = mapping;
+  m_data = p;
+  m_size = size;
+  return true;
+}
+
+void SharedRegion::Close() {
+  if (m_data) UnmapViewOfFile(m_data);
+  if (m_mapping) CloseHandle(m_mapping);
+  m_data = nullptr;
+  m_mapping = nullptr;
+  m_size = 0;
+}
@@ -0,0 +1,90 @@
+#include "single_instance.h"
+#include <cstring>
+#include <thread>
+
+namespace {
+
+constexpr uint32_t kActivationMagic = 0x41494443u; // "CDIA"
+constexpr size_t kMaxActivationArgs = 256;
+constexpr size_t kMaxActivationBytes = 64 * 1024;
+
+void Put32(std::vector<uint8_t>& out, uint32_t v) {
+  for (int i = 0; i < 4; ++i) out.push_back((uint8_t)(v >> (8 * i)));
+}
+
+uint32_t Get32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+std::string EndpointName(const std::string& name) {
+  return name + ".Endpoint";
+}
+
+} // namespace
+
+InstanceRole SingleInstance::Claim(std::chrono::milliseconds timeout, const ForwardFn& forward) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  for (;;) {
+    if (m_lock.TryAcquire(m_name)) {
+      m_endpoint.Close();
+      // 端点建不出来只影响后启动的进程（它们会超时退出），本进程照常启动
+      if (m_endpoint.Create(EndpointName(m_name), sizeof(Block))) {
+        // 可能复用了上一任主实例（崩溃）留下的区域：先作废旧端点
+        EndpointBlock()->ready.store(0, std::memory_order_release);
+      }
+      return InstanceRole::Primary;
+    }
+    if (!m_endpoint.IsOpen()) m_endpoint.Open(EndpointName(m_name), sizeof(Block));
+    if (m_endpoint.IsOpen()) {
+      const Block* block = EndpointBlock();
+      if (block->ready.load(std::memory_order_acquire)) {
+        Endpoint endpoint;
+        endpoint.pid = block->pid.load(std::memory_order_relaxed);
+        endpoint.window = block->window.load(std::memory_order_relaxed);
+        if (forward(endpoint)) return InstanceRole::Forwarded;
+        // 端点已过期（主实例刚退出，或新主实例正在替换）：下一轮重新打开
+        m_endpoint.Close();
+      }
+    }
+    if (std::chrono::steady_clock::now() >= deadline) return InstanceRole::TimedOut;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+}
+
+void SingleInstance::Publish(const Endpoint& endpoint) {
+  if (!m_lock.IsHeld() || !m_endpoint.IsOpen()) return;
+  Block* block = EndpointBlock();
+  block->pid.store(endpoint.pid, std::memory_order_relaxed);
+  block->window.store(endpoint.window, std::memory_order_relaxed);
+  block->ready.store(1, std::memory_order_release);
+}
+
+std::vector<uint8_t> EncodeInstanceActivation(const std::vector<std::string>& args) {
+  std::vector<uint8_t> out;
+  Put32(out, kActivationMagic);
+  Put32(out, (uint32_t)args.size());
+  for (const std::string& arg : args) {
+    Put32(out, (uint32_t)arg.size());
+    out.insert(out.end(), arg.begin(), arg.end());
+  }
+  return out;
+}
+
+bool DecodeInstanceActivation(const void* data, size_t size, std::vector<std::string>* args) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  if (!p || size < 8 || size > kMaxActivationBytes || Get32(p) != kActivationMagic) return false;
+  const uint32_t count = Get32(p + 4);
+  if (count > kMaxActivationArgs) return false;
+  size_t offset = 8;
+  args->clear();
+  args->reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    if (size - offset < 4) return false;
+    const uint32_t len = Get32(p + offset);
+    offset += 4;
+    if (size - offset < len) return false;
+    args->emplace_back(reinterpret_cast<const char*>(p + offset), len);
+    offset += len;
+  }
+  return offset == size;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "shared_region.h"
+
+// 单实例：第一个启动的主程序持有具名锁成为主实例；之后再启动的进程在创建 Flutter 引擎之前
+// 把命令行参数交给主实例（激活请求）并直接退出。
+//
+// 锁：Windows 用具名互斥量（Local\ 命名空间），其余平台对锁文件加 flock，两者都在进程退出
+// （包括崩溃）时由系统释放，所以不会残留“幽灵主实例”。
+// 端点：主实例创建窗口后把 pid 与窗口句柄发布到一小块共享内存；后启动的进程等待端点就绪再转交。
+// 主实例持锁但还没发布端点（正在启动）时，后启动的进程轮询等待，直到超时。
+//
+// 转交失败（主实例刚好退出、端点已过期）时回到抢锁：旧主实例退出后锁已释放，重试会成为新的主实例。
+constexpr char kSingleInstanceName[] = "ChatDesktop.Instance";
+
+// 激活请求的 WM_COPYDATA dwData，与 ball_ipc.h / task_wire.h 的取值共用一个空间
+constexpr uint32_t kInstanceActivateCopyData = 5;
+
+// 具名进程锁
+class InstanceLock {
+public:
+  InstanceLock() = default;
+  ~InstanceLock();
+  InstanceLock(const InstanceLock&) = delete;
+  InstanceLock& operator=(const InstanceLock&) = delete;
+
+  // 非阻塞；成功后一直持有到 Release / 析构 / 进程退出
+  bool TryAcquire(const std::string& name);
+  void Release();
+  bool IsHeld() const { return m_held; }
+
+private:
+  bool m_held{false};
+#ifdef _WIN32
+  void* m_mutex{nullptr};
+#else
+  int m_fd{-1};
+#endif
+};
+
+enum class InstanceRole : uint8_t {
+  Primary,   // 拿到锁：正常启动
+  Forwarded, // 已交给主实例：应直接退出
+  TimedOut,  // 主实例持锁但一直没有就绪：应退出（不破坏单实例）
+};
+
+class SingleInstance {
+public:
+  // 主实例的端点；window 为平台窗口句柄（Windows 上是 HWND）
+  struct Endpoint {
+    uint32_t pid{0};
+    uint64_t window{0};
+  };
+  // 返回 true 表示主实例已接受激活请求
+  using ForwardFn = std::function<bool(const Endpoint&)>;
+
+  explicit SingleInstance(std::string name) : m_name(std::move(name)) {}
+
+  InstanceRole Claim(std::chrono::milliseconds timeout, const ForwardFn& forward);
+
+  // 仅主实例调用：窗口创建后发布端点；在此之前启动的进程一直等待
+  void Publish(const Endpoint& endpoint);
+
+  bool IsPrimary() const { return m_lock.IsHeld(); }
+
+private:
+  struct Block {
+    std::atomic<uint32_t> ready;
+    std::atomic<uint32_t> pid;
+    std::atomic<uint64_t> window;
+  };
+
+  Block* EndpointBlock() const { return static_cast<Block*>(m_endpoint.Data()); }
+
+  std::string m_name;
+  InstanceLock m_lock;
+  SharedRegion m_endpoint;
+};
+
+// 激活请求的载荷：'CDIA' + u32 参数个数 + 每个参数（u32 字节数 + UTF-8），小端
+std::vector<uint8_t> EncodeInstanceActivation(const std::vector<std::string>& args);
+// 校验长度与上限（最多 256 个参数、64 KiB），非法返回 false
+bool DecodeInstanceActivation(const void* data, size_t size, std::vector<std::string>* args);
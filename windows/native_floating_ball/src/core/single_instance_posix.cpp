@@ -0,0 +1,36 @@
+#include "single_instance.h"
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <cstdlib>
+
+namespace {
+std::string LockPath(const std::string& name) {
+  const char* dir = std::getenv("XDG_RUNTIME_DIR");
+  return std::string(dir && *dir ? dir : "/tmp") + "/" + name + ".lock";
+}
+}
+
+InstanceLock::~InstanceLock() {
+  Release();
+}
+
+bool InstanceLock::TryAcquire(const std::string& name) {
+  if (m_held) return true;
+  const int fd = open(LockPath(name).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+  if (fd < 0) return false;
+  // flock 属于打开的文件描述，进程退出时随描述符一起释放；锁文件本身不删除（删除与加锁之间有竞态）
+  if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+    close(fd);
+    return false;
+  }
+  m_fd = fd;
+  m_held = true;
+  return true;
+}
+
+void InstanceLock::Release() {
+  if (m_fd >= 0) close(m_fd);
+  m_fd = -1;
+  m_held = false;
+}
@@ -0,0 +1,34 @@
+#include "single_instance.h"
+#include <windows.h>
+
+InstanceLock::~InstanceLock() {
+  Release();
+}
+
+bool InstanceLock::TryAcquire(const std::string& name) {
+  if (m_held) return true;
+  // 名字只用 ASCII；Local\ 使锁只在当前登录会话内生效（与共享内存一致）
+  std::wstring wide = L"Local\\";
+  for (char c : name) wide += (wchar_t)(unsigned char)c;
+  HANDLE mutex = CreateMutexW(nullptr, FALSE, wide.c_str());
+  if (!mutex) return false;
+  // 以“持有”而不是“存在”判定：别的进程为了探测而短暂打开的句柄不会被误认为主实例；
+  // 上一任主实例崩溃留下的互斥量返回 WAIT_ABANDONED，同样视为拿到
+  const DWORD wait = WaitForSingleObject(mutex, 0);
+  if (wait != WAIT_OBJECT_0 && wait != WAIT_ABANDONED) {
+    CloseHandle(mutex);
+    return false;
+  }
+  m_mutex = mutex;
+  m_held = true;
+  return true;
+}
+
+void InstanceLock::Release() {
+  if (m_mutex) {
+    ReleaseMutex(m_mutex);
+    CloseHandle(m_mutex);
+  }
+  m_mutex = nullptr;
+  m_held = false;
+}
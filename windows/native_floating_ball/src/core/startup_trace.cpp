@@ -0,0 +1,84 @@
+#include "startup_trace.h"
+#include <cstdio>
+
+namespace {
+
+void AppendJsonString(std::string& out, const char* s) {
+  out += '"';
+  for (; s && *s; ++s) {
+    const char c = *s;
+    if (c == '"' || c == '\\') { out += '\\'; out += c; }
+    else if ((unsigned char)c < 0x20) { char buf[8]; std::snprintf(buf, sizeof(buf), "\\u%04x", c); out += buf; }
+    else out += c;
+  }
+  out += '"';
+}
+
+void AppendMicros(std::string& out, int64_t ns) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.3f", (double)ns / 1000.0);
+  out += buf;
+}
+
+} // namespace
+
+void StartupTracer::AddSpan(const char* name, int64_t startNs, int64_t durNs, uint32_t tid) {
+  const size_t i = m_next.fetch_add(1, std::memory_order_relaxed);
+  if (i >= kCapacity) return;
+  Event& e = m_events[i];
+  e.name = name;
+  e.startNs = startNs;
+  e.durNs = durNs;
+  e.tid = tid;
+}
+
+size_t StartupTracer::Dropped() const {
+  const size_t n = m_next.load(std::memory_order_acquire);
+  return n > kCapacity ? n - kCapacity : 0;
+}
+
+std::string StartupTracer::ToChromeJson() const {
+  const size_t n = Size();
+  std::string out;
+  out.reserve(128 + n * 96);
+  char num[24];
+  const auto pid = [&] { std::snprintf(num, sizeof(num), "%u", m_pid); return num; };
+  out += "{\"traceEvents\":[";
+  bool first = true;
+  if (m_processName) {
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":";
+    out += pid();
+    out += ",\"tid\":0,\"args\":{\"name\":";
+    AppendJsonString(out, m_processName);
+    out += "}}";
+    first = false;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    const Event& e = m_events[i];
+    if (!first) out += ',';
+    first = false;
+    out += "{\"name\":";
+    AppendJsonString(out, e.name);
+    out += ",\"cat\":\"startup\",\"ph\":";
+    out += e.durNs < 0 ? "\"i\",\"s\":\"p\"" : "\"X\"";
+    out += ",\"ts\":";
+    AppendMicros(out, e.startNs);
+    if (e.durNs >= 0) {
+      out += ",\"dur\":";
+      AppendMicros(out, e.durNs);
+    }
+    out += ",\"pid\":";
+    out += pid();
+    std::snprintf(num, sizeof(num), "%u", e.tid);
+    out += ",\"tid\":";
+    out += num;
+    out += '}';
+  }
+  out += "],\"displayTimeUnit\":\"ms\"}";
+  return out;
+}
+
+StartupTracer& ProcessStartupTracer() {
+  static StartupTracer tracer;
+  return tracer;
+}
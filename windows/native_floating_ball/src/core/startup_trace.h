@@ -0,0 +1,76 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 启动时间线：记录命名区间（单调时钟），导出 Chrome trace-event JSON（chrome://tracing / Perfetto 可直接打开）。
+// 常编译、常开启：事件存放在固定容量数组里，记录一次只有两次时钟读取和一次原子自增，不分配内存；
+// 超出容量的事件计入 Dropped()。名称须是静态字符串（只保存指针）。
+//
+// 时间原点是实例第一次被使用的时刻；AddSpan 允许负的起点，用于补记原点之前的阶段
+// （例如进程创建 → wWinMain）。主程序与悬浮球各自导出，pid 不同，可在查看器里合并对比。
+class StartupTracer {
+public:
+  static constexpr size_t kCapacity = 256;
+
+  struct Event {
+    const char* name{nullptr};
+    int64_t startNs{0}; // 相对原点
+    int64_t durNs{0};
+    uint32_t tid{0};
+  };
+
+  class Span {
+  public:
+    Span(StartupTracer& tracer, const char* name, uint32_t tid = 0)
+      : m_tracer(tracer), m_name(name), m_tid(tid), m_start(tracer.NowNs()) {}
+    ~Span() { End(); }
+    // 提前结束（析构时不再记录）
+    void End() {
+      if (!m_name) return;
+      m_tracer.AddSpan(m_name, m_start, m_tracer.NowNs() - m_start, m_tid);
+      m_name = nullptr;
+    }
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+  private:
+    StartupTracer& m_tracer;
+    const char* m_name;
+    uint32_t m_tid;
+    int64_t m_start;
+  };
+
+  StartupTracer() : m_origin(std::chrono::steady_clock::now()) {}
+
+  // 进程信息写入导出的元数据事件
+  void SetProcess(uint32_t pid, const char* name) { m_pid = pid; m_processName = name; }
+
+  int64_t NowNs() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_origin).count();
+  }
+
+  void AddSpan(const char* name, int64_t startNs, int64_t durNs, uint32_t tid = 0);
+  // 瞬时事件（例如“首帧已呈现”）
+  void AddInstant(const char* name, uint32_t tid = 0) { AddSpan(name, NowNs(), -1, tid); }
+
+  size_t Size() const { return (std::min)(m_next.load(std::memory_order_acquire), kCapacity); }
+  size_t Dropped() const;
+  const Event& At(size_t i) const { return m_events[i]; }
+
+  // {"traceEvents":[...],"displayTimeUnit":"ms"}；ts/dur 为微秒。导出应在记录结束后进行（例如首帧之后）
+  std::string ToChromeJson() const;
+
+private:
+  std::chrono::steady_clock::time_point m_origin;
+  Event m_events[kCapacity];
+  std::atomic<size_t> m_next{0};
+  uint32_t m_pid{0};
+  const char* m_processName{nullptr};
+};
+
+// 进程内共享的实例
+StartupTracer& ProcessStartupTracer();
@@ -0,0 +1,319 @@
+#include "task_list_model.h"
+#include <algorithm>
+
+namespace {
+constexpr size_t kPending = static_cast<size_t>(-1); // LIS 前驱链的终止标记
+constexpr float kRowAnimSeconds = 0.15f;
+constexpr size_t kMaxGhosts = 32; // 一次移除太多行时不做淡出，直接消失
+}
+
+uint64_t HashTaskId(std::u16string_view id) {
+  uint64_t h = 1469598103934665603ull; // FNV-1a
+  for (char16_t c : id) {
+    h ^= (uint64_t)c;
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+void TaskIdIndex::Reset(size_t expected) {
+  size_t cap = 16;
+  while (cap < expected * 2) cap <<= 1;
+  if (m_slots.size() < cap) m_slots.resize(cap);
+  std::fill(m_slots.begin(), m_slots.end(), Slot{});
+  m_size = 0;
+  m_used = 0;
+}
+
+void TaskIdIndex::Grow() {
+  std::vector<Slot> old;
+  old.swap(m_slots);
+  m_slots.assign((std::max)((size_t)16, old.size() * 2), Slot{});
+  m_size = 0;
+  m_used = 0;
+  for (const Slot& s : old) {
+    if (s.index != kEmpty && s.index != kTombstone) Insert(s.hash, s.index);
+  }
+}
+
+void TaskIdIndex::Insert(uint64_t hash, uint32_t index) {
+  if ((m_used + 1) * 2 > m_slots.size()) Grow();
+  const size_t mask = m_slots.size() - 1;
+  size_t i = (size_t)hash & mask;
+  while (m_slots[i].index != kEmpty && m_slots[i].index != kTombstone) i = (i + 1) & mask;
+  if (m_slots[i].index == kEmpty) ++m_used;
+  m_slots[i].hash = hash;
+  m_slots[i].index = index;
+  ++m_size;
+}
+
+const TaskListDiff& TaskListModel::Replace(const std::vector<TaskItemView>& items) {
+  m_diff.Clear();
+
+  // 上一次更新遗留的淡出行直接丢弃，只对 live 行做对比
+  DropGhosts(false);
+  for (size_t i = 0; i < m_order.size(); ++i) {
+    TaskRow& row = m_slots[m_order[i]];
+    row.oldIndex = i;
+    row.change = RowChange::None;
+  }
+  m_seen.assign(m_slots.size(), 0);
+  m_newOrder.clear();
+  m_newOrder.reserve(items.size());
+  m_incoming.Reset(items.size());
+
+  for (size_t k = 0; k < items.size(); ++k) {
+    const TaskItemView& item = items[k];
+    const uint64_t h = HashTaskId(item.id);
+    // 负载中重复的 id，只保留第一条
+    if (m_incoming.Find(h, [&](uint32_t j) { return items[j].id == item.id; }) != TaskIdIndex::kNotFound) continue;
+    m_incoming.Insert(h, (uint32_t)k);
+
+    uint32_t slot = FindSlot(h, item.id);
+    if (slot == TaskIdIndex::kNotFound) {
+      slot = AllocSlot();
+      TaskRow& row = m_slots[slot];
+      row.item.id.assign(item.id.data(), item.id.size());
+      AssignIfChanged(row, item);
+      row.idHash = h;
+      row.change = RowChange::Inserted;
+      row.anim = 0.f;
+      m_index.Insert(h, slot);
+    } else {
+      m_seen[slot] = 1;
+      TaskRow& row = m_slots[slot];
+      if (AssignIfChanged(row, item)) {
+        ++row.version;
+        row.change = RowChange::Updated;
+      }
+    }
+    m_newOrder.push_back(slot);
+  }
+
+  // 未再出现的行：从索引中移除，少量时保留为淡出残影
+  m_ghostOrder.clear();
+  for (uint32_t slot : m_order) {
+    if (m_seen[slot]) continue;
+    ++m_diff.removed;
+    m_index.Erase(m_slots[slot].idHash, [slot](uint32_t s) { return s == slot; });
+    m_ghostOrder.push_back(slot);
+  }
+  if (m_ghostOrder.size() > kMaxGhosts) {
+    for (uint32_t slot : m_ghostOrder) FreeSlot(slot);
+    m_ghostOrder.clear();
+  }
+
+  MarkMoved();
+
+  // 按旧位置把残影行归并回列表，使其在原处淡出
+  m_order.clear();
+  size_t g = 0;
+  for (uint32_t slot : m_newOrder) {
+    while (g < m_ghostOrder.size() && m_slots[m_ghostOrder[g]].oldIndex <= m_order.size()) {
+      m_order.push_back(m_ghostOrder[g++]);
+    }
+    m_order.push_back(slot);
+  }
+  for (; g < m_ghostOrder.size(); ++g) m_order.push_back(m_ghostOrder[g]);
+  for (uint32_t slot : m_ghostOrder) {
+    m_slots[slot].removing = true;
+    m_slots[slot].anim = 1.f;
+  }
+  m_ghosts = m_ghostOrder.size();
+  m_ghostOrder.clear();
+
+  for (uint32_t slot : m_newOrder) {
+    switch (m_slots[slot].change) {
+    case RowChange::Inserted: ++m_diff.inserted; break;
+    case RowChange::Updated: ++m_diff.updated; break;
+    case RowChange::Moved: ++m_diff.moved; break;
+    default: break;
+    }
+  }
+  m_animating = m_diff.inserted != 0 || m_ghosts != 0;
+  return m_diff;
+}
+
+void TaskListModel::BeginBatch() {
+  m_diff.Clear();
+}
+
+void TaskListModel::Add(const TaskItemView& item) {
+  const uint64_t h = HashTaskId(item.id);
+  if (FindSlot(h, item.id) != TaskIdIndex::kNotFound) {
+    Update(item);
+    return;
+  }
+  const uint32_t slot = AllocSlot();
+  TaskRow& row = m_slots[slot];
+  row.item.id.assign(item.id.data(), item.id.size());
+  AssignIfChanged(row, item);
+  row.idHash = h;
+  row.change = RowChange::Inserted;
+  row.anim = 0.f;
+  m_index.Insert(h, slot);
+
+  // position 是 live 下标；有残影行时换算成含残影的顺序下标
+  size_t at = m_order.size();
+  if (item.position < LiveCount()) {
+    at = item.position;
+    if (m_ghosts) {
+      size_t live = 0;
+      for (at = 0; at < m_order.size(); ++at) {
+        if (m_slots[m_order[at]].removing) continue;
+        if (live++ == item.position) break;
+      }
+    }
+  }
+  m_order.insert(m_order.begin() + at, slot);
+  ++m_diff.inserted;
+  m_animating = true;
+}
+
+bool TaskListModel::Update(const TaskItemView& item) {
+  const uint32_t slot = FindSlot(HashTaskId(item.id), item.id);
+  if (slot == TaskIdIndex::kNotFound) return false;
+  TaskRow& row = m_slots[slot];
+  if (AssignIfChanged(row, item)) {
+    ++row.version;
+    row.change = RowChange::Updated;
+    ++m_diff.updated;
+  }
+  return true;
+}
+
+bool TaskListModel::Remove(std::u16string_view id) {
+  const uint64_t h = HashTaskId(id);
+  const uint32_t slot = FindSlot(h, id);
+  if (slot == TaskIdIndex::kNotFound) return false;
+  m_index.Erase(h, [slot](uint32_t s) { return s == slot; });
+  // 残影行留在原位淡出，不移动顺序数组
+  TaskRow& row = m_slots[slot];
+  row.removing = true;
+  row.anim = 1.f;
+  ++m_ghosts;
+  ++m_diff.removed;
+  m_animating = true;
+  return true;
+}
+
+const TaskListDiff& TaskListModel::EndBatch() {
+  if (m_ghosts > kMaxGhosts) DropGhosts(false); // 一次移除太多行时不做淡出
+  return m_diff;
+}
+
+// 保留下来的行中，旧下标的最长递增子序列视为“没动”，其余标记为移动。
+void TaskListModel::MarkMoved() {
+  m_lisTails.clear();
+  m_lisPrev.assign(m_newOrder.size(), kPending);
+  for (size_t i = 0; i < m_newOrder.size(); ++i) {
+    const TaskRow& row = m_slots[m_newOrder[i]];
+    if (row.change == RowChange::Inserted) continue;
+    const size_t key = row.oldIndex;
+    auto pos = std::lower_bound(m_lisTails.begin(), m_lisTails.end(), key,
+                                [this](size_t idx, size_t k) { return m_slots[m_newOrder[idx]].oldIndex < k; });
+    if (pos != m_lisTails.begin()) m_lisPrev[i] = *(pos - 1);
+    if (pos == m_lisTails.end()) m_lisTails.push_back(i); else *pos = i;
+  }
+  // 标记 LIS 中的行，其余保留行即为移动
+  std::vector<uint8_t>& inLis = m_seen; // 复用缓冲
+  inLis.assign(m_newOrder.size(), 0);
+  if (!m_lisTails.empty()) {
+    for (size_t i = m_lisTails.back(); i != kPending; i = m_lisPrev[i]) inLis[i] = 1;
+  }
+  for (size_t i = 0; i < m_newOrder.size(); ++i) {
+    TaskRow& row = m_slots[m_newOrder[i]];
+    if (row.change == RowChange::Inserted || inLis[i]) continue;
+    if (row.change == RowChange::None) row.change = RowChange::Moved;
+  }
+}
+
+bool TaskListModel::AssignIfChanged(TaskRow& row, const TaskItemView& item) {
+  TaskItem& dst = row.item;
+  if (dst.title == item.title && dst.priority == item.priority && dst.flags == item.flags && dst.dueMs == item.dueMs) {
+    return false;
+  }
+  dst.title.assign(item.title.data(), item.title.size());
+  dst.priority = item.priority;
+  dst.flags = item.flags;
+  dst.dueMs = item.dueMs;
+  return true;
+}
+
+uint32_t TaskListModel::FindSlot(uint64_t hash, std::u16string_view id) const {
+  return m_index.Find(hash, [&](uint32_t s) { return m_slots[s].item.id == id; });
+}
+
+uint32_t TaskListModel::AllocSlot() {
+  if (m_freeSlots.empty()) {
+    m_slots.emplace_back();
+    return (uint32_t)(m_slots.size() - 1);
+  }
+  const uint32_t slot = m_freeSlots.back();
+  m_freeSlots.pop_back();
+  return slot;
+}
+
+void TaskListModel::FreeSlot(uint32_t slot) {
+  // 保留字符串容量，槽位复用时不必重新分配
+  TaskRow& row = m_slots[slot];
+  row.item.id.clear();
+  row.item.title.clear();
+  row.item.priority = 1;
+  row.item.flags = kTaskUnread;
+  row.item.dueMs = 0;
+  row.idHash = 0;
+  row.version = 0;
+  row.change = RowChange::None;
+  row.removing = false;
+  row.anim = 1.f;
+  m_freeSlots.push_back(slot);
+}
+
+void TaskListModel::DropGhosts(bool finishedOnly) {
+  if (!m_ghosts) return;
+  size_t out = 0;
+  for (uint32_t slot : m_order) {
+    const TaskRow& row = m_slots[slot];
+    if (row.removing && (!finishedOnly || row.anim <= 0.f)) {
+      FreeSlot(slot);
+      --m_ghosts;
+    } else {
+      m_order[out++] = slot;
+    }
+  }
+  m_order.resize(out);
+}
+
+bool TaskListModel::Tick(float dt) {
+  if (!m_animating) return false;
+  const float step = dt / kRowAnimSeconds;
+  bool active = false;
+  bool finishedGhost = false;
+  for (uint32_t slot : m_order) {
+    TaskRow& row = m_slots[slot];
+    if (row.removing) {
+      row.anim = (std::max)(0.f, row.anim - step);
+      if (row.anim <= 0.f) finishedGhost = true; else active = true;
+    } else if (row.anim < 1.f) {
+      row.anim = (std::min)(1.f, row.anim + step);
+      if (row.anim < 1.f) active = true;
+    }
+  }
+  if (finishedGhost) DropGhosts(true);
+  m_animating = active;
+  return m_animating;
+}
+
+int TaskListModel::IndexOf(std::u16string_view id) const {
+  const uint32_t slot = FindSlot(HashTaskId(id), id);
+  if (slot == TaskIdIndex::kNotFound) return -1;
+  for (size_t i = 0; i < m_order.size(); ++i) {
+    if (m_order[i] == slot) return (int)i;
+  }
+  return -1;
+}
+
+bool TaskListModel::Contains(std::u16string_view id) const {
+  return FindSlot(HashTaskId(id), id) != TaskIdIndex::kNotFound;
+}
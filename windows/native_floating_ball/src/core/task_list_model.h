@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 悬浮球/气泡使用的任务条目。文本统一为 UTF-16（与 WM_COPYDATA 负载、DirectWrite 一致），
+// 使用 char16_t 而不是 wchar_t，以便同一份代码在 Linux（wchar_t 为 32 位）上也能编译运行。
+enum TaskFlags : uint8_t {
+  kTaskUnread = 1u << 0,
+  kTaskCompleted = 1u << 1,
+};
+
+struct TaskItem {
+  std::u16string id;
+  std::u16string title;
+  uint8_t priority{1};   // 0 低 / 1 中 / 2 高（与 Dart 端 Priority 枚举一致）
+  uint8_t flags{kTaskUnread};
+  int64_t dueMs{0};      // 截止时间（Unix 毫秒，UTC）；0 表示无
+};
+
+// 指向解码缓冲区的只读视图：解析时不为每行分配内存，只有真正新增/变化的行才拷贝进模型。
+struct TaskItemView {
+  std::u16string_view id;
+  std::u16string_view title;
+  uint8_t priority{1};
+  uint8_t flags{kTaskUnread};
+  int64_t dueMs{0};
+  uint32_t position{0xFFFFFFFFu}; // 仅增量 ADD 使用：插入后的 live 下标；缺省追加到末尾
+};
+
+enum class RowChange : uint8_t { None, Inserted, Updated, Moved };
+
+struct TaskRow {
+  TaskItem item;
+  uint64_t idHash{0};
+  uint32_t version{0};     // 标题等内容每变化一次 +1
+  RowChange change{RowChange::None};
+  bool removing{false};    // 已被移除、正在淡出的“残影”行（不可点击，不计入未读数）
+  float anim{1.f};         // 插入时 0 -> 1 淡入；移除时 1 -> 0 淡出
+  size_t oldIndex{0};      // 仅在 Replace 期间使用
+};
+
+// 一次更新相对上一次的差异（行数统计）。增量更新只触及变化的行，
+// 不为统计下标而遍历整个列表。
+struct TaskListDiff {
+  size_t inserted{0};
+  size_t updated{0};
+  size_t moved{0};
+  size_t removed{0};
+
+  bool Empty() const { return inserted == 0 && updated == 0 && moved == 0 && removed == 0; }
+  bool ChangesRowCount() const { return inserted != 0 || removed != 0; }
+  void Clear() { *this = TaskListDiff{}; }
+  // 合并多次更新（接收端把一帧内的多次更新合成一次重排/重绘）
+  void Accumulate(const TaskListDiff& o) {
+    inserted += o.inserted; updated += o.updated; moved += o.moved; removed += o.removed;
+  }
+};
+
+uint64_t HashTaskId(std::u16string_view id);
+
+// id 哈希 -> 行下标 的开放寻址表。键比较交给调用方（比较行里的 id），因此查找可以直接用视图，
+// 不需要构造 std::u16string；清空/重建复用同一块内存。
+class TaskIdIndex {
+public:
+  static constexpr uint32_t kNotFound = 0xFFFFFFFFu;
+
+  void Reset(size_t expected);
+  void Insert(uint64_t hash, uint32_t index);
+  // eq(index) 判断该下标处的 id 是否就是要找的 id
+  template <typename Eq>
+  uint32_t Find(uint64_t hash, Eq eq) const;
+  template <typename Eq>
+  bool Erase(uint64_t hash, Eq eq);
+  size_t Size() const { return m_size; }
+
+private:
+  struct Slot {
+    uint64_t hash{0};
+    uint32_t index{kEmpty};
+  };
+  static constexpr uint32_t kEmpty = 0xFFFFFFFFu;
+  static constexpr uint32_t kTombstone = 0xFFFFFFFEu;
+  void Grow();
+
+  std::vector<Slot> m_slots;
+  size_t m_size{0};
+  size_t m_used{0}; // size + tombstones
+};
+
+template <typename Eq>
+uint32_t TaskIdIndex::Find(uint64_t hash, Eq eq) const {
+  if (m_slots.empty()) return kNotFound;
+  const size_t mask = m_slots.size() - 1;
+  for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask) {
+    const Slot& s = m_slots[i];
+    if (s.index == kEmpty) return kNotFound;
+    if (s.index != kTombstone && s.hash == hash && eq(s.index)) return s.index;
+  }
+}
+
+template <typename Eq>
+bool TaskIdIndex::Erase(uint64_t hash, Eq eq) {
+  if (m_slots.empty()) return false;
+  const size_t mask = m_slots.size() - 1;
+  for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask) {
+    Slot& s = m_slots[i];
+    if (s.index == kEmpty) return false;
+    if (s.index != kTombstone && s.hash == hash && eq(s.index)) {
+      s.index = kTombstone;
+      --m_size;
+      return true;
+    }
+  }
+}
+
+// id -> 行 的任务列表模型。行存放在位置稳定的槽位里，显示顺序单独保存为槽位下标数组，
+// 因此 id 索引（id -> 槽位）不随插入/删除/重排失效。
+//   Replace：整表替换（快照），只对插入/删除/移动/更新的行产生差异，未变化的行原样保留（包括版本号）；
+//   BeginBatch/Add/Update/Remove/EndBatch：增量更新，成本只与变化的行数有关
+//   （中间插入需要移动 4 字节/行的顺序数组）。
+class TaskListModel {
+public:
+  const TaskListDiff& Replace(const std::vector<TaskItemView>& items);
+
+  void BeginBatch();
+  void Add(const TaskItemView& item);           // id 已存在时按 Update 处理
+  bool Update(const TaskItemView& item);        // id 不存在时返回 false
+  bool Remove(std::u16string_view id);          // id 不存在时返回 false
+  const TaskListDiff& EndBatch();
+
+  // 推进行级插入/移除动画；返回是否仍有动画在进行。
+  bool Tick(float dt);
+  bool IsAnimating() const { return m_animating; }
+
+  size_t Size() const { return m_order.size(); }
+  size_t LiveCount() const { return m_order.size() - m_ghosts; }
+  const TaskRow& Row(size_t index) const { return m_slots[m_order[index]]; }
+  int IndexOf(std::u16string_view id) const;
+  bool Contains(std::u16string_view id) const;   // 仅 live 行；O(1)，增量应用前的校验用
+  const TaskListDiff& LastDiff() const { return m_diff; }
+
+private:
+  uint32_t FindSlot(uint64_t hash, std::u16string_view id) const;
+  uint32_t AllocSlot();
+  void FreeSlot(uint32_t slot);
+  void DropGhosts(bool finishedOnly);
+  void MarkMoved();
+  static bool AssignIfChanged(TaskRow& row, const TaskItemView& item);
+
+  std::vector<TaskRow> m_slots;        // 槽位，释放后进入空闲链复用（字符串容量一并复用）
+  std::vector<uint32_t> m_freeSlots;
+  std::vector<uint32_t> m_order;       // 显示顺序（含淡出中的残影行）
+  std::vector<uint32_t> m_newOrder;    // 复用的缓冲，避免每次更新重新分配
+  std::vector<uint32_t> m_ghostOrder;
+  std::vector<uint8_t> m_seen;
+  std::vector<size_t> m_lisTails;
+  std::vector<size_t> m_lisPrev;
+  TaskIdIndex m_index;                 // id -> 槽位，仅包含 live 行
+  TaskIdIndex m_incoming;              // 本次负载内的 id，用于剔除重复
+  TaskListDiff m_diff;
+  size_t m_ghosts{0};
+  bool m_animating{false};
+};
@@ -0,0 +1,64 @@
+#include "task_sync.h"
+#include <algorithm>
+
+TaskSyncResult TaskSyncReceiver::Apply(const void* data, size_t size, TaskListModel& model) {
+  if (!m_reader.Open(data, size)) return TaskSyncResult::Rejected;
+  const TaskWireHeader& header = m_reader.Header();
+  TaskItemView item;
+
+  if (header.kind == TaskWireKind::Snapshot) {
+    m_items.clear();
+    m_items.reserve(header.count);
+    while (m_reader.Next(&item)) m_items.push_back(item);
+    if (m_reader.Error() != TaskWireError::None) return TaskSyncResult::Rejected;
+    model.Replace(m_items);
+    // sequence 为 0 的快照不建立基线：之后的增量无从校验
+    m_hasBase = header.sequence != 0;
+    m_lastSeq = header.sequence;
+    return TaskSyncResult::Applied;
+  }
+
+  if (header.kind != TaskWireKind::Add && header.kind != TaskWireKind::Update && header.kind != TaskWireKind::Remove) {
+    return TaskSyncResult::Rejected;
+  }
+  // 缺口（丢包、发送端重启、其它发送端插入了旧格式更新）：不应用，等待快照
+  if (!m_hasBase || header.sequence != m_lastSeq + 1) {
+    m_hasBase = false;
+    return TaskSyncResult::ResyncRequired;
+  }
+
+  // 先完整解码并校验整条增量，再动模型：截断的负载或引用了不存在 id 的记录都不应留下半条更新
+  m_items.clear();
+  m_items.reserve(header.count);
+  while (m_reader.Next(&item)) m_items.push_back(item);
+  if (m_reader.Error() != TaskWireError::None || !Consistent(header.kind, model)) {
+    m_hasBase = false;
+    return TaskSyncResult::ResyncRequired;
+  }
+
+  model.BeginBatch();
+  for (const TaskItemView& record : m_items) {
+    switch (header.kind) {
+    case TaskWireKind::Add: model.Add(record); break;
+    case TaskWireKind::Update: model.Update(record); break;
+    case TaskWireKind::Remove: model.Remove(record.id); break;
+    default: break;
+    }
+  }
+  model.EndBatch();
+  m_lastSeq = header.sequence;
+  return TaskSyncResult::Applied;
+}
+
+bool TaskSyncReceiver::Consistent(TaskWireKind kind, const TaskListModel& model) {
+  if (kind == TaskWireKind::Add) return true;
+  for (const TaskItemView& record : m_items) {
+    if (!model.Contains(record.id)) return false;
+  }
+  if (kind != TaskWireKind::Remove || m_items.size() < 2) return true;
+  // 同一 id 删除两次：第二次在逐条应用时必然找不到
+  m_ids.clear();
+  for (const TaskItemView& record : m_items) m_ids.push_back(record.id);
+  std::sort(m_ids.begin(), m_ids.end());
+  return std::adjacent_find(m_ids.begin(), m_ids.end()) == m_ids.end();
+}
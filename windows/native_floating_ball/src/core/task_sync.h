@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "task_list_model.h"
+#include "task_wire.h"
+
+// 接收端的序号状态机：把二进制 UPDATE_TASKS（快照或增量）应用到 TaskListModel。
+// 返回值直接作为 WM_COPYDATA 的返回码，发送端据此决定是否重发快照。
+enum class TaskSyncResult : uint8_t {
+  Rejected = 0,       // 无法解析；发送端应回退到旧文本格式
+  Applied = 1,
+  ResyncRequired = 2, // 序号缺口或增量引用了不存在的 id；发送端应重发带序号的快照
+};
+
+class TaskSyncReceiver {
+public:
+  TaskSyncResult Apply(const void* data, size_t size, TaskListModel& model);
+  // 列表被其它途径整体替换（例如旧文本格式）后，后续增量都必须先等到新的快照
+  void Invalidate() { m_hasBase = false; }
+
+  bool HasBase() const { return m_hasBase; }
+  uint32_t LastSequence() const { return m_lastSeq; }
+
+private:
+  // m_items 中的增量能否整条应用：UPDATE/REMOVE 的 id 都存在，REMOVE 不重复
+  bool Consistent(TaskWireKind kind, const TaskListModel& model);
+
+  TaskWireReader m_reader;
+  std::vector<TaskItemView> m_items;   // 复用的解码缓冲
+  std::vector<std::u16string_view> m_ids;
+  uint32_t m_lastSeq{0};
+  bool m_hasBase{false};
+};
@@ -0,0 +1,31 @@
+#include "task_text_parser.h"
+
+const std::vector<TaskItemView>& TaskTextParser::Parse(std::u16string_view payload) {
+  m_items.clear();
+  const char16_t* p = payload.data();
+  const char16_t* const end = p + payload.size();
+  while (p < end) {
+    // 一次扫描同时找到行尾与第一个空格
+    const char16_t* lineEnd = p;
+    const char16_t* space = nullptr;
+    for (; lineEnd < end && *lineEnd != u'\n' && *lineEnd != u'\r'; ++lineEnd) {
+      if (!space && *lineEnd == u' ') space = lineEnd;
+    }
+    const char16_t* contentEnd = lineEnd;
+    while (contentEnd > p && contentEnd[-1] == u'\0') --contentEnd;
+    if (space && space >= contentEnd) space = nullptr;
+    // 空行与以空格开头（id 为空）的行都忽略：空 id 既无法点击打开，也会在模型里互相去重
+    if (contentEnd > p && space != p) {
+      TaskItemView item;
+      if (space) {
+        item.id = std::u16string_view(p, (size_t)(space - p));
+        item.title = std::u16string_view(space + 1, (size_t)(contentEnd - space - 1));
+      } else {
+        item.id = std::u16string_view(p, (size_t)(contentEnd - p));
+      }
+      m_items.push_back(item);
+    }
+    p = lineEnd + 1;
+  }
+  return m_items;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include "task_list_model.h"
+
+// 旧文本格式 UPDATE_TASKS（WM_COPYDATA dwData=1）的零拷贝解析：每行 "<id> <title>"，
+// id 与标题在第一个空格处拆分；\r、\n 都视为换行，结尾 NUL、空行与 id 为空的行忽略。
+// 格式没有转义：标题里的换行由发送端替换为空格；其余 UTF-16 码元（包括不成对的代理）原样保留。
+// 解析结果是指向输入负载的视图，条目数组在多次更新之间复用（只增不减），
+// 稳态下一次更新不产生任何堆分配。视图只在负载有效期间（当前消息处理内）可用。
+class TaskTextParser {
+public:
+  const std::vector<TaskItemView>& Parse(std::u16string_view payload);
+  const std::vector<TaskItemView>& Items() const { return m_items; }
+
+private:
+  std::vector<TaskItemView> m_items;
+};
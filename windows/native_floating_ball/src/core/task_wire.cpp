@@ -0,0 +1,137 @@
+#include "task_wire.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+template <typename T>
+T Load(const uint8_t* p) {
+  T v;
+  std::memcpy(&v, p, sizeof(T));
+  return v;
+}
+
+template <typename T>
+void Append(std::vector<uint8_t>& buf, T v) {
+  const size_t at = buf.size();
+  buf.resize(at + sizeof(T));
+  std::memcpy(buf.data() + at, &v, sizeof(T));
+}
+
+template <typename T>
+void Store(std::vector<uint8_t>& buf, size_t at, T v) {
+  std::memcpy(buf.data() + at, &v, sizeof(T));
+}
+
+constexpr size_t Align4(size_t n) { return (n + 3) & ~(size_t)3; }
+
+bool IsLittleEndian() {
+  const uint16_t probe = 1;
+  uint8_t first;
+  std::memcpy(&first, &probe, 1);
+  return first == 1;
+}
+}
+
+bool TaskWireReader::Open(const void* data, size_t size) {
+  m_data = static_cast<const uint8_t*>(data);
+  m_size = size;
+  m_offset = 0;
+  m_read = 0;
+  m_header = TaskWireHeader{};
+  m_error = TaskWireError::None;
+
+  if (!m_data || size < kTaskWireHeaderSize) return Fail(TaskWireError::TooShort);
+  // 标题/ID 以 char16_t 视图直接引用缓冲，要求偶数地址；目前只支持小端主机
+  if (((uintptr_t)m_data & 1) || !IsLittleEndian()) return Fail(TaskWireError::Misaligned);
+  if (Load<uint32_t>(m_data) != kTaskWireMagic) return Fail(TaskWireError::BadMagic);
+  m_header.version = m_data[4];
+  if (m_header.version != kTaskWireVersion) return Fail(TaskWireError::UnsupportedVersion);
+  m_header.kind = static_cast<TaskWireKind>(m_data[5]);
+  const uint16_t headerSize = Load<uint16_t>(m_data + 6);
+  if (headerSize < kTaskWireHeaderSize || (headerSize & 3) || headerSize > size) return Fail(TaskWireError::TooShort);
+  m_header.count = Load<uint32_t>(m_data + 8);
+  m_header.sequence = Load<uint32_t>(m_data + 12);
+  // 每条记录至少 kTaskWireRecordFixedSize 字节，count 不可能超过剩余长度允许的上限
+  if (m_header.count > (size - headerSize) / kTaskWireRecordFixedSize) return Fail(TaskWireError::Truncated);
+  m_offset = headerSize;
+  return true;
+}
+
+bool TaskWireReader::Next(TaskItemView* out) {
+  if (m_error != TaskWireError::None || m_read >= m_header.count) return false;
+  const size_t remaining = m_size - m_offset;
+  if (remaining < kTaskWireRecordFixedSize) return Fail(TaskWireError::Truncated);
+  const uint8_t* p = m_data + m_offset;
+  const uint32_t recordSize = Load<uint32_t>(p);
+  if (recordSize < kTaskWireRecordFixedSize || (recordSize & 3)) return Fail(TaskWireError::BadRecord);
+  if (recordSize > remaining) return Fail(TaskWireError::Truncated);
+  const uint16_t idLen = Load<uint16_t>(p + 6);
+  const uint32_t titleLen = Load<uint32_t>(p + 16);
+  // 用 64 位计算，避免 titleLen 接近 UINT32_MAX 时溢出
+  const uint64_t textBytes = ((uint64_t)idLen + titleLen) * sizeof(char16_t);
+  if (kTaskWireRecordFixedSize + textBytes > recordSize) return Fail(TaskWireError::BadRecord);
+
+  const char16_t* text = reinterpret_cast<const char16_t*>(p + kTaskWireRecordFixedSize);
+  out->priority = p[4];
+  out->flags = p[5];
+  out->dueMs = Load<int64_t>(p + 8);
+  out->id = std::u16string_view(text, idLen);
+  out->title = std::u16string_view(text + idLen, titleLen);
+  out->position = 0xFFFFFFFFu;
+  const size_t tail = Align4(kTaskWireRecordFixedSize + (size_t)textBytes);
+  if (m_header.kind == TaskWireKind::Add && tail + sizeof(uint32_t) <= recordSize) {
+    out->position = Load<uint32_t>(p + tail);
+  }
+  m_offset += recordSize;
+  ++m_read;
+  return true;
+}
+
+void TaskWireWriter::Begin(TaskWireKind kind, uint32_t sequence) {
+  m_buf.clear();
+  m_kind = kind;
+  m_count = 0;
+  Append<uint32_t>(m_buf, kTaskWireMagic);
+  Append<uint8_t>(m_buf, kTaskWireVersion);
+  Append<uint8_t>(m_buf, static_cast<uint8_t>(kind));
+  Append<uint16_t>(m_buf, (uint16_t)kTaskWireHeaderSize);
+  Append<uint32_t>(m_buf, 0); // count，Finish 时回填
+  Append<uint32_t>(m_buf, sequence);
+}
+
+void TaskWireWriter::Add(const TaskItemView& item) {
+  const size_t idLen = (std::min)(item.id.size(), (size_t)0xFFFF);
+  const size_t titleLen = item.title.size();
+  const size_t textEnd = Align4(kTaskWireRecordFixedSize + (idLen + titleLen) * sizeof(char16_t));
+  const size_t recordSize = textEnd + (m_kind == TaskWireKind::Add ? sizeof(uint32_t) : 0);
+  const size_t at = m_buf.size();
+  m_buf.resize(at + recordSize, 0);
+  Store<uint32_t>(m_buf, at, (uint32_t)recordSize);
+  m_buf[at + 4] = item.priority;
+  m_buf[at + 5] = item.flags;
+  Store<uint16_t>(m_buf, at + 6, (uint16_t)idLen);
+  Store<int64_t>(m_buf, at + 8, item.dueMs);
+  Store<uint32_t>(m_buf, at + 16, (uint32_t)titleLen);
+  uint8_t* text = m_buf.data() + at + kTaskWireRecordFixedSize;
+  // 空视图的 data() 可能为空指针，长度为 0 时不调用 memcpy
+  if (idLen) std::memcpy(text, item.id.data(), idLen * sizeof(char16_t));
+  if (titleLen) std::memcpy(text + idLen * sizeof(char16_t), item.title.data(), titleLen * sizeof(char16_t));
+  if (m_kind == TaskWireKind::Add) Store<uint32_t>(m_buf, at + textEnd, item.position);
+  ++m_count;
+}
+
+const std::vector<uint8_t>& TaskWireWriter::Finish() {
+  if (m_buf.size() >= kTaskWireHeaderSize) Store<uint32_t>(m_buf, 8, m_count);
+  return m_buf;
+}
+
+bool DecodeTaskWire(const void* data, size_t size, std::vector<TaskItemView>* out, TaskWireHeader* header) {
+  out->clear();
+  TaskWireReader reader;
+  if (!reader.Open(data, size)) return false;
+  out->reserve(reader.Header().count);
+  TaskItemView item;
+  while (reader.Next(&item)) out->push_back(item);
+  if (header) *header = reader.Header();
+  return reader.Error() == TaskWireError::None;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "task_list_model.h"
+
+// UPDATE_TASKS 的二进制负载（WM_COPYDATA dwData = kTaskWireCopyDataId）。所有整数为小端。
+//
+// 头部（16 字节）：
+//   u32 magic 'CDTW'   u8 version   u8 kind   u16 headerSize
+//   u32 count          u32 sequence（0 表示不带序号）
+// 之后是 count 条记录，每条以 4 字节对齐：
+//   u32 recordSize  u8 priority  u8 flags  u16 idLen  i64 dueMs  u32 titleLen
+//   char16_t id[idLen]  char16_t title[titleLen]  填充到 4 字节
+//   [ADD] u32 position（插入后的 live 下标，0xFFFFFFFF 表示追加到末尾）
+//
+// 兼容规则：version 只在不兼容变更时递增；新增字段追加在头部末尾或记录文本之后（4 字节对齐），
+// 旧读端按 headerSize / recordSize 跳过不认识的尾部。
+//
+// 序号：sequence 非 0 的 SNAPSHOT 建立基线，其后的 ADD/UPDATE/REMOVE 必须依次 +1，
+// 接收端发现缺口时拒绝应用并要求发送端重发快照（见 task_sync.h）。
+constexpr uintptr_t kTaskWireCopyDataId = 4;
+constexpr uint32_t kTaskWireMagic = 0x57544443u; // "CDTW"
+constexpr uint8_t kTaskWireVersion = 1;
+constexpr size_t kTaskWireHeaderSize = 16;
+constexpr size_t kTaskWireRecordFixedSize = 20;
+
+// 大列表快照走共享内存：发布端把 SNAPSHOT 负载写进具名区域（SeqlockSnapshot 布局），
+// 再向悬浮球发送一条不带负载的注册消息 kTaskSnapshotMessageName；悬浮球无锁读出后
+// 按与 WM_COPYDATA 相同的规则应用，并以 TaskSyncResult 作为该消息的返回值。
+constexpr char kTaskSnapshotRegionName[] = "ChatDesktopFloatingTaskSnapshot";
+constexpr size_t kTaskSnapshotCapacity = 4u << 20; // 每槽 4 MiB
+constexpr wchar_t kTaskSnapshotMessageName[] = L"ChatDesktop.FloatingTaskSnapshotPublished";
+
+enum class TaskWireKind : uint8_t {
+  Snapshot = 0, // 完整的未读列表
+  Add = 1,      // 新增（id 已存在时按更新处理）
+  Update = 2,   // 更新已有条目的标题/元数据，位置不变
+  Remove = 3,   // 按 id 移除，只使用记录中的 id
+};
+
+enum class TaskWireError : uint8_t {
+  None,
+  TooShort,
+  BadMagic,
+  UnsupportedVersion,
+  Misaligned,
+  Truncated,
+  BadRecord,
+};
+
+struct TaskWireHeader {
+  uint8_t version{0};
+  TaskWireKind kind{TaskWireKind::Snapshot};
+  uint32_t count{0};
+  uint32_t sequence{0};
+};
+
+// 零拷贝解码：Next 返回的视图直接指向输入缓冲，缓冲须在使用期间保持有效。
+class TaskWireReader {
+public:
+  bool Open(const void* data, size_t size);
+  bool Next(TaskItemView* out);
+
+  const TaskWireHeader& Header() const { return m_header; }
+  TaskWireError Error() const { return m_error; }
+
+private:
+  bool Fail(TaskWireError e) { m_error = e; return false; }
+
+  const uint8_t* m_data{nullptr};
+  size_t m_size{0};
+  size_t m_offset{0};
+  uint32_t m_read{0};
+  TaskWireHeader m_header;
+  TaskWireError m_error{TaskWireError::None};
+};
+
+// 编码端（C++ 侧用于基准/回放，Dart 侧有对应实现 lib/services/floating_ball_wire.dart）。
+class TaskWireWriter {
+public:
+  void Begin(TaskWireKind kind, uint32_t sequence = 0);
+  void Add(const TaskItemView& item);
+  const std::vector<uint8_t>& Finish();
+
+private:
+  std::vector<uint8_t> m_buf; // 复用，Begin 只清空不释放
+  TaskWireKind m_kind{TaskWireKind::Snapshot};
+  uint32_t m_count{0};
+};
+
+// 便利函数：把整块负载解码到 out（复用 out 的容量）。
+bool DecodeTaskWire(const void* data, size_t size, std::vector<TaskItemView>* out, TaskWireHeader* header = nullptr);
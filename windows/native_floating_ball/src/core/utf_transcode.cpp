@@ -0,0 +1,352 @@
+#include "utf_transcode.h"
+#include <cstring>
+
+// NFB_UTF_NO_SIMD：只编译标量路径（测试用它核对向量路径）
+#if defined(NFB_UTF_NO_SIMD)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NFB_UTF_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define NFB_UTF_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+constexpr char32_t kReplacement = 0xFFFD;
+
+bool IsHighSurrogate(char16_t c) { return c >= 0xD800 && c <= 0xDBFF; }
+bool IsLowSurrogate(char16_t c) { return c >= 0xDC00 && c <= 0xDFFF; }
+
+// 从 in[i] 解码一个码点；返回消费的码元数，非法时 *valid = false（消费 1 个码元）
+size_t DecodeUtf16(const char16_t* in, size_t n, size_t i, char32_t* cp, bool* valid) {
+  const char16_t c = in[i];
+  if (c < 0xD800 || c > 0xDFFF) { *cp = c; *valid = true; return 1; }
+  if (IsHighSurrogate(c) && i + 1 < n && IsLowSurrogate(in[i + 1])) {
+    *cp = 0x10000 + (((char32_t)c - 0xD800) << 10) + ((char32_t)in[i + 1] - 0xDC00);
+    *valid = true;
+    return 2;
+  }
+  *cp = kReplacement;
+  *valid = false;
+  return 1;
+}
+
+bool IsCont(uint8_t b) { return (b & 0xC0) == 0x80; }
+
+// 从 in[i] 解码一个码点；非法时 *valid = false，返回“最大非法子序列”的长度（至少 1）
+size_t DecodeUtf8(const uint8_t* in, size_t n, size_t i, char32_t* cp, bool* valid) {
+  const uint8_t b0 = in[i];
+  *valid = false;
+  *cp = kReplacement;
+  if (b0 < 0x80) { *cp = b0; *valid = true; return 1; }
+  if (b0 >= 0xC2 && b0 <= 0xDF) {
+    if (i + 1 < n && IsCont(in[i + 1])) {
+      *cp = ((char32_t)(b0 & 0x1F) << 6) | (in[i + 1] & 0x3F);
+      *valid = true;
+      return 2;
+    }
+    return 1;
+  }
+  if (b0 >= 0xE0 && b0 <= 0xEF) {
+    const uint8_t lo = (b0 == 0xE0) ? 0xA0 : 0x80;
+    const uint8_t hi = (b0 == 0xED) ? 0x9F : 0xBF;
+    if (i + 1 >= n || in[i + 1] < lo || in[i + 1] > hi) return 1;
+    if (i + 2 >= n || !IsCont(in[i + 2])) return 2;
+    *cp = ((char32_t)(b0 & 0x0F) << 12) | ((char32_t)(in[i + 1] & 0x3F) << 6) | (in[i + 2] & 0x3F);
+    *valid = true;
+    return 3;
+  }
+  if (b0 >= 0xF0 && b0 <= 0xF4) {
+    const uint8_t lo = (b0 == 0xF0) ? 0x90 : 0x80;
+    const uint8_t hi = (b0 == 0xF4) ? 0x8F : 0xBF;
+    if (i + 1 >= n || in[i + 1] < lo || in[i + 1] > hi) return 1;
+    if (i + 2 >= n || !IsCont(in[i + 2])) return 2;
+    if (i + 3 >= n || !IsCont(in[i + 3])) return 3;
+    *cp = ((char32_t)(b0 & 0x07) << 18) | ((char32_t)(in[i + 1] & 0x3F) << 12) |
+          ((char32_t)(in[i + 2] & 0x3F) << 6) | (in[i + 3] & 0x3F);
+    *valid = true;
+    return 4;
+  }
+  return 1;
+}
+
+size_t Utf8Units(char32_t cp) {
+  return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+}
+
+size_t EncodeUtf8(char32_t cp, char* out) {
+  if (cp < 0x80) { out[0] = (char)cp; return 1; }
+  if (cp < 0x800) {
+    out[0] = (char)(0xC0 | (cp >> 6));
+    out[1] = (char)(0x80 | (cp & 0x3F));
+    return 2;
+  }
+  if (cp < 0x10000) {
+    out[0] = (char)(0xE0 | (cp >> 12));
+    out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[2] = (char)(0x80 | (cp & 0x3F));
+    return 3;
+  }
+  out[0] = (char)(0xF0 | (cp >> 18));
+  out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+  out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+  out[3] = (char)(0x80 | (cp & 0x3F));
+  return 4;
+}
+
+size_t EncodeUtf16(char32_t cp, char16_t* out) {
+  if (cp < 0x10000) { out[0] = (char16_t)cp; return 1; }
+  cp -= 0x10000;
+  out[0] = (char16_t)(0xD800 + (cp >> 10));
+  out[1] = (char16_t)(0xDC00 + (cp & 0x3FF));
+  return 2;
+}
+
+// ---- 向量块：16 个码元一组 ----
+constexpr size_t kBlock = 16;
+
+#if NFB_UTF_SSE2
+// 16 个 UTF-16 码元全是 ASCII 时压缩写出 16 字节
+bool Utf16AsciiBlock(const char16_t* in, char* out) {
+  const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+  const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8));
+  const __m128i mask = _mm_set1_epi16((short)0xFF80);
+  const __m128i high = _mm_and_si128(_mm_or_si128(a, b), mask);
+  if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xFFFF) return false;
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(a, b));
+  return true;
+}
+
+// 从 in 开始连续统计不含代理项的整块：*units 为消费的码元数（kBlock 的倍数），返回 UTF-8 字节数。
+// 每个码元贡献 1 + (>= 0x80) + (>= 0x800)，比较结果（-1）直接在 16 位通道里累加，定期归约一次。
+size_t Utf8LengthRun(const char16_t* in, size_t n, size_t* units) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ones = _mm_set1_epi16(1);
+  size_t total = 0, i = 0;
+  while (i + kBlock <= n) {
+    __m128i acc = zero; // 负数计数：每块每通道至多 -4，4096 块内不会溢出
+    size_t blocks = 0;
+    for (; blocks < 4096 && i + kBlock <= n; ++blocks, i += kBlock) {
+      const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+      const __m128i fa = _mm_and_si128(a, _mm_set1_epi16((short)0xF800));
+      const __m128i fb = _mm_and_si128(b, _mm_set1_epi16((short)0xF800));
+      const __m128i sur = _mm_or_si128(_mm_cmpeq_epi16(fa, _mm_set1_epi16((short)0xD800)),
+                                       _mm_cmpeq_epi16(fb, _mm_set1_epi16((short)0xD800)));
+      if (_mm_movemask_epi8(sur)) break;
+      const __m128i hi = _mm_set1_epi16((short)0xFF80);
+      // 先取反：比较得到“< 0x80 / < 0x800”，再从 3 里扣除
+      acc = _mm_add_epi16(acc, _mm_cmpeq_epi16(_mm_and_si128(a, hi), zero));
+      acc = _mm_add_epi16(acc, _mm_cmpeq_epi16(_mm_and_si128(b, hi), zero));
+      acc = _mm_add_epi16(acc, _mm_cmpeq_epi16(fa, zero));
+      acc = _mm_add_epi16(acc, _mm_cmpeq_epi16(fb, zero));
+    }
+    if (!blocks) break;
+    // acc 每通道为 -(< 0x80 个数 + < 0x800 个数)，按有符号 16 位横向求和
+    __m128i sum = _mm_madd_epi16(acc, ones);
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    total += blocks * kBlock * 3 - (size_t)(-_mm_cvtsi128_si32(sum));
+    if (blocks < 4096) break;
+  }
+  *units = i;
+  return total;
+}
+
+// 16 字节全是 ASCII 时展开写出 16 个码元
+bool Utf8AsciiBlock(const uint8_t* in, char16_t* out) {
+  const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+  if (_mm_movemask_epi8(v)) return false;
+  const __m128i zero = _mm_setzero_si128();
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(v, zero));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(v, zero));
+  return true;
+}
+
+bool Utf8AsciiOnly(const uint8_t* in) {
+  return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))) == 0;
+}
+#elif NFB_UTF_NEON
+bool Utf16AsciiBlock(const char16_t* in, char* out) {
+  const uint16x8_t a = vld1q_u16(reinterpret_cast<const uint16_t*>(in));
+  const uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t*>(in + 8));
+  if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) return false;
+  vst1q_u8(reinterpret_cast<uint8_t*>(out), vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+  return true;
+}
+
+size_t Utf8LengthRun(const char16_t* in, size_t n, size_t* units) {
+  size_t total = 0, i = 0;
+  while (i + kBlock <= n) {
+    uint16x8_t acc = vdupq_n_u16(0); // 每块每通道至多 +4，4096 块内不会溢出
+    size_t blocks = 0;
+    for (; blocks < 4096 && i + kBlock <= n; ++blocks, i += kBlock) {
+      const uint16x8_t a = vld1q_u16(reinterpret_cast<const uint16_t*>(in + i));
+      const uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t*>(in + i + 8));
+      const uint16x8_t sur = vorrq_u16(vceqq_u16(vandq_u16(a, vdupq_n_u16(0xF800)), vdupq_n_u16(0xD800)),
+                                       vceqq_u16(vandq_u16(b, vdupq_n_u16(0xF800)), vdupq_n_u16(0xD800)));
+      if (vmaxvq_u16(sur)) break;
+      // 每个码元 (>= 0x80) + (>= 0x800)，比较结果右移成 0/1
+      acc = vsraq_n_u16(acc, vcgeq_u16(a, vdupq_n_u16(0x80)), 15);
+      acc = vsraq_n_u16(acc, vcgeq_u16(b, vdupq_n_u16(0x80)), 15);
+      acc = vsraq_n_u16(acc, vcgeq_u16(a, vdupq_n_u16(0x800)), 15);
+      acc = vsraq_n_u16(acc, vcgeq_u16(b, vdupq_n_u16(0x800)), 15);
+    }
+    if (!blocks) break;
+    total += blocks * kBlock + vaddlvq_u16(acc);
+    if (blocks < 4096) break;
+  }
+  *units = i;
+  return total;
+}
+
+bool Utf8AsciiBlock(const uint8_t* in, char16_t* out) {
+  const uint8x16_t v = vld1q_u8(in);
+  if (vmaxvq_u8(v) >= 0x80) return false;
+  vst1q_u16(reinterpret_cast<uint16_t*>(out), vmovl_u8(vget_low_u8(v)));
+  vst1q_u16(reinterpret_cast<uint16_t*>(out + 8), vmovl_u8(vget_high_u8(v)));
+  return true;
+}
+
+bool Utf8AsciiOnly(const uint8_t* in) { return vmaxvq_u8(vld1q_u8(in)) < 0x80; }
+#else
+bool Utf16AsciiBlock(const char16_t* in, char* out) {
+  char16_t acc = 0;
+  for (size_t k = 0; k < kBlock; ++k) acc |= in[k];
+  if (acc >= 0x80) return false;
+  for (size_t k = 0; k < kBlock; ++k) out[k] = (char)in[k];
+  return true;
+}
+
+size_t Utf8LengthRun(const char16_t*, size_t, size_t* units) { *units = 0; return 0; }
+
+bool Utf8AsciiOnly(const uint8_t* in) {
+  uint8_t acc = 0;
+  for (size_t k = 0; k < kBlock; ++k) acc |= in[k];
+  return acc < 0x80;
+}
+
+bool Utf8AsciiBlock(const uint8_t* in, char16_t* out) {
+  if (!Utf8AsciiOnly(in)) return false;
+  for (size_t k = 0; k < kBlock; ++k) out[k] = in[k];
+  return true;
+}
+#endif
+
+} // namespace
+
+size_t Utf8LengthOf(std::u16string_view in, bool* valid) {
+  const char16_t* p = in.data();
+  const size_t n = in.size();
+  size_t len = 0, i = 0;
+  bool ok = true;
+  while (i < n) {
+    size_t units = 0;
+    len += Utf8LengthRun(p + i, n - i, &units);
+    i += units;
+    // 逐码点处理到下一个块边界（含代理对，可能多走一个码元）
+    const size_t stop = (i + kBlock <= n) ? i + kBlock : n;
+    while (i < stop) {
+      char32_t cp;
+      bool v;
+      i += DecodeUtf16(p, n, i, &cp, &v);
+      ok &= v;
+      len += Utf8Units(cp);
+    }
+  }
+  if (valid) *valid = ok;
+  return len;
+}
+
+size_t Utf16LengthOf(std::string_view in, bool* valid) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(in.data());
+  const size_t n = in.size();
+  size_t len = 0, i = 0;
+  bool ok = true;
+  while (i < n) {
+    if (i + kBlock <= n && Utf8AsciiOnly(p + i)) { len += kBlock; i += kBlock; continue; }
+    const size_t stop = (i + kBlock <= n) ? i + kBlock : n;
+    while (i < stop) {
+      char32_t cp;
+      bool v;
+      i += DecodeUtf8(p, n, i, &cp, &v);
+      ok &= v;
+      len += cp >= 0x10000 ? 2 : 1;
+    }
+  }
+  if (valid) *valid = ok;
+  return len;
+}
+
+UtfResult Utf16ToUtf8(std::u16string_view in, char* out, UtfMode mode) {
+  const char16_t* p = in.data();
+  const size_t n = in.size();
+  UtfResult r;
+  size_t i = 0, o = 0;
+  while (i < n) {
+    if (i + kBlock <= n && Utf16AsciiBlock(p + i, out + o)) { i += kBlock; o += kBlock; continue; }
+    const size_t stop = (i + kBlock <= n) ? i + kBlock : n;
+    while (i < stop) {
+      char32_t cp;
+      bool v;
+      const size_t used = DecodeUtf16(p, n, i, &cp, &v);
+      if (!v && mode == UtfMode::Strict) {
+        r.ok = false;
+        r.read = i;
+        r.written = o;
+        return r;
+      }
+      o += EncodeUtf8(cp, out + o);
+      i += used;
+    }
+  }
+  r.read = i;
+  r.written = o;
+  return r;
+}
+
+UtfResult Utf8ToUtf16(std::string_view in, char16_t* out, UtfMode mode) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(in.data());
+  const size_t n = in.size();
+  UtfResult r;
+  size_t i = 0, o = 0;
+  while (i < n) {
+    if (i + kBlock <= n && Utf8AsciiBlock(p + i, out + o)) { i += kBlock; o += kBlock; continue; }
+    const size_t stop = (i + kBlock <= n) ? i + kBlock : n;
+    while (i < stop) {
+      char32_t cp;
+      bool v;
+      const size_t used = DecodeUtf8(p, n, i, &cp, &v);
+      if (!v && mode == UtfMode::Strict) {
+        r.ok = false;
+        r.read = i;
+        r.written = o;
+        return r;
+      }
+      o += EncodeUtf16(cp, out + o);
+      i += used;
+    }
+  }
+  r.read = i;
+  r.written = o;
+  return r;
+}
+
+bool Utf16ToUtf8(std::u16string_view in, std::string* out, UtfMode mode) {
+  bool valid = true;
+  const size_t len = Utf8LengthOf(in, &valid);
+  if (!valid && mode == UtfMode::Strict) { out->clear(); return false; }
+  out->resize(len);
+  if (len) Utf16ToUtf8(in, &(*out)[0], UtfMode::Lossy);
+  return true;
+}
+
+bool Utf8ToUtf16(std::string_view in, std::u16string* out, UtfMode mode) {
+  // UTF-16 码元数不超过 UTF-8 字节数：按上界分配后单遍解码，再截短（不重新分配）
+  out->resize(in.size());
+  const UtfResult r = in.empty() ? UtfResult{} : Utf8ToUtf16(in, &(*out)[0], mode);
+  if (!r.ok) { out->clear(); return false; }
+  out->resize(r.written);
+  return true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// UTF-16 ⇄ UTF-8 转码（可移植，带校验）。主程序的命令行参数、平台通道字符串与悬浮球 IPC 编解码共用。
+//
+// 只分配一次：UTF-16→UTF-8 先算出精确长度再一次写满（不需要 WideCharToMultiByte 那样“先问长度再转换”的
+// 两次系统调用，也不按 3 倍最坏情况多分配）；UTF-8→UTF-16 的输出码元数不超过输入字节数，按上界分配后单遍解码。
+// x86-64（SSE2）/ AArch64（NEON）上 ASCII 连续段按 16 个码元一组转换；UTF-16→UTF-8 的长度统计对
+// 不含代理项的块（包括中文）也走向量路径。其余情况逐码点处理。
+//
+// 非法输入：
+//   UTF-16 中不成对的代理项；UTF-8 中的过长编码、编码后的代理项、超出 U+10FFFF、截断序列与孤立续字节。
+// Strict 模式遇到第一个非法序列即停止并报告位置；Lossy 模式把每个“最大非法子序列”替换为 U+FFFD
+// （与 Unicode 第 3 章 / WHATWG Encoding 的替换规则一致）。
+enum class UtfMode : uint8_t {
+  Strict,
+  Lossy,
+};
+
+struct UtfResult {
+  bool ok{true};      // Strict 模式下遇到非法输入时为 false
+  size_t read{0};     // 已消费的输入码元数（失败时即非法序列的起始位置）
+  size_t written{0};  // 已写出的输出码元数
+};
+
+// Lossy 转换后的精确输出长度；valid（可选）返回输入是否完全合法
+size_t Utf8LengthOf(std::u16string_view in, bool* valid = nullptr);
+size_t Utf16LengthOf(std::string_view in, bool* valid = nullptr);
+
+// out 须至少能容纳对应 Length 函数返回的码元数
+UtfResult Utf16ToUtf8(std::u16string_view in, char* out, UtfMode mode = UtfMode::Lossy);
+UtfResult Utf8ToUtf16(std::string_view in, char16_t* out, UtfMode mode = UtfMode::Lossy);
+
+// 便利函数：一次分配。Strict 模式失败时返回 false，out 被清空
+bool Utf16ToUtf8(std::u16string_view in, std::string* out, UtfMode mode = UtfMode::Lossy);
+bool Utf8ToUtf16(std::string_view in, std::u16string* out, UtfMode mode = UtfMode::Lossy);
@@ -0,0 +1,98 @@
+#include "dwrite_glyph_rasterizer.h"
+#include <cmath>
+
+DWriteGlyphRasterizer::~DWriteGlyphRasterizer() {
+  for (auto& f : m_faces) if (f.face) f.face->Release();
+  if (m_factory2) m_factory2->Release();
+}
+
+bool DWriteGlyphRasterizer::Initialize(IDWriteFactory* factory, const wchar_t* const* families, size_t familyCount) {
+  if (!factory || IsReady()) return IsReady();
+  if (FAILED(factory->QueryInterface(__uuidof(IDWriteFactory2), reinterpret_cast<void**>(&m_factory2)))) {
+    m_factory2 = nullptr;
+    return false;
+  }
+  IDWriteFontCollection* collection = nullptr;
+  if (FAILED(factory->GetSystemFontCollection(&collection)) || !collection) return false;
+  for (size_t i = 0; i < familyCount; ++i) {
+    UINT32 index = 0; BOOL exists = FALSE;
+    if (FAILED(collection->FindFamilyName(families[i], &index, &exists)) || !exists) continue;
+    IDWriteFontFamily* family = nullptr;
+    if (FAILED(collection->GetFontFamily(index, &family)) || !family) continue;
+    IDWriteFont* font = nullptr;
+    if (SUCCEEDED(family->GetFirstMatchingFont(DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STRETCH_NORMAL, DWRITE_FONT_STYLE_NORMAL, &font)) && font) {
+      Face f;
+      if (SUCCEEDED(font->CreateFontFace(&f.face)) && f.face) {
+        f.face->GetMetrics(&f.metrics);
+        m_faces.push_back(f);
+      }
+      font->Release();
+    }
+    family->Release();
+  }
+  collection->Release();
+  return IsReady();
+}
+
+float DWriteGlyphRasterizer::Ascent(float sizePx) const {
+  if (m_faces.empty()) return sizePx;
+  const auto& m = m_faces[0].metrics;
+  return m.ascent * sizePx / m.designUnitsPerEm;
+}
+
+float DWriteGlyphRasterizer::LineHeight(float sizePx) const {
+  if (m_faces.empty()) return sizePx * 1.3f;
+  const auto& m = m_faces[0].metrics;
+  return (m.ascent + m.descent + m.lineGap) * sizePx / m.designUnitsPerEm;
+}
+
+bool DWriteGlyphRasterizer::Rasterize(uint32_t codepoint, float sizePx, GlyphBitmap* out) {
+  if (!IsReady() || !out) return false;
+  // 字体回退：取第一个包含该码点的字体；都没有时用主字体的 .notdef
+  const Face* chosen = &m_faces[0];
+  UINT16 glyph = 0;
+  for (const auto& f : m_faces) {
+    UINT16 gi = 0;
+    const UINT32 cp = codepoint;
+    if (SUCCEEDED(f.face->GetGlyphIndices(&cp, 1, &gi)) && gi != 0) {
+      chosen = &f;
+      glyph = gi;
+      break;
+    }
+  }
+
+  DWRITE_GLYPH_METRICS gm{};
+  chosen->face->GetDesignGlyphMetrics(&glyph, 1, &gm, FALSE);
+  out->advance = gm.advanceWidth * sizePx / chosen->metrics.designUnitsPerEm;
+
+  FLOAT advance = 0.f;
+  DWRITE_GLYPH_OFFSET offset{};
+  DWRITE_GLYPH_RUN run{};
+  run.fontFace = chosen->face;
+  run.fontEmSize = sizePx;
+  run.glyphCount = 1;
+  run.glyphIndices = &glyph;
+  run.glyphAdvances = &advance;
+  run.glyphOffsets = &offset;
+
+  IDWriteGlyphRunAnalysis* analysis = nullptr;
+  HRESULT hr = m_factory2->CreateGlyphRunAnalysis(
+      &run, nullptr, DWRITE_RENDERING_MODE_NATURAL_SYMMETRIC, DWRITE_MEASURING_MODE_NATURAL,
+      DWRITE_GRID_FIT_MODE_DEFAULT, DWRITE_TEXT_ANTIALIAS_MODE_GRAYSCALE, 0.f, 0.f, &analysis);
+  if (FAILED(hr) || !analysis) return false;
+
+  // 灰度抗锯齿模式下 ALIASED_1x1 纹理即为 8 位覆盖率
+  RECT bounds{};
+  hr = analysis->GetAlphaTextureBounds(DWRITE_TEXTURE_ALIASED_1x1, &bounds);
+  if (SUCCEEDED(hr) && bounds.right > bounds.left && bounds.bottom > bounds.top) {
+    out->width = bounds.right - bounds.left;
+    out->height = bounds.bottom - bounds.top;
+    out->left = bounds.left;
+    out->top = -bounds.top;
+    out->coverage.resize((size_t)out->width * (size_t)out->height);
+    hr = analysis->CreateAlphaTexture(DWRITE_TEXTURE_ALIASED_1x1, &bounds, out->coverage.data(), (UINT32)out->coverage.size());
+    if (FAILED(hr)) { out->width = out->height = 0; out->coverage.clear(); }
+  }
+  analysis->Release();
+  return true; // 空白字形（空格）也是成功
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <windows.h>
+#include <dwrite_2.h>
+#include <vector>
+#include "core/glyph_atlas.h"
+
+// GlyphRasterizer 的 DirectWrite 实现：按字体列表逐个查找码点（Segoe UI 缺中文时回退到雅黑），
+// 通过 IDWriteGlyphRunAnalysis 生成灰度覆盖位图。需要 IDWriteFactory2（Win8.1+），
+// 初始化失败时调用方应回退到 DrawTextLayout 路径。
+class DWriteGlyphRasterizer : public GlyphRasterizer {
+public:
+  DWriteGlyphRasterizer() = default;
+  ~DWriteGlyphRasterizer() override;
+  DWriteGlyphRasterizer(const DWriteGlyphRasterizer&) = delete;
+  DWriteGlyphRasterizer& operator=(const DWriteGlyphRasterizer&) = delete;
+
+  bool Initialize(IDWriteFactory* factory, const wchar_t* const* families, size_t familyCount);
+  bool IsReady() const { return m_factory2 && !m_faces.empty(); }
+
+  bool Rasterize(uint32_t codepoint, float sizePx, GlyphBitmap* out) override;
+  float Ascent(float sizePx) const override;
+  float LineHeight(float sizePx) const override;
+
+private:
+  struct Face {
+    IDWriteFontFace* face{nullptr};
+    DWRITE_FONT_METRICS metrics{};
+  };
+  IDWriteFactory2* m_factory2{nullptr};
+  std::vector<Face> m_faces; // [0] 为主字体，决定行高/基线
+};
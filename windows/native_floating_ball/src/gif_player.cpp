@@ -2,7 +2,6 @@
 #include <propvarutil.h>
 #include <algorithm>
 #include <cstdint>
-#include <cstring>
 
 static bool MetadataUInt(IWICMetadataQueryReader* reader, const wchar_t* name, UINT* out) {
   if (!reader || !name || !out) return false;
@@ -113,16 +112,11 @@ static void ClearRectPremultipliedBGRA(
   }
 }
 
-GifPlayer::~GifPlayer() {
-  for (auto* f : m_frames) if (f) f->Release();
-}
-
-bool GifPlayer::Load(IWICImagingFactory* pFactory, const std::wstring& path) {
-  for (auto* f : m_frames) if (f) f->Release();
-  m_frames.clear();
-  m_delaysMs.clear();
-  m_width = 0;
-  m_height = 0;
+// 只保留显示尺寸帧：每合成一帧就缩放、乘蒙版后送进 m_frames，整张画布在加载结束即释放
+bool GifPlayer::Load(IWICImagingFactory* pFactory, const std::wstring& path, const CircleMask& mask) {
+  m_frames.Clear();
+  m_memory.Set(0);
+  if (!pFactory) return false;
 
   IWICBitmapDecoder* pDecoder = nullptr;
   if (FAILED(pFactory->CreateDecoderFromFilename(path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &pDecoder)))
@@ -146,16 +140,18 @@ bool GifPlayer::Load(IWICImagingFactory* pFactory, const std::wstring& path) {
     }
   }
   if (canvasW == 0 || canvasH == 0) firstFrame->GetSize(&canvasW, &canvasH);
-  if (canvasW == 0 || canvasH == 0) {
-    firstFrame->Release();
+  firstFrame->Release();
+  if (canvasW == 0 || canvasH == 0 || !m_frames.Begin(canvasW, canvasH, mask, count)) {
     pDecoder->Release();
     return false;
   }
-  m_width = canvasW;
-  m_height = canvasH;
 
   std::vector<BYTE> canvas(canvasW * canvasH * 4u, (BYTE)0);
   std::vector<BYTE> prevCanvas;
+  std::vector<BYTE> src;
+  // 加载期间的临时内存：画布、Disposal 3 的恢复点与单帧解码缓冲，计入峰值
+  MemoryCharge scratch(MemorySubsystem::AnimationFrames);
+  scratch.Set(canvas.size());
 
   for (UINT i = 0; i < count; ++i) {
     IWICBitmapFrameDecode* frame = nullptr;
@@ -173,8 +169,6 @@ bool GifPlayer::Load(IWICImagingFactory* pFactory, const std::wstring& path) {
       reader->Release();
     }
 
-    m_delaysMs.push_back(DelayFromFrame(frame));
-
     if (disp == 3) {
       prevCanvas = canvas;
     }
@@ -184,34 +178,17 @@ bool GifPlayer::Load(IWICImagingFactory* pFactory, const std::wstring& path) {
     if (SUCCEEDED(pFactory->CreateFormatConverter(&conv)) && conv) {
       if (SUCCEEDED(conv->Initialize(frame, GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.f, WICBitmapPaletteTypeCustom))) {
         const UINT srcStride = frameW * 4u;
-        std::vector<BYTE> src(frameH * srcStride);
+        src.resize(frameH * srcStride);
         if (SUCCEEDED(conv->CopyPixels(nullptr, srcStride, (UINT)src.size(), src.data()))) {
           BlendPremultipliedBGRA(canvas, canvasW, canvasH, src.data(), frameW, frameH, left, top);
         }
       }
       conv->Release();
     }
+    scratch.Set(canvas.size() + prevCanvas.capacity() + src.capacity());
 
-    // 把“当前整帧”复制成 IWICBitmap 保存下来（用于后续绘制）。
-    IWICBitmap* composed = nullptr;
-    if (SUCCEEDED(pFactory->CreateBitmap(canvasW, canvasH, GUID_WICPixelFormat32bppPBGRA, WICBitmapCacheOnLoad, &composed)) && composed) {
-      WICRect rect{ 0, 0, (INT)canvasW, (INT)canvasH };
-      IWICBitmapLock* lock = nullptr;
-      if (SUCCEEDED(composed->Lock(&rect, WICBitmapLockWrite, &lock)) && lock) {
-        UINT cb = 0;
-        BYTE* data = nullptr;
-        UINT stride = 0;
-        lock->GetStride(&stride);
-        if (SUCCEEDED(lock->GetDataPointer(&cb, &data)) && data && stride >= canvasW * 4u) {
-          const UINT rowBytes = canvasW * 4u;
-          for (UINT y = 0; y < canvasH; ++y) {
-            memcpy(data + y * stride, canvas.data() + y * rowBytes, rowBytes);
-          }
-        }
-        lock->Release();
-      }
-      m_frames.push_back(composed);
-    }
+    // 当前整帧：缩放到直径、乘上圆形蒙版后保留
+    m_frames.AddCanvas(canvas.data(), canvasW * 4u, DelayFromFrame(frame));
 
     // 处理 Disposal：对“显示后的下一帧”生效
     if (disp == 2) {
@@ -223,24 +200,14 @@ bool GifPlayer::Load(IWICImagingFactory* pFactory, const std::wstring& path) {
     frame->Release();
   }
 
-  firstFrame->Release();
   pDecoder->Release();
-  return !m_frames.empty();
+  const bool ok = m_frames.Finish();
+  m_memory.Set(m_frames.Bytes());
+  return ok;
 }
 
 UINT GifPlayer::GetDelayMs(UINT frameIndex) const {
-  if (frameIndex >= m_delaysMs.size()) return 100;
-  return m_delaysMs[frameIndex];
-}
-
-bool GifPlayer::CreateConvertedFrame(IWICImagingFactory* pFactory, UINT frameIndex, IWICFormatConverter** ppConv) {
-  if (frameIndex >= m_frames.size()) return false;
-  IWICFormatConverter* pConv = nullptr;
-  if (FAILED(pFactory->CreateFormatConverter(&pConv))) return false;
-  if (FAILED(pConv->Initialize(m_frames[frameIndex], GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.f, WICBitmapPaletteTypeCustom))) {
-    pConv->Release();
-    return false;
-  }
-  *ppConv = pConv;
-  return true;
+  const std::vector<UINT>& delays = m_frames.DelaysMs();
+  if (frameIndex >= delays.size()) return 100;
+  return delays[frameIndex];
 }
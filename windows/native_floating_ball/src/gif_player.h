@@ -3,28 +3,32 @@
 #ifndef NOMINMAX
 #define NOMINMAX
 #endif
+#include <windows.h>
 #include <wincodec.h>
 #include <vector>
 #include <string>
+#include "core/display_frames.h"
+#include "core/memory_accounting.h"
 
 class GifPlayer {
 public:
   GifPlayer() = default;
-  ~GifPlayer();
 
-  bool Load(IWICImagingFactory* pFactory, const std::wstring& path);
-  UINT FrameCount() const { return (UINT)m_frames.size(); }
+  // WIC 解码并按 FrameRect/Disposal 合成整帧，再构建显示尺寸帧（尺寸为 mask 的直径，圆形蒙版已乘进像素）
+  bool Load(IWICImagingFactory* pFactory, const std::wstring& path, const CircleMask& mask);
+  UINT FrameCount() const { return (UINT)m_frames.FrameCount(); }
   UINT GetDelayMs(UINT frameIndex) const; // per frame
+  const std::vector<UINT>& DelaysMs() const { return m_frames.DelaysMs(); }
 
-  // Creates a converter for the requested frame in 32bppPBGRA
-  bool CreateConvertedFrame(IWICImagingFactory* pFactory, UINT frameIndex, IWICFormatConverter** ppConv);
+  // diameter x diameter 的预乘 BGRA，行距 diameter * 4
+  const uint8_t* DisplayFrame(UINT frameIndex) const { return m_frames.Frame(frameIndex); }
+  // 所有帧 alpha 的并集按阈值压成的命中区域
+  const HitMask& Hit() const { return m_frames.Hit(); }
 
-  UINT Width() const { return m_width; }
-  UINT Height() const { return m_height; }
+  UINT Width() const { return m_frames.SourceWidth(); }
+  UINT Height() const { return m_frames.SourceHeight(); }
 
 private:
-  // 预合成后的整帧（已按 GIF 的 FrameRect/Disposal 规则叠加），用于直接绘制。
-  std::vector<IWICBitmap*> m_frames;
-  std::vector<UINT> m_delaysMs;
-  UINT m_width{0}, m_height{0};
+  DisplayFrames m_frames;
+  MemoryCharge m_memory{MemorySubsystem::AnimationFrames}; // 已保留帧的像素（每帧 diameter²*4）
 };
@@ -0,0 +1,15 @@
+#include "ipc_send.h"
+
+bool SendCopyData(HWND target, ULONG_PTR dwData, const void* data, DWORD bytes, LRESULT* reply, UINT timeoutMs) {
+  if (!target || !IsWindow(target)) return false;
+  COPYDATASTRUCT cds{};
+  cds.dwData = dwData;
+  cds.cbData = bytes;
+  cds.lpData = const_cast<void*>(data);
+  DWORD_PTR result = 0;
+  const LRESULT ok = SendMessageTimeoutW(target, WM_COPYDATA, 0, (LPARAM)&cds,
+                                         SMTO_ABORTIFHUNG | SMTO_ERRORONEXIT, timeoutMs, &result);
+  if (!ok) return false;
+  if (reply) *reply = (LRESULT)result;
+  return true;
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <windows.h>
+
+// 跨进程 WM_COPYDATA 的有界发送：对方忙碌/挂起/退出时最多阻塞 timeoutMs，
+// 避免一端卡在耗时的绘制里把另一端的 UI 线程一起拖住。
+constexpr UINT kIpcSendTimeoutMs = 250;
+
+// 成功送达并返回时为 true，reply 为对方的返回值；超时/对方挂起/窗口已销毁时为 false。
+bool SendCopyData(HWND target, ULONG_PTR dwData, const void* data, DWORD bytes,
+                  LRESULT* reply = nullptr, UINT timeoutMs = kIpcSendTimeoutMs);
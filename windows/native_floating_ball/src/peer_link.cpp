@@ -0,0 +1,71 @@
+#include "peer_link.h"
+#include <cwchar>
+
+PeerLink::PeerLink(const wchar_t* peerClass, uint32_t peerRole)
+  : m_peerClass(peerClass), m_peerRole(peerRole) {}
+
+UINT PeerLink::Attach(HWND self, uint32_t selfRole) {
+  m_self = self;
+  m_selfRole = selfRole;
+  m_helloMsg = RegisterWindowMessageW(kPeerHelloMessageName);
+  // 只在启动时广播一次；PostMessage 不等待任何窗口处理
+  if (m_helloMsg) PostMessageW(HWND_BROADCAST, m_helloMsg, (WPARAM)self, (LPARAM)selfRole);
+  return m_helloMsg;
+}
+
+void PeerLink::OnHello(WPARAM wParam, LPARAM lParam) {
+  HWND from = reinterpret_cast<HWND>(wParam);
+  const uint32_t flags = (uint32_t)lParam;
+  if (!from || from == m_self || (flags & kPeerRoleMask) != m_peerRole) return;
+  Cache(from);
+  if (!(flags & kPeerHelloReply) && m_self) {
+    PostMessageW(from, m_helloMsg, (WPARAM)m_self, (LPARAM)(m_selfRole | kPeerHelloReply));
+  }
+}
+
+HWND PeerLink::Resolve(bool* cached) {
+  const bool hit = IsValid();
+  if (cached) *cached = hit;
+  if (hit) return m_peer;
+  Invalidate();
+  HWND found = Discover();
+  if (found) Cache(found);
+  return found;
+}
+
+bool PeerLink::IsValid() const {
+  if (!m_peer || !IsWindow(m_peer)) return false;
+  // HWND 可能被系统回收后分配给别的进程：所属进程变化即视为失效
+  DWORD pid = 0;
+  GetWindowThreadProcessId(m_peer, &pid);
+  return pid == m_peerPid;
+}
+
+void PeerLink::Cache(HWND peer) {
+  DWORD pid = 0;
+  GetWindowThreadProcessId(peer, &pid);
+  m_peer = pid ? peer : nullptr;
+  m_peerPid = pid;
+}
+
+HWND PeerLink::Discover() const {
+  // 有些情况下 FindWindow 会找不到（多窗口/不同线程创建），这里枚举顶层窗口更稳。
+  struct Ctx {
+    const wchar_t* cls;
+    HWND found{nullptr};
+  } ctx{m_peerClass};
+  EnumWindows(
+      [](HWND hWnd, LPARAM lp) -> BOOL {
+        auto* c = reinterpret_cast<Ctx*>(lp);
+        wchar_t cls[256]{0};
+        if (GetClassNameW(hWnd, cls, (int)(sizeof(cls) / sizeof(cls[0])))) {
+          if (wcscmp(cls, c->cls) == 0) {
+            c->found = hWnd;
+            return FALSE; // stop
+          }
+        }
+        return TRUE; // continue
+      },
+      reinterpret_cast<LPARAM>(&ctx));
+  return ctx.found;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include "core/peer_hello.h"
+
+// 对端窗口句柄缓存（见 core/peer_hello.h 的握手协议）。
+// Resolve() 命中缓存时只有 IsWindow + GetWindowThreadProcessId 两次系统调用；
+// 缓存失效（对端重启/窗口销毁）时才按类名枚举顶层窗口重新发现。
+class PeerLink {
+public:
+  PeerLink(const wchar_t* peerClass, uint32_t peerRole);
+
+  // 绑定本端窗口并广播一次 PeerHello；返回注册消息 ID（失败为 0）
+  UINT Attach(HWND self, uint32_t selfRole);
+  UINT HelloMessage() const { return m_helloMsg; }
+
+  // 处理收到的 PeerHello：角色匹配时缓存对端，并在对方未标记应答时回一条应答
+  void OnHello(WPARAM wParam, LPARAM lParam);
+
+  // 返回可用的对端窗口；*cached（可选）表示是否命中缓存
+  HWND Resolve(bool* cached = nullptr);
+  void Invalidate() { m_peer = nullptr; m_peerPid = 0; }
+
+private:
+  bool IsValid() const;
+  void Cache(HWND peer);
+  HWND Discover() const;
+
+  const wchar_t* m_peerClass;
+  uint32_t m_peerRole;
+  uint32_t m_selfRole{0};
+  HWND m_self{nullptr};
+  UINT m_helloMsg{0};
+  HWND m_peer{nullptr};
+  DWORD m_peerPid{0};
+};
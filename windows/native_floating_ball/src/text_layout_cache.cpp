@@ -0,0 +1,52 @@
+#include "text_layout_cache.h"
+
+// FNV-1a 64
+static uint64_t Fingerprint(std::wstring_view text, std::wstring_view font, float maxWidth, UINT dpi) {
+  uint64_t h = 1469598103934665603ull;
+  auto feed = [&h](const void* data, size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+  };
+  feed(text.data(), text.size() * sizeof(wchar_t));
+  feed(font.data(), font.size() * sizeof(wchar_t));
+  feed(&maxWidth, sizeof(maxWidth));
+  feed(&dpi, sizeof(dpi));
+  return h;
+}
+
+TextLayoutCache::~TextLayoutCache() {
+  m_cache.Clear();
+  if (m_ellipsis) m_ellipsis->Release();
+}
+
+const CachedTextLayout* TextLayoutCache::Get(IDWriteFactory* factory, IDWriteTextFormat* format,
+                                             std::wstring_view fontKey, std::wstring_view text,
+                                             float maxWidth, float lineHeight, UINT dpi) {
+  const uint64_t key = Fingerprint(text, fontKey, maxWidth, dpi);
+  if (CachedTextLayout* hit = m_cache.Find(key)) {
+    if (hit->Matches(text, fontKey, maxWidth, dpi)) return hit;
+  }
+  if (!factory || !format) return nullptr;
+
+  IDWriteTextLayout* layout = nullptr;
+  if (FAILED(factory->CreateTextLayout(text.data(), (UINT32)text.size(), format, maxWidth, lineHeight, &layout)) || !layout) {
+    return nullptr;
+  }
+  // 单行显示：禁止换行，超出部分按字符截断并以“…”结尾（中文标题没有空格，不能按词截断）
+  layout->SetWordWrapping(DWRITE_WORD_WRAPPING_NO_WRAP);
+  if (m_ellipsisFormat != format) {
+    if (m_ellipsis) { m_ellipsis->Release(); m_ellipsis = nullptr; }
+    factory->CreateEllipsisTrimmingSign(format, &m_ellipsis);
+    m_ellipsisFormat = format;
+  }
+  DWRITE_TRIMMING trimming{ DWRITE_TRIMMING_GRANULARITY_CHARACTER, 0, 0 };
+  layout->SetTrimming(&trimming, m_ellipsis);
+
+  DWRITE_TEXT_METRICS metrics{};
+  float width = maxWidth, height = lineHeight;
+  if (SUCCEEDED(layout->GetMetrics(&metrics))) {
+    width = (metrics.width < maxWidth) ? metrics.width : maxWidth;
+    height = metrics.height;
+  }
+  return m_cache.Insert(key, CachedTextLayout(layout, width, height, text, fontKey, maxWidth, dpi));
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <windows.h>
+#include <dwrite.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "core/lru_cache.h"
+
+// 单行文本的“测量 + 省略号截断”结果缓存。
+// key = (文本, 字体, 最大宽度, DPI) 的 64 位指纹；value 持有已设置好截断规则的 IDWriteTextLayout
+// 及其测量尺寸，并保存完整 key 用于校验指纹冲突。查找不分配内存，动画帧只做一次哈希。
+class CachedTextLayout {
+public:
+  CachedTextLayout() = default;
+  CachedTextLayout(IDWriteTextLayout* layout, float width, float height,
+                   std::wstring_view text, std::wstring_view font, float maxWidth, UINT dpi)
+      : m_layout(layout), m_width(width), m_height(height),
+        m_text(text), m_font(font), m_maxWidth(maxWidth), m_dpi(dpi) {}
+  ~CachedTextLayout() { if (m_layout) m_layout->Release(); }
+  CachedTextLayout(CachedTextLayout&& o) noexcept { *this = std::move(o); }
+  CachedTextLayout& operator=(CachedTextLayout&& o) noexcept {
+    if (this != &o) {
+      if (m_layout) m_layout->Release();
+      m_layout = o.m_layout; o.m_layout = nullptr;
+      m_width = o.m_width; m_height = o.m_height;
+      m_text = std::move(o.m_text); m_font = std::move(o.m_font);
+      m_maxWidth = o.m_maxWidth; m_dpi = o.m_dpi;
+    }
+    return *this;
+  }
+  CachedTextLayout(const CachedTextLayout&) = delete;
+  CachedTextLayout& operator=(const CachedTextLayout&) = delete;
+
+  IDWriteTextLayout* Layout() const { return m_layout; }
+  float Width() const { return m_width; }   // 截断后的实际绘制宽度
+  float Height() const { return m_height; }
+
+  bool Matches(std::wstring_view text, std::wstring_view font, float maxWidth, UINT dpi) const {
+    return m_maxWidth == maxWidth && m_dpi == dpi && m_text == text && m_font == font;
+  }
+
+private:
+  IDWriteTextLayout* m_layout{nullptr};
+  float m_width{0.f};
+  float m_height{0.f};
+  std::wstring m_text;
+  std::wstring m_font;
+  float m_maxWidth{0.f};
+  UINT m_dpi{96};
+};
+
+class TextLayoutCache {
+public:
+  using Stats = LruCache<uint64_t, CachedTextLayout>::Stats;
+
+  explicit TextLayoutCache(size_t capacity = 256) : m_cache(capacity) {}
+  ~TextLayoutCache();
+
+  // format/factory 由调用方持有；fontKey 用于区分不同的 text format。
+  const CachedTextLayout* Get(IDWriteFactory* factory, IDWriteTextFormat* format,
+                              std::wstring_view fontKey, std::wstring_view text,
+                              float maxWidth, float lineHeight, UINT dpi);
+
+  Stats GetStats() const { return m_cache.GetStats(); }
+  void Clear() { m_cache.Clear(); }
+
+private:
+  LruCache<uint64_t, CachedTextLayout> m_cache;
+  IDWriteInlineObject* m_ellipsis{nullptr};
+  IDWriteTextFormat* m_ellipsisFormat{nullptr}; // 省略号对象与创建它的 format 绑定
+};
@@ -0,0 +1,10 @@
+// libFuzzer 入口：cmake -DNFB_BUILD_FUZZERS=ON -DCMAKE_CXX_COMPILER=clang++ 后
+//   build/tests/fuzz_task_wire corpus/ -max_total_time=600
+#include <cstddef>
+#include <cstdint>
+#include "task_wire_fuzz.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  if (!FuzzTaskWireOnce(data, size)) __builtin_trap();
+  return 0;
+}
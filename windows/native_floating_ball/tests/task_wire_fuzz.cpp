@@ -0,0 +1,112 @@
+#include "task_wire_fuzz.h"
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/task_list_model.h"
+#include "core/task_sync.h"
+#include "core/task_wire.h"
+
+namespace {
+
+bool Within(std::u16string_view view, const uint8_t* begin, const uint8_t* end) {
+  if (view.empty()) return true;
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(view.data());
+  return p >= begin && p + view.size() * sizeof(char16_t) <= end;
+}
+
+bool SameItem(const TaskItemView& a, const TaskItemView& b) {
+  return a.id == b.id && a.title == b.title && a.priority == b.priority && a.flags == b.flags && a.dueMs == b.dueMs &&
+         a.position == b.position;
+}
+
+// 行数与 id 索引自洽：live 行都能按 id 找回自己的下标。IndexOf 是线性的，只检查前 64 行
+bool ModelConsistent(const TaskListModel& model) {
+  if (model.LiveCount() > model.Size()) return false;
+  size_t live = 0;
+  for (size_t i = 0; i < model.Size(); ++i) {
+    const TaskRow& row = model.Row(i);
+    if (row.removing) continue;
+    ++live;
+    if (i < 64 && model.IndexOf(row.item.id) != (int)i) return false;
+  }
+  return live == model.LiveCount();
+}
+
+// 模型全部可见状态（顺序、内容、版本、残影标记）的指纹，用于判断模型是否被改动
+uint64_t ModelFingerprint(const TaskListModel& model) {
+  uint64_t h = 1469598103934665603ull;
+  const auto mix = [&h](uint64_t v) { h = (h ^ v) * 1099511628211ull; };
+  for (size_t i = 0; i < model.Size(); ++i) {
+    const TaskRow& row = model.Row(i);
+    mix(HashTaskId(row.item.id));
+    mix(HashTaskId(row.item.title));
+    mix(row.version);
+    mix(row.removing);
+  }
+  mix(model.LiveCount());
+  return h;
+}
+
+} // namespace
+
+bool FuzzTaskWireOnce(const uint8_t* data, size_t size) {
+  // 拷进恰好 size 字节的新缓冲：new[] 满足读端的对齐要求，越界读会被 ASan 报告
+  std::unique_ptr<uint8_t[]> buf(new uint8_t[size ? size : 1]);
+  if (size) std::memcpy(buf.get(), data, size);
+  const uint8_t* begin = buf.get();
+  const uint8_t* end = begin + size;
+  bool ok = true;
+
+  TaskWireReader reader;
+  std::vector<TaskItemView> items;
+  bool complete = false;
+  if (reader.Open(begin, size)) {
+    TaskItemView item;
+    while (reader.Next(&item)) {
+      ok &= Within(item.id, begin, end) && Within(item.title, begin, end);
+      items.push_back(item);
+    }
+    ok &= items.size() <= reader.Header().count;
+    complete = reader.Error() == TaskWireError::None;
+    if (complete) ok &= items.size() == reader.Header().count;
+  }
+
+  // 完整解码的负载：重新编码（规范形式）后再解码，字段逐一相同
+  if (complete) {
+    TaskWireWriter writer;
+    writer.Begin(reader.Header().kind, reader.Header().sequence);
+    for (const TaskItemView& item : items) writer.Add(item);
+    const std::vector<uint8_t> encoded = writer.Finish();
+    std::vector<TaskItemView> again;
+    TaskWireHeader header;
+    ok &= DecodeTaskWire(encoded.data(), encoded.size(), &again, &header);
+    ok &= again.size() == items.size() && header.sequence == reader.Header().sequence;
+    for (size_t i = 0; ok && i < items.size(); ++i) ok &= SameItem(items[i], again[i]);
+  }
+
+  // 应用到模型：先以 sequence - 1 建立一份基线快照，增量才会真正走到逐条应用
+  TaskListModel model;
+  TaskSyncReceiver sync;
+  if (size >= kTaskWireHeaderSize) {
+    uint32_t sequence;
+    std::memcpy(&sequence, begin + 12, sizeof(sequence));
+    static const char16_t* kIds[] = { u"1", u"2", u"3", u"4", u"5" };
+    TaskWireWriter writer;
+    writer.Begin(TaskWireKind::Snapshot, sequence - 1);
+    for (const char16_t* id : kIds) {
+      TaskItemView view;
+      view.id = id;
+      view.title = u"baseline";
+      writer.Add(view);
+    }
+    const std::vector<uint8_t> baseline = writer.Finish();
+    sync.Apply(baseline.data(), baseline.size(), model);
+  }
+  // 未应用（拒绝或要求重发快照）的负载不能留下半条更新
+  const uint64_t before = ModelFingerprint(model);
+  const TaskSyncResult result = sync.Apply(begin, size, model);
+  ok &= ModelConsistent(model);
+  if (result != TaskSyncResult::Applied) ok &= ModelFingerprint(model) == before;
+  return ok;
+}
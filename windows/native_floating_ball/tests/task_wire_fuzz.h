@@ -0,0 +1,13 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// UPDATE_TASKS 读端的模糊测试体，由两处共用：
+//   fuzz_task_wire（libFuzzer，-DNFB_BUILD_FUZZERS=ON，需 Clang）做覆盖率引导的长时间模糊；
+//   test_task_wire 在 ctest 里对合法负载做固定种子的随机变异，保证每次构建都跑一遍。
+//
+// 对任意输入检查：不越界读（配合 ASan）；读出的视图都落在输入内；没有错误时记录数等于 count；
+// 完整解码的负载重新编码后解码结果不变；经 TaskSyncReceiver 应用后模型的行数与索引自洽，
+// 未被应用的负载不改动模型。
+// 返回 false 表示某条不变量被破坏（不会提前退出）。
+bool FuzzTaskWireOnce(const uint8_t* data, size_t size);
@@ -0,0 +1,240 @@
+// 异步日志：输出行的格式与顺序、级别过滤、长消息旁路、Warn/Error 的重复抑制与 "repeated N more times"、
+// 按大小轮转的文件名链（path、path.1 … path.<maxFiles-1>），以及 Close 时报告丢弃与抑制的条数。
+// 环满丢弃的用例让日志写进没人读的 FIFO（POSIX），后台线程阻塞后丢弃是确定的；Windows 上跳过。
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "test_harness.h"
+#include "core/async_logger.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::vector<std::string> ReadLines(const std::string& path) {
+  std::vector<std::string> lines;
+  std::ifstream in(path, std::ios::binary);
+  for (std::string line; std::getline(in, line);) lines.push_back(line);
+  return lines;
+}
+
+bool FileExists(const std::string& path) {
+  return std::ifstream(path, std::ios::binary).good();
+}
+
+size_t FileSize(const std::string& path) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  return in ? (size_t)in.tellg() : 0;
+}
+
+// "YYYY-MM-DD HH:MM:SS.mmm [T] " 前缀（28 字节）之后的消息；格式不符时返回空并记失败
+std::string MessageOf(const std::string& line, char* tag = nullptr) {
+  const auto digit = [&](size_t i) { return i < line.size() && line[i] >= '0' && line[i] <= '9'; };
+  bool ok = line.size() >= 28;
+  for (size_t i : { 0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, 17, 18, 20, 21, 22 }) ok = ok && digit(i);
+  ok = ok && line[4] == '-' && line[7] == '-' && line[10] == ' ' && line[13] == ':' && line[16] == ':' &&
+       line[19] == '.' && line[23] == ' ' && line[24] == '[' && line[26] == ']' && line[27] == ' ';
+  if (!ok) {
+    ReportFailure(__FILE__, __LINE__, "malformed log line: " + line);
+    return std::string();
+  }
+  if (tag) *tag = line[25];
+  return line.substr(28);
+}
+
+AsyncLogger::Options OptionsFor(const std::string& path) {
+  AsyncLogger::Options options;
+  options.path = path;
+  return options;
+}
+
+} // namespace
+
+NFB_TEST(AsyncLogger, WritesFormattedLinesInOrder) {
+  const TestTempDir dir("logger_lines");
+  const std::string path = dir.File("ball.log");
+  AsyncLogger logger;
+  NFB_REQUIRE(logger.Open(OptionsFor(path)));
+  NFB_CHECK(logger.IsOpen());
+  NFB_CHECK(!logger.Log(LogLevel::Debug, "filtered")); // 默认最低级别 Info
+  NFB_CHECK(logger.Log(LogLevel::Info, "first"));
+  NFB_CHECK(logger.Log(LogLevel::Warn, "second"));
+  NFB_CHECK(logger.Log(LogLevel::Error, "third"));
+  logger.SetMinLevel(LogLevel::Debug);
+  NFB_CHECK(logger.Log(LogLevel::Debug, "fourth"));
+  const std::string longText(AsyncLogger::kSlotText * 3, 'L'); // 超过槽位长度：走旁路队列，原样写出
+  NFB_CHECK(logger.Log(LogLevel::Info, longText));
+  for (int i = 0; i < 100; ++i) logger.Log(LogLevel::Info, "n" + std::to_string(i));
+  logger.Flush();
+
+  // Flush 之后已经落盘，不必等 Close
+  const std::vector<std::string> lines = ReadLines(path);
+  NFB_REQUIRE(lines.size() == 105);
+  const char expectedTags[] = { 'I', 'W', 'E', 'D', 'I' };
+  const std::string expected[] = { "first", "second", "third", "fourth", longText };
+  for (size_t i = 0; i < 5; ++i) {
+    char tag = 0;
+    NFB_CHECK(MessageOf(lines[i], &tag) == expected[i]);
+    NFB_CHECK_EQ(tag, expectedTags[i]);
+  }
+  for (int i = 0; i < 100; ++i) NFB_CHECK(MessageOf(lines[5 + i]) == "n" + std::to_string(i));
+
+  // 没有丢弃或抑制时 Close 不追加汇总行；关闭后的记录被拒绝
+  logger.Close();
+  NFB_CHECK(!logger.IsOpen());
+  NFB_CHECK(!logger.Log(LogLevel::Error, "after close"));
+  NFB_CHECK_EQ(ReadLines(path).size(), 105u);
+
+  // 重新打开追加到同一个文件
+  NFB_REQUIRE(logger.Open(OptionsFor(path)));
+  logger.Log(LogLevel::Info, "reopened");
+  logger.Close();
+  const std::vector<std::string> after = ReadLines(path);
+  NFB_REQUIRE(after.size() == 106);
+  NFB_CHECK(MessageOf(after.back()) == "reopened");
+}
+
+NFB_TEST(AsyncLogger, RepeatedWarningsAreSuppressed) {
+  const TestTempDir dir("logger_repeat");
+  const std::string path = dir.File("ball.log");
+  AsyncLogger::Options options = OptionsFor(path);
+  options.repeatWindow = std::chrono::milliseconds(300);
+  {
+    AsyncLogger logger;
+    NFB_REQUIRE(logger.Open(options));
+    NFB_CHECK(logger.Log(LogLevel::Warn, "EndDraw failed"));
+    for (int i = 0; i < 4; ++i) NFB_CHECK(!logger.Log(LogLevel::Warn, "EndDraw failed"));
+    NFB_CHECK(logger.Log(LogLevel::Error, "other error")); // 不同消息不受影响
+    for (int i = 0; i < 3; ++i) NFB_CHECK(logger.Log(LogLevel::Info, "info repeats")); // Info 不抑制
+    NFB_CHECK_EQ(logger.Suppressed(), 4u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    NFB_CHECK(logger.Log(LogLevel::Warn, "EndDraw failed")); // 窗口过后：附带省略次数
+    NFB_CHECK(!logger.Log(LogLevel::Warn, "EndDraw failed")); // 新窗口重新开始抑制
+  } // 析构即 Close
+
+  const std::vector<std::string> lines = ReadLines(path);
+  NFB_REQUIRE(lines.size() == 7);
+  NFB_CHECK(MessageOf(lines[0]) == "EndDraw failed");
+  NFB_CHECK(MessageOf(lines[1]) == "other error");
+  for (size_t i = 2; i < 5; ++i) NFB_CHECK(MessageOf(lines[i]) == "info repeats");
+  NFB_CHECK(MessageOf(lines[5]) == "EndDraw failed (repeated 4 more times)");
+  char tag = 0;
+  NFB_CHECK(MessageOf(lines[6], &tag) == "logger closed: 0 dropped, 5 repeats suppressed");
+  NFB_CHECK_EQ(tag, 'I');
+}
+
+NFB_TEST(AsyncLogger, RotatesThroughNumberedFiles) {
+  const TestTempDir dir("logger_rotate");
+  const std::string path = dir.File("ball.log");
+  AsyncLogger::Options options = OptionsFor(path);
+  options.maxFileBytes = 1000;
+  options.maxFiles = 3;
+  AsyncLogger logger;
+  NFB_REQUIRE(logger.Open(options));
+  // 每行 28 字节前缀 + 72 字节消息 + 换行 = 101 字节：每个文件 9 行
+  for (int i = 0; i < 40; ++i) {
+    char message[80];
+    std::snprintf(message, sizeof(message), "line %04d %s", i, std::string(62, 'x').c_str());
+    logger.Log(LogLevel::Info, message);
+  }
+  logger.Close();
+
+  NFB_CHECK(FileExists(path));
+  NFB_CHECK(FileExists(path + ".1"));
+  NFB_CHECK(FileExists(path + ".2"));
+  NFB_CHECK(!FileExists(path + ".3"));
+  for (const std::string& p : { path, path + ".1", path + ".2" }) NFB_CHECK(FileSize(p) <= options.maxFileBytes);
+
+  // 由旧到新：path.2、path.1、path，行号连续并止于最后一行；当前文件以最新记录结尾
+  std::vector<std::string> all;
+  for (const std::string& p : { path + ".2", path + ".1", path }) {
+    const std::vector<std::string> lines = ReadLines(p);
+    NFB_CHECK_EQ(lines.size(), p == path ? 4u : 9u);
+    all.insert(all.end(), lines.begin(), lines.end());
+  }
+  NFB_REQUIRE(all.size() == 22);
+  for (size_t i = 0; i < all.size(); ++i) {
+    char expected[16];
+    std::snprintf(expected, sizeof(expected), "line %04d ", (int)(18 + i));
+    NFB_CHECK(MessageOf(all[i]).compare(0, 10, expected) == 0);
+  }
+
+  // 打开时已超过上限的文件（例如上次进程之外追加过的）先轮转，再写入
+  std::ofstream(path, std::ios::binary | std::ios::app) << std::string(800, 'z') << '\n';
+  NFB_REQUIRE(logger.Open(options));
+  NFB_CHECK_EQ(FileSize(path), 0u);
+  logger.Close();
+  NFB_CHECK_EQ(ReadLines(path + ".1").size(), 5u);
+  NFB_CHECK_EQ(ReadLines(path + ".2").size(), 9u);
+
+  // maxFiles = 1：不保留历史文件，只截断
+  const std::string single = dir.File("single.log");
+  options.path = single;
+  options.maxFiles = 1;
+  NFB_REQUIRE(logger.Open(options));
+  for (int i = 0; i < 30; ++i) logger.Log(LogLevel::Info, std::string(72, 'y'));
+  logger.Close();
+  NFB_CHECK(FileSize(single) <= options.maxFileBytes);
+  NFB_CHECK(!FileExists(single + ".1"));
+}
+
+#ifndef _WIN32
+
+NFB_TEST(AsyncLogger, DroppedRecordsReportedOnClose) {
+  // 日志写进 FIFO，先不读：管道缓冲写满后后台线程阻塞在写文件上，环形缓冲随后写满，之后的记录必然被丢弃。
+  const TestTempDir dir("logger_drop");
+  const std::string path = dir.File("ball.fifo");
+  NFB_REQUIRE(mkfifo(path.c_str(), 0600) == 0);
+  const int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK); // 有读端时写端的 open 不阻塞
+  NFB_REQUIRE(fd >= 0);
+
+  constexpr int kRecords = 5000;
+  AsyncLogger logger;
+  if (!logger.Open(OptionsFor(path))) {
+    close(fd);
+    NFB_REQUIRE(false);
+  }
+  const std::string pad(150, 'p');
+  int accepted = 0;
+  for (int i = 0; i < kRecords; ++i) accepted += logger.Log(LogLevel::Info, "record " + std::to_string(i) + " " + pad);
+  const uint64_t dropped = logger.Dropped();
+  NFB_CHECK(dropped > 0);
+  NFB_CHECK_EQ((uint64_t)accepted + dropped, (uint64_t)kRecords);
+
+  // 开始读，Close 写完剩余记录与汇总行后关闭写端，读端随之读到 EOF
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+  std::string text;
+  std::thread reader([&] {
+    char buf[65536];
+    for (ssize_t n; (n = read(fd, buf, sizeof(buf))) > 0;) text.append(buf, (size_t)n);
+  });
+  logger.Close();
+  reader.join();
+  close(fd);
+
+  std::vector<std::string> lines;
+  std::istringstream in(text);
+  for (std::string line; std::getline(in, line);) lines.push_back(line);
+  NFB_REQUIRE(!lines.empty());
+  NFB_CHECK_EQ(lines.size(), (size_t)accepted + 1);
+  NFB_CHECK(MessageOf(lines.back()) == "logger closed: " + std::to_string(dropped) + " dropped, 0 repeats suppressed");
+  // 写出的记录保持入队顺序
+  long previous = -1;
+  bool ordered = true;
+  for (size_t i = 0; i + 1 < lines.size(); ++i) {
+    const long n = std::stol(MessageOf(lines[i]).substr(7));
+    ordered = ordered && n > previous;
+    previous = n;
+  }
+  NFB_CHECK(ordered);
+}
+
+#endif // !_WIN32
@@ -0,0 +1,140 @@
+// 悬浮球 → 主程序消息：OPEN_TASK 编解码、畸形负载、批次合并
+#include <random>
+#include <string>
+#include <vector>
+#include "test_harness.h"
+#include "core/ball_ipc.h"
+
+namespace {
+
+bool Decode(std::u16string_view payload, BallIpcEvent* out, uintptr_t dwData = kBallIpcOpenTask) {
+  const std::u16string copy(payload); // 对齐的独立缓冲
+  return DecodeBallIpc(dwData, copy.data(), copy.size() * sizeof(char16_t), out);
+}
+
+BallIpcEvent Open(std::u16string id) {
+  BallIpcEvent event;
+  event.kind = BallIpcKind::OpenTask;
+  event.taskId = std::move(id);
+  return event;
+}
+
+BallIpcEvent Restore() { return BallIpcEvent{}; }
+
+} // namespace
+
+NFB_TEST(BallIpc, OpenTaskRoundTrip) {
+  const std::u16string ids[] = {
+    u"42", u"-7", u"007", u"abc", u"with \"quotes\"", u"back\\slash", u"ctl\x01\x1f\n\t", u"中文任务",
+    u"\xD83D\xDE00 emoji", u"-", u"1e5", u"/slash/",
+  };
+  for (const std::u16string& id : ids) {
+    const std::u16string payload = EncodeOpenTask(id);
+    NFB_CHECK(!payload.empty() && payload.back() == u'\0');
+    BallIpcEvent event;
+    NFB_REQUIRE(Decode(payload, &event));
+    NFB_CHECK_EQ(event.kind, BallIpcKind::OpenTask);
+    NFB_CHECK(event.taskId == id);
+  }
+}
+
+NFB_TEST(BallIpc, NumericIdsStayBare) {
+  NFB_CHECK(EncodeOpenTask(u"42") == std::u16string(u"{\"action\":\"open_task\",\"taskId\":42}") + u'\0');
+  NFB_CHECK(EncodeOpenTask(u"4a") == std::u16string(u"{\"action\":\"open_task\",\"taskId\":\"4a\"}") + u'\0');
+}
+
+NFB_TEST(BallIpc, AcceptsHandWrittenJson) {
+  BallIpcEvent event;
+  NFB_CHECK(Decode(u" { \"taskId\" : 17 , \"action\" : \"open_task\" } ", &event) && event.taskId == u"17");
+  // 没有 action 字段的旧发送端
+  NFB_CHECK(Decode(u"{\"taskId\":\"x\"}", &event) && event.taskId == u"x");
+  NFB_CHECK(Decode(u"{\"extra\":true,\"taskId\":\"\\u0041\\/b\"}", &event) && event.taskId == u"A/b");
+  // 不带结尾 NUL，或带多个 NUL
+  NFB_CHECK(Decode(std::u16string(u"{\"taskId\":5}") + u'\0' + u'\0', &event) && event.taskId == u"5");
+}
+
+NFB_TEST(BallIpc, RejectsMalformed) {
+  BallIpcEvent event;
+  const std::u16string bad[] = {
+    u"",
+    u"not json",
+    u"{}",
+    u"{\"action\":\"close\",\"taskId\":1}",
+    u"{\"taskId\":null}",
+    u"{\"taskId\":\"\"}",
+    u"{\"taskId\":}",
+    u"{\"taskId\"",
+    u"{\"taskId\":\"unterminated",
+    u"{\"taskId\":\"bad escape \\u12\"}",
+    u"{\"taskId\":\"\\u12G4\"}",
+    u"{\"taskId\":\"trailing backslash\\",
+    u"{\"a\":1 \"taskId\":2}",
+    u"[\"taskId\",1]",
+  };
+  for (const std::u16string& payload : bad) NFB_CHECK(!Decode(payload, &event));
+
+  const std::u16string good = EncodeOpenTask(u"1");
+  NFB_CHECK(!DecodeBallIpc(kBallIpcOpenTask, nullptr, 8, &event));
+  NFB_CHECK(!DecodeBallIpc(kBallIpcOpenTask, good.data(), 1, &event));
+  NFB_CHECK(!DecodeBallIpc(99, good.data(), good.size() * 2, &event));
+  NFB_CHECK(!DecodeBallIpc(kBallIpcMemoryReport, good.data(), good.size() * 2, &event));
+  // 奇数地址无法按 UTF-16 读取
+  std::vector<uint8_t> shifted(good.size() * 2 + 2);
+  NFB_CHECK(!DecodeBallIpc(kBallIpcOpenTask, shifted.data() + 1, good.size() * 2, &event));
+}
+
+NFB_TEST(BallIpc, RestoreMainIgnoresPayload) {
+  BallIpcEvent event = Open(u"stale");
+  NFB_CHECK(DecodeBallIpc(kBallIpcRestoreMain, nullptr, 0, &event));
+  NFB_CHECK_EQ(event.kind, BallIpcKind::RestoreMain);
+  NFB_CHECK(event.taskId.empty());
+}
+
+NFB_TEST(BallIpc, TruncationsAndGarbageDoNotOverrun) {
+  // 每个前缀都放进恰好大小的缓冲：越界读会被 ASan 报告
+  const std::u16string good = EncodeOpenTask(u"with \"quotes\" \x01");
+  for (size_t len = 1; len < good.size(); ++len) {
+    std::vector<char16_t> cut(good.begin(), good.begin() + len);
+    BallIpcEvent event;
+    DecodeBallIpc(kBallIpcOpenTask, cut.data(), len * sizeof(char16_t), &event);
+  }
+  std::mt19937 rng(7);
+  const char16_t alphabet[] = u"{}\":,\\u0aF taskId-\x00";
+  for (int iteration = 0; iteration < 20000; ++iteration) {
+    std::vector<char16_t> bytes(1 + rng() % 40);
+    for (char16_t& c : bytes) c = alphabet[rng() % (sizeof(alphabet) / sizeof(alphabet[0]) - 1)];
+    BallIpcEvent event;
+    if (DecodeBallIpc(kBallIpcOpenTask, bytes.data(), bytes.size() * sizeof(char16_t), &event)) {
+      NFB_CHECK(!event.taskId.empty() && event.taskId != u"null");
+    }
+  }
+}
+
+NFB_TEST(BallIpc, BatchCoalescesDuplicates) {
+  BallIpcBatch batch;
+  NFB_CHECK(batch.Push(Restore()));
+  NFB_CHECK(!batch.Push(Open(u"1")));
+  NFB_CHECK(!batch.Push(Restore()));
+  NFB_CHECK(!batch.Push(Open(u"1")));
+  NFB_CHECK(!batch.Push(Open(u"2")));
+  NFB_CHECK_EQ(batch.Size(), 3u);
+  const std::vector<BallIpcEvent>& taken = batch.Take();
+  NFB_REQUIRE(taken.size() == 3);
+  NFB_CHECK_EQ(taken[0].kind, BallIpcKind::RestoreMain);
+  NFB_CHECK(taken[1].taskId == u"1");
+  NFB_CHECK(taken[2].taskId == u"2");
+  NFB_CHECK(batch.Empty());
+  // 新的一批：第一条再次要求调度刷新
+  NFB_CHECK(batch.Push(Open(u"1")));
+}
+
+NFB_TEST(BallIpc, BatchDropsOldestWhenFull) {
+  BallIpcBatch batch(3);
+  for (int i = 0; i < 5; ++i) batch.Push(Open(std::u16string(1, (char16_t)(u'a' + i))));
+  NFB_CHECK_EQ(batch.Size(), 3u);
+  NFB_CHECK_EQ(batch.Dropped(), 2u);
+  const std::vector<BallIpcEvent>& taken = batch.Take();
+  NFB_REQUIRE(taken.size() == 3);
+  NFB_CHECK(taken[0].taskId == u"c");
+  NFB_CHECK(taken[2].taskId == u"e");
+}
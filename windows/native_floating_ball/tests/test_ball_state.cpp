@@ -0,0 +1,120 @@
+// 悬浮球状态机的悬停与气泡显隐：只在悬停状态变化时产生副作用，离开后延迟隐藏，
+// 回到球上取消隐藏而不重新 Show；气泡显示时任务变化只刷新受影响的行。
+#include <random>
+#include "test_harness.h"
+#include "core/ball_state.h"
+
+namespace {
+
+TaskListDiff Updated(size_t n) {
+  TaskListDiff diff;
+  diff.updated = n;
+  return diff;
+}
+
+} // namespace
+
+NFB_TEST(BallState, FirstMoveShowsBubbleOnce) {
+  BallState state;
+  state.Start();
+  NFB_CHECK(!state.Hovered() && !state.BubbleShown());
+  NFB_CHECK_EQ(state.OnMouseMove(false), (uint32_t)kBallEffectShowBubble);
+  NFB_CHECK(state.Hovered() && state.BubbleShown());
+  // 同一次悬停里的后续移动没有任何副作用
+  for (int i = 0; i < 100; ++i) NFB_CHECK_EQ(state.OnMouseMove(true), 0u);
+}
+
+NFB_TEST(BallState, LeaveThenHideAfterDelay) {
+  BallState state;
+  state.Start();
+  state.OnMouseMove(false);
+  NFB_CHECK_EQ(state.OnMouseLeave(), (uint32_t)kBallEffectStartHideTimer);
+  NFB_CHECK(!state.Hovered());
+  NFB_CHECK(state.BubbleShown()); // 不立即隐藏
+  // 光标移进了气泡：轮询继续，什么都不做
+  NFB_CHECK_EQ(state.OnHideTimer(true), 0u);
+  NFB_CHECK(state.BubbleShown());
+  NFB_CHECK_EQ(state.OnHideTimer(false), (uint32_t)kBallEffectHideBubble);
+  NFB_CHECK(!state.BubbleShown());
+  // 隐藏之后再悬停：重新显示
+  NFB_CHECK_EQ(state.OnMouseMove(false), (uint32_t)kBallEffectShowBubble);
+}
+
+NFB_TEST(BallState, ReturningWhileBubbleVisibleOnlyCancelsHide) {
+  BallState state;
+  state.Start();
+  state.OnMouseMove(false);
+  state.OnMouseLeave();
+  // 气泡还在：只停止隐藏轮询，不重新 Show（不重设位置、不重启显示动画）
+  NFB_CHECK_EQ(state.OnMouseMove(true), (uint32_t)kBallEffectStopHideTimer);
+  NFB_CHECK(state.Hovered() && state.BubbleShown());
+  NFB_CHECK_EQ(state.OnMouseMove(true), 0u);
+}
+
+NFB_TEST(BallState, BubbleGoneOutsideStateMachineIsShownAgain) {
+  // 点击条目或隐藏动画让气泡在状态机之外消失：仍在悬停时的下一次移动要重新显示
+  BallState state;
+  state.Start();
+  state.OnMouseMove(false);
+  NFB_CHECK_EQ(state.OnMouseMove(false), (uint32_t)kBallEffectShowBubble);
+  NFB_CHECK_EQ(state.OnMouseMove(true), 0u);
+}
+
+NFB_TEST(BallState, TaskChangesRefreshOnlyVisibleBubble) {
+  BallState state;
+  state.Start();
+  NFB_CHECK(state.QueueTasksChanged(Updated(1), 0));
+  NFB_CHECK((state.FlushTasksChanged() & kBallEffectRefreshBubble) == 0); // 气泡未显示
+
+  state.OnMouseMove(false);
+  NFB_CHECK(state.QueueTasksChanged(Updated(1), 0));
+  NFB_CHECK(!state.QueueTasksChanged(Updated(2), 0)); // 同一批只安排一次刷新
+  NFB_CHECK(state.TasksChangedPending());
+  NFB_CHECK((state.FlushTasksChanged() & kBallEffectRefreshBubble) != 0);
+  NFB_CHECK(!state.TasksChangedPending());
+  // 空的变化（例如只带未读数的结果）不刷新气泡
+  state.QueueTasksChanged(TaskListDiff{}, 0);
+  NFB_CHECK((state.FlushTasksChanged() & kBallEffectRefreshBubble) == 0);
+
+  state.OnMouseLeave();
+  state.OnHideTimer(false);
+  state.QueueTasksChanged(Updated(1), 0);
+  NFB_CHECK((state.FlushTasksChanged() & kBallEffectRefreshBubble) == 0);
+}
+
+NFB_TEST(BallState, RandomHoverSequencesNeverRepeatShow) {
+  // 随机的移动/离开/隐藏轮询序列：ShowBubble 只在“气泡不可见”时出现，
+  // 同一个输入不会同时要求显示和隐藏，Hide 之后 BubbleShown 为 false
+  std::mt19937 rng(11);
+  for (int run = 0; run < 50; ++run) {
+    BallState state;
+    state.Start();
+    bool visible = false; // 模拟窗口：气泡实际是否可见
+    for (int step = 0; step < 500; ++step) {
+      uint32_t effects = 0;
+      const uint32_t input = rng() % 10;
+      if (input < 6) {
+        const bool wasHovered = state.Hovered();
+        effects = state.OnMouseMove(visible);
+        if (visible && wasHovered) NFB_CHECK_EQ(effects, 0u);
+        NFB_CHECK_EQ((effects & kBallEffectShowBubble) != 0, !visible);
+        NFB_CHECK(state.Hovered());
+      } else if (input < 8) {
+        effects = state.OnMouseLeave();
+        NFB_CHECK_EQ(effects, (uint32_t)kBallEffectStartHideTimer);
+        NFB_CHECK(!state.Hovered());
+      } else if (input < 9) {
+        effects = state.OnHideTimer(rng() % 2 == 0);
+      } else {
+        visible = false; // 气泡在状态机之外消失（点击条目）
+      }
+      NFB_CHECK(!((effects & kBallEffectShowBubble) && (effects & kBallEffectHideBubble)));
+      if (effects & kBallEffectShowBubble) visible = true;
+      if (effects & kBallEffectHideBubble) {
+        visible = false;
+        NFB_CHECK(!state.BubbleShown());
+      }
+      if (visible) NFB_CHECK(state.BubbleShown());
+    }
+  }
+}
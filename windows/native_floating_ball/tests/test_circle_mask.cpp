@@ -0,0 +1,208 @@
+// 圆形蒙版：覆盖率的对称性、行区间与覆盖率一致、Apply / Fill 与逐像素公式一致、与高倍超采样的参考相差有界；
+// 以及用仓库自带 unread_logo.gif 构建的显示尺寸帧满足的不变量（圆外全零、alpha 等于覆盖率、命中区域按覆盖率阈值）。
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include "test_harness.h"
+#include "core/circle_mask.h"
+#include "core/display_frames.h"
+
+namespace {
+
+const uint32_t kDiameters[] = { 3, 4, 5, 6, 7, 8, 11, 16, 17, 31, 32, 47, 48, 63, 64, 96, 120, 121 };
+
+// round(v * a / 255)，不用蒙版里的移位近似
+uint8_t Scale255(uint32_t v, uint32_t a) {
+  return (uint8_t)((2 * v * a + 255) / 510);
+}
+
+// 64x64 超采样的覆盖率（与蒙版同一圆心、半径）
+double ReferenceCoverage(uint32_t diameter, uint32_t x, uint32_t y) {
+  constexpr int kFine = 64;
+  const double c = diameter / 2.0, r = (diameter - 2.0) / 2.0;
+  int inside = 0;
+  for (int sy = 0; sy < kFine; ++sy) {
+    const double py = y + (sy + 0.5) / kFine - c;
+    for (int sx = 0; sx < kFine; ++sx) {
+      const double px = x + (sx + 0.5) / kFine - c;
+      if (px * px + py * py <= r * r) ++inside;
+    }
+  }
+  return inside * 255.0 / (kFine * kFine);
+}
+
+} // namespace
+
+NFB_TEST(CircleMask, CoverageIsSymmetric) {
+  for (uint32_t d : kDiameters) {
+    CircleMask mask;
+    mask.Build(d);
+    NFB_REQUIRE(mask.Diameter() == d);
+    for (uint32_t y = 0; y < d; ++y) {
+      for (uint32_t x = 0; x < d; ++x) {
+        const uint8_t c = mask.Coverage(x, y);
+        NFB_CHECK_EQ(c, mask.Coverage(d - 1 - x, y));
+        NFB_CHECK_EQ(c, mask.Coverage(x, d - 1 - y));
+        NFB_CHECK_EQ(c, mask.Coverage(y, x));
+      }
+    }
+    // 四周 1px 透明边；中心像素完全覆盖
+    for (uint32_t i = 0; i < d; ++i) {
+      NFB_CHECK_EQ(mask.Coverage(i, 0), 0);
+      NFB_CHECK_EQ(mask.Coverage(0, i), 0);
+      NFB_CHECK_EQ(mask.Coverage(i, d - 1), 0);
+      NFB_CHECK_EQ(mask.Coverage(d - 1, i), 0);
+    }
+    if (d >= 6) NFB_CHECK_EQ(mask.Coverage(d / 2, d / 2), 255);
+  }
+}
+
+NFB_TEST(CircleMask, RowSpansMatchCoverage) {
+  for (uint32_t d : kDiameters) {
+    CircleMask mask;
+    mask.Build(d);
+    for (uint32_t y = 0; y < d; ++y) {
+      const CircleMask::Span& span = mask.RowSpan(y);
+      NFB_CHECK(span.first <= span.last && span.last <= d);
+      NFB_CHECK(span.first <= span.solidFirst && span.solidFirst <= span.solidLast && span.solidLast <= span.last);
+      if (span.first < span.last) {
+        NFB_CHECK(mask.Coverage(span.first, y) != 0);
+        NFB_CHECK(mask.Coverage(span.last - 1u, y) != 0);
+      }
+      for (uint32_t x = 0; x < d; ++x) {
+        const uint8_t c = mask.Coverage(x, y);
+        const bool inSpan = x >= span.first && x < span.last;
+        const bool inSolid = x >= span.solidFirst && x < span.solidLast;
+        if (!inSpan) NFB_CHECK_EQ(c, 0);
+        // 圆是凸的：区间内没有空洞，255 的像素恰好是实心区间
+        if (inSpan) NFB_CHECK(c != 0);
+        NFB_CHECK_EQ(c == 255, inSolid);
+      }
+    }
+  }
+}
+
+NFB_TEST(CircleMask, CloseToSupersampledReference) {
+  // 16x16 与 64x64 超采样的差来自边缘像素里不足一格的子样本；整体面积与 πr² 一致
+  for (uint32_t d : { 3u, 5u, 8u, 17u, 32u, 47u, 64u }) {
+    CircleMask mask;
+    mask.Build(d);
+    double maxError = 0, area = 0;
+    for (uint32_t y = 0; y < d; ++y) {
+      for (uint32_t x = 0; x < d; ++x) {
+        const double error = std::fabs(mask.Coverage(x, y) - ReferenceCoverage(d, x, y));
+        maxError = (std::max)(maxError, error);
+        area += mask.Coverage(x, y) / 255.0;
+      }
+    }
+    if (maxError > 8.0) ReportFailure(__FILE__, __LINE__, "d=" + std::to_string(d) + " max error " + std::to_string(maxError));
+    const double r = (d - 2.0) / 2.0;
+    const double expected = 3.14159265358979 * r * r;
+    if (std::fabs(area - expected) > 0.01 * expected + 0.5) {
+      ReportFailure(__FILE__, __LINE__, "d=" + std::to_string(d) + " area " + std::to_string(area));
+    }
+  }
+}
+
+NFB_TEST(CircleMask, ApplyMultipliesEveryChannelByCoverage) {
+  std::mt19937 rng(3);
+  for (uint32_t d : kDiameters) {
+    CircleMask mask;
+    mask.Build(d);
+    // 行距带 12 字节的填充：填充不应被改动
+    const size_t stride = (size_t)d * 4 + 12;
+    std::vector<uint8_t> frame(stride * d);
+    for (size_t i = 0; i < frame.size(); i += 4) {
+      const uint8_t a = (uint8_t)rng();
+      frame[i + 3] = a;
+      for (int k = 0; k < 3; ++k) frame[i + k] = a ? (uint8_t)(rng() % (a + 1u)) : 0; // 合法的预乘像素
+    }
+    const std::vector<uint8_t> original = frame;
+    mask.Apply(frame.data(), stride);
+    for (uint32_t y = 0; y < d; ++y) {
+      for (uint32_t x = 0; x < d; ++x) {
+        const size_t at = y * stride + (size_t)x * 4;
+        for (int k = 0; k < 4; ++k) NFB_CHECK_EQ(frame[at + k], Scale255(original[at + k], mask.Coverage(x, y)));
+      }
+      for (size_t pad = (size_t)d * 4; pad < stride; ++pad) NFB_CHECK_EQ(frame[y * stride + pad], original[y * stride + pad]);
+    }
+  }
+}
+
+NFB_TEST(CircleMask, FillPremultipliesColorAndCoverage) {
+  const uint32_t colors[] = { 0xFF4169E1u, 0x80FFFFFFu, 0x00FF0000u, 0xFF000000u, 0x7F123456u };
+  for (uint32_t d : { 5u, 32u, 121u }) {
+    CircleMask mask;
+    mask.Build(d);
+    for (uint32_t argb : colors) {
+      std::vector<uint8_t> frame((size_t)d * d * 4, 0xAA);
+      mask.Fill(argb, frame.data(), (size_t)d * 4);
+      const uint32_t a = argb >> 24;
+      const uint8_t premul[4] = { Scale255(argb & 0xFF, a), Scale255((argb >> 8) & 0xFF, a),
+                                  Scale255((argb >> 16) & 0xFF, a), (uint8_t)a };
+      for (uint32_t y = 0; y < d; ++y) {
+        for (uint32_t x = 0; x < d; ++x) {
+          const uint8_t* p = &frame[((size_t)y * d + x) * 4];
+          for (int k = 0; k < 4; ++k) NFB_CHECK_EQ(p[k], Scale255(premul[k], mask.Coverage(x, y)));
+        }
+      }
+    }
+  }
+}
+
+NFB_TEST(CircleMask, TinyDiametersAreEmpty) {
+  for (uint32_t d : { 0u, 1u, 2u }) {
+    CircleMask mask;
+    mask.Build(d);
+    NFB_CHECK_EQ(mask.Diameter(), d);
+    std::vector<uint8_t> frame((size_t)d * d * 4 + 1, 0xFF);
+    mask.Apply(frame.data(), (size_t)d * 4);
+    for (size_t i = 0; i < (size_t)d * d * 4; ++i) NFB_CHECK_EQ(frame[i], 0);
+    NFB_CHECK_EQ(frame.back(), 0xFF);
+    for (uint32_t y = 0; y < d; ++y) NFB_CHECK(mask.RowSpan(y).first == mask.RowSpan(y).last);
+  }
+}
+
+NFB_TEST(CircleMask, DisplayFramesFromUnreadLogo) {
+  // unread_logo.gif 每帧都不透明：乘上蒙版后 alpha 恰好等于覆盖率，
+  // 命中区域就是覆盖率不低于 kDefaultMinAlpha 的像素
+  const std::string path = std::string(NFB_ASSET_DIR) + "/unread_logo.gif";
+  std::ifstream in(path, std::ios::binary);
+  NFB_REQUIRE(in.good());
+  const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  constexpr uint32_t kDiameter = 120;
+  CircleMask mask;
+  mask.Build(kDiameter);
+  DisplayFrames frames;
+  NFB_REQUIRE(frames.Build(bytes.data(), bytes.size(), mask));
+  NFB_CHECK_EQ(frames.Diameter(), kDiameter);
+  NFB_CHECK_EQ(frames.FrameCount(), 61u);
+  NFB_CHECK_EQ(frames.DelaysMs().size(), 61u);
+  NFB_CHECK_EQ(frames.SourceWidth(), 976u);
+  NFB_CHECK_EQ(frames.SourceHeight(), 720u);
+  NFB_CHECK_EQ(frames.FrameBytes(), (size_t)kDiameter * kDiameter * 4);
+  NFB_CHECK(frames.Bytes() >= frames.FrameCount() * frames.FrameBytes());
+
+  for (size_t f = 0; f < frames.FrameCount(); ++f) {
+    const uint8_t* frame = frames.Frame(f);
+    size_t bad = 0;
+    for (uint32_t y = 0; y < kDiameter; ++y) {
+      for (uint32_t x = 0; x < kDiameter; ++x) {
+        const uint8_t* p = frame + ((size_t)y * kDiameter + x) * 4;
+        const uint8_t c = mask.Coverage(x, y);
+        if (p[3] != c || p[0] > p[3] || p[1] > p[3] || p[2] > p[3]) ++bad;
+      }
+    }
+    if (bad) ReportFailure(__FILE__, __LINE__, "frame " + std::to_string(f) + ": " + std::to_string(bad) + " pixels");
+  }
+  const HitMask& hit = frames.Hit();
+  NFB_CHECK_EQ(hit.Width(), kDiameter);
+  NFB_CHECK_EQ(hit.Height(), kDiameter);
+  for (uint32_t y = 0; y < kDiameter; ++y) {
+    for (uint32_t x = 0; x < kDiameter; ++x) NFB_CHECK_EQ(hit.Contains((int)x, (int)y), mask.Coverage(x, y) >= HitMask::kDefaultMinAlpha);
+  }
+}
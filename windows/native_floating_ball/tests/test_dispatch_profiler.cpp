@@ -0,0 +1,153 @@
+// 消息分发剖析：消息名（已收录 / WM_USER+n / WM_APP+n / registered / 十六进制）、每类消息的次数与耗时分位、
+// 报告表格按累计耗时降序且 (other) 在末尾、表满后的兜底、Reset 与 Scope。
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "test_harness.h"
+#include "core/dispatch_profiler.h"
+
+namespace {
+
+struct ReportRow {
+  std::string name;
+  unsigned long long count{0};
+  double avgUs{0}, p50Us{0}, p99Us{0}, maxUs{0}, totalMs{0};
+};
+
+// 解析 Format() 的表格；消息名可能含空格（"registered 0xC123"），数值列固定为最后 6 列
+std::vector<ReportRow> ParseReport(const std::string& text) {
+  std::vector<ReportRow> rows;
+  std::istringstream in(text);
+  std::string line;
+  std::getline(in, line); // 表头
+  while (std::getline(in, line)) {
+    std::vector<std::string> fields;
+    std::istringstream words(line);
+    for (std::string w; words >> w;) fields.push_back(w);
+    if (fields.size() < 7) continue;
+    ReportRow row;
+    for (size_t i = 0; i + 6 < fields.size(); ++i) row.name += (i ? " " : "") + fields[i];
+    const size_t n = fields.size();
+    row.count = std::stoull(fields[n - 6]);
+    row.avgUs = std::stod(fields[n - 5]);
+    row.p50Us = std::stod(fields[n - 4]);
+    row.p99Us = std::stod(fields[n - 3]);
+    row.maxUs = std::stod(fields[n - 2]);
+    row.totalMs = std::stod(fields[n - 1]);
+    rows.push_back(row);
+  }
+  return rows;
+}
+
+const ReportRow* RowNamed(const std::vector<ReportRow>& rows, const std::string& name) {
+  for (const ReportRow& row : rows) {
+    if (row.name == name) return &row;
+  }
+  return nullptr;
+}
+
+} // namespace
+
+NFB_TEST(DispatchProfiler, MessageNames) {
+  NFB_CHECK(std::strcmp(WindowMessageName(0x000F), "WM_PAINT") == 0);
+  NFB_CHECK(std::strcmp(WindowMessageName(0x004A), "WM_COPYDATA") == 0);
+  NFB_CHECK(std::strcmp(WindowMessageName(0x02E0), "WM_DPICHANGED") == 0);
+  NFB_CHECK(WindowMessageName(0x0400) == nullptr);
+  NFB_CHECK(WindowMessageName(0xC000) == nullptr);
+
+  DispatchProfiler profiler;
+  const uint32_t messages[] = { 0x000F, 0x0400, 0x0405, 0x7FFF, 0x8000, 0x8003, 0xBFFF, 0xC000, 0xC123, 0xFFFF, 0x0099 };
+  for (uint32_t m : messages) profiler.Record(m, 1000);
+  const std::vector<ReportRow> rows = ParseReport(profiler.Format());
+  NFB_CHECK_EQ(rows.size(), sizeof(messages) / sizeof(messages[0]));
+  const char* expected[] = {
+    "WM_PAINT", "WM_USER+0", "WM_USER+5", "WM_USER+31743", "WM_APP+0", "WM_APP+3", "WM_APP+16383",
+    "registered 0xC000", "registered 0xC123", "registered 0xFFFF", "0x0099",
+  };
+  for (const char* name : expected) {
+    const ReportRow* row = RowNamed(rows, name);
+    NFB_CHECK(row != nullptr);
+    if (row) NFB_CHECK_EQ(row->count, 1ull);
+  }
+}
+
+NFB_TEST(DispatchProfiler, PerMessageStats) {
+  DispatchProfiler profiler;
+  // WM_TIMER：99 次 1µs + 1 次 1ms；WM_PAINT：10 次 200µs
+  for (int i = 0; i < 99; ++i) profiler.Record(0x0113, 1000);
+  profiler.Record(0x0113, 1000000);
+  for (int i = 0; i < 10; ++i) profiler.Record(0x000F, 200000);
+  NFB_CHECK_EQ(profiler.TotalCount(), 110u);
+
+  const DispatchProfiler::Entry* timer = profiler.Find(0x0113);
+  NFB_REQUIRE(timer != nullptr);
+  NFB_CHECK_EQ(timer->count, 100u);
+  NFB_CHECK_EQ(timer->totalNs, 99u * 1000u + 1000000u);
+  NFB_CHECK_EQ(timer->maxNs, 1000000u);
+  // 1000ns 落在 [512, 1024) 桶，分位取桶上界；最高分位取最大值
+  NFB_CHECK_EQ(timer->PercentileNs(0.50), 1024u);
+  NFB_CHECK_EQ(timer->PercentileNs(0.98), 1024u);
+  NFB_CHECK_EQ(timer->PercentileNs(1.0), 1000000u);
+  const DispatchProfiler::Entry* paint = profiler.Find(0x000F);
+  NFB_REQUIRE(paint != nullptr);
+  NFB_CHECK_EQ(paint->PercentileNs(0.5), 200000u); // 桶上界 262144 被最大值截断
+  NFB_CHECK(profiler.Find(0x0200) == nullptr);
+  NFB_CHECK_EQ(DispatchProfiler::Entry{}.PercentileNs(0.5), 0u);
+
+  // 表格：按累计耗时降序（WM_PAINT 2ms 在 WM_TIMER 1.099ms 之前）
+  const std::vector<ReportRow> rows = ParseReport(profiler.Format());
+  NFB_REQUIRE(rows.size() == 2);
+  NFB_CHECK(rows[0].name == "WM_PAINT");
+  NFB_CHECK(rows[1].name == "WM_TIMER");
+  NFB_CHECK_EQ(rows[1].count, 100ull);
+  NFB_CHECK_EQ(rows[1].avgUs, 11.0);  // (99 * 1 + 1000) / 100 = 10.99，保留一位
+  NFB_CHECK_EQ(rows[1].p50Us, 1.0);
+  NFB_CHECK_EQ(rows[1].maxUs, 1000.0);
+  NFB_CHECK_EQ(rows[1].totalMs, 1.10);
+  NFB_CHECK_EQ(rows[0].p99Us, 200.0);
+  NFB_CHECK_EQ(rows[0].totalMs, 2.0);
+
+  // 表头
+  NFB_CHECK(profiler.Format().compare(0, 7, "message") == 0);
+}
+
+NFB_TEST(DispatchProfiler, FullTableFallsBackToOther) {
+  DispatchProfiler profiler;
+  for (uint32_t i = 0; i < DispatchProfiler::kCapacity; ++i) profiler.Record(0xC000 + i, 100);
+  for (uint32_t i = 0; i < DispatchProfiler::kCapacity; ++i) NFB_CHECK(profiler.Find(0xC000 + i) != nullptr);
+  NFB_CHECK_EQ(profiler.Other().count, 0u);
+  // 已有的消息仍计入自己的行，新的消息计入 (other)
+  profiler.Record(0xC000, 100);
+  profiler.Record(0x0001, 5000000);
+  profiler.Record(0x0002, 5000000);
+  NFB_CHECK_EQ(profiler.Find(0xC000)->count, 2u);
+  NFB_CHECK(profiler.Find(0x0001) == nullptr);
+  NFB_CHECK_EQ(profiler.Other().count, 2u);
+  NFB_CHECK_EQ(profiler.TotalCount(), (uint64_t)DispatchProfiler::kCapacity + 3);
+
+  // (other) 即使累计耗时最多也排在最后
+  const std::vector<ReportRow> rows = ParseReport(profiler.Format());
+  NFB_REQUIRE(rows.size() == DispatchProfiler::kCapacity + 1);
+  NFB_CHECK(rows.back().name == "(other)");
+  NFB_CHECK_EQ(rows.back().count, 2ull);
+
+  profiler.Reset();
+  NFB_CHECK_EQ(profiler.TotalCount(), 0u);
+  NFB_CHECK_EQ(profiler.Other().count, 0u);
+  NFB_CHECK(profiler.Find(0xC000) == nullptr);
+  NFB_CHECK(ParseReport(profiler.Format()).empty());
+}
+
+NFB_TEST(DispatchProfiler, ScopeRecordsOnce) {
+  DispatchProfiler profiler;
+  {
+    DispatchProfiler::Scope scope(profiler, 0x004A);
+    NFB_CHECK_EQ(profiler.TotalCount(), 0u); // 析构时才记
+  }
+  const DispatchProfiler::Entry* entry = profiler.Find(0x004A);
+  NFB_REQUIRE(entry != nullptr);
+  NFB_CHECK_EQ(entry->count, 1u);
+  NFB_CHECK_EQ(entry->maxNs, entry->totalNs);
+}
@@ -0,0 +1,355 @@
+// 事件轨迹（.nfbt）：编码后逐字段读回（类型、时间、a/b、负载）、录制到文件再读回、大小上限后的丢弃、
+// 截断的轨迹读出完整部分后报告 Truncated、不是轨迹的文件（魔数 / 版本 / 文件头不对）被拒绝，
+// 以及同一条固定轨迹在无窗口悬浮球（bench/headless_ball）上回放，球与气泡的帧数每次都相同。
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "test_harness.h"
+#include "headless_ball.h"
+#include "core/event_trace.h"
+#include "core/task_wire.h"
+
+namespace {
+
+struct ExpectedEvent {
+  TraceEventKind kind;
+  uint64_t timeUs;
+  uint32_t a;
+  uint32_t b;
+  std::string payload;
+};
+
+bool Matches(const TraceEvent& e, const ExpectedEvent& x) {
+  return e.kind == x.kind && e.timeUs == x.timeUs && e.a == x.a && e.b == x.b && e.payloadSize == x.payload.size() &&
+         (x.payload.empty() ? e.payload == nullptr : std::memcmp(e.payload, x.payload.data(), x.payload.size()) == 0);
+}
+
+std::vector<ExpectedEvent> SampleEvents() {
+  return {
+    { TraceEventKind::CopyData, 0, 3, 0, std::string("snapshot\0payload", 16) },
+    { TraceEventKind::TasksFlush, 50, 0, 0, "" },
+    { TraceEventKind::MouseMove, 8000, 60, 61, "" },
+    { TraceEventKind::MouseMove, 8000, 0xFFFFFFFFu, 0x80000000u, "" }, // 同一时刻；最大的 varint
+    { TraceEventKind::FrameTimer, 1ull << 40, 0, 0, "" },             // 很长的间隔
+    { TraceEventKind::HideTimer, (1ull << 40) + 1, 1, 0, "" },
+    { TraceEventKind::SnapshotPublished, (1ull << 40) + 2, 0, 0, std::string(300, 'x') }, // 多字节长度
+    { TraceEventKind::DpiChanged, (1ull << 40) + 3, 144, 180, "" },
+    { TraceEventKind::DisplayChange, (1ull << 40) + 3, 0, 0, "" },
+    { TraceEventKind::MouseLeave, (1ull << 40) + 4, 0, 0, "" },
+  };
+}
+
+std::vector<uint8_t> Encode(const std::vector<ExpectedEvent>& events) {
+  EventTraceEncoder encoder;
+  for (const ExpectedEvent& e : events) {
+    encoder.Append(e.kind, e.timeUs, e.a, e.b, e.payload.empty() ? nullptr : e.payload.data(), e.payload.size());
+  }
+  return encoder.Data();
+}
+
+std::vector<uint8_t> ReadFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+std::u16string ToU16(const std::string& s) {
+  return std::u16string(s.begin(), s.end());
+}
+
+// 固定的 600ms 轨迹：GIF 帧定时器每 40ms；开头没有任务（未读 GIF 动画），150ms 时收到 12 条任务的快照；
+// 光标先落在透明角落（穿透），随后在球内移动约 200ms 展开气泡，其间收到两条增量；离开后 250ms 隐藏轮询收起气泡
+std::vector<uint8_t> MakeFixedTrace() {
+  EventTraceEncoder trace;
+  TaskWireWriter wire;
+  std::vector<std::u16string> ids, titles;
+  const auto item = [&](int i) {
+    ids.push_back(ToU16("task-" + std::to_string(i)));
+    titles.push_back(ToU16("Follow up on item " + std::to_string(i)));
+    TaskItemView view;
+    view.id = ids.back();
+    view.title = titles.back();
+    return view;
+  };
+  wire.Begin(TaskWireKind::Snapshot, 1);
+  const std::vector<uint8_t>& empty = wire.Finish();
+  trace.Append(TraceEventKind::CopyData, 0, (uint32_t)kTaskWireCopyDataId, 0, empty.data(), empty.size());
+  trace.Append(TraceEventKind::TasksFlush, 100);
+
+  for (uint64_t t = 1000; t <= 600000; t += 1000) {
+    if (t % 40000 == 0) trace.Append(TraceEventKind::FrameTimer, t);
+    if (t == 150000) {
+      wire.Begin(TaskWireKind::Snapshot, 2);
+      for (int i = 0; i < 12; ++i) wire.Add(item(i));
+      const std::vector<uint8_t>& snapshot = wire.Finish();
+      trace.Append(TraceEventKind::CopyData, t, (uint32_t)kTaskWireCopyDataId, 0, snapshot.data(), snapshot.size());
+      trace.Append(TraceEventKind::TasksFlush, t + 200);
+    }
+    if (t == 90000) trace.Append(TraceEventKind::MouseMove, t, 2, 2);
+    if (t >= 100000 && t <= 300000 && t % 8000 == 0) trace.Append(TraceEventKind::MouseMove, t, 60, 58 + (uint32_t)(t / 8000) % 5);
+    if (t == 180000 || t == 240000) {
+      wire.Begin(t == 180000 ? TaskWireKind::Add : TaskWireKind::Remove, t == 180000 ? 3 : 4);
+      wire.Add(t == 180000 ? item(12) : item(3));
+      const std::vector<uint8_t>& delta = wire.Finish();
+      trace.Append(TraceEventKind::CopyData, t, (uint32_t)kTaskWireCopyDataId, 0, delta.data(), delta.size());
+      trace.Append(TraceEventKind::TasksFlush, t + 200);
+    }
+    if (t == 320000) trace.Append(TraceEventKind::MouseLeave, t);
+    if (t == 570000) trace.Append(TraceEventKind::HideTimer, t, 0);
+  }
+  return trace.Data();
+}
+
+struct ReplayCounts {
+  uint64_t events{0};
+  uint64_t ballFrames{0};
+  uint64_t bubbleFrames{0};
+  uint64_t passedThrough{0};
+  size_t tasks{0};
+  bool truncated{false};
+
+  bool operator==(const ReplayCounts& o) const {
+    return events == o.events && ballFrames == o.ballFrames && bubbleFrames == o.bubbleFrames &&
+           passedThrough == o.passedThrough && tasks == o.tasks && truncated == o.truncated;
+  }
+};
+
+// 在 ball 上回放一遍并让轨迹末尾还在播的气泡动画播完（推进 1s 的 16ms 帧），返回这一遍增加的计数。
+// 不播完的话，收起动画余下的帧会记在同一个悬浮球的下一遍开头
+ReplayCounts ReplayOnce(HeadlessBall& ball, const std::vector<uint8_t>& trace, bool realtime) {
+  const uint64_t ballFrames = ball.BallFrames(), bubbleFrames = ball.BubbleFrames(), passed = ball.PassedThrough();
+  const ReplayResult result = ReplayTrace(trace.data(), trace.size(), ball, realtime, nullptr);
+  ball.AdvanceTo(ball.NowUs() + 1000000, nullptr);
+  ReplayCounts counts;
+  counts.events = result.events;
+  counts.ballFrames = ball.BallFrames() - ballFrames;
+  counts.bubbleFrames = ball.BubbleFrames() - bubbleFrames;
+  counts.passedThrough = ball.PassedThrough() - passed;
+  counts.tasks = ball.TaskCount();
+  counts.truncated = result.truncated;
+  return counts;
+}
+
+// 新的悬浮球回放一遍。assetDir 为空时不加载 GIF（纯色圆，解码大 GIF 在未优化构建里要一秒多）
+ReplayCounts Replay(const std::vector<uint8_t>& trace, bool realtime, const std::string& assetDir) {
+  HeadlessBall ball;
+  ball.LoadAssets(assetDir);
+  return ReplayOnce(ball, trace, realtime);
+}
+
+} // namespace
+
+NFB_TEST(EventTrace, EncodedEventsReadBackFieldByField) {
+  const std::vector<ExpectedEvent> expected = SampleEvents();
+  const std::vector<uint8_t> data = Encode(expected);
+  NFB_REQUIRE(data.size() > 8);
+  NFB_CHECK(std::memcmp(data.data(), "NFBT", 4) == 0);
+  NFB_CHECK_EQ(data[4], kEventTraceVersion);
+
+  EventTraceReader reader;
+  NFB_REQUIRE(reader.Open(data.data(), data.size()));
+  for (int pass = 0; pass < 2; ++pass) {
+    TraceEvent event;
+    size_t n = 0;
+    while (reader.Next(&event)) {
+      NFB_REQUIRE(n < expected.size());
+      NFB_CHECK(Matches(event, expected[n]));
+      if (event.payload) NFB_CHECK(event.payload >= data.data() && event.payload + event.payloadSize <= data.data() + data.size());
+      ++n;
+    }
+    NFB_CHECK_EQ(n, expected.size());
+    NFB_CHECK(!reader.Truncated());
+    NFB_CHECK(!reader.Next(&event)); // 读完后保持结束
+    reader.Rewind();                 // 第二遍从头读出同样的内容
+  }
+
+  // 时间倒退按与上一条相同处理；没有负载指针时长度记为 0
+  EventTraceEncoder encoder;
+  encoder.Append(TraceEventKind::FrameTimer, 500);
+  encoder.Append(TraceEventKind::FrameTimer, 200, 0, 0, nullptr, 64);
+  NFB_REQUIRE(reader.Open(encoder.Data().data(), encoder.Data().size()));
+  TraceEvent event;
+  NFB_REQUIRE(reader.Next(&event));
+  NFB_REQUIRE(reader.Next(&event));
+  NFB_CHECK_EQ(event.timeUs, 500u);
+  NFB_CHECK_EQ(event.payloadSize, 0u);
+
+  // TakeRecords 取走文件头之后的部分：文件头 + 各块拼起来与一次编码相同
+  encoder.Reset();
+  std::vector<uint8_t> joined = encoder.Data();
+  std::vector<uint8_t> chunk;
+  for (const ExpectedEvent& e : expected) {
+    encoder.Append(e.kind, e.timeUs, e.a, e.b, e.payload.empty() ? nullptr : e.payload.data(), e.payload.size());
+    encoder.TakeRecords(&chunk);
+    joined.insert(joined.end(), chunk.begin(), chunk.end());
+  }
+  NFB_CHECK(joined == data);
+  NFB_CHECK_EQ(encoder.Data().size(), 8u);
+
+  NFB_CHECK(std::strcmp(TraceEventKindName(TraceEventKind::SnapshotPublished), "snapshot") == 0);
+  NFB_CHECK(std::strcmp(TraceEventKindName((TraceEventKind)0), "unknown") == 0);
+}
+
+NFB_TEST(EventTrace, RecordedFileReadsBack) {
+  const TestTempDir dir("event_trace");
+  const std::string path = dir.File("events.nfbt");
+  EventTraceWriter writer;
+  NFB_REQUIRE(writer.Open(path));
+  NFB_CHECK(writer.IsOpen());
+  const std::string payload(100000, 'p'); // 超过一块：中途会分块写出
+  writer.Record(TraceEventKind::CopyData, 3, 0, payload.data(), payload.size());
+  for (uint32_t i = 0; i < 1000; ++i) writer.Record(TraceEventKind::MouseMove, i, i * 2);
+  writer.Record(TraceEventKind::MouseLeave);
+  NFB_CHECK_EQ(writer.Recorded(), 1002u);
+  NFB_CHECK_EQ(writer.Dropped(), 0u);
+  writer.Close();
+  NFB_CHECK(!writer.IsOpen());
+  writer.Record(TraceEventKind::FrameTimer); // 关闭后忽略
+
+  const std::vector<uint8_t> data = ReadFile(path);
+  EventTraceReader reader;
+  NFB_REQUIRE(reader.Open(data.data(), data.size()));
+  TraceEvent event;
+  NFB_REQUIRE(reader.Next(&event));
+  NFB_CHECK_EQ(event.kind, TraceEventKind::CopyData);
+  NFB_CHECK_EQ(event.a, 3u);
+  NFB_CHECK(event.payloadSize == payload.size() && std::memcmp(event.payload, payload.data(), payload.size()) == 0);
+  uint64_t lastUs = event.timeUs;
+  bool fieldsOk = true, monotonic = true;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    NFB_REQUIRE(reader.Next(&event));
+    fieldsOk = fieldsOk && event.kind == TraceEventKind::MouseMove && event.a == i && event.b == i * 2 && !event.payload;
+    monotonic = monotonic && event.timeUs >= lastUs;
+    lastUs = event.timeUs;
+  }
+  NFB_CHECK(fieldsOk);
+  NFB_CHECK(monotonic);
+  NFB_REQUIRE(reader.Next(&event));
+  NFB_CHECK_EQ(event.kind, TraceEventKind::MouseLeave);
+  NFB_CHECK(!reader.Next(&event));
+  NFB_CHECK(!reader.Truncated());
+
+  // 大小上限：放不下的记录被丢弃并计数，文件不超过上限
+  NFB_REQUIRE(writer.Open(path, 4096));
+  for (int i = 0; i < 2000; ++i) writer.Record(TraceEventKind::FrameTimer);
+  writer.Record(TraceEventKind::CopyData, 3, 0, payload.data(), payload.size());
+  NFB_CHECK(writer.Dropped() > 0);
+  NFB_CHECK_EQ(writer.Recorded() + writer.Dropped(), 2001u);
+  writer.Close();
+  const std::vector<uint8_t> capped = ReadFile(path);
+  NFB_CHECK(capped.size() <= 4096);
+  NFB_REQUIRE(reader.Open(capped.data(), capped.size()));
+  uint64_t n = 0;
+  while (reader.Next(&event)) ++n;
+  NFB_CHECK(!reader.Truncated());
+
+  NFB_CHECK(!writer.Open(dir.File("missing/events.nfbt")));
+  NFB_CHECK(!writer.IsOpen());
+}
+
+NFB_TEST(EventTrace, TruncatedTraceReadsCompletePrefix) {
+  const std::vector<ExpectedEvent> expected = SampleEvents();
+  const std::vector<uint8_t> full = Encode(expected);
+  // 每条记录结束的位置
+  std::vector<size_t> boundaries;
+  {
+    EventTraceEncoder encoder;
+    for (const ExpectedEvent& e : expected) {
+      encoder.Append(e.kind, e.timeUs, e.a, e.b, e.payload.empty() ? nullptr : e.payload.data(), e.payload.size());
+      boundaries.push_back(encoder.Data().size());
+    }
+  }
+  // 在每个字节处截断（录制中途崩溃）：读出截断点之前的完整记录，截在记录中间时报告 Truncated
+  bool allOk = true;
+  for (size_t cut = 8; cut < full.size(); ++cut) {
+    const std::vector<uint8_t> data(full.begin(), full.begin() + cut);
+    EventTraceReader reader;
+    if (!reader.Open(data.data(), data.size())) {
+      allOk = false;
+      continue;
+    }
+    size_t complete = 0;
+    while (complete < boundaries.size() && boundaries[complete] <= cut) ++complete;
+    TraceEvent event;
+    size_t n = 0;
+    while (reader.Next(&event)) {
+      allOk = allOk && n < expected.size() && Matches(event, expected[n]);
+      ++n;
+    }
+    const bool atBoundary = cut == 8 || (complete && boundaries[complete - 1] == cut);
+    allOk = allOk && n == complete && reader.Truncated() == !atBoundary;
+  }
+  NFB_CHECK(allOk);
+
+  // 回放截断的轨迹：回放完整的部分并报告 truncated
+  const std::vector<uint8_t> trace = MakeFixedTrace();
+  const std::vector<uint8_t> cut(trace.begin(), trace.end() - 3);
+  const ReplayCounts counts = Replay(cut, false, "");
+  const ReplayCounts whole = Replay(trace, false, "");
+  NFB_CHECK(counts.truncated);
+  NFB_CHECK(!whole.truncated);
+  NFB_CHECK_EQ(counts.events + 1, whole.events);
+}
+
+NFB_TEST(EventTrace, ForeignFilesAreRejected) {
+  const std::vector<uint8_t> good = Encode(SampleEvents());
+  const std::vector<std::vector<uint8_t>> foreign = {
+    {},
+    { 'N', 'F', 'B', 'T' },                                   // 文件头不完整
+    { 'N', 'F', 'B', 'T', kEventTraceVersion, 0, 0 },        // 差一个字节
+    { 'N', 'F', 'B', 'T', 2, 0, 0, 0, 3, 0, 0, 0, 0 },       // 未知版本
+    { 'G', 'I', 'F', '8', '9', 'a', 1, 0, 1, 0, 0, 0, 0 },   // GIF
+    { 'n', 'f', 'b', 't', kEventTraceVersion, 0, 0, 0 },     // 魔数大小写不同
+  };
+  EventTraceReader reader;
+  for (const std::vector<uint8_t>& data : foreign) NFB_CHECK(!reader.Open(data.data(), data.size()));
+  const std::string settings = "# native_floating_ball settings\ndiameter=120\n";
+  NFB_CHECK(!reader.Open(reinterpret_cast<const uint8_t*>(settings.data()), settings.size()));
+  NFB_CHECK(!reader.Open(nullptr, 100));
+
+  // 拒绝之后不会读出上一次打开的数据
+  NFB_REQUIRE(reader.Open(good.data(), good.size()));
+  NFB_CHECK(!reader.Open(foreign[4].data(), foreign[4].size()));
+  TraceEvent event;
+  NFB_CHECK(!reader.Next(&event));
+
+  // 回放也不处理任何事件（native_floating_replay 据此报告 "not an event trace"）
+  HeadlessBall ball;
+  const ReplayResult result = ReplayTrace(foreign[4].data(), foreign[4].size(), ball, false, nullptr);
+  NFB_CHECK_EQ(result.events, 0u);
+  NFB_CHECK(!result.truncated);
+
+  // 只有文件头的轨迹是合法的空轨迹
+  NFB_REQUIRE(reader.Open(good.data(), 8));
+  NFB_CHECK(!reader.Next(&event));
+  NFB_CHECK(!reader.Truncated());
+}
+
+NFB_TEST(EventTrace, FixedTraceReplaysToSameFrameCounts) {
+  const std::vector<uint8_t> trace = MakeFixedTrace();
+  NFB_CHECK(trace == MakeFixedTrace()); // 轨迹本身是确定的
+
+  // 全速回放：与 GIF 无关的计数是固定值（回放逻辑或 BallState 的改动若改变了它们，这里会提示）
+  HeadlessBall ball;
+  ball.LoadAssets(NFB_ASSET_DIR);
+  const ReplayCounts first = ReplayOnce(ball, trace, false);
+  NFB_CHECK_EQ(first.events, 51u);
+  NFB_CHECK_EQ(first.bubbleFrames, 45u);
+  NFB_CHECK_EQ(first.passedThrough, 1u);
+  NFB_CHECK_EQ(first.tasks, 12u);
+  NFB_CHECK(!first.truncated);
+  NFB_CHECK(first.ballFrames > 1); // 没有任务时未读 GIF 随帧定时器动画
+
+  // 另一个悬浮球按录制时的间隔回放：帧数只取决于轨迹时间，不取决于墙钟与调度
+  HeadlessBall realtimeBall;
+  realtimeBall.LoadAssets(NFB_ASSET_DIR);
+  NFB_CHECK(ReplayOnce(realtimeBall, trace, true) == first);
+  // 不加载 GIF 的悬浮球之间同样每次一致
+  const ReplayCounts plain = Replay(trace, false, "");
+  for (int i = 0; i < 3; ++i) NFB_CHECK(Replay(trace, false, "") == plain);
+  NFB_CHECK_EQ(plain.bubbleFrames, first.bubbleFrames);
+
+  // 同一个悬浮球连续回放（基准 BM_Replay 即如此）：轨迹时间接在上一次之后，每一遍与新球的第一遍相同
+  for (int i = 0; i < 3; ++i) NFB_CHECK(ReplayOnce(ball, trace, false) == first);
+}
@@ -0,0 +1,132 @@
+// 帧耗时统计：按预定间隔计帧间隔与错过次数（晚一个定时器 tick 以上才算错过、按需重绘不计）、两个窗口互不影响、
+// 最近一秒的帧率、Reset 清空本周期而保留帧率窗口、汇总周期，以及 Format / OverlayText 的输出。
+#include <sstream>
+#include <string>
+#include <vector>
+#include "test_harness.h"
+#include "core/frame_timing.h"
+
+namespace {
+
+constexpr uint64_t kMs = 1000000;
+
+// Format() 中某个窗口那一行的 frames / missed 两列
+bool SurfaceRow(const std::string& text, const char* surface, unsigned long long* frames, unsigned long long* missed) {
+  std::istringstream in(text);
+  for (std::string line; std::getline(in, line);) {
+    std::istringstream words(line);
+    std::string name;
+    if (words >> name && name == surface) return (bool)(words >> *frames >> *missed);
+  }
+  return false;
+}
+
+} // namespace
+
+NFB_TEST(FrameTimings, CountsDeadlineMisses) {
+  FrameTimings t;
+  const uint64_t budget = 40 * kMs; // GIF 帧延迟 40ms
+  uint64_t now = 1000 * kMs;
+  t.FramePresented(FrameSurface::Ball, now, 2 * kMs, budget); // 第一帧没有间隔
+  NFB_CHECK_EQ(t.Interval(FrameSurface::Ball).Count(), 0u);
+
+  // 按时到达、晚不到一个 tick、恰好晚一个 tick：都不算错过
+  for (uint64_t late : { (uint64_t)0, 15 * kMs, FrameTimings::kLateSlackNs }) {
+    now += budget + late;
+    t.FramePresented(FrameSurface::Ball, now, 2 * kMs, budget);
+  }
+  NFB_CHECK_EQ(t.Missed(FrameSurface::Ball), 0u);
+  NFB_CHECK_EQ(t.Interval(FrameSurface::Ball).Count(), 3u);
+
+  // 再晚 1ns 就错过一次；卡住 250ms 也只记一次
+  now += budget + FrameTimings::kLateSlackNs + 1;
+  t.FramePresented(FrameSurface::Ball, now, 2 * kMs, budget);
+  NFB_CHECK_EQ(t.Missed(FrameSurface::Ball), 1u);
+  now += 250 * kMs;
+  t.FramePresented(FrameSurface::Ball, now, 240 * kMs, budget);
+  NFB_CHECK_EQ(t.Missed(FrameSurface::Ball), 2u);
+  NFB_CHECK_EQ(t.Interval(FrameSurface::Ball).Max(), 250 * kMs);
+  NFB_CHECK_EQ(t.Frame(FrameSurface::Ball).Count(), 6u);
+  NFB_CHECK_EQ(t.Frame(FrameSurface::Ball).Max(), 240 * kMs);
+
+  // 按需重绘（budget 0）隔了很久也不算错过、不计间隔，但更新上一帧时刻
+  now += 5000 * kMs;
+  t.FramePresented(FrameSurface::Ball, now, 2 * kMs, 0);
+  NFB_CHECK_EQ(t.Missed(FrameSurface::Ball), 2u);
+  NFB_CHECK_EQ(t.Interval(FrameSurface::Ball).Count(), 5u);
+  now += budget;
+  t.FramePresented(FrameSurface::Ball, now, 2 * kMs, budget);
+  NFB_CHECK_EQ(t.Missed(FrameSurface::Ball), 2u);
+  NFB_CHECK_EQ(t.Interval(FrameSurface::Ball).Max(), 250 * kMs);
+
+  // 时钟没有前进（同一时刻两次呈现）不计间隔
+  t.FramePresented(FrameSurface::Ball, now, 2 * kMs, budget);
+  NFB_CHECK_EQ(t.Interval(FrameSurface::Ball).Count(), 6u);
+
+  // 气泡的 16ms 动画单独统计：晚了 33ms 才算错过
+  uint64_t bubbleNow = now;
+  for (uint64_t gap : { 16 * kMs, 32 * kMs, 33 * kMs, 16 * kMs }) {
+    t.FramePresented(FrameSurface::Bubble, bubbleNow += gap, kMs, 16 * kMs);
+  }
+  NFB_CHECK_EQ(t.Missed(FrameSurface::Bubble), 1u);
+  NFB_CHECK_EQ(t.Missed(FrameSurface::Ball), 2u);
+
+  unsigned long long frames = 0, missed = 0;
+  const std::string text = t.Format(now);
+  NFB_REQUIRE(SurfaceRow(text, "ball", &frames, &missed));
+  NFB_CHECK_EQ(frames, 9ull);
+  NFB_CHECK_EQ(missed, 2ull);
+  NFB_REQUIRE(SurfaceRow(text, "bubble", &frames, &missed));
+  NFB_CHECK_EQ(frames, 4ull);
+  NFB_CHECK_EQ(missed, 1ull);
+}
+
+NFB_TEST(FrameTimings, FpsOverLastFullSecond) {
+  FrameTimings t;
+  NFB_CHECK(t.Fps(FrameSurface::Ball) == 0.0);
+  // 40ms 一帧：第一个完整秒后为 25fps（窗口起点那一帧不算）
+  for (uint64_t ms = 10; ms <= 1010; ms += 40) t.FramePresented(FrameSurface::Ball, ms * kMs, kMs, 40 * kMs);
+  NFB_CHECK(t.Fps(FrameSurface::Ball) == 25.0);
+  NFB_CHECK(t.OverlayText(FrameSurface::Ball).rfind("25 fps p99 ", 0) == 0);
+  // 下一秒只有 10fps；不满一秒时保持上一个值
+  for (uint64_t ms = 1110; ms <= 1910; ms += 100) t.FramePresented(FrameSurface::Ball, ms * kMs, kMs, 100 * kMs);
+  NFB_CHECK(t.Fps(FrameSurface::Ball) == 25.0);
+  t.FramePresented(FrameSurface::Ball, 2010 * kMs, kMs, 100 * kMs);
+  NFB_CHECK(t.Fps(FrameSurface::Ball) == 10.0);
+  NFB_CHECK(t.Fps(FrameSurface::Bubble) == 0.0);
+}
+
+NFB_TEST(FrameTimings, ResetStartsNewPeriod) {
+  FrameTimings t;
+  t.SetSummaryInterval(60000 * kMs);
+  NFB_CHECK(!t.SummaryDue(100000 * kMs)); // 第一次 Reset 才是周期起点
+  t.Reset(1000 * kMs);
+  NFB_CHECK(!t.SummaryDue(60999 * kMs));
+  NFB_CHECK(t.SummaryDue(61000 * kMs));
+
+  t.Record(FrameStage::BallSelect, 3 * kMs);
+  t.Record(FrameStage::BallPresent, 1 * kMs);
+  t.FramePresented(FrameSurface::Ball, 1000 * kMs, 4 * kMs, 40 * kMs);
+  t.FramePresented(FrameSurface::Ball, 1100 * kMs, 4 * kMs, 40 * kMs); // 错过
+  NFB_CHECK_EQ(t.Missed(FrameSurface::Ball), 1u);
+  NFB_CHECK_EQ(t.Stage(FrameStage::BallSelect).Count(), 1u);
+  const std::string text = t.Format(31000 * kMs);
+  NFB_CHECK(text.rfind("frame timings over 30.0 s\n", 0) == 0);
+  NFB_CHECK(text.find("ball.select") != std::string::npos);
+  NFB_CHECK(text.find("bubble.draw") == std::string::npos); // 没有样本的阶段不列出
+
+  t.Reset(61000 * kMs);
+  NFB_CHECK_EQ(t.Missed(FrameSurface::Ball), 0u);
+  NFB_CHECK_EQ(t.Frame(FrameSurface::Ball).Count(), 0u);
+  NFB_CHECK_EQ(t.Stage(FrameStage::BallSelect).Count(), 0u);
+  NFB_CHECK(!t.SummaryDue(61000 * kMs));
+  // 上一帧时刻保留：Reset 之后的第一帧仍与之前的帧比较间隔
+  t.FramePresented(FrameSurface::Ball, 1140 * kMs, 4 * kMs, 40 * kMs);
+  NFB_CHECK_EQ(t.Interval(FrameSurface::Ball).Count(), 1u);
+  NFB_CHECK_EQ(t.Missed(FrameSurface::Ball), 0u);
+
+  t.SetSummaryInterval(0);
+  NFB_CHECK(!t.SummaryDue(UINT64_MAX));
+  NFB_CHECK(std::string(FrameStageName(FrameStage::BubbleEndDraw)) == "bubble.end_draw");
+  NFB_CHECK(std::string(FrameSurfaceName(FrameSurface::kCount)) == "unknown");
+}
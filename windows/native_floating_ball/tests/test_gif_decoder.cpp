@@ -0,0 +1,657 @@
+// GIF 解码与合成：用测试内的编码器手工构造小 GIF（码长增长、clear 码、表满后的延迟 clear、
+// Disposal 2/3、透明色、隔行扫描、局部调色板、裁剪），逐帧与按规则直接合成的参考画布比对；
+// 截断与损坏输入不越界且已完整的帧不受影响；仓库自带 unread_logo.gif 的逐帧哈希与 PIL 合成结果一致。
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "test_harness.h"
+#include "core/circle_mask.h"
+#include "core/display_frames.h"
+#include "core/gif_decoder.h"
+
+namespace {
+
+// 按 GIF 的位序（低位在前）写变长码
+class BitWriter {
+public:
+  void Put(uint32_t code, uint32_t size) {
+    m_bits |= (uint64_t)code << m_count;
+    m_count += size;
+    while (m_count >= 8) {
+      m_bytes.push_back((uint8_t)m_bits);
+      m_bits >>= 8;
+      m_count -= 8;
+    }
+  }
+  std::vector<uint8_t> Finish() {
+    if (m_count) m_bytes.push_back((uint8_t)m_bits);
+    m_bits = 0;
+    m_count = 0;
+    return std::move(m_bytes);
+  }
+
+private:
+  std::vector<uint8_t> m_bytes;
+  uint64_t m_bits{0};
+  uint32_t m_count{0};
+};
+
+struct LzwOptions {
+  bool dictionary{true};    // false：每个像素单独成码（解码端照样建表、码长照样增长）
+  bool clearWhenFull{true}; // false：表满后不发 clear，继续用 12 位码（延迟 clear）
+  size_t clearEvery{0};     // 每发出这么多个码插入一次 clear（0 表示不插）
+};
+
+struct LzwStats {
+  size_t codes{0};
+  size_t clears{0};
+  bool filled{false}; // 编码端码表曾经满到 4096 项
+  uint32_t maxCodeSize{0};
+};
+
+// 码长按解码端的规则推进：收到第 k (k >= 1) 个码后建一项，next 到达 2^codeSize 时码长加一
+std::vector<uint8_t> EncodeLzw(const std::vector<uint8_t>& indices, uint32_t minCodeSize, const LzwOptions& options,
+                               LzwStats* stats) {
+  const uint32_t clear = 1u << minCodeSize;
+  BitWriter writer;
+  std::map<std::pair<uint32_t, uint8_t>, uint32_t> table;
+  uint32_t codeSize = 0, next = 0, decoderNext = 0;
+  size_t sinceClear = 0;
+  LzwStats local;
+  const auto reset = [&] {
+    table.clear();
+    codeSize = minCodeSize + 1;
+    next = decoderNext = clear + 2;
+    sinceClear = 0;
+  };
+  const auto put = [&](uint32_t code) {
+    writer.Put(code, codeSize);
+    ++local.codes;
+    local.maxCodeSize = (std::max)(local.maxCodeSize, codeSize);
+    if (sinceClear++ > 0 && decoderNext < 4096) {
+      ++decoderNext;
+      if (decoderNext == (1u << codeSize) && codeSize < 12) ++codeSize;
+    }
+  };
+  const auto putClear = [&] {
+    writer.Put(clear, codeSize);
+    ++local.clears;
+    reset();
+  };
+
+  reset();
+  putClear();
+  local.clears = 0;
+  size_t i = 0;
+  while (i < indices.size()) {
+    if (options.clearEvery && sinceClear >= options.clearEvery) putClear();
+    uint32_t code = indices[i++];
+    if (options.dictionary) {
+      while (i < indices.size()) {
+        const auto it = table.find({ code, indices[i] });
+        if (it == table.end()) break;
+        code = it->second;
+        ++i;
+      }
+    }
+    put(code);
+    if (i < indices.size() && next < 4096) {
+      if (options.dictionary) table[{ code, indices[i] }] = next;
+      if (++next == 4096) local.filled = true;
+    }
+    // 与常见编码器一样，表满后紧接着发 clear
+    if (next == 4096 && options.clearWhenFull && i < indices.size()) putClear();
+  }
+  writer.Put(clear + 1, codeSize);
+  if (stats) *stats = local;
+  return writer.Finish();
+}
+
+struct FrameSpec {
+  uint16_t left{0}, top{0}, width{0}, height{0};
+  std::vector<uint8_t> indices;      // 按显示顺序（隔行时由编码端重排）
+  std::vector<uint32_t> palette;     // 局部调色板 0xRRGGBB；空表示用全局调色板
+  int transparent{-1};
+  uint8_t disposal{0};
+  int delayCs{-1};                   // -1：不写图形控制扩展
+  bool interlaced{false};
+  uint32_t minCodeSize{0};           // 0：按调色板大小推算（至少 2）
+  LzwOptions lzw;
+  std::vector<uint8_t> rawCodes;     // 非空时直接用作码流（测试损坏数据）
+  LzwStats stats;                    // 编码后回填
+};
+
+uint32_t PaletteBits(size_t entries) {
+  uint32_t bits = 1;
+  while ((1u << bits) < entries) ++bits;
+  return bits;
+}
+
+void PutU16(std::vector<uint8_t>* out, uint32_t v) {
+  out->push_back((uint8_t)v);
+  out->push_back((uint8_t)(v >> 8));
+}
+
+void PutPalette(std::vector<uint8_t>* out, const std::vector<uint32_t>& palette) {
+  const size_t entries = (size_t)1 << PaletteBits(palette.size());
+  for (size_t i = 0; i < entries; ++i) {
+    const uint32_t rgb = i < palette.size() ? palette[i] : 0;
+    out->push_back((uint8_t)(rgb >> 16));
+    out->push_back((uint8_t)(rgb >> 8));
+    out->push_back((uint8_t)rgb);
+  }
+}
+
+// 隔行扫描的码流行序：0,8,16.. / 4,12.. / 2,6.. / 1,3..
+std::vector<uint32_t> InterlacedRows(uint32_t height) {
+  std::vector<uint32_t> rows;
+  const uint32_t start[4] = { 0, 4, 2, 1 };
+  const uint32_t step[4] = { 8, 8, 4, 2 };
+  for (int pass = 0; pass < 4; ++pass) {
+    for (uint32_t r = start[pass]; r < height; r += step[pass]) rows.push_back(r);
+  }
+  return rows;
+}
+
+std::vector<uint8_t> BuildGif(uint16_t width, uint16_t height, const std::vector<uint32_t>& globalPalette,
+                              std::vector<FrameSpec>& frames) {
+  std::vector<uint8_t> out = { 'G', 'I', 'F', '8', '9', 'a' };
+  PutU16(&out, width);
+  PutU16(&out, height);
+  out.push_back(globalPalette.empty() ? 0 : (uint8_t)(0x80 | (PaletteBits(globalPalette.size()) - 1)));
+  out.push_back(0); // 背景色
+  out.push_back(0); // 像素宽高比
+  if (!globalPalette.empty()) PutPalette(&out, globalPalette);
+
+  for (FrameSpec& frame : frames) {
+    if (frame.delayCs >= 0 || frame.transparent >= 0 || frame.disposal) {
+      out.insert(out.end(), { 0x21, 0xF9, 4 });
+      out.push_back((uint8_t)(frame.disposal << 2 | (frame.transparent >= 0 ? 1 : 0)));
+      PutU16(&out, frame.delayCs < 0 ? 0 : (uint32_t)frame.delayCs);
+      out.push_back((uint8_t)(frame.transparent >= 0 ? frame.transparent : 0));
+      out.push_back(0);
+    }
+    out.push_back(0x2C);
+    PutU16(&out, frame.left);
+    PutU16(&out, frame.top);
+    PutU16(&out, frame.width);
+    PutU16(&out, frame.height);
+    uint8_t packed = frame.interlaced ? 0x40 : 0;
+    if (!frame.palette.empty()) packed |= (uint8_t)(0x80 | (PaletteBits(frame.palette.size()) - 1));
+    out.push_back(packed);
+    if (!frame.palette.empty()) PutPalette(&out, frame.palette);
+
+    const size_t paletteEntries = frame.palette.empty() ? globalPalette.size() : frame.palette.size();
+    const uint32_t minCodeSize = frame.minCodeSize ? frame.minCodeSize : (std::max)(2u, PaletteBits(paletteEntries));
+    out.push_back((uint8_t)minCodeSize);
+    std::vector<uint8_t> codes = frame.rawCodes;
+    if (codes.empty()) {
+      std::vector<uint8_t> stream = frame.indices;
+      if (frame.interlaced) {
+        const std::vector<uint32_t> rows = InterlacedRows(frame.height);
+        for (size_t r = 0; r < rows.size(); ++r) {
+          std::memcpy(stream.data() + r * frame.width, frame.indices.data() + (size_t)rows[r] * frame.width, frame.width);
+        }
+      }
+      codes = EncodeLzw(stream, minCodeSize, frame.lzw, &frame.stats);
+    }
+    for (size_t p = 0; p < codes.size(); p += 255) {
+      const size_t len = (std::min)((size_t)255, codes.size() - p);
+      out.push_back((uint8_t)len);
+      out.insert(out.end(), codes.begin() + p, codes.begin() + p + len);
+    }
+    out.push_back(0);
+  }
+  out.push_back(0x3B);
+  return out;
+}
+
+// 不经过 LZW，直接按 GIF 规则合成每一帧（预乘 BGRA，Disposal 2 清成透明）
+std::vector<std::vector<uint8_t>> ReferenceCanvases(uint32_t width, uint32_t height,
+                                                    const std::vector<uint32_t>& globalPalette,
+                                                    const std::vector<FrameSpec>& frames) {
+  std::vector<std::vector<uint8_t>> result;
+  std::vector<uint8_t> canvas((size_t)width * height * 4, 0), saved;
+  const FrameSpec* prev = nullptr;
+  for (const FrameSpec& frame : frames) {
+    if (prev && prev->disposal == 2) {
+      for (uint32_t y = prev->top; y < (std::min)(height, (uint32_t)prev->top + prev->height); ++y) {
+        for (uint32_t x = prev->left; x < (std::min)(width, (uint32_t)prev->left + prev->width); ++x) {
+          std::memset(&canvas[((size_t)y * width + x) * 4], 0, 4);
+        }
+      }
+    } else if (prev && prev->disposal == 3) {
+      canvas = saved;
+    }
+    if (frame.disposal == 3) saved = canvas;
+    const std::vector<uint32_t>& palette = frame.palette.empty() ? globalPalette : frame.palette;
+    for (uint32_t y = 0; y < frame.height; ++y) {
+      for (uint32_t x = 0; x < frame.width; ++x) {
+        const uint8_t index = frame.indices[(size_t)y * frame.width + x];
+        if (index == frame.transparent) continue;
+        const uint32_t cx = frame.left + x, cy = frame.top + y;
+        if (cx >= width || cy >= height) continue;
+        const uint32_t rgb = index < palette.size() ? palette[index] : 0; // 越界下标为黑色
+        uint8_t* px = &canvas[((size_t)cy * width + cx) * 4];
+        px[0] = (uint8_t)rgb;
+        px[1] = (uint8_t)(rgb >> 8);
+        px[2] = (uint8_t)(rgb >> 16);
+        px[3] = 255;
+      }
+    }
+    result.push_back(canvas);
+    prev = &frame;
+  }
+  return result;
+}
+
+// 解码每一帧并与参考画布比对；返回解出的帧数
+size_t CheckAgainstReference(const std::vector<uint8_t>& gif, uint32_t width, uint32_t height,
+                             const std::vector<std::vector<uint8_t>>& expected) {
+  GifDecoder decoder;
+  if (!decoder.Open(gif.data(), gif.size())) return 0;
+  NFB_CHECK_EQ(decoder.Width(), width);
+  NFB_CHECK_EQ(decoder.Height(), height);
+  size_t frames = 0;
+  while (const uint8_t* canvas = decoder.ComposeNext()) {
+    if (frames >= expected.size()) {
+      ReportFailure(__FILE__, __LINE__, "more frames than expected");
+      break;
+    }
+    const bool same = std::memcmp(canvas, expected[frames].data(), expected[frames].size()) == 0;
+    if (!same) ReportFailure(__FILE__, __LINE__, "frame " + std::to_string(frames) + " differs from reference");
+    ++frames;
+  }
+  return frames;
+}
+
+std::vector<uint8_t> RandomIndices(size_t count, uint32_t colors, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<uint8_t> indices(count);
+  for (uint8_t& i : indices) i = (uint8_t)(rng() % colors);
+  return indices;
+}
+
+std::vector<uint32_t> Palette(size_t entries, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<uint32_t> palette(entries);
+  for (uint32_t& rgb : palette) rgb = rng() & 0xFFFFFFu;
+  return palette;
+}
+
+FrameSpec Full(uint16_t width, uint16_t height, std::vector<uint8_t> indices) {
+  FrameSpec frame;
+  frame.width = width;
+  frame.height = height;
+  frame.indices = std::move(indices);
+  return frame;
+}
+
+uint64_t Fnv1a(const uint8_t* data, size_t size) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < size; ++i) {
+    h ^= data[i];
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+} // namespace
+
+NFB_TEST(GifDecoder, CodeSizeGrowsAndTableFreezesWithoutClear) {
+  // 8 位随机像素几乎没有可复用的串：码表在这一帧里填满 4096 项，之后编码端不发 clear，继续用 12 位码
+  const std::vector<uint32_t> palette = Palette(256, 1);
+  std::vector<FrameSpec> frames = { Full(128, 64, RandomIndices(128 * 64, 256, 2)) };
+  frames[0].lzw.clearWhenFull = false;
+  const std::vector<uint8_t> gif = BuildGif(128, 64, palette, frames);
+  NFB_CHECK(frames[0].stats.filled);
+  NFB_CHECK_EQ(frames[0].stats.clears, 0u);
+  NFB_CHECK_EQ(frames[0].stats.maxCodeSize, 12u);
+  NFB_CHECK(frames[0].stats.codes > 4096u);
+  NFB_CHECK_EQ(CheckAgainstReference(gif, 128, 64, ReferenceCanvases(128, 64, palette, frames)), 1u);
+}
+
+NFB_TEST(GifDecoder, ClearCodesResetTheTable) {
+  // 2 位调色板：码长从 3 位一路涨到 12 位；表满时发 clear，另一帧每 37 个码插一次 clear
+  const std::vector<uint32_t> palette = Palette(4, 3);
+  std::vector<FrameSpec> frames = { Full(200, 150, RandomIndices(200 * 150, 4, 4)),
+                                    Full(200, 150, RandomIndices(200 * 150, 3, 5)) };
+  frames[1].lzw.clearEvery = 37;
+  const std::vector<uint8_t> gif = BuildGif(200, 150, palette, frames);
+  NFB_CHECK(frames[0].stats.filled);
+  NFB_CHECK(frames[0].stats.clears > 0u);
+  NFB_CHECK_EQ(frames[0].stats.maxCodeSize, 12u);
+  NFB_CHECK(frames[1].stats.clears > 100u);
+  NFB_CHECK_EQ(CheckAgainstReference(gif, 200, 150, ReferenceCanvases(200, 150, palette, frames)), 2u);
+}
+
+NFB_TEST(GifDecoder, LiteralAndRunHeavyStreams) {
+  // 逐像素成码（解码端照样建表）与大片同色（反复出现 code == next 的 KwKwK 情形），各种最小码长
+  for (uint32_t bits = 1; bits <= 8; ++bits) {
+    const std::vector<uint32_t> palette = Palette((size_t)1 << bits, bits);
+    std::vector<FrameSpec> frames = { Full(33, 17, RandomIndices(33 * 17, 1u << bits, bits)) };
+    frames[0].lzw.dictionary = false;
+    FrameSpec runs = Full(64, 64, std::vector<uint8_t>(64 * 64, 0));
+    for (size_t i = 0; i < runs.indices.size(); ++i) runs.indices[i] = (uint8_t)((i / 700) % palette.size());
+    frames.push_back(runs);
+    const std::vector<uint8_t> gif = BuildGif(64, 64, palette, frames);
+    NFB_CHECK_EQ(CheckAgainstReference(gif, 64, 64, ReferenceCanvases(64, 64, palette, frames)), 2u);
+  }
+}
+
+NFB_TEST(GifDecoder, DisposalAndTransparency) {
+  const std::vector<uint32_t> palette = { 0xFF0000, 0x00FF00, 0x0000FF, 0xFFFFFF };
+  std::vector<FrameSpec> frames;
+  FrameSpec background = Full(12, 10, std::vector<uint8_t>(120, 0));
+  background.disposal = 1;
+  frames.push_back(background);
+  // 透明色 3 的位置露出底下的红色；显示后清成透明
+  FrameSpec cleared;
+  cleared.left = 2, cleared.top = 1, cleared.width = 5, cleared.height = 4;
+  cleared.indices = RandomIndices(20, 4, 6);
+  cleared.transparent = 3;
+  cleared.disposal = 2;
+  frames.push_back(cleared);
+  // 显示后恢复到本帧之前的画布
+  FrameSpec restored;
+  restored.left = 6, restored.top = 3, restored.width = 6, restored.height = 7;
+  restored.indices = RandomIndices(42, 4, 7);
+  restored.disposal = 3;
+  frames.push_back(restored);
+  FrameSpec last;
+  last.left = 0, last.top = 8, last.width = 12, last.height = 2;
+  last.indices = std::vector<uint8_t>(24, 2);
+  frames.push_back(last);
+  const std::vector<uint8_t> gif = BuildGif(12, 10, palette, frames);
+  const std::vector<std::vector<uint8_t>> expected = ReferenceCanvases(12, 10, palette, frames);
+  NFB_CHECK_EQ(CheckAgainstReference(gif, 12, 10, expected), 4u);
+  // 参考画布本身：Disposal 2 清出的区域是透明的，Disposal 3 之后那块区域回到清除后的状态
+  const uint8_t red[4] = { 0, 0, 255, 255 };
+  NFB_CHECK_EQ(expected[2][(1 * 12 + 2) * 4 + 3], 0);
+  NFB_CHECK_EQ(expected[3][(2 * 12 + 3) * 4 + 3], 0);
+  NFB_CHECK(std::memcmp(&expected[3][(5 * 12 + 8) * 4], red, 4) == 0);
+}
+
+NFB_TEST(GifDecoder, InterlacedRowsLandInDisplayOrder) {
+  const std::vector<uint32_t> palette = Palette(16, 8);
+  for (uint16_t height = 1; height <= 19; ++height) {
+    std::vector<FrameSpec> frames = { Full(7, height, std::vector<uint8_t>((size_t)7 * height)) };
+    // 每行一种颜色，行序错了一定能看出来
+    for (uint16_t y = 0; y < height; ++y) std::memset(frames[0].indices.data() + (size_t)y * 7, y % 16, 7);
+    frames[0].interlaced = true;
+    const std::vector<uint8_t> gif = BuildGif(7, height, palette, frames);
+    NFB_CHECK_EQ(CheckAgainstReference(gif, 7, height, ReferenceCanvases(7, height, palette, frames)), 1u);
+  }
+}
+
+NFB_TEST(GifDecoder, LocalPaletteClippingAndDelays) {
+  const std::vector<uint32_t> global = Palette(4, 9);
+  std::vector<FrameSpec> frames;
+  FrameSpec local = Full(8, 8, RandomIndices(64, 4, 10));
+  local.palette = { 0x123456, 0xABCDEF }; // 下标 2、3 超出局部调色板：按黑色
+  local.minCodeSize = 2;
+  local.delayCs = 0;
+  frames.push_back(local);
+  FrameSpec overhang;
+  overhang.left = 5, overhang.top = 6, overhang.width = 9, overhang.height = 5; // 超出画布的部分被裁掉
+  overhang.indices = RandomIndices(45, 4, 11);
+  overhang.delayCs = 7;
+  frames.push_back(overhang);
+  FrameSpec outside;
+  outside.left = 20, outside.top = 0, outside.width = 3, outside.height = 3;
+  outside.indices = RandomIndices(9, 4, 12);
+  frames.push_back(outside);
+  const std::vector<uint8_t> gif = BuildGif(8, 8, global, frames);
+  NFB_CHECK_EQ(CheckAgainstReference(gif, 8, 8, ReferenceCanvases(8, 8, global, frames)), 3u);
+
+  GifDecoder decoder;
+  NFB_REQUIRE(decoder.Open(gif.data(), gif.size()));
+  NFB_CHECK_EQ(decoder.DelayMs(0), 100u); // 延迟 0 按默认速度
+  NFB_CHECK_EQ(decoder.DelayMs(1), 70u);
+  NFB_CHECK_EQ(decoder.DelayMs(2), 100u); // 没有图形控制扩展
+  NFB_CHECK_EQ(decoder.DelayMs(3), 100u);
+}
+
+NFB_TEST(GifDecoder, ZeroScreenFallsBackToFirstFrame) {
+  const std::vector<uint32_t> palette = Palette(4, 13);
+  std::vector<FrameSpec> frames;
+  FrameSpec frame = Full(5, 3, RandomIndices(15, 4, 14));
+  frame.left = 2, frame.top = 1;
+  frames.push_back(frame);
+  const std::vector<uint8_t> gif = BuildGif(0, 0, palette, frames);
+  NFB_CHECK_EQ(CheckAgainstReference(gif, 7, 4, ReferenceCanvases(7, 4, palette, frames)), 1u);
+}
+
+NFB_TEST(GifDecoder, RewindReplaysIdentically) {
+  const std::vector<uint32_t> palette = Palette(8, 15);
+  std::vector<FrameSpec> frames;
+  for (int i = 0; i < 4; ++i) {
+    FrameSpec frame;
+    frame.left = (uint16_t)i, frame.top = (uint16_t)(i * 2), frame.width = 10, frame.height = 6;
+    frame.indices = RandomIndices(60, 8, 16 + i);
+    frame.disposal = (uint8_t)(i % 4);
+    frame.transparent = i;
+    frames.push_back(frame);
+  }
+  const std::vector<uint8_t> gif = BuildGif(16, 16, palette, frames);
+  GifDecoder decoder;
+  NFB_REQUIRE(decoder.Open(gif.data(), gif.size()));
+  std::vector<std::vector<uint8_t>> first;
+  while (const uint8_t* canvas = decoder.ComposeNext()) first.emplace_back(canvas, canvas + 16 * 16 * 4);
+  NFB_CHECK(decoder.ComposeNext() == nullptr);
+  decoder.Rewind();
+  for (const std::vector<uint8_t>& expected : first) {
+    const uint8_t* canvas = decoder.ComposeNext();
+    NFB_REQUIRE(canvas != nullptr);
+    NFB_CHECK(std::memcmp(canvas, expected.data(), expected.size()) == 0);
+  }
+  NFB_CHECK(first == ReferenceCanvases(16, 16, palette, frames));
+}
+
+NFB_TEST(GifDecoder, TruncationKeepsCompleteFrames) {
+  // 每个前缀都放进恰好大小的缓冲：越界读会被 ASan 报告；截断处之前完整的帧必须与参考一致
+  const std::vector<uint32_t> palette = Palette(16, 20);
+  std::vector<FrameSpec> frames;
+  for (int i = 0; i < 3; ++i) {
+    FrameSpec frame = Full(20, 12, RandomIndices(240, 16, 21 + i));
+    frame.disposal = (uint8_t)(i + 1);
+    frame.delayCs = 5;
+    frames.push_back(frame);
+  }
+  const std::vector<uint8_t> gif = BuildGif(20, 12, palette, frames);
+  const std::vector<std::vector<uint8_t>> expected = ReferenceCanvases(20, 12, palette, frames);
+  size_t lastCount = 0;
+  for (size_t len = 0; len <= gif.size(); ++len) {
+    const std::vector<uint8_t> cut(gif.begin(), gif.begin() + len);
+    GifDecoder decoder;
+    if (!decoder.Open(cut.data(), cut.size())) {
+      NFB_CHECK_EQ(decoder.FrameCount(), 0u);
+      NFB_CHECK(decoder.ComposeNext() == nullptr);
+      continue;
+    }
+    NFB_CHECK(decoder.FrameCount() >= lastCount);
+    lastCount = decoder.FrameCount();
+    NFB_CHECK_EQ(CheckAgainstReference(cut, 20, 12, expected), decoder.FrameCount());
+  }
+  NFB_CHECK_EQ(lastCount, 3u);
+}
+
+NFB_TEST(GifDecoder, CorruptCodeStreamKeepsDecodedPrefix) {
+  // clear, 1, 1, 1（码长随之涨到 4 位），然后一个超出码表的码：前三个像素画上，其余保持原样（透明）
+  const std::vector<uint32_t> palette = { 0x000000, 0x102030, 0x405060, 0x708090 };
+  BitWriter writer;
+  writer.Put(4, 3);
+  writer.Put(1, 3);
+  writer.Put(1, 3);
+  writer.Put(1, 3);
+  writer.Put(9, 4);
+  writer.Put(1, 4);
+  std::vector<FrameSpec> frames = { Full(4, 2, {}) };
+  frames[0].rawCodes = writer.Finish();
+  frames[0].minCodeSize = 2;
+  const std::vector<uint8_t> gif = BuildGif(4, 2, palette, frames);
+  GifDecoder decoder;
+  NFB_REQUIRE(decoder.Open(gif.data(), gif.size()));
+  const uint8_t* canvas = decoder.ComposeNext();
+  NFB_REQUIRE(canvas != nullptr);
+  const uint8_t color[4] = { 0x30, 0x20, 0x10, 0xFF };
+  NFB_CHECK(std::memcmp(canvas, color, 4) == 0);
+  NFB_CHECK(std::memcmp(canvas + 4, color, 4) == 0);
+  NFB_CHECK(std::memcmp(canvas + 8, color, 4) == 0);
+  for (size_t i = 3; i < 8; ++i) NFB_CHECK_EQ(canvas[i * 4 + 3], 0);
+
+  // 最小码长不合法的帧不绘制
+  for (uint8_t bad : { (uint8_t)0, (uint8_t)1, (uint8_t)12, (uint8_t)255 }) {
+    std::vector<FrameSpec> one = { Full(4, 2, std::vector<uint8_t>(8, 1)) };
+    std::vector<uint8_t> data = BuildGif(4, 2, palette, one);
+    const size_t codeSizeAt = 13 + 4 * 3 + 10; // 头 + 全局调色板 + 图像描述符
+    NFB_REQUIRE(data[codeSizeAt] == 2);
+    data[codeSizeAt] = bad;
+    NFB_REQUIRE(decoder.Open(data.data(), data.size()));
+    canvas = decoder.ComposeNext();
+    NFB_REQUIRE(canvas != nullptr);
+    for (size_t i = 0; i < 8; ++i) NFB_CHECK_EQ(canvas[i * 4 + 3], 0);
+  }
+}
+
+NFB_TEST(GifDecoder, RejectsMalformedHeaders) {
+  const std::vector<uint32_t> palette = Palette(4, 30);
+  std::vector<FrameSpec> frames = { Full(4, 4, RandomIndices(16, 4, 31)) };
+  const std::vector<uint8_t> good = BuildGif(4, 4, palette, frames);
+  GifDecoder decoder;
+  NFB_CHECK(decoder.Open(good.data(), good.size()));
+  NFB_CHECK(!decoder.Open(nullptr, good.size()));
+  std::vector<uint8_t> bytes = good;
+  bytes[3] = '7';
+  bytes[4] = '0'; // "GIF70a"
+  NFB_CHECK(!decoder.Open(bytes.data(), bytes.size()));
+  bytes = good;
+  bytes[6] = 0x01, bytes[7] = 0x21; // 宽 8449 超过上限
+  NFB_CHECK(!decoder.Open(bytes.data(), bytes.size()));
+  NFB_CHECK_EQ(decoder.FrameCount(), 0u);
+  NFB_CHECK(decoder.ComposeNext() == nullptr);
+  // 只有头、没有图像块
+  std::vector<uint8_t> empty(good.begin(), good.begin() + 13 + 12);
+  empty.push_back(0x3B);
+  NFB_CHECK(!decoder.Open(empty.data(), empty.size()));
+}
+
+NFB_TEST(GifDecoder, RandomCorruptionStaysInBounds) {
+  const std::vector<uint32_t> palette = Palette(16, 40);
+  std::vector<FrameSpec> frames;
+  for (int i = 0; i < 3; ++i) {
+    FrameSpec frame;
+    frame.left = (uint16_t)(i * 3), frame.top = (uint16_t)i, frame.width = 13, frame.height = 9;
+    frame.indices = RandomIndices(117, 16, 41 + i);
+    frame.disposal = (uint8_t)(i + 1);
+    frame.interlaced = i == 1;
+    frame.transparent = 5;
+    frames.push_back(frame);
+  }
+  const std::vector<uint8_t> good = BuildGif(20, 12, palette, frames);
+  std::mt19937 rng(42);
+  for (int iteration = 0; iteration < 3000; ++iteration) {
+    std::vector<uint8_t> bytes = good;
+    const int flips = 1 + (int)(rng() % 4);
+    for (int f = 0; f < flips; ++f) bytes[6 + rng() % (bytes.size() - 6)] = (uint8_t)rng();
+    GifDecoder decoder;
+    if (!decoder.Open(bytes.data(), bytes.size())) continue;
+    NFB_CHECK(decoder.Width() <= GifDecoder::kMaxDimension && decoder.Height() <= GifDecoder::kMaxDimension);
+    size_t composed = 0;
+    while (decoder.ComposeNext()) ++composed;
+    NFB_CHECK_EQ(composed, decoder.FrameCount());
+  }
+}
+
+NFB_TEST(GifDecoder, UnreadLogoMatchesReferenceFrames) {
+  // 逐帧 FNV-1a（预乘 BGRA 画布）：用 PIL 逐帧合成并转成 BGRA 后计算，与本解码器无关（该文件全部帧
+  // Disposal 1、无透明色，PIL 的合成与上面的规则一致）
+  static const uint64_t kFrameHashes[] = {
+    0x3c5b801b2aea180cull, 0xbbcdd15922b65baeull, 0xa000f26295c21b2full,
+    0xdb5abc7160eda8f2ull, 0x3276db3b0b111c10ull, 0x823714c540f342a4ull,
+    0x8d77c38a736fe05eull, 0xdd3b272298ca67f8ull, 0xf9d11937e88ad131ull,
+    0x47006787fc900b19ull, 0x3aa2e4f085206437ull, 0xf1ac85db0bcc05fcull,
+    0x4bacc8e06554a332ull, 0x8366a24183038090ull, 0xe9014eeb0589b766ull,
+    0x663644d50fc2e109ull, 0x85efd7949910914bull, 0x676d4fcb63258396ull,
+    0x971862660dcd8f2dull, 0xff90af1707657782ull, 0x0e9962594b944084ull,
+    0x1dfb357e8be2badeull, 0xd7fee4e768ecc034ull, 0xcc096e5718a5602full,
+    0xb2893ffdd00afe49ull, 0xc877f21cd30a2382ull, 0x7dc6bc1dc794e319ull,
+    0xfaa0158baa81d705ull, 0xd7d3dd49d4ef3415ull, 0xea796c5ae9416345ull,
+    0x73a2a825b673dbeeull, 0xfe5da615614b9d09ull, 0xaecdbfeae95b644bull,
+    0xc592a25f5ac428c9ull, 0x6ef289f21b0d3e4dull, 0x1732bbe518a222e9ull,
+    0x84ef0b46b73837f9ull, 0x146644b0d2a12b44ull, 0x225fb8e5de98ce3dull,
+    0x4e0261eecb72587eull, 0xeac210ef62f50224ull, 0x47a09810653a8277ull,
+    0xa243f10f698189a9ull, 0xca829d87494991c3ull, 0x4693218c5b3ce3b8ull,
+    0xc2ab57a898d635e2ull, 0xfaf86698a5c70ddfull, 0xe1320aae09706815ull,
+    0x8cec175f952f6db0ull, 0x4bcd9bdb0bcd85f1ull, 0x5822159db58755c0ull,
+    0x3dc4de57f3aae69eull, 0x26e88d29c1ba8a85ull, 0xaff6605fbe567ee0ull,
+    0x05a9d572580f630eull, 0x02025cca9245e023ull, 0xab7ae66b94c759b4ull,
+    0xf298bd09360c070aull, 0xfbae9056fbc8e31full, 0xabc8b478e17b9316ull,
+    0x1348b85dea5e2a1aull,
+  };
+  const std::string path = std::string(NFB_ASSET_DIR) + "/unread_logo.gif";
+  std::ifstream in(path, std::ios::binary);
+  NFB_REQUIRE(in.good());
+  const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  GifDecoder decoder;
+  NFB_REQUIRE(decoder.Open(bytes.data(), bytes.size()));
+  NFB_CHECK_EQ(decoder.Width(), 976u);
+  NFB_CHECK_EQ(decoder.Height(), 720u);
+  NFB_REQUIRE(decoder.FrameCount() == sizeof(kFrameHashes) / sizeof(kFrameHashes[0]));
+  size_t index = 0;
+  while (const uint8_t* canvas = decoder.ComposeNext()) {
+    if (Fnv1a(canvas, (size_t)976 * 720 * 4) != kFrameHashes[index]) {
+      ReportFailure(__FILE__, __LINE__, "unread_logo.gif frame " + std::to_string(index) + " differs from reference");
+    }
+    NFB_CHECK_EQ(decoder.DelayMs(index), index % 3 == 1 ? 90u : 80u); // 图形控制扩展里是 8、9、8 厘秒循环
+    ++index;
+  }
+  NFB_CHECK_EQ(index, decoder.FrameCount());
+}
+
+NFB_TEST(GifDecoder, DisplayFramesStreamMatchesBuild) {
+  // 悬浮球经 Begin/AddCanvas/Finish 输入 WIC 合成的画布；与 Build（本解码器）走的是同一条缩放蒙版路径
+  const std::vector<uint32_t> palette = Palette(16, 50);
+  std::vector<FrameSpec> frames;
+  for (int i = 0; i < 3; ++i) {
+    FrameSpec frame;
+    frame.left = (uint16_t)(i * 4), frame.top = (uint16_t)(i * 3), frame.width = 30, frame.height = 20;
+    frame.indices = RandomIndices(600, 16, 51 + i);
+    frame.transparent = 0;
+    frame.disposal = (uint8_t)(i + 1);
+    frame.delayCs = 4 + i;
+    frames.push_back(frame);
+  }
+  const std::vector<uint8_t> gif = BuildGif(40, 30, palette, frames);
+  CircleMask mask;
+  mask.Build(24);
+  DisplayFrames built;
+  NFB_REQUIRE(built.Build(gif.data(), gif.size(), mask));
+
+  DisplayFrames streamed;
+  NFB_REQUIRE(streamed.Begin(40, 30, mask, 3));
+  const std::vector<std::vector<uint8_t>> canvases = ReferenceCanvases(40, 30, palette, frames);
+  for (size_t i = 0; i < canvases.size(); ++i) streamed.AddCanvas(canvases[i].data(), 40 * 4, (uint32_t)(40 + i * 10));
+  NFB_REQUIRE(streamed.Finish());
+
+  NFB_CHECK_EQ(streamed.FrameCount(), 3u);
+  NFB_CHECK(streamed.DelaysMs() == built.DelaysMs());
+  NFB_CHECK_EQ(streamed.SourceWidth(), 40u);
+  for (size_t i = 0; i < 3; ++i) NFB_CHECK(std::memcmp(streamed.Frame(i), built.Frame(i), built.FrameBytes()) == 0);
+  for (uint32_t y = 0; y < 24; ++y) {
+    for (uint32_t x = 0; x < 24; ++x) NFB_CHECK_EQ(streamed.Hit().Contains((int)x, (int)y), built.Hit().Contains((int)x, (int)y));
+  }
+
+  // 没有帧时 Finish 失败并清空；直径为 0 的蒙版不能开始
+  DisplayFrames empty;
+  NFB_REQUIRE(empty.Begin(40, 30, mask, 0));
+  NFB_CHECK(!empty.Finish());
+  NFB_CHECK_EQ(empty.Diameter(), 0u);
+  NFB_CHECK(!empty.Begin(40, 30, CircleMask(), 1));
+}
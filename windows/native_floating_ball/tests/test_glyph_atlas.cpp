@@ -0,0 +1,96 @@
+// 字形图集与排版缓存：一组可见行必须引用同一代图集（气泡把整组行的字形一次性从纹理里取）
+#include <string>
+#include <vector>
+#include "test_harness.h"
+#include "core/glyph_atlas.h"
+
+namespace {
+
+// 每个码点一个 7x7 方块，覆盖率取码点低 8 位（非 0），便于核对字形位于图集的哪个格子
+class BlockRasterizer : public GlyphRasterizer {
+public:
+  bool Rasterize(uint32_t codepoint, float, GlyphBitmap* out) override {
+    out->width = out->height = 7;
+    out->left = 0;
+    out->top = 7;
+    out->advance = 8.f;
+    out->coverage.assign(49, (uint8_t)((codepoint & 0x7F) | 0x80));
+    return true;
+  }
+  float Ascent(float) const override { return 7.f; }
+  float LineHeight(float) const override { return 9.f; }
+};
+
+constexpr float kSize = 13.f;
+constexpr float kWide = 10000.f; // 不截断
+
+// 行里的每个字形都能在当前图集的同一位置找到，且那里的像素就是该码点
+bool LineMatchesAtlas(const ShapedLine& line, std::u16string_view text, GlyphAtlas& atlas, BlockRasterizer& raster) {
+  if (line.atlasGeneration != atlas.Generation() || line.glyphs.size() != text.size()) return false;
+  for (size_t i = 0; i < text.size(); ++i) {
+    const GlyphEntry& placed = line.glyphs[i].glyph;
+    const GlyphEntry* current = atlas.Get(raster, text[i], kSize, 96);
+    if (!current || current->x != placed.x || current->y != placed.y) return false;
+    if (atlas.Pixels()[(size_t)placed.y * atlas.Width() + placed.x] != (uint8_t)((text[i] & 0x7F) | 0x80)) return false;
+  }
+  return true;
+}
+
+} // namespace
+
+NFB_TEST(GlyphAtlas, ConsistentAfterResetMidFrame) {
+  // 32x32 图集放得下 16 个 7x7 字形（含 1px 间隔）。先占 12 格，第一行再占满 4 格，
+  // 第二行的第一个字形触发清空：第一行手里的位置全部失效，必须整组重排
+  GlyphAtlas atlas(32, 32);
+  BlockRasterizer raster;
+  for (uint32_t cp = 0x100; cp < 0x10C; ++cp) atlas.Get(raster, cp, kSize, 96);
+  ShapedTextCache cache;
+  const std::vector<std::u16string_view> texts = { u"abcd", u"efgh" };
+  std::vector<const ShapedLine*> lines;
+  const uint32_t before = atlas.Generation();
+  NFB_REQUIRE(cache.GetConsistent(atlas, raster, texts, kSize, 96, kWide, &lines));
+  NFB_CHECK(atlas.Generation() != before);
+  NFB_REQUIRE(lines.size() == 2);
+  NFB_CHECK(LineMatchesAtlas(*lines[0], texts[0], atlas, raster));
+  NFB_CHECK(LineMatchesAtlas(*lines[1], texts[1], atlas, raster));
+
+  // 下一帧：同一组行直接命中，图集不再变化
+  const uint32_t settled = atlas.Generation();
+  NFB_REQUIRE(cache.GetConsistent(atlas, raster, texts, kSize, 96, kWide, &lines));
+  NFB_CHECK_EQ(atlas.Generation(), settled);
+}
+
+NFB_TEST(GlyphAtlas, ConsistentWhenLaterLinesResetRepeatedly) {
+  // 三行各 5 个字形，合计 15 格放得下；但图集先被占到只剩 3 格，每一行都可能在排版中途触发清空
+  GlyphAtlas atlas(32, 32);
+  BlockRasterizer raster;
+  for (uint32_t cp = 0x100; cp < 0x10D; ++cp) atlas.Get(raster, cp, kSize, 96);
+  ShapedTextCache cache;
+  // 先让第三行以旧一代图集缓存下来
+  cache.Get(atlas, raster, u"klmno", kSize, 96, kWide);
+  const std::vector<std::u16string_view> texts = { u"abcde", u"fghij", u"klmno" };
+  std::vector<const ShapedLine*> lines;
+  NFB_REQUIRE(cache.GetConsistent(atlas, raster, texts, kSize, 96, kWide, &lines));
+  NFB_REQUIRE(lines.size() == 3);
+  for (size_t i = 0; i < 3; ++i) NFB_CHECK(LineMatchesAtlas(*lines[i], texts[i], atlas, raster));
+}
+
+NFB_TEST(GlyphAtlas, ReportsSetsThatDoNotFit) {
+  // 三行各 6 个不同字形共 18 格，一张 16 格的图集放不下：每一遍都会清空，应当放弃并交给调用方降级
+  GlyphAtlas atlas(32, 32);
+  BlockRasterizer raster;
+  ShapedTextCache cache;
+  const std::vector<std::u16string_view> texts = { u"abcdef", u"ghijkl", u"mnopqr" };
+  std::vector<const ShapedLine*> lines;
+  NFB_CHECK(!cache.GetConsistent(atlas, raster, texts, kSize, 96, kWide, &lines));
+  NFB_CHECK(lines.empty());
+}
+
+NFB_TEST(GlyphAtlas, SingleLineSurvivesReset) {
+  GlyphAtlas atlas(32, 32);
+  BlockRasterizer raster;
+  for (uint32_t cp = 0x100; cp < 0x10E; ++cp) atlas.Get(raster, cp, kSize, 96);
+  ShapedLine line;
+  ShapeLine(atlas, raster, u"wxyz", kSize, 96, kWide, &line);
+  NFB_CHECK(LineMatchesAtlas(line, u"wxyz", atlas, raster));
+}
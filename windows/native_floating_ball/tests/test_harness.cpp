@@ -0,0 +1,98 @@
+#include "test_harness.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define NFB_GETPID _getpid
+#else
+#include <unistd.h>
+#define NFB_GETPID getpid
+#endif
+
+namespace {
+
+struct TestEntry {
+  std::string name;
+  TestFn fn;
+};
+
+std::vector<TestEntry>& Registry() {
+  static std::vector<TestEntry> registry;
+  return registry;
+}
+
+// 当前用例的失败次数；每条失败在发生时立即打印
+int g_failures = 0;
+constexpr int kMaxReportedFailures = 20; // 单个用例失败过多时只打印前几条（循环里的检查）
+
+} // namespace
+
+void RegisterTest(const std::string& name, TestFn fn) {
+  Registry().push_back(TestEntry{ name, std::move(fn) });
+}
+
+void ReportFailure(const char* file, int line, const std::string& message) {
+  if (++g_failures <= kMaxReportedFailures) {
+    std::printf("  %s:%d: check failed: %s\n", file, line, message.c_str());
+  } else if (g_failures == kMaxReportedFailures + 1) {
+    std::printf("  ... further failures suppressed\n");
+  }
+}
+
+TestTempDir::TestTempDir(const char* tag) {
+  static int counter = 0;
+  std::error_code ec;
+  std::filesystem::path dir = std::filesystem::temp_directory_path(ec);
+  if (ec) dir = ".";
+  dir /= std::string("nfb_test_") + tag + "_" + std::to_string((long long)NFB_GETPID()) + "_" + std::to_string(++counter);
+  std::filesystem::remove_all(dir, ec);
+  std::filesystem::create_directories(dir, ec);
+  m_path = dir.u8string();
+}
+
+TestTempDir::~TestTempDir() {
+  std::error_code ec;
+  std::filesystem::remove_all(std::filesystem::u8path(m_path), ec);
+}
+
+int RunTests(int argc, char** argv) {
+  std::string filter;
+  for (int i = 1; i < argc; ++i) {
+    const char* a = argv[i];
+    if (std::strncmp(a, "--filter=", 9) == 0) filter = a + 9;
+    else if (std::strcmp(a, "--list") == 0) {
+      for (const auto& e : Registry()) std::printf("%s\n", e.name.c_str());
+      return 0;
+    } else {
+      std::fprintf(stderr, "usage: %s [--filter=substr] [--list]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  int run = 0, failed = 0;
+  for (const auto& e : Registry()) {
+    if (!filter.empty() && e.name.find(filter) == std::string::npos) continue;
+    std::printf("[ RUN  ] %s\n", e.name.c_str());
+    std::fflush(stdout);
+    g_failures = 0;
+    const auto start = std::chrono::steady_clock::now();
+    e.fn();
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    ++run;
+    if (g_failures) ++failed;
+    std::printf("[ %s ] %s (%.1f ms)\n", g_failures ? "FAIL" : "  OK", e.name.c_str(), ms);
+    std::fflush(stdout);
+  }
+  if (run == 0) {
+    std::fprintf(stderr, "no tests match '%s'\n", filter.c_str());
+    return 1;
+  }
+  std::printf("%d test(s), %d failed\n", run, failed);
+  return failed ? 1 : 0;
+}
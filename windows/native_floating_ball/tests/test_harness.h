@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// 极简单元测试框架（与 bench 一样不引入第三方依赖）：
+//
+//   NFB_TEST(TaskWire, RoundTrip) {
+//     NFB_CHECK(reader.Open(data, size));          // 失败时记录并继续
+//     NFB_CHECK_EQ(view.priority, 2);              // 整数/枚举失败时打印两边的值
+//     NFB_REQUIRE(!items.empty());                 // 失败时结束当前用例
+//   }
+//
+// 用例名为 "<Suite>.<Name>"；--filter=子串 只运行匹配的用例。ctest 按 suite 分别注册（见 CMakeLists.txt），
+// 任一检查失败时进程退出码为 1。
+using TestFn = std::function<void()>;
+
+void RegisterTest(const std::string& name, TestFn fn);
+// 记录一次失败（文件:行 + 表达式 + 可选的附加说明）
+void ReportFailure(const char* file, int line, const std::string& message);
+int RunTests(int argc, char** argv);
+
+// 用例独占的临时目录（系统临时目录下按进程号与序号命名），析构时连同内容删除。路径为 UTF-8。
+class TestTempDir {
+public:
+  explicit TestTempDir(const char* tag);
+  ~TestTempDir();
+  TestTempDir(const TestTempDir&) = delete;
+  TestTempDir& operator=(const TestTempDir&) = delete;
+
+  const std::string& Path() const { return m_path; }
+  std::string File(const std::string& name) const { return m_path + "/" + name; }
+
+private:
+  std::string m_path;
+};
+
+struct TestRegistrar {
+  TestRegistrar(const char* name, TestFn fn) { RegisterTest(name, std::move(fn)); }
+};
+
+template <typename T>
+std::string TestValueString(const T& value) {
+  if constexpr (std::is_enum_v<T>) {
+    return std::to_string((long long)value);
+  } else if constexpr (std::is_same_v<T, bool>) {
+    return value ? "true" : "false";
+  } else if constexpr (std::is_integral_v<T>) {
+    if constexpr (std::is_signed_v<T>) return std::to_string((long long)value);
+    else return std::to_string((unsigned long long)value);
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return std::to_string((double)value);
+  } else {
+    return "?";
+  }
+}
+
+template <typename A, typename B>
+bool CheckEqual(const A& a, const B& b, const char* file, int line, const char* expr) {
+  bool equal;
+  if constexpr (std::is_integral_v<A> && std::is_integral_v<B> && !std::is_same_v<A, bool> && !std::is_same_v<B, bool>) {
+    // 有符号/无符号混合比较按数学值
+    if constexpr (std::is_signed_v<A> == std::is_signed_v<B>) equal = a == b;
+    else if constexpr (std::is_signed_v<A>) equal = a >= 0 && (unsigned long long)a == (unsigned long long)b;
+    else equal = b >= 0 && (unsigned long long)a == (unsigned long long)b;
+  } else {
+    equal = a == b;
+  }
+  if (!equal) ReportFailure(file, line, std::string(expr) + " (" + TestValueString(a) + " vs " + TestValueString(b) + ")");
+  return equal;
+}
+
+#define NFB_TEST_CONCAT2(a, b) a##b
+#define NFB_TEST_CONCAT(a, b) NFB_TEST_CONCAT2(a, b)
+#define NFB_TEST(suite, name)                                                                         \
+  static void NFB_TEST_CONCAT(nfb_test_, NFB_TEST_CONCAT(suite, NFB_TEST_CONCAT(_, name)))();         \
+  static TestRegistrar NFB_TEST_CONCAT(nfb_test_reg_, NFB_TEST_CONCAT(suite, NFB_TEST_CONCAT(_, name)))( \
+      #suite "." #name, &NFB_TEST_CONCAT(nfb_test_, NFB_TEST_CONCAT(suite, NFB_TEST_CONCAT(_, name)))); \
+  static void NFB_TEST_CONCAT(nfb_test_, NFB_TEST_CONCAT(suite, NFB_TEST_CONCAT(_, name)))()
+
+#define NFB_CHECK(cond) \
+  ((cond) ? true : (ReportFailure(__FILE__, __LINE__, #cond), false))
+#define NFB_CHECK_EQ(a, b) CheckEqual((a), (b), __FILE__, __LINE__, #a " == " #b)
+#define NFB_REQUIRE(cond)                          \
+  do {                                             \
+    if (!(cond)) {                                 \
+      ReportFailure(__FILE__, __LINE__, #cond);    \
+      return;                                      \
+    }                                              \
+  } while (0)
@@ -0,0 +1,162 @@
+// HDR 直方图：分桶边界与每桶的相对误差、已知分布（均匀 / 指数 / 双峰 / 常数）的 p50 / p99 与精确分位数之差
+// 不超过声明的 1/32、最小 / 最大与空直方图、超出 2^kMaxBits 的值落进最后一桶、Merge 与 Reset。
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "test_harness.h"
+#include "core/hdr_histogram.h"
+
+namespace {
+
+constexpr uint64_t kMaxValue = (1ull << HdrHistogram::kMaxBits) - 1;
+// 头文件声明的相对误差上界：1 / (kSubBuckets / 2)
+constexpr double kRelativeError = 1.0 / (HdrHistogram::kSubBuckets / 2);
+
+// 与 Percentile 相同的秩：第 (p * (n - 1)) + 1 小的值
+uint64_t ExactPercentile(const std::vector<uint64_t>& sorted, double p) {
+  return sorted[(size_t)(p * (double)(sorted.size() - 1))];
+}
+
+// 直方图分位数不小于精确值（取桶上界，偏保守），且多出的部分不超过精确值的 kRelativeError
+void CheckPercentiles(const std::string& name, std::vector<uint64_t> values) {
+  HdrHistogram h;
+  for (uint64_t v : values) h.Record(v);
+  std::sort(values.begin(), values.end());
+  for (double p : { 0.5, 0.99 }) {
+    const uint64_t exact = ExactPercentile(values, p);
+    const uint64_t got = h.Percentile(p);
+    if (got < exact || (double)(got - exact) > (double)exact * kRelativeError) {
+      ReportFailure(__FILE__, __LINE__, name + " p" + std::to_string((int)(p * 100)) + ": histogram " +
+                                            std::to_string(got) + ", exact " + std::to_string(exact));
+    }
+  }
+  if (h.Min() != values.front() || h.Max() != values.back()) {
+    ReportFailure(__FILE__, __LINE__, name + ": min / max differ from the samples");
+  }
+}
+
+// 由原始 64 位随机数构造 (0, 1) 的均匀数，不依赖各标准库实现不同的分布类
+double Uniform01(std::mt19937_64& rng) {
+  return ((double)(rng() >> 11) + 0.5) / 9007199254740992.0;
+}
+
+} // namespace
+
+NFB_TEST(HdrHistogram, BucketsCoverValuesWithinRelativeError) {
+  NFB_CHECK_EQ(HdrHistogram::kBucketCount, 64u + 34u * 32u);
+  NFB_CHECK_EQ(HdrHistogram::BucketUpper(HdrHistogram::kBucketCount - 1), kMaxValue);
+  // 小于 kSubBuckets 的值逐一计数
+  for (uint64_t v = 0; v < HdrHistogram::kSubBuckets; ++v) {
+    NFB_CHECK_EQ(HdrHistogram::BucketOf(v), (size_t)v);
+    NFB_CHECK_EQ(HdrHistogram::BucketUpper((size_t)v), v);
+  }
+  // 桶首尾相接：每个桶上界的下一个值落在下一个桶
+  for (size_t i = 0; i + 1 < HdrHistogram::kBucketCount; ++i) {
+    const uint64_t upper = HdrHistogram::BucketUpper(i);
+    NFB_CHECK_EQ(HdrHistogram::BucketOf(upper), i);
+    NFB_CHECK_EQ(HdrHistogram::BucketOf(upper + 1), i + 1);
+  }
+  // 每桶宽度不超过桶内最小值的 1/32
+  for (size_t i = HdrHistogram::kSubBuckets; i < HdrHistogram::kBucketCount; ++i) {
+    const uint64_t lower = HdrHistogram::BucketUpper(i - 1) + 1;
+    NFB_CHECK((double)(HdrHistogram::BucketUpper(i) - lower) <= (double)lower * kRelativeError);
+  }
+}
+
+NFB_TEST(HdrHistogram, PercentilesOfKnownDistributions) {
+  std::mt19937_64 rng(48);
+  std::vector<uint64_t> uniform, exponential, bimodal;
+  for (int i = 0; i < 100000; ++i) {
+    uniform.push_back(1000 + (uint64_t)(Uniform01(rng) * 9000000.0));               // 1µs..9ms（纳秒）
+    exponential.push_back((uint64_t)(-std::log(Uniform01(rng)) * 4000000.0));        // 均值 4ms
+    bimodal.push_back(i % 50 == 0 ? 250000000 + i : 16000000 + (uint64_t)(i % 997)); // 2% 的帧卡 250ms
+  }
+  CheckPercentiles("uniform", uniform);
+  CheckPercentiles("exponential", exponential);
+  CheckPercentiles("bimodal", bimodal);
+  CheckPercentiles("constant", std::vector<uint64_t>(1000, 33333333));
+  CheckPercentiles("small", std::vector<uint64_t>{ 3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5 }); // 逐一计数，精确
+
+  // 均匀分布的理论分位数：与样本分位数一样落在误差内
+  HdrHistogram h;
+  for (uint64_t v : uniform) h.Record(v);
+  NFB_CHECK(std::fabs((double)h.Percentile(0.5) - 4501000.0) <= 4501000.0 * (kRelativeError + 0.01));
+  NFB_CHECK(std::fabs((double)h.Percentile(0.99) - 8911000.0) <= 8911000.0 * (kRelativeError + 0.01));
+  NFB_CHECK(std::fabs(h.Mean() - 4501000.0) <= 4501000.0 * 0.01); // 均值按原始值累加，不受分桶影响
+}
+
+NFB_TEST(HdrHistogram, MinMaxAndEmpty) {
+  HdrHistogram h;
+  NFB_CHECK_EQ(h.Count(), 0u);
+  NFB_CHECK_EQ(h.Min(), 0u);
+  NFB_CHECK_EQ(h.Max(), 0u);
+  NFB_CHECK_EQ(h.Percentile(0.5), 0u);
+  NFB_CHECK(h.Mean() == 0.0);
+
+  h.Record(1000003);
+  NFB_CHECK_EQ(h.Min(), 1000003u);
+  NFB_CHECK_EQ(h.Max(), 1000003u);
+  // 桶上界不超过 Max：只有一个样本时各分位数就是它本身
+  NFB_CHECK_EQ(h.Percentile(0.0), 1000003u);
+  NFB_CHECK_EQ(h.Percentile(1.0), 1000003u);
+
+  h.Record(7);
+  h.Record(0);
+  h.Record(123456789);
+  NFB_CHECK_EQ(h.Count(), 4u);
+  NFB_CHECK_EQ(h.Min(), 0u);
+  NFB_CHECK_EQ(h.Max(), 123456789u);
+  NFB_CHECK_EQ(h.Percentile(0.0), 0u);
+  NFB_CHECK_EQ(h.Percentile(-1.0), 0u); // p 夹到 [0, 1]
+  NFB_CHECK_EQ(h.Percentile(2.0), 123456789u);
+}
+
+NFB_TEST(HdrHistogram, ValuesBeyondRangeLandInLastBucket) {
+  const size_t last = HdrHistogram::kBucketCount - 1;
+  NFB_CHECK_EQ(HdrHistogram::BucketOf(kMaxValue), last);
+  NFB_CHECK_EQ(HdrHistogram::BucketOf(kMaxValue + 1), last);
+  NFB_CHECK_EQ(HdrHistogram::BucketOf(UINT64_MAX), last);
+  NFB_CHECK(HdrHistogram::BucketOf(kMaxValue / 2) < last);
+
+  HdrHistogram h;
+  for (int i = 0; i < 99; ++i) h.Record(5000);
+  h.Record(kMaxValue * 4);
+  NFB_CHECK_EQ(h.Count(), 100u);
+  // Min / Max / Mean 按原始值；分位数按最大可记录值计
+  NFB_CHECK_EQ(h.Max(), kMaxValue * 4);
+  NFB_CHECK(h.Mean() > (double)kMaxValue / 25);
+  NFB_CHECK_EQ(h.Percentile(1.0), kMaxValue);
+  NFB_CHECK(h.Percentile(0.98) <= 5000u + 5000u / 32);
+
+  h.Record(UINT64_MAX); // 不会越界写
+  NFB_CHECK_EQ(h.Count(), 101u);
+  NFB_CHECK_EQ(h.Max(), UINT64_MAX);
+  NFB_CHECK_EQ(h.Percentile(1.0), kMaxValue);
+}
+
+NFB_TEST(HdrHistogram, MergeAndReset) {
+  HdrHistogram a, b, all;
+  for (uint64_t v = 1; v <= 3000; ++v) {
+    (v % 3 ? a : b).Record(v * 977);
+    all.Record(v * 977);
+  }
+  HdrHistogram empty;
+  a.Merge(empty); // 合并空直方图不改变 Min
+  NFB_CHECK_EQ(a.Min(), 977u);
+  a.Merge(b);
+  NFB_CHECK_EQ(a.Count(), all.Count());
+  NFB_CHECK_EQ(a.Min(), all.Min());
+  NFB_CHECK_EQ(a.Max(), all.Max());
+  NFB_CHECK(a.Mean() == all.Mean());
+  for (double p : { 0.0, 0.1, 0.5, 0.9, 0.99, 0.999, 1.0 }) NFB_CHECK_EQ(a.Percentile(p), all.Percentile(p));
+
+  a.Reset();
+  NFB_CHECK_EQ(a.Count(), 0u);
+  NFB_CHECK_EQ(a.Min(), 0u);
+  NFB_CHECK_EQ(a.Max(), 0u);
+  a.Record(42);
+  NFB_CHECK_EQ(a.Min(), 42u); // Reset 后最小值重新开始
+  NFB_CHECK_EQ(a.Percentile(0.5), 42u);
+}
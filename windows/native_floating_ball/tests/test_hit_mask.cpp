@@ -0,0 +1,135 @@
+// 命中区域：随机 alpha 平面上与逐像素阈值判断一致、越界坐标、每行区间有序且互不相邻、空输入与重建。
+#include <climits>
+#include <random>
+#include <vector>
+#include "test_harness.h"
+#include "core/hit_mask.h"
+
+namespace {
+
+// 每行区间合法：在宽度之内、非空、按 x 升序且相邻区间之间至少隔一个透明像素
+bool SpansWellFormed(const HitMask& mask) {
+  size_t total = 0;
+  for (uint32_t y = 0; y < mask.Height(); ++y) {
+    const HitMask::Span* prev = nullptr;
+    for (const HitMask::Span* span = mask.RowBegin(y); span != mask.RowEnd(y); ++span) {
+      if (span->first >= span->last || span->last > mask.Width()) return false;
+      if (prev && prev->last >= span->first) return false;
+      prev = span;
+      ++total;
+    }
+  }
+  return total == mask.SpanCount();
+}
+
+// 一行里不低于阈值的连续段数
+size_t RunCount(const uint8_t* row, uint32_t width, size_t pixelStride, uint8_t minAlpha) {
+  size_t runs = 0;
+  bool inside = false;
+  for (uint32_t x = 0; x < width; ++x) {
+    const bool opaque = row[x * pixelStride] >= minAlpha;
+    if (opaque && !inside) ++runs;
+    inside = opaque;
+  }
+  return runs;
+}
+
+} // namespace
+
+NFB_TEST(HitMask, MatchesThresholdOnRandomPlanes) {
+  std::mt19937 rng(5);
+  const uint8_t thresholds[] = { 0, 1, 32, 128, 255 };
+  for (int iteration = 0; iteration < 200; ++iteration) {
+    const uint32_t width = 1 + rng() % 70, height = 1 + rng() % 40;
+    const bool bgra = iteration % 2 == 0;
+    const size_t pixelStride = bgra ? 4 : 1;
+    const size_t rowStride = width * pixelStride + rng() % 9;
+    // 大片透明/不透明夹杂随机值，区间既有长的也有单像素的
+    std::vector<uint8_t> plane(rowStride * height);
+    for (uint8_t& v : plane) {
+      const uint32_t r = rng() % 4;
+      v = r == 0 ? 0 : r == 1 ? 255 : (uint8_t)rng();
+    }
+    const uint8_t* alpha = plane.data() + (bgra ? 3 : 0);
+    const uint8_t minAlpha = thresholds[iteration % 5];
+    HitMask mask;
+    mask.Build(alpha, width, height, rowStride, pixelStride, minAlpha);
+    NFB_CHECK_EQ(mask.Width(), width);
+    NFB_CHECK_EQ(mask.Height(), height);
+    NFB_CHECK(SpansWellFormed(mask));
+    for (uint32_t y = 0; y < height; ++y) {
+      const uint8_t* row = alpha + y * rowStride;
+      NFB_CHECK_EQ((size_t)(mask.RowEnd(y) - mask.RowBegin(y)), RunCount(row, width, pixelStride, minAlpha));
+      for (uint32_t x = 0; x < width; ++x) {
+        NFB_CHECK_EQ(mask.Contains((int)x, (int)y), row[x * pixelStride] >= minAlpha);
+      }
+    }
+  }
+}
+
+NFB_TEST(HitMask, OutOfBoundsIsTransparent) {
+  std::vector<uint8_t> plane(6 * 4, 255);
+  HitMask mask;
+  mask.Build(plane.data(), 6, 4, 6, 1);
+  NFB_CHECK(mask.Contains(0, 0) && mask.Contains(5, 3));
+  const int outside[][2] = { { -1, 0 }, { 0, -1 }, { 6, 0 }, { 0, 4 }, { 6, 4 }, { INT_MIN, 0 }, { 0, INT_MAX }, { INT_MAX, INT_MAX } };
+  for (const auto& p : outside) NFB_CHECK(!mask.Contains(p[0], p[1]));
+}
+
+NFB_TEST(HitMask, DefaultThresholdSkipsFaintEdges) {
+  const uint8_t row[] = { 0, 31, 32, 200, 31, 255, 255, 1 };
+  HitMask mask;
+  mask.Build(row, 8, 1, 8, 1);
+  NFB_REQUIRE(mask.SpanCount() == 2);
+  NFB_CHECK_EQ(mask.RowBegin(0)[0].first, 2);
+  NFB_CHECK_EQ(mask.RowBegin(0)[0].last, 4);
+  NFB_CHECK_EQ(mask.RowBegin(0)[1].first, 5);
+  NFB_CHECK_EQ(mask.RowBegin(0)[1].last, 7);
+}
+
+NFB_TEST(HitMask, EmptyInputsAndRebuild) {
+  std::vector<uint8_t> plane(16, 255);
+  HitMask mask;
+  NFB_CHECK(mask.Empty());
+  NFB_CHECK(!mask.Contains(0, 0));
+  const struct {
+    const uint8_t* alpha;
+    uint32_t width, height;
+  } empty[] = { { nullptr, 4, 4 }, { plane.data(), 0, 4 }, { plane.data(), 4, 0 }, { plane.data(), 0x10000, 1 } };
+  for (const auto& input : empty) {
+    mask.Build(plane.data(), 4, 4, 4, 1); // 先有内容，确认失败的构建会清空
+    NFB_REQUIRE(!mask.Empty());
+    mask.Build(input.alpha, input.width, input.height, 4, 1);
+    NFB_CHECK(mask.Empty());
+    NFB_CHECK_EQ(mask.Width(), 0u);
+    NFB_CHECK_EQ(mask.Height(), 0u);
+    NFB_CHECK(!mask.Contains(0, 0));
+  }
+
+  // 全透明的平面：尺寸有效但没有区间
+  const std::vector<uint8_t> clear(16, 0);
+  mask.Build(clear.data(), 4, 4, 4, 1);
+  NFB_CHECK(mask.Empty());
+  NFB_CHECK_EQ(mask.Width(), 4u);
+  for (int y = 0; y < 4; ++y) {
+    NFB_CHECK(mask.RowBegin((uint32_t)y) == mask.RowEnd((uint32_t)y));
+    for (int x = 0; x < 4; ++x) NFB_CHECK(!mask.Contains(x, y));
+  }
+
+  // 重建不残留上一次的区间
+  std::mt19937 rng(9);
+  std::vector<uint8_t> a(30 * 20), b(12 * 7);
+  for (uint8_t& v : a) v = (uint8_t)rng();
+  for (uint8_t& v : b) v = (uint8_t)rng();
+  HitMask fresh;
+  fresh.Build(b.data(), 12, 7, 12, 1);
+  mask.Build(a.data(), 30, 20, 30, 1);
+  mask.Build(b.data(), 12, 7, 12, 1);
+  NFB_CHECK_EQ(mask.SpanCount(), fresh.SpanCount());
+  for (int y = -1; y <= 7; ++y) {
+    for (int x = -1; x <= 12; ++x) NFB_CHECK_EQ(mask.Contains(x, y), fresh.Contains(x, y));
+  }
+  mask.Clear();
+  NFB_CHECK(mask.Empty());
+  NFB_CHECK(!mask.Contains(0, 0));
+}
@@ -0,0 +1,129 @@
+#include "test_json.h"
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+class JsonParser {
+public:
+  explicit JsonParser(const std::string& text) : m_p(text.c_str()), m_end(text.c_str() + text.size()) {}
+
+  bool ParseDocument(Json* out) {
+    if (!Value(out)) return false;
+    Skip();
+    return m_p == m_end;
+  }
+
+private:
+  void Skip() {
+    while (m_p < m_end && (*m_p == ' ' || *m_p == '\n' || *m_p == '\r' || *m_p == '\t')) ++m_p;
+  }
+  bool Literal(const char* word) {
+    const size_t n = std::char_traits<char>::length(word);
+    if ((size_t)(m_end - m_p) < n || std::string(m_p, n) != word) return false;
+    m_p += n;
+    return true;
+  }
+  bool Value(Json* out) {
+    Skip();
+    if (m_p >= m_end) return false;
+    switch (*m_p) {
+    case '{': return Object(out);
+    case '[': return Array(out);
+    case '"': out->type = Json::Type::String; return String(&out->string);
+    case 't': out->type = Json::Type::Bool; out->boolean = true; return Literal("true");
+    case 'f': out->type = Json::Type::Bool; return Literal("false");
+    case 'n': return Literal("null");
+    default: {
+      char* numberEnd = nullptr;
+      out->number = std::strtod(m_p, &numberEnd);
+      if (numberEnd == m_p) return false;
+      out->type = Json::Type::Number;
+      m_p = numberEnd;
+      return true;
+    }
+    }
+  }
+  bool Object(Json* out) {
+    out->type = Json::Type::Object;
+    ++m_p;
+    Skip();
+    if (m_p < m_end && *m_p == '}') { ++m_p; return true; }
+    for (;;) {
+      Skip();
+      std::string key;
+      if (m_p >= m_end || *m_p != '"' || !String(&key)) return false;
+      Skip();
+      if (m_p >= m_end || *m_p++ != ':') return false;
+      if (out->object.count(key) || !Value(&out->object[key])) return false; // 重复键也算错误
+      Skip();
+      if (m_p >= m_end) return false;
+      if (*m_p == ',') { ++m_p; continue; }
+      if (*m_p == '}') { ++m_p; return true; }
+      return false;
+    }
+  }
+  bool Array(Json* out) {
+    out->type = Json::Type::Array;
+    ++m_p;
+    Skip();
+    if (m_p < m_end && *m_p == ']') { ++m_p; return true; }
+    for (;;) {
+      out->array.emplace_back();
+      if (!Value(&out->array.back())) return false;
+      Skip();
+      if (m_p >= m_end) return false;
+      if (*m_p == ',') { ++m_p; continue; }
+      if (*m_p == ']') { ++m_p; return true; }
+      return false;
+    }
+  }
+  bool String(std::string* out) {
+    ++m_p;
+    while (m_p < m_end && *m_p != '"') {
+      const unsigned char c = (unsigned char)*m_p++;
+      if (c < 0x20) return false; // 控制字符必须转义
+      if (c != '\\') { *out += (char)c; continue; }
+      if (m_p >= m_end) return false;
+      const char e = *m_p++;
+      switch (e) {
+      case '"': case '\\': case '/': *out += e; break;
+      case 'b': *out += '\b'; break;
+      case 'f': *out += '\f'; break;
+      case 'n': *out += '\n'; break;
+      case 'r': *out += '\r'; break;
+      case 't': *out += '\t'; break;
+      case 'u': {
+        if (m_end - m_p < 4) return false;
+        const unsigned long cp = std::strtoul(std::string(m_p, 4).c_str(), nullptr, 16);
+        m_p += 4;
+        if (cp < 0x80) {
+          *out += (char)cp;
+        } else if (cp < 0x800) {
+          *out += (char)(0xC0 | (cp >> 6));
+          *out += (char)(0x80 | (cp & 0x3F));
+        } else {
+          *out += (char)(0xE0 | (cp >> 12));
+          *out += (char)(0x80 | ((cp >> 6) & 0x3F));
+          *out += (char)(0x80 | (cp & 0x3F));
+        }
+        break;
+      }
+      default: return false;
+      }
+    }
+    if (m_p >= m_end) return false;
+    ++m_p;
+    return true;
+  }
+
+  const char* m_p;
+  const char* m_end;
+};
+
+} // namespace
+
+bool ParseJson(const std::string& text, Json* out) {
+  *out = Json{};
+  return JsonParser(text).ParseDocument(out);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+// 测试用的 JSON 读取（导出格式的校验共用）：对象、数组、字符串（含 \uXXXX，BMP 内转 UTF-8）、数字、true/false/null。
+// 严格：多余的尾随内容、未转义的控制字符、重复键都算错误。
+struct Json {
+  enum class Type { Null, Bool, Number, String, Array, Object } type{Type::Null};
+  double number{0};
+  bool boolean{false};
+  std::string string;
+  std::vector<Json> array;
+  std::map<std::string, Json> object;
+
+  bool Has(const std::string& key) const { return object.count(key) != 0; }
+  const Json& operator[](const std::string& key) const { return object.at(key); }
+};
+
+bool ParseJson(const std::string& text, Json* out);
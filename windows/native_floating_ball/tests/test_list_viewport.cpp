@@ -0,0 +1,104 @@
+// 气泡列表视口：内容/首选高度、滚动钳制、ScrollBy 的返回值、RowAt 的命中范围（行间距对半分）与可见区间。
+#include <cmath>
+#include <random>
+#include "test_harness.h"
+#include "core/list_viewport.h"
+
+namespace {
+
+// 默认几何：内边距 10、行高 24、行距 4（行节距 28）
+ListViewport Viewport(int items, float height, float scroll = 0.f) {
+  ListViewport view;
+  view.itemCount = items;
+  view.viewportHeight = height;
+  view.scrollOffset = scroll;
+  return view;
+}
+
+} // namespace
+
+NFB_TEST(ListViewport, Heights) {
+  NFB_CHECK_EQ(Viewport(0, 0).ContentHeight(), 20.f);
+  NFB_CHECK_EQ(Viewport(3, 0).ContentHeight(), 100.f);
+  // 至少一行，至多 maxRows 行
+  NFB_CHECK_EQ(Viewport(0, 0).PreferredHeight(8), 44.f);
+  NFB_CHECK_EQ(Viewport(3, 0).PreferredHeight(8), 100.f);
+  NFB_CHECK_EQ(Viewport(100, 0).PreferredHeight(8), 240.f);
+}
+
+NFB_TEST(ListViewport, ClampAndScrollBy) {
+  ListViewport view = Viewport(100, 240.f);
+  NFB_CHECK_EQ(view.MaxScroll(), 2816.f - 240.f);
+  view.scrollOffset = -5.f;
+  view.ClampScroll();
+  NFB_CHECK_EQ(view.scrollOffset, 0.f);
+  view.scrollOffset = 1e6f;
+  view.ClampScroll();
+  NFB_CHECK_EQ(view.scrollOffset, view.MaxScroll());
+
+  view.scrollOffset = 0.f;
+  NFB_CHECK(!view.ScrollBy(-30.f)); // 已在顶部：没有变化，不需要重绘
+  NFB_CHECK(view.ScrollBy(30.f));
+  NFB_CHECK_EQ(view.scrollOffset, 30.f);
+  NFB_CHECK(view.ScrollBy(1e6f));
+  NFB_CHECK_EQ(view.scrollOffset, view.MaxScroll());
+  NFB_CHECK(!view.ScrollBy(1.f));
+
+  // 内容比视口矮：不能滚动
+  ListViewport shortList = Viewport(3, 240.f);
+  NFB_CHECK_EQ(shortList.MaxScroll(), 0.f);
+  NFB_CHECK(!shortList.ScrollBy(50.f));
+  NFB_CHECK_EQ(shortList.scrollOffset, 0.f);
+
+  // 条目减少后钳制回新的最大值
+  view.itemCount = 10;
+  view.ClampScroll();
+  NFB_CHECK_EQ(view.scrollOffset, 300.f - 4.f - 240.f);
+}
+
+NFB_TEST(ListViewport, RowAtSplitsGapsBetweenNeighbours) {
+  const ListViewport view = Viewport(5, 200.f);
+  NFB_CHECK_EQ(view.RowAt(-1.f), -1);
+  NFB_CHECK_EQ(view.RowAt(7.f), -1);  // 上内边距（扣除半个行距之外）
+  NFB_CHECK_EQ(view.RowAt(8.f), 0);
+  NFB_CHECK_EQ(view.RowAt(33.f), 0);  // 行 0 的 [10, 34)
+  NFB_CHECK_EQ(view.RowAt(35.f), 0);  // 行距 [34, 38) 上半归上一行
+  NFB_CHECK_EQ(view.RowAt(36.f), 1);  // 下半归下一行
+  NFB_CHECK_EQ(view.RowAt(10.f + 4 * 28.f), 4);
+  NFB_CHECK_EQ(view.RowAt(10.f + 5 * 28.f), -1); // 最后一行之后
+  NFB_CHECK_EQ(view.RowAt(200.f), -1);           // 视口之外
+
+  // 视口底边落在行 2 与行 3 之间的行距里：露出的下半个行距不命中没有绘制的行 3
+  const ListViewport clipped = Viewport(5, 93.f);
+  NFB_CHECK_EQ(clipped.RowAt(91.f), 2);
+  NFB_CHECK_EQ(clipped.RowAt(92.5f), -1);
+
+  const ListViewport scrolled = Viewport(100, 240.f, 5 * 28.f);
+  NFB_CHECK_EQ(scrolled.RowAt(10.f), 5);
+  NFB_CHECK_EQ(scrolled.RowAt(0.f), 4);
+}
+
+NFB_TEST(ListViewport, RowAtAndVisibleRangeAgreeWithRowTop) {
+  std::mt19937 rng(17);
+  for (int iteration = 0; iteration < 300; ++iteration) {
+    ListViewport view = Viewport((int)(rng() % 300), 40.f + (float)(rng() % 400));
+    view.scrollOffset = (float)(rng() % 9000);
+    view.ClampScroll();
+    int first = 0, last = 0;
+    view.VisibleRange(&first, &last);
+    NFB_CHECK(0 <= first && first <= last && last <= view.itemCount);
+    NFB_CHECK(last - first <= (int)std::ceil(view.viewportHeight / view.RowPitch()) + 2);
+    for (int i = 0; i < view.itemCount; ++i) {
+      const float top = view.RowTop(i);
+      // 与视口相交的行一定在可见区间内
+      if (top + view.rowHeight > 0.f && top < view.viewportHeight) NFB_CHECK(i >= first && i < last);
+    }
+    for (float y = 0.f; y < view.viewportHeight; y += 0.5f) {
+      const int row = view.RowAt(y);
+      if (row < 0) continue;
+      const float top = view.RowTop(row);
+      NFB_CHECK(y >= top - view.rowGap / 2.f - 1e-3f && y < top + view.rowHeight + view.rowGap / 2.f + 1e-3f);
+      NFB_CHECK(row >= first && row < last);
+    }
+  }
+}
@@ -0,0 +1,119 @@
+// LRU 缓存：淘汰最久未使用的条目（Find 与覆盖 Insert 都算使用）、统计、只可移动的值随淘汰析构，
+// 以及随机操作序列与直接用链表实现的参考模型一致。
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include "test_harness.h"
+#include "core/lru_cache.h"
+
+namespace {
+
+// 析构时计数：确认淘汰/Clear 释放了值（TextLayoutCache 的值持有 COM 指针）
+struct Tracked {
+  explicit Tracked(int* live) : live(live) { ++*live; }
+  ~Tracked() { --*live; }
+  int* live;
+};
+
+} // namespace
+
+NFB_TEST(LruCache, EvictsLeastRecentlyUsed) {
+  LruCache<std::string, int> cache(3);
+  cache.Insert("a", 1);
+  cache.Insert("b", 2);
+  cache.Insert("c", 3);
+  NFB_REQUIRE(cache.Find("a") != nullptr); // a 变为最新：下一个被淘汰的是 b
+  cache.Insert("d", 4);
+  NFB_CHECK(cache.Find("b") == nullptr);
+  NFB_CHECK(cache.Find("a") != nullptr && cache.Find("c") != nullptr && cache.Find("d") != nullptr);
+  // 顺序（新 -> 旧）：d c a；覆盖 a 使其变为最新，也不淘汰
+  cache.Insert("a", 10);
+  NFB_CHECK_EQ(cache.Size(), 3u);
+  NFB_CHECK_EQ(*cache.Find("a"), 10);
+  cache.Insert("e", 5); // 此时顺序为 a d c：淘汰 c
+  NFB_CHECK(cache.Find("c") == nullptr);
+  NFB_CHECK(cache.Find("d") != nullptr && cache.Find("e") != nullptr);
+}
+
+NFB_TEST(LruCache, StatsCountHitsMissesEvictions) {
+  LruCache<int, int> cache(2);
+  NFB_CHECK(cache.Find(1) == nullptr);
+  cache.Insert(1, 1);
+  cache.Insert(2, 2);
+  cache.Find(1);
+  cache.Find(1);
+  cache.Insert(3, 3); // 淘汰 2
+  cache.Find(2);
+  LruCache<int, int>::Stats stats = cache.GetStats();
+  NFB_CHECK_EQ(stats.hits, 2u);
+  NFB_CHECK_EQ(stats.misses, 2u);
+  NFB_CHECK_EQ(stats.evictions, 1u);
+  NFB_CHECK_EQ(stats.size, 2u);
+  NFB_CHECK_EQ(stats.capacity, 2u);
+  NFB_CHECK_EQ(stats.HitRate(), 0.5);
+  cache.ResetStats();
+  stats = cache.GetStats();
+  NFB_CHECK_EQ(stats.hits + stats.misses + stats.evictions, 0u);
+  NFB_CHECK_EQ(stats.size, 2u);
+  NFB_CHECK_EQ(stats.HitRate(), 0.0);
+  // 容量 0 按 1 处理
+  LruCache<int, int> tiny(0);
+  tiny.Insert(1, 1);
+  tiny.Insert(2, 2);
+  NFB_CHECK_EQ(tiny.Size(), 1u);
+  NFB_CHECK(tiny.Find(2) != nullptr);
+}
+
+NFB_TEST(LruCache, MoveOnlyValuesReleasedOnEvictionAndClear) {
+  int live = 0;
+  {
+    LruCache<int, std::unique_ptr<Tracked>> cache(4);
+    for (int i = 0; i < 10; ++i) cache.Insert(i, std::make_unique<Tracked>(&live));
+    NFB_CHECK_EQ(live, 4);
+    cache.Insert(9, std::make_unique<Tracked>(&live)); // 覆盖：旧值释放
+    NFB_CHECK_EQ(live, 4);
+    cache.Clear();
+    NFB_CHECK_EQ(live, 0);
+    NFB_CHECK_EQ(cache.Size(), 0u);
+    cache.Insert(1, std::make_unique<Tracked>(&live));
+  }
+  NFB_CHECK_EQ(live, 0);
+}
+
+NFB_TEST(LruCache, MatchesReferenceModel) {
+  std::mt19937 rng(23);
+  for (size_t capacity : { 1u, 2u, 7u, 64u }) {
+    LruCache<int, int> cache(capacity);
+    std::list<std::pair<int, int>> model; // 表头最新
+    uint64_t evictions = 0;
+    for (int step = 0; step < 20000; ++step) {
+      const int key = (int)(rng() % (capacity * 3 + 1));
+      auto it = std::find_if(model.begin(), model.end(), [&](const std::pair<int, int>& e) { return e.first == key; });
+      if (rng() % 2) {
+        const int* found = cache.Find(key);
+        NFB_CHECK_EQ(found != nullptr, it != model.end());
+        if (found && it != model.end()) {
+          NFB_CHECK_EQ(*found, it->second);
+          model.splice(model.begin(), model, it);
+        }
+      } else {
+        const int value = step;
+        cache.Insert(key, value);
+        if (it != model.end()) {
+          it->second = value;
+          model.splice(model.begin(), model, it);
+        } else {
+          if (model.size() >= capacity) {
+            model.pop_back();
+            ++evictions;
+          }
+          model.emplace_front(key, value);
+        }
+      }
+      NFB_CHECK_EQ(cache.Size(), model.size());
+    }
+    NFB_CHECK_EQ(cache.GetStats().evictions, evictions);
+  }
+}
@@ -0,0 +1,5 @@
+#include "test_harness.h"
+
+int main(int argc, char** argv) {
+  return RunTests(argc, argv);
+}
@@ -0,0 +1,241 @@
+// 按子系统的内存统计：各子系统与总量的当前值随登记增减、峰值只升不降（ResetPeaks 回落）、释放过量按 0 计、
+// MemoryCharge 的调整与析构释放、多线程登记后收支平衡、预算越界标志，
+// 以及 dumpMemoryReport 取回的 JSON 报告（WM_COPYDATA dwData = 6）与写进日志的文本报告。
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "test_harness.h"
+#include "test_json.h"
+#include "core/ball_ipc.h"
+#include "core/memory_accounting.h"
+
+namespace {
+
+constexpr MemorySubsystem kAllSubsystems[] = {
+  MemorySubsystem::AnimationFrames, MemorySubsystem::RenderResources, MemorySubsystem::IpcBuffers,
+  MemorySubsystem::BubbleScene,     MemorySubsystem::Logging,
+};
+
+// 文本报告的一行：名称 + 若干以 KB 计的数值（名称可能带括号，但不含空格）
+struct ReportLine {
+  std::string name;
+  std::vector<std::string> values;
+};
+
+std::vector<ReportLine> ParseTextReport(const std::string& text) {
+  std::vector<ReportLine> lines;
+  std::istringstream in(text);
+  for (std::string line; std::getline(in, line);) {
+    std::istringstream words(line);
+    ReportLine row;
+    words >> row.name;
+    for (std::string w; words >> w;) row.values.push_back(w);
+    lines.push_back(row);
+  }
+  return lines;
+}
+
+} // namespace
+
+NFB_TEST(MemoryAccounting, CountersFollowAddAndSub) {
+  MemoryAccounting accounting;
+  for (MemorySubsystem s : kAllSubsystems) {
+    NFB_CHECK_EQ(accounting.Get(s).current, 0u);
+    NFB_CHECK_EQ(accounting.Get(s).peak, 0u);
+  }
+  accounting.Add(MemorySubsystem::AnimationFrames, 4000);
+  accounting.Add(MemorySubsystem::AnimationFrames, 1000);
+  accounting.Add(MemorySubsystem::RenderResources, 300);
+  NFB_CHECK_EQ(accounting.Get(MemorySubsystem::AnimationFrames).current, 5000u);
+  NFB_CHECK_EQ(accounting.Get(MemorySubsystem::RenderResources).current, 300u);
+  NFB_CHECK_EQ(accounting.Get(MemorySubsystem::Logging).current, 0u); // 其他子系统不受影响
+  NFB_CHECK_EQ(accounting.Total().current, 5300u);
+
+  // 释放：当前值下降，峰值保留
+  accounting.Sub(MemorySubsystem::AnimationFrames, 3500);
+  NFB_CHECK_EQ(accounting.Get(MemorySubsystem::AnimationFrames).current, 1500u);
+  NFB_CHECK_EQ(accounting.Get(MemorySubsystem::AnimationFrames).peak, 5000u);
+  NFB_CHECK_EQ(accounting.Total().current, 1800u);
+  NFB_CHECK_EQ(accounting.Total().peak, 5300u);
+
+  // 再次上升但未超过旧峰值：峰值不变；超过后跟着升
+  accounting.Add(MemorySubsystem::AnimationFrames, 2000);
+  NFB_CHECK_EQ(accounting.Get(MemorySubsystem::AnimationFrames).peak, 5000u);
+  accounting.Add(MemorySubsystem::AnimationFrames, 2000);
+  NFB_CHECK_EQ(accounting.Get(MemorySubsystem::AnimationFrames).peak, 5500u);
+  NFB_CHECK_EQ(accounting.Total().peak, 5800u);
+
+  // 释放过量：按 0 计，总量只减去子系统实际减掉的部分
+  accounting.Sub(MemorySubsystem::RenderResources, 1000000);
+  NFB_CHECK_EQ(accounting.Get(MemorySubsystem::RenderResources).current, 0u);
+  NFB_CHECK_EQ(accounting.Total().current, 5500u);
+
+  // 0 字节与越界的子系统被忽略
+  accounting.Add(MemorySubsystem::kCount, 100);
+  accounting.Sub(MemorySubsystem::kCount, 100);
+  accounting.Add(MemorySubsystem::Logging, 0);
+  NFB_CHECK_EQ(accounting.Total().current, 5500u);
+  NFB_CHECK_EQ(accounting.Get(MemorySubsystem::kCount).current, 0u);
+
+  // ResetPeaks：峰值回落到当前值
+  accounting.ResetPeaks();
+  NFB_CHECK_EQ(accounting.Get(MemorySubsystem::AnimationFrames).peak, 5500u);
+  NFB_CHECK_EQ(accounting.Get(MemorySubsystem::RenderResources).peak, 0u);
+  NFB_CHECK_EQ(accounting.Total().peak, 5500u);
+}
+
+NFB_TEST(MemoryAccounting, ChargeAdjustsAndReleases) {
+  MemoryAccounting accounting;
+  {
+    MemoryCharge frames(MemorySubsystem::AnimationFrames, accounting);
+    MemoryCharge dib(MemorySubsystem::RenderResources, accounting);
+    frames.Set(1 << 20);
+    dib.Set(4096);
+    NFB_CHECK_EQ(accounting.Get(MemorySubsystem::AnimationFrames).current, (uint64_t)(1 << 20));
+    frames.Set(1 << 19); // 调小：只释放差额
+    frames.Add(100);
+    frames.Sub(50);
+    NFB_CHECK_EQ(frames.Bytes(), (size_t)(1 << 19) + 50);
+    NFB_CHECK_EQ(accounting.Get(MemorySubsystem::AnimationFrames).current, (uint64_t)(1 << 19) + 50);
+    NFB_CHECK_EQ(accounting.Get(MemorySubsystem::AnimationFrames).peak, (uint64_t)(1 << 20));
+    dib.Sub(10000); // 过量释放：登记归零
+    NFB_CHECK_EQ(dib.Bytes(), 0u);
+    dib.Set(2048);
+    {
+      MemoryCharge second(MemorySubsystem::RenderResources, accounting);
+      second.Set(1000);
+      NFB_CHECK_EQ(accounting.Get(MemorySubsystem::RenderResources).current, 3048u);
+    }
+    NFB_CHECK_EQ(accounting.Get(MemorySubsystem::RenderResources).current, 2048u);
+    NFB_CHECK_EQ(accounting.Total().current, (uint64_t)(1 << 19) + 50 + 2048);
+  } // 析构释放全部登记
+  for (MemorySubsystem s : kAllSubsystems) NFB_CHECK_EQ(accounting.Get(s).current, 0u);
+  NFB_CHECK_EQ(accounting.Total().current, 0u);
+  NFB_CHECK_EQ(accounting.Total().peak, (uint64_t)(1 << 20) + 4096);
+}
+
+NFB_TEST(MemoryAccounting, ConcurrentChargesBalance) {
+  MemoryAccounting accounting;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&accounting, t] {
+      MemoryCharge charge(kAllSubsystems[t % 5], accounting);
+      for (int i = 0; i < 20000; ++i) charge.Set((size_t)(i % 97) * 16);
+    });
+  }
+  for (std::thread& t : threads) t.join();
+  NFB_CHECK_EQ(accounting.Total().current, 0u);
+  for (MemorySubsystem s : kAllSubsystems) NFB_CHECK_EQ(accounting.Get(s).current, 0u);
+  NFB_CHECK_EQ(accounting.Get(MemorySubsystem::AnimationFrames).peak, 96u * 16);
+  NFB_CHECK(accounting.Total().peak >= 96u * 16);
+  NFB_CHECK(accounting.Total().peak <= 4u * 96 * 16);
+}
+
+NFB_TEST(MemoryAccounting, BudgetCrossingIsFlaggedOnce) {
+  MemoryAccounting accounting;
+  NFB_CHECK(!accounting.OverBudget()); // 0 = 不限
+  accounting.SetBudget(10000);
+  accounting.Add(MemorySubsystem::IpcBuffers, 6000);
+  accounting.Add(MemorySubsystem::BubbleScene, 4000); // 正好等于预算：不算超出
+  NFB_CHECK(!accounting.OverBudget());
+  NFB_CHECK(!accounting.TakeBudgetExceeded());
+  accounting.Add(MemorySubsystem::BubbleScene, 1);
+  NFB_CHECK(accounting.OverBudget());
+  accounting.Add(MemorySubsystem::BubbleScene, 5000); // 已经超出：不再置位
+  NFB_CHECK(accounting.TakeBudgetExceeded());
+  NFB_CHECK(!accounting.TakeBudgetExceeded());
+
+  // 回落到预算以内后再越过：再次置位
+  accounting.Sub(MemorySubsystem::BubbleScene, 8000);
+  NFB_CHECK(!accounting.OverBudget());
+  accounting.Add(MemorySubsystem::Logging, 5000);
+  NFB_CHECK(accounting.TakeBudgetExceeded());
+
+  // 调低预算时已经超出：立即置位；预算清零后不再超出
+  accounting.Sub(MemorySubsystem::Logging, 5000);
+  accounting.SetBudget(1000);
+  NFB_CHECK(accounting.TakeBudgetExceeded());
+  accounting.SetBudget(0);
+  NFB_CHECK(!accounting.OverBudget());
+  NFB_CHECK_EQ(accounting.Budget(), 0u);
+}
+
+NFB_TEST(MemoryAccounting, JsonReportForDumpMemoryReport) {
+  // 主程序的 dumpMemoryReport 收到的就是这份 JSON（WM_COPYDATA dwData = 6）
+  NFB_CHECK_EQ(kBallIpcMemoryReport, (uintptr_t)6);
+
+  MemoryAccounting accounting;
+  accounting.Add(MemorySubsystem::AnimationFrames, 3 << 20);
+  accounting.Sub(MemorySubsystem::AnimationFrames, 1 << 20);
+  accounting.Add(MemorySubsystem::Logging, 118784);
+  accounting.SetBudget(1 << 20);
+
+  Json doc;
+  NFB_REQUIRE(ParseJson(accounting.ToJson(), &doc));
+  NFB_REQUIRE(doc.Has("subsystems") && doc.Has("total"));
+  const Json& subsystems = doc["subsystems"];
+  NFB_CHECK_EQ(subsystems.object.size(), MemoryAccounting::kSubsystems);
+  for (MemorySubsystem s : kAllSubsystems) {
+    NFB_REQUIRE(subsystems.Has(MemorySubsystemName(s)));
+    const Json& entry = subsystems[MemorySubsystemName(s)];
+    NFB_CHECK_EQ(entry.object.size(), 2u);
+    NFB_CHECK_EQ(entry["current"].number, (double)accounting.Get(s).current);
+    NFB_CHECK_EQ(entry["peak"].number, (double)accounting.Get(s).peak);
+  }
+  NFB_CHECK_EQ(subsystems["animation_frames"]["current"].number, (double)(2 << 20));
+  NFB_CHECK_EQ(subsystems["animation_frames"]["peak"].number, (double)(3 << 20));
+  NFB_CHECK_EQ(subsystems["logging"]["current"].number, 118784.0);
+  NFB_CHECK_EQ(subsystems["ipc_buffers"]["peak"].number, 0.0);
+  NFB_CHECK_EQ(doc["total"]["current"].number, (double)(2 << 20) + 118784);
+  NFB_CHECK_EQ(doc["total"]["peak"].number, (double)(3 << 20)); // 峰值出现在日志登记之前
+  NFB_CHECK_EQ(doc["budget"].number, (double)(1 << 20));
+  NFB_CHECK(doc["over_budget"].type == Json::Type::Bool && doc["over_budget"].boolean);
+  NFB_CHECK(!doc.Has("process_private")); // 未知进程总量时省略
+
+  NFB_REQUIRE(ParseJson(accounting.ToJson(50u << 20), &doc));
+  NFB_CHECK_EQ(doc["process_private"].number, (double)(50u << 20));
+  NFB_CHECK_EQ(doc.object.size(), 5u);
+
+  // 空的统计也是完整的报告
+  NFB_REQUIRE(ParseJson(MemoryAccounting().ToJson(), &doc));
+  NFB_CHECK_EQ(doc["total"]["current"].number, 0.0);
+  NFB_CHECK(!doc["over_budget"].boolean);
+  NFB_CHECK_EQ(doc["subsystems"].object.size(), MemoryAccounting::kSubsystems);
+}
+
+NFB_TEST(MemoryAccounting, TextReportListsEverySubsystem) {
+  MemoryAccounting accounting;
+  accounting.Add(MemorySubsystem::RenderResources, 2048);
+  accounting.Add(MemorySubsystem::BubbleScene, 512);
+  accounting.Sub(MemorySubsystem::BubbleScene, 512);
+
+  std::vector<ReportLine> lines = ParseTextReport(accounting.Format());
+  NFB_REQUIRE(lines.size() == 7); // 表头 + 5 个子系统 + 登记总量
+  NFB_CHECK(lines[0].name == "subsystem");
+  NFB_CHECK(lines[0].values == std::vector<std::string>({ "current_kb", "peak_kb" }));
+  for (size_t i = 0; i < MemoryAccounting::kSubsystems; ++i) {
+    NFB_CHECK(lines[1 + i].name == MemorySubsystemName(kAllSubsystems[i]));
+    NFB_CHECK_EQ(lines[1 + i].values.size(), 2u);
+  }
+  NFB_CHECK(lines[2].values == std::vector<std::string>({ "2.0", "2.0" }));  // render_resources
+  NFB_CHECK(lines[4].values == std::vector<std::string>({ "0.0", "0.5" }));  // bubble_scene：只剩峰值
+  NFB_CHECK(lines[6].name == "(tracked");
+  NFB_CHECK(lines[6].values == std::vector<std::string>({ "total)", "2.0", "2.5" }));
+
+  // 进程私有字节与未登记部分；超出预算时标 OVER
+  accounting.SetBudget(1024);
+  lines = ParseTextReport(accounting.Format(10240));
+  NFB_REQUIRE(lines.size() == 10);
+  NFB_CHECK(lines[7].values == std::vector<std::string>({ "private)", "10.0" }));
+  NFB_CHECK(lines[8].name == "(untracked)");
+  NFB_CHECK(lines[8].values == std::vector<std::string>({ "8.0" }));
+  NFB_CHECK(lines[9].name == "(budget)");
+  NFB_CHECK(lines[9].values == std::vector<std::string>({ "1.0", "OVER" }));
+
+  // 进程总量小于登记总量（统计时刻不同）：未登记部分按 0 计
+  lines = ParseTextReport(accounting.Format(1024));
+  NFB_REQUIRE(lines.size() == 10);
+  NFB_CHECK(lines[8].values == std::vector<std::string>({ "0.0" }));
+  NFB_CHECK_EQ(std::string(MemorySubsystemName(MemorySubsystem::kCount)), std::string("unknown"));
+}
@@ -0,0 +1,251 @@
+// 子进程监管：退避序列，以及用 /bin/sh 脚本扮演悬浮球时的事件顺序（就绪、超时、崩溃重启、放弃、
+// 正常退出、Stop）。子进程用例只在 POSIX 上编译。
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "test_harness.h"
+#include "core/process_supervisor.h"
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using std::chrono::milliseconds;
+
+NFB_TEST(ProcessSupervisor, BackoffDoublesUpToCapThenGivesUp) {
+  RestartBackoff backoff(milliseconds(100), milliseconds(350), milliseconds(1000), 4);
+  milliseconds delay{0};
+  const long long expected[] = { 100, 200, 350, 350 };
+  for (long long ms : expected) {
+    NFB_REQUIRE(backoff.Next(milliseconds(10), &delay));
+    NFB_CHECK_EQ(delay.count(), ms);
+  }
+  NFB_CHECK(!backoff.Next(milliseconds(10), &delay));
+}
+
+NFB_TEST(ProcessSupervisor, StableRunResetsBackoff) {
+  RestartBackoff backoff(milliseconds(100), milliseconds(1000), milliseconds(500), 2);
+  milliseconds delay{0};
+  NFB_CHECK(backoff.Next(milliseconds(10), &delay));
+  NFB_CHECK(backoff.Next(milliseconds(10), &delay));
+  NFB_CHECK_EQ(delay.count(), 200);
+  // 稳定运行过一段时间后的崩溃重新从 initial 开始计数
+  NFB_CHECK(backoff.Next(milliseconds(600), &delay));
+  NFB_CHECK_EQ(delay.count(), 100);
+  NFB_CHECK_EQ(backoff.Consecutive(), 1);
+}
+
+NFB_TEST(ProcessSupervisor, ReadyArgumentParsing) {
+  NFB_CHECK(!SignalSupervisorReady("--other"));
+  NFB_CHECK(!SignalSupervisorReady("--ready="));
+  NFB_CHECK(!SignalSupervisorReady("--ready=abc"));
+  NFB_CHECK(!SignalSupervisorReady("--ready=-1"));
+}
+
+#ifndef _WIN32
+
+namespace {
+
+using Event = ProcessSupervisor::Event;
+
+struct Recorded {
+  Event event;
+  uint32_t pid;
+  int exitCode;
+  std::chrono::steady_clock::time_point at;
+};
+
+// 在监管线程上收集事件；WaitFor 等到出现某个事件（或超时）
+class EventLog {
+public:
+  ProcessSupervisor::Listener Listener() {
+    return [this](Event event, uint32_t pid, int exitCode) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_events.push_back({ event, pid, exitCode, std::chrono::steady_clock::now() });
+      m_cv.notify_all();
+    };
+  }
+
+  bool WaitFor(Event event, milliseconds timeout = milliseconds(5000)) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_cv.wait_for(lock, timeout, [&] {
+      for (const Recorded& r : m_events) {
+        if (r.event == event) return true;
+      }
+      return false;
+    });
+  }
+
+  std::vector<Recorded> Events() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_events;
+  }
+
+  std::vector<Event> Kinds() {
+    std::vector<Event> kinds;
+    for (const Recorded& r : Events()) kinds.push_back(r.event);
+    return kinds;
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::vector<Recorded> m_events;
+};
+
+// sh -c script：监管端追加的 "--ready=<fd>" 成为 $0。dash 的重定向不支持两位数的 fd，经 /dev/fd 写
+constexpr char kSignalReady[] = "printf r > /dev/fd/${0#--ready=}; ";
+
+ProcessSupervisor::Options Script(const std::string& script) {
+  ProcessSupervisor::Options options;
+  options.path = "/bin/sh";
+  options.args = { "-c", script };
+  options.readyTimeout = milliseconds(2000);
+  options.initialBackoff = milliseconds(20);
+  options.maxBackoff = milliseconds(40);
+  options.stableRun = milliseconds(10000);
+  options.maxRestarts = 3;
+  return options;
+}
+
+bool WaitStopped(const ProcessSupervisor& supervisor) {
+  const auto deadline = std::chrono::steady_clock::now() + milliseconds(5000);
+  while (supervisor.IsRunning() && std::chrono::steady_clock::now() < deadline) usleep(1000);
+  return !supervisor.IsRunning();
+}
+
+bool Alive(uint32_t pid) {
+  // 已退出但尚未回收的僵尸进程也算退出
+  int status = 0;
+  if (waitpid((pid_t)pid, &status, WNOHANG) == (pid_t)pid) return false;
+  return kill((pid_t)pid, 0) == 0;
+}
+
+} // namespace
+
+NFB_TEST(ProcessSupervisor, ReadyThenCleanExit) {
+  EventLog log;
+  ProcessSupervisor supervisor(Script(std::string(kSignalReady) + "sleep 0.05; exit 0"), log.Listener());
+  supervisor.Start();
+  NFB_CHECK(log.WaitFor(Event::Exited));
+  NFB_CHECK(WaitStopped(supervisor));
+  const std::vector<Event> expected = { Event::Ready, Event::Exited };
+  NFB_CHECK(log.Kinds() == expected);
+  NFB_CHECK_EQ(supervisor.Restarts(), 0);
+  const std::vector<Recorded> events = log.Events();
+  NFB_REQUIRE(events.size() == 2);
+  NFB_CHECK(events[0].pid != 0 && events[0].pid == events[1].pid);
+}
+
+NFB_TEST(ProcessSupervisor, SilentChildReportsReadyTimeout) {
+  // 不发就绪信号的旧版本：超时后报告 ReadyTimeout，仍继续监管直到退出
+  EventLog log;
+  ProcessSupervisor::Options options = Script("sleep 0.3; exit 0");
+  options.readyTimeout = milliseconds(60);
+  ProcessSupervisor supervisor(std::move(options), log.Listener());
+  supervisor.Start();
+  NFB_CHECK(log.WaitFor(Event::Exited));
+  NFB_CHECK(WaitStopped(supervisor));
+  const std::vector<Event> expected = { Event::ReadyTimeout, Event::Exited };
+  NFB_CHECK(log.Kinds() == expected);
+}
+
+NFB_TEST(ProcessSupervisor, CrashLoopBacksOffThenGivesUp) {
+  EventLog log;
+  ProcessSupervisor supervisor(Script("exit 3"), log.Listener());
+  supervisor.Start();
+  NFB_CHECK(log.WaitFor(Event::GaveUp));
+  NFB_CHECK(WaitStopped(supervisor));
+  const std::vector<Event> expected = { Event::Crashed, Event::Crashed, Event::Crashed, Event::GaveUp };
+  NFB_CHECK(log.Kinds() == expected);
+  NFB_CHECK_EQ(supervisor.Restarts(), 3);
+  const std::vector<Recorded> events = log.Events();
+  NFB_REQUIRE(events.size() == 4);
+  for (const Recorded& r : events) NFB_CHECK_EQ(r.exitCode, 3);
+  // 每次重启都是新进程；相邻两次崩溃之间至少隔了退避时间（20、40、40 ms）
+  NFB_CHECK(events[0].pid != events[1].pid && events[1].pid != events[2].pid);
+  NFB_CHECK(events[1].at - events[0].at >= milliseconds(20));
+  NFB_CHECK(events[2].at - events[1].at >= milliseconds(40));
+  NFB_CHECK(events[3].at - events[2].at >= milliseconds(40));
+}
+
+NFB_TEST(ProcessSupervisor, RestartsAfterCrashUntilReady) {
+  // 第一次运行崩溃（以信号结束），重启后的进程发出就绪并正常退出
+  char dir[] = "/tmp/nfb_supervisor_XXXXXX";
+  NFB_REQUIRE(mkdtemp(dir) != nullptr);
+  const std::string marker = std::string(dir) + "/started";
+  EventLog log;
+  ProcessSupervisor supervisor(
+      Script("if [ -e " + marker + " ]; then " + kSignalReady + "exit 0; fi; : > " + marker + "; kill -9 $$"),
+      log.Listener());
+  supervisor.Start();
+  NFB_CHECK(log.WaitFor(Event::Exited));
+  NFB_CHECK(WaitStopped(supervisor));
+  const std::vector<Event> expected = { Event::Crashed, Event::Ready, Event::Exited };
+  NFB_CHECK(log.Kinds() == expected);
+  const std::vector<Recorded> events = log.Events();
+  NFB_REQUIRE(events.size() == 3);
+  NFB_CHECK_EQ(events[0].exitCode, 128 + SIGKILL);
+  NFB_CHECK_EQ(supervisor.Restarts(), 1);
+  unlink(marker.c_str());
+  rmdir(dir);
+}
+
+NFB_TEST(ProcessSupervisor, SpawnFailureEndsSupervision) {
+  EventLog log;
+  ProcessSupervisor::Options options;
+  options.path = "/nonexistent/native_floating_ball";
+  ProcessSupervisor supervisor(std::move(options), log.Listener());
+  supervisor.Start();
+  NFB_CHECK(log.WaitFor(Event::SpawnFailed));
+  NFB_CHECK(WaitStopped(supervisor));
+  NFB_CHECK_EQ(log.Events().size(), 1u);
+}
+
+NFB_TEST(ProcessSupervisor, StopTerminatesOrDetaches) {
+  // exec：被监管的就是 sleep 本身。否则结束 sh 后孤儿 sleep 仍占着测试的输出管道，ctest 要等它退出
+  {
+    EventLog log;
+    ProcessSupervisor supervisor(Script(std::string(kSignalReady) + "exec sleep 30"), log.Listener());
+    supervisor.Start();
+    NFB_REQUIRE(log.WaitFor(Event::Ready));
+    const uint32_t pid = log.Events()[0].pid;
+    supervisor.Stop(true);
+    NFB_CHECK(!supervisor.IsRunning());
+    NFB_CHECK(!Alive(pid));
+    // Stop 之后不再有事件（不会把被结束的子进程当作崩溃重启）
+    NFB_CHECK_EQ(log.Events().size(), 1u);
+  }
+  {
+    EventLog log;
+    ProcessSupervisor supervisor(Script(std::string(kSignalReady) + "exec sleep 30"), log.Listener());
+    supervisor.Start();
+    NFB_REQUIRE(log.WaitFor(Event::Ready));
+    const uint32_t pid = log.Events()[0].pid;
+    supervisor.Stop(false);
+    NFB_CHECK(!supervisor.IsRunning());
+    NFB_CHECK(Alive(pid));
+    kill((pid_t)pid, SIGKILL);
+    waitpid((pid_t)pid, nullptr, 0);
+  }
+}
+
+NFB_TEST(ProcessSupervisor, RestartAfterSelfStop) {
+  // 监管自行结束（子进程正常退出）后可以再次 Start
+  EventLog log;
+  ProcessSupervisor supervisor(Script("exit 0"), log.Listener());
+  supervisor.Start();
+  NFB_REQUIRE(log.WaitFor(Event::Exited));
+  NFB_REQUIRE(WaitStopped(supervisor));
+  supervisor.Start();
+  const auto deadline = std::chrono::steady_clock::now() + milliseconds(5000);
+  while (log.Events().size() < 2 && std::chrono::steady_clock::now() < deadline) usleep(1000);
+  const std::vector<Event> expected = { Event::Exited, Event::Exited };
+  NFB_CHECK(log.Kinds() == expected);
+}
+
+#endif // !_WIN32
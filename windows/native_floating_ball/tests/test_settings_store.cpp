@@ -0,0 +1,302 @@
+// 设置存储：连续修改去抖合并为一次写盘、持续修改最迟 maxDelay 写一次、析构时写出未落盘的修改、
+// 经 WriteFileAtomically 写出再读回、残留的 .tmp 不会顶替正式文件、写失败的计数与重试；
+// 以及悬浮球位置按 pos.<显示器拓扑> 分别保存、旧版 native_floating_ball_pos.txt 只导入一次。
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "test_harness.h"
+#include "core/ball_position.h"
+#include "core/settings_store.h"
+
+namespace {
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void WriteFile(const std::string& path, const std::string& data) {
+  std::ofstream(path, std::ios::binary | std::ios::trunc) << data;
+}
+
+bool FileExists(const std::string& path) {
+  return std::ifstream(path, std::ios::binary).good();
+}
+
+SettingsStore::Options OptionsFor(const std::string& path, int debounceMs = 50, int maxDelayMs = 5000) {
+  SettingsStore::Options options;
+  options.path = path;
+  options.debounce = std::chrono::milliseconds(debounceMs);
+  options.maxDelay = std::chrono::milliseconds(maxDelayMs);
+  return options;
+}
+
+// 等后台线程写到 writes 次（最多 budget）
+bool WaitForWrites(const SettingsStore& store, uint64_t writes, std::chrono::milliseconds budget) {
+  const auto deadline = std::chrono::steady_clock::now() + budget;
+  while (store.Writes() < writes) {
+    if (std::chrono::steady_clock::now() >= deadline) return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return true;
+}
+
+std::string Value(const SettingsStore& store, const char* key) {
+  std::string value;
+  return store.Get(key, &value) ? value : std::string("<missing>");
+}
+
+} // namespace
+
+NFB_TEST(SettingsStore, SetsCoalesceIntoOneWrite) {
+  const TestTempDir dir("settings_coalesce");
+  const std::string path = dir.File("settings.txt");
+  SettingsStore store;
+  NFB_REQUIRE(store.Open(OptionsFor(path, 100)));
+  // 拖动球时每次 WM_MOVE 都会保存位置：20 次修改只写一次盘
+  for (int i = 0; i < 20; ++i) NFB_CHECK(store.SetInt("pos.test", i));
+  NFB_CHECK(store.Set("diameter", "120"));
+  NFB_CHECK_EQ(store.Writes(), 0u);
+  NFB_CHECK(!FileExists(path));
+  NFB_REQUIRE(WaitForWrites(store, 1, std::chrono::seconds(5)));
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  NFB_CHECK_EQ(store.Writes(), 1u);
+  NFB_CHECK(ReadFile(path) == "# native_floating_ball settings\ndiameter=120\npos.test=19\n");
+
+  // 值没变：不算修改，不写盘
+  NFB_CHECK(store.Set("diameter", "120"));
+  NFB_CHECK(store.Flush());
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  NFB_CHECK_EQ(store.Writes(), 1u);
+  NFB_CHECK_EQ(store.Failures(), 0u);
+}
+
+NFB_TEST(SettingsStore, ContinuousChangesWriteByMaxDelay) {
+  const TestTempDir dir("settings_maxdelay");
+  const std::string path = dir.File("settings.txt");
+  SettingsStore store;
+  NFB_REQUIRE(store.Open(OptionsFor(path, 200, 300)));
+  // 每 20ms 改一次，去抖永远等不到空闲：最迟 maxDelay 写一次
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1000); ++i) {
+    store.SetInt("counter", i);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  const uint64_t writes = store.Writes();
+  NFB_CHECK(writes >= 2);
+  NFB_CHECK(writes <= 4);
+}
+
+NFB_TEST(SettingsStore, FlushAndDestructionWritePendingChanges) {
+  const TestTempDir dir("settings_flush");
+  const std::string path = dir.File("settings.txt");
+  {
+    SettingsStore store;
+    NFB_REQUIRE(store.Open(OptionsFor(path, 60000, 60000)));
+    NFB_CHECK(store.Set("a", "1"));
+    NFB_CHECK(store.Flush()); // 不等去抖
+    NFB_CHECK_EQ(store.Writes(), 1u);
+    NFB_CHECK(ReadFile(path).find("a=1\n") != std::string::npos);
+    NFB_CHECK(store.Set("b", "2"));
+    NFB_CHECK(store.Erase("a"));
+    NFB_CHECK(!store.Erase("a"));
+  } // 析构：写出去抖中的修改
+  NFB_CHECK(ReadFile(path) == "# native_floating_ball settings\nb=2\n");
+
+  // Close 之后 Flush 只在没有未写修改时成功
+  SettingsStore store;
+  NFB_REQUIRE(store.Open(OptionsFor(path, 60000, 60000)));
+  store.Close();
+  NFB_CHECK(!store.IsOpen());
+  NFB_CHECK(store.Flush());
+  NFB_CHECK(store.Set("c", "3"));
+  NFB_CHECK(!store.Flush());
+  NFB_CHECK(ReadFile(path) == "# native_floating_ball settings\nb=2\n");
+}
+
+NFB_TEST(SettingsStore, RoundTripThroughAtomicWrite) {
+  const TestTempDir dir("settings_roundtrip");
+  const std::string path = dir.File("settings.txt");
+
+  // WriteFileAtomically 本身：整体替换，不留临时文件
+  NFB_CHECK(WriteFileAtomically(path, std::string("first version, longer than the second\n")));
+  NFB_CHECK(WriteFileAtomically(path, std::string("x\0y", 3)));
+  NFB_CHECK(ReadFile(path) == std::string("x\0y", 3));
+  NFB_CHECK(!FileExists(path + ".tmp"));
+  NFB_CHECK(!WriteFileAtomically(dir.File("missing/settings.txt"), "z"));
+
+  {
+    SettingsStore store;
+    NFB_REQUIRE(store.Open(OptionsFor(path)));
+    NFB_CHECK(store.Set("frame_profile", "balanced"));
+    NFB_CHECK(store.Set("path", "C:\\Users\\名字\\a=b c"));  // 值里可以有 '='、空格与非 ASCII
+    NFB_CHECK(store.Set("empty", ""));
+    NFB_CHECK(store.SetInt("memory_budget_kb", -42));
+    NFB_CHECK(store.SetInt("big", INT64_MAX));
+    NFB_CHECK(!store.Set("bad=key", "v"));
+    NFB_CHECK(!store.Set("", "v"));
+    NFB_CHECK(!store.Set("#comment", "v"));
+    NFB_CHECK(!store.Set("key", "two\nlines"));
+    NFB_CHECK(!store.Set("key", "cr\r"));
+    NFB_CHECK(store.Flush());
+  }
+  SettingsStore reopened;
+  NFB_REQUIRE(reopened.Open(OptionsFor(path)));
+  NFB_CHECK(Value(reopened, "frame_profile") == "balanced");
+  NFB_CHECK(Value(reopened, "path") == "C:\\Users\\名字\\a=b c");
+  NFB_CHECK(Value(reopened, "empty") == "");
+  NFB_CHECK_EQ(reopened.GetInt("memory_budget_kb", 0), -42);
+  NFB_CHECK_EQ(reopened.GetInt("big", 0), INT64_MAX);
+  NFB_CHECK_EQ(reopened.GetInt("frame_profile", 7), 7); // 不是整数时用默认值
+  NFB_CHECK_EQ(reopened.GetInt("missing", 9), 9);
+  NFB_CHECK(!reopened.Get("bad=key", nullptr));
+  NFB_CHECK(!reopened.Get("key", nullptr));
+  NFB_CHECK_EQ(reopened.Writes(), 0u); // 读入不算修改
+
+  // 手写的文件：注释、CRLF、空行、没有 '=' 的行与空键被跳过，重复的键以后出现的为准
+  WriteFile(path, "# comment\r\nk1=v1\r\n\r\nnoequals\n=nokey\nk2=a=b\nk1=v2");
+  SettingsStore manual;
+  NFB_REQUIRE(manual.Open(OptionsFor(path)));
+  NFB_CHECK(Value(manual, "k1") == "v2");
+  NFB_CHECK(Value(manual, "k2") == "a=b");
+  std::vector<std::string> keys;
+  manual.ForEachWithPrefix("", [&](const std::string& key, const std::string&) { keys.push_back(key); });
+  NFB_CHECK(keys == std::vector<std::string>({ "k1", "k2" }));
+}
+
+NFB_TEST(SettingsStore, LeftoverTempFileNeverReplacesSettings) {
+  const TestTempDir dir("settings_tmp");
+  const std::string path = dir.File("settings.txt");
+  WriteFile(path, "# native_floating_ball settings\ndiameter=96\n");
+  // 上次写到一半崩溃：临时文件只写了一部分，正式文件还是旧的
+  WriteFile(path + ".tmp", "# native_floating_ball settings\ndiameter=5");
+  {
+    SettingsStore store;
+    NFB_REQUIRE(store.Open(OptionsFor(path)));
+    NFB_CHECK_EQ(store.GetInt("diameter", 0), 96);
+    store.Close(); // 没有修改：不写盘，临时文件原样留着，正式文件不变
+    NFB_CHECK_EQ(store.Writes(), 0u);
+    NFB_CHECK(ReadFile(path) == "# native_floating_ball settings\ndiameter=96\n");
+  }
+  // 下一次写盘覆盖掉残留的临时文件再改名，正式文件是完整的新内容
+  SettingsStore store;
+  NFB_REQUIRE(store.Open(OptionsFor(path)));
+  NFB_CHECK(store.SetInt("diameter", 150));
+  NFB_CHECK(store.Flush());
+  NFB_CHECK(ReadFile(path) == "# native_floating_ball settings\ndiameter=150\n");
+  NFB_CHECK(!FileExists(path + ".tmp"));
+}
+
+NFB_TEST(SettingsStore, FailedWriteIsCountedAndRetried) {
+  const TestTempDir dir("settings_fail");
+  const std::string path = dir.File("sub/settings.txt"); // 目录还不存在：写盘失败
+  SettingsStore store;
+  NFB_CHECK(store.Open(OptionsFor(path))); // 文件不存在视为空
+  NFB_CHECK(store.Set("a", "1"));
+  NFB_CHECK(!store.Flush());
+  NFB_CHECK_EQ(store.Failures(), 1u);
+  NFB_CHECK_EQ(store.Writes(), 0u);
+  NFB_CHECK(Value(store, "a") == "1"); // 内存表照常可用
+  // 失败的版本不自动重试；目录建好后 Flush 重试成功
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  NFB_CHECK_EQ(store.Failures(), 1u);
+  std::error_code ec;
+  NFB_REQUIRE(std::filesystem::create_directories(std::filesystem::u8path(dir.File("sub")), ec));
+  NFB_CHECK(store.Flush());
+  NFB_CHECK_EQ(store.Writes(), 1u);
+  NFB_CHECK(ReadFile(path) == "# native_floating_ball settings\na=1\n");
+}
+
+NFB_TEST(SettingsStore, PositionsKeyedByMonitorTopology) {
+  const MonitorGeometry laptop{ 0, 0, 1920, 1080, 144 };
+  const MonitorGeometry external{ 1920, 0, 4480, 1440, 96 };
+  const std::string single = MonitorTopologyKey({ laptop });
+  const std::string docked = MonitorTopologyKey({ laptop, external });
+  NFB_CHECK_EQ(single.size(), 16u);
+  NFB_CHECK(single.find_first_not_of("0123456789abcdef") == std::string::npos);
+  NFB_CHECK(single != docked);
+  NFB_CHECK(MonitorTopologyKey({ external, laptop }) == docked); // 与枚举顺序无关
+  NFB_CHECK(MonitorTopologyKey({ { 0, 0, 1920, 1080, 96 } }) != single); // 只改 DPI 也是另一组
+  NFB_CHECK(MonitorTopologyKey({ laptop }) == single);
+  // 已保存的位置依赖拓扑键的具体取值：哈希（含沿用下来的非标准 FNV 初值）不能变
+  NFB_CHECK(MonitorTopologyKey({}) == "14650fb0739d0383");
+  NFB_CHECK(single == "50ecee316f7079b6");
+
+  const TestTempDir dir("settings_pos");
+  const std::string path = dir.File("settings.txt");
+  {
+    SettingsStore store;
+    NFB_REQUIRE(store.Open(OptionsFor(path)));
+    SaveBallPosition(store, single, 1700, 900);
+    SaveBallPosition(store, docked, -300, 1200); // 负坐标：主显示器左侧的屏幕
+    long x = 0, y = 0;
+    NFB_CHECK(LoadBallPosition(store, single, &x, &y));
+    NFB_CHECK_EQ(x, 1700L);
+    NFB_CHECK_EQ(y, 900L);
+  }
+  SettingsStore store;
+  NFB_REQUIRE(store.Open(OptionsFor(path)));
+  NFB_CHECK(Value(store, ("pos." + single).c_str()) == "1700 900");
+  NFB_CHECK(Value(store, ("pos." + docked).c_str()) == "-300 1200");
+  long x = 0, y = 0;
+  NFB_CHECK(LoadBallPosition(store, docked, &x, &y));
+  NFB_CHECK_EQ(x, -300L);
+  NFB_CHECK_EQ(y, 1200L);
+  NFB_CHECK(!LoadBallPosition(store, MonitorTopologyKey({ external }), &x, &y)); // 没来过的拓扑
+  NFB_CHECK_EQ(x, -300L); // 失败时不改输出
+
+  // 损坏的值不被采用
+  for (const char* bad : { "", "12", "12 ", " 12 3", "12  3", "12 3 ", "a b", "12,3" }) {
+    store.Set("pos.bad", bad);
+    NFB_CHECK(!LoadBallPosition(store, "bad", &x, &y));
+  }
+}
+
+NFB_TEST(SettingsStore, LegacyPositionImportedOnce) {
+  const TestTempDir dir("settings_legacy");
+  const std::string path = dir.File("settings.txt");
+  const std::string legacy = dir.File("native_floating_ball_pos.txt");
+  const std::string topology = MonitorTopologyKey({ { 0, 0, 2560, 1440, 120 } });
+
+  // 没有旧文件、旧文件损坏：什么也不导入
+  {
+    SettingsStore store;
+    NFB_REQUIRE(store.Open(OptionsFor(path)));
+    NFB_CHECK(!ImportLegacyBallPosition(store, topology, legacy));
+    WriteFile(legacy, "not a position");
+    NFB_CHECK(!ImportLegacyBallPosition(store, topology, legacy));
+    NFB_CHECK(!LoadBallPosition(store, topology, nullptr, nullptr));
+    NFB_CHECK_EQ(store.Writes(), 0u);
+  }
+
+  // 第一次启动：导入到当前拓扑并写进设置文件
+  WriteFile(legacy, "812 604\n");
+  {
+    SettingsStore store;
+    NFB_REQUIRE(store.Open(OptionsFor(path)));
+    NFB_CHECK(ImportLegacyBallPosition(store, topology, legacy));
+    NFB_CHECK(store.Flush());
+  }
+  NFB_CHECK(ReadFile(path).find("pos." + topology + "=812 604\n") != std::string::npos);
+
+  // 之后的启动：已经有 pos.* 项，旧文件（即使内容变了、换了拓扑）不再被读取
+  WriteFile(legacy, "1 2\n");
+  SettingsStore store;
+  NFB_REQUIRE(store.Open(OptionsFor(path)));
+  const std::string other = MonitorTopologyKey({ { 0, 0, 1366, 768, 96 } });
+  NFB_CHECK(!ImportLegacyBallPosition(store, other, legacy));
+  NFB_CHECK(!ImportLegacyBallPosition(store, topology, legacy));
+  long x = 0, y = 0;
+  NFB_CHECK(LoadBallPosition(store, topology, &x, &y));
+  NFB_CHECK_EQ(x, 812L);
+  NFB_CHECK_EQ(y, 604L);
+  NFB_CHECK(!LoadBallPosition(store, other, &x, &y));
+  NFB_CHECK(store.Flush());
+  NFB_CHECK_EQ(store.Writes(), 0u);
+}
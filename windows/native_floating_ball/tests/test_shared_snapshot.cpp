@@ -0,0 +1,261 @@
+// 共享内存快照通道（seqlock 双缓冲）：写者持续覆盖时读者不会读到撕裂的数据，版本号单调不减且与内容一致；
+// 读者卡在被改写的槽上时有限次重试后返回 Busy；读者停住不动时写者照常发布。
+// 读写两端各自映射同一个具名区域（POSIX 上为 shm_open）；跨进程用例用 fork，Windows 上只跑进程内的用例。
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "test_harness.h"
+#include "core/seqlock_snapshot.h"
+#include "core/shared_region.h"
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t kCapacity = 64 * 1024;
+
+std::string UniqueName(const char* test) {
+  static int counter = 0;
+#ifdef _WIN32
+  const long long pid = 0;
+#else
+  const long long pid = (long long)getpid();
+#endif
+  return std::string("nfb_test_snapshot_") + test + "_" + std::to_string(pid) + "_" + std::to_string(++counter);
+}
+
+// 负载自带校验：首 8 字节为种子（= 发布后的版本号），长度与其余字节都由种子推出；撕裂的数据必然校验失败
+void FillPayload(std::vector<uint8_t>& buf, uint64_t seed) {
+  const size_t size = 1024 + (size_t)(seed * 7919 % (kCapacity - 1024));
+  buf.resize(size);
+  std::memcpy(buf.data(), &seed, 8);
+  for (size_t i = 8; i < size; ++i) buf[i] = (uint8_t)(seed * 31 + i);
+}
+
+bool CheckPayload(const std::vector<uint8_t>& buf, uint64_t version) {
+  if (buf.size() < 8) return false;
+  uint64_t seed;
+  std::memcpy(&seed, buf.data(), 8);
+  if (seed != version || buf.size() != 1024 + (size_t)(seed * 7919 % (kCapacity - 1024))) return false;
+  for (size_t i = 8; i < buf.size(); ++i) {
+    if (buf[i] != (uint8_t)(seed * 31 + i)) return false;
+  }
+  return true;
+}
+
+// 一个写端映射 + 写者；区域在析构时删除
+struct WriterSide {
+  SharedRegion region;
+  SeqlockSnapshotWriter writer;
+  std::vector<uint8_t> buf;
+
+  bool Create(const std::string& name) {
+    const size_t size = SeqlockSnapshot::RegionSize(kCapacity);
+    return region.Create(name, size) && writer.Attach(region.Data(), size, kCapacity, true);
+  }
+  // 发布下一个版本（种子 = 版本号）
+  bool PublishNext() {
+    FillPayload(buf, writer.Version() + 1);
+    return writer.Publish(buf.data(), buf.size());
+  }
+};
+
+struct ReaderSide {
+  SharedRegion region;
+  SeqlockSnapshotReader reader;
+
+  bool Open(const std::string& name) {
+    const size_t size = SeqlockSnapshot::RegionSize(kCapacity);
+    return region.Open(name, size) && reader.Attach(region.Data(), size);
+  }
+};
+
+struct ReadTally {
+  uint64_t ok{0};
+  uint64_t busy{0};
+  uint64_t torn{0};
+  uint64_t backwards{0};
+  uint64_t lastVersion{0};
+};
+
+// 读到 okTarget 次成功或超时为止，统计撕裂读与版本回退
+void ReadUntil(SeqlockSnapshotReader& reader, uint64_t okTarget, std::chrono::milliseconds budget, ReadTally* tally) {
+  std::vector<uint8_t> out;
+  const auto deadline = std::chrono::steady_clock::now() + budget;
+  while (tally->ok < okTarget && std::chrono::steady_clock::now() < deadline) {
+    uint64_t version = 0;
+    const SeqlockSnapshotReader::Status status = reader.Read(&out, &version);
+    if (status != SeqlockSnapshotReader::Status::Ok) {
+      ++tally->busy;
+      continue;
+    }
+    ++tally->ok;
+    if (!CheckPayload(out, version)) ++tally->torn;
+    if (version < tally->lastVersion) ++tally->backwards;
+    tally->lastVersion = version;
+  }
+}
+
+} // namespace
+
+NFB_TEST(SharedSnapshot, EmptyThenPublishedRoundTrip) {
+  const std::string name = UniqueName("basic");
+  WriterSide w;
+  NFB_REQUIRE(w.Create(name));
+  ReaderSide r;
+  NFB_REQUIRE(r.Open(name));
+  std::vector<uint8_t> out;
+  uint64_t version = 0;
+  NFB_CHECK_EQ(r.reader.Read(&out, &version), SeqlockSnapshotReader::Status::Empty);
+  for (int i = 0; i < 5; ++i) {
+    NFB_REQUIRE(w.PublishNext());
+    NFB_CHECK_EQ(r.reader.Read(&out, &version), SeqlockSnapshotReader::Status::Ok);
+    NFB_CHECK_EQ(version, (uint64_t)i + 1);
+    NFB_CHECK(CheckPayload(out, version));
+  }
+  // 超过容量的快照不发布，版本不变
+  std::vector<uint8_t> big(kCapacity + 1);
+  NFB_CHECK(!w.writer.Publish(big.data(), big.size()));
+  NFB_CHECK_EQ(r.reader.Version(), 5u);
+  NFB_CHECK_EQ(r.reader.Retries(), 0u);
+}
+
+NFB_TEST(SharedSnapshot, ConcurrentReadsAreNeverTorn) {
+  const std::string name = UniqueName("stress");
+  WriterSide w;
+  NFB_REQUIRE(w.Create(name));
+  NFB_REQUIRE(w.PublishNext());
+  ReaderSide r1, r2;
+  NFB_REQUIRE(r1.Open(name));
+  NFB_REQUIRE(r2.Open(name));
+
+  std::atomic<bool> stop{false};
+  std::thread writerThread([&] {
+    while (!stop.load(std::memory_order_relaxed)) w.PublishNext();
+  });
+  ReadTally t1, t2;
+  std::thread readerThread([&] { ReadUntil(r2.reader, 3000, std::chrono::milliseconds(1500), &t2); });
+  ReadUntil(r1.reader, 3000, std::chrono::milliseconds(1500), &t1);
+  readerThread.join();
+  stop = true;
+  writerThread.join();
+
+  for (const ReadTally* t : { &t1, &t2 }) {
+    NFB_CHECK(t->ok > 0);
+    NFB_CHECK_EQ(t->torn, 0u);
+    NFB_CHECK_EQ(t->backwards, 0u);
+    NFB_CHECK(t->lastVersion <= w.writer.Version());
+  }
+  NFB_CHECK(w.writer.Version() > 1);
+}
+
+NFB_TEST(SharedSnapshot, ReaderOnRewrittenSlotGivesUpAsBusy) {
+  // 模拟读者永远赶不上写者：当前版本所在槽的序号停在奇数（写入中）。
+  // 读者有限次重试后返回 Busy，不返回半写的数据；写者发布下一版（写另一个槽）后读者恢复。
+  const std::string name = UniqueName("busy");
+  WriterSide w;
+  NFB_REQUIRE(w.Create(name));
+  NFB_REQUIRE(w.PublishNext());
+  ReaderSide r;
+  NFB_REQUIRE(r.Open(name));
+
+  // 布局：64 字节头部 | 槽 0 | 槽 1，每槽以 seq 字开头；版本 1 在槽 1
+  const size_t slotStride = (SeqlockSnapshot::RegionSize(kCapacity) - 64) / 2;
+  std::atomic<uint64_t>* seq = reinterpret_cast<std::atomic<uint64_t>*>(static_cast<uint8_t*>(w.region.Data()) + 64 + slotStride);
+  const uint64_t saved = seq->load();
+  seq->store(saved + 1);
+
+  std::vector<uint8_t> out(3, 0xEE);
+  uint64_t version = 0;
+  NFB_CHECK_EQ(r.reader.Read(&out, &version, 16), SeqlockSnapshotReader::Status::Busy);
+  NFB_CHECK_EQ(r.reader.Retries(), 16u);
+  NFB_CHECK_EQ(out.size(), 3u); // 没有被改写
+  NFB_CHECK_EQ(version, 0u);
+  NFB_CHECK_EQ(r.reader.Read(&out, &version, 0), SeqlockSnapshotReader::Status::Busy);
+  NFB_CHECK_EQ(r.reader.Retries(), 16u);
+
+  NFB_REQUIRE(w.PublishNext());
+  NFB_CHECK_EQ(r.reader.Read(&out, &version), SeqlockSnapshotReader::Status::Ok);
+  NFB_CHECK_EQ(version, 2u);
+  NFB_CHECK(CheckPayload(out, version));
+  seq->store(saved);
+}
+
+#ifndef _WIN32
+
+NFB_TEST(SharedSnapshot, CrossProcessWriterNeverTearsReads) {
+  // 写者在子进程里不停发布，父进程读
+  const std::string name = UniqueName("xproc");
+  WriterSide w;
+  NFB_REQUIRE(w.Create(name));
+  NFB_REQUIRE(w.PublishNext());
+  const pid_t pid = fork();
+  if (pid == 0) {
+    for (;;) w.PublishNext();
+  }
+  NFB_REQUIRE(pid > 0);
+  ReaderSide r;
+  ReadTally tally;
+  if (r.Open(name)) ReadUntil(r.reader, 3000, std::chrono::milliseconds(1500), &tally);
+  const uint64_t lastSeen = r.reader.Version();
+  kill(pid, SIGKILL);
+  waitpid(pid, nullptr, 0);
+  NFB_REQUIRE(r.region.IsOpen());
+  NFB_CHECK(tally.ok > 0);
+  NFB_CHECK_EQ(tally.torn, 0u);
+  NFB_CHECK_EQ(tally.backwards, 0u);
+  NFB_CHECK(lastSeen > 1); // 子进程确实在发布
+}
+
+NFB_TEST(SharedSnapshot, StoppedReaderDoesNotBlockWriter) {
+  // 读者进程读到一半被挂起（SIGSTOP），永远不再完成：读者不写共享内存，写者照常发布，
+  // 其他读者读到的始终是最新且完整的快照
+  const std::string name = UniqueName("stopped");
+  WriterSide w;
+  NFB_REQUIRE(w.Create(name));
+  NFB_REQUIRE(w.PublishNext());
+  const pid_t pid = fork();
+  if (pid == 0) {
+    ReaderSide stuck;
+    if (!stuck.Open(name)) _exit(1);
+    std::vector<uint8_t> out;
+    for (;;) stuck.reader.Read(&out, nullptr);
+  }
+  NFB_REQUIRE(pid > 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  kill(pid, SIGSTOP);
+
+  // 失败也要走到下面杀掉子进程，这里不用 NFB_REQUIRE
+  ReaderSide r;
+  const bool opened = r.Open(name);
+  NFB_CHECK(opened);
+  std::vector<uint8_t> out;
+  int published = 0, consistent = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; opened && i < 2000; ++i) {
+    if (!w.PublishNext()) break;
+    ++published;
+    uint64_t version = 0;
+    if (r.reader.Read(&out, &version) == SeqlockSnapshotReader::Status::Ok && version == w.writer.Version() &&
+        CheckPayload(out, version)) {
+      ++consistent;
+    }
+  }
+  NFB_CHECK_EQ(published, 2000);
+  NFB_CHECK_EQ(consistent, 2000);
+  NFB_CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+  NFB_CHECK_EQ(r.reader.Retries(), 0u);
+  kill(pid, SIGKILL);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  NFB_CHECK(WIFSIGNALED(status)); // 直到被杀都停在读循环里，没有因打开失败提前退出
+}
+
+#endif // !_WIN32
@@ -0,0 +1,280 @@
+// 单实例：锁互斥、同时启动只选出一个主实例、端点过期/主实例崩溃后的回退，以及激活请求的编解码。
+// 多进程用例用 fork（POSIX）；Windows 上只跑进程内的用例。
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include "test_harness.h"
+#include "core/single_instance.h"
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 每个用例独占一个名字，避免与并行运行的测试或真实实例冲突
+std::string UniqueName(const char* test) {
+  static int counter = 0;
+#ifdef _WIN32
+  const long long pid = 0;
+#else
+  const long long pid = (long long)getpid();
+#endif
+  return std::string("NfbTest.") + test + "." + std::to_string(pid) + "." + std::to_string(++counter);
+}
+
+// 锁文件按设计不删除（见 single_instance_posix.cpp）；测试结束时自己清理
+struct LockFileCleanup {
+  explicit LockFileCleanup(std::string n) : name(std::move(n)) {}
+  ~LockFileCleanup() {
+#ifndef _WIN32
+    const char* dir = std::getenv("XDG_RUNTIME_DIR");
+    unlink((std::string(dir && *dir ? dir : "/tmp") + "/" + name + ".lock").c_str());
+#endif
+  }
+  std::string name;
+};
+
+} // namespace
+
+NFB_TEST(SingleInstance, LockIsExclusive) {
+  const std::string name = UniqueName("Lock");
+  const LockFileCleanup cleanup(name);
+  InstanceLock a, b;
+  NFB_REQUIRE(a.TryAcquire(name));
+  NFB_CHECK(!b.TryAcquire(name));
+  a.Release();
+  NFB_CHECK(b.TryAcquire(name));
+  NFB_CHECK(!a.TryAcquire(name));
+}
+
+NFB_TEST(SingleInstance, SecondLauncherForwardsToPublishedEndpoint) {
+  const std::string name = UniqueName("Forward");
+  const LockFileCleanup cleanup(name);
+  SingleInstance primary(name);
+  NFB_REQUIRE(primary.Claim(std::chrono::milliseconds(0), [](const SingleInstance::Endpoint&) { return false; }) ==
+              InstanceRole::Primary);
+  primary.Publish({ 1234, 0xABCDu });
+
+  SingleInstance second(name);
+  SingleInstance::Endpoint seen;
+  const InstanceRole role = second.Claim(std::chrono::milliseconds(1000), [&](const SingleInstance::Endpoint& e) {
+    seen = e;
+    return true;
+  });
+  NFB_CHECK_EQ(role, InstanceRole::Forwarded);
+  NFB_CHECK_EQ(seen.pid, 1234u);
+  NFB_CHECK_EQ(seen.window, 0xABCDu);
+  NFB_CHECK(!second.IsPrimary());
+}
+
+NFB_TEST(SingleInstance, UnpublishedPrimaryTimesOut) {
+  // 主实例持锁但还在启动：后来者等待到超时，不会自己也成为主实例
+  const std::string name = UniqueName("Starting");
+  const LockFileCleanup cleanup(name);
+  SingleInstance primary(name);
+  NFB_REQUIRE(primary.Claim(std::chrono::milliseconds(0), [](const SingleInstance::Endpoint&) { return false; }) ==
+              InstanceRole::Primary);
+  SingleInstance second(name);
+  int forwards = 0;
+  const auto start = std::chrono::steady_clock::now();
+  const InstanceRole role = second.Claim(std::chrono::milliseconds(60), [&](const SingleInstance::Endpoint&) {
+    ++forwards;
+    return true;
+  });
+  NFB_CHECK_EQ(role, InstanceRole::TimedOut);
+  NFB_CHECK_EQ(forwards, 0);
+  NFB_CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(60));
+}
+
+NFB_TEST(SingleInstance, StaleEndpointFallsBackToLock) {
+  // 转交时主实例恰好退出：forward 失败后重新抢锁，成为新的主实例
+  const std::string name = UniqueName("Stale");
+  const LockFileCleanup cleanup(name);
+  auto primary = std::make_unique<SingleInstance>(name);
+  NFB_REQUIRE(primary->Claim(std::chrono::milliseconds(0), [](const SingleInstance::Endpoint&) { return false; }) ==
+              InstanceRole::Primary);
+  primary->Publish({ 1, 1 });
+
+  SingleInstance second(name);
+  int forwards = 0;
+  const InstanceRole role = second.Claim(std::chrono::milliseconds(1000), [&](const SingleInstance::Endpoint&) {
+    ++forwards;
+    primary.reset(); // 主实例在消息送达前退出
+    return false;
+  });
+  NFB_CHECK_EQ(role, InstanceRole::Primary);
+  NFB_CHECK_EQ(forwards, 1);
+  NFB_CHECK(second.IsPrimary());
+}
+
+#ifndef _WIN32
+
+namespace {
+
+// fork 出的子进程的退出码
+constexpr int kExitPrimary = 10;
+constexpr int kExitForwarded = 11;
+constexpr int kExitTimedOut = 12;
+
+struct RaceShared {
+  std::atomic<uint32_t> go;
+  std::atomic<uint32_t> forwarded;
+  std::atomic<uint32_t> primaries;
+};
+
+} // namespace
+
+NFB_TEST(SingleInstance, SimultaneousLaunchersElectOnePrimary) {
+  constexpr int kLaunchers = 12;
+  constexpr int kRounds = 5;
+  for (int round = 0; round < kRounds; ++round) {
+    const std::string name = UniqueName("Race");
+    const LockFileCleanup cleanup(name);
+    void* mem = mmap(nullptr, sizeof(RaceShared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    NFB_REQUIRE(mem != MAP_FAILED);
+    RaceShared* shared = new (mem) RaceShared{};
+
+    std::vector<pid_t> children;
+    for (int i = 0; i < kLaunchers; ++i) {
+      const pid_t pid = fork();
+      if (pid == 0) {
+        int code;
+        {
+          // 所有子进程在同一时刻开始抢锁
+          while (!shared->go.load(std::memory_order_acquire)) {}
+          SingleInstance instance(name);
+          const InstanceRole role = instance.Claim(std::chrono::milliseconds(5000), [&](const SingleInstance::Endpoint& e) {
+            if (e.pid == 0 || kill((pid_t)e.pid, 0) != 0) return false;
+            shared->forwarded.fetch_add(1);
+            return true;
+          });
+          if (role == InstanceRole::Primary) {
+            shared->primaries.fetch_add(1);
+            // 模拟启动耗时后再发布端点，然后等所有后来者转交完毕
+            usleep(20000);
+            instance.Publish({ (uint32_t)getpid(), 1 });
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (shared->forwarded.load() + 1 < kLaunchers && std::chrono::steady_clock::now() < deadline) usleep(1000);
+          }
+          code = role == InstanceRole::Primary ? kExitPrimary : role == InstanceRole::Forwarded ? kExitForwarded : kExitTimedOut;
+        }
+        _exit(code);
+      }
+      if (pid < 0) break;
+      children.push_back(pid);
+    }
+    shared->go.store(1, std::memory_order_release);
+    NFB_CHECK_EQ(children.size(), (size_t)kLaunchers);
+
+    int primaries = 0, forwarded = 0, other = 0;
+    for (pid_t pid : children) {
+      int status = 0;
+      waitpid(pid, &status, 0);
+      const int code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+      if (code == kExitPrimary) ++primaries;
+      else if (code == kExitForwarded) ++forwarded;
+      else ++other;
+    }
+    NFB_CHECK_EQ(primaries, 1);
+    NFB_CHECK_EQ(forwarded, (int)children.size() - 1);
+    NFB_CHECK_EQ(other, 0);
+    NFB_CHECK_EQ(shared->primaries.load(), 1u);
+    munmap(mem, sizeof(RaceShared));
+  }
+}
+
+NFB_TEST(SingleInstance, CrashedPrimaryReleasesLockAndEndpoint) {
+  // 主实例发布端点后被 SIGKILL：锁随进程释放；新主实例作废残留的端点，
+  // 在它自己发布之前，后来者不会转交到死掉的旧进程
+  const std::string name = UniqueName("Crash");
+  const LockFileCleanup cleanup(name);
+  int ready[2];
+  NFB_REQUIRE(pipe(ready) == 0);
+  const pid_t pid = fork();
+  if (pid == 0) {
+    close(ready[0]);
+    SingleInstance instance(name);
+    const bool primary = instance.Claim(std::chrono::milliseconds(0), [](const SingleInstance::Endpoint&) {
+      return false;
+    }) == InstanceRole::Primary;
+    if (primary) instance.Publish({ (uint32_t)getpid(), 7 });
+    const char byte = primary ? 1 : 0;
+    if (write(ready[1], &byte, 1) != 1) _exit(1);
+    for (;;) pause();
+  }
+  NFB_REQUIRE(pid > 0);
+  close(ready[1]);
+  char byte = 0;
+  const bool published = read(ready[0], &byte, 1) == 1 && byte == 1;
+  close(ready[0]);
+  kill(pid, SIGKILL);
+  waitpid(pid, nullptr, 0);
+  NFB_REQUIRE(published);
+
+  SingleInstance successor(name);
+  int forwards = 0;
+  NFB_CHECK_EQ(successor.Claim(std::chrono::milliseconds(1000), [&](const SingleInstance::Endpoint&) {
+    ++forwards;
+    return false;
+  }), InstanceRole::Primary);
+  NFB_CHECK_EQ(forwards, 0);
+
+  SingleInstance late(name);
+  NFB_CHECK_EQ(late.Claim(std::chrono::milliseconds(30), [&](const SingleInstance::Endpoint&) {
+    ++forwards;
+    return true;
+  }), InstanceRole::TimedOut);
+  NFB_CHECK_EQ(forwards, 0);
+
+  successor.Publish({ 99, 9 });
+  SingleInstance::Endpoint seen;
+  NFB_CHECK_EQ(late.Claim(std::chrono::milliseconds(1000), [&](const SingleInstance::Endpoint& e) {
+    seen = e;
+    return true;
+  }), InstanceRole::Forwarded);
+  NFB_CHECK_EQ(seen.pid, 99u);
+}
+
+#endif // !_WIN32
+
+NFB_TEST(SingleInstance, ActivationRoundTrip) {
+  const std::vector<std::string> args = { "--open", "task:42", "", std::string(1000, 'x'), "中文参数" };
+  const std::vector<uint8_t> payload = EncodeInstanceActivation(args);
+  std::vector<std::string> out;
+  NFB_REQUIRE(DecodeInstanceActivation(payload.data(), payload.size(), &out));
+  NFB_CHECK(out == args);
+  NFB_CHECK(DecodeInstanceActivation(EncodeInstanceActivation({}).data(), 8, &out) && out.empty());
+}
+
+NFB_TEST(SingleInstance, ActivationRejectsMalformed) {
+  const std::vector<uint8_t> good = EncodeInstanceActivation({ "a", "bc" });
+  std::vector<std::string> out;
+  for (size_t len = 0; len < good.size(); ++len) {
+    const std::vector<uint8_t> cut(good.begin(), good.begin() + len);
+    NFB_CHECK(!DecodeInstanceActivation(cut.data(), len, &out));
+  }
+  std::vector<uint8_t> bytes = good;
+  bytes.push_back(0); // 多余的尾部
+  NFB_CHECK(!DecodeInstanceActivation(bytes.data(), bytes.size(), &out));
+  bytes = good;
+  bytes[0] ^= 1;
+  NFB_CHECK(!DecodeInstanceActivation(bytes.data(), bytes.size(), &out));
+  bytes = good;
+  bytes[4] = 0xFF; // 参数个数超过上限
+  NFB_CHECK(!DecodeInstanceActivation(bytes.data(), bytes.size(), &out));
+  bytes = good;
+  bytes[8] = 0xFF; // 参数长度超出负载
+  NFB_CHECK(!DecodeInstanceActivation(bytes.data(), bytes.size(), &out));
+  NFB_CHECK(!DecodeInstanceActivation(nullptr, 16, &out));
+  const std::vector<uint8_t> huge = EncodeInstanceActivation({ std::string(70 * 1024, 'x') });
+  NFB_CHECK(!DecodeInstanceActivation(huge.data(), huge.size(), &out));
+}
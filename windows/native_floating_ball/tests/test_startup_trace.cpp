@@ -0,0 +1,156 @@
+// 启动时间线的 Chrome trace JSON 导出：整体是合法 JSON、进程元数据、嵌套区间的包含关系、
+// 原点之前的负偏移加载区间、瞬时事件、名称的 JSON 转义，以及超出容量的事件计入 Dropped。
+#include <string>
+#include <vector>
+#include "test_harness.h"
+#include "test_json.h"
+#include "core/startup_trace.h"
+
+namespace {
+
+// 导出并解析；返回 traceEvents 中的非元数据事件
+std::vector<Json> ExportEvents(const StartupTracer& tracer, Json* doc) {
+  const bool ok = ParseJson(tracer.ToChromeJson(), doc);
+  if (!ok || !doc->Has("traceEvents")) {
+    ReportFailure(__FILE__, __LINE__, "ToChromeJson is not valid trace JSON");
+    return {};
+  }
+  std::vector<Json> events;
+  for (const Json& e : (*doc)["traceEvents"].array) {
+    if (e["ph"].string != "M") events.push_back(e);
+  }
+  return events;
+}
+
+const Json* EventNamed(const std::vector<Json>& events, const std::string& name) {
+  for (const Json& e : events) {
+    if (e["name"].string == name) return &e;
+  }
+  return nullptr;
+}
+
+} // namespace
+
+NFB_TEST(StartupTrace, ExportsProcessMetadata) {
+  StartupTracer tracer;
+  Json doc;
+  NFB_CHECK(ExportEvents(tracer, &doc).empty());
+  NFB_CHECK(doc["traceEvents"].array.empty());
+  NFB_CHECK(doc["displayTimeUnit"].string == "ms");
+
+  tracer.SetProcess(4242, "chat_desktop");
+  tracer.AddSpan("a", 1500, 2500, 7);
+  const std::vector<Json> events = ExportEvents(tracer, &doc);
+  NFB_REQUIRE(doc["traceEvents"].array.size() == 2);
+  const Json& meta = doc["traceEvents"].array[0];
+  NFB_CHECK(meta["name"].string == "process_name");
+  NFB_CHECK(meta["ph"].string == "M");
+  NFB_CHECK_EQ(meta["pid"].number, 4242.0);
+  NFB_CHECK(meta["args"]["name"].string == "chat_desktop");
+  NFB_REQUIRE(events.size() == 1);
+  NFB_CHECK(events[0]["ph"].string == "X");
+  NFB_CHECK(events[0]["cat"].string == "startup");
+  NFB_CHECK_EQ(events[0]["ts"].number, 1.5);
+  NFB_CHECK_EQ(events[0]["dur"].number, 2.5);
+  NFB_CHECK_EQ(events[0]["pid"].number, 4242.0);
+  NFB_CHECK_EQ(events[0]["tid"].number, 7.0);
+}
+
+NFB_TEST(StartupTrace, NestedSpansAreContained) {
+  StartupTracer tracer;
+  {
+    StartupTracer::Span outer(tracer, "outer");
+    {
+      StartupTracer::Span middle(tracer, "middle", 1);
+      { StartupTracer::Span inner(tracer, "inner", 1); }
+      StartupTracer::Span sibling(tracer, "sibling", 1);
+      sibling.End();
+      sibling.End(); // 提前结束后不再重复记录
+    }
+    tracer.AddInstant("first frame");
+  }
+  // 区间在结束时记录：内层先于外层
+  NFB_REQUIRE(tracer.Size() == 5);
+  NFB_CHECK(std::string(tracer.At(0).name) == "inner");
+  NFB_CHECK(std::string(tracer.At(4).name) == "outer");
+
+  Json doc;
+  const std::vector<Json> events = ExportEvents(tracer, &doc);
+  NFB_REQUIRE(events.size() == 5);
+  const Json* outer = EventNamed(events, "outer");
+  const Json* middle = EventNamed(events, "middle");
+  const Json* inner = EventNamed(events, "inner");
+  const Json* sibling = EventNamed(events, "sibling");
+  const Json* instant = EventNamed(events, "first frame");
+  NFB_REQUIRE(outer && middle && inner && sibling && instant);
+  // 微秒保留三位小数，各自舍入，容差 1ns
+  const auto contains = [](const Json& a, const Json& b) {
+    const double eps = 0.0011;
+    return b["ts"].number >= a["ts"].number - eps &&
+           b["ts"].number + b["dur"].number <= a["ts"].number + a["dur"].number + eps;
+  };
+  NFB_CHECK(contains(*outer, *middle));
+  NFB_CHECK(contains(*middle, *inner));
+  NFB_CHECK(contains(*middle, *sibling));
+  NFB_CHECK((*sibling)["ts"].number >= (*inner)["ts"].number + (*inner)["dur"].number - 0.0011);
+  NFB_CHECK_EQ((*inner)["tid"].number, 1.0);
+  NFB_CHECK_EQ((*outer)["tid"].number, 0.0);
+  // 瞬时事件：ph=i、进程级作用域、没有 dur，落在外层区间之内
+  NFB_CHECK((*instant)["ph"].string == "i");
+  NFB_CHECK((*instant)["s"].string == "p");
+  NFB_CHECK(!instant->Has("dur"));
+  NFB_CHECK((*instant)["ts"].number >= (*middle)["ts"].number + (*middle)["dur"].number - 0.0011);
+  NFB_CHECK((*instant)["ts"].number <= (*outer)["ts"].number + (*outer)["dur"].number + 0.0011);
+}
+
+NFB_TEST(StartupTrace, NegativeOffsetLoaderSpan) {
+  // 与 runner/main.cpp 一致：进程创建 -> wWinMain 的加载时间以负起点补记，止于原点
+  StartupTracer tracer;
+  const int64_t loaderNs = 12345678;
+  tracer.AddSpan("process start -> wWinMain", -loaderNs, loaderNs);
+  { StartupTracer::Span span(tracer, "wWinMain -> message loop"); }
+  Json doc;
+  const std::vector<Json> events = ExportEvents(tracer, &doc);
+  NFB_REQUIRE(events.size() == 2);
+  const Json& loader = events[0];
+  NFB_CHECK_EQ(loader["ts"].number, -12345.678);
+  NFB_CHECK_EQ(loader["dur"].number, 12345.678);
+  NFB_CHECK_EQ(loader["ts"].number + loader["dur"].number, 0.0);
+  NFB_CHECK(tracer.ToChromeJson().find("\"ts\":-12345.678,\"dur\":12345.678") != std::string::npos);
+  NFB_CHECK(events[1]["ts"].number >= 0.0); // 原点之后的阶段紧接其后
+}
+
+NFB_TEST(StartupTrace, NamesAreJsonEscaped) {
+  static const char kQuoted[] = "say \"hi\" \\ path\\to";
+  static const char kControl[] = "line1\nline2\ttab\r\x01\x1f end";
+  static const char kUtf8[] = "启动 → 首帧";
+  static const char kProcess[] = "proc \"x\"\n";
+  StartupTracer tracer;
+  tracer.SetProcess(1, kProcess);
+  tracer.AddSpan(kQuoted, 0, 1);
+  tracer.AddSpan(kControl, 0, 1);
+  tracer.AddSpan(kUtf8, 0, 1);
+  tracer.AddSpan(nullptr, 0, 1); // 没有名称：导出空字符串
+  const std::string json = tracer.ToChromeJson();
+  NFB_CHECK(json.find('\n') == std::string::npos);
+  NFB_CHECK(json.find("\\u0001") != std::string::npos);
+  Json doc;
+  const std::vector<Json> events = ExportEvents(tracer, &doc);
+  NFB_REQUIRE(events.size() == 4);
+  NFB_CHECK(events[0]["name"].string == kQuoted);
+  NFB_CHECK(events[1]["name"].string == kControl);
+  NFB_CHECK(events[2]["name"].string == kUtf8);
+  NFB_CHECK(events[3]["name"].string.empty());
+  NFB_CHECK(doc["traceEvents"].array[0]["args"]["name"].string == kProcess);
+}
+
+NFB_TEST(StartupTrace, OverflowIsCountedAsDropped) {
+  StartupTracer tracer;
+  for (size_t i = 0; i < StartupTracer::kCapacity + 44; ++i) tracer.AddSpan("span", (int64_t)i * 1000, 10);
+  NFB_CHECK_EQ(tracer.Size(), StartupTracer::kCapacity);
+  NFB_CHECK_EQ(tracer.Dropped(), 44u);
+  Json doc;
+  const std::vector<Json> events = ExportEvents(tracer, &doc);
+  NFB_CHECK_EQ(events.size(), StartupTracer::kCapacity);
+  NFB_CHECK_EQ(events.back()["ts"].number, (double)(StartupTracer::kCapacity - 1));
+}
@@ -0,0 +1,318 @@
+// 任务列表模型：200 行列表里只变一个任务时，插入/移除/移动/更新只标记那一行；
+// LIS 只把真正移动的行标为 Moved；残影行在原位淡出，一次移除超过 kMaxGhosts（32）行时不留残影。
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "test_harness.h"
+#include "core/task_list_model.h"
+
+namespace {
+
+constexpr size_t kRows = 200;
+constexpr size_t kMaxGhosts = 32; // 与 task_list_model.cpp 一致
+constexpr float kRowAnimSeconds = 0.15f;
+
+std::u16string Id(size_t n) {
+  const std::string s = std::to_string(n);
+  return std::u16string(s.begin(), s.end());
+}
+
+// 持有字符串，按当前顺序生成视图
+struct Tasks {
+  std::vector<std::u16string> ids;
+  std::vector<std::u16string> titles;
+  std::vector<uint8_t> flags;
+
+  static Tasks Range(size_t count) {
+    Tasks tasks;
+    for (size_t i = 0; i < count; ++i) tasks.Push(Id(i));
+    return tasks;
+  }
+  void Push(const std::u16string& id, size_t at = static_cast<size_t>(-1)) {
+    at = (std::min)(at, ids.size());
+    ids.insert(ids.begin() + at, id);
+    titles.insert(titles.begin() + at, u"task " + id);
+    flags.insert(flags.begin() + at, (uint8_t)kTaskUnread);
+  }
+  void Erase(size_t at) {
+    ids.erase(ids.begin() + at);
+    titles.erase(titles.begin() + at);
+    flags.erase(flags.begin() + at);
+  }
+  void Move(size_t from, size_t to) {
+    const std::u16string id = ids[from], title = titles[from];
+    const uint8_t f = flags[from];
+    Erase(from);
+    ids.insert(ids.begin() + to, id);
+    titles.insert(titles.begin() + to, title);
+    flags.insert(flags.begin() + to, f);
+  }
+  std::vector<TaskItemView> Views() const {
+    std::vector<TaskItemView> views(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+      views[i].id = ids[i];
+      views[i].title = titles[i];
+      views[i].flags = flags[i];
+    }
+    return views;
+  }
+};
+
+// 动画全部结束（残影回收、插入行完全显示）
+void Settle(TaskListModel& model) {
+  for (int i = 0; i < 100 && model.Tick(0.05f); ++i) {}
+}
+
+// 载入 kRows 行并结束动画，然后用同一份数据再替换一次，清掉 Inserted 标记
+TaskListModel Loaded(const Tasks& tasks) {
+  TaskListModel model;
+  model.Replace(tasks.Views());
+  Settle(model);
+  model.Replace(tasks.Views());
+  return model;
+}
+
+size_t CountChange(const TaskListModel& model, RowChange change) {
+  size_t n = 0;
+  for (size_t i = 0; i < model.Size(); ++i) n += model.Row(i).change == change;
+  return n;
+}
+
+// 显示顺序与期望的 live id 一致（残影行跳过）
+bool LiveOrderIs(const TaskListModel& model, const Tasks& tasks) {
+  size_t live = 0;
+  for (size_t i = 0; i < model.Size(); ++i) {
+    const TaskRow& row = model.Row(i);
+    if (row.removing) continue;
+    if (live >= tasks.ids.size() || row.item.id != tasks.ids[live]) return false;
+    ++live;
+  }
+  return live == tasks.ids.size();
+}
+
+size_t LongestIncreasing(const std::vector<size_t>& keys) {
+  std::vector<size_t> tails;
+  for (size_t key : keys) {
+    auto pos = std::lower_bound(tails.begin(), tails.end(), key);
+    if (pos == tails.end()) tails.push_back(key); else *pos = key;
+  }
+  return tails.size();
+}
+
+} // namespace
+
+NFB_TEST(TaskListModel, FirstSnapshotInsertsEveryRow) {
+  const Tasks tasks = Tasks::Range(kRows);
+  TaskListModel model;
+  const TaskListDiff diff = model.Replace(tasks.Views());
+  NFB_CHECK_EQ(diff.inserted, kRows);
+  NFB_CHECK_EQ(diff.updated + diff.moved + diff.removed, 0u);
+  NFB_CHECK_EQ(CountChange(model, RowChange::Inserted), kRows);
+  NFB_CHECK(model.IsAnimating());
+  NFB_CHECK(LiveOrderIs(model, tasks));
+
+  // 同一份快照再来一次：没有任何差异，所有行恢复为 None
+  Settle(model);
+  NFB_CHECK(model.Replace(tasks.Views()).Empty());
+  NFB_CHECK_EQ(CountChange(model, RowChange::None), kRows);
+  NFB_CHECK(!model.IsAnimating());
+}
+
+NFB_TEST(TaskListModel, UpdateFlagsOnlyThatRow) {
+  Tasks tasks = Tasks::Range(kRows);
+  TaskListModel model = Loaded(tasks);
+  tasks.titles[77] = u"renamed";
+  const TaskListDiff diff = model.Replace(tasks.Views());
+  NFB_CHECK_EQ(diff.updated, 1u);
+  NFB_CHECK_EQ(diff.inserted + diff.moved + diff.removed, 0u);
+  for (size_t i = 0; i < model.Size(); ++i) {
+    const TaskRow& row = model.Row(i);
+    NFB_CHECK_EQ(row.change, i == 77 ? RowChange::Updated : RowChange::None);
+    NFB_CHECK_EQ(row.version, i == 77 ? 1u : 0u);
+  }
+  NFB_CHECK(model.Row(77).item.title == u"renamed");
+
+  // 只改未读标志也算更新
+  tasks.flags[3] = kTaskCompleted;
+  NFB_CHECK_EQ(model.Replace(tasks.Views()).updated, 1u);
+  NFB_CHECK_EQ(model.Row(3).change, RowChange::Updated);
+  NFB_CHECK_EQ(model.Row(77).change, RowChange::None);
+  NFB_CHECK_EQ(model.Row(77).version, 1u); // 未变化的行保留版本号
+}
+
+NFB_TEST(TaskListModel, InsertFlagsOnlyThatRow) {
+  Tasks tasks = Tasks::Range(kRows);
+  TaskListModel model = Loaded(tasks);
+  tasks.Push(u"new", 100);
+  const TaskListDiff diff = model.Replace(tasks.Views());
+  NFB_CHECK_EQ(diff.inserted, 1u);
+  NFB_CHECK_EQ(diff.updated + diff.moved + diff.removed, 0u);
+  NFB_CHECK(LiveOrderIs(model, tasks));
+  for (size_t i = 0; i < model.Size(); ++i) {
+    NFB_CHECK_EQ(model.Row(i).change, i == 100 ? RowChange::Inserted : RowChange::None);
+    NFB_CHECK_EQ(model.Row(i).anim, i == 100 ? 0.f : 1.f);
+  }
+  // 淡入
+  NFB_CHECK(model.IsAnimating());
+  NFB_CHECK(model.Tick(kRowAnimSeconds / 2));
+  NFB_CHECK(std::abs(model.Row(100).anim - 0.5f) < 1e-4f);
+  NFB_CHECK(!model.Tick(kRowAnimSeconds));
+  NFB_CHECK_EQ(model.Row(100).anim, 1.f);
+}
+
+NFB_TEST(TaskListModel, RemoveLeavesGhostInPlace) {
+  Tasks tasks = Tasks::Range(kRows);
+  TaskListModel model = Loaded(tasks);
+  tasks.Erase(50);
+  const TaskListDiff diff = model.Replace(tasks.Views());
+  NFB_CHECK_EQ(diff.removed, 1u);
+  NFB_CHECK_EQ(diff.inserted + diff.updated + diff.moved, 0u);
+  NFB_CHECK_EQ(model.Size(), kRows);
+  NFB_CHECK_EQ(model.LiveCount(), kRows - 1);
+  NFB_CHECK(LiveOrderIs(model, tasks));
+  for (size_t i = 0; i < model.Size(); ++i) {
+    const TaskRow& row = model.Row(i);
+    NFB_CHECK_EQ(row.removing, i == 50);
+    NFB_CHECK_EQ(row.change, RowChange::None);
+  }
+  NFB_CHECK(model.Row(50).item.id == Id(50));
+  NFB_CHECK(!model.Contains(Id(50)));
+  NFB_CHECK_EQ(model.IndexOf(Id(50)), -1);
+  NFB_CHECK_EQ(model.IndexOf(Id(51)), 51);
+}
+
+NFB_TEST(TaskListModel, MoveFlagsOnlyMovedRow) {
+  Tasks tasks = Tasks::Range(kRows);
+  TaskListModel model = Loaded(tasks);
+  tasks.Move(10, 150);
+  const TaskListDiff diff = model.Replace(tasks.Views());
+  NFB_CHECK_EQ(diff.moved, 1u);
+  NFB_CHECK_EQ(diff.inserted + diff.updated + diff.removed, 0u);
+  NFB_CHECK(LiveOrderIs(model, tasks));
+  for (size_t i = 0; i < model.Size(); ++i) {
+    NFB_CHECK_EQ(model.Row(i).change, i == 150 ? RowChange::Moved : RowChange::None);
+  }
+  NFB_CHECK(model.Row(150).item.id == Id(10));
+
+  // 末尾移到开头：只有这一行移动，而不是其余 199 行
+  tasks.Move(kRows - 1, 0);
+  NFB_CHECK_EQ(model.Replace(tasks.Views()).moved, 1u);
+  NFB_CHECK_EQ(model.Row(0).change, RowChange::Moved);
+
+  // 相邻两行交换：只标记其中一行
+  tasks.Move(5, 6);
+  NFB_CHECK_EQ(model.Replace(tasks.Views()).moved, 1u);
+  NFB_CHECK_EQ(CountChange(model, RowChange::Moved), 1u);
+
+  // 整表反转：LIS 长度为 1
+  std::reverse(tasks.ids.begin(), tasks.ids.end());
+  std::reverse(tasks.titles.begin(), tasks.titles.end());
+  std::reverse(tasks.flags.begin(), tasks.flags.end());
+  NFB_CHECK_EQ(model.Replace(tasks.Views()).moved, kRows - 1);
+
+  // 内容变化优先：既移动又改了标题的行标为 Updated（整行重排），不再计入 moved
+  tasks.Move(0, 100);
+  tasks.titles[100] = u"moved and renamed";
+  const TaskListDiff both = model.Replace(tasks.Views());
+  NFB_CHECK_EQ(both.updated, 1u);
+  NFB_CHECK_EQ(both.moved, 0u);
+  NFB_CHECK_EQ(model.Row(100).change, RowChange::Updated);
+}
+
+NFB_TEST(TaskListModel, MovedRowsAreComplementOfLongestIncreasingRun) {
+  // 随机打乱、删除、插入：未标记为 Moved 的保留行按旧下标递增，且数量等于 LIS 长度
+  std::mt19937 rng(29);
+  Tasks tasks = Tasks::Range(kRows);
+  TaskListModel model = Loaded(tasks);
+  size_t nextId = kRows;
+  for (int round = 0; round < 60; ++round) {
+    std::vector<std::u16string> before = tasks.ids;
+    const size_t swaps = rng() % 6;
+    for (size_t s = 0; s < swaps; ++s) tasks.Move(rng() % tasks.ids.size(), rng() % tasks.ids.size());
+    if (rng() % 2 && tasks.ids.size() > 10) tasks.Erase(rng() % tasks.ids.size());
+    if (rng() % 2) tasks.Push(Id(nextId++), rng() % (tasks.ids.size() + 1));
+
+    const TaskListDiff diff = model.Replace(tasks.Views());
+    NFB_CHECK(LiveOrderIs(model, tasks));
+    std::vector<size_t> keptOld;       // 保留行的旧下标（按新顺序）
+    std::vector<size_t> stillOld;      // 其中没有标记为 Moved 的
+    size_t moved = 0;
+    for (size_t i = 0; i < model.Size(); ++i) {
+      const TaskRow& row = model.Row(i);
+      if (row.removing || row.change == RowChange::Inserted) continue;
+      const size_t old = (size_t)(std::find(before.begin(), before.end(), row.item.id) - before.begin());
+      NFB_REQUIRE(old < before.size());
+      keptOld.push_back(old);
+      if (row.change == RowChange::Moved) ++moved; else stillOld.push_back(old);
+    }
+    NFB_CHECK(std::is_sorted(stillOld.begin(), stillOld.end()));
+    NFB_CHECK_EQ(stillOld.size(), LongestIncreasing(keptOld));
+    NFB_CHECK_EQ(diff.moved, moved);
+    Settle(model);
+  }
+}
+
+NFB_TEST(TaskListModel, GhostsFadeOutThenDisappear) {
+  Tasks tasks = Tasks::Range(kRows);
+  TaskListModel model = Loaded(tasks);
+  tasks.Erase(120);
+  tasks.Erase(20);
+  tasks.Erase(0);
+  model.Replace(tasks.Views());
+  NFB_CHECK_EQ(model.Size(), kRows);
+  NFB_CHECK(model.Row(0).removing && model.Row(20).removing && model.Row(120).removing);
+  NFB_CHECK(model.IsAnimating());
+
+  float last = 1.f;
+  while (model.Size() != model.LiveCount()) {
+    const bool animating = model.Tick(kRowAnimSeconds / 4);
+    if (model.Size() == model.LiveCount()) {
+      NFB_CHECK(!animating);
+      break;
+    }
+    const float anim = model.Row(0).anim;
+    NFB_CHECK(anim < last); // 单调淡出
+    NFB_CHECK_EQ(model.Row(20).anim, anim);
+    last = anim;
+  }
+  NFB_CHECK_EQ(model.Size(), kRows - 3);
+  NFB_CHECK(LiveOrderIs(model, tasks));
+  NFB_CHECK(!model.IsAnimating());
+
+  // 下一次替换直接丢弃还在淡出的残影
+  tasks.Erase(0);
+  model.Replace(tasks.Views());
+  NFB_CHECK_EQ(model.Size(), kRows - 3);
+  tasks.Erase(0);
+  model.Replace(tasks.Views());
+  NFB_CHECK_EQ(model.Size(), kRows - 4); // 只剩这一次的一个残影
+  NFB_CHECK_EQ(model.LiveCount(), kRows - 5);
+}
+
+NFB_TEST(TaskListModel, GhostsCappedAtMax) {
+  for (size_t removed : { kMaxGhosts, kMaxGhosts + 1 }) {
+    Tasks tasks = Tasks::Range(kRows);
+    TaskListModel model = Loaded(tasks);
+    for (size_t i = 0; i < removed; ++i) tasks.Erase(i); // 隔行删除
+    const TaskListDiff diff = model.Replace(tasks.Views());
+    NFB_CHECK_EQ(diff.removed, removed);
+    NFB_CHECK_EQ(model.LiveCount(), kRows - removed);
+    NFB_CHECK_EQ(model.Size(), removed <= kMaxGhosts ? kRows : kRows - removed);
+    NFB_CHECK_EQ(model.IsAnimating(), removed <= kMaxGhosts);
+    NFB_CHECK(LiveOrderIs(model, tasks));
+  }
+
+  // 增量路径同样限制：超过上限的批次在 EndBatch 时直接丢弃残影
+  for (size_t removed : { kMaxGhosts, kMaxGhosts + 1 }) {
+    Tasks tasks = Tasks::Range(kRows);
+    TaskListModel model = Loaded(tasks);
+    model.BeginBatch();
+    for (size_t i = 0; i < removed; ++i) NFB_CHECK(model.Remove(Id(i * 3)));
+    const TaskListDiff diff = model.EndBatch();
+    NFB_CHECK_EQ(diff.removed, removed);
+    NFB_CHECK_EQ(model.LiveCount(), kRows - removed);
+    NFB_CHECK_EQ(model.Size(), removed <= kMaxGhosts ? kRows : kRows - removed);
+  }
+}
@@ -0,0 +1,151 @@
+// TaskSyncReceiver：序号状态机，以及“整条增量要么全部应用、要么完全不动模型”
+#include <string>
+#include <vector>
+#include "test_harness.h"
+#include "core/task_list_model.h"
+#include "core/task_sync.h"
+#include "core/task_wire.h"
+
+namespace {
+
+// 以 id 列表编码一条负载；标题为 "t" + id + suffix
+std::vector<uint8_t> Encode(TaskWireKind kind, uint32_t sequence, const std::vector<std::u16string>& ids,
+                            const std::u16string& suffix = u"") {
+  std::vector<std::u16string> titles;
+  titles.reserve(ids.size());
+  for (const std::u16string& id : ids) titles.push_back(u"t" + id + suffix);
+  TaskWireWriter writer;
+  writer.Begin(kind, sequence);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    TaskItemView view;
+    view.id = ids[i];
+    view.title = titles[i];
+    writer.Add(view);
+  }
+  return writer.Finish();
+}
+
+std::vector<std::u16string> Ids(int first, int count) {
+  std::vector<std::u16string> ids;
+  for (int i = first; i < first + count; ++i) {
+    const std::string s = std::to_string(i);
+    ids.emplace_back(s.begin(), s.end());
+  }
+  return ids;
+}
+
+// 模型的 live 行（按显示顺序）及其标题
+std::vector<std::u16string> LiveTitles(const TaskListModel& model) {
+  std::vector<std::u16string> titles;
+  for (size_t i = 0; i < model.Size(); ++i) {
+    if (!model.Row(i).removing) titles.push_back(model.Row(i).item.title);
+  }
+  return titles;
+}
+
+TaskSyncResult Apply(TaskSyncReceiver& sync, const std::vector<uint8_t>& bytes, TaskListModel& model) {
+  return sync.Apply(bytes.data(), bytes.size(), model);
+}
+
+} // namespace
+
+NFB_TEST(TaskSync, SnapshotThenDeltas) {
+  TaskListModel model;
+  TaskSyncReceiver sync;
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Snapshot, 10, Ids(0, 5)), model), TaskSyncResult::Applied);
+  NFB_CHECK(sync.HasBase());
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Add, 11, Ids(5, 2)), model), TaskSyncResult::Applied);
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Update, 12, { u"1", u"6" }, u"!"), model), TaskSyncResult::Applied);
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Remove, 13, { u"0", u"3" }), model), TaskSyncResult::Applied);
+  NFB_CHECK_EQ(sync.LastSequence(), 13u);
+  const std::vector<std::u16string> expected = { u"t1!", u"t2", u"t4", u"t5", u"t6!" };
+  NFB_CHECK(LiveTitles(model) == expected);
+  NFB_CHECK_EQ(model.LiveCount(), 5u);
+}
+
+NFB_TEST(TaskSync, SequenceGapRequiresSnapshot) {
+  TaskListModel model;
+  TaskSyncReceiver sync;
+  Apply(sync, Encode(TaskWireKind::Snapshot, 1, Ids(0, 3)), model);
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Add, 3, Ids(3, 1)), model), TaskSyncResult::ResyncRequired);
+  NFB_CHECK_EQ(model.LiveCount(), 3u);
+  // 失去基线后，即便序号连续的增量也不再应用，直到新的快照
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Add, 2, Ids(3, 1)), model), TaskSyncResult::ResyncRequired);
+  NFB_CHECK_EQ(model.LiveCount(), 3u);
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Snapshot, 4, Ids(0, 4)), model), TaskSyncResult::Applied);
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Remove, 5, { u"2" }), model), TaskSyncResult::Applied);
+  NFB_CHECK_EQ(model.LiveCount(), 3u);
+}
+
+NFB_TEST(TaskSync, SequenceZeroSnapshotHasNoBase) {
+  TaskListModel model;
+  TaskSyncReceiver sync;
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Snapshot, 0, Ids(0, 2)), model), TaskSyncResult::Applied);
+  NFB_CHECK(!sync.HasBase());
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Add, 1, Ids(2, 1)), model), TaskSyncResult::ResyncRequired);
+  NFB_CHECK_EQ(model.LiveCount(), 2u);
+}
+
+NFB_TEST(TaskSync, UnknownIdLeavesModelUntouched) {
+  // 大批量删除里混进一个不存在的 id（位于末尾）：逐条应用会先删掉前面所有行
+  TaskListModel model;
+  TaskSyncReceiver sync;
+  Apply(sync, Encode(TaskWireKind::Snapshot, 1, Ids(0, 100)), model);
+  const std::vector<std::u16string> before = LiveTitles(model);
+  std::vector<std::u16string> remove = Ids(0, 40);
+  remove.push_back(u"missing");
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Remove, 2, remove), model), TaskSyncResult::ResyncRequired);
+  NFB_CHECK(LiveTitles(model) == before);
+  NFB_CHECK_EQ(model.Size(), 100u);
+
+  // 更新同理
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Snapshot, 3, Ids(0, 100)), model), TaskSyncResult::Applied);
+  std::vector<std::u16string> update = Ids(0, 40);
+  update.push_back(u"missing");
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Update, 4, update, u"!"), model), TaskSyncResult::ResyncRequired);
+  NFB_CHECK(LiveTitles(model) == before);
+  for (size_t i = 0; i < model.Size(); ++i) NFB_CHECK_EQ(model.Row(i).version, 0u);
+}
+
+NFB_TEST(TaskSync, DuplicateRemoveLeavesModelUntouched) {
+  TaskListModel model;
+  TaskSyncReceiver sync;
+  Apply(sync, Encode(TaskWireKind::Snapshot, 1, Ids(0, 10)), model);
+  NFB_CHECK_EQ(Apply(sync, Encode(TaskWireKind::Remove, 2, { u"1", u"5", u"1" }), model), TaskSyncResult::ResyncRequired);
+  NFB_CHECK_EQ(model.LiveCount(), 10u);
+  NFB_CHECK(!sync.HasBase());
+}
+
+NFB_TEST(TaskSync, TruncatedDeltaLeavesModelUntouched) {
+  TaskListModel model;
+  TaskSyncReceiver sync;
+  const std::vector<uint8_t> baseline = Encode(TaskWireKind::Snapshot, 1, Ids(0, 50));
+  for (TaskWireKind kind : { TaskWireKind::Add, TaskWireKind::Update, TaskWireKind::Remove }) {
+    const std::vector<uint8_t> full = Encode(kind, 2, kind == TaskWireKind::Add ? Ids(50, 20) : Ids(0, 20), u"!");
+    // 截在各处：count 明显放不下时 Open 直接拒绝，否则读到一半出错、要求重发快照；两种情况都不动模型
+    for (size_t len = kTaskWireHeaderSize + 2; len < full.size(); len += 14) {
+      Apply(sync, baseline, model);
+      const std::vector<std::u16string> before = LiveTitles(model);
+      const std::vector<uint8_t> cut(full.begin(), full.begin() + len);
+      NFB_CHECK(Apply(sync, cut, model) != TaskSyncResult::Applied);
+      NFB_CHECK(LiveTitles(model) == before);
+      NFB_CHECK_EQ(model.Size(), 50u);
+    }
+  }
+}
+
+NFB_TEST(TaskSync, MalformedIsRejected) {
+  TaskListModel model;
+  TaskSyncReceiver sync;
+  Apply(sync, Encode(TaskWireKind::Snapshot, 1, Ids(0, 3)), model);
+  std::vector<uint8_t> bytes = Encode(TaskWireKind::Add, 2, Ids(3, 1));
+  bytes[0] ^= 0xFF;
+  NFB_CHECK_EQ(Apply(sync, bytes, model), TaskSyncResult::Rejected);
+  // 截断的快照同样拒绝，且不替换当前列表
+  const std::vector<uint8_t> snapshot = Encode(TaskWireKind::Snapshot, 5, Ids(10, 5));
+  const std::vector<uint8_t> cut(snapshot.begin(), snapshot.end() - 4);
+  NFB_CHECK_EQ(Apply(sync, cut, model), TaskSyncResult::Rejected);
+  NFB_CHECK_EQ(model.LiveCount(), 3u);
+  NFB_CHECK(model.Contains(u"0"));
+  NFB_CHECK(!model.Contains(u"10"));
+}
@@ -0,0 +1,146 @@
+// 旧文本格式 UPDATE_TASKS 的解析：第一个空格拆分 id 与标题、各种换行、空字段与空行、结尾 NUL、
+// 不成对的代理与非法 UTF-8 经有损转码后的负载、超长输入，以及视图指向负载本身（零拷贝）。
+#include <string>
+#include <vector>
+#include "test_harness.h"
+#include "core/task_text_parser.h"
+#include "core/utf_transcode.h"
+
+namespace {
+
+bool Is(const TaskItemView& item, std::u16string_view id, std::u16string_view title) {
+  return item.id == id && item.title == title;
+}
+
+// 视图落在负载内（没有拷贝）
+bool PointsInto(const TaskItemView& item, std::u16string_view payload) {
+  const char16_t* begin = payload.data();
+  const char16_t* end = begin + payload.size();
+  return item.id.data() >= begin && item.id.data() + item.id.size() <= end &&
+         (item.title.empty() || (item.title.data() >= begin && item.title.data() + item.title.size() <= end));
+}
+
+} // namespace
+
+NFB_TEST(TaskTextParser, SplitsAtFirstSpace) {
+  TaskTextParser parser;
+  const std::u16string payload = u"a1 Buy milk\nb2 Call  the\tbank \nc3 x";
+  const std::vector<TaskItemView>& items = parser.Parse(payload);
+  NFB_REQUIRE(items.size() == 3);
+  NFB_CHECK(Is(items[0], u"a1", u"Buy milk"));
+  NFB_CHECK(Is(items[1], u"b2", u"Call  the\tbank ")); // 标题里的空格、制表符、结尾空格原样保留
+  NFB_CHECK(Is(items[2], u"c3", u"x"));
+  for (const TaskItemView& item : items) {
+    NFB_CHECK(PointsInto(item, payload));
+    NFB_CHECK_EQ(item.priority, 1);
+    NFB_CHECK_EQ(item.flags, (uint8_t)kTaskUnread);
+  }
+  NFB_CHECK_EQ(parser.Items().size(), 3u);
+}
+
+NFB_TEST(TaskTextParser, LineBreaksAndEmbeddedSeparators) {
+  TaskTextParser parser;
+  // \n、\r\n、单独的 \r 都是换行；格式没有转义，反斜杠序列只是普通字符
+  const std::vector<TaskItemView>& items = parser.Parse(u"a one\r\nb two\rc three\nd back\\nslash\\ space");
+  NFB_REQUIRE(items.size() == 4);
+  NFB_CHECK(Is(items[0], u"a", u"one"));
+  NFB_CHECK(Is(items[1], u"b", u"two"));
+  NFB_CHECK(Is(items[2], u"c", u"three"));
+  NFB_CHECK(Is(items[3], u"d", u"back\\nslash\\ space"));
+
+  // 标题里的换行会切出新的一行，所以发送端把它们替换成空格
+  NFB_REQUIRE(parser.Parse(u"e first\nsecond half").size() == 2);
+  NFB_CHECK(Is(parser.Items()[1], u"second", u"half"));
+}
+
+NFB_TEST(TaskTextParser, EmptyFieldsAndLines) {
+  TaskTextParser parser;
+  NFB_CHECK(parser.Parse(u"").empty());
+  NFB_CHECK(parser.Parse(u"\n\r\n\r\n").empty());
+  NFB_CHECK(parser.Parse(std::u16string(3, u'\0')).empty());
+
+  const std::vector<TaskItemView>& items = parser.Parse(u"\n\nnotitle\nblank \n only title\n \n  \nz  two spaces\n");
+  NFB_REQUIRE(items.size() == 3);
+  NFB_CHECK(Is(items[0], u"notitle", u""));
+  NFB_CHECK(Is(items[1], u"blank", u""));        // 结尾空格：标题为空
+  NFB_CHECK(Is(items[2], u"z", u" two spaces")); // 只在第一个空格处拆分
+}
+
+NFB_TEST(TaskTextParser, TrailingNulsAreStripped) {
+  TaskTextParser parser;
+  // 发送端带上 C 字符串结尾的 NUL（cbData 包含终止符）
+  std::u16string payload = u"a first\nb second";
+  payload.push_back(u'\0');
+  NFB_REQUIRE(parser.Parse(payload).size() == 2);
+  NFB_CHECK(Is(parser.Items()[1], u"b", u"second"));
+
+  // 只有行尾的 NUL 被去掉；行中（包括 id 里）的 NUL 属于内容
+  payload = std::u16string(u"c mid") + u'\0' + u"dle" + u'\0' + u'\0' + u"\nd" + u'\0' + u" x\n";
+  payload += std::u16string(2, u'\0');
+  const std::vector<TaskItemView>& items = parser.Parse(payload);
+  NFB_REQUIRE(items.size() == 2);
+  NFB_CHECK(Is(items[0], u"c", std::u16string(u"mid") + u'\0' + u"dle"));
+  NFB_CHECK(Is(items[1], std::u16string(u"d") + u'\0', u"x"));
+
+  // 空格后面只剩 NUL：标题为空，不会越过内容末尾
+  payload = std::u16string(u"e ") + u'\0';
+  NFB_REQUIRE(parser.Parse(payload).size() == 1);
+  NFB_CHECK(Is(parser.Items()[0], u"e", u""));
+}
+
+NFB_TEST(TaskTextParser, InvalidUnicodePassesThrough) {
+  TaskTextParser parser;
+  // 不成对的代理原样保留在 id/标题里；代理对（U+1F600）不会被当作分隔符
+  std::u16string payload;
+  payload += u'\xD800';
+  payload += u" lone high\nid";
+  payload += u'\xDC00';
+  payload += u" lone low";
+  payload += u'\xDBFF';
+  payload += u"\nemoji \U0001F600 ok";
+  const std::vector<TaskItemView>& items = parser.Parse(payload);
+  NFB_REQUIRE(items.size() == 3);
+  NFB_CHECK(Is(items[0], std::u16string(1, u'\xD800'), u"lone high"));
+  NFB_CHECK(Is(items[1], std::u16string(u"id") + u'\xDC00', std::u16string(u"lone low") + u'\xDBFF'));
+  NFB_CHECK(Is(items[2], u"emoji", u"\U0001F600 ok"));
+
+  // 非法 UTF-8 的来源经有损转码成 U+FFFD 之后再拼成负载：行与字段的拆分不受影响
+  const std::string utf8 = "x1 bad\xC3\x28 byte\ny2 \xF0\x9F\x98\nz3 trunc\xE2\x82";
+  std::u16string transcoded;
+  NFB_REQUIRE(Utf8ToUtf16(utf8, &transcoded, UtfMode::Lossy));
+  const std::vector<TaskItemView>& lossy = parser.Parse(transcoded);
+  NFB_REQUIRE(lossy.size() == 3);
+  NFB_CHECK(Is(lossy[0], u"x1", u"bad\uFFFD( byte"));
+  NFB_CHECK(lossy[1].id == u"y2" && !lossy[1].title.empty());
+  NFB_CHECK(lossy[1].title.find(u'\uFFFD') != std::u16string_view::npos);
+  NFB_CHECK(lossy[2].id == u"z3" && lossy[2].title.substr(0, 5) == u"trunc");
+}
+
+NFB_TEST(TaskTextParser, OversizedInput) {
+  TaskTextParser parser;
+  // 10 万行
+  std::u16string payload;
+  for (int i = 0; i < 100000; ++i) {
+    const std::string id = std::to_string(i);
+    payload.append(id.begin(), id.end());
+    payload += u" title\n";
+  }
+  const std::vector<TaskItemView>& many = parser.Parse(payload);
+  NFB_REQUIRE(many.size() == 100000);
+  NFB_CHECK(Is(many[99999], u"99999", u"title"));
+  NFB_CHECK(PointsInto(many[50000], payload));
+
+  // 单行 4M 码元的标题与没有空格的超长 id
+  const std::u16string huge(4u << 20, u'w');
+  const std::u16string line = u"big " + huge + u"\n" + huge;
+  const std::vector<TaskItemView>& big = parser.Parse(line);
+  NFB_REQUIRE(big.size() == 2);
+  NFB_CHECK_EQ(big[0].title.size(), huge.size());
+  NFB_CHECK(big[0].title.data() == line.data() + 4);
+  NFB_CHECK_EQ(big[1].id.size(), huge.size());
+  NFB_CHECK(big[1].title.empty());
+
+  // 条目数组复用：较小的负载不残留上一次的条目
+  NFB_REQUIRE(parser.Parse(u"only one").size() == 1);
+  NFB_CHECK(Is(parser.Items()[0], u"only", u"one"));
+}
@@ -0,0 +1,187 @@
+// UPDATE_TASKS 二进制负载：编解码往返、兼容规则、畸形输入，以及固定种子的变异模糊（见 task_wire_fuzz.h）
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "task_wire_fuzz.h"
+#include "test_harness.h"
+#include "core/task_wire.h"
+
+namespace {
+
+TaskItemView Item(std::u16string_view id, std::u16string_view title, uint8_t priority = 1, int64_t dueMs = 0) {
+  TaskItemView view;
+  view.id = id;
+  view.title = title;
+  view.priority = priority;
+  view.dueMs = dueMs;
+  return view;
+}
+
+std::vector<uint8_t> Encode(TaskWireKind kind, uint32_t sequence, const std::vector<TaskItemView>& items) {
+  TaskWireWriter writer;
+  writer.Begin(kind, sequence);
+  for (const TaskItemView& item : items) writer.Add(item);
+  return writer.Finish();
+}
+
+template <typename T>
+void Put(std::vector<uint8_t>& buf, size_t at, T v) {
+  std::memcpy(buf.data() + at, &v, sizeof(T));
+}
+
+// 负载按 4 字节对齐拷贝后解码（WM_COPYDATA 的 lpData 是对齐的）
+struct Aligned {
+  explicit Aligned(const std::vector<uint8_t>& bytes) : words((bytes.size() + 7) / 8), size(bytes.size()) {
+    if (size) std::memcpy(words.data(), bytes.data(), size);
+  }
+  const void* data() const { return words.data(); }
+  std::vector<uint64_t> words;
+  size_t size;
+};
+
+} // namespace
+
+NFB_TEST(TaskWire, RoundTripAllKinds) {
+  const std::u16string longTitle(5000, u'长');
+  const std::vector<TaskItemView> items = {
+    Item(u"42", u"请于本周五前提交季度预算", 2, 1700000000000LL),
+    Item(u"id-with-空格 and unicode", u"标题\n含换行\t和制表符", 0, -1),
+    Item(u"", u""),
+    Item(u"x", longTitle),
+  };
+  for (TaskWireKind kind : { TaskWireKind::Snapshot, TaskWireKind::Add, TaskWireKind::Update, TaskWireKind::Remove }) {
+    const Aligned payload(Encode(kind, 7, items));
+    std::vector<TaskItemView> out;
+    TaskWireHeader header;
+    NFB_REQUIRE(DecodeTaskWire(payload.data(), payload.size, &out, &header));
+    NFB_CHECK_EQ(header.kind, kind);
+    NFB_CHECK_EQ(header.sequence, 7u);
+    NFB_REQUIRE(out.size() == items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+      NFB_CHECK(out[i].id == items[i].id);
+      NFB_CHECK(out[i].title == items[i].title);
+      NFB_CHECK_EQ(out[i].priority, items[i].priority);
+      NFB_CHECK_EQ(out[i].dueMs, items[i].dueMs);
+    }
+  }
+}
+
+NFB_TEST(TaskWire, AddCarriesPosition) {
+  TaskItemView first = Item(u"a", u"A");
+  first.position = 3;
+  const Aligned payload(Encode(TaskWireKind::Add, 1, { first, Item(u"b", u"B") }));
+  std::vector<TaskItemView> out;
+  NFB_REQUIRE(DecodeTaskWire(payload.data(), payload.size, &out));
+  NFB_REQUIRE(out.size() == 2);
+  NFB_CHECK_EQ(out[0].position, 3u);
+  NFB_CHECK_EQ(out[1].position, 0xFFFFFFFFu);
+}
+
+NFB_TEST(TaskWire, SkipsUnknownHeaderAndRecordTails) {
+  // 新版本追加的字段：头部 +8 字节、记录 +4 字节，旧读端按长度跳过
+  std::vector<uint8_t> bytes = Encode(TaskWireKind::Snapshot, 0, { Item(u"1", u"one"), Item(u"2", u"two") });
+  bytes.insert(bytes.begin() + kTaskWireHeaderSize, 8, 0xEE);
+  Put<uint16_t>(bytes, 6, (uint16_t)(kTaskWireHeaderSize + 8));
+  const size_t first = kTaskWireHeaderSize + 8;
+  uint32_t recordSize;
+  std::memcpy(&recordSize, bytes.data() + first, 4);
+  bytes.insert(bytes.begin() + first + recordSize, 4, 0xEE);
+  Put<uint32_t>(bytes, first, recordSize + 4);
+  const Aligned payload(bytes);
+  std::vector<TaskItemView> out;
+  NFB_REQUIRE(DecodeTaskWire(payload.data(), payload.size, &out));
+  NFB_REQUIRE(out.size() == 2);
+  NFB_CHECK(out[0].title == u"one");
+  NFB_CHECK(out[1].id == u"2");
+}
+
+NFB_TEST(TaskWire, RejectsMalformedHeaders) {
+  const std::vector<uint8_t> good = Encode(TaskWireKind::Snapshot, 0, { Item(u"1", u"one") });
+  const auto error = [](std::vector<uint8_t> bytes) {
+    const Aligned payload(bytes);
+    TaskWireReader reader;
+    TaskItemView item;
+    if (reader.Open(payload.data(), payload.size)) {
+      while (reader.Next(&item)) {}
+    }
+    return reader.Error();
+  };
+  NFB_CHECK_EQ(error(good), TaskWireError::None);
+  NFB_CHECK_EQ(error(std::vector<uint8_t>(good.begin(), good.begin() + 8)), TaskWireError::TooShort);
+  std::vector<uint8_t> bytes = good;
+  bytes[0] ^= 1;
+  NFB_CHECK_EQ(error(bytes), TaskWireError::BadMagic);
+  bytes = good;
+  bytes[4] = kTaskWireVersion + 1;
+  NFB_CHECK_EQ(error(bytes), TaskWireError::UnsupportedVersion);
+  bytes = good;
+  Put<uint16_t>(bytes, 6, 18); // 未对齐的头部长度
+  NFB_CHECK_EQ(error(bytes), TaskWireError::TooShort);
+  bytes = good;
+  Put<uint32_t>(bytes, 8, 1000000); // count 超出负载所能容纳的条数
+  NFB_CHECK_EQ(error(bytes), TaskWireError::Truncated);
+  bytes = good;
+  Put<uint32_t>(bytes, kTaskWireHeaderSize + 16, 0xFFFFFFF0u); // titleLen 溢出记录
+  NFB_CHECK_EQ(error(bytes), TaskWireError::BadRecord);
+  bytes = good;
+  Put<uint32_t>(bytes, kTaskWireHeaderSize, 22); // recordSize 未对齐
+  NFB_CHECK_EQ(error(bytes), TaskWireError::BadRecord);
+
+  // 奇数地址：char16_t 视图无法直接引用
+  std::vector<uint8_t> shifted(good.size() + 2);
+  std::memcpy(shifted.data() + 1, good.data(), good.size());
+  const Aligned odd(shifted);
+  TaskWireReader reader;
+  NFB_CHECK(!reader.Open(static_cast<const uint8_t*>(odd.data()) + 1, good.size()));
+  NFB_CHECK_EQ(reader.Error(), TaskWireError::Misaligned);
+}
+
+NFB_TEST(TaskWire, EveryTruncationFailsCleanly) {
+  const std::vector<uint8_t> good =
+      Encode(TaskWireKind::Add, 3, { Item(u"1", u"first"), Item(u"22", u"第二条"), Item(u"333", u"third") });
+  for (size_t len = 0; len < good.size(); ++len) {
+    // 恰好 len 字节的缓冲：读端越界时 ASan 会报告
+    std::vector<uint8_t> cut(good.begin(), good.begin() + len);
+    std::vector<TaskItemView> out;
+    NFB_CHECK(!DecodeTaskWire(cut.empty() ? nullptr : cut.data(), len, &out));
+    NFB_CHECK(out.size() < 3);
+  }
+}
+
+// 合法负载的固定种子变异：翻转位、覆写为边界值、截断、插入/删除字节、拼接两段负载
+NFB_TEST(TaskWire, MutationFuzz) {
+  std::vector<std::vector<uint8_t>> seeds;
+  seeds.push_back(Encode(TaskWireKind::Snapshot, 5, { Item(u"1", u"one"), Item(u"2", u"二"), Item(u"3", u"") }));
+  seeds.push_back(Encode(TaskWireKind::Add, 6, { Item(u"9", u"nine"), Item(u"1", u"one again") }));
+  seeds.push_back(Encode(TaskWireKind::Update, 6, { Item(u"2", u"two"), Item(u"4", u"four") }));
+  seeds.push_back(Encode(TaskWireKind::Remove, 6, { Item(u"1", u""), Item(u"3", u""), Item(u"7", u"") }));
+  seeds.push_back(Encode(TaskWireKind::Snapshot, 0, {}));
+
+  std::mt19937 rng(20240611);
+  const uint32_t kInteresting[] = { 0u, 1u, 2u, 3u, 4u, 0x7Fu, 0xFFu, 0xFFFFu, 0x7FFFFFFFu, 0xFFFFFFFFu, 16u, 20u, 24u };
+  int broken = 0;
+  for (int iteration = 0; iteration < 40000; ++iteration) {
+    std::vector<uint8_t> bytes = seeds[rng() % seeds.size()];
+    const int mutations = 1 + (int)(rng() % 4);
+    for (int m = 0; m < mutations && !bytes.empty(); ++m) {
+      const size_t at = rng() % bytes.size();
+      switch (rng() % 6) {
+      case 0: bytes[at] ^= (uint8_t)(1u << (rng() % 8)); break;
+      case 1: bytes[at] = (uint8_t)rng(); break;
+      case 2:
+        if (at + 4 <= bytes.size()) Put<uint32_t>(bytes, at & ~(size_t)3, kInteresting[rng() % 13]);
+        break;
+      case 3: bytes.resize(at); break;
+      case 4: bytes.insert(bytes.begin() + at, 1 + rng() % 8, (uint8_t)rng()); break;
+      default: {
+        const std::vector<uint8_t>& other = seeds[rng() % seeds.size()];
+        bytes.insert(bytes.end(), other.begin() + (rng() % other.size()), other.end());
+        break;
+      }
+      }
+    }
+    if (!FuzzTaskWireOnce(bytes.data(), bytes.size())) ++broken;
+  }
+  NFB_CHECK_EQ(broken, 0);
+}
@@ -0,0 +1,397 @@
+// UTF-16 ⇄ UTF-8 转码：与逐码点的参考实现（Unicode 第 3 章 / WHATWG 的最大非法子序列替换）逐一比较。
+// 同一份用例还以 NFB_UTF_NO_SIMD 编译成 native_floating_utf_scalar（见 CMakeLists.txt），
+// 因此向量路径与标量路径都要与参考实现一致。
+#include <random>
+#include <string>
+#include <vector>
+#include "test_harness.h"
+#include "core/utf_transcode.h"
+
+namespace {
+
+constexpr char16_t kReplacement = 0xFFFD;
+
+struct Reference {
+  std::u16string utf16;
+  std::string utf8;
+  bool valid{true};
+  size_t firstBad{0};   // 第一个非法序列的起始位置（输入码元）
+  size_t writtenAtBad{0};
+};
+
+void AppendUtf8(char32_t cp, std::string* out) {
+  if (cp < 0x80) {
+    out->push_back((char)cp);
+  } else if (cp < 0x800) {
+    out->push_back((char)(0xC0 | (cp >> 6)));
+    out->push_back((char)(0x80 | (cp & 0x3F)));
+  } else if (cp < 0x10000) {
+    out->push_back((char)(0xE0 | (cp >> 12)));
+    out->push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+    out->push_back((char)(0x80 | (cp & 0x3F)));
+  } else {
+    out->push_back((char)(0xF0 | (cp >> 18)));
+    out->push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+    out->push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+    out->push_back((char)(0x80 | (cp & 0x3F)));
+  }
+}
+
+void AppendUtf16(char32_t cp, std::u16string* out) {
+  if (cp < 0x10000) {
+    out->push_back((char16_t)cp);
+  } else {
+    out->push_back((char16_t)(0xD800 + ((cp - 0x10000) >> 10)));
+    out->push_back((char16_t)(0xDC00 + ((cp - 0x10000) & 0x3FF)));
+  }
+}
+
+void MarkBad(Reference* ref, size_t at, size_t written) {
+  if (!ref->valid) return;
+  ref->valid = false;
+  ref->firstBad = at;
+  ref->writtenAtBad = written;
+}
+
+Reference ReferenceFromUtf16(std::u16string_view in) {
+  Reference ref;
+  for (size_t i = 0; i < in.size();) {
+    const char16_t c = in[i];
+    if (c >= 0xD800 && c <= 0xDBFF && i + 1 < in.size() && in[i + 1] >= 0xDC00 && in[i + 1] <= 0xDFFF) {
+      AppendUtf8(0x10000 + (((char32_t)c - 0xD800) << 10) + (in[i + 1] - 0xDC00), &ref.utf8);
+      i += 2;
+    } else if (c >= 0xD800 && c <= 0xDFFF) {
+      MarkBad(&ref, i, ref.utf8.size());
+      AppendUtf8(kReplacement, &ref.utf8);
+      ++i;
+    } else {
+      AppendUtf8(c, &ref.utf8);
+      ++i;
+    }
+  }
+  return ref;
+}
+
+// 写入复用的 ref（逐条比较上千万条短序列时不必每次分配）
+void ReferenceFromUtf8(std::string_view text, Reference* out) {
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(text.data());
+  const size_t n = text.size();
+  Reference& ref = *out;
+  ref.utf16.clear();
+  ref.valid = true;
+  for (size_t i = 0; i < n;) {
+    const uint8_t b = in[i];
+    if (b < 0x80) {
+      ref.utf16.push_back(b);
+      ++i;
+      continue;
+    }
+    size_t need;
+    char32_t cp;
+    uint8_t lo = 0x80, hi = 0xBF;
+    if (b >= 0xC2 && b <= 0xDF) {
+      need = 1;
+      cp = b & 0x1F;
+    } else if (b >= 0xE0 && b <= 0xEF) {
+      need = 2;
+      cp = b & 0x0F;
+      if (b == 0xE0) lo = 0xA0;
+      if (b == 0xED) hi = 0x9F;
+    } else if (b >= 0xF0 && b <= 0xF4) {
+      need = 3;
+      cp = b & 0x07;
+      if (b == 0xF0) lo = 0x90;
+      if (b == 0xF4) hi = 0x8F;
+    } else {
+      MarkBad(&ref, i, ref.utf16.size());
+      ref.utf16.push_back(kReplacement);
+      ++i;
+      continue;
+    }
+    size_t j = i + 1, got = 0;
+    while (got < need && j < n && in[j] >= lo && in[j] <= hi) {
+      cp = (cp << 6) | (in[j] & 0x3F);
+      lo = 0x80;
+      hi = 0xBF;
+      ++j;
+      ++got;
+    }
+    if (got < need) {
+      MarkBad(&ref, i, ref.utf16.size());
+      ref.utf16.push_back(kReplacement);
+    } else {
+      AppendUtf16(cp, &ref.utf16);
+    }
+    i = j;
+  }
+}
+
+Reference ReferenceFromUtf8(std::string_view text) {
+  Reference ref;
+  ReferenceFromUtf8(text, &ref);
+  return ref;
+}
+
+// 两种模式、两种接口（缓冲区 / 便利函数）与长度预测都和参考一致
+bool Check16To8(std::u16string_view in) {
+  const Reference ref = ReferenceFromUtf16(in);
+  bool ok = true;
+  bool valid = false;
+  const size_t len = Utf8LengthOf(in, &valid);
+  ok &= len == ref.utf8.size() && valid == ref.valid;
+
+  std::vector<char> buf(len + 1, '\x5A');
+  UtfResult r = Utf16ToUtf8(in, buf.data(), UtfMode::Lossy);
+  ok &= r.ok && r.read == in.size() && r.written == len;
+  ok &= std::string_view(buf.data(), len) == ref.utf8 && buf[len] == '\x5A';
+
+  std::fill(buf.begin(), buf.end(), '\0');
+  r = Utf16ToUtf8(in, buf.data(), UtfMode::Strict);
+  ok &= r.ok == ref.valid;
+  if (!ref.valid) {
+    ok &= r.read == ref.firstBad && r.written == ref.writtenAtBad;
+    ok &= std::string_view(buf.data(), r.written) == std::string_view(ref.utf8).substr(0, r.written);
+  }
+
+  std::string s;
+  ok &= Utf16ToUtf8(in, &s, UtfMode::Lossy) && s == ref.utf8;
+  ok &= Utf16ToUtf8(in, &s, UtfMode::Strict) == ref.valid;
+  ok &= ref.valid ? s == ref.utf8 : s.empty();
+  return ok;
+}
+
+bool Check8To16(std::string_view in) {
+  const Reference ref = ReferenceFromUtf8(in);
+  bool ok = true;
+  bool valid = false;
+  const size_t len = Utf16LengthOf(in, &valid);
+  ok &= len == ref.utf16.size() && valid == ref.valid;
+
+  std::vector<char16_t> buf(len + 1, u'\x5A');
+  UtfResult r = Utf8ToUtf16(in, buf.data(), UtfMode::Lossy);
+  ok &= r.ok && r.read == in.size() && r.written == len;
+  ok &= std::u16string_view(buf.data(), len) == ref.utf16 && buf[len] == u'\x5A';
+
+  std::fill(buf.begin(), buf.end(), u'\0');
+  r = Utf8ToUtf16(in, buf.data(), UtfMode::Strict);
+  ok &= r.ok == ref.valid;
+  if (!ref.valid) {
+    ok &= r.read == ref.firstBad && r.written == ref.writtenAtBad;
+    ok &= std::u16string_view(buf.data(), r.written) == std::u16string_view(ref.utf16).substr(0, r.written);
+  }
+
+  std::u16string s;
+  ok &= Utf8ToUtf16(in, &s, UtfMode::Lossy) && s == ref.utf16;
+  ok &= Utf8ToUtf16(in, &s, UtfMode::Strict) == ref.valid;
+  ok &= ref.valid ? s == ref.utf16 : s.empty();
+  return ok;
+}
+
+// 把 body 放在 16 码元块内的每个偏移上（前后填充 ASCII / 中文），覆盖块边界与向量/标量切换
+template <typename Str, typename Check>
+int CheckAtEveryOffset(const Str& body, const Str& asciiFill, const Str& wideFill, Check check) {
+  int failures = 0;
+  for (size_t offset = 0; offset <= 33; ++offset) {
+    for (const Str* fill : { &asciiFill, &wideFill }) {
+      Str text;
+      while (text.size() < offset) text += *fill;
+      text.resize(offset);
+      text += body;
+      text += *fill;
+      text += *fill;
+      if (!check(text)) ++failures;
+    }
+  }
+  return failures;
+}
+
+const std::u16string kAscii16 = u"abcdefghijklmnopqrstuvwxyz0123456789";
+const std::u16string kWide16 = u"中文任务列表同步";
+const std::string kAscii8 = "abcdefghijklmnopqrstuvwxyz0123456789";
+const std::string kWide8 = "\xE4\xB8\xAD\xE6\x96\x87"; // "中文"
+
+} // namespace
+
+NFB_TEST(UtfTranscode, EveryUtf16CodeUnit) {
+  int failures = 0;
+  for (uint32_t c = 0; c <= 0xFFFF; ++c) {
+    const char16_t unit = (char16_t)c;
+    if (!Check16To8(std::u16string_view(&unit, 1))) ++failures;
+    // 块中间与块末尾（下一个码元不在同一块）
+    std::u16string text = kAscii16.substr(0, 7) + unit + kAscii16.substr(0, 8);
+    if (!Check16To8(text)) ++failures;
+    text = kWide16 + kWide16.substr(0, 7) + unit + u"x";
+    if (!Check16To8(text)) ++failures;
+  }
+  NFB_CHECK_EQ(failures, 0);
+}
+
+NFB_TEST(UtfTranscode, EverySurrogatePair) {
+  // 每个高代理项一条串：1024 个合法对，末尾再接一个孤立高代理项
+  int failures = 0;
+  for (char16_t high = 0xD800; high <= 0xDBFF; ++high) {
+    std::u16string text;
+    for (char16_t low = 0xDC00; low <= 0xDFFF; ++low) {
+      text.push_back(high);
+      text.push_back(low);
+    }
+    if (!Check16To8(text)) ++failures;
+    text.push_back(high);
+    if (!Check16To8(text)) ++failures;
+  }
+  NFB_CHECK_EQ(failures, 0);
+}
+
+NFB_TEST(UtfTranscode, SurrogatesAcrossBlockEdges) {
+  const std::u16string bodies[] = {
+    u"\xD83D\xDE00",         // 合法对
+    u"\xD83D",               // 孤立高代理项
+    u"\xDE00",               // 孤立低代理项
+    u"\xDE00\xD83D",         // 顺序颠倒
+    u"\xD83D\xD83D\xDE00",   // 高 + 合法对
+    u"\xD83D\xDE00\xDE00",   // 合法对 + 低
+    u"\xDBFF\xDFFF\xD800\xDC00",
+  };
+  int failures = 0;
+  for (const std::u16string& body : bodies) {
+    failures += CheckAtEveryOffset(body, kAscii16, kWide16, [](const std::u16string& s) { return Check16To8(s); });
+    // 也放在输入的最末尾（之后没有任何码元）
+    for (size_t offset = 0; offset <= 33; ++offset) {
+      if (!Check16To8(std::u16string(offset, u'a') + body)) ++failures;
+    }
+  }
+  NFB_CHECK_EQ(failures, 0);
+}
+
+NFB_TEST(UtfTranscode, EveryScalarValueRoundTrips) {
+  std::u16string all;
+  for (char32_t cp = 0; cp <= 0x10FFFF; ++cp) {
+    if (cp >= 0xD800 && cp <= 0xDFFF) continue;
+    AppendUtf16(cp, &all);
+  }
+  std::string utf8;
+  NFB_REQUIRE(Utf16ToUtf8(all, &utf8, UtfMode::Strict));
+  NFB_CHECK(utf8 == ReferenceFromUtf16(all).utf8);
+  std::u16string back;
+  NFB_REQUIRE(Utf8ToUtf16(utf8, &back, UtfMode::Strict));
+  NFB_CHECK(back == all);
+  NFB_CHECK_EQ(Utf8LengthOf(all), utf8.size());
+  NFB_CHECK_EQ(Utf16LengthOf(utf8), all.size());
+}
+
+NFB_TEST(UtfTranscode, EveryOneAndTwoByteSequence) {
+  int failures = 0;
+  for (uint32_t a = 0; a < 256; ++a) {
+    const char one[] = { (char)a };
+    if (!Check8To16(std::string_view(one, 1))) ++failures;
+    for (uint32_t b = 0; b < 256; ++b) {
+      const char two[] = { (char)a, (char)b };
+      if (!Check8To16(std::string_view(two, 2))) ++failures;
+    }
+  }
+  NFB_CHECK_EQ(failures, 0);
+}
+
+NFB_TEST(UtfTranscode, EveryThreeByteSequence) {
+  // 1600 万条：只比较转换结果与长度（完整的 Check8To16 放在下面的抽样里）
+  int failures = 0;
+  char16_t buf[4];
+  Reference ref;
+  for (uint32_t a = 0; a < 256; ++a) {
+    for (uint32_t b = 0; b < 256; ++b) {
+      for (uint32_t c = 0; c < 256; ++c) {
+        const char in[] = { (char)a, (char)b, (char)c };
+        const std::string_view text(in, 3);
+        const UtfResult r = Utf8ToUtf16(text, buf, UtfMode::Lossy);
+        ReferenceFromUtf8(text, &ref);
+        if (r.written != ref.utf16.size() || std::u16string_view(buf, r.written) != ref.utf16 ||
+            Utf16LengthOf(text) != r.written) {
+          ++failures;
+        }
+      }
+    }
+  }
+  NFB_CHECK_EQ(failures, 0);
+  std::mt19937 rng(40);
+  for (int i = 0; i < 200000; ++i) {
+    const char in[] = { (char)rng(), (char)rng(), (char)rng() };
+    if (!Check8To16(std::string_view(in, 3))) ++failures;
+  }
+  NFB_CHECK_EQ(failures, 0);
+}
+
+NFB_TEST(UtfTranscode, FourByteSequences) {
+  // 每个首字节 × 每个第二字节，后两字节取边界值
+  const uint8_t tails[] = { 0x7F, 0x80, 0x8F, 0x90, 0xBF, 0xC0 };
+  int failures = 0;
+  for (uint32_t a = 0xC0; a < 256; ++a) {
+    for (uint32_t b = 0; b < 256; ++b) {
+      for (uint8_t c : tails) {
+        for (uint8_t d : tails) {
+          const char in[] = { (char)a, (char)b, (char)c, (char)d };
+          if (!Check8To16(std::string_view(in, 4))) ++failures;
+        }
+      }
+    }
+  }
+  NFB_CHECK_EQ(failures, 0);
+}
+
+NFB_TEST(UtfTranscode, Utf8SequencesAcrossBlockEdges) {
+  const std::string bodies[] = {
+    "\xF0\x9F\x98\x80",   // U+1F600
+    "\xE4\xB8\xAD",       // 中
+    "\xC3\xA9",           // é
+    "\xF0\x9F\x98",       // 截断的 4 字节序列
+    "\xE4\xB8",           // 截断的 3 字节序列
+    "\x80\xBF",           // 孤立续字节
+    "\xC0\xAF",           // 过长编码
+    "\xED\xA0\x80",       // 编码后的代理项
+    "\xF4\x90\x80\x80",   // 超出 U+10FFFF
+    "\xFF",
+  };
+  int failures = 0;
+  for (const std::string& body : bodies) {
+    failures += CheckAtEveryOffset(body, kAscii8, kWide8, [](const std::string& s) { return Check8To16(s); });
+    for (size_t offset = 0; offset <= 33; ++offset) {
+      if (!Check8To16(std::string(offset, 'a') + body)) ++failures;
+    }
+  }
+  NFB_CHECK_EQ(failures, 0);
+}
+
+NFB_TEST(UtfTranscode, RandomMixedText) {
+  // 按权重混合 ASCII 段、中文、补充平面与非法码元，长度跨越多个块
+  std::mt19937 rng(20240611);
+  int failures = 0;
+  for (int iteration = 0; iteration < 3000; ++iteration) {
+    std::u16string text;
+    const size_t length = rng() % 200;
+    while (text.size() < length) {
+      switch (rng() % 8) {
+      case 0: case 1: case 2: text.append(rng() % 40, (char16_t)(u'a' + rng() % 26)); break;
+      case 3: case 4: text.push_back((char16_t)(0x4E00 + rng() % 0x5000)); break;
+      case 5: AppendUtf16(0x10000 + rng() % 0x100000, &text); break;
+      case 6: text.push_back((char16_t)(0x80 + rng() % 0x780)); break;
+      default: if (rng() % 4 == 0) text.push_back((char16_t)(0xD800 + rng() % 0x800)); break;
+      }
+    }
+    if (!Check16To8(text)) ++failures;
+    const Reference ref = ReferenceFromUtf16(text);
+    if (!Check8To16(ref.utf8)) ++failures;
+    // 在 UTF-8 里随机破坏一个字节
+    std::string damaged = ref.utf8;
+    if (!damaged.empty()) damaged[rng() % damaged.size()] = (char)rng();
+    if (!Check8To16(damaged)) ++failures;
+  }
+  NFB_CHECK_EQ(failures, 0);
+}
+
+NFB_TEST(UtfTranscode, EmptyInput) {
+  NFB_CHECK_EQ(Utf8LengthOf(u""), 0u);
+  NFB_CHECK_EQ(Utf16LengthOf(""), 0u);
+  std::string s = "x";
+  NFB_CHECK(Utf16ToUtf8(u"", &s, UtfMode::Strict) && s.empty());
+  std::u16string w = u"x";
+  NFB_CHECK(Utf8ToUtf16("", &w, UtfMode::Strict) && w.empty());
+}
@@ -0,0 +1,378 @@
+#include "floating_ball_channel.h"
+
+#include <flutter/event_stream_handler_functions.h>
+#include <flutter/standard_method_codec.h>
+#include <windows.h>
+
+#include "utils.h"
+
+#include "core/dispatch_profiler.h"
+#include "core/memory_accounting.h"
+#include "core/peer_hello.h"
+#include "core/process_supervisor.h"
+#include "core/single_instance.h"
+#include "core/startup_trace.h"
+#include "core/task_wire.h"
+#include "core/utf_transcode.h"
+
+namespace {
+
+constexpr wchar_t kFloatingBallClass[] = L"NativeFloatingBallWindow";
+// Upper bound the platform thread waits for the ball to apply a snapshot.
+constexpr UINT kNotifyTimeoutMs = 250;
+// Posted to the main window once per batch of ball events.
+constexpr UINT kFlushEventsMessage = WM_APP + 0x40;
+// Posted from the ball supervisor thread: wparam = ProcessSupervisor::Event,
+// lparam = ball pid.
+constexpr UINT kBallLaunchMessage = WM_APP + 0x41;
+// Runner events (relaunches, ball restarts) kept while Dart is not listening;
+// the oldest are dropped.
+constexpr size_t kMaxPendingRunnerEvents = 16;
+
+}  // namespace
+
+FloatingBallChannel::FloatingBallChannel(flutter::BinaryMessenger* messenger,
+                                         HWND window)
+    : channel_(std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+          messenger, "chat_desktop/floating_ball",
+          &flutter::StandardMethodCodec::GetInstance())),
+      snapshot_message_(RegisterWindowMessageW(kTaskSnapshotMessageName)),
+      window_(window),
+      hello_message_(RegisterWindowMessageW(kPeerHelloMessageName)) {
+  channel_->SetMethodCallHandler(
+      [this](const auto& call, auto result) {
+        HandleMethodCall(call, std::move(result));
+      });
+
+  event_channel_ =
+      std::make_unique<flutter::EventChannel<flutter::EncodableValue>>(
+          messenger, "chat_desktop/floating_ball/events",
+          &flutter::StandardMethodCodec::GetInstance());
+  event_channel_->SetStreamHandler(
+      std::make_unique<flutter::StreamHandlerFunctions<>>(
+          [this](const flutter::EncodableValue* arguments,
+                 std::unique_ptr<flutter::EventSink<>>&& events)
+              -> std::unique_ptr<flutter::StreamHandlerError<>> {
+            event_sink_ = std::move(events);
+            // Deliver anything the ball sent before Dart started listening.
+            FlushEvents();
+            return nullptr;
+          },
+          [this](const flutter::EncodableValue* arguments)
+              -> std::unique_ptr<flutter::StreamHandlerError<>> {
+            event_sink_ = nullptr;
+            return nullptr;
+          }));
+
+  // Announce once; a ball that is already running replies with its HWND.
+  if (hello_message_ && window_) {
+    PostMessageW(HWND_BROADCAST, hello_message_,
+                 reinterpret_cast<WPARAM>(window_), kPeerRoleMain);
+  }
+}
+
+FloatingBallChannel::~FloatingBallChannel() {
+  // Leaves the ball running; only stops watching it.
+  ball_supervisor_ = nullptr;
+  channel_->SetMethodCallHandler(nullptr);
+  event_channel_->SetStreamHandler(nullptr);
+}
+
+void FloatingBallChannel::HandleMethodCall(
+    const flutter::MethodCall<flutter::EncodableValue>& call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  if (call.method_name() == "publishTaskSnapshot") {
+    const auto* payload = std::get_if<std::vector<uint8_t>>(call.arguments());
+    if (!payload) {
+      result->Error("bad_args", "expected Uint8List");
+      return;
+    }
+    result->Success(flutter::EncodableValue(PublishTaskSnapshot(*payload)));
+    return;
+  }
+  if (call.method_name() == "launchBall") {
+    const auto* path = std::get_if<std::string>(call.arguments());
+    if (!path || path->empty()) {
+      result->Error("bad_args", "expected the ball executable path");
+      return;
+    }
+    LaunchBall(*path, std::move(result));
+    return;
+  }
+  if (call.method_name() == "dumpDispatchProfile") {
+    // The ball writes its own table to its log file.
+    HWND ball = ResolveBall();
+    UINT dump_message = RegisterWindowMessageW(kDispatchDumpMessageName);
+    if (ball && dump_message) {
+      PostMessageW(ball, dump_message, 0, 0);
+    }
+    result->Success(
+        flutter::EncodableValue(ProcessDispatchProfiler().Format()));
+    return;
+  }
+  if (call.method_name() == "dumpMemoryReport") {
+    result->Success(QueryBallMemoryReport());
+    return;
+  }
+  if (call.method_name() == "dumpStartupTrace") {
+    result->Success(
+        flutter::EncodableValue(ProcessStartupTracer().ToChromeJson()));
+    return;
+  }
+  result->NotImplemented();
+}
+
+std::optional<LRESULT> FloatingBallChannel::HandleWindowMessage(
+    UINT message, WPARAM wparam, LPARAM lparam) {
+  if (message == WM_COPYDATA) {
+    return HandleCopyData(reinterpret_cast<const COPYDATASTRUCT*>(lparam));
+  }
+  if (message == kFlushEventsMessage) {
+    FlushEvents();
+    return 0;
+  }
+  if (message == kBallLaunchMessage) {
+    OnBallLaunchEvent(wparam, static_cast<DWORD>(lparam));
+    return 0;
+  }
+  if (!hello_message_ || message != hello_message_) {
+    return std::nullopt;
+  }
+  HWND from = reinterpret_cast<HWND>(wparam);
+  const uint32_t flags = static_cast<uint32_t>(lparam);
+  if (from && from != window_ && (flags & kPeerRoleMask) == kPeerRoleBall) {
+    CacheBall(from);
+    if (!(flags & kPeerHelloReply)) {
+      PostMessageW(from, hello_message_, reinterpret_cast<WPARAM>(window_),
+                   kPeerRoleMain | kPeerHelloReply);
+    }
+  }
+  return 0;
+}
+
+std::optional<LRESULT> FloatingBallChannel::HandleCopyData(
+    const COPYDATASTRUCT* cds) {
+  if (cds && cds->dwData == kBallIpcMemoryReport) {
+    // Only the reply to a query in flight is accepted.
+    if (!memory_report_ || !cds->lpData) {
+      return 0;
+    }
+    memory_report_->assign(static_cast<const char*>(cds->lpData), cds->cbData);
+    return 1;
+  }
+  if (cds && cds->dwData == kInstanceActivateCopyData) {
+    std::vector<std::string> args;
+    if (!DecodeInstanceActivation(cds->lpData, cds->cbData, &args)) {
+      return 0;
+    }
+    RestoreWindow();
+    flutter::EncodableList list;
+    for (std::string& arg : args) {
+      list.emplace_back(std::move(arg));
+    }
+    flutter::EncodableMap map;
+    map[flutter::EncodableValue("type")] = flutter::EncodableValue("activate");
+    map[flutter::EncodableValue("args")] =
+        flutter::EncodableValue(std::move(list));
+    PushRunnerEvent(std::move(map));
+    return 1;  // Tells the relaunched process it can exit.
+  }
+  BallIpcEvent event;
+  if (!cds ||
+      !DecodeBallIpc(cds->dwData, cds->lpData, cds->cbData, &event)) {
+    return std::nullopt;
+  }
+  // Restore before replying so the ball's foreground request that follows
+  // targets a visible window; Dart only handles what happens next.
+  RestoreWindow();
+  if (pending_events_.Push(std::move(event))) {
+    PostMessageW(window_, kFlushEventsMessage, 0, 0);
+  }
+  return 0;
+}
+
+void FloatingBallChannel::RestoreWindow() {
+  ShowWindow(window_, SW_SHOW);
+  ShowWindow(window_, SW_RESTORE);
+  SetForegroundWindow(window_);
+}
+
+void FloatingBallChannel::FlushEvents() {
+  if (!event_sink_ ||
+      (pending_events_.Empty() && pending_runner_events_.empty())) {
+    return;
+  }
+  flutter::EncodableList batch;
+  for (const BallIpcEvent& event : pending_events_.Take()) {
+    flutter::EncodableMap map;
+    if (event.kind == BallIpcKind::OpenTask) {
+      map[flutter::EncodableValue("type")] =
+          flutter::EncodableValue("open_task");
+      std::string task_id;
+      Utf16ToUtf8(event.taskId, &task_id);
+      map[flutter::EncodableValue("taskId")] =
+          flutter::EncodableValue(std::move(task_id));
+    } else {
+      map[flutter::EncodableValue("type")] =
+          flutter::EncodableValue("restore");
+    }
+    batch.emplace_back(std::move(map));
+  }
+  for (flutter::EncodableValue& event : pending_runner_events_) {
+    batch.push_back(std::move(event));
+  }
+  pending_runner_events_.clear();
+  event_sink_->Success(flutter::EncodableValue(std::move(batch)));
+}
+
+void FloatingBallChannel::PushRunnerEvent(flutter::EncodableMap event) {
+  if (pending_runner_events_.size() >= kMaxPendingRunnerEvents) {
+    pending_runner_events_.erase(pending_runner_events_.begin());
+  }
+  pending_runner_events_.emplace_back(std::move(event));
+  PostMessageW(window_, kFlushEventsMessage, 0, 0);
+}
+
+void FloatingBallChannel::LaunchBall(
+    const std::string& path,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  // Already up (started earlier, by hand or by a previous instance).
+  if (ResolveBall()) {
+    result->Success(flutter::EncodableValue(true));
+    return;
+  }
+  if (ball_supervisor_ && ball_supervisor_->IsRunning()) {
+    if (!ball_up_) {
+      // Answered together with the launch in flight.
+      pending_launches_.push_back(std::move(result));
+      return;
+    }
+    // Reported up, yet its window is gone: it closed the window without
+    // exiting, hung, or crashed with the event still queued. Nothing can talk
+    // to that process, so replace it instead of reporting success.
+    ball_supervisor_->Stop(true);
+  }
+  ProcessSupervisor::Options options;
+  options.path = path;
+  HWND window = window_;
+  // Events still queued from a replaced supervisor are ignored by generation.
+  const WPARAM generation = ++ball_launch_generation_;
+  ball_supervisor_ = std::make_unique<ProcessSupervisor>(
+      std::move(options),
+      [window, generation](ProcessSupervisor::Event event, uint32_t pid, int) {
+        PostMessageW(window, kBallLaunchMessage,
+                     (generation << 8) | static_cast<WPARAM>(event),
+                     static_cast<LPARAM>(pid));
+      });
+  pending_launches_.push_back(std::move(result));
+  ball_up_ = false;
+  ball_supervisor_->Start();
+}
+
+void FloatingBallChannel::OnBallLaunchEvent(WPARAM event, DWORD pid) {
+  using Event = ProcessSupervisor::Event;
+  if ((event >> 8) != ball_launch_generation_) {
+    return;  // From a supervisor LaunchBall has since replaced.
+  }
+  const Event kind = static_cast<Event>(event & 0xFF);
+  // Ready, or alive but without a signal (older ball builds): either way the
+  // caller can start syncing. Anything else means there is no ball.
+  const bool up = kind == Event::Ready || kind == Event::ReadyTimeout;
+  ball_up_ = up;
+  if (kind == Event::Crashed) {
+    return;  // The supervisor restarts it after a backoff.
+  }
+  if (!pending_launches_.empty()) {
+    for (auto& result : pending_launches_) {
+      result->Success(flutter::EncodableValue(up));
+    }
+    pending_launches_.clear();
+  } else if (kind == Event::Ready) {
+    // A restart after a crash: the new ball starts empty and needs a fresh
+    // snapshot.
+    flutter::EncodableMap map;
+    map[flutter::EncodableValue("type")] =
+        flutter::EncodableValue("ball_ready");
+    map[flutter::EncodableValue("pid")] =
+        flutter::EncodableValue(static_cast<int64_t>(pid));
+    PushRunnerEvent(std::move(map));
+  }
+}
+
+HWND FloatingBallChannel::ResolveBall() {
+  if (ball_ && IsWindow(ball_)) {
+    DWORD pid = 0;
+    GetWindowThreadProcessId(ball_, &pid);
+    if (pid == ball_pid_) {
+      return ball_;
+    }
+  }
+  ball_ = nullptr;
+  ball_pid_ = 0;
+  HWND found = FindWindowW(kFloatingBallClass, nullptr);
+  if (found) {
+    CacheBall(found);
+  }
+  return ball_;
+}
+
+void FloatingBallChannel::CacheBall(HWND ball) {
+  DWORD pid = 0;
+  GetWindowThreadProcessId(ball, &pid);
+  ball_ = pid ? ball : nullptr;
+  ball_pid_ = pid;
+}
+
+bool FloatingBallChannel::EnsureSnapshotRegion() {
+  if (snapshot_region_.IsOpen()) {
+    return true;
+  }
+  const size_t region_size =
+      SeqlockSnapshot::RegionSize(kTaskSnapshotCapacity);
+  if (!snapshot_region_.Create(kTaskSnapshotRegionName, region_size) ||
+      !snapshot_writer_.Attach(snapshot_region_.Data(), region_size,
+                               kTaskSnapshotCapacity, true)) {
+    snapshot_region_.Close();
+    return false;
+  }
+  return true;
+}
+
+flutter::EncodableValue FloatingBallChannel::QueryBallMemoryReport() {
+  HWND ball = ResolveBall();
+  const UINT report_message = RegisterWindowMessageW(kMemoryReportMessageName);
+  if (!ball || !report_message) {
+    return flutter::EncodableValue();
+  }
+  // The ball answers with WM_COPYDATA before this send returns; the platform
+  // thread dispatches that incoming sent message while it waits.
+  std::string report;
+  memory_report_ = &report;
+  DWORD_PTR reply = 0;
+  const bool answered =
+      SendMessageTimeoutW(ball, report_message,
+                          reinterpret_cast<WPARAM>(window_), 0,
+                          SMTO_ABORTIFHUNG | SMTO_ERRORONEXIT,
+                          kNotifyTimeoutMs, &reply) != 0;
+  memory_report_ = nullptr;
+  if (!answered || report.empty()) {
+    return flutter::EncodableValue();
+  }
+  return flutter::EncodableValue(std::move(report));
+}
+
+int FloatingBallChannel::PublishTaskSnapshot(
+    const std::vector<uint8_t>& payload) {
+  HWND ball = ResolveBall();
+  if (!ball || !snapshot_message_ || !EnsureSnapshotRegion() ||
+      !snapshot_writer_.Publish(payload.data(), payload.size())) {
+    return -1;
+  }
+  DWORD_PTR reply = 0;
+  if (!SendMessageTimeoutW(ball, snapshot_message_, 0, 0,
+                           SMTO_ABORTIFHUNG | SMTO_ERRORONEXIT,
+                           kNotifyTimeoutMs, &reply)) {
+    return -1;
+  }
+  return static_cast<int>(reply);
+}
@@ -0,0 +1,121 @@
+#ifndef RUNNER_FLOATING_BALL_CHANNEL_H_
+#define RUNNER_FLOATING_BALL_CHANNEL_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/event_channel.h>
+#include <flutter/event_sink.h>
+#include <flutter/method_channel.h>
+
+#include <windows.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/ball_ipc.h"
+#include "core/process_supervisor.h"
+#include "core/seqlock_snapshot.h"
+#include "core/shared_region.h"
+
+// Method channel "chat_desktop/floating_ball" used by WindowsFloatingIpc.
+//
+// publishTaskSnapshot(Uint8List): writes an already-encoded SNAPSHOT payload
+// (see native_floating_ball/src/core/task_wire.h) into the shared-memory
+// region and notifies the native floating ball with a payload-less registered
+// message. Replies with the ball's TaskSyncResult (0/1/2), or -1 when the
+// snapshot could not be published or the ball did not answer in time, in
+// which case the caller falls back to WM_COPYDATA.
+//
+// dumpDispatchProfile(): returns this process's window-message dispatch
+// profile (core/dispatch_profiler.h) as text and asks the ball to log its own.
+// dumpMemoryReport(): asks the ball for its per-subsystem memory accounting
+// (core/memory_accounting.h) and returns it as a JSON string; the ball also
+// writes the table to its log. Null when no ball answered in time.
+// dumpStartupTrace(): returns this process's startup timeline as Chrome
+// trace-event JSON (core/startup_trace.h).
+//
+// Event channel "chat_desktop/floating_ball/events": messages the ball sends
+// to the main window (OPEN_TASK, RESTORE_MAIN_WINDOW; see core/ball_ipc.h)
+// are decoded here. The window is restored natively right away and the events
+// are forwarded to Dart as one list per platform-channel hop; a burst that
+// arrives before the posted flush runs is coalesced into the same list. Each
+// event is a map {"type": "open_task" | "restore", "taskId": String?}.
+//
+// A second launch of the app forwards its command line here instead of
+// starting another engine (core/single_instance.h). The window is restored
+// and the request is delivered on the same event channel, after any ball
+// events of that batch, as {"type": "activate", "args": List<String>}.
+//
+// launchBall(String path): starts native_floating_ball.exe directly (no shell)
+// under a ProcessSupervisor (core/process_supervisor.h) and replies true once
+// the ball signals that its window and GIFs are live, so the first snapshot
+// can go out right away; false when it could not be started. Replies true
+// immediately when a ball is already running. A ball that crashes is
+// restarted with backoff; each restart is reported on the event channel as
+// {"type": "ball_ready", "pid": int} so Dart can resend the snapshot.
+//
+// Also owns this side of the PeerHello handshake (core/peer_hello.h): the main
+// window announces itself once on creation and caches the ball's HWND from
+// its hello, so publishing never has to search for the ball window.
+class FloatingBallChannel {
+ public:
+  FloatingBallChannel(flutter::BinaryMessenger* messenger, HWND window);
+  ~FloatingBallChannel();
+
+  FloatingBallChannel(const FloatingBallChannel&) = delete;
+  FloatingBallChannel& operator=(const FloatingBallChannel&) = delete;
+
+  // Handles PeerHello and ball WM_COPYDATA messages plus the internal flush
+  // message; returns nullopt for anything else.
+  std::optional<LRESULT> HandleWindowMessage(UINT message, WPARAM wparam,
+                                             LPARAM lparam);
+
+ private:
+  void HandleMethodCall(
+      const flutter::MethodCall<flutter::EncodableValue>& call,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  int PublishTaskSnapshot(const std::vector<uint8_t>& payload);
+  flutter::EncodableValue QueryBallMemoryReport();
+  bool EnsureSnapshotRegion();
+  // Returns the cached ball window if it is still alive and owned by the same
+  // process, otherwise looks it up by class name once and caches it.
+  HWND ResolveBall();
+  std::optional<LRESULT> HandleCopyData(const COPYDATASTRUCT* cds);
+  void RestoreWindow();
+  void FlushEvents();
+  void CacheBall(HWND ball);
+  // Queues a runner-originated event for the next flush.
+  void PushRunnerEvent(flutter::EncodableMap event);
+  void LaunchBall(
+      const std::string& path,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  // event packs the ProcessSupervisor::Event (low byte) and the generation of
+  // the supervisor that posted it.
+  void OnBallLaunchEvent(WPARAM event, DWORD pid);
+
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
+  std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>>
+      event_channel_;
+  std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> event_sink_;
+  BallIpcBatch pending_events_;
+  std::vector<flutter::EncodableValue> pending_runner_events_;
+  std::unique_ptr<ProcessSupervisor> ball_supervisor_;
+  bool ball_up_ = false;
+  WPARAM ball_launch_generation_ = 0;
+  std::vector<std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>>
+      pending_launches_;
+  SharedRegion snapshot_region_;
+  SeqlockSnapshotWriter snapshot_writer_;
+  UINT snapshot_message_ = 0;
+  HWND window_ = nullptr;
+  UINT hello_message_ = 0;
+  HWND ball_ = nullptr;
+  DWORD ball_pid_ = 0;
+  // Set only while QueryBallMemoryReport waits for the ball's reply.
+  std::string* memory_report_ = nullptr;
+};
+
+#endif  // RUNNER_FLOATING_BALL_CHANNEL_H_
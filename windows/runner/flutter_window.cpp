@@ -2,7 +2,9 @@
 
 #include <optional>
 
+#include "core/startup_trace.h"
 #include "flutter/generated_plugin_registrant.h"
+#include "utils.h"
 
 FlutterWindow::FlutterWindow(const flutter::DartProject& project)
     : project_(project) {}
@@ -15,17 +17,28 @@ bool FlutterWindow::OnCreate() {
   }
 
   RECT frame = GetClientArea();
+  StartupTracer& trace = ProcessStartupTracer();
 
   // The size here must match the window dimensions to avoid unnecessary surface
   // creation / destruction in the startup path.
-  flutter_controller_ = std::make_unique<flutter::FlutterViewController>(
-      frame.right - frame.left, frame.bottom - frame.top, project_);
+  {
+    StartupTracer::Span span(trace, "FlutterViewController");
+    flutter_controller_ = std::make_unique<flutter::FlutterViewController>(
+        frame.right - frame.left, frame.bottom - frame.top, project_);
+  }
   // Ensure that basic setup of the controller was successful.
   if (!flutter_controller_->engine() || !flutter_controller_->view()) {
     return false;
   }
-  RegisterPlugins(flutter_controller_->engine());
+  {
+    StartupTracer::Span span(trace, "RegisterPlugins");
+    RegisterPlugins(flutter_controller_->engine());
+  }
   SetChildContent(flutter_controller_->view()->GetNativeWindow());
+  if (!IsSubWindow()) {
+    floating_ball_channel_ = std::make_unique<FloatingBallChannel>(
+        flutter_controller_->engine()->messenger(), GetHandle());
+  }
 
   // If this is a sub-window (floating window), reconfigure window style
   if (IsSubWindow()) {
@@ -49,8 +62,16 @@ bool FlutterWindow::OnCreate() {
     OutputDebugStringA("[FlutterWindow] Floating window style reconfigured - WS_POPUP applied\n");
   }
 
+  trace.AddInstant("SetNextFrameCallback");
   flutter_controller_->engine()->SetNextFrameCallback([&]() {
-    this->Show();
+    StartupTracer& trace = ProcessStartupTracer();
+    trace.AddInstant("first frame");
+    {
+      StartupTracer::Span span(trace, "Show");
+      this->Show();
+    }
+    ExportStartupTraceIfRequested(IsSubWindow() ? L"sub_window"
+                                                : L"chat_desktop");
   });
 
   // Flutter can complete the first frame before the "show window" callback is
@@ -62,6 +83,7 @@ bool FlutterWindow::OnCreate() {
 }
 
 void FlutterWindow::OnDestroy() {
+  floating_ball_channel_ = nullptr;
   if (flutter_controller_) {
     flutter_controller_ = nullptr;
   }
@@ -89,9 +111,18 @@ FlutterWindow::MessageHandler(HWND hwnd, UINT const message,
     }
   }
 
+  if (floating_ball_channel_) {
+    std::optional<LRESULT> result =
+        floating_ball_channel_->HandleWindowMessage(message, wparam, lparam);
+    if (result) {
+      return *result;
+    }
+  }
+
   switch (message) {
     case WM_COPYDATA: {
-      // 接收来自原生悬浮窗的控制消息（例如：从托盘隐藏状态恢复主窗口）
+      // 接收来自原生悬浮窗的控制消息（例如：从托盘隐藏状态恢复主窗口）。
+      // 主窗口上由 FloatingBallChannel 先行处理并转发给 Dart，这里是兜底。
       auto cds = reinterpret_cast<COPYDATASTRUCT*>(lparam);
       if (cds && cds->dwData == 3) { // 3 = RESTORE_MAIN_WINDOW
         ShowWindow(hwnd, SW_SHOW);
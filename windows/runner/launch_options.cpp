@@ -0,0 +1,34 @@
+#include "launch_options.h"
+
+#include <windows.h>
+
+#include <string_view>
+
+#include "utils.h"
+
+// static
+const LaunchOptions& LaunchOptions::Get() {
+  static const LaunchOptions options;
+  return options;
+}
+
+LaunchOptions::LaunchOptions()
+    : dart_arguments_(GetCommandLineArguments()) {
+  int argc = 0;
+  LPWSTR* argv = ::CommandLineToArgvW(::GetCommandLineW(), &argc);
+  if (argv == nullptr) {
+    return;
+  }
+  // Skip the first argument as it's the binary name.
+  for (int i = 1; i < argc; i++) {
+    std::wstring_view arg(argv[i]);
+    // Detect both desktop_multi_window markers and our custom entry flag
+    if (arg.find(L"mini_window") != std::wstring_view::npos) {
+      is_mini_window_ = true;
+      is_sub_window_ = true;
+    } else if (arg.find(L"multi_window") != std::wstring_view::npos) {
+      is_sub_window_ = true;
+    }
+  }
+  ::LocalFree(argv);
+}
@@ -0,0 +1,36 @@
+#ifndef RUNNER_LAUNCH_OPTIONS_H_
+#define RUNNER_LAUNCH_OPTIONS_H_
+
+#include <string>
+#include <vector>
+
+// Process role and launch flags, parsed once from the command line at
+// startup. Hot paths (e.g. WM_NCHITTEST, which fires on every mouse move)
+// read the cached values instead of re-parsing the command line.
+class LaunchOptions {
+ public:
+  // Returns the options for this process; the first call parses
+  // GetCommandLineW() and later calls return the same immutable object.
+  static const LaunchOptions& Get();
+
+  // True for desktop_multi_window sub-windows and the mini window entry.
+  bool is_sub_window() const { return is_sub_window_; }
+
+  // True only for the mini window entry ("mini_window"), which uses the
+  // bitsdojo custom frame.
+  bool is_mini_window() const { return is_mini_window_; }
+
+  // Arguments forwarded to the Dart entrypoint, encoded in UTF-8.
+  const std::vector<std::string>& dart_arguments() const {
+    return dart_arguments_;
+  }
+
+ private:
+  LaunchOptions();
+
+  bool is_sub_window_ = false;
+  bool is_mini_window_ = false;
+  std::vector<std::string> dart_arguments_;
+};
+
+#endif  // RUNNER_LAUNCH_OPTIONS_H_
@@ -4,54 +4,150 @@
 #include <propkey.h>
 #include <shobjidl.h>
 
+#include <chrono>
+#include <iostream>
+#include <vector>
+
 #include <bitsdojo_window_windows/bitsdojo_window_plugin.h>
 
+#include "core/single_instance.h"
+#include "core/startup_trace.h"
 #include "flutter_window.h"
+#include "launch_options.h"
 #include "utils.h"
 
+namespace {
+
+// How long a relaunch waits for a primary instance that holds the lock but
+// has not created its window yet.
+constexpr auto kForwardTimeout = std::chrono::seconds(5);
+constexpr UINT kForwardSendTimeoutMs = 2000;
+// Exit code of a relaunch whose arguments never reached the primary instance,
+// so scripts and launchers can tell a lost activation from a forwarded one.
+constexpr int kExitForwardTimedOut = 3;
+
+// Hands this launch's arguments to the running instance. Returns true once the
+// primary window accepted them.
+bool ForwardActivation(const SingleInstance::Endpoint& endpoint) {
+  HWND window = reinterpret_cast<HWND>(endpoint.window);
+  DWORD owner = 0;
+  if (!::IsWindow(window) ||
+      (::GetWindowThreadProcessId(window, &owner), owner != endpoint.pid)) {
+    return false;
+  }
+  // Let the primary bring itself to the foreground on our behalf.
+  ::AllowSetForegroundWindow(endpoint.pid);
+  std::vector<uint8_t> payload =
+      EncodeInstanceActivation(LaunchOptions::Get().dart_arguments());
+  COPYDATASTRUCT cds{};
+  cds.dwData = kInstanceActivateCopyData;
+  cds.cbData = static_cast<DWORD>(payload.size());
+  cds.lpData = payload.data();
+  DWORD_PTR accepted = 0;
+  return ::SendMessageTimeoutW(window, WM_COPYDATA, 0,
+                               reinterpret_cast<LPARAM>(&cds),
+                               SMTO_ABORTIFHUNG | SMTO_BLOCK,
+                               kForwardSendTimeoutMs, &accepted) &&
+         accepted == 1;
+}
+
+}  // namespace
+
 int APIENTRY wWinMain(_In_ HINSTANCE instance, _In_opt_ HINSTANCE prev,
                       _In_ wchar_t *command_line, _In_ int show_command) {
+  // Startup timeline (exported after the first frame, see FlutterWindow).
+  StartupTracer& trace = ProcessStartupTracer();
+  trace.SetProcess(::GetCurrentProcessId(), "chat_desktop");
+  {
+    // Loader time before wWinMain: process creation -> now.
+    FILETIME created, exited, kernel, user, now;
+    if (::GetProcessTimes(::GetCurrentProcess(), &created, &exited, &kernel,
+                          &user)) {
+      ::GetSystemTimePreciseAsFileTime(&now);
+      const auto ticks = [](const FILETIME& ft) {
+        return (static_cast<int64_t>(ft.dwHighDateTime) << 32) |
+               ft.dwLowDateTime;
+      };
+      const int64_t loader_ns = (ticks(now) - ticks(created)) * 100;
+      if (loader_ns > 0) {
+        trace.AddSpan("process start -> wWinMain", -loader_ns, loader_ns);
+      }
+    }
+  }
+  StartupTracer::Span main_span(trace, "wWinMain -> message loop");
+
   // Attach to console when present (e.g., 'flutter run') or create a
   // new console when running with a debugger.
   if (!::AttachConsole(ATTACH_PARENT_PROCESS) && ::IsDebuggerPresent()) {
     CreateAndAttachConsole();
   }
 
+  // Single instance: a second launch of the main app forwards its arguments
+  // to the running instance and exits before COM, the Dart project or the
+  // engine are set up.
+  SingleInstance instance(kSingleInstanceName);
+  if (!LaunchOptions::Get().is_sub_window()) {
+    StartupTracer::Span span(trace, "SingleInstance::Claim");
+    const InstanceRole role =
+        instance.Claim(kForwardTimeout, ForwardActivation);
+    if (role == InstanceRole::Forwarded) {
+      return EXIT_SUCCESS;
+    }
+    if (role == InstanceRole::TimedOut) {
+      // The primary holds the lock but never accepted the activation: this
+      // launch's arguments are lost. Report it instead of exiting cleanly.
+      span.End();
+      trace.AddInstant("SingleInstance: forward timed out");
+      ExportStartupTraceIfRequested(L"forward_timeout");
+      ::OutputDebugStringA(
+          "[SingleInstance] Primary instance did not accept the activation; "
+          "exiting\n");
+      std::cerr << "chat_desktop: the running instance did not respond; "
+                   "this launch was not forwarded"
+                << std::endl;
+      return kExitForwardTimedOut;
+    }
+  }
+
   // Initialize COM, so that it is available for use in the library and/or
   // plugins.
-  ::CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+  {
+    StartupTracer::Span span(trace, "CoInitializeEx");
+    ::CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+  }
 
   // Set AppUserModelID for Windows notification support
   // This is important for the notification system to recognize the app
   SetCurrentProcessExplicitAppUserModelID(L"com.chatdesktop.ChatDesktop");
 
+  StartupTracer::Span project_span(trace, "DartProject + LaunchOptions");
   flutter::DartProject project(L"data");
 
   // Configure Bitsdojo Window only for mini-window (see below)
 
-  std::vector<std::string> command_line_arguments = GetCommandLineArguments();
+  const LaunchOptions& options = LaunchOptions::Get();
 
   // Only enable custom frame for the mini window process
-  bool is_mini_window = false;
-  for (const auto& arg : command_line_arguments) {
-    if (arg.find("mini_window") != std::string::npos) {
-      is_mini_window = true;
-      break;
-    }
-  }
-  if (is_mini_window) {
+  if (options.is_mini_window()) {
     bitsdojo_window_configure(BDW_CUSTOM_FRAME);
   }
 
-  project.set_dart_entrypoint_arguments(std::move(command_line_arguments));
+  project.set_dart_entrypoint_arguments(options.dart_arguments());
+  project_span.End();
 
   FlutterWindow window(project);
   Win32Window::Point origin(10, 10);
   Win32Window::Size size(1280, 720);
-  if (!window.Create(L"chat_desktop", origin, size)) {
-    return EXIT_FAILURE;
+  {
+    StartupTracer::Span span(trace, "Win32Window::Create");
+    if (!window.Create(L"chat_desktop", origin, size)) {
+      return EXIT_FAILURE;
+    }
   }
   window.SetQuitOnClose(true);
+  instance.Publish({::GetCurrentProcessId(),
+                    reinterpret_cast<uint64_t>(window.GetHandle())});
+  main_span.End();
 
   ::MSG msg;
   while (::GetMessage(&msg, nullptr, 0, 0)) {
@@ -5,7 +5,12 @@
 #include <stdio.h>
 #include <windows.h>
 
+#include <fstream>
 #include <iostream>
+#include <string>
+
+#include "core/startup_trace.h"
+#include "core/utf_transcode.h"
 
 void CreateAndAttachConsole() {
   if (::AllocConsole()) {
@@ -42,24 +47,37 @@ std::vector<std::string> GetCommandLineArguments() {
 }
 
 std::string Utf8FromUtf16(const wchar_t* utf16_string) {
+  static_assert(sizeof(wchar_t) == sizeof(char16_t),
+                "Win32 wchar_t is UTF-16");
   if (utf16_string == nullptr) {
     return std::string();
   }
-  unsigned int target_length = ::WideCharToMultiByte(
-      CP_UTF8, WC_ERR_INVALID_CHARS, utf16_string,
-      -1, nullptr, 0, nullptr, nullptr)
-    -1; // remove the trailing null character
-  int input_length = (int)wcslen(utf16_string);
+  // Exact-length single allocation; invalid UTF-16 (unpaired surrogates)
+  // yields an empty string, matching WC_ERR_INVALID_CHARS.
   std::string utf8_string;
-  if (target_length == 0 || target_length > utf8_string.max_size()) {
-    return utf8_string;
+  Utf16ToUtf8(std::u16string_view(
+                  reinterpret_cast<const char16_t*>(utf16_string),
+                  wcslen(utf16_string)),
+              &utf8_string, UtfMode::Strict);
+  return utf8_string;
+}
+
+void ExportStartupTraceIfRequested(const wchar_t* name) {
+  wchar_t dir[MAX_PATH];
+  DWORD length = ::GetEnvironmentVariableW(L"CHAT_DESKTOP_STARTUP_TRACE", dir,
+                                           MAX_PATH);
+  if (length == 0 || length >= MAX_PATH) {
+    return;
   }
-  utf8_string.resize(target_length);
-  int converted_length = ::WideCharToMultiByte(
-      CP_UTF8, WC_ERR_INVALID_CHARS, utf16_string,
-      input_length, utf8_string.data(), target_length, nullptr, nullptr);
-  if (converted_length == 0) {
-    return std::string();
+  std::wstring path(dir, length);
+  if (path.back() != L'\\' && path.back() != L'/') {
+    path += L'\\';
+  }
+  path += L"startup_";
+  path += name;
+  path += L"_" + std::to_wstring(::GetCurrentProcessId()) + L".json";
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (out.is_open()) {
+    out << ProcessStartupTracer().ToChromeJson();
   }
-  return utf8_string;
 }
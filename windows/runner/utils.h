@@ -16,4 +16,9 @@ std::string Utf8FromUtf16(const wchar_t* utf16_string);
 // encoded in UTF-8. Returns an empty std::vector<std::string> on failure.
 std::vector<std::string> GetCommandLineArguments();
 
+// Writes the process startup trace (core/startup_trace.h) as Chrome
+// trace-event JSON to %CHAT_DESKTOP_STARTUP_TRACE%\startup_<name>_<pid>.json
+// when that environment variable names a directory. No-op otherwise.
+void ExportStartupTraceIfRequested(const wchar_t* name);
+
 #endif  // RUNNER_UTILS_H_
@@ -3,6 +3,8 @@
 #include <dwmapi.h>
 #include <flutter_windows.h>
 
+#include "core/dispatch_profiler.h"
+#include "launch_options.h"
 #include "resource.h"
 
 namespace {
@@ -173,25 +175,8 @@ bool Win32Window::Create(const std::wstring& title,
   return OnCreate();
 }
 
-// Helper function to check if this is a sub-window
-bool Win32Window::IsSubWindow() {
-  // Check command line arguments
-  int argc;
-  LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
-
-  bool is_sub_window = false;
-  for (int i = 0; i < argc; i++) {
-    std::wstring arg(argv[i]);
-    // Detect both desktop_multi_window markers and our custom entry flag
-    if (arg.find(L"multi_window") != std::wstring::npos ||
-        arg.find(L"mini_window") != std::wstring::npos) {
-      is_sub_window = true;
-      break;
-    }
-  }
-
-  LocalFree(argv);
-  return is_sub_window;
+bool Win32Window::IsSubWindow() const {
+  return LaunchOptions::Get().is_sub_window();
 }
 
 bool Win32Window::Show() {
@@ -212,6 +197,9 @@ LRESULT CALLBACK Win32Window::WndProc(HWND const window,
     EnableFullDpiSupportIfAvailable(window);
     that->window_handle_ = window;
   } else if (Win32Window* that = GetThisFromHandle(window)) {
+    // Per-message-type counts and latency; dumped on demand through
+    // FloatingBallChannel ("dumpDispatchProfile").
+    DispatchProfiler::Scope scope(ProcessDispatchProfiler(), message);
     return that->MessageHandler(window, message, wparam, lparam);
   }
 
@@ -71,8 +71,9 @@ class Win32Window {
   // Called when Destroy is called.
   virtual void OnDestroy();
 
-  // Check if this is a sub-window (floating window) based on command line arguments.
-  bool IsSubWindow();
+  // Check if this is a sub-window (floating window) based on command line
+  // arguments. Cheap: reads the options parsed once at startup.
+  bool IsSubWindow() const;
 
  private:
   friend class WindowClassRegistrar;